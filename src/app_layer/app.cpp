@@ -16,14 +16,41 @@ output_destination_t filterOutTimeDependentOutputs(output_destination_t output)
     return (output & ALL_TIME_INDEPENDENT_OUTPUTS);
 }
 
-void sendToOutputAndCheckForErrors(control_io_t output, const control_data_ts *data)
+task_status_te app_runOutputsBackground()
 {
-    control_error_ts error;
-    // Define output component
-    control_device_ts output_component = {output, CONTROL_ID_UNUSED};
+    control_runOutputsBackground();
+    // Export moves one block and the profiling dump one slot per call
+    return (control_isLogExportActive() || control_isProfilingDumpActive()) ? NOT_FINISHED : FINISHED;
+}
 
-    error.component = output_component;
-    error.error_code = control_routeDataToOutput(output, data);
-    checkForErrors(&error);
+task_status_te app_startComponents()
+{
+    (void)control_init(); // Failed components are reported by the control, pending ones come up later
+    return FINISHED;
+}
+
+task_status_te app_bringUpComponents()
+{
+    return (CONTROL_BRING_UP_FINISHED == control_bringUp()) ? FINISHED : NOT_FINISHED;
+}
+
+task_status_te app_recoverComponents(uint32_t current_millis)
+{
+    return (CONTROL_RECOVERY_SETTLING == control_recover(current_millis)) ? NOT_FINISHED : FINISHED;
+}
+
+output_destination_t app_getOutputs(uint8_t group)
+{
+    return settings_getOutputs(group);
+}
+
+uint8_t app_getI2CScanMode()
+{
+    return settings_getI2CScanMode();
+}
+
+bool app_takeHostRequest(uint8_t request)
+{
+    return settings_takeTrigger(request);
 }
 /* *************************************** */
\ No newline at end of file
@@ -5,5 +5,6 @@
 #include "app_i2c_scan/app_i2c_scan.h"
 #include "app_sensors/app_sensors.h"
 #include "app_time/app_time.h"
+#include "app_view/app_view.h"
 
 #endif
\ No newline at end of file
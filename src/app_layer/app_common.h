@@ -4,30 +4,8 @@
 #include <Arduino.h>
 #include "../control/control.h"
 
-/* Macro to check if a specific output bit is set in the output variable */
-/* It returns true if the specified bit (bit_mask) is set in the output, otherwise false */
-#define IS_OUTPUT_INCLUDED(output, bit_mask) ((output & bit_mask) != 0)
-
-/* Type for representing and managing output destinations (supports up to 16 different output options) */
-typedef uint16_t output_destination_t;
-
-/** Bitmask macros for output destinations:
- * - The first 8 bits (0x00FF) are for time-independent outputs (supports up to 8 outputs at once).
- * - The second 8 bits (0xFF00) are for time-dependent outputs (supports up to 8 outputs at once, e.g., display).
- * - ALL_OUTPUTS combines both time-independent and time-dependent outputs (16 bits in total).
- */
-/* Output option for serial console(can show all at once or sequentially) */
-#define SERIAL_CONSOLE                 (output_destination_t)(1 << 0) /* 7 bytes reserved for the future outputs */
-/* Output option for displays(cannot show all at once) */
-#define LCD_DISPLAY                    (output_destination_t)(1 << 8) /* 7 bytes reserved for the future outputs */
-/* Outputs that can be sent independently of time constraints(all at once) */
-#define ALL_TIME_INDEPENDENT_OUTPUTS   (output_destination_t)(0x00FF)
-/* Outputs that require time constraints (e.g., display) */
-#define ALL_TIME_DEPENDENT_OUTPUTS     (output_destination_t)(0xFF00)
-/* Used to indicate all outputs */
-#define ALL_OUTPUTS                    (output_destination_t)(0xFFFF)
-/* Used to indicate no outputs are set */
-#define NO_OUTPUTS                     (output_destination_t)(0x0000)
+/* Macro that checks if a deadline (millis() based) has been reached, safe against millis() overflow */
+#define IS_DEADLINE_REACHED(current_millis, deadline) ((int32_t)((uint32_t)(current_millis) - (uint32_t)(deadline)) >= 0)
 
 /* Enum representing the status of a task(function called) */
 typedef enum
@@ -62,16 +40,65 @@ void checkForErrors(const control_error_ts *error);
 output_destination_t filterOutTimeDependentOutputs(output_destination_t output);
 
 /**
- * @brief Routes data to the specified output component and checks for errors.
+ * @brief Runs the background work of the outputs.
+ *
+ * Must be called periodically, so queued serial console lines keep flowing to the UART.
+ *
+ * @return task_status_te NOT_FINISHED while the log is exported or the profiling is dumped, so the caller can call it again sooner, FINISHED otherwise.
+ */
+task_status_te app_runOutputsBackground();
+
+/**
+ * @brief Starts the initialization of every component without waiting for their settle times.
+ *
+ * Components which are still settling are brought up later by app_bringUpComponents().
+ *
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_startComponents();
+
+/**
+ * @brief Brings up the components which were still settling when they were started.
+ *
+ * Must be called periodically until it returns FINISHED, each component comes up as soon as
+ * its own settle time is over.
+ *
+ * @return task_status_te `NOT_FINISHED` while some component is pending, `FINISHED` otherwise.
+ */
+task_status_te app_bringUpComponents();
+
+/**
+ * @brief Retries the components which failed to initialize, with exponential backoff between the passes.
+ *
+ * Must be called periodically, a pass is only done when its backoff is over and is limited in time,
+ * so the sampling tasks are never blocked for long.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return task_status_te `NOT_FINISHED` while a retried component is settling and needs the bring-up, `FINISHED` otherwise.
+ */
+task_status_te app_recoverComponents(uint32_t current_millis);
+
+/**
+ * @brief Returns the outputs of a group of tasks, as set by the host or by the firmware.
  *
- * This function attempts to send the provided data to the specified output component (e.g., LCD display, serial console).
- * It then checks for any errors encountered during the operation by calling `checkForErrors`.
+ * @param group The group of the task (SETTINGS_OUTPUTS_*).
+ * @return output_destination_t The outputs of the group.
+ */
+output_destination_t app_getOutputs(uint8_t group);
+
+/**
+ * @brief Returns the mode of the I2C scan at boot, as set by the host or by the firmware.
+ *
+ * @return uint8_t The scan mode (I2C_SCAN_MODE_*).
+ */
+uint8_t app_getI2CScanMode();
+
+/**
+ * @brief Takes an action which the host requested over the serial console.
  *
- * @param output The output component to send the data to (e.g., OUTPUT_DISPLAY, OUTPUT_SERIAL_CONSOLE).
- * @param data A pointer to the data to be sent to the output component.
- * 
- * @note The `CONTROL_ID_UNUSED` is used to indicate that the device ID is not used in this operation.
+ * @param request The action (SETTINGS_TRIGGER_*).
+ * @return true if the host requested the action since the last call, the request is cleared.
  */
-void sendToOutputAndCheckForErrors(control_io_t output, const control_data_ts *data);
+bool app_takeHostRequest(uint8_t request);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "app_i2c_scan.h"
 
+/* STATIC GLOBAL VARIABLES */
+/* Caller owned slot of the one-shot scans, the scanner writes into it and outputs read it in place */
+static control_data_ts i2c_scan_slot;
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 /**
  * @brief Updates the I2C scan result to the next available address.
@@ -12,6 +17,16 @@
  * @return bool Returns true if a valid address was found, false if no addresses remain.
  */
 static bool updateI2CScanForAllAddressesUpdateNextAddress(i2c_scan_reading_ts *reading);
+
+/**
+ * @brief Routes every detected address of a finished scan to the outputs, one after another.
+ *
+ * The number of routed addresses is limited by the range of I2C addresses to avoid infinite loops.
+ *
+ * @param output The destination(s) for the I2C scan results.
+ * @param slot Slot with the finished scan, its current address is updated in place.
+ */
+static void routeAllFoundAddresses(output_destination_t output, control_data_ts *slot);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -20,33 +35,37 @@ task_status_te app_readAllI2CAddressesPeriodic(output_destination_t output, i2c_
     // Run the I2C scanner if it's not already completed
     if(I2C_SCANER_RUN == context->run_i2c_scanner)
     {
-        control_device_ts i2c_scanner = {INPUT_I2C_SCAN, I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES};
-        // Fetch the I2C scan result
-        context->i2c_scan_return = control_fetchDataFromInput(&i2c_scanner);
+        control_device_ts i2c_scanner = {INPUT_I2C_SCAN, context->scan_mode};
+        // Fetch the next slice of the I2C scan
+        control_error_ts error = control_makeError(control_fetchDataFromInput(&i2c_scanner, &(context->i2c_scan_slot)), i2c_scanner);
+        if(ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED == error.error_code)
+        {
+            return NOT_FINISHED; // Scanner keeps its position in the slot, next call continues
+        }
         // Handle input errors
-        control_error_ts error = {context->i2c_scan_return.error_code, i2c_scanner};
         checkForErrors(&error);
         // Mark scanner as stopped after fetching the data
         context->run_i2c_scanner = I2C_SCANER_DONT_RUN;
+
+        if(I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES == context->scan_mode)
+        {
+            // Known devices are only reported, waiting on each of them would delay the boot
+            routeAllFoundAddresses(filterOutTimeDependentOutputs(output), &(context->i2c_scan_slot));
+            context->run_i2c_scanner = I2C_SCANER_RUN;
+            return FINISHED;
+        }
     }
 
-    i2c_scan_reading_ts current_reading = context->i2c_scan_return.data.input_return.i2c_scan_reading;
+    // Updated in place, so the outputs see the current address and the next call continues from it
+    i2c_scan_reading_ts *current_reading = &(context->i2c_scan_slot.input_return.i2c_scan_reading);
     // Check if an address update function is assigned
-    if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading.update_i2c_address)
+    if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading->update_i2c_address)
     {
         // Try updating the I2C address (returns true if a valid address is found)
-        if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(&current_reading))
+        if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(current_reading))
         {
-            if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-            {
-                // Send I2C scan address to display output and check for errors
-                sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(context->i2c_scan_return.data));
-            }
-            if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-            {
-                // Send I2C scan address to serial console output and check for errors
-                sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(context->i2c_scan_return.data));
-            }
+            // Send I2C scan address to all selected outputs, errors are handled by the control
+            (void)control_routeDataToOutputs(output, &(context->i2c_scan_slot));
 
             return NOT_FINISHED;
         }
@@ -63,38 +82,16 @@ task_status_te app_readAllI2CAddressesAtOnce(output_destination_t output)
     if(NO_OUTPUTS != output) // Check if all outputs are filtered out
     {
         control_device_ts i2c_scanner = {INPUT_I2C_SCAN, I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES};
-        // Fetch the I2C scan result
-        control_input_data_ts i2c_scan_reading_result = control_fetchDataFromInput(&i2c_scanner);
+        control_error_ts error = control_makeError(ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED, i2c_scanner);
+        // Fetch the I2C scan result, slice after slice
+        while(ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED == error.error_code)
+        {
+            error.error_code = control_fetchDataFromInput(&i2c_scanner, &i2c_scan_slot);
+        }
         // Handle input errors
-        control_error_ts error = {i2c_scan_reading_result.error_code, i2c_scanner};
         checkForErrors(&error);
 
-        i2c_scan_reading_ts current_reading = i2c_scan_reading_result.data.input_return.i2c_scan_reading;
-        // Check if an address update function is assigned
-        if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading.update_i2c_address)
-        {
-            // Initialize a loop counter or timeout check to prevent infinite loop
-            uint8_t attempt_counter = I2C_SCAN_I2C_ADDRESS_MIN;
-            // Timeout based on attempts
-            while(attempt_counter <= I2C_SCAN_I2C_ADDRESS_MAX)
-            {
-                // Try updating the I2C address (returns true if a valid address is found)
-                if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(&current_reading))
-                {
-                    if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-                    {
-                        // Send I2C scan address to serial console output and check for errors
-                        sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(i2c_scan_reading_result.data));
-                    }
-
-                    attempt_counter++; // Increment the attempt counter after a successful address update
-                }
-                else
-                {
-                    break;
-                }
-            }
-        }
+        routeAllFoundAddresses(output, &i2c_scan_slot);
     }
 
     return FINISHED; // No update function assigned, just return finished
@@ -106,35 +103,33 @@ task_status_te app_readI2CDeviceStatus(uint8_t device_address, output_destinatio
     {
         control_device_ts i2c_scanner = {INPUT_I2C_SCAN, device_address};
         // Fetch the I2C scan result
-        control_input_data_ts i2c_scan_reading_result = control_fetchDataFromInput(&i2c_scanner);
+        control_error_ts error = control_makeError(control_fetchDataFromInput(&i2c_scanner, &i2c_scan_slot), i2c_scanner);
         // Handle input errors
-        control_error_ts error = {i2c_scan_reading_result.error_code, i2c_scanner};
         checkForErrors(&error);
 
-        if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-        {
-            // Send I2C scan address to display output and check for errors
-            sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(i2c_scan_reading_result.data));
-        }
-        if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-        {
-            // Send I2C scan address to serial console output and check for errors
-            sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(i2c_scan_reading_result.data));
-        }
+        // Send I2C device status to all selected outputs, errors are handled by the control
+        (void)control_routeDataToOutputs(output, &i2c_scan_slot);
     }
     return FINISHED; // Return value is used to notify task component
 }
 
-i2c_scan_reading_context_ts app_createI2CScanReadingContext()
+bool app_isI2CScanInProgress(const i2c_scan_reading_context_ts *context)
+{
+    return I2C_SCANER_RUN == context->run_i2c_scanner &&
+           I2C_SCAN_CURSOR_START != context->i2c_scan_slot.input_return.i2c_scan_reading.scan_cursor;
+}
+
+i2c_scan_reading_context_ts app_createI2CScanReadingContext(uint8_t scan_mode)
 {
     // Initialize the I2C scan reading context with zeroed-out default values
     i2c_scan_reading_context_ts new_i2c_scan_reading_context = {0};
 
     // Set the function pointer to indicate no address update functionality is available
-    new_i2c_scan_reading_context.i2c_scan_return.data.input_return.i2c_scan_reading.update_i2c_address = I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION;
+    new_i2c_scan_reading_context.i2c_scan_slot.input_return.i2c_scan_reading.update_i2c_address = I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION;
 
     // Mark the scanner as active, meaning it should start scanning when triggered
     new_i2c_scan_reading_context.run_i2c_scanner = I2C_SCANER_RUN;
+    new_i2c_scan_reading_context.scan_mode = scan_mode;
 
     // Return the half initialized scan reading context structure
     return new_i2c_scan_reading_context;
@@ -146,4 +141,34 @@ static bool updateI2CScanForAllAddressesUpdateNextAddress(i2c_scan_reading_ts *r
 {
     return reading->update_i2c_address(reading);
 }
+
+static void routeAllFoundAddresses(output_destination_t output, control_data_ts *slot)
+{
+    // Updated in place, so the outputs see the current address
+    i2c_scan_reading_ts *current_reading = &(slot->input_return.i2c_scan_reading);
+    // Check if an address update function is assigned
+    if(NO_OUTPUTS == output || I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION == current_reading->update_i2c_address)
+    {
+        return;
+    }
+
+    // Initialize a loop counter or timeout check to prevent infinite loop
+    uint8_t attempt_counter = I2C_SCAN_I2C_ADDRESS_MIN;
+    // Timeout based on attempts
+    while(attempt_counter <= I2C_SCAN_I2C_ADDRESS_MAX)
+    {
+        // Try updating the I2C address (returns true if a valid address is found)
+        if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(current_reading))
+        {
+            // Send I2C scan address to all selected outputs, errors are handled by the control
+            (void)control_routeDataToOutputs(output, slot);
+
+            attempt_counter++; // Increment the attempt counter after a successful address update
+        }
+        else
+        {
+            break;
+        }
+    }
+}
 /* *************************************** */
\ No newline at end of file
@@ -12,22 +12,36 @@
 /* Context structure to manage the state of the I2C scanner operation */
 typedef struct
 {
-    control_input_data_ts i2c_scan_return; // Stores the result of the I2C scan operation
+    control_data_ts i2c_scan_slot;         // Caller owned slot, the scanner writes its result and its scan position into it in place
     bool run_i2c_scanner;                  // Flag indicating whether the I2C scanner should be run
+    uint8_t scan_mode;                     // I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES or I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES
 } i2c_scan_reading_context_ts;
 
 /**
  * @brief Periodically scans and reads I2C addresses.
  *
- * This function runs the I2C scanner periodically and updates the display or console with 
- * detected I2C addresses. If no more addresses are found, it marks the scanning process as completed.
+ * This function runs one slice of the I2C scanner per call until the scan is done, afterwards it
+ * updates the display or console with one detected I2C address per call. A scan of the known
+ * devices is not presented address by address, its result is sent at once to the time
+ * independent outputs, so the boot is not delayed. If no more addresses are found, it marks the
+ * scanning process as completed.
  *
  * @param output The output destination (LCD display, serial console, etc.).
  * @param context The I2C scan reading context containing the scan data.
- * @return task_status_te - `NOT_FINISHED` if there are more addresses to process, `FINISHED` otherwise.
+ * @return task_status_te - `NOT_FINISHED` if the scan or the presentation continues, `FINISHED` otherwise.
  */
 task_status_te app_readAllI2CAddressesPeriodic(output_destination_t output, i2c_scan_reading_context_ts *context);
 
+/**
+ * @brief Checks if the scan of the context is between two slices.
+ *
+ * Used by the caller to run the next slice soon instead of waiting for the presentation period.
+ *
+ * @param context The I2C scan reading context.
+ * @return bool true if some addresses are probed and the scan is not finished yet.
+ */
+bool app_isI2CScanInProgress(const i2c_scan_reading_context_ts *context);
+
 /**
  * @brief Reads all I2C addresses at once by performing a scan and routing the results to specified outputs.
  * 
@@ -67,8 +81,9 @@ task_status_te app_readI2CDeviceStatus(uint8_t device_address, output_destinatio
  * The function pointer `update_i2c_address` is explicitly set to `I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION`,
  * which serves as the key check for determining if address updates should occur.
  *
+ * @param scan_mode I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES or I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES.
  * @return i2c_scan_reading_context_ts - A half initialized I2C scan reading context.
  */
-i2c_scan_reading_context_ts app_createI2CScanReadingContext();
+i2c_scan_reading_context_ts app_createI2CScanReadingContext(uint8_t scan_mode);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,11 @@
 #include "app_sensors.h"
 
+/* STATIC GLOBAL VARIABLES */
+/* Caller owned slots, inputs write into them and outputs read them in place */
+static control_data_ts sensor_slot;
+static control_data_ts snapshot_slot;
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 /**
  * @brief Updates the sensor index for periodic readings.
@@ -12,27 +18,31 @@
  * @return uint8_t The updated sensor index.
  */
 static uint8_t readAllSensorsPeriodicUpdateSensorIndex(uint8_t current_index, size_t number_of_sensors);
+
+/**
+ * @brief Fetches a sensor reading into the sensor slot and handles the input error.
+ *
+ * @param sensor_id The ID of the sensor to be read.
+ * @return control_error_code_te Error code of the reading.
+ */
+static control_error_code_te fetchSensorIntoSlot(uint8_t sensor_id);
+
+/**
+ * @brief Samples a sensor into the sensor slot and handles the input error.
+ *
+ * @param sensor_id The ID of the sensor to be sampled.
+ * @return control_error_code_te Error code of the reading.
+ */
+static control_error_code_te sampleSensorIntoSlot(uint8_t sensor_id);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 task_status_te app_readSpecificSensor(uint8_t sensor_id, output_destination_t output)
 {
-    // Define input component and fetch sensor data
-    control_device_ts sensor_to_read = {INPUT_SENSORS, sensor_id};
-    control_input_data_ts sensor_reading_result = control_fetchDataFromInput(&sensor_to_read);
-    // Handle input errors
-    control_error_ts error = {sensor_reading_result.error_code, sensor_to_read};
-    checkForErrors(&error);
+    (void)fetchSensorIntoSlot(sensor_id);
 
-    if (IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-    {
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(sensor_reading_result.data));
-    }
-
-    if (IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-    {
-        sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(sensor_reading_result.data));
-    }
+    // Send sensor data to all selected outputs, errors are handled by the control
+    (void)control_routeDataToOutputs(output, &sensor_slot);
 
     return FINISHED;  // Notify that task is finished
 }
@@ -83,6 +93,164 @@ task_status_te app_readAllSensorsAtOnce(output_destination_t output)
     return FINISHED; // Return FINISHED since all sensors are processed
 }
 
+task_status_te app_readSensorsSnapshot(output_destination_t output)
+{
+    output = filterOutTimeDependentOutputs(output);
+    if(NO_OUTPUTS != output) // Check if all outputs are filtered out
+    {
+        // Define input component and fetch all sensors at once
+        control_device_ts snapshot_to_read = {INPUT_SENSORS_SNAPSHOT, CONTROL_ID_UNUSED};
+        control_error_ts error = control_makeError(control_fetchDataFromInput(&snapshot_to_read, &snapshot_slot), snapshot_to_read);
+        checkForErrors(&error);
+
+        if(ERROR_CODE_NO_ERROR == error.error_code)
+        {
+            const sensors_snapshot_ts *snapshot = snapshot_slot.input_return.sensors_snapshot;
+            // Handle errors of single readings, erroneous readings are skipped by the outputs
+            for (uint8_t sensor_index = STARTING_SENSOR_INDEX; sensor_index < snapshot->num_of_readings; sensor_index++)
+            {
+                control_device_ts sensor_read = {INPUT_SENSORS, sensors_interface_sensorIndexToId(sensor_index)};
+                control_error_ts reading_error = control_makeError(snapshot->readings[sensor_index].error_code, sensor_read);
+                checkForErrors(&reading_error);
+            }
+
+            // Send the snapshot to all selected outputs, errors are handled by the control
+            (void)control_routeDataToOutputs(output, &snapshot_slot);
+        }
+    }
+
+    return FINISHED; // Return FINISHED since all sensors are processed
+}
+
+task_status_te app_readDueSensors(output_destination_t output, sensor_sampling_context_ts *context, uint32_t current_millis)
+{
+    output = filterOutTimeDependentOutputs(output);
+    if(NO_OUTPUTS != output) // Check if all outputs are filtered out
+    {
+        for (uint8_t sensor_index = STARTING_SENSOR_INDEX; sensor_index < context->number_of_sensors; sensor_index++)
+        {
+            if(IS_DEADLINE_REACHED(current_millis, context->next_deadline[sensor_index]))
+            {
+                uint32_t sample_period = sensors_interface_getSamplePeriod(sensor_index);
+                context->next_deadline[sensor_index] += sample_period;
+                // Sensor was late for more than one period, skip the missed samples
+                if(IS_DEADLINE_REACHED(current_millis, context->next_deadline[sensor_index]))
+                {
+                    context->next_deadline[sensor_index] = current_millis + sample_period;
+                }
+
+                // Periodic samples are the only ones kept in the history, so the period of a series is constant
+                if(ERROR_CODE_NO_ERROR == sampleSensorIntoSlot(sensors_interface_sensorIndexToId(sensor_index)))
+                {
+                    control_recordHistory(&sensor_slot, current_millis);
+                    // Readings within the deadband are not sent, until the heartbeat of the measurement is due
+                    if(CONTROL_READING_NOT_REPORTABLE == control_isReadingReportable(&sensor_slot, current_millis))
+                    {
+                        continue;
+                    }
+                }
+                (void)control_routeDataToOutputs(output, &sensor_slot);
+            }
+        }
+    }
+
+    return FINISHED; // Return FINISHED since all due sensors are processed
+}
+
+task_status_te app_readEventSensor(output_destination_t output, uint8_t sensor_id, uint32_t current_millis)
+{
+    output = filterOutTimeDependentOutputs(output);
+    if(NO_OUTPUTS != output && SENSORS_NO_EVENT != sensor_id)
+    {
+        if(ERROR_CODE_NO_ERROR == sampleSensorIntoSlot(sensor_id) &&
+           CONTROL_READING_NOT_REPORTABLE == control_isReadingReportable(&sensor_slot, current_millis))
+        {
+            return FINISHED; // Changed back before it was sampled
+        }
+        (void)control_routeDataToOutputs(output, &sensor_slot);
+    }
+
+    return FINISHED;
+}
+
+uint8_t app_takeSensorEvent(uint32_t current_millis, uint32_t *next_check)
+{
+    return sensors_takeEvent(current_millis, next_check);
+}
+
+bool app_isSensorEventPending()
+{
+    return sensors_isEventPending();
+}
+
+uint32_t app_getNextSensorDeadline(const sensor_sampling_context_ts *context, uint32_t current_millis)
+{
+    if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED == context->number_of_sensors)
+    {
+        return current_millis + APP_SENSORS_NO_SENSORS_PERIOD;
+    }
+
+    uint32_t nearest_time_left = UINT32_MAX;
+
+    for (uint8_t sensor_index = STARTING_SENSOR_INDEX; sensor_index < context->number_of_sensors; sensor_index++)
+    {
+        uint32_t time_left = context->next_deadline[sensor_index] - current_millis; // Overflow safe difference
+        if(IS_DEADLINE_REACHED(current_millis, context->next_deadline[sensor_index]))
+        {
+            time_left = 0u; // Already due
+        }
+        if(time_left < nearest_time_left)
+        {
+            nearest_time_left = time_left;
+        }
+    }
+
+    return current_millis + nearest_time_left;
+}
+
+sensor_sampling_context_ts app_createSensorsSamplingContext(uint32_t current_millis)
+{
+    sensor_sampling_context_ts new_sensor_sampling_context;
+    new_sensor_sampling_context.number_of_sensors = sensors_interface_getSensorsLen();
+
+    for (uint8_t sensor_index = STARTING_SENSOR_INDEX; sensor_index < SENSORS_SNAPSHOT_CAPACITY; sensor_index++)
+    {
+        new_sensor_sampling_context.next_deadline[sensor_index] = current_millis;
+    }
+    return new_sensor_sampling_context;
+}
+
+task_status_te app_runSensorsBackground()
+{
+    control_runInputsBackground(millis());
+    return FINISHED;
+}
+
+bool app_isSensorsCalibrationNeeded()
+{
+    return SENSORS_CALIBRATION_NEEDED == sensors_calibration_isNeeded();
+}
+
+task_status_te app_startSensorsCalibration(uint32_t current_millis)
+{
+    sensors_calibration_start(current_millis);
+    return FINISHED;
+}
+
+task_status_te app_runSensorsCalibration(uint32_t current_millis)
+{
+    uint8_t sensor_id = SENSORS_CALIBRATION_NO_SENSOR;
+    control_error_code_te error_code = sensors_calibration_service(current_millis, &sensor_id);
+    if(SENSORS_CALIBRATION_NO_SENSOR != sensor_id)
+    {
+        // Rejected R0 is reported for the sensor, it keeps its previous R0
+        control_error_ts error = control_makeError(error_code, {INPUT_SENSORS, sensor_id});
+        checkForErrors(&error);
+    }
+
+    return (SENSORS_CALIBRATION_ACTIVE == sensors_calibration_isActive()) ? NOT_FINISHED : FINISHED;
+}
+
 sensor_reading_context_ts app_createNewSensorsReadingContext()
 {
     sensor_reading_context_ts new_sensor_reading_context = {sensors_interface_getSensorsLen(), STARTING_SENSOR_INDEX};
@@ -102,4 +270,24 @@ static uint8_t readAllSensorsPeriodicUpdateSensorIndex(uint8_t current_index, si
 
     return current_index;
 }
+
+static control_error_code_te fetchSensorIntoSlot(uint8_t sensor_id)
+{
+    // Define input component and fetch sensor data
+    control_device_ts sensor_to_read = {INPUT_SENSORS, sensor_id};
+    control_error_ts error = control_makeError(control_fetchDataFromInput(&sensor_to_read, &sensor_slot), sensor_to_read);
+    // Handle input errors
+    checkForErrors(&error);
+
+    return error.error_code;
+}
+
+static control_error_code_te sampleSensorIntoSlot(uint8_t sensor_id)
+{
+    control_error_ts error = control_makeError(control_sampleSensor(sensor_id, &sensor_slot), sensor_slot.input);
+    // Handle input errors
+    checkForErrors(&error);
+
+    return error.error_code;
+}
 /* *************************************** */
\ No newline at end of file
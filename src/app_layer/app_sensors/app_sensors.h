@@ -14,11 +14,22 @@ typedef struct
     uint8_t sensor_index;     // Remembers the current sensor index, resetting if the function is called with a different context
 } sensor_reading_context_ts;
 
+/* Deadline distance used when no sensors are configured, sampling task then only wakes up rarely */
+#define APP_SENSORS_NO_SENSORS_PERIOD (uint32_t)(60000u)
+
+/* Context structure to keep the deadline of every sensor measurement for per-sensor sampling */
+typedef struct
+{
+    size_t number_of_sensors;                         // Total number of sensors, deadlines above it are unused
+    uint32_t next_deadline[SENSORS_SNAPSHOT_CAPACITY]; // Time (millis() based) of the next sample, indexed by catalog index
+} sensor_sampling_context_ts;
+
 /**
  * @brief Reads sensor data and routes it to the specified output.
  *
- * Fetches data from the given sensor and sends it to the selected output(s) 
+ * Fetches the cached reading of the given sensor and sends it to the selected output(s) 
  * (LCD, serial console, or both). Handles any retrieval or routing errors internally.
+ * The hardware is not read, the reading comes from the last sample of app_readDueSensors.
  *
  * @param sensor_id The ID of the sensor to be read.
  * @param output The output destination (LCD, serial console, or both).
@@ -60,6 +71,128 @@ task_status_te app_readAllSensorsPeriodic(output_destination_t output, sensor_re
  */
 task_status_te app_readAllSensorsAtOnce(output_destination_t output);
 
+/**
+ * @brief Reads all sensors in a single sweep and sends them to the specified output as one record.
+ *
+ * Unlike `app_readAllSensorsAtOnce`, sensors are not routed one by one. All readings are
+ * collected in one timestamped snapshot from the reading cache and
+ * the snapshot is routed to every output only once. Errors of individual readings are handled here.
+ * Time dependent outputs are filtered out since they can not show all readings at once.
+ *
+ * @param output The destination output where the snapshot will be sent (e.g., SERIAL_CONSOLE).
+ *
+ * @return task_status_te Always returns FINISHED, indicating that all sensors were processed.
+ */
+task_status_te app_readSensorsSnapshot(output_destination_t output);
+
+/**
+ * @brief Reads every sensor whose sample period has elapsed and routes it to the specified output.
+ *
+ * Each measurement is sampled on its own deadline which is advanced by the sample period
+ * from the sensor catalog, so slow signals do not take bus and ADC time from fast ones.
+ * This is the only path which reads the sensor hardware, every sample refreshes the reading cache
+ * which the other sensor tasks read from.
+ * If a sensor was late by more than one period its deadline is re-synchronized to the current time.
+ * Time dependent outputs are filtered out since readings arrive independently of each other.
+ * Readings which changed less than the deadband of their measurement are not routed until the
+ * max silence of the measurement passed, erroneous readings are always routed.
+ *
+ * @param output The destination where sensor data should be routed (e.g., SERIAL_CONSOLE).
+ * @param context Pointer to the sampling context which holds the deadline of every sensor.
+ * @param current_millis Current time in milliseconds.
+ *
+ * @return task_status_te Always returns FINISHED, indicating that all due sensors were processed.
+ */
+task_status_te app_readDueSensors(output_destination_t output, sensor_sampling_context_ts *context, uint32_t current_millis);
+
+/**
+ * @brief Samples an event driven sensor whose value changed and routes it to the specified output.
+ *
+ * The sample is taken outside the period of the sensor, so it is not kept in the history.
+ * It passes the deadband like a periodic sample, so the next periodic sample is only sent if it differs.
+ *
+ * @param output The destination where sensor data should be routed (e.g., SERIAL_CONSOLE).
+ * @param sensor_id ID returned by app_takeSensorEvent().
+ * @param current_millis Current time in milliseconds.
+ *
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_readEventSensor(output_destination_t output, uint8_t sensor_id, uint32_t current_millis);
+
+/**
+ * @brief Takes the change of an event driven sensor, see sensors_takeEvent().
+ *
+ * @param current_millis Current time in milliseconds.
+ * @param next_check Lowered to the time at which a settling sensor must be checked again, untouched otherwise.
+ * @return uint8_t ID of the sensor whose value changed, SENSORS_NO_EVENT otherwise.
+ */
+uint8_t app_takeSensorEvent(uint32_t current_millis, uint32_t *next_check);
+
+/**
+ * @brief Checks if an interrupt of an event driven sensor is waiting for app_takeSensorEvent().
+ *
+ * @return true if app_takeSensorEvent() should be called.
+ */
+bool app_isSensorEventPending();
+
+/**
+ * @brief Returns the nearest deadline of all sensors in the sampling context.
+ *
+ * @param context Pointer to the sampling context.
+ * @param current_millis Current time in milliseconds.
+ *
+ * @return uint32_t Time (millis() based) at which the next sensor is due, or
+ *         current_millis + APP_SENSORS_NO_SENSORS_PERIOD if no sensors are configured.
+ */
+uint32_t app_getNextSensorDeadline(const sensor_sampling_context_ts *context, uint32_t current_millis);
+
+/**
+ * @brief Creates and initializes a new sensor sampling context.
+ *
+ * Every sensor is due immediately, so the first call of `app_readDueSensors` samples all of them.
+ *
+ * @param current_millis Current time in milliseconds.
+ * @return sensor_sampling_context_ts The initialized sensor sampling context.
+ */
+sensor_sampling_context_ts app_createSensorsSamplingContext(uint32_t current_millis);
+
+/**
+ * @brief Runs the background work of the sensors.
+ *
+ * Must be called periodically, more often than SENSORS_MQ7_SAMPLE_WINDOW_MS,
+ * so time critical samples (MQ7 at the end of the low heater phase) are not missed.
+ *
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_runSensorsBackground();
+
+/**
+ * @brief Checks if an enabled MQ gas sensor has no calibrated R0 yet.
+ *
+ * @return true if the calibration should be run (the station is expected to be in clean air).
+ */
+bool app_isSensorsCalibrationNeeded();
+
+/**
+ * @brief Starts the R0 calibration of the MQ gas sensors, see sensors_calibration.h.
+ *
+ * @param current_millis Current time in milliseconds.
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_startSensorsCalibration(uint32_t current_millis);
+
+/**
+ * @brief Runs the R0 calibration of the MQ gas sensors and handles the errors of the evaluated sensors.
+ *
+ * Must be called periodically, more often than SENSORS_MQ7_SAMPLE_WINDOW_MS, while the calibration runs.
+ *
+ * @param current_millis Current time in milliseconds.
+ * @return task_status_te Returns:
+ *         - `FINISHED` when every sensor is evaluated or no calibration was started.
+ *         - `NOT_FINISHED` while the calibration is warming up, sampling or evaluating.
+ */
+task_status_te app_runSensorsCalibration(uint32_t current_millis);
+
 /**
  * @brief Creates and initializes a new sensor reading context.
  *
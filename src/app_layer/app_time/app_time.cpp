@@ -1,25 +1,23 @@
 #include "app_time.h"
 
+#ifdef RTC_COMPONENT
+/* STATIC GLOBAL VARIABLES */
+/* Caller owned slot, the RTC writes into it and outputs read it in place */
+static control_data_ts rtc_slot;
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
 task_status_te app_readCurrentRtcTime(output_destination_t output)
 {
     // Define input component and fetch sensor data
     control_device_ts time_component = {INPUT_RTC, RTC_DEFAULT_RTC};
-    control_input_data_ts rtc_result = control_fetchDataFromInput(&time_component);
+    control_error_ts error = control_makeError(control_fetchDataFromInput(&time_component, &rtc_slot), time_component);
     // Handle input errors
-    control_error_ts error = {rtc_result.error_code, time_component};
     checkForErrors(&error);
 
-    if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-    {
-        // Send RTC data to display output and check for errors
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(rtc_result.data));
-    }
-    if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-    {
-        // Send RTC data to serial console output and check for errors
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(rtc_result.data));
-    }   
+    // Send RTC data to all selected outputs, errors are handled by the control
+    (void)control_routeDataToOutputs(output, &rtc_slot);
     return FINISHED;
 }
-/* *************************************** */
\ No newline at end of file
+/* *************************************** */
+#endif
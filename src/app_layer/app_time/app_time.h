@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "../app_common.h"
 
+#ifdef RTC_COMPONENT
 /**
  * @brief Reads the current RTC time and routes it to the specified output.
  *
@@ -15,5 +16,6 @@
  * @return task_status_te Returns FINISHED to notify the task component.
  */
 task_status_te app_readCurrentRtcTime(output_destination_t output);
+#endif
 
 #endif
\ No newline at end of file
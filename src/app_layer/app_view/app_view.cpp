@@ -0,0 +1,191 @@
+#include "app_view.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* PAGE LAYOUT TABLE - ONE INPUT PER ROW OF THE DISPLAY, PAGES ARE SHOWN IN THIS ORDER, SENSORS AS IN THE CATALOG */
+static const control_device_ts view_pages[][CONTROL_VIEW_PAGE_ROWS] PLATFORM_PROGMEM =
+{
+#ifdef DHT11_COMPONENT
+    {APP_VIEW_SENSOR_ROW(DHT11_TEMPERATURE), APP_VIEW_SENSOR_ROW(DHT11_HUMIDITY)},
+#ifdef HISTORY_COMPONENT
+    {APP_VIEW_SENSOR_ROW(DHT11_TEMPERATURE), APP_VIEW_TREND_ROW(DHT11_TEMPERATURE)},
+#endif
+#endif
+#ifdef BMP280_COMPONENT
+    {APP_VIEW_SENSOR_ROW(BMP280_PRESSURE), APP_VIEW_SENSOR_ROW(BMP280_TEMPERATURE)},
+    {APP_VIEW_SENSOR_ROW(BMP280_ALTITUDE), APP_VIEW_TIME_ROW},
+#ifdef HISTORY_COMPONENT
+    {APP_VIEW_SENSOR_ROW(BMP280_PRESSURE), APP_VIEW_TREND_ROW(BMP280_PRESSURE)},
+#endif
+#endif
+#ifdef BH1750_COMPONENT
+    {APP_VIEW_SENSOR_ROW(BH1750_LUMINANCE), APP_VIEW_TIME_ROW},
+#endif
+#ifdef MQ135_COMPONENT
+    {APP_VIEW_SENSOR_ROW(MQ135_PPM), APP_VIEW_TIME_ROW},
+#endif
+#ifdef MQ7_COMPONENT
+    {APP_VIEW_SENSOR_ROW(MQ7_COPPM), APP_VIEW_TIME_ROW},
+#endif
+#ifdef GYML8511_COMPONENT
+    {APP_VIEW_SENSOR_ROW(GYML8511_UV), APP_VIEW_TIME_ROW},
+#endif
+#ifdef ARDUINORAIN_COMPONENT
+    {APP_VIEW_SENSOR_ROW(ARDUINORAIN_RAINING), APP_VIEW_TIME_ROW},
+#endif
+    {APP_VIEW_TIME_ROW, APP_VIEW_EMPTY_ROW} // Keeps the table valid without any sensor
+};
+
+/* Number of pages in the layout table */
+static constexpr uint8_t view_num_of_pages = (uint8_t)(sizeof(view_pages) / sizeof(view_pages[APP_VIEW_FIRST_PAGE]));
+
+/* Caller owned slot of the page, the display reads the page in place */
+static control_data_ts view_slot;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(UINT8_MAX > sizeof(view_pages) / sizeof(view_pages[APP_VIEW_FIRST_PAGE]), "Page index of the view must fit into 8 bits");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Fetches the data of every row of the current page.
+ *
+ * @param context Pointer to the view context, the page is written into it.
+ * @return true if the data of a row differs from the data the page was drawn from, false otherwise.
+ */
+static bool fetchPageRows(view_context_ts *context);
+
+/**
+ * @brief Fetches the data of one row from its input, the hardware is not read.
+ *
+ * @param device Input of the row, IO_UNUSED for a blank row.
+ * @param row_data Pointer to the row which receives the data, IO_UNUSED if the reading is not valid.
+ */
+static void fetchRow(const control_device_ts *device, control_data_ts *row_data);
+
+/**
+ * @brief Checks if the data of a row changed in a way which is visible on the display.
+ *
+ * Timestamps of the readings and the seconds of the time are not shown, so they are not compared.
+ *
+ * @param drawn_row Data the row was drawn from.
+ * @param new_row Freshly fetched data of the row.
+ * @return true if the row must be drawn again, false otherwise.
+ */
+static bool isRowChanged(const control_data_ts *drawn_row, const control_data_ts *new_row);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+task_status_te app_rotateViewPage(output_destination_t output, view_context_ts *context)
+{
+    context->page_index++;
+    if(view_num_of_pages <= context->page_index)
+    {
+        context->page_index = APP_VIEW_FIRST_PAGE; // Start again with the first page
+    }
+    context->page_drawn = APP_VIEW_PAGE_NOT_DRAWN;
+
+    return app_refreshViewPage(output, context);
+}
+
+task_status_te app_refreshViewPage(output_destination_t output, view_context_ts *context)
+{
+    bool row_changed = fetchPageRows(context);
+
+    if(APP_VIEW_PAGE_DRAWN != context->page_drawn || row_changed)
+    {
+        // Send the page to all selected outputs, errors are handled by the control
+        view_slot.input = {INPUT_VIEW_PAGE, context->page_index};
+        view_slot.input_return.view_page = &(context->page);
+        (void)control_routeDataToOutputs(output, &view_slot);
+        // A frame kept back by a busy LCD is routed again by the next refresh
+        context->page_drawn = control_isOutputPending(output) ? APP_VIEW_PAGE_NOT_DRAWN : APP_VIEW_PAGE_DRAWN;
+    }
+    return FINISHED;
+}
+
+view_context_ts app_createViewContext()
+{
+    view_context_ts new_view_context;
+    memset(&new_view_context, 0, sizeof(new_view_context));
+    new_view_context.page_index = APP_VIEW_FIRST_PAGE;
+    new_view_context.page_drawn = APP_VIEW_PAGE_NOT_DRAWN;
+    return new_view_context;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool fetchPageRows(view_context_ts *context)
+{
+    bool row_changed = false;
+
+    for (uint8_t row = 0u; row < CONTROL_VIEW_PAGE_ROWS; row++)
+    {
+        control_device_ts device;
+        control_data_ts new_row;
+        PLATFORM_MEMCPY_FLASH(&device, &view_pages[context->page_index][row], sizeof(device));
+
+        fetchRow(&device, &new_row);
+        if(isRowChanged(&(context->page.rows[row]), &new_row))
+        {
+            context->page.rows[row] = new_row;
+            row_changed = true;
+        }
+    }
+    return row_changed;
+}
+
+static void fetchRow(const control_device_ts *device, control_data_ts *row_data)
+{
+    control_device_ts unused_row = APP_VIEW_EMPTY_ROW;
+
+    // Errors of the readings are reported by the sampling and the snapshot, the view only leaves the row blank
+    if(IO_UNUSED == device->io_component || ERROR_CODE_NO_ERROR != control_fetchDataFromInput(device, row_data))
+    {
+        row_data->input = unused_row;
+    }
+}
+
+static bool isRowChanged(const control_data_ts *drawn_row, const control_data_ts *new_row)
+{
+    if(drawn_row->input.io_component != new_row->input.io_component || drawn_row->input.device_id != new_row->input.device_id)
+    {
+        return true;
+    }
+
+    switch(new_row->input.io_component)
+    {
+    case INPUT_SENSORS:
+    {
+        const sensor_reading_ts *drawn_reading = &(drawn_row->input_return.sensor_reading);
+        const sensor_reading_ts *new_reading = &(new_row->input_return.sensor_reading);
+        return drawn_reading->measurement_type_switch != new_reading->measurement_type_switch ||
+               drawn_reading->value != new_reading->value ||
+               drawn_reading->indication != new_reading->indication;
+    }
+
+#ifdef RTC_COMPONENT
+    case INPUT_RTC:
+    {
+        const rtc_reading_ts *drawn_time = &(drawn_row->input_return.rtc_reading);
+        const rtc_reading_ts *new_time = &(new_row->input_return.rtc_reading);
+        return drawn_time->mins != new_time->mins || drawn_time->hour != new_time->hour ||
+               drawn_time->day != new_time->day || drawn_time->month != new_time->month ||
+               drawn_time->year != new_time->year;
+    }
+#endif
+
+    case INPUT_HISTORY:
+    {
+        // Bars show only the levels, a new sample which keeps every level is not drawn
+        const trend_reading_ts *drawn_trend = &(drawn_row->input_return.trend_reading);
+        const trend_reading_ts *new_trend = &(new_row->input_return.trend_reading);
+        return drawn_trend->num_of_samples != new_trend->num_of_samples ||
+               0 != memcmp(drawn_trend->levels, new_trend->levels, new_trend->num_of_samples);
+    }
+
+    default:
+        return false; // Blank row stays blank
+    }
+}
+/* *************************************** */
@@ -0,0 +1,72 @@
+#ifndef APP_VIEW_H
+#define APP_VIEW_H
+
+#include <Arduino.h>
+#include "../app_common.h"
+
+/**
+ * Pages of the display view, every page shows one input per row.
+ * Layouts are the compile time table in app_view.cpp, the pages follow each other in the order of the table.
+ */
+
+/* Rows of a page layout which are not used */
+#define APP_VIEW_EMPTY_ROW         {IO_UNUSED, CONTROL_ID_UNUSED}
+/* Row of a page layout with the current time, blank without the RTC */
+#ifdef RTC_COMPONENT
+#define APP_VIEW_TIME_ROW          {INPUT_RTC, RTC_DEFAULT_RTC}
+#else
+#define APP_VIEW_TIME_ROW          APP_VIEW_EMPTY_ROW
+#endif
+/* Row of a page layout with the cached reading of a sensor */
+#define APP_VIEW_SENSOR_ROW(id)    {INPUT_SENSORS, (id)}
+/* Row of a page layout with the trend of the latest samples of a sensor, drawn as bars */
+#define APP_VIEW_TREND_ROW(id)     {INPUT_HISTORY, (id)}
+
+/* First page shown after boot */
+#define APP_VIEW_FIRST_PAGE        (uint8_t)(0u)
+
+/* Flags indicating if the page was routed to the display since it was selected and is shown */
+#define APP_VIEW_PAGE_DRAWN        (bool)(true)
+#define APP_VIEW_PAGE_NOT_DRAWN    (bool)(false)
+
+/* Context structure to keep the page on the display and the data it was drawn from */
+typedef struct
+{
+    uint8_t page_index;        // Index of the page in the layout table
+    bool page_drawn;           // Page was routed since it was selected and the display shows it
+    control_view_page_ts page; // Data which the page on the display was drawn from
+} view_context_ts;
+
+/**
+ * @brief Switches the view to the next page and draws it.
+ *
+ * Called on the rotation timer, after the last page the view starts again with the first one.
+ *
+ * @param output The output destination of the view (e.g., LCD_DISPLAY).
+ * @param context Pointer to the view context.
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_rotateViewPage(output_destination_t output, view_context_ts *context);
+
+/**
+ * @brief Draws the current page again from the reading cache if any of its values changed.
+ *
+ * Every row is fetched from its input without reading the hardware (sensor readings come from the
+ * reading cache, the time from the epoch of the RTC). The page is routed only when it was not drawn
+ * yet or when the data of a row changed, so the display is not refreshed by the sensor sampling.
+ * Rows whose reading is missing or stale are blank, errors of the readings are reported by the sampling.
+ *
+ * @param output The output destination of the view (e.g., LCD_DISPLAY).
+ * @param context Pointer to the view context.
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_refreshViewPage(output_destination_t output, view_context_ts *context);
+
+/**
+ * @brief Creates and initializes a new view context, showing the first page.
+ *
+ * @return view_context_ts The initialized view context.
+ */
+view_context_ts app_createViewContext();
+
+#endif
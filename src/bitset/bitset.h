@@ -0,0 +1,178 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <Arduino.h>
+
+/**
+ * @file bitset.h
+ * @brief Compact bitset with the number of bits fixed at compile time.
+ *
+ * Bits are kept in 8-bit words, the native word of the AVR core, so setting or testing a bit is one
+ * shift of a byte and operations on whole sets loop over as few bytes as the set needs. The set is a
+ * plain aggregate, `{}` initializes every bit to 0. Bit indexes above the size are ignored by every
+ * operation and tested as 0.
+ */
+
+/* Bits in one word of the set */
+#define BITSET_BITS_PER_WORD            (uint8_t)(8u)
+/* Number of words of a set, at least one so a set of 0 bits is still a valid type */
+#define BITSET_NUM_OF_WORDS(num_of_bits) (uint8_t)(((num_of_bits) > 0u) ? (((num_of_bits) + BITSET_BITS_PER_WORD - 1u) / BITSET_BITS_PER_WORD) : 1u)
+
+/* Returned by bitset_findNext() when no set bit is left */
+#define BITSET_NO_BIT                   (uint8_t)(0xFFu)
+
+/* Value of a word without any set bit */
+#define BITSET_EMPTY_WORD               (uint8_t)(0u)
+
+/**
+ * @brief Bitset of num_of_bits bits.
+ *
+ * Members:
+ *  - words: Bits of the set, bit 0 is the lowest bit of the first word. Bits above num_of_bits stay 0.
+ */
+template <uint8_t num_of_bits>
+struct bitset_ts
+{
+  static_assert(BITSET_NO_BIT > num_of_bits, "BITSET_NO_BIT must not be a valid bit index");
+  uint8_t words[BITSET_NUM_OF_WORDS(num_of_bits)];
+};
+
+/**
+ * @brief Sets a bit.
+ *
+ * @param set Bitset.
+ * @param bit Index of the bit, indexes above the size are ignored.
+ */
+template <uint8_t num_of_bits>
+inline void bitset_set(bitset_ts<num_of_bits> *set, uint8_t bit)
+{
+  if(num_of_bits > bit)
+  {
+    set->words[bit / BITSET_BITS_PER_WORD] |= (uint8_t)(1u << (bit % BITSET_BITS_PER_WORD));
+  }
+}
+
+/**
+ * @brief Clears a bit.
+ *
+ * @param set Bitset.
+ * @param bit Index of the bit, indexes above the size are ignored.
+ */
+template <uint8_t num_of_bits>
+inline void bitset_clear(bitset_ts<num_of_bits> *set, uint8_t bit)
+{
+  if(num_of_bits > bit)
+  {
+    set->words[bit / BITSET_BITS_PER_WORD] &= (uint8_t)~(1u << (bit % BITSET_BITS_PER_WORD));
+  }
+}
+
+/**
+ * @brief Tests a bit.
+ *
+ * @param set Bitset.
+ * @param bit Index of the bit.
+ * @return true if the bit is set, false otherwise (also for indexes above the size).
+ */
+template <uint8_t num_of_bits>
+inline bool bitset_test(const bitset_ts<num_of_bits> *set, uint8_t bit)
+{
+  return (num_of_bits > bit) && (BITSET_EMPTY_WORD != (set->words[bit / BITSET_BITS_PER_WORD] & (uint8_t)(1u << (bit % BITSET_BITS_PER_WORD))));
+}
+
+/**
+ * @brief Checks if no bit is set.
+ *
+ * @param set Bitset.
+ * @return true if every bit is 0, false otherwise.
+ */
+template <uint8_t num_of_bits>
+inline bool bitset_isEmpty(const bitset_ts<num_of_bits> *set)
+{
+  for (uint8_t word = 0u; word < BITSET_NUM_OF_WORDS(num_of_bits); word++)
+  {
+    if(BITSET_EMPTY_WORD != set->words[word])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Sets every bit of the destination which is set in the source (union).
+ *
+ * @param destination Bitset which receives the result.
+ * @param source Bitset which is added.
+ */
+template <uint8_t num_of_bits>
+inline void bitset_or(bitset_ts<num_of_bits> *destination, const bitset_ts<num_of_bits> *source)
+{
+  for (uint8_t word = 0u; word < BITSET_NUM_OF_WORDS(num_of_bits); word++)
+  {
+    destination->words[word] |= source->words[word];
+  }
+}
+
+/**
+ * @brief Clears every bit of the destination which is set in the source (difference).
+ *
+ * @param destination Bitset which receives the result.
+ * @param source Bitset which is removed.
+ */
+template <uint8_t num_of_bits>
+inline void bitset_andNot(bitset_ts<num_of_bits> *destination, const bitset_ts<num_of_bits> *source)
+{
+  for (uint8_t word = 0u; word < BITSET_NUM_OF_WORDS(num_of_bits); word++)
+  {
+    destination->words[word] &= (uint8_t)~source->words[word];
+  }
+}
+
+/**
+ * @brief Toggles every bit of the destination which is set in the source (symmetric difference).
+ *
+ * @param destination Bitset which receives the result.
+ * @param source Bitset which is compared.
+ */
+template <uint8_t num_of_bits>
+inline void bitset_xor(bitset_ts<num_of_bits> *destination, const bitset_ts<num_of_bits> *source)
+{
+  for (uint8_t word = 0u; word < BITSET_NUM_OF_WORDS(num_of_bits); word++)
+  {
+    destination->words[word] ^= source->words[word];
+  }
+}
+
+/**
+ * @brief Finds the lowest set bit at or above a bit, used to iterate over the set bits.
+ *
+ * Empty words are skipped as a whole, so iterating over a sparse set costs one compare per word.
+ *
+ * @param set Bitset.
+ * @param from_bit Index of the first bit which is checked.
+ * @return uint8_t Index of the set bit, BITSET_NO_BIT if no bit at or above from_bit is set.
+ */
+template <uint8_t num_of_bits>
+inline uint8_t bitset_findNext(const bitset_ts<num_of_bits> *set, uint8_t from_bit)
+{
+  uint8_t bit = from_bit;
+  while(num_of_bits > bit)
+  {
+    uint8_t word = (uint8_t)(set->words[bit / BITSET_BITS_PER_WORD] >> (bit % BITSET_BITS_PER_WORD));
+    if(BITSET_EMPTY_WORD == word)
+    {
+      bit = (uint8_t)((bit / BITSET_BITS_PER_WORD + 1u) * BITSET_BITS_PER_WORD); // Rest of the word is empty
+      continue;
+    }
+    while(0u == (word & 1u))
+    {
+      word >>= 1u;
+      bit++;
+    }
+    return bit;
+  }
+  return BITSET_NO_BIT;
+}
+
+#endif
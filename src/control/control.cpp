@@ -1,26 +1,169 @@
 #include "control.h"
 
 /* STATIC GLOBAL VARIABLES */
-static components_status_ts components_status[CONTROL_COMPONENTS_STATUS_SIZE] = {0};
+static components_status_ts components_status[CONTROL_COMPONENTS_STATUS_SIZE] = {};
+/* Storage for the latest sensors snapshot, outputs receive only a pointer to it */
+static sensors_snapshot_ts sensors_snapshot;
+/* Slot for error messages routed to the outputs, kept off the stack of the error path */
+static control_data_ts error_slot;
+/* Errors counted since their last report, an entry without occurrences is free */
+static control_error_ts error_table[CONTROL_ERROR_TABLE_SIZE];
+static uint16_t dropped_errors = CONTROL_ERROR_NO_OCCURRENCES;
+/* Position in the report turns, table entries first and the dropped errors last */
+static uint8_t error_report_position = 0u;
+static uint32_t next_error_report = 0u;
+/* Component retried by the recovery (one bit), next position of the turns and backoff before the next pass */
+static components_status_ts recovery_selection = {};
+static uint8_t recovery_position = 0u;
+static uint8_t recovery_backoff_exponent = 0u;
+static uint32_t next_recovery = 0u;
+/* Device which hung the station repeatedly before the last watchdog reset, it is not initialized */
+static control_device_ts skipped_device = {IO_UNUSED, CONTROL_ID_UNUSED};
+/* Last reading reported to the time independent outputs, per catalog index, used by the deadband filter */
+static sensor_value_t last_reported_value[SENSORS_SNAPSHOT_CAPACITY];
+static uint32_t last_reported_millis[SENSORS_SNAPSHOT_CAPACITY];
+/* Bit per catalog index, set after the first report of the measurement */
+static uint16_t reported_measurements = CONTROL_NO_MEASUREMENT_REPORTED;
+
+/* OUTPUT SINKS TABLE - INDEXED BY THE BIT OF THE OUTPUT IN output_destination_t */
+static constexpr control_output_sink_ts output_sinks[CONTROL_NUM_OF_OUTPUT_BITS] PLATFORM_PROGMEM =
+{
+    /* Time independent outputs */
+    CONTROL_SINK_SERIAL_CONSOLE,
+    CONTROL_SINK_DATA_LOG,
+    CONTROL_SINK_RADIO,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    /* Time dependent outputs */
+    CONTROL_SINK_LCD_DISPLAY,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK,
+    CONTROL_NO_SINK
+};
 /* *************************************** */
 
-/* STATIC FUNCTION PROTOTYPES */
+/* COMPILE TIME CHECKS */
 /**
- * @brief Initializes input return data structure.
+ * @brief Collects the destination bits which have a registered sink.
  *
- * Sets up the return data structure with the specified input component 
- * and ID, initializing error handling fields to indicate an invalid input by default.
+ * @param output_bit Bit from which the collection starts (recursive, C++11 constexpr).
+ * @return output_destination_t Bitmask of all registered outputs from the bit till the end.
+ */
+static constexpr output_destination_t outputSinksRegistered(uint8_t output_bit)
+{
+    return (CONTROL_NUM_OF_OUTPUT_BITS <= output_bit) ? NO_OUTPUTS :
+           (output_destination_t)(((CONTROL_NO_SINK_FUNCTION != output_sinks[output_bit].sink_function) ? (1u << output_bit) : 0u) |
+                                  outputSinksRegistered(output_bit + 1u));
+}
+
+/**
+ * @brief Checks that every registered sink reports its errors with a valid output component.
  *
- * @param input_device Pointer to struct with input component and unique identifier of the input component.
- * @return control_input_data_ts The initialized return data structure.
+ * @param output_bit Bit from which the check starts (recursive, C++11 constexpr).
+ * @return true if the table is consistent from the bit till the end, false otherwise.
  */
-static control_input_data_ts initializeInputReturnData(const control_device_ts *input_device);
+static constexpr bool outputSinksAreConsistent(uint8_t output_bit)
+{
+    return (CONTROL_NUM_OF_OUTPUT_BITS <= output_bit) ||
+           (((CONTROL_NO_SINK_FUNCTION == output_sinks[output_bit].sink_function) == (IO_UNUSED == output_sinks[output_bit].output_component)) &&
+            outputSinksAreConsistent(output_bit + 1u));
+}
+
+/* SRAM BUDGET - LARGEST STATIC BUFFERS OF THE ENABLED COMPONENTS, ROUNDED DOWN (COUNTERS AND FLAGS ARE LEFT TO THE RESERVE) */
+static constexpr uint32_t sram_sensors_bytes = (uint32_t)SENSORS_SNAPSHOT_CAPACITY *
+                                               (sizeof(sensors_cache_entry_ts) + sizeof(uint16_t) + sizeof(sensor_value_t) + sizeof(uint32_t)) +
+                                               (uint32_t)SENSORS_NUM_OF_FILTERS * sizeof(sensor_filter_state_ts) + sizeof(sensors_snapshot_ts);
+static constexpr uint32_t sram_control_bytes = sizeof(components_status) + sizeof(error_table) + sizeof(control_data_ts)
+                                               ;
+static constexpr uint32_t sram_outputs_bytes = 0u
+#ifdef SERIAL_CONSOLE_COMPONENT
+                                               + SERIAL_CONSOLE_TX_RING_SIZE + SERIAL_CONSOLE_RX_FRAME_SIZE + PLATFORM_SERIAL_BUFFERS_SIZE
+#endif
+#ifdef LCD_DISPLAY_COMPONENT
+                                               + LCD_I2C_FRAME_SIZE + 2u * DISPLAY_LCD_HEIGHT * DISPLAY_LCD_WIDTH
+#endif
+#ifdef DATA_LOG_COMPONENT
+                                               + DATA_LOG_NUM_OF_BUFFERS * (DATA_LOG_MEMORY_ADDRESS_SIZE + DATA_LOG_PAGE_SIZE) +
+                                               DATA_LOG_EXPORT_FRAME_BLOCK_SIZE + DATA_LOG_EXPORT_FRAME_CRC_SIZE
+#endif
+#ifdef RADIO_COMPONENT
+                                               + 3u * SENSORS_SNAPSHOT_CAPACITY * sizeof(int32_t) + RADIO_MAX_PACKET_SIZE
+#endif
+                                               ;
+static constexpr uint32_t sram_other_bytes = 0u
+#ifdef HISTORY_COMPONENT
+                                             + HISTORY_MAX_FOOTPRINT_BYTES
+#endif
+#ifdef PROFILING_COMPONENT
+                                             + PROFILING_NUM_OF_SLOTS * sizeof(profiling_stats_ts) + PROFILING_FRAME_STATS_SIZE + PROFILING_FRAME_CRC_SIZE
+#endif
+#ifdef SETTINGS_COMPONENT
+                                             + SETTINGS_FRAME_STATUS_SIZE + SETTINGS_FRAME_CRC_SIZE
+#endif
+                                             ;
+static constexpr uint32_t sram_static_bytes = sram_sensors_bytes + sram_control_bytes + sram_outputs_bytes + sram_other_bytes;
+
+/* Outputs which can be dispatched, the other bits are dropped before the dispatch loop */
+static constexpr output_destination_t registered_outputs = outputSinksRegistered(0u);
+
+static_assert(CONTROL_NUM_OF_OUTPUT_BITS == 8u * sizeof(output_destination_t), "Output sinks table must have one entry for every destination bit");
+static_assert(0u != registered_outputs, "At least one output component must be enabled in project_settings.h");
+static_assert(control_areComponentBitsUnique(control_sensor_component_bits, sizeof(control_sensor_component_bits)), "Every enabled sensor *_COMPONENT must have its own ID");
+static_assert(control_areComponentBitsUnique(control_other_input_component_bits, sizeof(control_other_input_component_bits)), "Every enabled input *_COMPONENT must have its own ID");
+static_assert(control_areComponentBitsUnique(control_output_component_bits, sizeof(control_output_component_bits)), "Every enabled output *_COMPONENT must have its own ID");
+#if defined(PROFILING_COMPONENT) && !defined(SERIAL_CONSOLE_COMPONENT)
+static_assert(false, "PROFILING_COMPONENT needs the SERIAL_CONSOLE_COMPONENT, the statistics are only sent to the host");
+#endif
+#ifdef GATEWAY_COMPONENT
+#ifndef SERIAL_CONSOLE_COMPONENT
+static_assert(false, "GATEWAY_COMPONENT needs the SERIAL_CONSOLE_COMPONENT, the batches are only sent to the host");
+#endif
+#ifdef RADIO_COMPONENT
+static_assert(false, "GATEWAY_COMPONENT and RADIO_COMPONENT share the transceiver, a gateway only receives");
+#endif
+static_assert(GATEWAY_BATCH_MAX_PAYLOAD <= SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD, "Gateway batch must fit a queued frame of the serial console");
+#endif
+static_assert(outputSinksAreConsistent(0u), "Registered output sinks must have an output component, unused bits must use CONTROL_NO_SINK");
+static_assert(SENSORS_SNAPSHOT_CAPACITY <= 8u * sizeof(reported_measurements), "Every measurement needs a bit in reported_measurements");
+#if defined(DATA_LOG_COMPONENT) && defined(SERIAL_CONSOLE_COMPONENT)
+static_assert(DATA_LOG_EXPORT_FRAME_BLOCK_SIZE <= SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD, "Export block frame must fit a queued serial console frame");
+static_assert(DATA_LOG_EXPORT_CMD_EXPORT_SIZE + SERIAL_FRAME_CRC_SIZE < SERIAL_CONSOLE_RX_FRAME_SIZE, "Export command must fit the serial console receive buffer");
+#endif
+#if defined(PROFILING_COMPONENT) && defined(SERIAL_CONSOLE_COMPONENT)
+static_assert(PROFILING_FRAME_STATS_SIZE <= SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD, "Profiling stats frame must fit a queued serial console frame");
+static_assert(PROFILING_CMD_DUMP_SIZE <= DATA_LOG_EXPORT_CMD_EXPORT_SIZE, "Dump command must fit the host command buffer");
+#endif
+#if defined(MEMORY_MONITOR_COMPONENT) && defined(SERIAL_CONSOLE_COMPONENT)
+static_assert(MEMORY_MONITOR_CMD_QUERY_SIZE <= DATA_LOG_EXPORT_CMD_EXPORT_SIZE, "Query command must fit the host command buffer");
+#endif
+#if defined(SETTINGS_COMPONENT) && defined(SERIAL_CONSOLE_COMPONENT)
+static_assert(SETTINGS_FRAME_STATUS_SIZE <= SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD, "Settings status frame must fit a queued serial console frame");
+static_assert(SETTINGS_CMD_SET_PERIOD_SIZE <= DATA_LOG_EXPORT_CMD_EXPORT_SIZE && SETTINGS_CMD_SET_OUTPUT_SIZE <= DATA_LOG_EXPORT_CMD_EXPORT_SIZE,
+              "Settings commands must fit the host command buffer");
+#endif
+static_assert((uint16_t)CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS + CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS + CONTROL_NUM_OF_SENSOR_COMPONENT_BITS <= UINT8_MAX, "Recovery positions are 8-bit");
+static_assert(CONTROL_RECOVERY_BACKOFF_MS(CONTROL_RECOVERY_MAX_BACKOFF_EXPONENT) < (uint32_t)INT32_MAX, "Recovery backoff must fit the overflow safe deadline");
+static_assert(sram_static_bytes + CONTROL_SRAM_RESERVE_BYTES <= PLATFORM_SRAM_SIZE,
+              "Static buffers of the enabled components leave less than CONTROL_SRAM_RESERVE_BYTES of SRAM for the stack, disable components in project_settings.h");
+#ifdef ARDUINO_ARCH_ESP32
+static_assert(false, "Only the platform layer is ported to the ESP32, the I2C bus, ADC sampling, MQ7, DHT11, RTC and power drivers still use AVR registers");
+#endif
+/* *************************************** */
 
+/* STATIC FUNCTION PROTOTYPES */
 /**
  * @brief Initializes a sensor and updates its status.
  *
  * This function marks the specified sensor as used and attempts to initialize it.
- * If initialization is successful, the sensor is also marked as working.
+ * If initialization is successful, the sensor is also marked as working, a sensor which is
+ * still settling is marked as pending.
  *
  * @param sensor The sensor ID to initialize.
  */
@@ -42,6 +185,38 @@ static void initSensor(uint8_t sensor);
  */
 static components_status_ts selectUninitialized();
 
+/**
+ * @brief Selects the failed components, the uninitialized ones which are not pending.
+ *
+ * @return components_status_ts A structure containing the failed components' status.
+ */
+static components_status_ts selectFailed();
+
+/**
+ * @brief Checks if no component is set in a status structure.
+ *
+ * @param components Status structure.
+ * @return true if every bitset is empty, false otherwise.
+ */
+static bool areNoComponents(const components_status_ts *components);
+
+/**
+ * @brief Checks if a component is set in a status structure.
+ *
+ * @param components Status structure.
+ * @param position Position in the recovery turns: outputs, other inputs and then sensors.
+ * @return true if the bit of the position is set, false otherwise.
+ */
+static bool isPositionSet(const components_status_ts *components, uint8_t position);
+
+/**
+ * @brief Builds a status structure with only the component of a position selected.
+ *
+ * @param position Position in the recovery turns.
+ * @return components_status_ts Structure with one bit set.
+ */
+static components_status_ts selectPosition(uint8_t position);
+
 /**
  * @brief Initializes or reinitializes system components.
  * 
@@ -51,18 +226,78 @@ static components_status_ts selectUninitialized();
  * it selectively reinitializes only the components that were not successfully 
  * initialized previously.
  * 
- * @param reinit Flag to determine whether this is the first initialization 
- *               (CONTROL_FIRST_INIT) or a reinitialization attempt (CONTROL_REINIT).
+ * @param init_mode Determines whether this is the first initialization (CONTROL_FIRST_INIT),
+ *                  a reinitialization attempt (CONTROL_REINIT), the background bring-up of the
+ *                  components which were still settling (CONTROL_BRING_UP) or the recovery of the
+ *                  component in recovery_selection (CONTROL_RECOVER).
  * 
  * @return CONTROL_INITIALIZATION_SUCCESSFUL if all components are successfully 
  *         initialized, otherwise CONTROL_INITIALIZATION_FAILED.
  */
-static bool control_initialize(bool reinit);
+static bool control_initialize(uint8_t init_mode);
+
+/**
+ * @brief Reports a watchdog reset and selects the device to skip if it hung the station repeatedly.
+ */
+static void handleWatchdogReset();
+
+/**
+ * @brief Checks if a device is skipped because it hung the station before the last watchdog reset.
+ *
+ * @param io_component I/O component of the device.
+ * @param device_id ID of the device.
+ * @return true if the device is skipped, false otherwise.
+ */
+static bool isDeviceSkipped(control_io_t io_component, uint8_t device_id);
+
+/**
+ * @brief Routes data to the sink registered for one destination bit.
+ *
+ * @param output_bit Bit of the output in output_destination_t, must be lower than CONTROL_NUM_OF_OUTPUT_BITS.
+ * @param data Pointer to the data, read in place by the sink.
+ * @return control_error_code_te Error code of the sink or ERROR_CODE_INVALID_OUTPUT if no sink is registered.
+ */
+static control_error_code_te routeDataToSink(uint8_t output_bit, const control_data_ts *data);
+
+/**
+ * @brief Reports the next error with new occurrences, at most once per CONTROL_ERROR_REPORT_PERIOD_MS.
+ *
+ * Table entries and the dropped errors are reported in turns, so a repeating error does not hide the others.
+ * When nothing is reported the deadline stays, so a new error is reported by the next call.
+ *
+ * @param current_millis The current time in milliseconds.
+ */
+static void reportNextError(uint32_t current_millis);
+
+/**
+ * @brief Routes an error to the serial console, or to the display if the serial console fails.
+ *
+ * @param error Pointer to the error, copied into the error slot.
+ */
+static void routeError(const control_error_ts *error);
+
+#ifdef CONTROL_HOST_COMMANDS_USED
+/**
+ * @brief Passes frames received by the serial console to the log export, the profiling, the memory monitor and the settings and queues their answers and the gateway batches.
+ *
+ * Every receiver ignores the frame types of the others. A frame which does not fit the transmit ring
+ * stays in its module and is queued again in the next call. The statistics requested by the settings
+ * are the profiling dump and the memory report.
+ */
+static void runHostCommands();
+#endif
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 bool control_init()
 {
+#ifdef MEMORY_MONITOR_COMPONENT
+    memory_monitor_init(); // Before the components, so their initialization is measured too
+#endif
+#ifdef SETTINGS_COMPONENT
+    settings_init();
+#endif
+    handleWatchdogReset();
     return control_initialize(CONTROL_FIRST_INIT);
 }
 
@@ -71,240 +306,638 @@ bool control_reinit()
     return control_initialize(CONTROL_REINIT);
 }
 
-control_error_code_te control_routeDataToOutput(control_io_t output_component, const control_data_ts *data)
+bool control_bringUp()
 {
-    // Initialize error code
-    control_error_code_te error_code = ERROR_CODE_INVALID_OUTPUT;
-    
-    switch (output_component)
+    (void)control_initialize(CONTROL_BRING_UP);
+
+    const components_status_ts *pending_components = &components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX];
+    if (areNoComponents(pending_components))
     {
-    case OUTPUT_DISPLAY:
-        // Route data to display and update error code
-        error_code = display_displayData(data);
-        break;
+        return CONTROL_BRING_UP_FINISHED;
+    }
 
-    case OUTPUT_SERIAL_CONSOLE:
-        // Route data to serial console and update error code
-        error_code = serial_console_displayData(data);
-        break;
+    return CONTROL_BRING_UP_IN_PROGRESS;
+}
+
+bool control_recover(uint32_t current_millis)
+{
+    components_status_ts failed_components = selectFailed();
+    if (areNoComponents(&failed_components))
+    {
+        recovery_backoff_exponent = 0u; // Next failure is retried soon
+        next_recovery = current_millis;
+    }
+    else if (0 <= (int32_t)(current_millis - next_recovery)) // Overflow safe deadline
+    {
+        bool recovered = false;
+        uint32_t pass_start = millis();
+
+        // Every failed component once, resumed at the next position if the budget runs out
+        for (uint8_t checked = 0u; checked < CONTROL_RECOVERY_NUM_OF_POSITIONS && CONTROL_RECOVERY_PASS_BUDGET_MS > millis() - pass_start; checked++)
+        {
+            uint8_t position = recovery_position;
+            recovery_position = (uint8_t)((position + 1u) % CONTROL_RECOVERY_NUM_OF_POSITIONS);
+            if (!isPositionSet(&failed_components, position))
+            {
+                continue;
+            }
+
+            (void)i2c_bus_recover(); // Slave left in the middle of a transfer would fail the retry again
+            recovery_selection = selectPosition(position);
+            (void)control_initialize(CONTROL_RECOVER);
+
+            components_status_ts still_failed = selectFailed();
+            recovered = recovered || !isPositionSet(&still_failed, position); // Working or settling again
+        }
+
+        if (recovered)
+        {
+            recovery_backoff_exponent = 0u;
+        }
+        else if (CONTROL_RECOVERY_MAX_BACKOFF_EXPONENT > recovery_backoff_exponent)
+        {
+            recovery_backoff_exponent++;
+        }
+        next_recovery = millis() + CONTROL_RECOVERY_BACKOFF_MS(recovery_backoff_exponent);
+    }
+
+    const components_status_ts *pending_components = &components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX];
+    if (areNoComponents(pending_components))
+    {
+        return CONTROL_RECOVERY_NOT_SETTLING;
+    }
+
+    return CONTROL_RECOVERY_SETTLING;
+}
+
+control_error_code_te control_routeDataToOutputs(output_destination_t outputs, const control_data_ts *data)
+{
+    control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+    outputs &= registered_outputs; // Bits without a sink are never visited
+
+    // One pass over the set bits, lowest bit (time independent outputs) first
+    while(NO_OUTPUTS != outputs)
+    {
+        uint8_t output_bit = (uint8_t)__builtin_ctz(outputs);
+        outputs &= (output_destination_t)(outputs - 1u); // Clear the lowest set bit
+
+        control_error_code_te sink_error_code = routeDataToSink(output_bit, data);
+        if(ERROR_CODE_NO_ERROR != sink_error_code)
+        {
+            control_device_ts output_component = {(control_io_t)PLATFORM_READ_BYTE(&output_sinks[output_bit].output_component), CONTROL_ID_UNUSED};
+            control_error_ts error = control_makeError(sink_error_code, output_component);
+            control_handleError(&error);
+            error_code = sink_error_code;
+        }
     }
-    // Default error code is set to ERROR_CODE_INVALID_OUTPUT so there is no need to set it in default.
     return error_code;
 }
 
-control_input_data_ts control_fetchDataFromInput(const control_device_ts *input_device)
+bool control_isOutputPending(output_destination_t outputs)
 {
-    // Initialize input return data with defaults
-    control_input_data_ts return_data = initializeInputReturnData(input_device);
+    return (NO_OUTPUTS != (outputs & registered_outputs & LCD_DISPLAY)) && display_isFramePending();
+}
+
+control_error_code_te control_fetchDataFromInput(const control_device_ts *input_device, control_data_ts *slot)
+{
+    // Initialize error code, inputs write their data directly into the slot
+    control_error_code_te error_code = ERROR_CODE_INVALID_INPUT;
+    slot->input = *input_device;
 
     switch (input_device->io_component)
     {
     case INPUT_SENSORS:
-        // Fetch sensor reading and update return data
-        sensor_return_ts sensor_return = sensors_getReading(input_device->device_id);
-        return_data.error_code = sensor_return.error_code;
-        return_data.data.input_return.sensor_reading = sensor_return.sensor_reading;
+        // Fetch cached sensor reading, only the sampling reads the hardware
+        error_code = sensors_getReading(input_device->device_id, &(slot->input_return.sensor_reading));
+        break;
+
+    case INPUT_SENSORS_SNAPSHOT:
+        // Collect all cached readings, errors of single readings are stored in the snapshot
+        error_code = sensors_getSnapshot(&sensors_snapshot);
+        slot->input_return.sensors_snapshot = &sensors_snapshot;
         break;
 
+#ifdef RTC_COMPONENT
     case INPUT_RTC:
-        // Fetch RTC data and update return data
-        rtc_return_ts rtc_return = rtc_getTime(input_device->device_id);
-        return_data.error_code = rtc_return.error_code;
-        return_data.data.input_return.rtc_reading = rtc_return.rtc_reading;
+        // Fetch RTC data
+        error_code = rtc_getTime(input_device->device_id, &(slot->input_return.rtc_reading));
         break;
+#endif
 
     case INPUT_I2C_SCAN:
-        // Fetch I2C scan data and update return data
-        i2c_scan_return_ts i2c_scan_return = i2c_scan_getReading(input_device->device_id);
-        return_data.error_code = i2c_scan_return.error_code;
-        return_data.data.input_return.i2c_scan_reading = i2c_scan_return.i2c_scan_reading;
+        // Fetch I2C scan data
+        error_code = i2c_scan_getReading(input_device->device_id, &(slot->input_return.i2c_scan_reading));
         break;
 
+#ifdef HISTORY_COMPONENT
+    case INPUT_HISTORY:
+    {
+        // Trend of the samples kept by control_recordHistory(), for the measurements of the series table
+        uint8_t index = sensors_interface_sensorIdToIndex(input_device->device_id);
+        if(SENSORS_INTERFACE_INVALID_INDEX == index)
+        {
+            error_code = ERROR_CODE_SENSOR_NOT_CONFIGURED;
+        }
+        else
+        {
+            bool trend_valid = history_getLevels(input_device->device_id, &(slot->input_return.trend_reading));
+            error_code = (HISTORY_STATS_VALID == trend_valid) ? ERROR_CODE_NO_ERROR : ERROR_CODE_HISTORY_EMPTY;
+        }
+        break;
+    }
+#endif
+
     default:
         // Default error code is set to ERROR_CODE_INVALID_INPUT so no need to set it again here.
         break;
     }
-    return return_data;
+    return error_code;
+}
+
+control_error_code_te control_sampleSensor(uint8_t sensor_id, control_data_ts *slot)
+{
+    slot->input = {INPUT_SENSORS, sensor_id};
+    return sensors_sampleReading(sensor_id, &(slot->input_return.sensor_reading), control_getTimestamp());
+}
+
+uint32_t control_getTimestamp()
+{
+#ifdef RTC_COMPONENT
+    uint32_t epoch = rtc_getEpoch(); // Counter of the SQW interrupt, no bus access
+    if(RTC_EPOCH_INVALID != epoch)
+    {
+        return epoch;
+    }
+#endif
+    return millis() / CONTROL_MS_PER_SECOND;
+}
+
+void control_runInputsBackground(unsigned long current_millis)
+{
+    i2c_bus_service(current_millis);
+    sensors_loop(current_millis);
+#ifdef RTC_COMPONENT
+    rtc_service((uint32_t)current_millis);
+#endif
+#ifdef GATEWAY_COMPONENT
+    gateway_service((uint32_t)current_millis);
+#endif
+}
+
+void control_runOutputsBackground()
+{
+    i2c_bus_service(millis()); // Supervises the display frame job
+#ifdef SERIAL_CONSOLE_COMPONENT
+    serial_console_service();
+#endif
+#ifdef DATA_LOG_COMPONENT
+    data_log_service(millis());
+#endif
+#ifdef RADIO_COMPONENT
+    radio_service(millis());
+#endif
+    reportNextError(millis());
+#ifdef MEMORY_MONITOR_COMPONENT
+    if(MEMORY_MONITOR_MEMORY_LOW == memory_monitor_service(millis()))
+    {
+        control_device_ts memory_device = {IO_UNUSED, CONTROL_ID_UNUSED};
+        control_error_ts error = control_makeError(ERROR_CODE_MEMORY_LOW, memory_device);
+        control_handleError(&error);
+    }
+#endif
+#ifdef CONTROL_HOST_COMMANDS_USED
+    runHostCommands();
+#endif
+}
+
+control_error_ts control_makeError(control_error_code_te error_code, control_device_ts component)
+{
+    control_error_ts error = {error_code, component, 0u};
+    return error;
 }
 
 void control_handleError(const control_error_ts *error)
 {
-    control_data_ts data;
-    control_device_ts error_input = {INPUT_ERROR, CONTROL_ID_UNUSED}; // Initialize input type
+    control_error_ts *free_entry = nullptr;
 
-    // Initialize error data
-    data.input_return.error_msg = *error;
-    data.input = error_input;
+    for (uint8_t entry_index = 0u; entry_index < CONTROL_ERROR_TABLE_SIZE; entry_index++)
+    {
+        control_error_ts *entry = &error_table[entry_index];
+        if(CONTROL_ERROR_NO_OCCURRENCES == entry->occurrences)
+        {
+            free_entry = (nullptr == free_entry) ? entry : free_entry;
+        }
+        else if(error->error_code == entry->error_code &&
+                error->component.io_component == entry->component.io_component &&
+                error->component.device_id == entry->component.device_id)
+        {
+            entry->occurrences = (UINT16_MAX == entry->occurrences) ? UINT16_MAX : (uint16_t)(entry->occurrences + 1u); // Repeat
+            return;
+        }
+    }
 
-    // Attempt to send error data to serial console; if it fails, fallback to display
-    if (ERROR_CODE_NO_ERROR != control_routeDataToOutput(OUTPUT_SERIAL_CONSOLE, &data))
+    if(nullptr != free_entry)
     {
-        (void)control_routeDataToOutput(OUTPUT_DISPLAY, &data);
+        *free_entry = *error;
+        free_entry->occurrences = 1u;
+    }
+    else if(UINT16_MAX != dropped_errors)
+    {
+        dropped_errors++;
     }
 }
-/* *************************************** */
 
-// TODO: CHANGE THIS FUNC TO RETURN ERROR CODE ONLY
+bool control_isLogExportActive()
+{
+#ifdef DATA_LOG_COMPONENT
+    return data_log_isExportActive();
+#else
+    return false;
+#endif
+}
 
-/* STATIC FUNCTIONS IMPLEMENTATIONS */
-static control_input_data_ts initializeInputReturnData(const control_device_ts *input_device)
+bool control_isProfilingDumpActive()
 {
-    control_input_data_ts return_data;
+#ifdef PROFILING_COMPONENT
+    return profiling_isDumpActive();
+#else
+    return false;
+#endif
+}
+
+bool control_isReadingReportable(const control_data_ts *data, uint32_t current_millis)
+{
+    if(INPUT_SENSORS != data->input.io_component)
+    {
+        return CONTROL_READING_REPORTABLE; // Filter applies only to sensor readings
+    }
+
+    uint8_t index = sensors_interface_sensorIdToIndex(data->input.device_id);
+    if(SENSORS_INTERFACE_INVALID_INDEX == index)
+    {
+        return CONTROL_READING_REPORTABLE;
+    }
 
-    // Initialize data part
-    return_data.data.input = *input_device;
+    const sensor_reading_ts *reading = &data->input_return.sensor_reading;
+    // Indications are compared as 1 and 0, their deadband is 0 so every change is reported
+    sensor_value_t value = (SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch) ?
+                           (sensor_value_t)(reading->indication ? 1 : 0) : reading->value;
+    uint16_t measurement_bit = (uint16_t)(1u << index);
 
-    // Initialize error part
-    return_data.error_code = ERROR_CODE_INVALID_INPUT;
+    if(reported_measurements & measurement_bit)
+    {
+        sensor_value_t last_value = last_reported_value[index];
+        sensor_value_t change = (value > last_value) ? (value - last_value) : (last_value - value);
+        bool heartbeat_due = (current_millis - last_reported_millis[index]) >= sensors_interface_getMaxSilence(index);
+        if(!(change > sensors_interface_getDeadband(index)) && !heartbeat_due)
+        {
+            return CONTROL_READING_NOT_REPORTABLE; // Changed less than the deadband and a report was sent recently
+        }
+    }
 
-    return return_data;
+    reported_measurements |= measurement_bit;
+    last_reported_value[index] = value;
+    last_reported_millis[index] = current_millis;
+    return CONTROL_READING_REPORTABLE;
 }
 
+void control_recordHistory(const control_data_ts *data, uint32_t current_millis)
+{
+#ifdef HISTORY_COMPONENT
+    const sensor_reading_ts *reading = &data->input_return.sensor_reading;
+    if(INPUT_SENSORS != data->input.io_component || SENSORS_MEASUREMENT_TYPE_VALUE != reading->measurement_type_switch)
+    {
+        return; // Only value measurements have a history
+    }
+
+    uint8_t index = sensors_interface_sensorIdToIndex(data->input.device_id);
+    if(SENSORS_INTERFACE_INVALID_INDEX != index)
+    {
+        // History keeps integers with the decimals of the catalog entry, in float mode too
+        uint8_t num_of_decimals = sensors_interface_getNumOfDecimals(index);
+        int32_t value = sensor_value_toDecimals(reading->value, num_of_decimals, num_of_decimals);
+        if(SENSOR_VALUE_SCALED_INVALID != value)
+        {
+            history_addSample(data->input.device_id, value, current_millis); // Kept only for the measurements of the series table
+        }
+    }
+#else
+    (void)data;
+    (void)current_millis;
+#endif
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
 static void initSensor(uint8_t sensor)
 {
-    components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].sensors_status |= (1 << sensor);
+    bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].sensors_status, sensor);
+    WATCHDOG_SET_ACTIVITY(INPUT_SENSORS, sensor);
     control_error_code_te error_code = sensors_init(sensor);
+    WATCHDOG_CLEAR_ACTIVITY();
     if(ERROR_CODE_NO_ERROR == error_code)
     {
-        components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status |= (1 << sensor);
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status, sensor);
+    }
+    else if(ERROR_CODE_INIT_PENDING == error_code)
+    {
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX].sensors_status, sensor);
     }
     else
     {
         control_device_ts sensor_device = {INPUT_SENSORS, sensor};
-        control_error_ts error = {error_code, sensor_device};
+        control_error_ts error = control_makeError(error_code, sensor_device);
         control_handleError(&error);
     }
 }
 
 static components_status_ts selectUninitialized()
 {
-    // Initialize return structure with all fields set to zero
-    components_status_ts return_status_struct = {0};
+    // Start from the "used" statuses
+    components_status_ts return_status_struct = components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX];
+    const components_status_ts *working_components = &components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX];
 
     // Compute XOR between "used" and "working" statuses to identify uninitialized components
-    return_status_struct.outputs_status = components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status ^ 
-                                          components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status;
+    bitset_xor(&return_status_struct.outputs_status, &working_components->outputs_status);
+    bitset_xor(&return_status_struct.other_inputs_status, &working_components->other_inputs_status);
+    bitset_xor(&return_status_struct.sensors_status, &working_components->sensors_status);
+
+    return return_status_struct;
+}
 
-    return_status_struct.other_inputs_status = components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status ^ 
-                                               components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status;
+static components_status_ts selectFailed()
+{
+    components_status_ts return_status_struct = selectUninitialized();
+    const components_status_ts *pending_components = &components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX];
 
-    return_status_struct.sensors_status = components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].sensors_status ^ 
-                                          components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status;
+    // Pending components are not failed, they are still coming up in the bring-up
+    bitset_andNot(&return_status_struct.outputs_status, &pending_components->outputs_status);
+    bitset_andNot(&return_status_struct.other_inputs_status, &pending_components->other_inputs_status);
+    bitset_andNot(&return_status_struct.sensors_status, &pending_components->sensors_status);
 
     return return_status_struct;
 }
 
-static bool control_initialize(bool reinit)
+static bool areNoComponents(const components_status_ts *components)
+{
+    return bitset_isEmpty(&components->outputs_status) &&
+           bitset_isEmpty(&components->other_inputs_status) &&
+           bitset_isEmpty(&components->sensors_status);
+}
+
+static bool isPositionSet(const components_status_ts *components, uint8_t position)
+{
+    if (CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS > position)
+    {
+        return bitset_test(&components->outputs_status, position);
+    }
+    position -= CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS;
+
+    if (CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS > position)
+    {
+        return bitset_test(&components->other_inputs_status, position);
+    }
+    position -= CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS;
+
+    return bitset_test(&components->sensors_status, position);
+}
+
+static components_status_ts selectPosition(uint8_t position)
+{
+    components_status_ts return_status_struct = {};
+
+    if (CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS > position)
+    {
+        bitset_set(&return_status_struct.outputs_status, position);
+    }
+    else if (CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS + CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS > position)
+    {
+        bitset_set(&return_status_struct.other_inputs_status, (uint8_t)(position - CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS));
+    }
+    else
+    {
+        bitset_set(&return_status_struct.sensors_status, (uint8_t)(position - CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS - CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS));
+    }
+
+    return return_status_struct;
+}
+
+static bool control_initialize(uint8_t init_mode)
 {
     control_error_code_te error_code = ERROR_CODE_INIT_FAILED;
     control_device_ts device_to_init = {IO_UNUSED, CONTROL_ID_UNUSED};
-    control_error_ts error = {error_code, device_to_init};
+    control_error_ts error = control_makeError(error_code, device_to_init);
 
-    // Re-check uninitialized components if reinitializing
-    components_status_ts uninitialized_components;
-    if (CONTROL_REINIT == reinit)
+    // Re-check uninitialized components if reinitializing, only the pending ones during the bring-up
+    components_status_ts uninitialized_components = {};
+    if (CONTROL_REINIT == init_mode)
     {
         uninitialized_components = selectUninitialized();
     }
+    else if (CONTROL_BRING_UP == init_mode)
+    {
+        uninitialized_components = components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX];
+    }
+    else if (CONTROL_RECOVER == init_mode)
+    {
+        uninitialized_components = recovery_selection;
+    }
+    else
+    {
+        i2c_bus_init(); // Bus is shared by the display, RTC, sensors and the I2C scanner
+    }
+
+    // Selected components are marked again below if they are still settling, the others keep their pending state
+    components_status_ts *pending_components = &components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX];
+    if (CONTROL_FIRST_INIT == init_mode)
+    {
+        *pending_components = {};
+    }
+    else
+    {
+        bitset_andNot(&pending_components->outputs_status, &uninitialized_components.outputs_status);
+        bitset_andNot(&pending_components->other_inputs_status, &uninitialized_components.other_inputs_status);
+        bitset_andNot(&pending_components->sensors_status, &uninitialized_components.sensors_status);
+    }
 
 #ifdef SERIAL_CONSOLE_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.outputs_status & (1 << SERIAL_CONSOLE_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.outputs_status, SERIAL_CONSOLE_COMPONENT)) && !isDeviceSkipped(OUTPUT_SERIAL_CONSOLE, CONTROL_ID_UNUSED))
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status |= (1 << SERIAL_CONSOLE_COMPONENT);
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status, SERIAL_CONSOLE_COMPONENT);
 
+        WATCHDOG_SET_ACTIVITY(OUTPUT_SERIAL_CONSOLE, CONTROL_ID_UNUSED);
         error_code = serial_console_init();
+        WATCHDOG_CLEAR_ACTIVITY();
 
         if (ERROR_CODE_NO_ERROR == error_code)
         {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status |= (1 << SERIAL_CONSOLE_COMPONENT);
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status, SERIAL_CONSOLE_COMPONENT);
         }
         else
         {
             device_to_init = {OUTPUT_SERIAL_CONSOLE, CONTROL_ID_UNUSED};
-            error = {error_code, device_to_init};
+            error = control_makeError(error_code, device_to_init);
             control_handleError(&error);
         }
     }
 #endif  
 
+#ifdef DATA_LOG_COMPONENT
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.outputs_status, DATA_LOG_COMPONENT)) && !isDeviceSkipped(OUTPUT_DATA_LOG, CONTROL_ID_UNUSED))
+    {
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status, DATA_LOG_COMPONENT);
+
+        WATCHDOG_SET_ACTIVITY(OUTPUT_DATA_LOG, CONTROL_ID_UNUSED);
+        error_code = data_log_init(); // Mount reads the block headers in steps
+        WATCHDOG_CLEAR_ACTIVITY();
+
+        if (ERROR_CODE_NO_ERROR == error_code)
+        {
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status, DATA_LOG_COMPONENT);
+        }
+        else if (ERROR_CODE_INIT_PENDING == error_code)
+        {
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX].outputs_status, DATA_LOG_COMPONENT);
+        }
+        else
+        {
+            device_to_init = {OUTPUT_DATA_LOG, CONTROL_ID_UNUSED};
+            error = control_makeError(error_code, device_to_init);
+            control_handleError(&error);
+        }
+    }
+#endif
+
+#ifdef RADIO_COMPONENT
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.outputs_status, RADIO_COMPONENT)) && !isDeviceSkipped(OUTPUT_RADIO, CONTROL_ID_UNUSED))
+    {
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status, RADIO_COMPONENT);
+
+        WATCHDOG_SET_ACTIVITY(OUTPUT_RADIO, CONTROL_ID_UNUSED);
+        error_code = radio_init();
+        WATCHDOG_CLEAR_ACTIVITY();
+
+        if (ERROR_CODE_NO_ERROR == error_code)
+        {
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status, RADIO_COMPONENT);
+        }
+        else
+        {
+            device_to_init = {OUTPUT_RADIO, CONTROL_ID_UNUSED};
+            error = control_makeError(error_code, device_to_init);
+            control_handleError(&error);
+        }
+    }
+#endif
+
 #ifdef LCD_DISPLAY_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.outputs_status & (1 << LCD_DISPLAY_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.outputs_status, LCD_DISPLAY_COMPONENT)) && !isDeviceSkipped(OUTPUT_DISPLAY, CONTROL_ID_UNUSED))
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status |= (1 << LCD_DISPLAY_COMPONENT);
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status, LCD_DISPLAY_COMPONENT);
 
+        WATCHDOG_SET_ACTIVITY(OUTPUT_DISPLAY, CONTROL_ID_UNUSED);
         error_code = display_init();
+        WATCHDOG_CLEAR_ACTIVITY();
 
         if (ERROR_CODE_NO_ERROR == error_code)
         {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status |= (1 << LCD_DISPLAY_COMPONENT);
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status, LCD_DISPLAY_COMPONENT);
+        }
+        else if (ERROR_CODE_INIT_PENDING == error_code)
+        {
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_PENDING_INDEX].outputs_status, LCD_DISPLAY_COMPONENT);
         }
         else
         {
             device_to_init = {OUTPUT_DISPLAY, CONTROL_ID_UNUSED};
-            error = {error_code, device_to_init};
+            error = control_makeError(error_code, device_to_init);
             control_handleError(&error);
         }
     }
 #endif  
 
 #ifdef RTC_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.other_inputs_status & (1 << RTC_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.other_inputs_status, RTC_COMPONENT)) && !isDeviceSkipped(INPUT_RTC, RTC_DEFAULT_RTC))
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status |= (1 << RTC_COMPONENT);
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status, RTC_COMPONENT);
 
+        WATCHDOG_SET_ACTIVITY(INPUT_RTC, RTC_DEFAULT_RTC);
         error_code = rtc_init();
+        WATCHDOG_CLEAR_ACTIVITY();
 
         if (ERROR_CODE_NO_ERROR == error_code)
         {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status |= (1 << RTC_COMPONENT);
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status, RTC_COMPONENT);
         }
         else
         {
             device_to_init = {INPUT_RTC, RTC_DEFAULT_RTC};
-            error = {error_code, device_to_init};
+            error = control_makeError(error_code, device_to_init);
             control_handleError(&error);
         }
     }
 #endif  
 
+#ifdef GATEWAY_COMPONENT
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.other_inputs_status, GATEWAY_COMPONENT)) && !isDeviceSkipped(INPUT_GATEWAY, CONTROL_ID_UNUSED))
+    {
+        bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status, GATEWAY_COMPONENT);
+
+        WATCHDOG_SET_ACTIVITY(INPUT_GATEWAY, CONTROL_ID_UNUSED);
+        error_code = gateway_init();
+        WATCHDOG_CLEAR_ACTIVITY();
+
+        if (ERROR_CODE_NO_ERROR == error_code)
+        {
+            bitset_set(&components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status, GATEWAY_COMPONENT);
+        }
+        else
+        {
+            device_to_init = {INPUT_GATEWAY, CONTROL_ID_UNUSED};
+            error = control_makeError(error_code, device_to_init);
+            control_handleError(&error);
+        }
+    }
+#endif
+
 #ifdef DHT11_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << DHT11_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, DHT11_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, DHT11_COMPONENT))
     {
         initSensor(DHT11_COMPONENT);
     }
 #endif
 #ifdef BMP280_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << BMP280_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, BMP280_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, BMP280_COMPONENT))
     {
         initSensor(BMP280_COMPONENT);
     }
 #endif
 #ifdef BH1750_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << BH1750_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, BH1750_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, BH1750_COMPONENT))
     {
         initSensor(BH1750_COMPONENT);
     }
 #endif
 #ifdef MQ135_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << MQ135_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, MQ135_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, MQ135_COMPONENT))
     {
         initSensor(MQ135_COMPONENT);
     }
 #endif
 #ifdef MQ7_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << MQ7_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, MQ7_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, MQ7_COMPONENT))
     {
         initSensor(MQ7_COMPONENT);
     }
 #endif
 #ifdef GYML8511_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << GYML8511_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, GYML8511_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, GYML8511_COMPONENT))
     {
         initSensor(GYML8511_COMPONENT);
     }
 #endif
 #ifdef ARDUINORAIN_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << ARDUINORAIN_COMPONENT)))
+    if ((CONTROL_FIRST_INIT == init_mode || bitset_test(&uninitialized_components.sensors_status, ARDUINORAIN_COMPONENT)) && !isDeviceSkipped(INPUT_SENSORS, ARDUINORAIN_COMPONENT))
     {
         initSensor(ARDUINORAIN_COMPONENT);
     }
@@ -312,13 +945,178 @@ static bool control_initialize(bool reinit)
 
     // Check initialization status
     uninitialized_components = selectUninitialized();
-    if (uninitialized_components.outputs_status == CONTROL_ALL_INITIALIZED &&
-        uninitialized_components.other_inputs_status == CONTROL_ALL_INITIALIZED &&
-        uninitialized_components.sensors_status == CONTROL_ALL_INITIALIZED)
+    if (areNoComponents(&uninitialized_components))
     {
         return CONTROL_INITIALIZATION_SUCCESSFUL;
     }
 
     return CONTROL_INITIALIZATION_FAILED;
 }
+
+static control_error_code_te routeDataToSink(uint8_t output_bit, const control_data_ts *data)
+{
+    control_output_sink_fn sink_function = (control_output_sink_fn)PLATFORM_READ_PTR(&output_sinks[output_bit].sink_function);
+    if(CONTROL_NO_SINK_FUNCTION == sink_function)
+    {
+        return ERROR_CODE_INVALID_OUTPUT;
+    }
+    WATCHDOG_SET_ACTIVITY(PLATFORM_READ_BYTE(&output_sinks[output_bit].output_component), CONTROL_ID_UNUSED);
+    control_error_code_te error_code = sink_function(data);
+    WATCHDOG_CLEAR_ACTIVITY();
+    return error_code;
+}
+
+static void handleWatchdogReset()
+{
+#ifdef WATCHDOG_COMPONENT
+    watchdog_reset_ts watchdog_reset;
+    if (WATCHDOG_RESET_BY_WATCHDOG != watchdog_getLastReset(&watchdog_reset))
+    {
+        return;
+    }
+
+    // Hang outside of a device activity is reported with the task which hung
+    control_device_ts culprit = {watchdog_reset.activity_group, watchdog_reset.activity_id};
+    if (WATCHDOG_NO_ACTIVITY == watchdog_reset.activity_group)
+    {
+        culprit = {IO_UNUSED, watchdog_reset.owner};
+    }
+    control_error_ts error = control_makeError(ERROR_CODE_WATCHDOG_RESET, culprit);
+    control_handleError(&error);
+
+    if (WATCHDOG_NO_ACTIVITY != watchdog_reset.activity_group && CONTROL_WATCHDOG_SKIP_RESETS <= watchdog_reset.consecutive_resets)
+    {
+        skipped_device = culprit;
+        error = control_makeError(ERROR_CODE_COMPONENT_SKIPPED, culprit);
+        control_handleError(&error);
+    }
+#endif
+}
+
+static bool isDeviceSkipped(control_io_t io_component, uint8_t device_id)
+{
+    return (io_component == skipped_device.io_component && device_id == skipped_device.device_id);
+}
+
+static void reportNextError(uint32_t current_millis)
+{
+    if(0 > (int32_t)(current_millis - next_error_report)) // Overflow safe deadline
+    {
+        return;
+    }
+
+    // One full turn at most, starting after the last reported position
+    for (uint8_t step = 0u; step <= CONTROL_ERROR_DROPPED_POSITION; step++)
+    {
+        uint8_t position = error_report_position;
+        error_report_position = (CONTROL_ERROR_DROPPED_POSITION == position) ? 0u : (uint8_t)(position + 1u);
+
+        if(CONTROL_ERROR_DROPPED_POSITION == position && CONTROL_ERROR_NO_OCCURRENCES != dropped_errors)
+        {
+            control_error_ts dropped = {ERROR_CODE_ERRORS_DROPPED, {IO_UNUSED, CONTROL_ID_UNUSED}, dropped_errors};
+            dropped_errors = CONTROL_ERROR_NO_OCCURRENCES;
+            routeError(&dropped);
+            next_error_report = current_millis + CONTROL_ERROR_REPORT_PERIOD_MS;
+            return;
+        }
+        if(CONTROL_ERROR_DROPPED_POSITION != position && CONTROL_ERROR_NO_OCCURRENCES != error_table[position].occurrences)
+        {
+            routeError(&error_table[position]);
+            error_table[position].occurrences = CONTROL_ERROR_NO_OCCURRENCES; // Entry is free until the error repeats
+            next_error_report = current_millis + CONTROL_ERROR_REPORT_PERIOD_MS;
+            return;
+        }
+    }
+}
+
+static void routeError(const control_error_ts *error)
+{
+    control_device_ts error_input = {INPUT_ERROR, CONTROL_ID_UNUSED}; // Initialize input type
+
+    // Initialize error data
+    error_slot.input_return.error_msg = *error;
+    error_slot.input = error_input;
+
+    // Attempt to send error data to serial console; if it fails, fallback to display
+    if (ERROR_CODE_NO_ERROR != routeDataToSink(CONTROL_OUTPUT_BIT_SERIAL_CONSOLE, &error_slot))
+    {
+        (void)routeDataToSink(CONTROL_OUTPUT_BIT_LCD_DISPLAY, &error_slot);
+    }
+}
+
+#ifdef CONTROL_HOST_COMMANDS_USED
+static void runHostCommands()
+{
+    // EXPORT is the longest host frame
+    uint8_t command[DATA_LOG_EXPORT_CMD_EXPORT_SIZE + SERIAL_FRAME_CRC_SIZE];
+    size_t command_len = serial_console_receiveFrame(command, sizeof(command));
+    if(0u != command_len)
+    {
+#ifdef DATA_LOG_COMPONENT
+        data_log_handleExportCommand(command, command_len, millis());
+#endif
+#ifdef PROFILING_COMPONENT
+        profiling_handleCommand(command, command_len);
+#endif
+#ifdef MEMORY_MONITOR_COMPONENT
+        memory_monitor_handleCommand(command, command_len);
+#endif
+#ifdef SETTINGS_COMPONENT
+        settings_handleCommand(command, command_len);
+#endif
+    }
+#ifdef SETTINGS_COMPONENT
+    if(settings_takeTrigger(SETTINGS_TRIGGER_DUMP_STATS))
+    {
+        // Same frames as the commands of the profiling and the memory monitor, their answers follow below
+#ifdef PROFILING_COMPONENT
+        uint8_t dump_command[PROFILING_CMD_DUMP_SIZE] = {PROFILING_CMD_DUMP, PROFILING_KEEP_AFTER_DUMP};
+        profiling_handleCommand(dump_command, sizeof(dump_command));
+#endif
+#ifdef MEMORY_MONITOR_COMPONENT
+        uint8_t query_command[MEMORY_MONITOR_CMD_QUERY_SIZE] = {MEMORY_MONITOR_CMD_QUERY};
+        memory_monitor_handleCommand(query_command, sizeof(query_command));
+#endif
+    }
+#endif
+
+    size_t frame_len = 0u;
+    uint8_t *frame = nullptr;
+#ifdef DATA_LOG_COMPONENT
+    frame = data_log_peekExportFrame(&frame_len);
+    if(nullptr != frame && serial_console_queueFrame(frame, frame_len))
+    {
+        data_log_releaseExportFrame();
+    }
+#endif
+#ifdef PROFILING_COMPONENT
+    frame = profiling_peekDumpFrame(&frame_len);
+    if(nullptr != frame && serial_console_queueFrame(frame, frame_len))
+    {
+        profiling_releaseDumpFrame();
+    }
+#endif
+#ifdef MEMORY_MONITOR_COMPONENT
+    frame = memory_monitor_peekReportFrame(&frame_len);
+    if(nullptr != frame && serial_console_queueFrame(frame, frame_len))
+    {
+        memory_monitor_releaseReportFrame();
+    }
+#endif
+#ifdef SETTINGS_COMPONENT
+    frame = settings_peekAnswerFrame(&frame_len);
+    if(nullptr != frame && serial_console_queueFrame(frame, frame_len))
+    {
+        settings_releaseAnswerFrame();
+    }
+#endif
+#ifdef GATEWAY_COMPONENT
+    frame = gateway_peekBatchFrame(&frame_len);
+    if(nullptr != frame && serial_console_queueFrame(frame, frame_len))
+    {
+        gateway_releaseBatchFrame();
+    }
+#endif
+}
+#endif
 /* *************************************** */
\ No newline at end of file
@@ -7,6 +7,18 @@
 #include "../input/sensors/sensors.h"
 #include "../output/display/display.h"
 #include "../output/serial_console/serial_console.h"
+#include "../output/data_log/data_log.h"
+#include "../output/radio/radio.h"
+#include "../input/gateway/gateway.h"
+#include "../i2c_bus/i2c_bus.h"
+#include "../history/history.h"
+#include "../profiling/profiling.h"
+#include "../memory_monitor/memory_monitor.h"
+#include "../settings/settings.h"
+#include "../bitset/bitset.h"
+#include "../watchdog/watchdog.h"
+#include "../platform/platform.h"
+#include "../spsc_ring/spsc_ring.h"
 #include "control_types.h"
 
 /* Index for components that are used in the system. */
@@ -15,14 +27,11 @@
 /* Index for components that are currently functioning. */
 #define CONTROL_COMPONENTS_STATUS_WORKING_INDEX  (uint8_t)(1u)
 
-/* Total number of component status entries. */
-#define CONTROL_COMPONENTS_STATUS_SIZE           (uint8_t)(2u)
-
-/* Macro defining a value (0) indicating all components are initialized */
-#define CONTROL_ALL_INITIALIZED                  (uint8_t)(0u)
+/* Index for components that are still settling after power on and come up in the background. */
+#define CONTROL_COMPONENTS_STATUS_PENDING_INDEX  (uint8_t)(2u)
 
-/* Macro defining a value (0) indicating component is initialized */
-#define CONTROL_COMPONENT_INITIALIZED            (uint8_t)(0u)
+/* Total number of component status entries. */
+#define CONTROL_COMPONENTS_STATUS_SIZE           (uint8_t)(3u)
 
 /* Macro indicating successful initialization */
 #define CONTROL_INITIALIZATION_SUCCESSFUL        (bool)(true)
@@ -31,46 +40,248 @@
 #define CONTROL_INITIALIZATION_FAILED            (bool)(false)
 
 /* Macro used for first initialization */
-#define CONTROL_FIRST_INIT                       (bool)(false)
+#define CONTROL_FIRST_INIT                       (uint8_t)(0u)
 
 /* Macro used for reinitialization */
-#define CONTROL_REINIT                           (bool)(true)
+#define CONTROL_REINIT                           (uint8_t)(1u)
+
+/* Macro used for the background bring-up of components which were still settling */
+#define CONTROL_BRING_UP                         (uint8_t)(2u)
+
+/* Macro used for the background recovery of one failed component, selected by control_recover() */
+#define CONTROL_RECOVER                          (uint8_t)(3u)
+
+/* Results of the background bring-up */
+#define CONTROL_BRING_UP_FINISHED                (bool)(true)
+#define CONTROL_BRING_UP_IN_PROGRESS             (bool)(false)
+
+/* Backoff of the background recovery, doubled after every pass in which no component came back */
+#define CONTROL_RECOVERY_MIN_BACKOFF_MS          (uint32_t)(1000u)
+#define CONTROL_RECOVERY_MAX_BACKOFF_EXPONENT    (uint8_t)(8u) /* About 4 minutes */
+#define CONTROL_RECOVERY_BACKOFF_MS(exponent)    (uint32_t)(CONTROL_RECOVERY_MIN_BACKOFF_MS << (exponent))
+/* Time after which a recovery pass stops retrying, the remaining components are retried in the next pass */
+#define CONTROL_RECOVERY_PASS_BUDGET_MS          (uint32_t)(50u)
+/* Positions of the recovery turns, one per bit of components_status_ts: outputs, other inputs and sensors */
+#define CONTROL_RECOVERY_NUM_OF_POSITIONS        (uint8_t)(CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS + CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS + CONTROL_NUM_OF_SENSOR_COMPONENT_BITS)
+
+/* Results of the background recovery */
+#define CONTROL_RECOVERY_SETTLING                (bool)(true)
+#define CONTROL_RECOVERY_NOT_SETTLING            (bool)(false)
+
+/* Watchdog resets in a row during the initialization or output of the same device after which the device is skipped at boot */
+#define CONTROL_WATCHDOG_SKIP_RESETS             (uint8_t)(2u)
+
+/* Timestamps without the RTC are seconds since boot */
+#define CONTROL_MS_PER_SECOND                    (uint32_t)(1000u)
+
+/* Flags returned by the deadband filter of the time independent outputs */
+#define CONTROL_READING_REPORTABLE               (bool)(true)
+#define CONTROL_READING_NOT_REPORTABLE           (bool)(false)
+
+/* No measurement was reported to the time independent outputs yet */
+#define CONTROL_NO_MEASUREMENT_REPORTED          (uint16_t)(0u)
+
+/* Number of different errors (error code and component) which are counted at the same time */
+#define CONTROL_ERROR_TABLE_SIZE                 (uint8_t)(8u)
+/* Period of the error reports, one error is reported per period */
+#define CONTROL_ERROR_REPORT_PERIOD_MS           (uint32_t)(1000u)
+/* Occurrences of an entry which has nothing new to report, the entry can be reused */
+#define CONTROL_ERROR_NO_OCCURRENCES             (uint16_t)(0u)
+/* Position of the dropped errors in the report turns, after the table entries */
+#define CONTROL_ERROR_DROPPED_POSITION           (uint8_t)(CONTROL_ERROR_TABLE_SIZE)
+
+/* Sink function of destination bits without a registered output */
+#define CONTROL_NO_SINK_FUNCTION                 (nullptr)
+
+/* SRAM left to the stack and the heap by the budget check of the static buffers: deepest task with the interrupt
+   frames on top of it, plus MEMORY_MONITOR_LOW_FREE_BYTES which the memory monitor expects to stay free */
+#define CONTROL_SRAM_RESERVE_BYTES               (uint16_t)(512u)
+
+
+/* Host frames are received when the serial console is used together with a module which answers them */
+#if defined(SERIAL_CONSOLE_COMPONENT) && (defined(DATA_LOG_COMPONENT) || defined(PROFILING_COMPONENT) || defined(MEMORY_MONITOR_COMPONENT) || defined(GATEWAY_COMPONENT) || defined(SETTINGS_COMPONENT))
+#define CONTROL_HOST_COMMANDS_USED
+#endif
+
+/* Entries of the output sinks table, an output which is not compiled in keeps its bit without a sink */
+#define CONTROL_NO_SINK                          {CONTROL_NO_SINK_FUNCTION, IO_UNUSED}
+
+#ifdef SERIAL_CONSOLE_COMPONENT
+#define CONTROL_SINK_SERIAL_CONSOLE              {serial_console_displayData, OUTPUT_SERIAL_CONSOLE}
+#else
+#define CONTROL_SINK_SERIAL_CONSOLE              CONTROL_NO_SINK
+#endif
+
+#ifdef DATA_LOG_COMPONENT
+#define CONTROL_SINK_DATA_LOG                    {data_log_displayData, OUTPUT_DATA_LOG}
+#else
+#define CONTROL_SINK_DATA_LOG                    CONTROL_NO_SINK
+#endif
+
+#ifdef RADIO_COMPONENT
+#define CONTROL_SINK_RADIO                       {radio_displayData, OUTPUT_RADIO}
+#else
+#define CONTROL_SINK_RADIO                       CONTROL_NO_SINK
+#endif
+
+#ifdef LCD_DISPLAY_COMPONENT
+#define CONTROL_SINK_LCD_DISPLAY                 {display_displayData, OUTPUT_DISPLAY}
+#else
+#define CONTROL_SINK_LCD_DISPLAY                 CONTROL_NO_SINK
+#endif
+
+/**
+ * Bits needed by every group of components, the highest ID of an enabled *_COMPONENT plus one.
+ * The first entry is the size of a group without any enabled component.
+ */
+static constexpr uint8_t control_sensor_component_bits[] =
+{
+    0u,
+#ifdef DHT11_COMPONENT
+    DHT11_COMPONENT + 1u,
+#endif
+#ifdef BMP280_COMPONENT
+    BMP280_COMPONENT + 1u,
+#endif
+#ifdef BH1750_COMPONENT
+    BH1750_COMPONENT + 1u,
+#endif
+#ifdef MQ135_COMPONENT
+    MQ135_COMPONENT + 1u,
+#endif
+#ifdef MQ7_COMPONENT
+    MQ7_COMPONENT + 1u,
+#endif
+#ifdef GYML8511_COMPONENT
+    GYML8511_COMPONENT + 1u,
+#endif
+#ifdef ARDUINORAIN_COMPONENT
+    ARDUINORAIN_COMPONENT + 1u,
+#endif
+};
+
+static constexpr uint8_t control_other_input_component_bits[] =
+{
+    0u,
+#ifdef RTC_COMPONENT
+    RTC_COMPONENT + 1u,
+#endif
+#ifdef GATEWAY_COMPONENT
+    GATEWAY_COMPONENT + 1u,
+#endif
+};
+
+static constexpr uint8_t control_output_component_bits[] =
+{
+    0u,
+#ifdef SERIAL_CONSOLE_COMPONENT
+    SERIAL_CONSOLE_COMPONENT + 1u,
+#endif
+#ifdef LCD_DISPLAY_COMPONENT
+    LCD_DISPLAY_COMPONENT + 1u,
+#endif
+#ifdef DATA_LOG_COMPONENT
+    DATA_LOG_COMPONENT + 1u,
+#endif
+#ifdef RADIO_COMPONENT
+    RADIO_COMPONENT + 1u,
+#endif
+};
+
+/**
+ * @brief Checks at compile time if a component bit is in a part of a list of component bits.
+ *
+ * @param bit Component bit which is searched.
+ * @param bits List of component bits.
+ * @param count Number of entries of the list.
+ * @param entry First entry which is checked (recursive, C++11 constexpr).
+ * @return bool true if the bit is found, false otherwise.
+ */
+static constexpr bool control_isComponentBitListed(uint8_t bit, const uint8_t *bits, uint8_t count, uint8_t entry)
+{
+    return (entry >= count) ? false : (bit == bits[entry]) || control_isComponentBitListed(bit, bits, count, entry + 1u);
+}
+
+/**
+ * @brief Finds the largest entry of a list of component bits at compile time.
+ *
+ * @param bits List of component bits.
+ * @param count Number of entries from the start of the list which are checked (recursive, C++11 constexpr).
+ * @return uint8_t Largest entry.
+ */
+static constexpr uint8_t control_maxComponentBits(const uint8_t *bits, uint8_t count)
+{
+    return (0u == count) ? 0u :
+           (bits[count - 1u] > control_maxComponentBits(bits, count - 1u)) ? bits[count - 1u] : control_maxComponentBits(bits, count - 1u);
+}
+
+/**
+ * @brief Checks at compile time that no two enabled components of a group share an ID.
+ *
+ * @param bits List of component bits, the first entry (empty group) is not checked.
+ * @param count Number of entries from the start of the list which are checked (recursive, C++11 constexpr).
+ * @param entry Entry which is compared with all entries after it.
+ * @return bool true if every enabled component has its own ID, false otherwise.
+ */
+static constexpr bool control_areComponentBitsUnique(const uint8_t *bits, uint8_t count, uint8_t entry = 1u)
+{
+    return (entry + 1u >= count) ? true :
+           !control_isComponentBitListed(bits[entry], bits, count, entry + 1u) && control_areComponentBitsUnique(bits, count, entry + 1u);
+}
+
+/* Sizes of the bitsets of components_status_ts */
+#define CONTROL_NUM_OF_SENSOR_COMPONENT_BITS        (control_maxComponentBits(control_sensor_component_bits, sizeof(control_sensor_component_bits)))
+#define CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS   (control_maxComponentBits(control_other_input_component_bits, sizeof(control_other_input_component_bits)))
+#define CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS        (control_maxComponentBits(control_output_component_bits, sizeof(control_output_component_bits)))
+
+typedef bitset_ts<CONTROL_NUM_OF_SENSOR_COMPONENT_BITS> control_sensors_bitset_t;
+typedef bitset_ts<CONTROL_NUM_OF_OTHER_INPUT_COMPONENT_BITS> control_other_inputs_bitset_t;
+typedef bitset_ts<CONTROL_NUM_OF_OUTPUT_COMPONENT_BITS> control_outputs_bitset_t;
 
 /**
  * @brief Structure to track the status of system components.
  *
- * This structure contains bit fields where each bit represents the status of a specific component.  
- * A bit set to 1 indicates that the component is in use or functioning, while a bit set to 0 indicates it is not.
+ * This structure contains bitsets where each bit represents the status of a specific component, the bit
+ * index is the ID of the *_COMPONENT define. A bit set to 1 indicates that the component is in use or
+ * functioning, while a bit set to 0 indicates it is not. Every bitset is sized at compile time for the
+ * enabled components of its group (see bitset.h), `{}` clears every bit.
  *
  * Fields:
- * - `sensors_status` (uint64_t):  
- *   - Each bit (0-63) represents the status of a sensor.  
- *   - Supports up to 64 different sensors.
- * - `other_inputs_status` (uint8_t):  
- *   - Each bit (0-7) represents the status of other input components (e.g., RTC, buttons, etc.).  
- *   - Supports up to 8 different other input components.
- * - `outputs_status` (uint8_t):  
- *   - Each bit (0-7) represents the status of output components (e.g., display, serial console, etc.).  
- *   - Supports up to 8 different output components.
+ * - `sensors_status`: Status of the sensors.
+ * - `other_inputs_status`: Status of the other input components (e.g., RTC, buttons, etc.).
+ * - `outputs_status`: Status of the output components (e.g., display, serial console, etc.).
  */
 typedef struct
 {
-    uint64_t sensors_status;
-    uint8_t other_inputs_status;
-    uint8_t outputs_status;
+    control_sensors_bitset_t sensors_status;
+    control_other_inputs_bitset_t other_inputs_status;
+    control_outputs_bitset_t outputs_status;
 } components_status_ts;
 
 /**
  * @brief Performs the first-time initialization of all system components.
  * 
- * Calls the control_initialize function with CONTROL_FIRST_INIT to initialize 
- * all outputs, inputs, and sensors from a fresh state.
+ * Calls the control_initialize function with CONTROL_FIRST_INIT to start the initialization of
+ * all outputs, inputs, and sensors from a fresh state. Nothing waits for settle times, components
+ * which are not ready yet report ERROR_CODE_INIT_PENDING and are brought up by control_bringUp().
+ * After a watchdog reset the hung task or device is reported, a device which hung the station
+ * CONTROL_WATCHDOG_SKIP_RESETS times in a row is not initialized until the next reset.
  * 
  * @return CONTROL_INITIALIZATION_SUCCESSFUL if all components initialize correctly, 
- *         otherwise CONTROL_INITIALIZATION_FAILED.
+ *         otherwise CONTROL_INITIALIZATION_FAILED (also while some components are pending).
  */
 bool control_init();
 
+/**
+ * @brief Retries the initialization of the components which were still settling.
+ *
+ * Calls the control_initialize function with CONTROL_BRING_UP, so every pending component
+ * comes up as soon as its own settle time is over. Components that failed are left to control_recover().
+ *
+ * @return CONTROL_BRING_UP_FINISHED if no component is pending anymore, otherwise CONTROL_BRING_UP_IN_PROGRESS.
+ */
+bool control_bringUp();
+
 /**
  * @brief Attempts to reinitialize any uninitialized system components.
  * 
@@ -83,49 +294,170 @@ bool control_init();
 bool control_reinit();
 
 /**
- * @brief Routes data to the specified output component.
+ * @brief Retries the initialization of the failed components in the background, with exponential backoff.
  *
- * This function forwards data fetched from an input component to one of the
- * defined output components. It returns an error code that can be passed
- * to the Error Manager for handling.
+ * Failed components are the used ones which are neither working nor pending. They are retried one at a
+ * time in a round-robin, each after a recovery of the I2C bus (see i2c_bus_recover()), until every one was
+ * retried once or the pass took CONTROL_RECOVERY_PASS_BUDGET_MS. The next pass starts after the backoff,
+ * which is reset when a component came back or nothing is failed and doubled otherwise, up to
+ * CONTROL_RECOVERY_BACKOFF_MS(CONTROL_RECOVERY_MAX_BACKOFF_EXPONENT). A retried component which is
+ * settling again is left to control_bringUp().
  *
- * @param output_component The ID of the output component to which the data
- *                         is forwarded (e.g., display, serial console).
- * @param data             Pointer to the actual data to be forwarded, which must match
- *                         the format/type of data part returned by the data fetch function.
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return CONTROL_RECOVERY_SETTLING if some component is pending after the pass, otherwise CONTROL_RECOVERY_NOT_SETTLING.
+ */
+bool control_recover(uint32_t current_millis);
+
+/**
+ * @brief Routes data to every selected output.
+ *
+ * The outputs are looked up in the output sinks table by their bit in `outputs`, so the
+ * data is dispatched to all selected sinks in one pass over the set bits. Bits without a
+ * registered sink are skipped. An error of a sink is passed to the Error Handler together
+ * with the output component of the sink.
+ *
+ * @param outputs Bitmask of the destinations (e.g., SERIAL_CONSOLE | LCD_DISPLAY).
+ * @param data    Pointer to the actual data to be forwarded, which must match
+ *                the format/type of data part returned by the data fetch function.
+ *                Outputs read the data in place, it is never copied.
  *
- * @return An error code of type `control_error_code_te` indicating the
- *         status of the routing operation.
+ * @return `ERROR_CODE_NO_ERROR` if every selected sink succeeded, otherwise the error
+ *         code of the last failed sink.
  */
-control_error_code_te control_routeDataToOutput(control_io_t output_component,
-                                                const control_data_ts *data);
+control_error_code_te control_routeDataToOutputs(output_destination_t outputs, const control_data_ts *data);
+
+/**
+ * @brief Checks if data routed to the outputs is still waiting to be shown by one of them.
+ *
+ * Only the LCD keeps a frame back while the previous one is on the bus, the frame is sent by
+ * the next data routed to it.
+ *
+ * @param outputs Bitmask of the destinations the data was routed to.
+ * @return true if a selected output does not show the data yet, it should be routed again later.
+ */
+bool control_isOutputPending(output_destination_t outputs);
 
 /**
  * @brief Fetches data from the specified input component.
  *
  * This function retrieves data from a specified input component (e.g., sensors, RTC)
- * and returns it as a structured result. One part of the fetched data can then be used by
- * output components and the other can be forwarded to an Error manager.
+ * and writes it directly into a slot owned by the caller. The slot can then be passed
+ * to output components as it is and the returned error code can be forwarded to an Error manager.
  *
  * @param input_device Pointer to structure with ID of the input component from which data is fetched
  *         (e.g., sensors, RTC) and the specific ID within the input component (e.g., sensor ID).
+ * @param slot Pointer to the caller owned (statically allocated) data slot. The input component
+ *         fills the union member in place and `input` is set to the fetched device.
+ *
+ * @return An error code of type `control_error_code_te` for the Error Handler,
+ *         `ERROR_CODE_INVALID_INPUT` if the input component is unknown.
+ */
+control_error_code_te control_fetchDataFromInput(const control_device_ts *input_device, control_data_ts *slot);
+
+/**
+ * @brief Samples a sensor and refreshes its cached reading.
+ *
+ * The only path which reads the sensor hardware, it is used by the scheduler at the sample period
+ * of the sensor. control_fetchDataFromInput() returns the cached readings afterwards.
+ *
+ * @param sensor_id ID of the sensor to be sampled.
+ * @param slot Pointer to the caller owned data slot which receives the reading.
+ *
+ * @return control_error_code_te Error code of the reading (see sensors_sampleReading).
+ */
+control_error_code_te control_sampleSensor(uint8_t sensor_id, control_data_ts *slot);
+
+/**
+ * @brief Returns the timestamp given to the readings and log records.
+ *
+ * @return uint32_t Seconds since 2000-01-01 00:00:00 from the RTC epoch, seconds since boot
+ *         if the RTC is not used or not synchronized yet.
+ */
+uint32_t control_getTimestamp();
+
+/**
+ * @brief Runs background work of the input components.
+ *
+ * Supervises the I2C bus jobs and forwards the call to the sensors loop, which takes time critical
+ * samples (for example MQ7 CO sample at the end of the low heater phase), and to the RTC,
+ * both of which refresh their latest data with background I2C jobs.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void control_runInputsBackground(unsigned long current_millis);
+
+/**
+ * @brief Runs background work of the output components.
  *
- * @return A structure of type `control_input_data_ts` has two parts.
- *         `data` - containing the fetched data, input type, and component ID.
- *         `error_msg` - containing error code, flag for input/output and the details of the
- *         component( ID, etc.)
+ * Supervises the I2C bus jobs of the display and forwards the call to the serial console,
+ * which feeds queued lines to the UART without blocking, and to the log, which writes full blocks
+ * and streams the log export requested over the serial console. Reports the counted errors at a bounded rate.
  */
-control_input_data_ts control_fetchDataFromInput(const control_device_ts *input_device);
+void control_runOutputsBackground();
 
 /**
- * @brief Handles and routes error messages to the appropriate output.
+ * @brief Builds an error message of a component, its occurrences start at zero.
  *
- * This function takes an error message, packages it into a control data structure, 
- * and attempts to route it to the serial console first. If that fails, it falls back 
- * to routing the error message to the display output.
+ * @param error_code Error code of the component.
+ * @param component Component which reported the error.
+ * @return control_error_ts Error message for control_handleError().
+ */
+control_error_ts control_makeError(control_error_code_te error_code, control_device_ts component);
+
+/**
+ * @brief Counts an error in the error table, nothing is output right away.
+ *
+ * Repeats of the same error code from the same component are counted in one entry. The outputs background
+ * reports one entry with new occurrences every CONTROL_ERROR_REPORT_PERIOD_MS, in turns, to the serial
+ * console first and to the display if that fails. Errors which find the table full are counted and
+ * reported as ERROR_CODE_ERRORS_DROPPED.
  *
- * @param error Pointer to the error message structure to be handled.
+ * @param error Pointer to the error message structure to be handled, its occurrences are not used.
  */
 void control_handleError(const control_error_ts *error);
 
+/**
+ * @brief Checks if the log is being exported over the serial console.
+ *
+ * While the export runs, the outputs background should be called more often, every call moves one block.
+ *
+ * @return true if an export is running, false otherwise (also without the log component).
+ */
+bool control_isLogExportActive();
+
+/**
+ * @brief Checks if the profiling statistics are being dumped over the serial console.
+ *
+ * While the dump runs, the outputs background should be called more often, every call sends one slot.
+ *
+ * @return true if a dump is running, false otherwise (also without the profiling component).
+ */
+bool control_isProfilingDumpActive();
+
+/**
+ * @brief Adds a sensor reading to the history of its measurement.
+ *
+ * Only successful value readings of the measurements in the series table of the history are recorded,
+ * indications and other inputs are ignored.
+ * Does nothing if HISTORY_COMPONENT is not enabled.
+ *
+ * @param data Pointer to the slot filled by control_fetchDataFromInput() without an error.
+ * @param current_millis Time of the reading in milliseconds (millis() based).
+ */
+void control_recordHistory(const control_data_ts *data, uint32_t current_millis);
+
+/**
+ * @brief Checks if a sensor reading should be sent to the time independent outputs.
+ *
+ * A reading is reportable when it is the first one of its measurement, when it differs from the last
+ * reported reading by more than the deadband of the catalog entry, or when the max silence of the
+ * entry passed since the last report (heartbeat). The reading is remembered as the last reported one
+ * when it is reportable. Readings of other inputs are always reportable.
+ *
+ * @param data Pointer to the slot filled by control_fetchDataFromInput() without an error.
+ * @param current_millis Time of the reading in milliseconds (millis() based).
+ * @return true (CONTROL_READING_REPORTABLE) if the reading should be routed, false otherwise.
+ */
+bool control_isReadingReportable(const control_data_ts *data, uint32_t current_millis);
+
 #endif
\ No newline at end of file
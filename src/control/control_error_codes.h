@@ -27,6 +27,7 @@ typedef enum
   ERROR_CODE_SENSORS_MEASUREMENT_TYPE_MISSING_FUNCTION,
   ERROR_CODE_INVALID_VALUE_FROM_SENSOR,
   ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR,
+  ERROR_CODE_SENSOR_READING_STALE, /* Sensor was not sampled within the max age of its cached reading */
   /* ********************************* */
 
   /* RTC related */
@@ -42,6 +43,29 @@ typedef enum
 
   /* Init related */
   ERROR_CODE_INIT_FAILED,
+  ERROR_CODE_INIT_PENDING, /* Component is still settling after power on, init is retried in the background */
+  /* ********************************* */
+
+  /* Memory related */
+  ERROR_CODE_MEMORY_LOW, /* Free SRAM between the heap and the stack dropped below MEMORY_MONITOR_LOW_FREE_BYTES */
+  /* ********************************* */
+
+  /* Error reporting related */
+  ERROR_CODE_ERRORS_DROPPED, /* Errors which were not counted because the error table was full */
+  /* ********************************* */
+
+  /* Watchdog related */
+  ERROR_CODE_WATCHDOG_RESET, /* Station was reset by the watchdog, the component is the hung device or {IO_UNUSED, task ID} */
+  ERROR_CODE_COMPONENT_SKIPPED, /* Component hung the station CONTROL_WATCHDOG_SKIP_RESETS times in a row and is not initialized */
+  /* ********************************* */
+
+  /* History related */
+  ERROR_CODE_HISTORY_EMPTY, /* Sensor has no history yet or keeps none (indication or not sampled periodically) */
+  /* ********************************* */
+
+  /* Calibration related */
+  ERROR_CODE_CALIBRATION_TOO_FEW_SAMPLES, /* Sensor gave less than SENSORS_MQ_CALIBRATION_MIN_SAMPLES valid samples, R0 is not changed */
+  ERROR_CODE_CALIBRATION_UNSTABLE, /* Samples spread more than SENSORS_MQ_CALIBRATION_MAX_DEVIATION_PERCENT, the air was not clean, R0 is not changed */
   /* ********************************* */
 } control_error_code_te;
 
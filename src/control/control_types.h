@@ -28,13 +28,20 @@ typedef uint8_t control_io_t;
 typedef enum
 {   
     INPUT_SENSORS,          /**< Input for sensors. */
+    INPUT_SENSORS_SNAPSHOT, /**< Input for all sensors read in a single sweep. */
 
 #ifdef RTC_COMPONENT
     INPUT_RTC,              /**< Input for the Real-Time Clock (RTC). */
 #endif
 
+#ifdef GATEWAY_COMPONENT
+    INPUT_GATEWAY,          /**< Input for the packets of the remote stations. */
+#endif
+
     INPUT_I2C_SCAN,         /**< Input for I2C address scanning. */
     INPUT_ERROR,            /**< Input for error. */
+    INPUT_VIEW_PAGE,        /**< Page of the display view, composed of the readings of other inputs. */
+    INPUT_HISTORY,          /**< Trend of the latest samples of a sensor from the history. */
 
 #ifdef LCD_DISPLAY_COMPONENT
     OUTPUT_DISPLAY,         /**< Output component for a display device. */
@@ -44,6 +51,14 @@ typedef enum
     OUTPUT_SERIAL_CONSOLE,  /**< Output component for the serial console. */
 #endif
 
+#ifdef DATA_LOG_COMPONENT
+    OUTPUT_DATA_LOG,        /**< Output component for the log in an external memory. */
+#endif
+
+#ifdef RADIO_COMPONENT
+    OUTPUT_RADIO,           /**< Output component for the LoRa uplink. */
+#endif
+
     IO_UNUSED = 0xFF
 } control_io_te;
 
@@ -71,13 +86,18 @@ typedef struct
  * Members:
  *  - error_code: The error code identifying the specific type of error.
  *  - component: Contains detailed information about the affected input/output component.
+ *  - occurrences: Number of times the error occurred since its last report, set by the error aggregation.
  */
 typedef struct
 {
     control_error_code_te error_code; /**< The specific error code. */
     control_device_ts component;      /**< Detailed information about the error source and the ID of the component */
+    uint16_t occurrences;             /**< Occurrences since the last report, saturates at UINT16_MAX */
 } control_error_ts;
 
+/* Forward declaration of the structure */
+struct control_view_page;
+
 /**
  * Union for handling various input types dynamically.
  *
@@ -89,18 +109,26 @@ typedef struct
  * Fields:
  *  - sensor_reading:     Contains data specific to sensor readings, such as value,
  *                        measurement type, and sensor ID.
+ *  - sensors_snapshot:   Points to readings of all sensors taken in one sweep. Only a pointer is
+ *                        stored so the union does not grow with the number of sensors, the snapshot
+ *                        is valid until the next snapshot is fetched.
  *  - rtc_reading:        Contains data specific to RTC readings, such as date and time.
  *  - i2c_scan_reading:    Contains data specific to I2C scan readings,
  *                        such as addresses bit fields or I2C device status.
  *  - error_msg           Contains data specific to the error message, such as error source,
  *                        input/output flag and specific error code.
+ *  - view_page:          Points to the rows of a display page, owned by the view engine of the app.
+ *  - trend_reading:      Contains the latest samples of a sensor scaled to bar levels.
  */
 typedef union
 {
     sensor_reading_ts sensor_reading;       /**< Data structure for sensor readings. */
+    const sensors_snapshot_ts *sensors_snapshot; /**< Pointer to readings of all sensors from one sweep. */
     rtc_reading_ts rtc_reading;             /**< Data structure for RTC readings. */
     i2c_scan_reading_ts i2c_scan_reading;   /**< Data structure for I2C scan readings. */
     control_error_ts error_msg;             /**< Data structure for error message. */
+    const struct control_view_page *view_page; /**< Pointer to the rows of a display page. */
+    trend_reading_ts trend_reading;         /**< Data structure for the trend of a sensor. */
 } input_return_tu;
 
 /**
@@ -123,24 +151,70 @@ typedef struct
     control_device_ts input;         /**< Structure with input type and ID. */
 } control_data_ts;
 
+/* Number of rows of a display page, one row of the LCD per row of the page */
+#define CONTROL_VIEW_PAGE_ROWS         (uint8_t)(2u)
+
+/**
+ * Structure representing a page of the display view.
+ *
+ * Members:
+ *  - rows: Data shown in every row, a row with the input IO_UNUSED is left blank.
+ */
+typedef struct control_view_page
+{
+    control_data_ts rows[CONTROL_VIEW_PAGE_ROWS]; /**< Data of every row of the page. */
+} control_view_page_ts;
+
+/* Type for representing and managing output destinations (supports up to 16 different output options) */
+typedef uint16_t output_destination_t;
+
+/* Number of output destinations, every bit of output_destination_t selects one output sink */
+#define CONTROL_NUM_OF_OUTPUT_BITS     (uint8_t)(16u)
+
+/* Bit of every output in output_destination_t, used as the index into the output sinks table */
+#define CONTROL_OUTPUT_BIT_SERIAL_CONSOLE (uint8_t)(0u)
+#define CONTROL_OUTPUT_BIT_DATA_LOG       (uint8_t)(1u)
+#define CONTROL_OUTPUT_BIT_RADIO          (uint8_t)(2u)
+#define CONTROL_OUTPUT_BIT_LCD_DISPLAY    (uint8_t)(8u)
+
+/** Bitmask macros for output destinations:
+ * - The first 8 bits (0x00FF) are for time-independent outputs (supports up to 8 outputs at once).
+ * - The second 8 bits (0xFF00) are for time-dependent outputs (supports up to 8 outputs at once, e.g., display).
+ * - ALL_OUTPUTS combines both time-independent and time-dependent outputs (16 bits in total).
+ */
+/* Output option for serial console(can show all at once or sequentially) */
+#define SERIAL_CONSOLE                 (output_destination_t)(1u << CONTROL_OUTPUT_BIT_SERIAL_CONSOLE) /* 6 bits reserved for the future outputs */
+/* Output option for the log in an external memory(stores readings all at once) */
+#define DATA_LOG                       (output_destination_t)(1u << CONTROL_OUTPUT_BIT_DATA_LOG)
+/* Output option for the LoRa uplink(sends the newest snapshot once per interval) */
+#define RADIO_UPLINK                   (output_destination_t)(1u << CONTROL_OUTPUT_BIT_RADIO)
+/* Output option for displays(cannot show all at once) */
+#define LCD_DISPLAY                    (output_destination_t)(1u << CONTROL_OUTPUT_BIT_LCD_DISPLAY) /* 7 bits reserved for the future outputs */
+/* Outputs that can be sent independently of time constraints(all at once) */
+#define ALL_TIME_INDEPENDENT_OUTPUTS   (output_destination_t)(0x00FF)
+/* Outputs that require time constraints (e.g., display) */
+#define ALL_TIME_DEPENDENT_OUTPUTS     (output_destination_t)(0xFF00)
+/* Used to indicate all outputs */
+#define ALL_OUTPUTS                    (output_destination_t)(0xFFFF)
+/* Used to indicate no outputs are set */
+#define NO_OUTPUTS                     (output_destination_t)(0x0000)
+
+/* Function pointer type of an output sink, the sink reads the routed data in place */
+typedef control_error_code_te (*control_output_sink_fn)(const control_data_ts *data);
+
 /**
- * Structure for managing the dual output of data fetching operations.
+ * Structure describing an output sink registered for one bit of `output_destination_t`.
  *
- * This structure is designed to encapsulate two outputs resulting from
- * a data fetch operation. One part (`data`) contains the fetched data
- * that can be forwarded to an output component, while the other part
- * (`error_code`) contains an error message to be handled by the Error Handler.
+ * Entries are stored in program memory and indexed directly by the bit of the output.
  *
  * Members:
- *  - data:       Contains the fetched data, encapsulated in the `control_data_ts`
- *                structure, to be forwarded to an output component (e.g., display, console).
- *  - error_code: Represents the error message of type `control_error_code_te`
- *                that can be passed to the Error Handler for further processing.
+ *  - sink_function: Function which writes the data to the output, `CONTROL_NO_SINK_FUNCTION` for unused bits.
+ *  - output_component: Output component reported together with an error of the sink.
  */
 typedef struct
 {
-    control_data_ts data;             /**< The fetched data for output forwarding. */
-    control_error_code_te error_code;  /**< The error code for the Error Handler. */
-} control_input_data_ts;
+    control_output_sink_fn sink_function;  /**< Function writing the data to the output. */
+    control_io_t output_component;         /**< Output component of the sink. */
+} control_output_sink_ts;
 
 #endif
\ No newline at end of file
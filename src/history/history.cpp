@@ -0,0 +1,253 @@
+#include "history.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* SERIES TABLE - MEASUREMENTS WITH A HISTORY, THE TRENDS OF THE VIEW, THE POSITION IS THE SERIES INDEX */
+static const uint8_t series_sensor_ids[] PLATFORM_PROGMEM =
+{
+#ifdef DHT11_TEMPERATURE
+  DHT11_TEMPERATURE,
+#endif
+#ifdef BMP280_PRESSURE
+  BMP280_PRESSURE,
+#endif
+  INVALID_SENSOR_ID // Keeps the table valid without any series
+};
+
+/* Number of series, without the closing entry */
+static constexpr uint8_t history_num_of_series = (uint8_t)(sizeof(series_sensor_ids) / sizeof(series_sensor_ids[0]) - 1u);
+
+static history_series_ts history[history_num_of_series];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(0u == (HISTORY_RING_SIZE & (HISTORY_RING_SIZE - 1u)), "Ring size must be a power of two");
+static_assert(HISTORY_RING_SIZE <= UINT8_MAX, "Ring indexes are 8-bit");
+static_assert(HISTORY_RING_SIZE <= TREND_MAX_SAMPLES, "Every sample of the ring must fit into a trend");
+static_assert(0u < history_num_of_series, "HISTORY_COMPONENT needs at least one measurement in the series table, disable it otherwise");
+static_assert(sizeof(history) <= HISTORY_MAX_FOOTPRINT_BYTES, "History takes more SRAM than HISTORY_MAX_FOOTPRINT_BYTES, remove series from the table");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Adds a value to a bucket, the sum stops growing when the bucket is full.
+ *
+ * @param bucket Pointer to the bucket.
+ * @param value Value (sample or minute mean) to add.
+ */
+static void addToBucket(history_bucket_ts *bucket, int32_t value);
+
+/**
+ * @brief Completes the current minute bucket and passes its mean to the hour bucket.
+ *
+ * The hour bucket is completed first if the new minute belongs to another hour.
+ *
+ * @param series Pointer to the series.
+ * @param new_minute_number Minute (since boot) of the sample which closed the bucket.
+ */
+static void completeMinute(history_series_ts *series, uint16_t new_minute_number);
+
+/**
+ * @brief Starts the ring again with a single sample.
+ *
+ * @param series Pointer to the series.
+ * @param value First sample of the ring.
+ */
+static void restartRing(history_series_ts *series, int32_t value);
+
+/**
+ * @brief Finds the series of a measurement in the series table.
+ *
+ * @param sensor_id ID of the measurement.
+ * @return history_series_ts* Series of the measurement, nullptr if it has no history.
+ */
+static history_series_ts *findSeries(uint8_t sensor_id);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void history_addSample(uint8_t sensor_id, int32_t value, uint32_t current_millis)
+{
+  history_series_ts *series = findSeries(sensor_id);
+  if(nullptr == series)
+  {
+    return;
+  }
+
+  // Ring of differences
+  int32_t delta = value - series->newest_value;
+  if(0u == series->count || HISTORY_DELTA_MIN > delta || HISTORY_DELTA_MAX < delta)
+  {
+    restartRing(series, value); // Step does not fit a difference, the nearby history is not continuous anyway
+  }
+  else
+  {
+    if(HISTORY_RING_SIZE == series->count)
+    {
+      // Drop the oldest sample, the next one becomes the start of the differences
+      series->head = (uint8_t)((series->head + 1u) & (HISTORY_RING_SIZE - 1u));
+      series->oldest_value += series->deltas[series->head];
+      series->count--;
+    }
+    series->deltas[(uint8_t)((series->head + series->count) & (HISTORY_RING_SIZE - 1u))] = (int8_t)delta;
+    series->count++;
+    series->newest_value = value;
+  }
+
+  // Rollups
+  uint16_t minute_number = (uint16_t)(current_millis / HISTORY_MINUTE_MS);
+  if(0u != series->current[HISTORY_WINDOW_MINUTE].count && minute_number != series->minute_number)
+  {
+    completeMinute(series, minute_number);
+  }
+  series->minute_number = minute_number;
+  addToBucket(&series->current[HISTORY_WINDOW_MINUTE], value);
+}
+
+bool history_getStats(uint8_t sensor_id, uint8_t window, history_stats_ts *stats)
+{
+  const history_series_ts *series = findSeries(sensor_id);
+  if(nullptr == series || HISTORY_NUM_OF_WINDOWS <= window)
+  {
+    return HISTORY_STATS_INVALID;
+  }
+
+  const history_bucket_ts *bucket = &series->completed[window];
+  if(0u == bucket->count)
+  {
+    return HISTORY_STATS_INVALID; // Window is not complete yet
+  }
+
+  stats->min = bucket->min;
+  stats->max = bucket->max;
+  stats->mean = bucket->sum / bucket->count;
+  return HISTORY_STATS_VALID;
+}
+
+bool history_getTrend(uint8_t sensor_id, int32_t *change)
+{
+  const history_series_ts *series = findSeries(sensor_id);
+  if(nullptr == series || 2u > series->count)
+  {
+    return HISTORY_STATS_INVALID;
+  }
+
+  *change = series->newest_value - series->oldest_value;
+  return HISTORY_STATS_VALID;
+}
+
+uint8_t history_getSamples(uint8_t sensor_id, int32_t *samples, uint8_t max_samples)
+{
+  const history_series_ts *series = findSeries(sensor_id);
+  if(nullptr == series)
+  {
+    return 0u;
+  }
+
+  uint8_t skipped = (series->count > max_samples) ? (uint8_t)(series->count - max_samples) : 0u;
+  uint8_t written = 0u;
+  int32_t value = series->oldest_value;
+
+  for (uint8_t i = 0u; i < series->count; i++)
+  {
+    if(0u != i)
+    {
+      value += series->deltas[(uint8_t)((series->head + i) & (HISTORY_RING_SIZE - 1u))];
+    }
+    if(i >= skipped)
+    {
+      samples[written] = value;
+      written++;
+    }
+  }
+
+  return written;
+}
+
+bool history_getLevels(uint8_t sensor_id, trend_reading_ts *trend)
+{
+  int32_t samples[HISTORY_RING_SIZE];
+  uint8_t num_of_samples = history_getSamples(sensor_id, samples, HISTORY_RING_SIZE);
+
+  trend->num_of_samples = num_of_samples;
+  if(0u == num_of_samples)
+  {
+    return HISTORY_STATS_INVALID;
+  }
+
+  int32_t min = samples[0];
+  int32_t max = samples[0];
+  for (uint8_t i = 1u; i < num_of_samples; i++)
+  {
+    min = (samples[i] < min) ? samples[i] : min;
+    max = (samples[i] > max) ? samples[i] : max;
+  }
+
+  // Range of neighbouring samples is limited by the 8-bit deltas, the product fits into 32 bits
+  int32_t range = max - min;
+  for (uint8_t i = 0u; i < num_of_samples; i++)
+  {
+    trend->levels[i] = (0 == range) ? HISTORY_FLAT_LEVEL :
+                       (uint8_t)(TREND_MIN_LEVEL + ((samples[i] - min) * (TREND_MAX_LEVEL - TREND_MIN_LEVEL) + range / 2) / range);
+  }
+  return HISTORY_STATS_VALID;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void addToBucket(history_bucket_ts *bucket, int32_t value)
+{
+  if(0u == bucket->count)
+  {
+    bucket->min = value;
+    bucket->max = value;
+    bucket->sum = 0;
+  }
+  bucket->min = (value < bucket->min) ? value : bucket->min;
+  bucket->max = (value > bucket->max) ? value : bucket->max;
+
+  if(HISTORY_BUCKET_MAX_COUNT > bucket->count)
+  {
+    bucket->sum += value; // Catalog ranges are far below INT32_MAX / HISTORY_BUCKET_MAX_COUNT
+    bucket->count++;
+  }
+}
+
+static void completeMinute(history_series_ts *series, uint16_t new_minute_number)
+{
+  history_bucket_ts *minute = &series->current[HISTORY_WINDOW_MINUTE];
+  history_bucket_ts *hour = &series->current[HISTORY_WINDOW_HOUR];
+
+  // Hour is built from the minute rollups, min and max are exact, the mean is the mean of the minute means
+  addToBucket(hour, minute->sum / minute->count);
+  hour->min = (minute->min < hour->min) ? minute->min : hour->min;
+  hour->max = (minute->max > hour->max) ? minute->max : hour->max;
+
+  if((uint16_t)(new_minute_number / HISTORY_MINUTES_PER_HOUR) != (uint16_t)(series->minute_number / HISTORY_MINUTES_PER_HOUR))
+  {
+    series->completed[HISTORY_WINDOW_HOUR] = *hour;
+    hour->count = 0u;
+  }
+
+  series->completed[HISTORY_WINDOW_MINUTE] = *minute;
+  minute->count = 0u;
+}
+
+static void restartRing(history_series_ts *series, int32_t value)
+{
+  series->oldest_value = value;
+  series->newest_value = value;
+  series->head = 0u;
+  series->count = 1u;
+}
+
+static history_series_ts *findSeries(uint8_t sensor_id)
+{
+  for (uint8_t series_index = 0u; series_index < history_num_of_series; series_index++)
+  {
+    if(sensor_id == PLATFORM_READ_BYTE(&series_sensor_ids[series_index]))
+    {
+      return &history[series_index];
+    }
+  }
+  return nullptr;
+}
+/* *************************************** */
@@ -0,0 +1,159 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "../platform/platform.h"
+#include "../input/input_types.h"
+
+/**
+ * @file history.h
+ * @brief Time series history of the sensor measurements in SRAM.
+ *
+ * The value measurements in the series table (history.cpp) keep a ring of the latest samples and
+ * rollups of the last complete minute and hour, the other measurements are not recorded. Samples are stored as 8-bit differences to the
+ * previous sample in the scaled integer format of the catalog entry, rollups are updated with every
+ * sample, so statistics are read in constant time without keeping raw samples.
+ */
+
+/* Number of samples kept in the ring of every measurement, one sample per column of the LCD */
+#define HISTORY_RING_SIZE               (uint8_t)(16u)
+
+/**
+ * SRAM of all series together. A series takes about 80 B on the AVR, so only the measurements
+ * whose trend is on a page of the view (app_view.cpp) have one.
+ */
+#define HISTORY_MAX_FOOTPRINT_BYTES     (uint16_t)(256u)
+
+/* Range of a difference between two neighbouring samples, larger steps restart the ring */
+#define HISTORY_DELTA_MIN               (int32_t)(INT8_MIN)
+#define HISTORY_DELTA_MAX               (int32_t)(INT8_MAX)
+
+/* Length of the rollup windows */
+#define HISTORY_MINUTE_MS               (uint32_t)(60000u)
+#define HISTORY_MINUTES_PER_HOUR        (uint8_t)(60u)
+
+/* Rollup windows */
+#define HISTORY_WINDOW_MINUTE           (uint8_t)(0u)
+#define HISTORY_WINDOW_HOUR             (uint8_t)(1u)
+#define HISTORY_NUM_OF_WINDOWS          (uint8_t)(2u)
+
+/* Highest number of samples (minute window) or minute means (hour window) summed in one bucket */
+#define HISTORY_BUCKET_MAX_COUNT        (uint8_t)(UINT8_MAX)
+
+/* Level of every sample of a series whose samples are all equal */
+#define HISTORY_FLAT_LEVEL              (uint8_t)((TREND_MIN_LEVEL + TREND_MAX_LEVEL) / 2u)
+
+/* Flags indicating if the statistics of a window are available */
+#define HISTORY_STATS_VALID             (bool)(true)
+#define HISTORY_STATS_INVALID           (bool)(false)
+
+/**
+ * @brief Structure with the statistics of one window.
+ *
+ * Values are scaled like the sensor values of the catalog entry (10^num_of_decimals).
+ *
+ * Members:
+ *  - min: Lowest sample of the window.
+ *  - max: Highest sample of the window.
+ *  - sum: Sum of the samples (minute window) or of the minute means (hour window).
+ *  - count: Number of summed entries, 0 if the window is empty.
+ */
+typedef struct
+{
+  int32_t min;
+  int32_t max;
+  int32_t sum;
+  uint8_t count;
+} history_bucket_ts;
+
+/**
+ * @brief Structure with the history of one measurement.
+ *
+ * Members:
+ *  - oldest_value: Value of the oldest sample in the ring, the differences are applied from it.
+ *  - newest_value: Value of the newest sample, the next difference is taken to it.
+ *  - deltas: Difference of every sample to the previous one, the oldest entry is unused.
+ *  - head: Index of the oldest sample in deltas.
+ *  - count: Number of samples in the ring.
+ *  - minute_number: Minute (since boot) of the current minute bucket.
+ *  - current: Buckets which are filled at the moment, by window.
+ *  - completed: Buckets of the last complete minute and hour, by window.
+ */
+typedef struct
+{
+  int32_t oldest_value;
+  int32_t newest_value;
+  int8_t deltas[HISTORY_RING_SIZE];
+  uint8_t head;
+  uint8_t count;
+  uint16_t minute_number;
+  history_bucket_ts current[HISTORY_NUM_OF_WINDOWS];
+  history_bucket_ts completed[HISTORY_NUM_OF_WINDOWS];
+} history_series_ts;
+
+/**
+ * @brief Structure with the statistics of a complete window, as returned to the outputs.
+ *
+ * Members:
+ *  - min: Lowest value of the window.
+ *  - max: Highest value of the window.
+ *  - mean: Mean value of the window, rounded towards zero.
+ */
+typedef struct
+{
+  int32_t min;
+  int32_t max;
+  int32_t mean;
+} history_stats_ts;
+
+/**
+ * @brief Adds a sample to the history of a measurement and updates its rollups.
+ *
+ * @param sensor_id ID of the measurement, nothing is kept for a measurement without a series.
+ * @param value Sample scaled like the catalog entry (10^num_of_decimals).
+ * @param current_millis Time of the sample in milliseconds (millis() based).
+ */
+void history_addSample(uint8_t sensor_id, int32_t value, uint32_t current_millis);
+
+/**
+ * @brief Returns the statistics of the last complete minute or hour in O(1).
+ *
+ * @param sensor_id ID of the measurement, HISTORY_STATS_INVALID or no samples for a measurement without a series.
+ * @param window HISTORY_WINDOW_MINUTE or HISTORY_WINDOW_HOUR.
+ * @param stats Pointer to the caller owned statistics which are filled in place.
+ * @return bool HISTORY_STATS_VALID if the window is complete, HISTORY_STATS_INVALID otherwise.
+ */
+bool history_getStats(uint8_t sensor_id, uint8_t window, history_stats_ts *stats);
+
+/**
+ * @brief Returns the change from the oldest to the newest sample of the ring in O(1).
+ *
+ * @param sensor_id ID of the measurement, HISTORY_STATS_INVALID or no samples for a measurement without a series.
+ * @param change Pointer to the caller owned value which receives the change.
+ * @return bool HISTORY_STATS_VALID if at least two samples are kept, HISTORY_STATS_INVALID otherwise.
+ */
+bool history_getTrend(uint8_t sensor_id, int32_t *change);
+
+/**
+ * @brief Decodes the samples of the ring, oldest first.
+ *
+ * @param sensor_id ID of the measurement, HISTORY_STATS_INVALID or no samples for a measurement without a series.
+ * @param samples Caller owned buffer for the samples.
+ * @param max_samples Size of the buffer, at most HISTORY_RING_SIZE samples are written.
+ * @return uint8_t Number of samples written, the newest ones are kept if the buffer is smaller.
+ */
+uint8_t history_getSamples(uint8_t sensor_id, int32_t *samples, uint8_t max_samples);
+
+/**
+ * @brief Scales the samples of the ring to the bar levels of a trend, oldest first.
+ *
+ * The lowest sample gets TREND_MIN_LEVEL and the highest TREND_MAX_LEVEL, the levels in between
+ * are linear. A flat series is drawn in the middle of the range.
+ *
+ * @param sensor_id ID of the measurement, HISTORY_STATS_INVALID or no samples for a measurement without a series.
+ * @param trend Pointer to the caller owned trend which is filled in place.
+ * @return bool HISTORY_STATS_VALID if at least one sample is kept, HISTORY_STATS_INVALID otherwise.
+ */
+bool history_getLevels(uint8_t sensor_id, trend_reading_ts *trend);
+
+#endif
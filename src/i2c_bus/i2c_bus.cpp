@@ -0,0 +1,314 @@
+#include "i2c_bus.h"
+
+/* STATIC GLOBAL VARIABLES */
+// Jobs waiting for the bus - written by i2c_bus_submit, consumed by the TWI interrupt
+static spsc_ring_ts<i2c_bus_job_ts *, I2C_BUS_QUEUE_SIZE> queue;
+
+// Job which is currently executed by the TWI interrupt
+static i2c_bus_job_ts *volatile active_job = nullptr;
+static volatile uint8_t tx_index = 0u;
+static volatile uint8_t rx_index = 0u;
+static volatile uint32_t active_job_start = 0u;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(((F_CPU / I2C_BUS_CLOCK_HZ) - 16u) / 2u <= 0xFFu, "Bus clock is too slow for the TWI prescaler of 1");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Takes the next job from the queue and makes it the active job.
+ *
+ * Must be called with interrupts disabled (or from the interrupt) and only when there is no active job.
+ *
+ * @return bool true if a job was taken, false if the queue is empty.
+ */
+static bool activateNextJob();
+
+/**
+ * @brief Finishes the active job with the status and starts the next queued job.
+ *
+ * Called from the interrupt, generates the STOP condition (followed by START if another job is queued).
+ *
+ * @param status Final status of the job (I2C_BUS_JOB_*).
+ */
+static void finishActiveJob(uint8_t status);
+
+/**
+ * @brief Starts the next queued job from the main loop when the bus is idle.
+ *
+ * Must be called with interrupts disabled.
+ */
+static void startFromIdle();
+
+/**
+ * @brief Pulls an open-drain line of the bus low, used only by the bus recovery.
+ *
+ * @param pin SDA or SCL.
+ */
+static void driveLineLow(uint8_t pin);
+
+/**
+ * @brief Releases an open-drain line of the bus, the pull-up takes it high.
+ *
+ * @param pin SDA or SCL.
+ */
+static void releaseLine(uint8_t pin);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void i2c_bus_init()
+{
+  pinMode(SDA, INPUT_PULLUP);
+  pinMode(SCL, INPUT_PULLUP);
+
+  TWSR = 0u; // Prescaler 1
+  TWBR = I2C_BUS_TWBR_VALUE;
+  TWCR = _BV(TWEN);
+}
+
+void i2c_bus_prepareJob(i2c_bus_job_ts *job, uint8_t address, const uint8_t *tx_buffer, uint8_t tx_length,
+                        uint8_t *rx_buffer, uint8_t rx_length)
+{
+  job->tx_buffer = tx_buffer;
+  job->rx_buffer = rx_buffer;
+  job->tx_length = tx_length;
+  job->rx_length = rx_length;
+  job->address = address;
+  job->timeout_ms = I2C_BUS_DEFAULT_TIMEOUT_MS;
+  job->status = I2C_BUS_JOB_IDLE;
+}
+
+bool i2c_bus_submit(i2c_bus_job_ts *job)
+{
+  bool result = I2C_BUS_JOB_REJECTED;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(!I2C_BUS_IS_JOB_PENDING(job->status) && I2C_BUS_QUEUE_SIZE > spsc_ring_getCount(&queue))
+    {
+      job->status = I2C_BUS_JOB_QUEUED;
+      (void)spsc_ring_push(&queue, &job);
+
+      if(nullptr == active_job)
+      {
+        startFromIdle();
+      }
+      result = I2C_BUS_JOB_ACCEPTED;
+    }
+  }
+
+  return result;
+}
+
+uint8_t i2c_bus_transfer(i2c_bus_job_ts *job)
+{
+  if(I2C_BUS_JOB_REJECTED == i2c_bus_submit(job))
+  {
+    return I2C_BUS_JOB_BUS_ERROR;
+  }
+
+  // Every job before this one is bounded by its own timeout
+  while(I2C_BUS_IS_JOB_PENDING(job->status))
+  {
+    i2c_bus_service(millis());
+  }
+
+  return job->status;
+}
+
+uint8_t i2c_bus_recover()
+{
+  uint8_t result = I2C_BUS_RECOVERY_NOT_NEEDED;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(nullptr != active_job || !spsc_ring_isEmpty(&queue))
+    {
+      result = I2C_BUS_RECOVERY_BUSY;
+    }
+    else if(LOW == digitalRead(SDA))
+    {
+      TWCR = 0u; // Lines are driven as GPIO while the TWI is off
+
+      // Slave is in the middle of a byte, every SCL pulse shifts one bit out until it releases SDA
+      for (uint8_t clock = 0u; clock < I2C_BUS_RECOVERY_CLOCKS && LOW == digitalRead(SDA); clock++)
+      {
+        driveLineLow(SCL);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+        releaseLine(SCL);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+      }
+
+      // STOP: SDA goes high while SCL is high, every slave returns to idle
+      driveLineLow(SCL);
+      driveLineLow(SDA);
+      delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+      releaseLine(SCL);
+      delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+      releaseLine(SDA);
+      delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+
+      result = (HIGH == digitalRead(SDA)) ? I2C_BUS_RECOVERY_DONE : I2C_BUS_RECOVERY_FAILED;
+      i2c_bus_init();
+    }
+  }
+
+  return result;
+}
+
+bool i2c_bus_isIdle()
+{
+  return nullptr == active_job && spsc_ring_isEmpty(&queue);
+}
+
+void i2c_bus_service(uint32_t current_millis)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    i2c_bus_job_ts *job = active_job;
+    // Signed difference, the job may have been started by the interrupt after current_millis was taken
+    if(nullptr != job && (int32_t)(current_millis - active_job_start) > (int32_t)job->timeout_ms)
+    {
+      // Resetting the peripheral releases SDA and SCL, the device may still hold the bus until it gives up
+      TWCR = 0u;
+      TWCR = _BV(TWEN);
+      job->status = I2C_BUS_JOB_TIMEOUT;
+      active_job = nullptr;
+    }
+
+    if(nullptr == active_job)
+    {
+      startFromIdle();
+    }
+  }
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(TWI_vect)
+{
+  i2c_bus_job_ts *job = active_job;
+  if(nullptr == job)
+  {
+    TWCR = I2C_BUS_TWCR_STOP; // Job was aborted by the timeout in the meantime
+    return;
+  }
+
+  switch(TWSR & I2C_BUS_TWI_STATUS_MASK)
+  {
+    case I2C_BUS_TWI_START:
+    case I2C_BUS_TWI_REPEATED_START:
+      // Write phase until all bytes are sent, a job without any bytes only probes the address
+      if(tx_index < job->tx_length || 0u == job->rx_length)
+      {
+        TWDR = (uint8_t)((job->address << 1) | I2C_BUS_DIRECTION_WRITE);
+      }
+      else
+      {
+        TWDR = (uint8_t)((job->address << 1) | I2C_BUS_DIRECTION_READ);
+      }
+      TWCR = I2C_BUS_TWCR_CONTINUE;
+      break;
+
+    case I2C_BUS_TWI_MT_SLA_ACK:
+    case I2C_BUS_TWI_MT_DATA_ACK:
+      if(tx_index < job->tx_length)
+      {
+        TWDR = job->tx_buffer[tx_index];
+        tx_index++;
+        TWCR = I2C_BUS_TWCR_CONTINUE;
+      }
+      else if(0u != job->rx_length)
+      {
+        TWCR = I2C_BUS_TWCR_START; // Repeated START for the read phase
+      }
+      else
+      {
+        finishActiveJob(I2C_BUS_JOB_DONE);
+      }
+      break;
+
+    case I2C_BUS_TWI_MR_SLA_ACK:
+      // Last byte is not acknowledged, so the device releases the bus
+      TWCR = (1u < job->rx_length) ? I2C_BUS_TWCR_ACK : I2C_BUS_TWCR_NACK;
+      break;
+
+    case I2C_BUS_TWI_MR_DATA_ACK:
+      job->rx_buffer[rx_index] = TWDR;
+      rx_index++;
+      TWCR = ((uint8_t)(rx_index + 1u) < job->rx_length) ? I2C_BUS_TWCR_ACK : I2C_BUS_TWCR_NACK;
+      break;
+
+    case I2C_BUS_TWI_MR_DATA_NACK:
+      job->rx_buffer[rx_index] = TWDR;
+      rx_index++;
+      finishActiveJob(I2C_BUS_JOB_DONE);
+      break;
+
+    case I2C_BUS_TWI_MT_SLA_NACK:
+    case I2C_BUS_TWI_MR_SLA_NACK:
+      finishActiveJob(I2C_BUS_JOB_NACK_ADDRESS);
+      break;
+
+    case I2C_BUS_TWI_MT_DATA_NACK:
+      finishActiveJob(I2C_BUS_JOB_NACK_DATA);
+      break;
+
+    default:
+      // Lost arbitration or bus error (illegal START/STOP)
+      finishActiveJob(I2C_BUS_JOB_BUS_ERROR);
+      break;
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool activateNextJob()
+{
+  i2c_bus_job_ts *job;
+  if(SPSC_RING_EMPTY == spsc_ring_pop(&queue, &job))
+  {
+    return false;
+  }
+
+  job->status = I2C_BUS_JOB_ACTIVE;
+  tx_index = 0u;
+  rx_index = 0u;
+  active_job_start = millis();
+  active_job = job;
+  return true;
+}
+
+static void finishActiveJob(uint8_t status)
+{
+  active_job->status = status;
+  active_job = nullptr;
+
+  // STOP and START of the next job in one step, the bus is never left idle between queued jobs
+  TWCR = activateNextJob() ? I2C_BUS_TWCR_STOP_START : I2C_BUS_TWCR_STOP;
+}
+
+static void startFromIdle()
+{
+  if(activateNextJob())
+  {
+    // STOP of the previous job must be on the bus before a new START is requested
+    for (uint8_t wait = 0u; wait < I2C_BUS_STOP_WAIT_LOOPS && (TWCR & _BV(TWSTO)); wait++)
+    {
+    }
+    TWCR = I2C_BUS_TWCR_START;
+  }
+}
+
+static void driveLineLow(uint8_t pin)
+{
+  digitalWrite(pin, LOW); // Pull-up off before the pin becomes an output, the line is never driven high
+  pinMode(pin, OUTPUT);
+}
+
+static void releaseLine(uint8_t pin)
+{
+  pinMode(pin, INPUT_PULLUP);
+}
+/* *************************************** */
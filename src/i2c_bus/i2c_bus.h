@@ -0,0 +1,185 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "../spsc_ring/spsc_ring.h"
+
+/**
+ * @file i2c_bus.h
+ * @brief Non-blocking, interrupt driven I2C (TWI) transaction engine.
+ *
+ * Every I2C access of the project is described by a job owned by the caller (write, read or
+ * write followed by a repeated start and read). Jobs are queued with i2c_bus_submit() and
+ * executed back to back by the TWI interrupt, so the main loop only checks the status of
+ * the job later and bus latency overlaps with other work. A job which does not finish in
+ * its timeout is aborted by i2c_bus_service(), so a slow or stuck device can not stall the loop.
+ *
+ * The engine owns the TWI interrupt, so the Wire library must not be linked together with it.
+ */
+
+/* SCL frequency of the bus */
+#define I2C_BUS_CLOCK_HZ                (uint32_t)(100000u)
+/* Bit rate register value for the TWI prescaler of 1 */
+#define I2C_BUS_TWBR_VALUE              (uint8_t)(((F_CPU / I2C_BUS_CLOCK_HZ) - 16u) / 2u)
+
+/* Number of jobs which can wait for the bus (power of two) */
+#define I2C_BUS_QUEUE_SIZE              (uint8_t)(8u)
+
+/* Timeout of a single job, a full 32 byte transfer takes about 3 ms at 100 kHz */
+#define I2C_BUS_DEFAULT_TIMEOUT_MS      (uint16_t)(25u)
+
+/* Maximum time the engine waits for the STOP condition before starting a new job from the main loop */
+#define I2C_BUS_STOP_WAIT_LOOPS         (uint8_t)(200u)
+
+/* Job status, written by the engine */
+#define I2C_BUS_JOB_IDLE                (uint8_t)(0u) /* Never submitted */
+#define I2C_BUS_JOB_QUEUED              (uint8_t)(1u) /* Waiting for the bus */
+#define I2C_BUS_JOB_ACTIVE              (uint8_t)(2u) /* Executed by the interrupt */
+#define I2C_BUS_JOB_DONE                (uint8_t)(3u) /* Finished successfully */
+#define I2C_BUS_JOB_NACK_ADDRESS        (uint8_t)(4u) /* No device acknowledged the address */
+#define I2C_BUS_JOB_NACK_DATA           (uint8_t)(5u) /* Device did not acknowledge a data byte */
+#define I2C_BUS_JOB_BUS_ERROR           (uint8_t)(6u) /* Lost arbitration or illegal START/STOP */
+#define I2C_BUS_JOB_TIMEOUT             (uint8_t)(7u) /* Aborted after the timeout of the job */
+
+/* Macro that checks if a job still waits for the engine */
+#define I2C_BUS_IS_JOB_PENDING(status)  ((I2C_BUS_JOB_QUEUED == (status)) || (I2C_BUS_JOB_ACTIVE == (status)))
+
+/* Results of i2c_bus_submit() */
+#define I2C_BUS_JOB_ACCEPTED            (bool)(true)
+#define I2C_BUS_JOB_REJECTED            (bool)(false)
+
+/* Results of i2c_bus_recover() */
+#define I2C_BUS_RECOVERY_NOT_NEEDED     (uint8_t)(0u) /* SDA was released, nothing was done */
+#define I2C_BUS_RECOVERY_DONE           (uint8_t)(1u) /* Slave released SDA after the SCL pulses */
+#define I2C_BUS_RECOVERY_FAILED         (uint8_t)(2u) /* SDA is still held low */
+#define I2C_BUS_RECOVERY_BUSY           (uint8_t)(3u) /* Jobs are queued or running, the bus was not touched */
+
+/* SCL pulses of the bus recovery, a slave holding SDA low releases it after at most 9 clocks (8 data bits and ACK) */
+#define I2C_BUS_RECOVERY_CLOCKS         (uint8_t)(9u)
+/* Half period of the recovery clock, 100 kHz like the bus */
+#define I2C_BUS_RECOVERY_HALF_PERIOD_US (uint8_t)(5u)
+
+/* Direction bit appended to the 7-bit address */
+#define I2C_BUS_DIRECTION_WRITE         (uint8_t)(0u)
+#define I2C_BUS_DIRECTION_READ          (uint8_t)(1u)
+
+/* TWI status codes (TWSR with the prescaler bits masked out) */
+#define I2C_BUS_TWI_STATUS_MASK         (uint8_t)(0xF8u)
+#define I2C_BUS_TWI_START               (uint8_t)(0x08u)
+#define I2C_BUS_TWI_REPEATED_START      (uint8_t)(0x10u)
+#define I2C_BUS_TWI_MT_SLA_ACK          (uint8_t)(0x18u)
+#define I2C_BUS_TWI_MT_SLA_NACK         (uint8_t)(0x20u)
+#define I2C_BUS_TWI_MT_DATA_ACK         (uint8_t)(0x28u)
+#define I2C_BUS_TWI_MT_DATA_NACK        (uint8_t)(0x30u)
+#define I2C_BUS_TWI_ARBITRATION_LOST    (uint8_t)(0x38u)
+#define I2C_BUS_TWI_MR_SLA_ACK          (uint8_t)(0x40u)
+#define I2C_BUS_TWI_MR_SLA_NACK         (uint8_t)(0x48u)
+#define I2C_BUS_TWI_MR_DATA_ACK         (uint8_t)(0x50u)
+#define I2C_BUS_TWI_MR_DATA_NACK        (uint8_t)(0x58u)
+
+/* TWI control register values for the steps of a transaction */
+#define I2C_BUS_TWCR_START              (uint8_t)(_BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE))
+#define I2C_BUS_TWCR_CONTINUE           (uint8_t)(_BV(TWINT) | _BV(TWEN) | _BV(TWIE))
+#define I2C_BUS_TWCR_ACK                (uint8_t)(_BV(TWINT) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE))
+#define I2C_BUS_TWCR_NACK               (uint8_t)(_BV(TWINT) | _BV(TWEN) | _BV(TWIE))
+#define I2C_BUS_TWCR_STOP               (uint8_t)(_BV(TWINT) | _BV(TWSTO) | _BV(TWEN))
+/* STOP immediately followed by the START of the next job */
+#define I2C_BUS_TWCR_STOP_START         (uint8_t)(_BV(TWINT) | _BV(TWSTO) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE))
+
+/**
+ * @brief Structure describing one I2C transaction.
+ *
+ * The job and its buffers are owned by the caller and must stay valid until the job is
+ * no longer pending. If both lengths are non-zero the bytes are written first and then
+ * read after a repeated START. A job with both lengths zero only probes the address.
+ *
+ * Members:
+ *  - tx_buffer: Bytes written to the device (for example register address and values).
+ *  - rx_buffer: Buffer which receives the bytes read from the device.
+ *  - tx_length: Number of bytes to write.
+ *  - rx_length: Number of bytes to read.
+ *  - address: 7-bit address of the device.
+ *  - timeout_ms: Maximum time the job may occupy the bus.
+ *  - status: Status of the job (I2C_BUS_JOB_*), written by the engine.
+ */
+typedef struct
+{
+  const uint8_t *tx_buffer;
+  uint8_t *rx_buffer;
+  uint8_t tx_length;
+  uint8_t rx_length;
+  uint8_t address;
+  uint16_t timeout_ms;
+  volatile uint8_t status;
+} i2c_bus_job_ts;
+
+/**
+ * @brief Initializes the TWI peripheral and enables the internal pull-ups of SDA and SCL.
+ */
+void i2c_bus_init();
+
+/**
+ * @brief Fills a job with the transaction parameters and the default timeout.
+ *
+ * @param job Pointer to the caller owned job, must not be pending.
+ * @param address 7-bit address of the device.
+ * @param tx_buffer Bytes to write, may be nullptr if tx_length is 0.
+ * @param tx_length Number of bytes to write.
+ * @param rx_buffer Buffer for the read bytes, may be nullptr if rx_length is 0.
+ * @param rx_length Number of bytes to read.
+ */
+void i2c_bus_prepareJob(i2c_bus_job_ts *job, uint8_t address, const uint8_t *tx_buffer, uint8_t tx_length,
+                        uint8_t *rx_buffer, uint8_t rx_length);
+
+/**
+ * @brief Queues a job, the transaction starts immediately if the bus is free.
+ *
+ * @param job Pointer to the prepared job.
+ * @return bool I2C_BUS_JOB_ACCEPTED if the job was queued, I2C_BUS_JOB_REJECTED if the job
+ *         is already pending or the queue is full.
+ */
+bool i2c_bus_submit(i2c_bus_job_ts *job);
+
+/**
+ * @brief Executes a job and waits until it is finished.
+ *
+ * Only for initialization code, where the result is needed before continuing.
+ * The wait is bounded by the timeout of the job.
+ *
+ * @param job Pointer to the prepared job.
+ * @return uint8_t Final status of the job (I2C_BUS_JOB_DONE on success).
+ */
+uint8_t i2c_bus_transfer(i2c_bus_job_ts *job);
+
+/**
+ * @brief Frees the bus from a slave which holds SDA low, for example after a reset in the middle of a transfer.
+ *
+ * Only if no job is queued or running: the TWI is disabled, SCL is clocked as a GPIO until the slave
+ * releases SDA (at most I2C_BUS_RECOVERY_CLOCKS pulses), a STOP condition is generated and the TWI
+ * is initialized again. Takes about 100 us with interrupts disabled, nothing is done when SDA is high.
+ *
+ * @return uint8_t Result of the recovery (I2C_BUS_RECOVERY_*).
+ */
+uint8_t i2c_bus_recover();
+
+/**
+ * @brief Checks if no job is queued or running.
+ *
+ * @return true if the bus is idle, false otherwise.
+ */
+bool i2c_bus_isIdle();
+
+/**
+ * @brief Aborts the active job if its timeout has expired and restarts the queue.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Transactions themselves run in the TWI interrupt,
+ * this function only supervises them.
+ *
+ * @param current_millis Current time in milliseconds (millis() based).
+ */
+void i2c_bus_service(uint32_t current_millis);
+
+#endif
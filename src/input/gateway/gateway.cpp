@@ -0,0 +1,346 @@
+#include "gateway.h"
+
+#ifdef GATEWAY_COMPONENT
+
+/* STATIC GLOBAL VARIABLES */
+static bool gateway_ready = GATEWAY_NOT_READY;
+// Reading cache of every station, slots are taken in the order the stations are heard
+static gateway_station_ts stations[GATEWAY_MAX_STATIONS];
+// Packet read from the transceiver
+static uint8_t received_packet[RADIO_MAX_PACKET_SIZE];
+// Batch which waits to be queued, with the slot the next batch starts at so every station gets its turn
+static uint8_t batch_frame[GATEWAY_BATCH_MAX_PAYLOAD + GATEWAY_FRAME_CRC_SIZE];
+static size_t batch_len = 0u;
+static bool batch_pending = GATEWAY_NO_BATCH_PENDING;
+static uint8_t next_batch_slot = 0u;
+static uint32_t next_batch_millis = 0u;
+// Packets lost since the last batch, reported in the batch header
+static uint16_t missed_packets = GATEWAY_NO_LOST_PACKETS;
+static uint16_t dropped_packets = GATEWAY_NO_LOST_PACKETS;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(GATEWAY_BATCH_HEADER_SIZE + GATEWAY_RECORD_MAX_SIZE <= GATEWAY_BATCH_MAX_PAYLOAD, "A batch must hold the record of a station with every value");
+static_assert(GATEWAY_NO_STATION > GATEWAY_MAX_STATIONS, "Slot indexes must be 8-bit");
+#ifdef __AVR_ATmega328P__
+static_assert(sizeof(stations) <= 512u, "Reading caches do not fit the SRAM of the ATmega328P, build the gateway for a Mega 2560 or lower GATEWAY_MAX_STATIONS");
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Finds the slot of a station, a station heard for the first time takes a free or timed out slot.
+ *
+ * @param station_id ID of the station.
+ * @param current_millis The current time in milliseconds.
+ * @return gateway_station_ts* Slot of the station, nullptr if every slot is taken.
+ */
+static gateway_station_ts *findStation(uint8_t station_id, uint32_t current_millis);
+
+/**
+ * @brief Decodes the bitmap and the values of a packet without applying them.
+ *
+ * @param packet Bytes of the packet, at least RADIO_HEADER_SIZE.
+ * @param packet_len Number of bytes.
+ * @param included Receives the bit per catalog index of the values in the packet.
+ * @param decoded Receives the values (key frame) or differences (delta frame) by catalog index.
+ * @return true if the packet is well formed, false if a bit is outside of the catalog or the values do not end with the packet.
+ */
+static bool decodeValues(const uint8_t *packet, uint8_t packet_len, radio_values_bitset_t *included, int32_t *decoded);
+
+/**
+ * @brief Reads one zigzag encoded varint.
+ *
+ * @param packet Bytes of the packet.
+ * @param packet_len Number of bytes.
+ * @param position Position of the varint, moved behind it.
+ * @param value Receives the decoded value.
+ * @return true if the varint ended inside of the packet and within RADIO_VARINT_MAX_SIZE bytes.
+ */
+static bool readVarint(const uint8_t *packet, uint8_t packet_len, uint8_t *position, int32_t *value);
+
+/**
+ * @brief Builds a batch of the updated stations, starting at next_batch_slot.
+ *
+ * @param current_millis The current time in milliseconds, the age of the readings is taken to it.
+ */
+static void buildBatch(uint32_t current_millis);
+
+/**
+ * @brief Adds to a lost packets counter, saturates at UINT16_MAX.
+ *
+ * @param counter Counter.
+ * @param count Number of lost packets.
+ */
+static void countLost(uint16_t *counter, uint16_t count);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+control_error_code_te gateway_init()
+{
+  for (uint8_t slot = 0u; slot < GATEWAY_MAX_STATIONS; slot++)
+  {
+    stations[slot].station_id = GATEWAY_NO_STATION;
+  }
+  batch_pending = GATEWAY_NO_BATCH_PENDING;
+
+  if(!sx1276_init())
+  {
+    gateway_ready = GATEWAY_NOT_READY;
+    return ERROR_CODE_INIT_FAILED;
+  }
+  sx1276_startReceive();
+  next_batch_millis = millis() + GATEWAY_BATCH_PERIOD_MS;
+  gateway_ready = GATEWAY_READY;
+  return ERROR_CODE_NO_ERROR;
+}
+
+void gateway_service(uint32_t current_millis)
+{
+  if(GATEWAY_READY != gateway_ready)
+  {
+    return;
+  }
+
+  uint8_t packet_len = SX1276_PACKET_DROPPED_LEN;
+  if(SX1276_PACKET_RECEIVED == sx1276_readPacket(received_packet, sizeof(received_packet), &packet_len))
+  {
+    if(SX1276_PACKET_DROPPED_LEN == packet_len)
+    {
+      countLost(&dropped_packets, 1u);
+    }
+    else
+    {
+      gateway_receivePacket(received_packet, packet_len, current_millis);
+    }
+  }
+
+  if(GATEWAY_NO_BATCH_PENDING == batch_pending && 0 <= (int32_t)(current_millis - next_batch_millis)) // Overflow safe compare
+  {
+    buildBatch(current_millis);
+  }
+}
+
+void gateway_receivePacket(const uint8_t *packet, uint8_t packet_len, uint32_t current_millis)
+{
+  radio_values_bitset_t included = {};
+  int32_t decoded[SENSORS_SNAPSHOT_CAPACITY];
+
+  uint8_t frame_type = (RADIO_HEADER_SIZE <= packet_len) ? packet[RADIO_HEADER_FRAME_TYPE] : RADIO_FRAME_KEY;
+  if(RADIO_HEADER_SIZE > packet_len || (RADIO_FRAME_KEY != frame_type && RADIO_FRAME_DELTA != frame_type) ||
+     !decodeValues(packet, packet_len, &included, decoded))
+  {
+    countLost(&dropped_packets, 1u);
+    return;
+  }
+
+  gateway_station_ts *station = findStation(packet[RADIO_HEADER_STATION_ID], current_millis);
+  if(nullptr == station)
+  {
+    countLost(&dropped_packets, 1u); // Every slot is taken by a station which was heard recently
+    return;
+  }
+
+  uint8_t sequence = packet[RADIO_HEADER_SEQUENCE];
+  bool in_sequence = (GATEWAY_STATION_SYNCED == station->synced) && ((uint8_t)(station->sequence + 1u) == sequence);
+  if(GATEWAY_STATION_SYNCED == station->synced)
+  {
+    if(sequence == station->sequence)
+    {
+      return; // Retry of a packet which was already applied, its differences must not be applied twice
+    }
+    if(!in_sequence)
+    {
+      countLost(&missed_packets, (uint8_t)(sequence - station->sequence - 1u));
+    }
+  }
+  station->sequence = sequence;
+  station->last_heard = current_millis;
+
+  if(RADIO_FRAME_KEY == frame_type)
+  {
+    for (uint8_t sensor_index = bitset_findNext(&included, SENSORS_INTERFACE_FIRST_SENSOR_INDEX); BITSET_NO_BIT != sensor_index;
+         sensor_index = bitset_findNext(&included, (uint8_t)(sensor_index + 1u)))
+    {
+      station->values[sensor_index] = decoded[sensor_index];
+    }
+    station->valid = included;
+    station->synced = GATEWAY_STATION_SYNCED;
+    station->updated = GATEWAY_STATION_UPDATED;
+  }
+  else if(in_sequence)
+  {
+    for (uint8_t sensor_index = bitset_findNext(&included, SENSORS_INTERFACE_FIRST_SENSOR_INDEX); BITSET_NO_BIT != sensor_index;
+         sensor_index = bitset_findNext(&included, (uint8_t)(sensor_index + 1u)))
+    {
+      station->values[sensor_index] = (int32_t)((uint32_t)station->values[sensor_index] + (uint32_t)decoded[sensor_index]);
+      station->updated = GATEWAY_STATION_UPDATED;
+    }
+  }
+  else
+  {
+    station->synced = GATEWAY_STATION_NOT_SYNCED; // Base of the differences is lost, wait for the next key frame
+  }
+}
+
+uint8_t *gateway_peekBatchFrame(size_t *payload_len)
+{
+  if(GATEWAY_BATCH_PENDING != batch_pending)
+  {
+    return nullptr;
+  }
+  *payload_len = batch_len;
+  return batch_frame;
+}
+
+void gateway_releaseBatchFrame()
+{
+  batch_pending = GATEWAY_NO_BATCH_PENDING;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static gateway_station_ts *findStation(uint8_t station_id, uint32_t current_millis)
+{
+  gateway_station_ts *free_slot = nullptr;
+
+  for (uint8_t slot = 0u; slot < GATEWAY_MAX_STATIONS; slot++)
+  {
+    gateway_station_ts *station = &stations[slot];
+    if(station_id == station->station_id)
+    {
+      return station;
+    }
+    if(nullptr == free_slot && (GATEWAY_NO_STATION == station->station_id ||
+                                (uint32_t)(current_millis - station->last_heard) > GATEWAY_STATION_TIMEOUT_MS))
+    {
+      free_slot = station;
+    }
+  }
+
+  if(nullptr != free_slot)
+  {
+    *free_slot = {};
+    free_slot->station_id = station_id;
+    free_slot->synced = GATEWAY_STATION_NOT_SYNCED;
+    free_slot->updated = GATEWAY_STATION_NOT_UPDATED;
+  }
+  return free_slot;
+}
+
+static bool decodeValues(const uint8_t *packet, uint8_t packet_len, radio_values_bitset_t *included, int32_t *decoded)
+{
+  for (uint8_t bit = 0u; bit < RADIO_BITMAP_SIZE * BITSET_BITS_PER_WORD; bit++)
+  {
+    if(0u != (packet[RADIO_HEADER_BITMAP + bit / BITSET_BITS_PER_WORD] & (uint8_t)(1u << (bit % BITSET_BITS_PER_WORD))))
+    {
+      if(SENSORS_SNAPSHOT_CAPACITY <= bit)
+      {
+        return false; // Station was built from another catalog
+      }
+      bitset_set(included, bit);
+    }
+  }
+
+  uint8_t position = RADIO_HEADER_SIZE;
+  for (uint8_t sensor_index = bitset_findNext(included, SENSORS_INTERFACE_FIRST_SENSOR_INDEX); BITSET_NO_BIT != sensor_index;
+       sensor_index = bitset_findNext(included, (uint8_t)(sensor_index + 1u)))
+  {
+    if(!readVarint(packet, packet_len, &position, &decoded[sensor_index]))
+    {
+      return false;
+    }
+  }
+  return packet_len == position;
+}
+
+static bool readVarint(const uint8_t *packet, uint8_t packet_len, uint8_t *position, int32_t *value)
+{
+  uint32_t zigzag = 0u;
+
+  for (uint8_t byte_index = 0u; byte_index < RADIO_VARINT_MAX_SIZE && *position < packet_len; byte_index++)
+  {
+    uint8_t byte = packet[*position];
+    (*position)++;
+    zigzag |= (uint32_t)(byte & RADIO_VARINT_VALUE_MASK) << (byte_index * RADIO_VARINT_VALUE_BITS);
+    if(0u == (byte & RADIO_VARINT_CONTINUE))
+    {
+      *value = (int32_t)((zigzag >> 1) ^ (uint32_t)(-(int32_t)(zigzag & 1u)));
+      return true;
+    }
+  }
+  return false;
+}
+
+static void buildBatch(uint32_t current_millis)
+{
+  uint8_t num_of_records = 0u;
+  size_t len = GATEWAY_BATCH_HEADER_SIZE;
+  bool batch_full = false;
+
+  for (uint8_t checked = 0u; checked < GATEWAY_MAX_STATIONS && !batch_full; checked++)
+  {
+    gateway_station_ts *station = &stations[next_batch_slot];
+    if(GATEWAY_NO_STATION != station->station_id && GATEWAY_STATION_UPDATED == station->updated)
+    {
+      uint8_t num_of_values = 0u;
+      for (uint8_t sensor_index = bitset_findNext(&station->valid, SENSORS_INTERFACE_FIRST_SENSOR_INDEX); BITSET_NO_BIT != sensor_index;
+           sensor_index = bitset_findNext(&station->valid, (uint8_t)(sensor_index + 1u)))
+      {
+        num_of_values++;
+      }
+
+      size_t record_len = GATEWAY_RECORD_HEADER_SIZE + (size_t)num_of_values * GATEWAY_RECORD_VALUE_SIZE;
+      if(GATEWAY_BATCH_MAX_PAYLOAD < len + record_len)
+      {
+        batch_full = true; // Station starts the next batch, which is built right after this one is queued
+        continue;
+      }
+
+      uint32_t age_s = (uint32_t)(current_millis - station->last_heard) / GATEWAY_MS_PER_SECOND;
+      uint8_t *record = &batch_frame[len];
+      record[0] = station->station_id;
+      record[1] = station->sequence;
+      serial_frame_putU16(&record[2], (GATEWAY_MAX_AGE_S < age_s) ? GATEWAY_MAX_AGE_S : (uint16_t)age_s);
+      memcpy(&record[4], station->valid.words, RADIO_BITMAP_SIZE);
+      uint8_t *value = &record[GATEWAY_RECORD_HEADER_SIZE];
+      for (uint8_t sensor_index = bitset_findNext(&station->valid, SENSORS_INTERFACE_FIRST_SENSOR_INDEX); BITSET_NO_BIT != sensor_index;
+           sensor_index = bitset_findNext(&station->valid, (uint8_t)(sensor_index + 1u)))
+      {
+        serial_frame_putU32(value, (uint32_t)station->values[sensor_index]);
+        value += GATEWAY_RECORD_VALUE_SIZE;
+      }
+
+      len += record_len;
+      num_of_records++;
+      station->updated = GATEWAY_STATION_NOT_UPDATED;
+    }
+    next_batch_slot = (uint8_t)((next_batch_slot + 1u) % GATEWAY_MAX_STATIONS);
+  }
+
+  if(!batch_full)
+  {
+    next_batch_millis = current_millis + GATEWAY_BATCH_PERIOD_MS; // Every updated station is in this batch
+  }
+  if(0u == num_of_records && GATEWAY_NO_LOST_PACKETS == missed_packets && GATEWAY_NO_LOST_PACKETS == dropped_packets)
+  {
+    return; // Nothing to forward
+  }
+
+  batch_frame[0] = GATEWAY_FRAME_BATCH;
+  batch_frame[1] = num_of_records;
+  serial_frame_putU16(&batch_frame[2], missed_packets);
+  serial_frame_putU16(&batch_frame[4], dropped_packets);
+  missed_packets = GATEWAY_NO_LOST_PACKETS;
+  dropped_packets = GATEWAY_NO_LOST_PACKETS;
+  batch_len = len;
+  batch_pending = GATEWAY_BATCH_PENDING;
+}
+
+static void countLost(uint16_t *counter, uint16_t count)
+{
+  *counter = (UINT16_MAX - *counter < count) ? UINT16_MAX : (uint16_t)(*counter + count);
+}
+/* *************************************** */
+
+#endif
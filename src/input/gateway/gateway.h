@@ -0,0 +1,132 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <Arduino.h>
+#include "gateway_config.h"
+#include "../../control/control_types.h"
+#include "../../output/radio/radio.h"
+#include "../../output/serial_console/serial_frame.h"
+#include "../../project_settings.h"
+
+/**
+ * @file gateway.h
+ * @brief Gateway of many stations, receives their LoRa packets and forwards their readings to the host in batches.
+ *
+ * Packets of the stations (see radio.h) are demultiplexed by the station ID into a reading cache per
+ * station, the key frames replace the values of the station and the delta frames are applied to them.
+ * The transceiver keeps only the latest packet, so gateway_service() reads it in every loop and decoding
+ * takes a few microseconds, the packets arrive not faster than one per airtime (tens of milliseconds).
+ * The stations must be built from the same catalog as the gateway, the catalog indexes and decimals of
+ * the values are taken from it.
+ *
+ * Batch protocol (binary frames of serial_frame.h, all fields little endian):
+ *  - gateway -> host BATCH: type, number of records, missed packets and dropped packets since the last batch (u16),
+ *    then for every updated station: station ID, sequence number of its last packet, age of its readings
+ *    (u16, seconds), bitmap of the valid values (RADIO_BITMAP_SIZE bytes) and the valid values (i32) with
+ *    the decimals of the catalog entry in catalog order. A batch carries as many stations as fit, the
+ *    others follow in the next batch right away.
+ */
+
+/* Frame type of the batch protocol, the memory monitor uses 0x28..0x29 */
+#define GATEWAY_FRAME_BATCH               (uint8_t)(0x30u)
+
+/* Payload sizes of the batch frames */
+#define GATEWAY_BATCH_HEADER_SIZE         (uint8_t)(6u)
+#define GATEWAY_RECORD_HEADER_SIZE        (uint8_t)(4u + RADIO_BITMAP_SIZE)
+#define GATEWAY_RECORD_VALUE_SIZE         (uint8_t)(4u)
+#define GATEWAY_RECORD_MAX_SIZE           (uint8_t)(GATEWAY_RECORD_HEADER_SIZE + SENSORS_SNAPSHOT_CAPACITY * GATEWAY_RECORD_VALUE_SIZE)
+/* Longest batch payload, same as the longest frame queued by the serial console */
+#define GATEWAY_BATCH_MAX_PAYLOAD         (uint8_t)(80u)
+/* Room for the CRC of the frame, which is appended by the framing */
+#define GATEWAY_FRAME_CRC_SIZE            (uint8_t)(SERIAL_FRAME_CRC_SIZE)
+
+/* Station ID of a free slot */
+#define GATEWAY_NO_STATION                (uint8_t)(CONTROL_ID_UNUSED)
+/* Seconds the age of the readings saturates at */
+#define GATEWAY_MAX_AGE_S                 (uint16_t)(UINT16_MAX)
+#define GATEWAY_MS_PER_SECOND             (uint16_t)(1000u)
+
+/* Flags of the state of a station and of the gateway */
+#define GATEWAY_READY                     (bool)(true)
+#define GATEWAY_NOT_READY                 (bool)(false)
+#define GATEWAY_STATION_SYNCED            (bool)(true)
+#define GATEWAY_STATION_NOT_SYNCED        (bool)(false)
+#define GATEWAY_STATION_UPDATED           (bool)(true)
+#define GATEWAY_STATION_NOT_UPDATED       (bool)(false)
+#define GATEWAY_BATCH_PENDING             (bool)(true)
+#define GATEWAY_NO_BATCH_PENDING          (bool)(false)
+
+/* Value of the packet counters when nothing was missed or dropped */
+#define GATEWAY_NO_LOST_PACKETS           (uint16_t)(0u)
+
+/**
+ * @brief Structure with the reading cache of one station.
+ *
+ * Members:
+ *  - values: Values by catalog index, scaled like the catalog entries.
+ *  - valid: Bit per catalog index of the valid values.
+ *  - last_heard: Time in milliseconds of the last packet of the station.
+ *  - station_id: ID of the station, GATEWAY_NO_STATION for a free slot.
+ *  - sequence: Sequence number of the last applied packet.
+ *  - synced: GATEWAY_STATION_SYNCED if the values are the ones of the last packet, delta frames are applied only then.
+ *  - updated: GATEWAY_STATION_UPDATED if the values changed since they were forwarded.
+ */
+typedef struct
+{
+  int32_t values[SENSORS_SNAPSHOT_CAPACITY];
+  radio_values_bitset_t valid;
+  uint32_t last_heard;
+  uint8_t station_id;
+  uint8_t sequence;
+  bool synced;
+  bool updated;
+} gateway_station_ts;
+
+/**
+ * @brief Initializes the transceiver for the reception and empties the reading caches.
+ *
+ * Blocks for the reset of the transceiver (about 5 ms), only for initialization code.
+ *
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Transceiver receives.
+ * - ERROR_CODE_INIT_FAILED: Transceiver did not answer.
+ */
+control_error_code_te gateway_init();
+
+/**
+ * @brief Reads the packet received by the transceiver and builds the next batch when it is due.
+ *
+ * NEEDS TO BE CALLED IN A LOOP, more often than the shortest packet airtime, otherwise packets are lost.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void gateway_service(uint32_t current_millis);
+
+/**
+ * @brief Applies one packet of a station to its reading cache.
+ *
+ * Called for every packet of the transceiver, other transports (e.g., a serial bus) can pass their
+ * packets here as well. Malformed packets and stations without a free slot are counted as dropped,
+ * gaps in the sequence numbers of a station are counted as missed.
+ *
+ * @param packet Bytes of the packet, in the layout of radio.h.
+ * @param packet_len Number of bytes.
+ * @param current_millis The current time in milliseconds.
+ */
+void gateway_receivePacket(const uint8_t *packet, uint8_t packet_len, uint32_t current_millis);
+
+/**
+ * @brief Returns the batch frame which is due.
+ *
+ * @param payload_len Receives the number of payload bytes.
+ * @return uint8_t* Payload with GATEWAY_FRAME_CRC_SIZE free bytes after it, nullptr if no batch is due.
+ *         The batch stays until gateway_releaseBatchFrame() is called.
+ */
+uint8_t *gateway_peekBatchFrame(size_t *payload_len);
+
+/**
+ * @brief Releases the batch frame after it was queued for transmission.
+ */
+void gateway_releaseBatchFrame();
+
+#endif
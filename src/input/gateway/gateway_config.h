@@ -0,0 +1,15 @@
+#ifndef GATEWAY_CONFIG_H
+#define GATEWAY_CONFIG_H
+
+#include <Arduino.h>
+
+/* Number of stations whose readings are kept, a station heard for the first time takes a free slot */
+#define GATEWAY_MAX_STATIONS          (uint8_t)(32u)
+
+/* Shortest time between two batches, the stations updated in between are forwarded together */
+#define GATEWAY_BATCH_PERIOD_MS       (uint32_t)(5000u)
+
+/* Time after which a station which was not heard gives its slot to a new station */
+#define GATEWAY_STATION_TIMEOUT_MS    (uint32_t)(3600000u)
+
+#endif
@@ -1,23 +1,57 @@
 #include "i2c_scan.h"
 
+/* STATIC GLOBAL VARIABLES */
+/* Addresses of the devices declared in the project settings, probed by the known devices scan */
+static const uint8_t known_addresses[] PLATFORM_PROGMEM =
+{
+#ifdef BMP280_COMPONENT
+  SENSORS_BMP280_I2C_ADDR,
+#endif
+#ifdef BH1750_COMPONENT
+  SENSORS_BH1750_I2C_ADDDR_GND,
+  SENSORS_BH1750_I2C_ADDDR_VCC,
+#endif
+#ifdef LCD_DISPLAY_COMPONENT
+  DISPLAY_LCD_I2C_ADDDR,
+#endif
+#ifdef RTC_COMPONENT
+  RTC_I2C_ADDR,
+#endif
+#ifdef DATA_LOG_COMPONENT
+  DATA_LOG_MEMORY_I2C_ADDR,
+#endif
+  I2C_SCAN_NO_MORE_ADDRESSES
+};
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 /**
- * @brief Scans the I2C bus for connected devices.
+ * @brief Scans the next slice of the I2C bus for connected devices.
  * 
- * This function checks all 7-bit I2C addresses to detect connected devices 
- * and marks their presence in a bit field array. The result includes an error 
- * code indicating the success or failure of the scan.
+ * This function checks the next `I2C_SCAN_ADDRESSES_PER_SLICE` addresses of the scan (all 7-bit
+ * addresses or only the known ones) and marks detected devices in a bit field array. The bit field
+ * is cleared when a new scan starts, `scan_cursor` of the reading keeps the position between calls.
  * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading`: Contains a bit field array where each bit represents 
- *           an I2C address. Bits set to `1` indicate detected devices.
- *         - `error_code`: Status of the scan operation. Possible values:
+ * @param device_address `I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES` or `I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES`.
+ * @param[in,out] reading Pointer to the reading, its `addresses` bit field array gets one bit per
+ *             I2C address. Bits set to `1` indicate detected devices.
+ * 
+ * @return Status of the scan operation. Possible values:
  *             - `ERROR_CODE_NO_ERROR`: Scan completed successfully.
- *             - `ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED`: Scan did not complete.
+ *             - `ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED`: More slices are needed.
  * 
  * @note Ensure the I2C bus is initialized before calling this function.
  */
-static i2c_scan_return_ts i2c_scan_scanForAddresses();
+static control_error_code_te i2c_scan_scanForAddresses(uint8_t device_address, i2c_scan_reading_ts *reading);
+
+/**
+ * @brief Returns the address probed at a position of the scan.
+ *
+ * @param device_address `I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES` or `I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES`.
+ * @param position Number of probes done so far.
+ * @return uint8_t The address, or `I2C_SCAN_NO_MORE_ADDRESSES` when every address was probed.
+ */
+static uint8_t addressAtPosition(uint8_t device_address, uint8_t position);
 
 /**
  * @brief Checks the status of a specific I2C device.
@@ -25,18 +59,17 @@ static i2c_scan_return_ts i2c_scan_scanForAddresses();
  * Sends a transmission to the specified I2C address and returns the result.
  * 
  * @param address The 7-bit I2C address to check (1–127).
- * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading.single_device_status`: Indicates the transmission result:
+ * @param[out] reading Pointer to the reading, `single_device_status` receives the transmission result:
  *             - `I2C_SCAN_TRANSMISSION_RESULT_SUCCESS`: Device detected.
  *             - Other values indicate specific transmission errors.
- *         - `error_code`: 
+ * 
+ * @return
  *             - `ERROR_CODE_NO_ERROR`: Operation successful.
  *             - `ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS`: Invalid result or bus issue.
  * 
  * @note Ensure the I2C bus is initialized before calling this function.
  */
-static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address);
+static control_error_code_te i2c_scan_checkDeviceStatus(uint8_t address, i2c_scan_reading_ts *reading);
 
 /**
  * @brief Updates the next available I2C address from the scan data.
@@ -51,77 +84,113 @@ static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address);
  * @return `I2C_SCAN_ADDRESS_FOUND` if a valid address is found, otherwise `I2C_SCAN_ADDRESS_NOT_FOUND`.
  */
 static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data);
+
+/**
+ * @brief Probes one address with an empty write transaction on the I2C bus.
+ *
+ * @param address The 7-bit I2C address to probe.
+ * @return uint8_t Transmission result (`I2C_SCAN_TRANSMISSION_RESULT_*`), bus errors and
+ *         timeouts are reported as `I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN`.
+ */
+static uint8_t probeAddress(uint8_t address);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
-i2c_scan_return_ts i2c_scan_getReading(uint8_t device_address)
+control_error_code_te i2c_scan_getReading(uint8_t device_address, i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
+  control_error_code_te error_code;
 
-  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == device_address)
+  if(I2C_SCAN_IS_MULTI_DEVICE_SCAN(device_address))
   {
-    // Find all I2C addresses on the bus
-    return_data = i2c_scan_scanForAddresses();
+    // Find I2C addresses on the bus, one slice per call
+    error_code = i2c_scan_scanForAddresses(device_address, reading);
+    if(ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED == error_code)
+    {
+      return error_code; // Result is not complete, iteration fields stay untouched
+    }
   }
   else if(device_address >= I2C_SCAN_I2C_ADDRESS_MIN && device_address <= I2C_SCAN_I2C_ADDRESS_MAX)
   {
     // Find status of the I2C device with specific address
-    return_data = i2c_scan_checkDeviceStatus(device_address);
+    error_code = i2c_scan_checkDeviceStatus(device_address, reading);
   }
   else
   {
-    return_data.error_code = ERROR_CODE_I2C_SCAN_INVALID_ADDRESS_PARAMETER;
+    error_code = ERROR_CODE_I2C_SCAN_INVALID_ADDRESS_PARAMETER;
   }
 
-  return_data.i2c_scan_reading.current_i2c_addr = I2C_SCAN_STARTING_ADDRESS; // Because we start the loop from current address + 1
-  return_data.i2c_scan_reading.update_i2c_address = i2c_scan_updateNextAddress;
-  return_data.i2c_scan_reading.device_address = device_address;
+  reading->current_i2c_addr = I2C_SCAN_STARTING_ADDRESS; // Because we start the loop from current address + 1
+  reading->update_i2c_address = i2c_scan_updateNextAddress;
+  reading->device_address = device_address;
 
-  return return_data;
+  return error_code;
 }
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
-static i2c_scan_return_ts i2c_scan_scanForAddresses()
+static control_error_code_te i2c_scan_scanForAddresses(uint8_t device_address, i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
-  return_data.error_code = ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED;
-  // Set all the bits to 0
-  memset(return_data.i2c_scan_reading.addresses, 0, sizeof(return_data.i2c_scan_reading.addresses));
+  if(I2C_SCAN_CURSOR_START == reading->scan_cursor)
+  {
+    // New scan, set all the bits to 0
+    memset(reading->addresses, 0, sizeof(reading->addresses));
+  }
 
   uint8_t transmission_result = I2C_SCAN_TRANSMISSION_RESULT_SUCCESS;
-  uint8_t address;
 
-  // Iterate through all the possible I2C addresses for 7-bit addressing
-  for (address = I2C_SCAN_I2C_ADDRESS_MIN; address <= I2C_SCAN_I2C_ADDRESS_MAX; address++) 
+  // Iterate through the next slice of the addresses
+  for (uint8_t probes = 0u; probes < I2C_SCAN_ADDRESSES_PER_SLICE; probes++)
   {
+    uint8_t address = addressAtPosition(device_address, reading->scan_cursor);
+    if(I2C_SCAN_NO_MORE_ADDRESSES == address)
+    {
+      // Every address is tried out, next call starts a new scan
+      reading->scan_cursor = I2C_SCAN_CURSOR_START;
+      return ERROR_CODE_NO_ERROR;
+    }
+
     // Try to contact the address and capture the result
-    Wire.beginTransmission(address);
-    transmission_result = Wire.endTransmission();
+    transmission_result = probeAddress(address);
 
     if(I2C_SCAN_TRANSMISSION_RESULT_SUCCESS == transmission_result)
     {
       // Set the bit corresponding to this address in the addresses array
-      return_data.i2c_scan_reading.addresses[address / BITS_IN_BYTE] |= (1 << (address % BITS_IN_BYTE));
+      reading->addresses[address / BITS_IN_BYTE] |= (1 << (address % BITS_IN_BYTE));
     }
+    reading->scan_cursor++;
+  }
+
+  // Finish right away if the slice ended exactly at the last address
+  if(I2C_SCAN_NO_MORE_ADDRESSES == addressAtPosition(device_address, reading->scan_cursor))
+  {
+    reading->scan_cursor = I2C_SCAN_CURSOR_START;
+    return ERROR_CODE_NO_ERROR;
+  }
+  return ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED;
+}
+
+static uint8_t addressAtPosition(uint8_t device_address, uint8_t position)
+{
+  if(I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES == device_address)
+  {
+    // Table is terminated, so the position never passes the end marker
+    return PLATFORM_READ_BYTE(&known_addresses[position]);
   }
-  // The loop completed and every I2C address is tried out
-  if(I2C_SCAN_I2C_ADDRESS_MAX < address)
+
+  if((uint8_t)(I2C_SCAN_I2C_ADDRESS_MAX - I2C_SCAN_I2C_ADDRESS_MIN) < position)
   {
-    return_data.error_code = ERROR_CODE_NO_ERROR;
+    return I2C_SCAN_NO_MORE_ADDRESSES;
   }
-  return return_data;
+  return (uint8_t)(I2C_SCAN_I2C_ADDRESS_MIN + position);
 }
 
-static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address)
+static control_error_code_te i2c_scan_checkDeviceStatus(uint8_t address, i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
-  return_data.error_code = ERROR_CODE_NO_ERROR;
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
   uint8_t transmission_result = I2C_SCAN_TRANSMISSION_RESULT_SUCCESS;
 
   // Try to contact the address and capture the result
-  Wire.beginTransmission(address);
-  transmission_result = Wire.endTransmission();
+  transmission_result = probeAddress(address);
 
   // Check if the transmission result is valid
   if(I2C_SCAN_TRANSMISSION_RESULT_SUCCESS == transmission_result || 
@@ -130,14 +199,14 @@ static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address)
      I2C_SCAN_TRANSMISSION_RESULT_NACKDAT == transmission_result ||
      I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN == transmission_result)
   {
-    return_data.i2c_scan_reading.single_device_status = transmission_result;
+    reading->single_device_status = transmission_result;
   }
   else
   {
-    return_data.error_code = ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS;
+    error_code = ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS;
   }
 
-  return return_data;
+  return error_code;
 }
 
 static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data)
@@ -163,4 +232,25 @@ static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data)
 
   return next_address_is_found;
 }
+
+static uint8_t probeAddress(uint8_t address)
+{
+  i2c_bus_job_ts probe_job;
+
+  i2c_bus_prepareJob(&probe_job, address, nullptr, 0u, nullptr, 0u);
+  switch(i2c_bus_transfer(&probe_job))
+  {
+    case I2C_BUS_JOB_DONE:
+      return I2C_SCAN_TRANSMISSION_RESULT_SUCCESS;
+
+    case I2C_BUS_JOB_NACK_ADDRESS:
+      return I2C_SCAN_TRANSMISSION_RESULT_NACKADR;
+
+    case I2C_BUS_JOB_NACK_DATA:
+      return I2C_SCAN_TRANSMISSION_RESULT_NACKDAT;
+
+    default:
+      return I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN;
+  }
+}
 /* *************************************** */
\ No newline at end of file
@@ -2,8 +2,13 @@
 #define I2C_SCAN_H
 
 #include <Arduino.h>
-#include <Wire.h>
 #include "../input_types.h"
+#include "../rtc/rtc.h"
+#include "../sensors/sensor_library/sensors_config.h"
+#include "../../output/display/display_config.h"
+#include "../../output/data_log/data_log_config.h"
+#include "../../project_settings.h"
+#include "../../i2c_bus/i2c_bus.h"
 
 #define I2C_SCAN_ADDRESS_FOUND                 (bool)(true)
 
@@ -25,21 +30,37 @@
 #define I2C_SCAN_OFFSET_FOR_NEXT_ADDR          (uint8_t)(1u)
 #define I2C_SCAN_STARTING_ADDRESS              (uint8_t)(I2C_SCAN_I2C_ADDRESS_MIN - I2C_SCAN_OFFSET_FOR_NEXT_ADDR)
 
+/**
+ * Maximum number of addresses probed by one call of a multi device scan.
+ * A probe takes about 0.2 ms at 100 kHz, so one slice keeps the scheduler responsive.
+ */
+#define I2C_SCAN_ADDRESSES_PER_SLICE           (uint8_t)(8u)
+
+/* Marks the end of a scan and terminates the table of known device addresses, 0 is not a valid I2C address */
+#define I2C_SCAN_NO_MORE_ADDRESSES             (uint8_t)(0u)
+
 /**
  * @brief Scans the I2C bus or checks the status of a specific device.
  * 
  * Depending on the input, this function either:
  * 1. Scans all I2C addresses (`I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES`) and marks detected devices.
- * 2. Checks the status of a device at a specific 7-bit address (1–127).
+ * 2. Scans only the addresses of the configured devices (`I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES`).
+ * 3. Checks the status of a device at a specific 7-bit address (1–127).
+ *
+ * Multi device scans are time sliced: every call probes at most `I2C_SCAN_ADDRESSES_PER_SLICE`
+ * addresses and keeps its position in the reading, so the same reading must be passed again
+ * until the scan is finished.
  * 
- * @param device_address Address to check or `I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES` for a full scan.
+ * @param device_address Address to check, `I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES` for a full scan
+ *                       or `I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES` for a scan of the known devices.
+ * @param reading Pointer to the caller owned reading which is filled in place with the
+ *                detected devices or the single device status.
  * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading`: Contains detected devices or single device status.
- *         - `error_code`: Indicates success or specific errors.
+ * @return control_error_code_te Indicates success or specific errors,
+ *         `ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED` while a multi device scan needs more calls.
  * 
  * @note Ensure the I2C bus is initialized before calling.
  */
-i2c_scan_return_ts i2c_scan_getReading(uint8_t device_address);
+control_error_code_te i2c_scan_getReading(uint8_t device_address, i2c_scan_reading_ts *reading);
 
 #endif
\ No newline at end of file
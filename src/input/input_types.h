@@ -23,6 +23,20 @@
  */
 #define I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES     (uint8_t)(0u)
 
+/**
+ * I2C scan mode to detect only the devices declared in the project settings.
+ *
+ * Same result as I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES, but only the addresses of the
+ * configured components are probed. Value is outside of the 7-bit address range.
+ */
+#define I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES   (uint8_t)(0x80u)
+
+/* Macro that checks if the scan mode fills the `addresses` field instead of a single device status */
+#define I2C_SCAN_IS_MULTI_DEVICE_SCAN(mode)    ((I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == (mode)) || (I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES == (mode)))
+
+/* Cursor of a scan which is not started yet, or which has just finished */
+#define I2C_SCAN_CURSOR_START                  (uint8_t)(0u)
+
 /**
  * Array size required to store the presence of I2C devices, one bit per device.
  * Each byte will store 8 device states (1 bit per device).
@@ -50,15 +64,18 @@
 /**
  * Structure representing a single sensor reading.
  * Members:
- *  - value: The measured value from the sensor.
+ *  - value: The measured value from the sensor, scaled by 10^num_of_decimals of the catalog entry
+ *           when SENSORS_FIXED_POINT_VALUES is used (see sensor_value.h).
  *  - indication: A flag for indication (for example raining / not raining).
  *  - measurement_type_switch: Identifier for the type of measurement (float value / indication).
+ *  - timestamp: Time of the sample in seconds (see control_getTimestamp()).
  */
 typedef struct
 {
-  float value;
+  sensor_value_t value;
   bool indication;
   uint8_t measurement_type_switch;
+  uint32_t timestamp;
 }sensor_reading_ts;
 
 /**
@@ -72,6 +89,45 @@ typedef struct
   sensor_reading_ts sensor_reading;
   control_error_code_te error_code;
 } sensor_return_ts;
+
+/* Number of readings in a sensors snapshot, at least one slot is reserved so the array is valid without configured sensors */
+#define SENSORS_SNAPSHOT_CAPACITY        (uint8_t)((SENSORS_CATALOG_NUM_OF_SENSORS > 0u) ? SENSORS_CATALOG_NUM_OF_SENSORS : 1u)
+
+/**
+ * Structure containing the readings of all configured sensors taken in a single sweep.
+ * Members:
+ *  - timestamp: Time in milliseconds (millis() based) at which the sweep was started.
+ *  - num_of_readings: Number of valid entries in readings.
+ *  - readings: Result of every sensor reading, indexed by catalog index (see sensors_interface_sensorIndexToId).
+ */
+typedef struct
+{
+  uint32_t timestamp;
+  uint8_t num_of_readings;
+  sensor_return_ts readings[SENSORS_SNAPSHOT_CAPACITY];
+} sensors_snapshot_ts;
+/* ***************************************** */
+
+/* HISTORY COMPONENT */
+/* Highest number of samples of a trend, one column of the LCD per sample */
+#define TREND_MAX_SAMPLES                (uint8_t)(16u)
+/* Bar levels of a trend sample, level 0 is a sample which is missing */
+#define TREND_NO_SAMPLE                  (uint8_t)(0u)
+#define TREND_MIN_LEVEL                  (uint8_t)(1u)
+#define TREND_MAX_LEVEL                  (uint8_t)(8u)
+
+/**
+ * Structure representing the latest samples of a measurement, scaled to bar levels.
+ * Members:
+ *  - levels: Level of every sample (TREND_MIN_LEVEL..TREND_MAX_LEVEL), oldest first, the lowest
+ *            sample of the trend has the lowest level and the highest sample the highest level.
+ *  - num_of_samples: Number of valid entries in levels.
+ */
+typedef struct
+{
+  uint8_t levels[TREND_MAX_SAMPLES];
+  uint8_t num_of_samples;
+} trend_reading_ts;
 /* ***************************************** */
 
 /* RTC COMPONENT */
@@ -94,18 +150,6 @@ typedef struct
   uint8_t mins;
   uint8_t secs;
 }rtc_reading_ts;
-
-/**
- * Structure containing the result of an RTC operation.
- * Members:
- *  - rtc_reading: Contains the actual time data retrieved from the RTC.
- *  - error_code: Indicates whether the operation succeeded or provides an error code in case of failure.
- */
-typedef struct
-{
-  rtc_reading_ts rtc_reading;
-  control_error_code_te error_code;
-} rtc_return_ts;
 /* ***************************************** */
 
 /* I2C SCAN COMPONENT */
@@ -125,11 +169,14 @@ typedef bool (*update_i2c_address_fn)(struct i2c_scan_reading *i2c_scan_data);
  *  - device_address: Specifies the type of scan to be performed:
  *                    - 0: Perform a scan for all devices and populate the `addresses` field.
  *                          This is because 0 is not a valid I2C address.
+ *                    - 0x80: Perform a scan for the known devices and populate the `addresses` field.
  *                    - 1–127: Perform a single-device status check for the specified address 
  *                              and update the `single_device_status` field.
  *  - update_to_next_i2c_address: Function pointer that updates `current_i2c_addr` 
  *                                to the next detected I2C address in `addresses` bit-field.
  *  - current_i2c_addr: Stores the currently selected I2C address during iteration.
+ *  - scan_cursor: Number of probes done by an unfinished scan, the next call continues from it.
+ *                 `I2C_SCAN_CURSOR_START` when no scan is in progress.
  */
 typedef struct i2c_scan_reading
 {
@@ -138,19 +185,8 @@ typedef struct i2c_scan_reading
   uint8_t device_address;
   update_i2c_address_fn update_i2c_address;
   uint8_t current_i2c_addr;
+  uint8_t scan_cursor;
 } i2c_scan_reading_ts;
-
-/**
- * Structure containing the result of an I2C scan operation.
- * Members:
- *  - i2c_scan_reading: Contains the data from the I2C scan.
- *  - error_code: Indicates whether the operation succeeded or provides an error code in case of failure.
- */
-typedef struct 
-{
-  i2c_scan_reading_ts i2c_scan_reading;
-  control_error_code_te error_code;
-} i2c_scan_return_ts;
 /* ***************************************** */
 
 #endif
\ No newline at end of file
@@ -1,51 +1,413 @@
 #include "rtc.h"
 
 /* STATIC GLOBAL VARIABLES */
-static RTC_DS3231 rtc;
+// Edges of SQW queued by the interrupt, the only data it hands over
+static spsc_ring_ts<rtc_sqw_tick_ts, RTC_TICK_QUEUE_SIZE> sqw_queue;
+static volatile bool tick_wake_up = RTC_TICK_WAKE_UP_NOT_ARMED;
+// Epoch advanced by the queued edges, outside of the interrupt
+static uint32_t epoch_seconds = RTC_EPOCH_INVALID;
+static uint8_t sqw_edges = 0u; // Edges since the last synchronization, saturates
+static uint8_t sqw_ticks = 0u; // Free running count of the edges
+static uint32_t last_tick_millis = 0u;
+// Fallback for the time before the first SQW edge
+static uint32_t sync_epoch = RTC_EPOCH_INVALID;
+static uint32_t sync_millis = 0u;
+// Time and SQW count at the submission of the latest read, the registers are read right after it
+static uint32_t last_sync_request = 0u;
+static uint8_t request_ticks = 0u;
+static bool rtc_ready = RTC_NOT_READY;
+
+// Background read of the time registers
+static i2c_bus_job_ts time_job;
+static const uint8_t time_register = RTC_REG_TIME;
+static uint8_t time_buffer[RTC_TIME_SIZE];
+
+// Days before the first day of every month in a common year
+static const uint16_t days_before_month[RTC_MAX_MONTH] PLATFORM_PROGMEM = {0u, 31u, 59u, 90u, 120u, 151u, 181u, 212u, 243u, 273u, 304u, 334u};
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(RTC_INT1_PIN == RTC_SQW_PIN, "RTC SQW must be connected to INT1 (pin 3), the epoch is advanced by its edges");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Sets the RTC to the compile date and time and clears the oscillator stop flag.
+ *
+ * @param status Value of the status register read during the initialization.
+ * @return true if both writes succeeded, false otherwise.
+ */
+static bool setCompileTime(uint8_t status);
+
+/**
+ * @brief Converts the BCD time registers to the RTC reading.
+ *
+ * @param registers Time registers read from RTC_REG_TIME.
+ * @param reading Pointer to the reading which receives the date and time.
+ */
+static void decodeTime(const uint8_t *registers, rtc_reading_ts *reading);
+
+/**
+ * @brief Checks that every field of the reading is in its range.
+ *
+ * @param reading Reading decoded from the time registers.
+ * @return true if the reading is valid, false otherwise.
+ */
+static bool isTimeValid(const rtc_reading_ts *reading);
+
+/**
+ * @brief Converts a valid date and time to the epoch.
+ *
+ * @param reading Date and time, year in 2000..2099.
+ * @return uint32_t Seconds since 2000-01-01 00:00:00.
+ */
+static uint32_t timeToEpoch(const rtc_reading_ts *reading);
+
+/**
+ * @brief Converts the epoch to the date and time.
+ *
+ * @param epoch Seconds since 2000-01-01 00:00:00.
+ * @param reading Pointer to the reading which receives the date and time.
+ */
+static void epochToTime(uint32_t epoch, rtc_reading_ts *reading);
+
+/**
+ * @brief Takes over a time read from the registers as the new epoch.
+ *
+ * SQW edges which came after the read was submitted are added, so a late takeover does not lose seconds.
+ *
+ * @param registers Time registers read from RTC_REG_TIME.
+ * @return true if the time was valid and taken over, false otherwise.
+ */
+static bool synchronize(const uint8_t *registers);
+
+/**
+ * @brief Advances the epoch by the SQW edges queued by the interrupt.
+ *
+ * Called before every use of the epoch or the time of the last tick.
+ */
+static void applyQueuedTicks();
+
+/**
+ * @brief Selects the falling edge of INT1 and clears a flag raised by the switch of the mode.
+ *
+ * Must be called with disabled interrupts.
+ */
+static void selectFallingEdge();
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 control_error_code_te rtc_init()
 {
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+  i2c_bus_job_ts job;
+  const uint8_t status_register = RTC_REG_STATUS;
+  const uint8_t control_registers[] = {RTC_REG_CONTROL, RTC_CONTROL_SQW_1HZ};
+  uint8_t status = 0u;
 
-  if (!rtc.begin()) 
+  i2c_bus_prepareJob(&job, RTC_I2C_ADDR, &status_register, sizeof(status_register), &status, sizeof(status));
+  if (I2C_BUS_JOB_DONE != i2c_bus_transfer(&job))
+  {
+    return ERROR_CODE_INIT_FAILED;
+  }
+
+  if (RTC_STATUS_OSF & status) // When time needs to be set on a new device, or after a power loss
+  {
+    if (!setCompileTime(status)) // Set to the compile time
+    {
+      error_code = ERROR_CODE_INIT_FAILED;
+    }
+  }
+
+  // 1 Hz on SQW, every falling edge is one second of the epoch
+  i2c_bus_prepareJob(&job, RTC_I2C_ADDR, control_registers, sizeof(control_registers), nullptr, 0u);
+  if (I2C_BUS_JOB_DONE != i2c_bus_transfer(&job))
   {
     error_code = ERROR_CODE_INIT_FAILED;
   }
+  pinMode(RTC_SQW_PIN, INPUT_PULLUP);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    selectFallingEdge();
+    EIMSK |= _BV(INT1);
+  }
+
+  // First time is read right away, afterwards it is resynchronized by rtc_service()
+  i2c_bus_prepareJob(&time_job, RTC_I2C_ADDR, &time_register, sizeof(time_register), time_buffer, sizeof(time_buffer));
+  last_sync_request = millis();
+  applyQueuedTicks();
+  request_ticks = sqw_ticks;
+  if (I2C_BUS_JOB_DONE == i2c_bus_transfer(&time_job))
+  {
+    (void)synchronize(time_buffer);
+  }
+  rtc_ready = RTC_READY;
+
+  return error_code;
+}
+
+control_error_code_te rtc_getTime(uint8_t id, rtc_reading_ts *reading)
+{
+  uint32_t epoch = rtc_getEpoch();
+
+  if(id != RTC_DEFAULT_RTC || RTC_EPOCH_INVALID == epoch)
+  {
+    return ERROR_CODE_RTC_NOT_FOUND;
+  }
 
-  if (rtc.lostPower()) // When time needs to be set on a new device, or after a power loss
+  epochToTime(epoch, reading); // Fields were validated at the synchronization
+  return ERROR_CODE_NO_ERROR;
+}
+
+uint32_t rtc_getEpoch()
+{
+  applyQueuedTicks();
+
+  uint32_t epoch = epoch_seconds;
+  if(RTC_EPOCH_INVALID != epoch && 0u == sqw_edges)
   {
-    rtc.adjust(DateTime(F(RTC_COMPILE_DATE), F(RTC_COMPILE_TIME))); // Set to the compile time
+    epoch = sync_epoch + (millis() - sync_millis) / RTC_MS_PER_SECOND; // No SQW edge since the synchronization
   }
+  return epoch;
 }
 
-rtc_return_ts rtc_getTime(uint8_t id)
+void rtc_service(uint32_t current_millis)
 {
-  rtc_return_ts new_reading;
-  new_reading.error_code = ERROR_CODE_RTC_NOT_FOUND;
+  if(RTC_READY != rtc_ready || I2C_BUS_IS_JOB_PENDING(time_job.status))
+  {
+    return; // Not initialized or the previous read is still on the bus
+  }
 
-  if(id == RTC_DEFAULT_RTC)
+  if(I2C_BUS_JOB_DONE == time_job.status)
+  {
+    (void)synchronize(time_buffer);
+    time_job.status = I2C_BUS_JOB_IDLE; // Result is taken over only once
+  }
+  else if(I2C_BUS_JOB_IDLE != time_job.status)
   {
-    DateTime now = rtc.now();
+    epoch_seconds = RTC_EPOCH_INVALID; // RTC did not answer, do not report a stale time
+    time_job.status = I2C_BUS_JOB_IDLE;
+  }
 
-    if(now.hour() >= RTC_MIN_HOUR && now.hour() <= RTC_MAX_HOUR && 
-        now.minute() >= RTC_MIN_MINUTE && now.minute() <= RTC_MAX_MINUTE && 
-        now.second() >= RTC_MIN_SECOND && now.second() <= RTC_MAX_SECOND &&
-        now.year() >= RTC_MIN_YEAR && now.month() >= RTC_MIN_MONTH &&
-        now.month() >= RTC_MIN_MONTH && now.month() <= RTC_MAX_MONTH &&
-        now.day() >= RTC_MIN_DAY && now.day() <= RTC_MAX_DAY)
+  if(RTC_EPOCH_INVALID == rtc_getEpoch() || (current_millis - last_sync_request) >= RTC_RESYNC_PERIOD_MS)
+  {
+    applyQueuedTicks();
+    request_ticks = sqw_ticks;
+    if(I2C_BUS_JOB_ACCEPTED == i2c_bus_submit(&time_job))
     {
-      new_reading.rtc_reading.year = now.year();
-      new_reading.rtc_reading.month = now.month();
-      new_reading.rtc_reading.day = now.day();
-      new_reading.rtc_reading.hour = now.hour();
-      new_reading.rtc_reading.mins = now.minute();
-      new_reading.rtc_reading.secs = now.second();
-
-      new_reading.error_code = ERROR_CODE_NO_ERROR;
+      last_sync_request = current_millis;
     }
   }
-  return new_reading;
 }
-/* *************************************** */
\ No newline at end of file
+
+bool rtc_getNextTick(uint32_t current_millis, uint32_t *tick_millis)
+{
+  applyQueuedTicks();
+
+  if(0u != sqw_edges && (current_millis - last_tick_millis) < RTC_MS_PER_SECOND)
+  {
+    *tick_millis = last_tick_millis + RTC_MS_PER_SECOND;
+    return RTC_TICK_KNOWN;
+  }
+  return RTC_TICK_UNKNOWN;
+}
+
+bool rtc_armTickWakeUp()
+{
+  bool armed = RTC_TICK_WAKE_UP_NOT_ARMED;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(HIGH == digitalRead(RTC_SQW_PIN))
+    {
+      EICRA &= (uint8_t)~(_BV(ISC11) | _BV(ISC10)); // Low level of INT1
+      tick_wake_up = RTC_TICK_WAKE_UP_ARMED;
+      armed = RTC_TICK_WAKE_UP_ARMED;
+    }
+  }
+  return armed;
+}
+
+bool rtc_finishTickWakeUp(uint32_t *tick_millis)
+{
+  bool woken_by_tick = RTC_WOKEN_BY_TICK;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(RTC_TICK_WAKE_UP_ARMED == tick_wake_up)
+    {
+      // Another interrupt woke the MCU before the tick
+      selectFallingEdge();
+      tick_wake_up = RTC_TICK_WAKE_UP_NOT_ARMED;
+      woken_by_tick = RTC_NOT_WOKEN_BY_TICK;
+    }
+  }
+
+  if(RTC_WOKEN_BY_TICK == woken_by_tick)
+  {
+    applyQueuedTicks(); // Tick is queued, the interrupt ran before the MCU continued here
+    *tick_millis = last_tick_millis;
+  }
+  return woken_by_tick;
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(INT1_vect)
+{
+  // Seconds register of the DS3231 is incremented together with the falling edge
+  rtc_sqw_tick_ts tick = {(uint32_t)millis(), RTC_TICK_MILLIS_RUNNING};
+  if(RTC_TICK_WAKE_UP_ARMED == tick_wake_up)
+  {
+    // Woken from power-save by the low level, millis() stood still since the previous tick
+    selectFallingEdge();
+    tick_wake_up = RTC_TICK_WAKE_UP_NOT_ARMED;
+    tick.millis_stopped = RTC_TICK_MILLIS_STOPPED;
+  }
+  (void)spsc_ring_push(&sqw_queue, &tick); // Ticks are applied at every read of the epoch, a lost one is corrected by the next resynchronization
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool setCompileTime(uint8_t status)
+{
+  i2c_bus_job_ts job;
+  // Register address followed by seconds, minutes, hours, weekday, day, month and year
+  const uint8_t time_registers[] = {RTC_REG_TIME,
+                                    RTC_BIN_TO_BCD(RTC_COMPILE_SECOND), RTC_BIN_TO_BCD(RTC_COMPILE_MINUTE), RTC_BIN_TO_BCD(RTC_COMPILE_HOUR),
+                                    RTC_DEFAULT_WEEKDAY, RTC_BIN_TO_BCD(RTC_COMPILE_DAY), RTC_BIN_TO_BCD(RTC_COMPILE_MONTH),
+                                    RTC_BIN_TO_BCD(RTC_COMPILE_YEAR - RTC_YEAR_BASE)};
+  const uint8_t status_registers[] = {RTC_REG_STATUS, (uint8_t)(status & (uint8_t)~RTC_STATUS_OSF)};
+
+  i2c_bus_prepareJob(&job, RTC_I2C_ADDR, time_registers, sizeof(time_registers), nullptr, 0u);
+  if(I2C_BUS_JOB_DONE != i2c_bus_transfer(&job))
+  {
+    return false;
+  }
+
+  i2c_bus_prepareJob(&job, RTC_I2C_ADDR, status_registers, sizeof(status_registers), nullptr, 0u);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+static void decodeTime(const uint8_t *registers, rtc_reading_ts *reading)
+{
+  reading->secs = RTC_BCD_TO_BIN(registers[0] & RTC_SECONDS_MASK);
+  reading->mins = RTC_BCD_TO_BIN(registers[1] & RTC_MINUTES_MASK);
+  reading->hour = RTC_BCD_TO_BIN(registers[2] & RTC_HOURS_MASK);
+  // registers[3] is the day of the week
+  reading->day = RTC_BCD_TO_BIN(registers[4] & RTC_DAY_MASK);
+  reading->month = RTC_BCD_TO_BIN(registers[5] & RTC_MONTH_MASK);
+  reading->year = (uint16_t)(RTC_YEAR_BASE + RTC_BCD_TO_BIN(registers[6]));
+}
+
+static bool isTimeValid(const rtc_reading_ts *reading)
+{
+  return reading->hour >= RTC_MIN_HOUR && reading->hour <= RTC_MAX_HOUR &&
+         reading->mins >= RTC_MIN_MINUTE && reading->mins <= RTC_MAX_MINUTE &&
+         reading->secs >= RTC_MIN_SECOND && reading->secs <= RTC_MAX_SECOND &&
+         reading->year >= RTC_MIN_YEAR &&
+         reading->month >= RTC_MIN_MONTH && reading->month <= RTC_MAX_MONTH &&
+         reading->day >= RTC_MIN_DAY && reading->day <= RTC_MAX_DAY;
+}
+
+static uint32_t timeToEpoch(const rtc_reading_ts *reading)
+{
+  uint32_t days = 0u;
+
+  for(uint16_t year = RTC_YEAR_BASE; year < reading->year; year++)
+  {
+    days += RTC_DAYS_IN_YEAR(year);
+  }
+  days += PLATFORM_READ_WORD(&days_before_month[reading->month - 1u]);
+  if(reading->month > RTC_FEBRUARY && RTC_IS_LEAP_YEAR(reading->year))
+  {
+    days++;
+  }
+  days += (uint32_t)(reading->day - 1u);
+
+  return days * RTC_SECONDS_PER_DAY + reading->hour * RTC_SECONDS_PER_HOUR + reading->mins * RTC_SECONDS_PER_MINUTE + reading->secs;
+}
+
+static void epochToTime(uint32_t epoch, rtc_reading_ts *reading)
+{
+  uint32_t days = epoch / RTC_SECONDS_PER_DAY;
+  uint32_t seconds_of_day = epoch % RTC_SECONDS_PER_DAY;
+
+  reading->hour = (uint8_t)(seconds_of_day / RTC_SECONDS_PER_HOUR);
+  reading->mins = (uint8_t)((seconds_of_day % RTC_SECONDS_PER_HOUR) / RTC_SECONDS_PER_MINUTE);
+  reading->secs = (uint8_t)(seconds_of_day % RTC_SECONDS_PER_MINUTE);
+
+  uint16_t year = RTC_YEAR_BASE;
+  while(days >= RTC_DAYS_IN_YEAR(year))
+  {
+    days -= RTC_DAYS_IN_YEAR(year);
+    year++;
+  }
+  reading->year = year;
+
+  uint8_t month = RTC_MAX_MONTH;
+  uint16_t leap_day = 0u;
+  // Search the last month which starts before the day, leap day counts from March on
+  while(month > RTC_MIN_MONTH)
+  {
+    leap_day = (month > RTC_FEBRUARY && RTC_IS_LEAP_YEAR(year)) ? 1u : 0u;
+    if(days >= PLATFORM_READ_WORD(&days_before_month[month - 1u]) + leap_day)
+    {
+      break;
+    }
+    month--;
+  }
+  if(RTC_MIN_MONTH == month)
+  {
+    leap_day = 0u;
+  }
+  reading->month = month;
+  reading->day = (uint8_t)(days - PLATFORM_READ_WORD(&days_before_month[month - 1u]) - leap_day + 1u);
+}
+
+static bool synchronize(const uint8_t *registers)
+{
+  rtc_reading_ts reading;
+
+  decodeTime(registers, &reading);
+  if(!isTimeValid(&reading))
+  {
+    return false;
+  }
+
+  uint32_t epoch = timeToEpoch(&reading);
+  applyQueuedTicks();
+  uint8_t late_edges = (uint8_t)(sqw_ticks - request_ticks);
+  sync_epoch = epoch;
+  sync_millis = last_sync_request;
+  epoch_seconds = epoch + late_edges;
+  sqw_edges = late_edges;
+  return true;
+}
+
+static void applyQueuedTicks()
+{
+  rtc_sqw_tick_ts tick;
+
+  while(SPSC_RING_POPPED == spsc_ring_pop(&sqw_queue, &tick))
+  {
+    sqw_ticks++;
+    last_tick_millis = (RTC_TICK_MILLIS_STOPPED == tick.millis_stopped) ? (last_tick_millis + RTC_MS_PER_SECOND) : tick.tick_millis;
+
+    if(RTC_EPOCH_INVALID != epoch_seconds)
+    {
+      epoch_seconds++;
+      if(sqw_edges < UINT8_MAX)
+      {
+        sqw_edges++;
+      }
+    }
+  }
+}
+
+static void selectFallingEdge()
+{
+  EICRA = (uint8_t)((EICRA & ~(_BV(ISC11) | _BV(ISC10))) | _BV(ISC11));
+  EIFR = _BV(INTF1);
+}
+/* *************************************** */
@@ -2,19 +2,119 @@
 #ifndef RTC_H
 #define RTC_H
 
-#include <avr/pgmspace.h>
+#include "../../platform/platform.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include <Arduino.h>
-#include <Wire.h>
-#include <RTClib.h>
 #include "../input_types.h"
+#include "../../i2c_bus/i2c_bus.h"
+#include "../../spsc_ring/spsc_ring.h"
 
 /* Macro for RTC compile date */
 #define RTC_COMPILE_DATE    __DATE__
 /* Macro for RTC compile time */
 #define RTC_COMPILE_TIME    __TIME__
 
+/* Macros that read the fields of the compile date ("Mmm dd yyyy") and time ("hh:mm:ss") at compile time */
+#define RTC_DIGIT(string, index)  (uint8_t)((string)[index] - '0')
+#define RTC_COMPILE_YEAR    (uint16_t)(RTC_DIGIT(RTC_COMPILE_DATE, 7) * 1000u + RTC_DIGIT(RTC_COMPILE_DATE, 8) * 100u + \
+                                       RTC_DIGIT(RTC_COMPILE_DATE, 9) * 10u + RTC_DIGIT(RTC_COMPILE_DATE, 10))
+#define RTC_COMPILE_MONTH   (uint8_t)(('J' == RTC_COMPILE_DATE[0]) ? (('a' == RTC_COMPILE_DATE[1]) ? 1u : (('n' == RTC_COMPILE_DATE[2]) ? 6u : 7u)) : \
+                                      ('F' == RTC_COMPILE_DATE[0]) ? 2u : \
+                                      ('M' == RTC_COMPILE_DATE[0]) ? (('r' == RTC_COMPILE_DATE[2]) ? 3u : 5u) : \
+                                      ('A' == RTC_COMPILE_DATE[0]) ? (('p' == RTC_COMPILE_DATE[1]) ? 4u : 8u) : \
+                                      ('S' == RTC_COMPILE_DATE[0]) ? 9u : \
+                                      ('O' == RTC_COMPILE_DATE[0]) ? 10u : \
+                                      ('N' == RTC_COMPILE_DATE[0]) ? 11u : 12u)
+#define RTC_COMPILE_DAY     (uint8_t)(((' ' == RTC_COMPILE_DATE[4]) ? 0u : RTC_DIGIT(RTC_COMPILE_DATE, 4) * 10u) + RTC_DIGIT(RTC_COMPILE_DATE, 5))
+#define RTC_COMPILE_HOUR    (uint8_t)(RTC_DIGIT(RTC_COMPILE_TIME, 0) * 10u + RTC_DIGIT(RTC_COMPILE_TIME, 1))
+#define RTC_COMPILE_MINUTE  (uint8_t)(RTC_DIGIT(RTC_COMPILE_TIME, 3) * 10u + RTC_DIGIT(RTC_COMPILE_TIME, 4))
+#define RTC_COMPILE_SECOND  (uint8_t)(RTC_DIGIT(RTC_COMPILE_TIME, 6) * 10u + RTC_DIGIT(RTC_COMPILE_TIME, 7))
+
 /* Macro for RTC I2C address */
-#define RTC_I2C_ADDR        (0x68)
+#define RTC_I2C_ADDR        (uint8_t)(0x68u)
+
+/* DS3231 registers, the time registers (seconds..year) are consecutive */
+#define RTC_REG_TIME        (uint8_t)(0x00u)
+#define RTC_REG_CONTROL     (uint8_t)(0x0Eu)
+#define RTC_REG_STATUS      (uint8_t)(0x0Fu)
+#define RTC_TIME_SIZE       (uint8_t)(7u)
+
+/* Control register value: oscillator on, square wave output instead of the alarm interrupt, 1 Hz */
+#define RTC_CONTROL_SQW_1HZ (uint8_t)(0x00u)
+
+/**
+ * SQW output of the DS3231 (open drain, internal pull-up is used) is connected to INT1.
+ * Every falling edge advances the epoch by one second, the time registers are read over I2C
+ * only every RTC_RESYNC_PERIOD_MS to correct the epoch.
+ */
+#define RTC_INT1_PIN        (uint8_t)(3u)
+#define RTC_SQW_PIN         (uint8_t)(3u)
+
+/* Period of the resynchronization of the epoch with the time registers */
+#define RTC_RESYNC_PERIOD_MS (uint32_t)(600000u)
+
+/* Epoch counts seconds since 2000-01-01 00:00:00, the first year of the year register */
+#define RTC_EPOCH_INVALID   (uint32_t)(0u)
+#define RTC_SECONDS_PER_MINUTE (uint32_t)(60u)
+#define RTC_SECONDS_PER_HOUR (uint32_t)(3600u)
+#define RTC_SECONDS_PER_DAY (uint32_t)(86400u)
+#define RTC_DAYS_PER_YEAR   (uint16_t)(365u)
+#define RTC_DAYS_PER_LEAP_YEAR (uint16_t)(366u)
+/* Every fourth year is a leap year in the range of the year register (2000..2099) */
+#define RTC_IS_LEAP_YEAR(year) (0u == ((year) % 4u))
+#define RTC_DAYS_IN_YEAR(year) (RTC_IS_LEAP_YEAR(year) ? RTC_DAYS_PER_LEAP_YEAR : RTC_DAYS_PER_YEAR)
+#define RTC_FEBRUARY        (uint8_t)(2u)
+
+/* Milliseconds per second, used while the epoch advances without SQW edges */
+#define RTC_MS_PER_SECOND   (uint32_t)(1000u)
+
+/* Flags returned by rtc_getNextTick() */
+#define RTC_TICK_KNOWN      (bool)(true)
+#define RTC_TICK_UNKNOWN    (bool)(false)
+
+/* Flags indicating if the next SQW tick wakes the MCU from a sleep mode */
+#define RTC_TICK_WAKE_UP_ARMED     (bool)(true)
+#define RTC_TICK_WAKE_UP_NOT_ARMED (bool)(false)
+
+/* Flags of a queued tick, millis() stands still while the MCU sleeps in power-save */
+#define RTC_TICK_MILLIS_STOPPED (bool)(true)
+#define RTC_TICK_MILLIS_RUNNING (bool)(false)
+
+/* Ticks queued by the SQW interrupt and not applied to the epoch yet (power of two), applied at every read of the epoch */
+#define RTC_TICK_QUEUE_SIZE (uint8_t)(4u)
+
+/* Flags returned by rtc_finishTickWakeUp() */
+#define RTC_WOKEN_BY_TICK   (bool)(true)
+#define RTC_NOT_WOKEN_BY_TICK (bool)(false)
+
+/* Oscillator stop flag in the status register, set after a power loss */
+#define RTC_STATUS_OSF      (uint8_t)(0x80u)
+
+/* Masks of the BCD fields in the time registers (control bits removed) */
+#define RTC_SECONDS_MASK    (uint8_t)(0x7Fu)
+#define RTC_MINUTES_MASK    (uint8_t)(0x7Fu)
+#define RTC_HOURS_MASK      (uint8_t)(0x3Fu) /* 24 hour mode */
+#define RTC_DAY_MASK        (uint8_t)(0x3Fu)
+#define RTC_MONTH_MASK      (uint8_t)(0x1Fu)
+
+/* Day of the week written when the time is set, the station does not use it */
+#define RTC_DEFAULT_WEEKDAY (uint8_t)(1u)
+/* The year register holds only the years of the century */
+#define RTC_YEAR_BASE       (uint16_t)(2000u)
+
+/* Macros that convert between binary and BCD values */
+#define RTC_BCD_TO_BIN(value) (uint8_t)((((value) >> 4) * 10u) + ((value) & 0x0Fu))
+#define RTC_BIN_TO_BCD(value) (uint8_t)((((value) / 10u) << 4) | ((value) % 10u))
+
+/* Flags indicating if the latest time read from the RTC is valid */
+#define RTC_TIME_VALID      (bool)(true)
+#define RTC_TIME_INVALID    (bool)(false)
+
+/* Flags indicating if the RTC is initialized and refreshed in the background */
+#define RTC_READY           (bool)(true)
+#define RTC_NOT_READY       (bool)(false)
 
 /* Default RTC identifier */
 #define RTC_DEFAULT_RTC     (uint8_t)(0u)
@@ -42,6 +142,20 @@
 #define RTC_MIN_SECOND      (uint8_t)(0u)
 #define RTC_MAX_SECOND      (uint8_t)(59u)
 
+/**
+ * @brief Structure describing one falling edge of SQW, queued by the INT1 interrupt.
+ *
+ * Members:
+ *  - tick_millis: millis() at the edge, not used if millis_stopped is set.
+ *  - millis_stopped: RTC_TICK_MILLIS_STOPPED if the edge woke the MCU from power-save, the edge is
+ *    one second after the previous one then.
+ */
+typedef struct
+{
+  uint32_t tick_millis;
+  bool millis_stopped;
+} rtc_sqw_tick_ts;
+
 /**
  * @brief Initializes the Real-Time Clock (RTC) module.
  *
@@ -57,15 +171,68 @@ control_error_code_te rtc_init();
 /**
  * @brief Retrieves the current date and time from the RTC module.
  *
- * This function reads the current time from the RTC module and performs basic validation 
- * to ensure the values fall within expected ranges. If the RTC is found and the values 
- * are valid, the function returns a structure containing the timestamp. Otherwise, 
- * it returns an error code indicating that the RTC was not found.
+ * This function converts the epoch advanced by the SQW interrupt to the date and time (the I2C bus
+ * is not accessed). The time registers are validated when they are read by rtc_service(), if the
+ * RTC is found and the epoch is synchronized, the function writes the time into the caller owned reading.
+ * Otherwise, it returns an error code indicating that the RTC was not found.
  *
  * @param[in] id Identifier for the RTC module. Should be `RTC_DEFAULT_RTC` for the default module.
- * @return `rtc_return_ts` structure containing the current date and time if valid, 
- *         or an error code if the RTC is not found or the values are out of range.
+ * @param[out] reading Pointer to the caller owned reading which receives the date and time.
+ * @return `ERROR_CODE_NO_ERROR` if the date and time are valid, or `ERROR_CODE_RTC_NOT_FOUND`
+ *         if the RTC is not found or the values are out of range.
+ */
+control_error_code_te rtc_getTime(uint8_t id, rtc_reading_ts *reading);
+
+/**
+ * @brief Returns the current epoch of the RTC.
+ *
+ * Applies the SQW ticks queued by the interrupt, no bus access. Until the first SQW edge after
+ * a synchronization (or if SQW is not connected) the epoch is advanced with millis() instead.
+ *
+ * @return uint32_t Seconds since 2000-01-01 00:00:00 or RTC_EPOCH_INVALID if the RTC was not synchronized yet.
+ */
+uint32_t rtc_getEpoch();
+
+/**
+ * @brief Resynchronizes the epoch with the time registers in the background.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Every RTC_RESYNC_PERIOD_MS (every call while the epoch is
+ * invalid) the time registers are read with an I2C job, validated and taken over as the epoch,
+ * so rtc_getTime() and rtc_getEpoch() never wait for the bus.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void rtc_service(uint32_t current_millis);
+
+/**
+ * @brief Returns the time of the next SQW tick.
+ *
+ * The tick is known only while SQW runs, the previous edge must have come within the last second.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @param tick_millis Receives millis() of the next falling edge of SQW, only written if the tick is known.
+ * @return true (RTC_TICK_KNOWN) if SQW runs, false otherwise.
+ */
+bool rtc_getNextTick(uint32_t current_millis, uint32_t *tick_millis);
+
+/**
+ * @brief Switches INT1 to the low level, so the next SQW tick wakes the MCU from power-save.
+ *
+ * Edges of INT1 wake the MCU only from the idle mode. The level is armed only while SQW is high,
+ * a low SQW (first half of the second) would wake the MCU at once. The interrupt of the tick
+ * switches back to the falling edge and queues the tick as one second after the previous one, since
+ * millis() stands still during the sleep.
+ *
+ * @return true (RTC_TICK_WAKE_UP_ARMED) if the wake-up is armed, false if SQW is low.
+ */
+bool rtc_armTickWakeUp();
+
+/**
+ * @brief Ends the sleep armed by rtc_armTickWakeUp(), switches back to the falling edge if the tick did not come.
+ *
+ * @param tick_millis Receives millis() of the tick which woke the MCU, only written if it was the tick.
+ * @return true (RTC_WOKEN_BY_TICK) if the tick woke the MCU, false if another interrupt did.
  */
-rtc_return_ts rtc_getTime(uint8_t id);
+bool rtc_finishTickWakeUp(uint32_t *tick_millis);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "adc_sampling.h"
+
+/* STATIC GLOBAL VARIABLES */
+static adc_sampling_channel_ts channels[ADC_SAMPLING_MAX_CHANNELS];
+static uint8_t num_of_channels = 0u;
+
+// Conversion request queue - written by the service, consumed by the ADC interrupt
+static spsc_ring_ts<uint8_t, ADC_SAMPLING_QUEUE_SIZE> queue;
+
+// Sample ring buffer - written by the ADC interrupt, drained by the service
+static spsc_ring_ts<uint16_t, ADC_SAMPLING_RING_SIZE> ring;
+
+// State of the burst which is currently executed by the ADC interrupt
+static volatile uint8_t burst_channel = 0u;
+static volatile uint8_t burst_samples_left = 0u;
+static volatile bool discard_sample = ADC_SAMPLING_KEEP_SAMPLE;
+static volatile bool adc_busy = ADC_SAMPLING_ADC_IDLE;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(ADC_SAMPLING_EXTRA_BITS <= 2u, "More than 2 extra bits need 64 samples per channel and the ring buffer would not fit into RAM");
+static_assert(ADC_SAMPLING_QUEUE_SIZE >= ADC_SAMPLING_MAX_CHANNELS, "Queue must hold a request for every channel");
+static_assert(ADC_SAMPLING_MAX_CHANNELS <= (1u << (16u - ADC_SAMPLING_ENTRY_CHANNEL_SHIFT)), "Channel index must fit into a ring entry");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Queues one burst of conversions for every registered channel and starts the ADC.
+ */
+static void queueAllChannels();
+
+/**
+ * @brief Switches the ADC multiplexer to the channel of the next burst.
+ *
+ * Called from the interrupt (and once when starting), so it must stay short.
+ *
+ * @param channel Index of the registered channel.
+ */
+static void selectChannel(uint8_t channel);
+
+/**
+ * @brief Decimates the oldest burst in the ring buffer, the burst stays in the ring.
+ *
+ * @param decimation_mode ADC_SAMPLING_DECIMATION_AVERAGE or ADC_SAMPLING_DECIMATION_MEDIAN.
+ * @return uint16_t ADC code with ADC_SAMPLING_EXTRA_BITS fractional bits.
+ */
+static uint16_t decimateBurst(uint8_t decimation_mode);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+uint8_t adc_sampling_addChannel(uint8_t analog_pin, uint8_t decimation_mode)
+{
+  if(ADC_SAMPLING_MAX_CHANNELS <= num_of_channels)
+  {
+    return ADC_SAMPLING_INVALID_CHANNEL;
+  }
+
+  uint8_t channel = num_of_channels;
+  channels[channel].latest_result = ADC_SAMPLING_NO_RESULT;
+  channels[channel].adc_channel = (analog_pin >= A0) ? (uint8_t)(analog_pin - A0) : analog_pin; // Accept both A0 and 0
+  channels[channel].decimation_mode = decimation_mode;
+  num_of_channels++;
+
+  // Digital input buffer of an analog pin only draws current, ADC6 and ADC7 have none
+  if(ADC_SAMPLING_NUM_OF_DIGITAL_INPUTS > channels[channel].adc_channel)
+  {
+    DIDR0 |= (uint8_t)_BV(channels[channel].adc_channel);
+  }
+
+  return channel;
+}
+
+uint16_t adc_sampling_getLatest(uint8_t channel)
+{
+  if(num_of_channels <= channel)
+  {
+    return ADC_SAMPLING_NO_RESULT;
+  }
+  return channels[channel].latest_result; // Written only outside of the interrupt
+}
+
+void adc_sampling_service()
+{
+  if(0u == num_of_channels)
+  {
+    return;
+  }
+
+  // Drain every complete burst, samples of one burst are always contiguous in the ring
+  while(spsc_ring_getCount(&ring) >= ADC_SAMPLING_OVERSAMPLE_COUNT)
+  {
+    uint8_t channel = ADC_SAMPLING_ENTRY_CHANNEL(*spsc_ring_peek(&ring, 0u));
+    channels[channel].latest_result = decimateBurst(channels[channel].decimation_mode);
+    spsc_ring_drop(&ring, ADC_SAMPLING_OVERSAMPLE_COUNT);
+  }
+
+  // Start the next round only when the previous one is finished and drained
+  if(ADC_SAMPLING_ADC_IDLE == adc_busy && spsc_ring_isEmpty(&ring))
+  {
+    queueAllChannels();
+  }
+}
+
+bool adc_sampling_isIdle()
+{
+  return ADC_SAMPLING_ADC_IDLE == adc_busy;
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(ADC_vect)
+{
+  uint16_t sample = ADC;
+
+  // This conversion was already running when the channel was switched
+  if(ADC_SAMPLING_DISCARD_SAMPLE == discard_sample)
+  {
+    discard_sample = ADC_SAMPLING_KEEP_SAMPLE;
+    return;
+  }
+
+  uint16_t entry = ADC_SAMPLING_MAKE_ENTRY(burst_channel, sample);
+  (void)spsc_ring_push(&ring, &entry); // Ring holds a whole round, a round is only queued when the ring is drained
+  burst_samples_left--;
+
+  if(0u == burst_samples_left)
+  {
+    uint8_t channel;
+    if(SPSC_RING_POPPED == spsc_ring_pop(&queue, &channel))
+    {
+      // Continue with the next queued burst without leaving the free running mode
+      selectChannel(channel);
+      discard_sample = ADC_SAMPLING_DISCARD_SAMPLE;
+    }
+    else
+    {
+      // Queue is empty, stop free running and switch the ADC off until the next round
+      ADCSRA &= (uint8_t)~(_BV(ADEN) | _BV(ADATE) | _BV(ADIE));
+      adc_busy = ADC_SAMPLING_ADC_IDLE;
+    }
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void queueAllChannels()
+{
+  // ADC is idle, the interrupt does not access the queue now
+  for (uint8_t channel = 1u; channel < num_of_channels; channel++)
+  {
+    (void)spsc_ring_push(&queue, &channel); // Queue holds a request for every channel
+  }
+
+  selectChannel(0u);
+  discard_sample = ADC_SAMPLING_KEEP_SAMPLE; // First conversion already uses the new channel
+  adc_busy = ADC_SAMPLING_ADC_BUSY;
+
+  ADCSRB = 0u; // Free running trigger source
+  // Enable, clear a pending flag from the previous round, free running with interrupt and start
+  ADCSRA = _BV(ADEN) | _BV(ADIF) | _BV(ADATE) | _BV(ADIE) | _BV(ADSC) | ADC_SAMPLING_ADCSRA_PRESCALER;
+}
+
+static void selectChannel(uint8_t channel)
+{
+  burst_channel = channel;
+  burst_samples_left = ADC_SAMPLING_OVERSAMPLE_COUNT;
+  ADMUX = ADC_SAMPLING_ADMUX_REFERENCE | (channels[channel].adc_channel & ADC_SAMPLING_ADMUX_CHANNEL_MASK);
+}
+
+static uint16_t decimateBurst(uint8_t decimation_mode)
+{
+  if(ADC_SAMPLING_DECIMATION_MEDIAN == decimation_mode)
+  {
+    uint16_t sorted[ADC_SAMPLING_OVERSAMPLE_COUNT];
+    // Insertion sort, small fixed number of samples
+    for (uint8_t i = 0u; i < ADC_SAMPLING_OVERSAMPLE_COUNT; i++)
+    {
+      uint16_t sample = ADC_SAMPLING_ENTRY_VALUE(*spsc_ring_peek(&ring, i));
+      uint8_t j = i;
+      while(j > 0u && sorted[j - 1u] > sample)
+      {
+        sorted[j] = sorted[j - 1u];
+        j--;
+      }
+      sorted[j] = sample;
+    }
+    return (uint16_t)(sorted[ADC_SAMPLING_OVERSAMPLE_COUNT / 2u] << ADC_SAMPLING_EXTRA_BITS);
+  }
+
+  // Sum of 4^n samples decimated by 2^n gives n extra bits
+  uint32_t sum = 0u;
+  for (uint8_t i = 0u; i < ADC_SAMPLING_OVERSAMPLE_COUNT; i++)
+  {
+    sum += ADC_SAMPLING_ENTRY_VALUE(*spsc_ring_peek(&ring, i));
+  }
+  return (uint16_t)(sum >> ADC_SAMPLING_EXTRA_BITS);
+}
+/* *************************************** */
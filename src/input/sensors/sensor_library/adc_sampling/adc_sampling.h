@@ -0,0 +1,130 @@
+#ifndef ADC_SAMPLING_H
+#define ADC_SAMPLING_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../sensors_config.h"
+#include "../../../../spsc_ring/spsc_ring.h"
+
+/**
+ * @file adc_sampling.h
+ * @brief Shared oversampling and decimation engine for the analog sensors.
+ *
+ * Analog sensors register their pin once and afterwards only read the latest result.
+ * adc_sampling_service() (called from the sensors loop) queues a burst of conversions for every
+ * registered channel. The ADC runs in free running mode and the conversion complete interrupt executes
+ * the queued bursts back to back, switching channels by itself, and pushes every sample into a lock-free ring buffer (see spsc_ring.h).
+ * The service later drains finished bursts from the ring and decimates them, so neither the main loop
+ * nor a sensor reading ever waits for the ADC.
+ */
+
+/* Maximum number of analog channels which can be registered (MQ135, MQ7, GY-ML8511, rain sensor) */
+#define ADC_SAMPLING_MAX_CHANNELS          (uint8_t)(4u)
+
+/* Resolution of a single ADC conversion */
+#define ADC_SAMPLING_ADC_MAX               (uint16_t)(1023u)
+
+/* Number of samples per result, 4^n samples are needed for n extra bits of resolution */
+#define ADC_SAMPLING_EXTRA_BITS            (uint8_t)(SENSORS_ADC_OVERSAMPLING_EXTRA_BITS)
+#define ADC_SAMPLING_OVERSAMPLE_COUNT      (uint8_t)(1u << (2u * ADC_SAMPLING_EXTRA_BITS))
+
+/* Maximum value of a decimated result, results are ADC codes with ADC_SAMPLING_EXTRA_BITS fractional bits */
+#define ADC_SAMPLING_RESULT_MAX            (uint16_t)(ADC_SAMPLING_ADC_MAX << ADC_SAMPLING_EXTRA_BITS)
+
+/* Returned until the first result of a channel is available or for invalid channels */
+#define ADC_SAMPLING_NO_RESULT             (uint16_t)(0xFFFFu)
+
+/* Returned by adc_sampling_addChannel when no more channels can be registered */
+#define ADC_SAMPLING_INVALID_CHANNEL       (uint8_t)(0xFFu)
+
+/* Decimation modes */
+/* Average of all samples, gives ADC_SAMPLING_EXTRA_BITS extra bits for signals with some noise */
+#define ADC_SAMPLING_DECIMATION_AVERAGE    (uint8_t)(0u)
+/* Median of all samples, rejects spikes, resolution stays the same (result is only scaled) */
+#define ADC_SAMPLING_DECIMATION_MEDIAN     (uint8_t)(1u)
+
+/* Size of the conversion request queue (power of two), one burst request per channel */
+#define ADC_SAMPLING_QUEUE_SIZE            (uint8_t)(4u)
+
+/* Size of the sample ring buffer (power of two), holds one burst of every channel */
+#define ADC_SAMPLING_RING_SIZE             (uint8_t)(ADC_SAMPLING_MAX_CHANNELS * ADC_SAMPLING_OVERSAMPLE_COUNT)
+
+/* Ring entries hold the channel index in the upper bits and the 10-bit conversion in the lower bits */
+#define ADC_SAMPLING_ENTRY_CHANNEL_SHIFT   (uint8_t)(12u)
+#define ADC_SAMPLING_ENTRY_VALUE_MASK      (uint16_t)(0x03FFu)
+#define ADC_SAMPLING_MAKE_ENTRY(channel, value) (uint16_t)(((uint16_t)(channel) << ADC_SAMPLING_ENTRY_CHANNEL_SHIFT) | ((value) & ADC_SAMPLING_ENTRY_VALUE_MASK))
+#define ADC_SAMPLING_ENTRY_CHANNEL(entry)  (uint8_t)((entry) >> ADC_SAMPLING_ENTRY_CHANNEL_SHIFT)
+#define ADC_SAMPLING_ENTRY_VALUE(entry)    (uint16_t)((entry) & ADC_SAMPLING_ENTRY_VALUE_MASK)
+
+/* ADC register settings - AVCC reference and prescaler 128 (125 kHz ADC clock at 16 MHz) same as analogRead() */
+#define ADC_SAMPLING_ADMUX_REFERENCE       (uint8_t)(_BV(REFS0))
+#define ADC_SAMPLING_ADMUX_CHANNEL_MASK    (uint8_t)(0x0Fu)
+/* ADC0..ADC5 have a digital input buffer which is disabled in DIDR0 */
+#define ADC_SAMPLING_NUM_OF_DIGITAL_INPUTS (uint8_t)(6u)
+#define ADC_SAMPLING_ADCSRA_PRESCALER      (uint8_t)(_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0))
+
+/* Flags indicating if the ADC is executing queued bursts, shared with the interrupt */
+#define ADC_SAMPLING_ADC_BUSY          (bool)(true)
+#define ADC_SAMPLING_ADC_IDLE          (bool)(false)
+
+/* Flags for discarding the conversion which was already started when the channel is switched */
+#define ADC_SAMPLING_DISCARD_SAMPLE    (bool)(true)
+#define ADC_SAMPLING_KEEP_SAMPLE       (bool)(false)
+
+/**
+ * @brief Structure describing a registered analog channel.
+ *
+ * Members:
+ *  - latest_result: Latest decimated result or ADC_SAMPLING_NO_RESULT.
+ *  - adc_channel: ADC multiplexer channel of the pin.
+ *  - decimation_mode: Decimation used for the channel (ADC_SAMPLING_DECIMATION_*).
+ */
+typedef struct
+{
+  uint16_t latest_result;
+  uint8_t adc_channel;
+  uint8_t decimation_mode;
+} adc_sampling_channel_ts;
+
+/* Macro that converts a decimated result to ADC counts (0..ADC_SAMPLING_ADC_MAX) keeping the fractional part */
+#define ADC_SAMPLING_TO_COUNTS(result)     ((float)(result) / (float)(1u << ADC_SAMPLING_EXTRA_BITS))
+
+/**
+ * @brief Registers an analog pin for background oversampling.
+ *
+ * Must be called from the init function of the sensor. Sampling of the channel runs
+ * continuously afterwards.
+ *
+ * @param analog_pin Arduino analog pin (A0, A1, ...).
+ * @param decimation_mode ADC_SAMPLING_DECIMATION_AVERAGE or ADC_SAMPLING_DECIMATION_MEDIAN.
+ * @return uint8_t Channel handle used for reading results or ADC_SAMPLING_INVALID_CHANNEL if all channels are taken.
+ */
+uint8_t adc_sampling_addChannel(uint8_t analog_pin, uint8_t decimation_mode);
+
+/**
+ * @brief Returns the latest decimated result of a channel without waiting.
+ *
+ * @param channel Channel handle returned by adc_sampling_addChannel.
+ * @return uint16_t ADC code with ADC_SAMPLING_EXTRA_BITS fractional bits (0..ADC_SAMPLING_RESULT_MAX)
+ *         or ADC_SAMPLING_NO_RESULT if there is no result yet.
+ */
+uint16_t adc_sampling_getLatest(uint8_t channel);
+
+/**
+ * @brief Decimates finished bursts from the ring buffer and queues the next round of conversions.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Samples themselves are collected from the ADC interrupt,
+ * this function only does the decimation outside of the interrupt. A new round is queued
+ * only when the previous one is drained, so the ring buffer can not overflow.
+ */
+void adc_sampling_service();
+
+/**
+ * @brief Checks if no conversion is running, the ADC is then switched off until the next round.
+ *
+ * @return true if the ADC is idle, false while a round of conversions is running.
+ */
+bool adc_sampling_isIdle();
+
+#endif
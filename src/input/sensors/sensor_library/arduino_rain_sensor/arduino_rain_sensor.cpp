@@ -1,13 +1,36 @@
 #include "arduino_rain_sensor.h"
 
+/* STATIC GLOBAL VARIABLES */
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+// Times of the edges queued by the PCINT2 interrupt and the debounced state taken by the service
+static spsc_ring_ts<uint32_t, ARDUINO_RAIN_SENSOR_EDGE_QUEUE_SIZE> edges;
+static uint32_t last_edge = 0u;
+static bool settling = false;
+static bool raining = false;
+#elif defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT)
+static uint8_t adc_channel = ADC_SAMPLING_INVALID_CHANNEL;
+#endif
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+static_assert(ARDUINO_RAIN_SENSOR_PCINT_PIN == SENSORS_ARDUINO_RAIN_PIN_DIGITAL,
+              "Digital output of the rain sensor must be connected to PCINT20 (pin 4) in interrupt mode");
+#ifdef ARDUINO_ARCH_ESP32
+static_assert(false, "SENSORS_ARDUINO_RAIN_INTERRUPT uses the pin change interrupt of the AVR, disable it on the ESP32");
+#endif
+#endif
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
-#ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+#if defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT) && !defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
 /**
  * @brief Checks rain status using an analog rain sensor pin.
  * @return true if the analog reading is below the threshold, false otherwise.
  */
 static bool arduino_rain_sensor_isRainingAnalog();
-#else
+#endif
+#if !defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT) || defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
 /**
  * @brief Checks rain status using a digital rain sensor pin.
  * @return true if rain is detected (LOW signal), false otherwise (HIGH signal).
@@ -19,9 +42,22 @@ static bool arduino_rain_sensor_isRainingDigital();
 /* EXPORTED FUNCTIONS */
 void arduino_rain_sensor_init()
 {
-#ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+  pinMode(SENSORS_ARDUINO_RAIN_PIN_DIGITAL, INPUT);
+  raining = arduino_rain_sensor_isRainingDigital(); // Level at start, only the changes are interrupts
+  settling = false;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    spsc_ring_clear(&edges);
+    PCMSK2 |= _BV(PCINT20);
+    PCIFR = _BV(PCIF2);
+    PCICR |= _BV(PCIE2);
+  }
+#elif defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT)
   // Configure the pin for analog input if analog measurement is enabled
   pinMode(SENSORS_ARDUINO_RAIN_PIN_ANALOG, INPUT);
+  adc_channel = adc_sampling_addChannel(SENSORS_ARDUINO_RAIN_PIN_ANALOG, SENSORS_ARDUINO_RAIN_ADC_DECIMATION);
 #else
   // Configure the pin for digital input if digital measurement is enabled
   pinMode(SENSORS_ARDUINO_RAIN_PIN_DIGITAL, INPUT);
@@ -30,7 +66,10 @@ void arduino_rain_sensor_init()
 
 bool arduino_rain_sensor_readRaining()
 {
-#ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+  // State of the last change, the output is not read while it bounces
+  return raining;
+#elif defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT)
   // Call analog-specific rain detection function
   return arduino_rain_sensor_isRainingAnalog();
 #else
@@ -38,15 +77,69 @@ bool arduino_rain_sensor_readRaining()
   return arduino_rain_sensor_isRainingDigital();
 #endif
 }
+
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+uint8_t arduino_rain_sensor_service(uint32_t current_millis, uint32_t *settle_deadline)
+{
+  uint32_t edge;
+  while(SPSC_RING_POPPED == spsc_ring_pop(&edges, &edge))
+  {
+    last_edge = edge;
+    settling = true;
+  }
+
+  if(!settling)
+  {
+    if(arduino_rain_sensor_isRainingDigital() == raining)
+    {
+      return ARDUINO_RAIN_SENSOR_STABLE;
+    }
+    // Edges were dropped by a full ring, the new level is debounced from now
+    last_edge = current_millis;
+    settling = true;
+  }
+  if((current_millis - last_edge) < SENSORS_ARDUINO_RAIN_DEBOUNCE_MS)
+  {
+    *settle_deadline = last_edge + SENSORS_ARDUINO_RAIN_DEBOUNCE_MS;
+    return ARDUINO_RAIN_SENSOR_SETTLING;
+  }
+
+  // Output is stable, a bounce back to the previous level is no change
+  settling = false;
+  bool raining_now = arduino_rain_sensor_isRainingDigital();
+  if(raining_now == raining)
+  {
+    return ARDUINO_RAIN_SENSOR_STABLE;
+  }
+  raining = raining_now;
+  return ARDUINO_RAIN_SENSOR_CHANGED;
+}
+
+bool arduino_rain_sensor_isEdgePending()
+{
+  return !spsc_ring_isEmpty(&edges);
+}
+#endif
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+ISR(PCINT2_vect)
+{
+  // Only PCINT20 is enabled on port D, every interrupt is an edge of the digital output
+  uint32_t edge = millis();
+  (void)spsc_ring_push(&edges, &edge);
+}
+#endif
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
-#ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+#if defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT) && !defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
 static bool arduino_rain_sensor_isRainingAnalog()
 {
-  int analog_reading = analogRead(SENSORS_ARDUINO_RAIN_PIN_ANALOG);
-  // Return true if the reading is below or equal to the defined threshold
-  if(ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD >= analog_reading)
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel); // Latest median filtered value, no waiting for the ADC
+  // Return true if the reading is below or equal to the defined threshold (no rain until the first result)
+  if(ADC_SAMPLING_NO_RESULT != adc_result && ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD >= ADC_SAMPLING_TO_COUNTS(adc_result))
   {
     return true;
   }
@@ -57,10 +150,10 @@ static bool arduino_rain_sensor_isRainingAnalog()
 }
 #endif
 
-#ifndef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+#if !defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT) || defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
 static bool arduino_rain_sensor_isRainingDigital()
 {
-  int rain_detected = digitalRead(RAINSENSOR_PIN_DIGITAL);
+  int rain_detected = digitalRead(SENSORS_ARDUINO_RAIN_PIN_DIGITAL);
 
   // Return true if LOW (rain detected), false otherwise
   if(ARDUINO_RAIN_SENSOR_RAIN_DETECTED == rain_detected)
@@ -3,6 +3,13 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../adc_sampling/adc_sampling.h"
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "../../../../spsc_ring/spsc_ring.h"
+#endif
 
 /* Define the digital output value indicating rain detected by the sensor, used in digital read mode */
 /* NOTE: The sensor uses reverse logic — 0 means rain is detected, and 1 means no rain */
@@ -11,6 +18,20 @@
 /* Define the threshold value for analog readings; values below this indicate rain */
 #define ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD (int)(500u)
 
+/**
+ * Interrupt mode (SENSORS_ARDUINO_RAIN_INTERRUPT): the digital output is connected to PCINT20 (pin 4), the ISR queues
+ * the time of every edge. The service takes the level once no edge came for SENSORS_ARDUINO_RAIN_DEBOUNCE_MS,
+ * so a change of rain is known within the debounce time instead of the sample period.
+ */
+#define ARDUINO_RAIN_SENSOR_PCINT_PIN        (uint8_t)(4u)
+/* Edges queued by the ISR and not taken yet (power of two), a full ring drops the latest edges of a bouncing output */
+#define ARDUINO_RAIN_SENSOR_EDGE_QUEUE_SIZE  (uint8_t)(8u)
+
+/* Results of the service in interrupt mode */
+#define ARDUINO_RAIN_SENSOR_STABLE           (uint8_t)(0u) /* No edge since the last change */
+#define ARDUINO_RAIN_SENSOR_SETTLING         (uint8_t)(1u) /* Output had an edge and is not stable for the debounce time yet */
+#define ARDUINO_RAIN_SENSOR_CHANGED          (uint8_t)(2u) /* Rain started or stopped, the new state is returned by arduino_rain_sensor_readRaining() */
+
 /**
  * @brief Initializes the rain sensor.
  * Depending on the configuration, sets the pin mode for analog or digital input.
@@ -24,4 +45,22 @@ void arduino_rain_sensor_init();
  */
 bool arduino_rain_sensor_readRaining();
 
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+/**
+ * @brief Takes the edges queued by the ISR and the debounced state of the digital output, interrupt mode only.
+ *
+ * @param current_millis The current time in milliseconds.
+ * @param settle_deadline Receives the time at which the settling output is stable, only written for ARDUINO_RAIN_SENSOR_SETTLING.
+ * @return uint8_t ARDUINO_RAIN_SENSOR_STABLE, ARDUINO_RAIN_SENSOR_SETTLING or ARDUINO_RAIN_SENSOR_CHANGED.
+ */
+uint8_t arduino_rain_sensor_service(uint32_t current_millis, uint32_t *settle_deadline);
+
+/**
+ * @brief Checks if the ISR queued an edge which the service did not take yet, interrupt mode only.
+ *
+ * @return true if the service should run.
+ */
+bool arduino_rain_sensor_isEdgePending();
+#endif
+
 #endif
\ No newline at end of file
@@ -1,21 +1,206 @@
 #include "bh1750.h"
 
 /* STATIC GLOBAL VARIABLES */
-static BH1750 lightMeter;
+static float latest_light_level = NAN;
+static bool latest_valid = BH1750_DATA_INVALID;
+static bool sensor_ready = BH1750_SENSOR_NOT_READY;
+static uint8_t state = BH1750_STATE_SLEEPING;
+static uint8_t mtreg = BH1750_MTREG_DEFAULT;            // MTreg of the next measurement, set by the auto-range
+static uint8_t measurement_mtreg = BH1750_MTREG_DEFAULT; // MTreg of the running measurement
+static uint32_t measurement_start = 0u;
+static uint32_t next_measurement = 0u;
+
+// Background instructions of one measurement, queued back to back, and read of the result
+static uint8_t instructions[] = {BH1750_MTREG_HIGH_INSTRUCTION(BH1750_MTREG_DEFAULT),
+                                 BH1750_MTREG_LOW_INSTRUCTION(BH1750_MTREG_DEFAULT),
+                                 BH1750_ONE_TIME_HIGH_RES_MODE};
+static i2c_bus_job_ts instruction_jobs[sizeof(instructions)];
+static uint8_t submitted_instructions = 0u;
+static i2c_bus_job_ts data_job;
+static uint8_t data_buffer[BH1750_DATA_SIZE];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(BH1750_MEASUREMENT_TIME_MS(BH1750_MTREG_MAX) < SENSORS_BH1750_CONVERSION_PERIOD_MS, "BH1750 conversion period must be longer than the longest measurement");
+static_assert(SENSORS_BH1750_CONVERSION_PERIOD_MS <= SENSORS_BH1750_LUMINANCE_SAMPLE_PERIOD_MS, "Every BH1750 sample must see a new measurement");
+static_assert(sizeof(instructions) < I2C_BUS_QUEUE_SIZE, "Instructions of a measurement must fit the I2C bus queue");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Sends one instruction to the sensor and waits for the transfer.
+ *
+ * @param instruction Instruction code (BH1750_* instructions).
+ * @return true if the sensor acknowledged the instruction, false otherwise.
+ */
+static bool writeInstruction(uint8_t instruction);
+
+/**
+ * @brief Chooses the MTreg of the next measurement from the result of the previous one.
+ *
+ * @param counts Result of the previous measurement.
+ * @param current_mtreg MTreg of the previous measurement.
+ * @return uint8_t MTreg which brings the result close to BH1750_AUTO_RANGE_TARGET_COUNTS.
+ */
+static uint8_t autoRange(uint16_t counts, uint8_t current_mtreg);
+
+/**
+ * @brief Checks if every submitted instruction of the measurement was acknowledged.
+ *
+ * @return uint8_t I2C_BUS_JOB_DONE if all are done, the pending or failed status of the first unfinished one otherwise.
+ */
+static uint8_t getInstructionsStatus();
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 bool bh1750_init()
 {
-  if(!lightMeter.begin())
+  if(!writeInstruction(BH1750_POWER_ON))
   {
     return false;
   }
+
+  for(uint8_t job = 0u; job < sizeof(instructions); job++)
+  {
+    i2c_bus_prepareJob(&instruction_jobs[job], BH1750_I2C_ADDR, &instructions[job], sizeof(instructions[job]), nullptr, 0u);
+  }
+  // The sensor sends the latest result without any register address
+  i2c_bus_prepareJob(&data_job, BH1750_I2C_ADDR, nullptr, 0u, data_buffer, sizeof(data_buffer));
+  latest_valid = BH1750_DATA_INVALID;
+  mtreg = BH1750_MTREG_DEFAULT;
+  state = BH1750_STATE_SLEEPING;
+  next_measurement = millis(); // First measurement runs while the rest of the station comes up
+  sensor_ready = BH1750_SENSOR_READY;
   return true;
 }
 
 float bh1750_readLightLevel()
 {
-  return lightMeter.readLightLevel();
+  return (BH1750_DATA_VALID == latest_valid) ? latest_light_level : NAN;
+}
+
+void bh1750_service(uint32_t current_millis)
+{
+  if(BH1750_SENSOR_READY != sensor_ready)
+  {
+    return;
+  }
+
+  switch(state)
+  {
+    case BH1750_STATE_SLEEPING:
+      if(0 <= (int32_t)(current_millis - next_measurement)) // Overflow safe deadline
+      {
+        measurement_mtreg = mtreg;
+        instructions[0] = BH1750_MTREG_HIGH_INSTRUCTION(measurement_mtreg);
+        instructions[1] = BH1750_MTREG_LOW_INSTRUCTION(measurement_mtreg);
+        // Jobs run in the order of submission, if the queue is full the whole measurement is retried
+        submitted_instructions = 0u;
+        while(submitted_instructions < sizeof(instructions) &&
+              I2C_BUS_JOB_ACCEPTED == i2c_bus_submit(&instruction_jobs[submitted_instructions]))
+        {
+          submitted_instructions++;
+        }
+        next_measurement = current_millis + SENSORS_BH1750_CONVERSION_PERIOD_MS;
+        state = BH1750_STATE_TRIGGERING;
+      }
+      break;
+
+    case BH1750_STATE_TRIGGERING:
+    {
+      uint8_t status = getInstructionsStatus();
+      if(I2C_BUS_IS_JOB_PENDING(status))
+      {
+        break; // Instructions are still on the bus
+      }
+      if(submitted_instructions < sizeof(instructions))
+      {
+        next_measurement = current_millis; // Queue was full, retry in the next pass
+        state = BH1750_STATE_SLEEPING;
+      }
+      else if(I2C_BUS_JOB_DONE == status)
+      {
+        measurement_start = current_millis;
+        state = BH1750_STATE_MEASURING;
+      }
+      else
+      {
+        latest_valid = BH1750_DATA_INVALID; // Sensor did not answer, do not report stale data
+        state = BH1750_STATE_SLEEPING;
+      }
+      break;
+    }
+
+    case BH1750_STATE_MEASURING:
+      if((current_millis - measurement_start) >= BH1750_MEASUREMENT_TIME_MS(measurement_mtreg) &&
+         I2C_BUS_JOB_ACCEPTED == i2c_bus_submit(&data_job))
+      {
+        state = BH1750_STATE_READING;
+      }
+      break;
+
+    case BH1750_STATE_READING:
+      if(I2C_BUS_JOB_DONE == data_job.status)
+      {
+        uint16_t counts = (uint16_t)((data_buffer[0] << 8) | data_buffer[1]);
+        // Sensitivity is proportional to MTreg, the default MTreg gives BH1750_COUNTS_PER_LUX
+        latest_light_level = ((float)counts / BH1750_COUNTS_PER_LUX) * ((float)BH1750_MTREG_DEFAULT / (float)measurement_mtreg);
+        latest_valid = BH1750_DATA_VALID;
+        mtreg = autoRange(counts, measurement_mtreg);
+        state = BH1750_STATE_SLEEPING;
+      }
+      else if(!I2C_BUS_IS_JOB_PENDING(data_job.status))
+      {
+        latest_valid = BH1750_DATA_INVALID;
+        state = BH1750_STATE_SLEEPING;
+      }
+      break;
+
+    default:
+      state = BH1750_STATE_SLEEPING;
+      break;
+  }
 }
-/* *************************************** */
\ No newline at end of file
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool writeInstruction(uint8_t instruction)
+{
+  i2c_bus_job_ts job;
+
+  i2c_bus_prepareJob(&job, BH1750_I2C_ADDR, &instruction, sizeof(instruction), nullptr, 0u);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+static uint8_t autoRange(uint16_t counts, uint8_t current_mtreg)
+{
+  if(counts >= BH1750_AUTO_RANGE_LOW_COUNTS && counts <= BH1750_AUTO_RANGE_HIGH_COUNTS)
+  {
+    return current_mtreg; // Result is well inside the range, keep the measurement time
+  }
+
+  // Counts are proportional to MTreg, dark results are clamped to one count
+  uint32_t scaled_mtreg = ((uint32_t)current_mtreg * BH1750_AUTO_RANGE_TARGET_COUNTS) / ((0u == counts) ? 1u : counts);
+  if(scaled_mtreg < BH1750_MTREG_MIN)
+  {
+    return BH1750_MTREG_MIN;
+  }
+  if(scaled_mtreg > BH1750_MTREG_MAX)
+  {
+    return BH1750_MTREG_MAX;
+  }
+  return (uint8_t)scaled_mtreg;
+}
+
+static uint8_t getInstructionsStatus()
+{
+  for(uint8_t job = 0u; job < submitted_instructions; job++)
+  {
+    if(I2C_BUS_JOB_DONE != instruction_jobs[job].status)
+    {
+      return instruction_jobs[job].status;
+    }
+  }
+  return I2C_BUS_JOB_DONE;
+}
+/* *************************************** */
@@ -2,15 +2,68 @@
 #define BH1750_H
 
 #include <Arduino.h>
-#include <BH1750.h>
 #include "../sensors_config.h"
+#include "../../../../i2c_bus/i2c_bus.h"
+
+/* I2C address of the sensor, ADDR pin is connected to GND */
+#define BH1750_I2C_ADDR                    (uint8_t)(SENSORS_BH1750_I2C_ADDDR_GND)
+
+/* Instructions of the sensor */
+#define BH1750_POWER_ON                    (uint8_t)(0x01u)
+#define BH1750_ONE_TIME_HIGH_RES_MODE      (uint8_t)(0x20u) /* 1 lx resolution at the default measurement time, powers down afterwards */
+#define BH1750_MTREG_HIGH_BITS             (uint8_t)(0x40u) /* Followed by bits 7..5 of MTreg */
+#define BH1750_MTREG_LOW_BITS              (uint8_t)(0x60u) /* Followed by bits 4..0 of MTreg */
+
+/* Macros that build the instructions which change the measurement time register */
+#define BH1750_MTREG_HIGH_INSTRUCTION(mtreg) (uint8_t)(BH1750_MTREG_HIGH_BITS | ((mtreg) >> 5))
+#define BH1750_MTREG_LOW_INSTRUCTION(mtreg)  (uint8_t)(BH1750_MTREG_LOW_BITS | ((mtreg) & 0x1Fu))
+
+/* Number of bytes of a measurement result (big endian) */
+#define BH1750_DATA_SIZE                   (uint8_t)(2u)
+
+/* Measurement time register (MTreg), the sensitivity and the measurement time are proportional to it */
+#define BH1750_MTREG_MIN                   (uint8_t)(31u)
+#define BH1750_MTREG_DEFAULT               (uint8_t)(69u)
+#define BH1750_MTREG_MAX                   (uint8_t)(254u)
+
+/* Maximum measurement time of the high resolution mode at the default MTreg */
+#define BH1750_MEASUREMENT_TIME_DEFAULT_MS (uint32_t)(180u)
+/* Macro that calculates the maximum measurement time for an MTreg value, rounded up */
+#define BH1750_MEASUREMENT_TIME_MS(mtreg)  (uint32_t)((BH1750_MEASUREMENT_TIME_DEFAULT_MS * (uint32_t)(mtreg) + BH1750_MTREG_DEFAULT - 1u) / BH1750_MTREG_DEFAULT)
+
+/* Conversion of the measurement result to lux, default measurement time */
+#define BH1750_COUNTS_PER_LUX              (float)(1.2f)
+
+/**
+ * Auto-range: MTreg of the next measurement is chosen so the result of the previous light level
+ * is close to BH1750_AUTO_RANGE_TARGET_COUNTS. Bright light gets short measurements, darkness
+ * long integrations with a finer resolution.
+ */
+#define BH1750_AUTO_RANGE_TARGET_COUNTS    (uint32_t)(20000u)
+/* Results inside this range keep the MTreg, so the measurement time does not change on every sample */
+#define BH1750_AUTO_RANGE_LOW_COUNTS       (uint16_t)(5000u)
+#define BH1750_AUTO_RANGE_HIGH_COUNTS      (uint16_t)(50000u)
+
+/* Flags indicating if the sensor is initialized and refreshed in the background */
+#define BH1750_SENSOR_READY     (bool)(true)
+#define BH1750_SENSOR_NOT_READY (bool)(false)
+
+/* Flags indicating if the latest data from the sensor is valid */
+#define BH1750_DATA_VALID                  (bool)(true)
+#define BH1750_DATA_INVALID                (bool)(false)
+
+/* State of the one-shot measurement */
+#define BH1750_STATE_SLEEPING              (uint8_t)(0u) /* Sensor is powered down until the next measurement */
+#define BH1750_STATE_TRIGGERING            (uint8_t)(1u) /* MTreg and the one-shot instruction are on the bus */
+#define BH1750_STATE_MEASURING             (uint8_t)(2u) /* Sensor integrates the light */
+#define BH1750_STATE_READING               (uint8_t)(3u) /* Read of the result is on the bus */
 
 /**
  * @brief Initializes the BH1750 light sensor.
  *
- * This function initializes the BH1750 sensor by calling its `begin()` method.
- * It ensures that the sensor is ready to be used. If the initialization fails,
- * the function returns false, indicating an error.
+ * This function powers the BH1750 sensor on to check that it answers. Measurements are
+ * started one by one by bh1750_service(), the sensor powers down after each of them.
+ * If the sensor does not acknowledge the instruction, the function returns false, indicating an error.
  *
  * @return true if the sensor is successfully initialized, false otherwise.
  */
@@ -19,11 +72,22 @@ bool bh1750_init();
 /**
  * @brief Reads the light level from the BH1750 sensor.
  *
- * This function retrieves the current light level in lux from the BH1750 sensor.
- * The value returned is a float, representing the light intensity measured by the sensor.
+ * This function returns the light level in lux from the latest result refreshed by
+ * bh1750_service(), the I2C bus is not accessed.
  *
- * @return The light level in lux as a float.
+ * @return The light level in lux as a float, NAN if there is no valid result.
  */
 float bh1750_readLightLevel();
 
-#endif
\ No newline at end of file
+/**
+ * @brief Runs the one-shot measurements of the sensor in the background.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Every SENSORS_BH1750_CONVERSION_PERIOD_MS the MTreg chosen by the
+ * auto-range and the one-shot instruction are queued, after the measurement time of that MTreg
+ * the result is read. No step waits for the bus.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void bh1750_service(uint32_t current_millis);
+
+#endif
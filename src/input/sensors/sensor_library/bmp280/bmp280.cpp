@@ -1,36 +1,234 @@
 #include "bmp280.h"
 
 /* STATIC GLOBAL VARIABLES */
-static Adafruit_BMP280 bmp;
+static bmp280_calibration_ts calibration;
+static bmp280_burst_reading_ts latest_reading;
+static bool latest_valid = BMP280_DATA_INVALID;
+static bool sensor_ready = BMP280_SENSOR_NOT_READY;
+static uint8_t state = BMP280_STATE_SLEEPING;
+static uint32_t conversion_start = 0u;
+static uint32_t next_conversion = 0u;
+
+// Background start of a forced conversion and burst read of the data registers
+static i2c_bus_job_ts trigger_job;
+static const uint8_t trigger_registers[] = {BMP280_REG_CTRL_MEAS,
+                                            BMP280_CTRL_MEAS(BMP280_TEMPERATURE_SAMPLING, BMP280_PRESSURE_SAMPLING, BMP280_MODE_FORCED)};
+static i2c_bus_job_ts data_job;
+static const uint8_t data_register = BMP280_REG_DATA;
+static uint8_t data_buffer[BMP280_DATA_SIZE];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(BMP280_MEASUREMENT_TIME_MS < SENSORS_BMP280_CONVERSION_PERIOD_MS, "BMP280 conversion period must be longer than its measurement time");
+static_assert(SENSORS_BMP280_CONVERSION_PERIOD_MS <= SENSORS_BMP280_TEMPERATURE_SAMPLE_PERIOD_MS &&
+              SENSORS_BMP280_CONVERSION_PERIOD_MS <= SENSORS_BMP280_PRESSURE_SAMPLE_PERIOD_MS &&
+              SENSORS_BMP280_CONVERSION_PERIOD_MS <= SENSORS_BMP280_ALTITUDE_SAMPLE_PERIOD_MS, "Every BMP280 sample must see a new conversion");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Writes one register of the sensor and waits for the transfer.
+ *
+ * @param reg Register address.
+ * @param value Value to be written.
+ * @return true if the sensor acknowledged the write, false otherwise.
+ */
+static bool writeRegister(uint8_t reg, uint8_t value);
+
+/**
+ * @brief Reads consecutive registers of the sensor and waits for the transfer.
+ *
+ * @param reg Address of the first register.
+ * @param buffer Buffer for the register values.
+ * @param length Number of registers to read.
+ * @return true if the read succeeded, false otherwise.
+ */
+static bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t length);
+
+/**
+ * @brief Converts the raw data with the calibration of the sensor (datasheet integer compensation).
+ *
+ * @param data Data registers read from BMP280_REG_DATA.
+ * @param reading Pointer to the reading which receives temperature, pressure and altitude.
+ */
+static void compensate(const uint8_t *data, bmp280_burst_reading_ts *reading);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 bool bmp280_init()
 {
-  if(!bmp.begin(SENSORS_BMP280_I2C_ADDR))
+  uint8_t chip_id = 0u;
+  uint8_t calibration_data[BMP280_CALIBRATION_SIZE];
+
+  if(!readRegisters(BMP280_REG_CHIP_ID, &chip_id, sizeof(chip_id)) || BMP280_CHIP_ID != chip_id)
+  {
+    return false;
+  }
+
+  if(!readRegisters(BMP280_REG_CALIBRATION, calibration_data, sizeof(calibration_data)))
   {
     return false;
   }
-  bmp.setSampling(BMP280_MODE_NORMAL,     // Operating Mode
-                  BMP280_SAMPLING_X2,     // Temperature oversampling(takes 2 samples)
-                  BMP280_SAMPLING_X16,    // Pressure oversampling(takes 16 samples)->more accurrate
-                  BMP280_FILTER_X16,      // Filtering
-                  BMP280_WAIT_MS_500);    // Standby time between readings
+  // Calibration words are little endian, in the order of the structure
+  calibration.dig_T1 = (uint16_t)(calibration_data[0] | (calibration_data[1] << 8));
+  calibration.dig_T2 = (int16_t)(calibration_data[2] | (calibration_data[3] << 8));
+  calibration.dig_T3 = (int16_t)(calibration_data[4] | (calibration_data[5] << 8));
+  calibration.dig_P1 = (uint16_t)(calibration_data[6] | (calibration_data[7] << 8));
+  calibration.dig_P2 = (int16_t)(calibration_data[8] | (calibration_data[9] << 8));
+  calibration.dig_P3 = (int16_t)(calibration_data[10] | (calibration_data[11] << 8));
+  calibration.dig_P4 = (int16_t)(calibration_data[12] | (calibration_data[13] << 8));
+  calibration.dig_P5 = (int16_t)(calibration_data[14] | (calibration_data[15] << 8));
+  calibration.dig_P6 = (int16_t)(calibration_data[16] | (calibration_data[17] << 8));
+  calibration.dig_P7 = (int16_t)(calibration_data[18] | (calibration_data[19] << 8));
+  calibration.dig_P8 = (int16_t)(calibration_data[20] | (calibration_data[21] << 8));
+  calibration.dig_P9 = (int16_t)(calibration_data[22] | (calibration_data[23] << 8));
+
+  // Sensor is in sleep mode after reset, the filter is kept between the forced conversions
+  if(!writeRegister(BMP280_REG_CTRL_MEAS, BMP280_CTRL_MEAS(BMP280_SAMPLING_NONE, BMP280_SAMPLING_NONE, BMP280_MODE_SLEEP)) ||
+     !writeRegister(BMP280_REG_CONFIG, BMP280_CONFIG(BMP280_WAIT_MS_0_5, BMP280_FILTER)))    // Standby is not used in forced mode
+  {
+    return false;
+  }
+
+  i2c_bus_prepareJob(&trigger_job, SENSORS_BMP280_I2C_ADDR, trigger_registers, sizeof(trigger_registers), nullptr, 0u);
+  i2c_bus_prepareJob(&data_job, SENSORS_BMP280_I2C_ADDR, &data_register, sizeof(data_register), data_buffer, sizeof(data_buffer));
+  latest_valid = BMP280_DATA_INVALID;
+  state = BMP280_STATE_SLEEPING;
+  next_conversion = millis();
+  sensor_ready = BMP280_SENSOR_READY;
   return true;
 }
 
 float bmp280_readTemperature()
 {
-    return bmp.readTemperature();
+  return (BMP280_DATA_VALID == latest_valid) ? latest_reading.temperature : NAN;
 }
 
 float bmp280_readPressure()
 {
-    return bmp.readPressure();
+  return (BMP280_DATA_VALID == latest_valid) ? latest_reading.pressure : NAN;
 }
 
 float bmp280_readAltitude()
 {
-    return bmp.readAltitude(SENSORS_BMP280_LOCAL_SEA_LEVEL_PRESSURE);
+  return (BMP280_DATA_VALID == latest_valid) ? latest_reading.altitude : NAN;
 }
-/* *************************************** */
\ No newline at end of file
+
+void bmp280_service(uint32_t current_millis)
+{
+  if(BMP280_SENSOR_READY != sensor_ready)
+  {
+    return;
+  }
+
+  switch(state)
+  {
+    case BMP280_STATE_SLEEPING:
+      if(0 <= (int32_t)(current_millis - next_conversion)) // Overflow safe deadline
+      {
+        if(I2C_BUS_JOB_ACCEPTED == i2c_bus_submit(&trigger_job)) // Queue full, retried in the next pass
+        {
+          next_conversion = current_millis + SENSORS_BMP280_CONVERSION_PERIOD_MS;
+          state = BMP280_STATE_TRIGGERING;
+        }
+      }
+      break;
+
+    case BMP280_STATE_TRIGGERING:
+      if(I2C_BUS_JOB_DONE == trigger_job.status)
+      {
+        conversion_start = current_millis;
+        state = BMP280_STATE_CONVERTING;
+      }
+      else if(!I2C_BUS_IS_JOB_PENDING(trigger_job.status))
+      {
+        latest_valid = BMP280_DATA_INVALID; // Sensor did not answer, do not report stale data
+        state = BMP280_STATE_SLEEPING;
+      }
+      break;
+
+    case BMP280_STATE_CONVERTING:
+      if((current_millis - conversion_start) >= BMP280_MEASUREMENT_TIME_MS &&
+         I2C_BUS_JOB_ACCEPTED == i2c_bus_submit(&data_job))
+      {
+        state = BMP280_STATE_READING;
+      }
+      break;
+
+    case BMP280_STATE_READING:
+      if(I2C_BUS_JOB_DONE == data_job.status)
+      {
+        compensate(data_buffer, &latest_reading);
+        latest_valid = BMP280_DATA_VALID;
+        state = BMP280_STATE_SLEEPING;
+      }
+      else if(!I2C_BUS_IS_JOB_PENDING(data_job.status))
+      {
+        latest_valid = BMP280_DATA_INVALID;
+        state = BMP280_STATE_SLEEPING;
+      }
+      break;
+
+    default:
+      state = BMP280_STATE_SLEEPING;
+      break;
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool writeRegister(uint8_t reg, uint8_t value)
+{
+  i2c_bus_job_ts job;
+  uint8_t tx_buffer[] = {reg, value};
+
+  i2c_bus_prepareJob(&job, SENSORS_BMP280_I2C_ADDR, tx_buffer, sizeof(tx_buffer), nullptr, 0u);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+static bool readRegisters(uint8_t reg, uint8_t *buffer, uint8_t length)
+{
+  i2c_bus_job_ts job;
+
+  i2c_bus_prepareJob(&job, SENSORS_BMP280_I2C_ADDR, &reg, sizeof(reg), buffer, length);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+static void compensate(const uint8_t *data, bmp280_burst_reading_ts *reading)
+{
+  int32_t raw_temperature = BMP280_RAW_TEMPERATURE(data);
+  int32_t raw_pressure = BMP280_RAW_PRESSURE(data);
+
+  // Temperature, t_fine is also needed for the pressure
+  int32_t var1 = ((((raw_temperature >> 3) - ((int32_t)calibration.dig_T1 << 1))) * ((int32_t)calibration.dig_T2)) >> 11;
+  int32_t var2 = (((((raw_temperature >> 4) - ((int32_t)calibration.dig_T1)) *
+                    ((raw_temperature >> 4) - ((int32_t)calibration.dig_T1))) >> 12) * ((int32_t)calibration.dig_T3)) >> 14;
+  int32_t t_fine = var1 + var2;
+  reading->temperature = (float)((t_fine * 5 + 128) >> 8) / BMP280_TEMPERATURE_SCALE;
+
+  // Pressure with 64-bit intermediate values
+  int64_t p_var1 = ((int64_t)t_fine) - 128000;
+  int64_t p_var2 = p_var1 * p_var1 * (int64_t)calibration.dig_P6;
+  p_var2 = p_var2 + ((p_var1 * (int64_t)calibration.dig_P5) << 17);
+  p_var2 = p_var2 + (((int64_t)calibration.dig_P4) << 35);
+  p_var1 = ((p_var1 * p_var1 * (int64_t)calibration.dig_P3) >> 8) + ((p_var1 * (int64_t)calibration.dig_P2) << 12);
+  p_var1 = (((((int64_t)1) << 47) + p_var1)) * ((int64_t)calibration.dig_P1) >> 33;
+
+  if(0 == p_var1)
+  {
+    reading->pressure = NAN; // Avoid division by zero
+    reading->altitude = NAN;
+    return;
+  }
+
+  int64_t pressure = 1048576 - raw_pressure;
+  pressure = (((pressure << 31) - p_var2) * 3125) / p_var1;
+  p_var1 = (((int64_t)calibration.dig_P9) * (pressure >> 13) * (pressure >> 13)) >> 25;
+  p_var2 = (((int64_t)calibration.dig_P8) * pressure) >> 19;
+  pressure = ((pressure + p_var1 + p_var2) >> 8) + (((int64_t)calibration.dig_P7) << 4);
+
+  reading->pressure = (float)pressure / (BMP280_PRESSURE_SCALE * BMP280_PA_PER_HPA); // Catalog range is in hPa
+  // Same barometric formula as Adafruit_BMP280::readAltitude(), evaluated once per conversion
+  reading->altitude = BMP280_HPA_TO_ALTITUDE(reading->pressure);
+}
+/* *************************************** */
@@ -2,47 +2,146 @@
 #define BMP280_H
 
 #include <Arduino.h>
-#include <Adafruit_BMP280.h>
 #include "../sensors_config.h"
+#include "../../../../i2c_bus/i2c_bus.h"
 
-
-#define BMP280_MODE_NORMAL    Adafruit_BMP280::MODE_NORMAL //The sensor continuously takes measurements based on the configured sampling and standby time.
-#define BMP280_MODE_SLEEP     Adafruit_BMP280::MODE_SLEEP  //The sensor is in sleep mode, consuming minimal power and not taking any measurements.
-#define BMP280_MODE_FORCED    Adafruit_BMP280::MODE_FORCED //The sensor takes a single measurement and then returns to sleep mode.
+/* Operating modes (ctrl_meas register, bits 1..0) */
+#define BMP280_MODE_SLEEP     (uint8_t)(0x00u) //The sensor is in sleep mode, consuming minimal power and not taking any measurements.
+#define BMP280_MODE_FORCED    (uint8_t)(0x01u) //The sensor takes a single measurement and then returns to sleep mode.
+#define BMP280_MODE_NORMAL    (uint8_t)(0x03u) //The sensor continuously takes measurements based on the configured sampling and standby time.
 
 // Higher sampling means higher resolution at the cost of slower measurements and higher power consumption.
-#define BMP280_SAMPLING_NONE  Adafruit_BMP280::SAMPLING_NONE
-#define BMP280_SAMPLING_X1    Adafruit_BMP280::SAMPLING_X1
-#define BMP280_SAMPLING_X2    Adafruit_BMP280::SAMPLING_X2
-#define BMP280_SAMPLING_X4    Adafruit_BMP280::SAMPLING_X4
-#define BMP280_SAMPLING_X8    Adafruit_BMP280::SAMPLING_X8
-#define BMP280_SAMPLING_X16   Adafruit_BMP280::SAMPLING_X16
+#define BMP280_SAMPLING_NONE  (uint8_t)(0x00u)
+#define BMP280_SAMPLING_X1    (uint8_t)(0x01u)
+#define BMP280_SAMPLING_X2    (uint8_t)(0x02u)
+#define BMP280_SAMPLING_X4    (uint8_t)(0x03u)
+#define BMP280_SAMPLING_X8    (uint8_t)(0x04u)
+#define BMP280_SAMPLING_X16   (uint8_t)(0x05u)
 
 //Filtering is used to reduce noise but it introduces a slight delay in readings.
-#define BMP280_FILTER_OFF     Adafruit_BMP280::FILTER_OFF
-#define BMP280_FILTER_X2      Adafruit_BMP280::FILTER_X2
-#define BMP280_FILTER_X4      Adafruit_BMP280::FILTER_X4
-#define BMP280_FILTER_X8      Adafruit_BMP280::FILTER_X8
-#define BMP280_FILTER_X16     Adafruit_BMP280::FILTER_X16
+#define BMP280_FILTER_OFF     (uint8_t)(0x00u)
+#define BMP280_FILTER_X2      (uint8_t)(0x01u)
+#define BMP280_FILTER_X4      (uint8_t)(0x02u)
+#define BMP280_FILTER_X8      (uint8_t)(0x03u)
+#define BMP280_FILTER_X16     (uint8_t)(0x04u)
 
 //The amount of time the sensor waits between measurements
-#define BMP280_WAIT_MS_0_5    Adafruit_BMP280::STANDBY_MS_0_5
-#define BMP280_WAIT_MS_62_5   Adafruit_BMP280::STANDBY_MS_62_5
-#define BMP280_WAIT_MS_125    Adafruit_BMP280::STANDBY_MS_125
-#define BMP280_WAIT_MS_250    Adafruit_BMP280::STANDBY_MS_250
-#define BMP280_WAIT_MS_500    Adafruit_BMP280::STANDBY_MS_500
-#define BMP280_WAIT_MS_1000   Adafruit_BMP280::STANDBY_MS_1000
-#define BMP280_WAIT_MS_2000   Adafruit_BMP280::STANDBY_MS_2000
-#define BMP280_WAIT_MS_4000   Adafruit_BMP280::STANDBY_MS_4000
+#define BMP280_WAIT_MS_0_5    (uint8_t)(0x00u)
+#define BMP280_WAIT_MS_62_5   (uint8_t)(0x01u)
+#define BMP280_WAIT_MS_125    (uint8_t)(0x02u)
+#define BMP280_WAIT_MS_250    (uint8_t)(0x03u)
+#define BMP280_WAIT_MS_500    (uint8_t)(0x04u)
+#define BMP280_WAIT_MS_1000   (uint8_t)(0x05u)
+#define BMP280_WAIT_MS_2000   (uint8_t)(0x06u)
+#define BMP280_WAIT_MS_4000   (uint8_t)(0x07u)
+
+/* Registers of the sensor */
+#define BMP280_REG_CALIBRATION          (uint8_t)(0x88u)
+#define BMP280_REG_CHIP_ID              (uint8_t)(0xD0u)
+#define BMP280_REG_CTRL_MEAS            (uint8_t)(0xF4u)
+#define BMP280_REG_CONFIG               (uint8_t)(0xF5u)
+#define BMP280_REG_DATA                 (uint8_t)(0xF7u)
+
+/* Value of the chip ID register of a BMP280 */
+#define BMP280_CHIP_ID                  (uint8_t)(0x58u)
+
+/* Number of calibration bytes (dig_T1..dig_P9) and of the data bytes (pressure and temperature, 3 bytes each) */
+#define BMP280_CALIBRATION_SIZE         (uint8_t)(24u)
+#define BMP280_DATA_SIZE                (uint8_t)(6u)
+
+/* Oversampling profiles, selected with SENSORS_BMP280_HIGH_RESOLUTION in sensors_config.h */
+#ifdef SENSORS_BMP280_HIGH_RESOLUTION
+#define BMP280_TEMPERATURE_SAMPLING     (BMP280_SAMPLING_X2)
+#define BMP280_PRESSURE_SAMPLING        (BMP280_SAMPLING_X16)
+#define BMP280_FILTER                   (BMP280_FILTER_X4)
+#else
+#define BMP280_TEMPERATURE_SAMPLING     (BMP280_SAMPLING_X1)
+#define BMP280_PRESSURE_SAMPLING        (BMP280_SAMPLING_X1)
+#define BMP280_FILTER                   (BMP280_FILTER_OFF)
+#endif
+
+/* Number of samples of an oversampling setting (X1 = 1 ... X16 = 16) */
+#define BMP280_SAMPLES(sampling)        (uint32_t)(1u << ((sampling) - 1u))
+
+/* Maximum measurement time of a forced conversion (datasheet 3.8.1) rounded up to milliseconds */
+#define BMP280_MEASUREMENT_TIME_MS      (uint32_t)((1250u + 2300u * BMP280_SAMPLES(BMP280_TEMPERATURE_SAMPLING) + \
+                                                    2300u * BMP280_SAMPLES(BMP280_PRESSURE_SAMPLING) + 575u + 999u) / 1000u)
+
+/* Macros that build the values of the control registers */
+#define BMP280_CTRL_MEAS(temperature_sampling, pressure_sampling, mode) (uint8_t)(((temperature_sampling) << 5) | ((pressure_sampling) << 2) | (mode))
+#define BMP280_CONFIG(standby, filter)  (uint8_t)(((standby) << 5) | ((filter) << 2))
+
+/* Macros that assemble the 20-bit raw values from the data bytes (msb, lsb, xlsb) */
+#define BMP280_RAW_PRESSURE(data)       (int32_t)(((uint32_t)(data)[0] << 12) | ((uint32_t)(data)[1] << 4) | ((data)[2] >> 4))
+#define BMP280_RAW_TEMPERATURE(data)    (int32_t)(((uint32_t)(data)[3] << 12) | ((uint32_t)(data)[4] << 4) | ((data)[5] >> 4))
+
+/* Scaling of the compensated values, temperature in 0.01 degC and pressure in Q24.8 Pa */
+#define BMP280_TEMPERATURE_SCALE        (float)(100.0f)
+#define BMP280_PRESSURE_SCALE           (float)(256.0f)
+
+/* Flags indicating if the sensor is initialized and refreshed in the background */
+#define BMP280_SENSOR_READY     (bool)(true)
+#define BMP280_SENSOR_NOT_READY (bool)(false)
+
+/* Flags indicating if the latest data from the sensor is valid */
+#define BMP280_DATA_VALID     (bool)(true)
+#define BMP280_DATA_INVALID   (bool)(false)
+
+/* State of the forced conversion */
+#define BMP280_STATE_SLEEPING   (uint8_t)(0u) /* Sensor sleeps until the next conversion */
+#define BMP280_STATE_TRIGGERING (uint8_t)(1u) /* Write of the forced mode is on the bus */
+#define BMP280_STATE_CONVERTING (uint8_t)(2u) /* Sensor measures, returns to sleep by itself */
+#define BMP280_STATE_READING    (uint8_t)(3u) /* Burst read of the data registers is on the bus */
+
+/**
+ * @brief Structure holding the factory calibration of the sensor (datasheet naming).
+ */
+typedef struct
+{
+  uint16_t dig_T1;
+  int16_t dig_T2;
+  int16_t dig_T3;
+  uint16_t dig_P1;
+  int16_t dig_P2;
+  int16_t dig_P3;
+  int16_t dig_P4;
+  int16_t dig_P5;
+  int16_t dig_P6;
+  int16_t dig_P7;
+  int16_t dig_P8;
+  int16_t dig_P9;
+} bmp280_calibration_ts;
+
+/* Barometric formula constants, same as used by Adafruit_BMP280::readAltitude() */
+#define BMP280_PA_PER_HPA               (float)(100.0f)
+#define BMP280_ALTITUDE_SCALE_M         (float)(44330.0f)
+#define BMP280_ALTITUDE_EXPONENT        (float)(0.1903f)
+
+/* Macro that calculates the altitude in meters from the pressure in hectopascals */
+#define BMP280_HPA_TO_ALTITUDE(pressure) (BMP280_ALTITUDE_SCALE_M * (1.0f - pow((pressure) / SENSORS_BMP280_LOCAL_SEA_LEVEL_PRESSURE, BMP280_ALTITUDE_EXPONENT)))
+
+/**
+ * @brief Structure holding all measurements of the BMP280 taken from one conversion.
+ *
+ * Members:
+ *  - temperature: Temperature in degrees Celsius.
+ *  - pressure: Atmospheric pressure in hectopascals, the unit of the sensor catalog.
+ *  - altitude: Altitude in meters calculated from the pressure above.
+ */
+typedef struct
+{
+  float temperature;
+  float pressure;
+  float altitude;
+} bmp280_burst_reading_ts;
 
 /**
  * @brief Initializes the BMP280 sensor.
  *
- * This function initializes the BMP280 sensor by attempting to start the sensor
- * with the specified I2C address. If the initialization is successful, it
- * configures the sensor's sampling settings, including operating mode, oversampling,
- * filtering, and standby time. If any initialization step fails, the function
- * returns false.
+ * This function checks the chip ID of the sensor at the configured I2C address,
+ * reads its calibration and configures the filter. The sensor is left in sleep mode,
+ * conversions are started in forced mode by bmp280_service(). If any initialization step
+ * fails, the function returns false.
  *
  * @return true if the sensor is successfully initialized, false otherwise.
  */
@@ -51,32 +150,43 @@ bool bmp280_init();
 /**
  * @brief Reads the current temperature from the BMP280 sensor.
  *
- * This function retrieves the current temperature from the BMP280 sensor.
- * The temperature is measured in degrees Celsius.
+ * This function returns the temperature from the latest data refreshed by bmp280_service(),
+ * the I2C bus is not accessed. The temperature is measured in degrees Celsius.
  *
- * @return The current temperature in degrees Celsius.
+ * @return The current temperature in degrees Celsius, NAN if there is no valid data.
  */
 float bmp280_readTemperature();
 
 /**
  * @brief Reads the current atmospheric pressure from the BMP280 sensor.
  *
- * This function retrieves the current atmospheric pressure from the BMP280 sensor.
- * The pressure is returned in Pascals (Pa).
+ * This function returns the pressure from the latest data refreshed by bmp280_service(),
+ * the I2C bus is not accessed. The pressure is returned in hectopascals (hPa).
  *
- * @return The current atmospheric pressure in Pascals.
+ * @return The current atmospheric pressure in hectopascals, NAN if there is no valid data.
  */
 float bmp280_readPressure();
 
 /**
  * @brief Reads the current altitude from the BMP280 sensor.
  *
- * This function calculates and returns the current altitude based on the pressure
- * measurement and a given sea-level pressure value. The altitude is calculated
- * using the barometric formula.
+ * This function returns the altitude calculated from the latest pressure and a given
+ * sea-level pressure value. The altitude is calculated once per conversion using the barometric formula.
  *
- * @return The calculated altitude in meters.
+ * @return The calculated altitude in meters, NAN if there is no valid data.
  */
 float bmp280_readAltitude();
 
+/**
+ * @brief Refreshes the latest data of the sensor in the background.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Every SENSORS_BMP280_CONVERSION_PERIOD_MS a forced conversion is
+ * started, after BMP280_MEASUREMENT_TIME_MS all six data registers are read in one burst and
+ * compensated once, so temperature, pressure and altitude always come from the same conversion.
+ * The sensor sleeps between the conversions and no step waits for the bus.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void bmp280_service(uint32_t current_millis);
+
 #endif
\ No newline at end of file
@@ -1,22 +1,176 @@
 #include "dht11.h"
 
 /* STATIC GLOBAL VARIABLES */
-static DHT dht(SENSORS_DHT11_PIN, DHT11);
+// Exchange state, written by the service only, the INT0 interrupt decodes the edges while RECEIVING
+static volatile uint8_t state = DHT11_STATE_IDLE;
+static volatile uint8_t edge_count = 0u;
+static volatile uint32_t last_edge_us = 0u;
+// Frame assembled by the interrupt and the complete frames it hands over to the service
+static dht11_frame_ts received_frame;
+static spsc_ring_ts<dht11_frame_ts, DHT11_FRAME_QUEUE_SIZE> frames;
+static uint32_t phase_start = 0u;
+static uint32_t next_conversion = 0u;
+
+// Values of the latest valid frame
+static float latest_temperature = NAN;
+static float latest_humidity = NAN;
+static bool latest_valid = DHT11_DATA_INVALID;
+static bool sensor_ready = DHT11_SENSOR_NOT_READY;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(DHT11_INT0_PIN == SENSORS_DHT11_PIN, "DHT11 must be connected to INT0 (pin 2), the frame is timed by its interrupt");
+static_assert(DHT11_MIN_CONVERSION_PERIOD_MS <= SENSORS_DHT11_CONVERSION_PERIOD_MS, "DHT11 can not convert more often than once per second");
+static_assert(SENSORS_DHT11_CONVERSION_PERIOD_MS <= SENSORS_DHT11_TEMPERATURE_SAMPLE_PERIOD_MS &&
+              SENSORS_DHT11_CONVERSION_PERIOD_MS <= SENSORS_DHT11_HUMIDITY_SAMPLE_PERIOD_MS, "Every DHT11 sample must see a new frame");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Checks a received frame and takes over temperature and humidity.
+ *
+ * @param frame Frame queued by the ISR.
+ * @return true if the checksum matched, false otherwise.
+ */
+static bool decodeFrame(const dht11_frame_ts *frame);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 void dht11_init()
 {
-    dht.begin();
+  pinMode(SENSORS_DHT11_PIN, INPUT_PULLUP); // Idle line is high
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    state = DHT11_STATE_IDLE;
+    EICRA = (uint8_t)((EICRA & ~(_BV(ISC01) | _BV(ISC00))) | _BV(ISC01)); // Falling edge of INT0
+    EIFR = _BV(INTF0);
+    EIMSK |= _BV(INT0);
+  }
+
+  latest_valid = DHT11_DATA_INVALID;
+  next_conversion = millis();
+  sensor_ready = DHT11_SENSOR_READY;
 }
 
 float dht11_readTemperature()
 {
-    return dht.readTemperature();
+  return (DHT11_DATA_VALID == latest_valid) ? latest_temperature : NAN;
 }
 
 float dht11_readHumidity()
 {
-    return dht.readHumidity();
+  return (DHT11_DATA_VALID == latest_valid) ? latest_humidity : NAN;
 }
-/* *************************************** */
\ No newline at end of file
+
+bool dht11_isIdle()
+{
+  return DHT11_STATE_IDLE == state;
+}
+
+void dht11_service(uint32_t current_millis)
+{
+  if(DHT11_SENSOR_READY != sensor_ready)
+  {
+    return;
+  }
+
+  switch(state)
+  {
+    case DHT11_STATE_IDLE:
+      if(0 <= (int32_t)(current_millis - next_conversion)) // Overflow safe deadline
+      {
+        next_conversion = current_millis + SENSORS_DHT11_CONVERSION_PERIOD_MS;
+        digitalWrite(SENSORS_DHT11_PIN, LOW);
+        pinMode(SENSORS_DHT11_PIN, OUTPUT); // Start signal, falling edge is ignored by the ISR
+        phase_start = current_millis;
+        state = DHT11_STATE_START_SIGNAL;
+      }
+      break;
+
+    case DHT11_STATE_START_SIGNAL:
+      if((current_millis - phase_start) >= DHT11_START_SIGNAL_MS)
+      {
+        spsc_ring_clear(&frames); // Late frame of a timed-out exchange
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+          edge_count = 0u;
+          state = DHT11_STATE_RECEIVING;
+        }
+        pinMode(SENSORS_DHT11_PIN, INPUT_PULLUP); // Release the line, the sensor answers within 40 us
+        phase_start = current_millis;
+      }
+      break;
+
+    case DHT11_STATE_RECEIVING:
+    {
+      dht11_frame_ts frame;
+      if(SPSC_RING_POPPED == spsc_ring_pop(&frames, &frame))
+      {
+        latest_valid = decodeFrame(&frame) ? DHT11_DATA_VALID : DHT11_DATA_INVALID;
+        state = DHT11_STATE_IDLE;
+      }
+      else if((current_millis - phase_start) >= DHT11_FRAME_TIMEOUT_MS)
+      {
+        state = DHT11_STATE_IDLE; // A frame finished after this is dropped at the next start
+        latest_valid = DHT11_DATA_INVALID; // Sensor did not answer, do not report stale data
+      }
+      break;
+    }
+
+    default:
+      state = DHT11_STATE_IDLE;
+      break;
+  }
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(INT0_vect)
+{
+  uint32_t now_us = micros();
+
+  if(DHT11_STATE_RECEIVING == state)
+  {
+    uint8_t edge = edge_count;
+    // Time from the previous falling edge is the length of the bit which just ended, edges after the frame are ignored
+    if(edge >= DHT11_FIRST_BIT_EDGE && (uint8_t)(edge - DHT11_FIRST_BIT_EDGE) < DHT11_FRAME_BITS)
+    {
+      uint8_t bit_index = (uint8_t)(edge - DHT11_FIRST_BIT_EDGE);
+      uint8_t byte_index = (uint8_t)(bit_index >> 3);
+      received_frame.bytes[byte_index] = (uint8_t)(received_frame.bytes[byte_index] << 1);
+      if((uint32_t)(now_us - last_edge_us) > DHT11_BIT_ONE_THRESHOLD_US)
+      {
+        received_frame.bytes[byte_index] |= 1u;
+      }
+      if((DHT11_FRAME_BITS - 1u) == bit_index)
+      {
+        (void)spsc_ring_push(&frames, &received_frame); // Queue holds the frame of every exchange
+      }
+    }
+    last_edge_us = now_us;
+    edge_count = (uint8_t)(edge + 1u);
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool decodeFrame(const dht11_frame_ts *frame)
+{
+  const uint8_t *bytes = frame->bytes;
+  uint8_t checksum = (uint8_t)(bytes[DHT11_FRAME_HUMIDITY_INTEGER] + bytes[DHT11_FRAME_HUMIDITY_DECIMAL] +
+                               bytes[DHT11_FRAME_TEMPERATURE_INTEGER] + bytes[DHT11_FRAME_TEMPERATURE_DECIMAL]);
+  if(checksum != bytes[DHT11_FRAME_CHECKSUM])
+  {
+    return false;
+  }
+
+  latest_humidity = (float)bytes[DHT11_FRAME_HUMIDITY_INTEGER] + (float)bytes[DHT11_FRAME_HUMIDITY_DECIMAL] / DHT11_DECIMAL_SCALE;
+
+  uint8_t temperature_decimal = bytes[DHT11_FRAME_TEMPERATURE_DECIMAL];
+  float temperature = (float)bytes[DHT11_FRAME_TEMPERATURE_INTEGER] +
+                      (float)(temperature_decimal & DHT11_TEMPERATURE_DECIMAL_MASK) / DHT11_DECIMAL_SCALE;
+  latest_temperature = (temperature_decimal & DHT11_TEMPERATURE_NEGATIVE_MASK) ? -temperature : temperature;
+  return true;
+}
+/* *************************************** */
@@ -2,29 +2,117 @@
 #define DHT11_H
 
 #include <Arduino.h>
-#include <DHT.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "../sensors_config.h"
+#include "../../../../spsc_ring/spsc_ring.h"
 
+/**
+ * The data line of the DHT11 is connected to INT0, every falling edge of the frame is timed in its ISR,
+ * so an exchange never blocks the loop or disables interrupts.
+ *
+ * Exchange: host pulls the line low for at least DHT11_START_SIGNAL_MS and releases it, the sensor answers
+ * with 80 us low and 80 us high and sends 40 bits. Every bit is 50 us low followed by 26-28 us (0) or
+ * 70 us (1) high, so the time between two falling edges is about 78 us for 0 and 120 us for 1.
+ * Frame: humidity integer and decimal byte, temperature integer and decimal byte, checksum.
+ */
+#define DHT11_INT0_PIN                    (uint8_t)(2u)
+
+/* Time the host keeps the line low to start a conversion */
+#define DHT11_START_SIGNAL_MS             (uint32_t)(20u)
+/* Frame takes about 5 ms, a longer exchange is treated as a missing sensor */
+#define DHT11_FRAME_TIMEOUT_MS            (uint32_t)(10u)
+/* Shortest conversion period allowed by the sensor */
+#define DHT11_MIN_CONVERSION_PERIOD_MS    (uint32_t)(1000u)
+
+/* Falling edges of the response (start of the response and start of the first bit) before the data bits */
+#define DHT11_FIRST_BIT_EDGE              (uint8_t)(2u)
+/* Number of data bits (5 bytes) */
+#define DHT11_FRAME_BITS                  (uint8_t)(40u)
+#define DHT11_FRAME_SIZE                  (uint8_t)(DHT11_FRAME_BITS / 8u)
+/* Time between two falling edges above which the bit is 1 */
+#define DHT11_BIT_ONE_THRESHOLD_US        (uint32_t)(100u)
+
+/* Bytes of the frame */
+#define DHT11_FRAME_HUMIDITY_INTEGER      (uint8_t)(0u)
+#define DHT11_FRAME_HUMIDITY_DECIMAL      (uint8_t)(1u)
+#define DHT11_FRAME_TEMPERATURE_INTEGER   (uint8_t)(2u)
+#define DHT11_FRAME_TEMPERATURE_DECIMAL   (uint8_t)(3u)
+#define DHT11_FRAME_CHECKSUM              (uint8_t)(4u)
+
+/* Sign bit and decimal digit of the temperature decimal byte */
+#define DHT11_TEMPERATURE_NEGATIVE_MASK   (uint8_t)(0x80u)
+#define DHT11_TEMPERATURE_DECIMAL_MASK    (uint8_t)(0x0Fu)
+/* Decimal bytes hold tenths */
+#define DHT11_DECIMAL_SCALE               (float)(10.0f)
+
+/* State of the exchange */
+#define DHT11_STATE_IDLE                  (uint8_t)(0u) /* Waiting for the next conversion */
+#define DHT11_STATE_START_SIGNAL          (uint8_t)(1u) /* Host holds the line low */
+#define DHT11_STATE_RECEIVING             (uint8_t)(2u) /* Falling edges are decoded by the ISR until the frame is queued */
+
+/* Frames decoded by the ISR and not checked yet (power of two), one per exchange and a late one of a timed-out exchange */
+#define DHT11_FRAME_QUEUE_SIZE            (uint8_t)(2u)
+
+/* Flags indicating if the sensor is initialized and refreshed in the background */
+#define DHT11_SENSOR_READY                (bool)(true)
+#define DHT11_SENSOR_NOT_READY            (bool)(false)
+
+/* Flags indicating if the latest frame from the sensor is valid */
+#define DHT11_DATA_VALID                  (bool)(true)
+#define DHT11_DATA_INVALID                (bool)(false)
+
+/**
+ * @brief Structure holding the bytes of one frame, queued by the ISR for dht11_service().
+ *
+ * Members:
+ *  - bytes: Frame bytes (DHT11_FRAME_* indexes).
+ */
+typedef struct
+{
+  uint8_t bytes[DHT11_FRAME_SIZE];
+} dht11_frame_ts;
 
 /**
  * @brief Initializes the DHT11 sensor.
  * 
- * Prepares the DHT11 sensor for reading temperature and humidity.
+ * Releases the data line and enables the falling edge interrupt, the first conversion
+ * is started by the next call of dht11_service().
  */
 void dht11_init();
 
 /**
- * @brief Reads the temperature from the DHT11 sensor.
+ * @brief Returns the temperature of the latest valid frame.
  * 
- * @return float Temperature in Celsius.
+ * @return float Temperature in Celsius or NAN if the latest exchange failed.
  */
 float dht11_readTemperature();
 
 /**
- * @brief Reads the humidity from the DHT11 sensor.
+ * @brief Returns the humidity of the latest valid frame.
  * 
- * @return float Humidity as a percentage.
+ * @return float Humidity as a percentage or NAN if the latest exchange failed.
  */
 float dht11_readHumidity();
 
-#endif
\ No newline at end of file
+/**
+ * @brief Checks if no exchange with the sensor is running.
+ *
+ * @return true between the exchanges, false from the start signal until the frame is checked.
+ */
+bool dht11_isIdle();
+
+/**
+ * @brief Runs the exchange with the sensor.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Starts a conversion every SENSORS_DHT11_CONVERSION_PERIOD_MS,
+ * releases the line after the start signal and checks the frame decoded by the ISR.
+ * Temperature and humidity are taken over together from one frame. The start signal lasts
+ * until the next call, so it is at least DHT11_START_SIGNAL_MS long.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void dht11_service(uint32_t current_millis);
+
+#endif
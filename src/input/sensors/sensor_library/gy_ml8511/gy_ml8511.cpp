@@ -1,19 +1,27 @@
 #include "gy_ml8511.h"
 
+/* STATIC GLOBAL VARIABLES */
+static uint8_t adc_channel = ADC_SAMPLING_INVALID_CHANNEL;
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
 void gy_ml8511_init()
 {
   pinMode(SENSORS_GY_ML8511_PIN_ANALOG, INPUT);
+  adc_channel = adc_sampling_addChannel(SENSORS_GY_ML8511_PIN_ANALOG, SENSORS_GYML8511_ADC_DECIMATION);
 }
 
 float gy_ml8511_readUvIntensity()
 {
-  int analog_value = analogRead(SENSORS_GY_ML8511_PIN_ANALOG);
-  float uv_voltage = ((float)analog_value / GY_ML8511_ANALOG_INPUT_MAX) * GY_ML8511_VCC_VOLTAGE;  //Convert to voltage
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel); // Latest oversampled value, no waiting for the ADC
+  if(ADC_SAMPLING_NO_RESULT == adc_result)
+  {
+    return GY_ML8511_INVALID_VALUE; // No samples yet
+  }
+  float uv_voltage = (ADC_SAMPLING_TO_COUNTS(adc_result) / GY_ML8511_ANALOG_INPUT_MAX) * GY_ML8511_VCC_VOLTAGE;  //Convert to voltage
   
-  // Convert voltage to intensity (UV intensity in mW/cm^2)
-  float calculated_intensity = (float)map(uv_voltage, GY_ML8511_OUTPUT_VOLTAGE_MIN, GY_ML8511_OUTPUT_VOLTAGE_MAX, 
-                                   SENSORS_GYML8511_UV_MIN, SENSORS_GYML8511_UV_MAX);  // range from datasheet
+  // Convert voltage to intensity (UV intensity in mW/cm^2), linear range from datasheet, map() would truncate to integers
+  float calculated_intensity = (uv_voltage - GY_ML8511_OUTPUT_VOLTAGE_MIN) * GY_ML8511_UV_PER_VOLT + SENSORS_GYML8511_UV_MIN;
 
   return calculated_intensity;
 }
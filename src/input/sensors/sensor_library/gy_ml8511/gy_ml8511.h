@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../adc_sampling/adc_sampling.h"
 
 /* Minimum output voltage of the GY-ML8511 UV sensor (in volts) */
 #define GY_ML8511_OUTPUT_VOLTAGE_MIN    (float)(0.99)
@@ -16,6 +17,12 @@
 /* Supply voltage for the GY-ML8511 UV sensor, typically 3.3V */
 #define GY_ML8511_VCC_VOLTAGE           (float)(3.3)
 
+/* Slope of the UV intensity over the output voltage */
+#define GY_ML8511_UV_PER_VOLT           (float)((SENSORS_GYML8511_UV_MAX - SENSORS_GYML8511_UV_MIN) / (GY_ML8511_OUTPUT_VOLTAGE_MAX - GY_ML8511_OUTPUT_VOLTAGE_MIN))
+
+/* Defines the invalid value for the GY-ML8511 sensor readings */
+#define GY_ML8511_INVALID_VALUE         (NAN)
+
 /**
  * @brief Initializes the GY-ML8511 UV sensor.
  * 
@@ -28,7 +35,7 @@ void gy_ml8511_init();
  * 
  * Converts the analog reading to a voltage and then maps it to UV intensity.
  * 
- * @return float UV intensity in mW/cm^2.
+ * @return float UV intensity in mW/cm^2 or GY_ML8511_INVALID_VALUE if no ADC result is available yet.
  */
 float gy_ml8511_readUvIntensity();
 
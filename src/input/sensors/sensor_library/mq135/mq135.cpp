@@ -1,41 +1,105 @@
 #include "mq135.h"
 
+/* STATIC GLOBAL VARIABLES */
+static uint8_t adc_channel = ADC_SAMPLING_INVALID_CHANNEL;
+// Correction of the lookup table for the calibrated R0
+static float ppm_scale = MQ135_PPM_SCALE_UNCALIBRATED;
+
+#if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+// Gas concentration for every MQ_LUT_KNOT_STEP ADC codes, generated at compile time
+static constexpr float ppm_table[MQ_LUT_SIZE] PLATFORM_PROGMEM =
+{
+  MQ_LUT_TABLE_ENTRIES(MQ135_LUT_ENTRY)
+};
+
+// ADC codes of the benchmark, about 12..3800 ppm with the default curve, checked at compile time
+static constexpr uint16_t benchmark_codes[MQ135_BENCHMARK_NUM_OF_CODES] PLATFORM_PROGMEM =
+{
+  MQ_LUT_SEGMENT_MIDDLE_CODE(39u), MQ_LUT_SEGMENT_MIDDLE_CODE(43u), MQ_LUT_SEGMENT_MIDDLE_CODE(47u), MQ_LUT_SEGMENT_MIDDLE_CODE(51u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(55u), MQ_LUT_SEGMENT_MIDDLE_CODE(59u), MQ_LUT_SEGMENT_MIDDLE_CODE(63u), MQ_LUT_SEGMENT_MIDDLE_CODE(67u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(71u), MQ_LUT_SEGMENT_MIDDLE_CODE(75u), MQ_LUT_SEGMENT_MIDDLE_CODE(79u), MQ_LUT_SEGMENT_MIDDLE_CODE(83u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(87u), MQ_LUT_SEGMENT_MIDDLE_CODE(91u), MQ_LUT_SEGMENT_MIDDLE_CODE(95u), MQ_LUT_SEGMENT_MIDDLE_CODE(99u)
+};
+#endif
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+#if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+static_assert(SENSORS_MQ135_R_ZERO >= MQ135_R_ZERO_MINIMUM, "MQ135 R-zero must be at least MQ135_R_ZERO_MINIMUM");
+static_assert(mq_lut_isAccurate(ppm_table, mq135_curvePPM, SENSORS_MQ135_PPM_MIN, SENSORS_MQ135_PPM_MAX, 0u, ADC_SAMPLING_RESULT_MAX),
+              "MQ135 lookup table is not accurate enough inside the measuring range, decrease MQ_LUT_KNOT_SHIFT");
+static_assert(mq_lut_areSamplesAccurate(ppm_table, mq135_curvePPM, SENSORS_MQ135_PPM_MIN, SENSORS_MQ135_PPM_MAX,
+                                        benchmark_codes, MQ135_BENCHMARK_NUM_OF_CODES),
+              "MQ135 benchmark codes must be inside the measuring range and the lookup table must match the curve there");
+static_assert(PROFILING_BENCHMARK_MQ135_POWF_CYCLES == PROFILING_BENCHMARK_MQ135_LOOKUP_CYCLES + 1u &&
+              PROFILING_BENCHMARK_MQ135_ERROR_PPM == PROFILING_BENCHMARK_MQ135_LOOKUP_CYCLES + 2u,
+              "Benchmark slots of the MQ135 must follow each other in the order of mq_lut_runBenchmark()");
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+/**
+ * @brief Float formula of the curve which the lookup table replaces, the reference of the benchmark.
+ *
+ * @param counts ADC counts, limited to MQ135_ANALOG_INPUT_MIN_VALID..MQ135_ANALOG_INPUT_MAX_CURVE.
+ * @return float Gas concentration in PPM for SENSORS_MQ135_R_ZERO.
+ */
+static float mq135_formulaPPM(float counts);
+#endif
+/* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 void mq135_init()
 {
   pinMode(SENSORS_MQ135_PIN_ANALOG, INPUT);
+  adc_channel = adc_sampling_addChannel(SENSORS_MQ135_PIN_ANALOG, SENSORS_MQ135_ADC_DECIMATION);
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+  // Cycles and error of the lookup against powf(), sent with the profiling dump
+  mq_lut_runBenchmark(ppm_table, mq135_formulaPPM, benchmark_codes, MQ135_BENCHMARK_NUM_OF_CODES, PROFILING_BENCHMARK_MQ135_LOOKUP_CYCLES);
+#endif
 }
 
 float mq135_readPPM()
 {
   float ppm = MQ135_INVALID_VALUE;
 #if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
-  int sensor_analog_reading = analogRead(SENSORS_MQ135_PIN_ANALOG); // Read the analog value from the MQ135 sensor pin
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel); // Latest oversampled value, no waiting for the ADC
+  float sensor_analog_reading = ADC_SAMPLING_TO_COUNTS(adc_result);
   
-  if(MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && 
-     MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading && // Check for valid analog read
-     SENSORS_MQ135_R_ZERO >= MQ135_R_ZERO_MINIMUM)      // Check for valid R0 resistance and avoid division by 0
+  if(ADC_SAMPLING_NO_RESULT != adc_result &&
+     MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && 
+     MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading) // Check for valid analog read, R0 is checked at compile time
   {
-    if(MQ135_ANALOG_INPUT_MIN == sensor_analog_reading)
-    {
-      sensor_analog_reading = MQ135_ANALOG_INPUT_MIN_VALID; // To avoid division by 0
-    }
-    float ratio = (float)sensor_analog_reading / SENSORS_MQ135_R_ZERO;
-    ppm = SENSORS_MQ135_PARAMETER_A * pow(ratio, -SENSORS_MQ135_PARAMETER_B); // Calculate PPM with formula
+    ppm = mq_lut_lookup(ppm_table, adc_result) * ppm_scale; // Curve is precomputed, interpolate between two knots
   }
 #endif
   return ppm; // Return calculated PPM or invalid value
 }
 
+void mq135_setResistanceZero(float r_zero)
+{
+  ppm_scale = MQ135_PPM_SCALE_UNCALIBRATED;
+#if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+  if(r_zero >= MQ135_R_ZERO_MINIMUM) // False for NAN as well
+  {
+    ppm_scale = powf(r_zero / SENSORS_MQ135_R_ZERO, SENSORS_MQ135_PARAMETER_B);
+  }
+#else
+  (void)r_zero;
+#endif
+}
+
 float mq135_readResistanceForCalibration()
 {
   float calculated_resistance = MQ135_INVALID_VALUE; // If analog read is not valid
 
-  int sensor_analog_reading = analogRead(SENSORS_MQ135_PIN_ANALOG);
-  if(MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading) // Check for valid analog read
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel);
+  float sensor_analog_reading = ADC_SAMPLING_TO_COUNTS(adc_result);
+  if(ADC_SAMPLING_NO_RESULT != adc_result &&
+     MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading) // Check for valid analog read
   {
-    if(MQ135_ANALOG_INPUT_MIN == sensor_analog_reading)
+    if(MQ135_ANALOG_INPUT_MIN_VALID > sensor_analog_reading)
     {
       sensor_analog_reading = MQ135_ANALOG_INPUT_MIN_VALID; // To avoid division by 0
     }
@@ -45,3 +109,20 @@ float mq135_readResistanceForCalibration()
 }
 /* *************************************** */
 
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+static float mq135_formulaPPM(float counts)
+{
+  if(MQ135_ANALOG_INPUT_MIN_VALID > counts)
+  {
+    counts = MQ135_ANALOG_INPUT_MIN_VALID;
+  }
+  else if(MQ135_ANALOG_INPUT_MAX_CURVE < counts)
+  {
+    counts = MQ135_ANALOG_INPUT_MAX_CURVE;
+  }
+  float ratio = (((float)MQ135_ANALOG_INPUT_MAX / counts) - 1) * MQ135_LOAD_RESISTANCE_VAL / SENSORS_MQ135_R_ZERO; // Rs / R0
+  return SENSORS_MQ135_PARAMETER_A * powf(ratio, -SENSORS_MQ135_PARAMETER_B);
+}
+#endif
+/* *************************************** */
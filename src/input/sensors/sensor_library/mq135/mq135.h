@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../adc_sampling/adc_sampling.h"
+#include "../mq_lut/mq_lut.h"
 
 /* Load resistance in ohms which is connected to from analog output of sensor to ground (default value for the module) */
 #define MQ135_LOAD_RESISTANCE_VAL           (float)(10000)
@@ -14,12 +16,55 @@
 /* Minimum valid analog value to avoid division by zero */
 #define MQ135_ANALOG_INPUT_MIN_VALID        (int)(1)
 
+/* Highest ADC code used for the PPM curve, at the maximum code the sensor resistance is 0 */
+#define MQ135_ANALOG_INPUT_MAX_CURVE        (int)(MQ135_ANALOG_INPUT_MAX - 1)
+
 /* Minimum valid sensor resistance (R0) in ohms */
 #define MQ135_R_ZERO_MINIMUM                (float)(1u)
 
 /* Defines the invalid value for the MQ135 sensor readings */
 #define MQ135_INVALID_VALUE                 (NAN)
 
+/* Scale of the lookup table output while R0 is the one of the table (SENSORS_MQ135_R_ZERO) */
+#define MQ135_PPM_SCALE_UNCALIBRATED        (float)(1)
+
+/* Number of sample codes of the lookup table benchmark, the middle of every fourth segment inside the measuring range */
+#define MQ135_BENCHMARK_NUM_OF_CODES        (uint8_t)(16u)
+
+/* Initializer entry of the PPM lookup table for one knot (see MQ_LUT_TABLE_ENTRIES) */
+#define MQ135_LUT_ENTRY(knot)               (float)(mq135_curvePPM(MQ_LUT_KNOT_COUNTS(knot))),
+
+#if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+/* COMPILE TIME PPM CURVE */
+/**
+ * @brief Exact PPM curve used for generating the lookup table at compile time, ppm = A * (Rs / R0)^-B.
+ *
+ * Sensor resistance Rs is calculated from the voltage divider with MQ135_LOAD_RESISTANCE_VAL, the same way
+ * as mq135_readResistanceForCalibration(), so a calibrated R0 fits the curve.
+ *
+ * @param counts ADC counts, may contain a fractional part, limited to MQ135_ANALOG_INPUT_MIN_VALID..MQ135_ANALOG_INPUT_MAX_CURVE.
+ * @return double Gas concentration in PPM.
+ */
+static constexpr double mq135_curvePPM(double counts)
+{
+    return (MQ135_ANALOG_INPUT_MIN_VALID > counts) ? mq135_curvePPM(MQ135_ANALOG_INPUT_MIN_VALID) :
+           (MQ135_ANALOG_INPUT_MAX_CURVE < counts) ? mq135_curvePPM(MQ135_ANALOG_INPUT_MAX_CURVE) :
+           SENSORS_MQ135_PARAMETER_A * mq_lut_pow((((double)MQ135_ANALOG_INPUT_MAX / counts) - 1.0) * MQ135_LOAD_RESISTANCE_VAL /
+                                                  SENSORS_MQ135_R_ZERO, -SENSORS_MQ135_PARAMETER_B);
+}
+
+/**
+ * @brief Ratio Rs / R0 in clean air, the inverse of the curve at SENSORS_MQ135_ATMOSPHERIC_CO2_PPM.
+ *
+ * @return double Ratio by which the resistance measured in clean air is divided to get R0.
+ */
+static constexpr double mq135_clearAirRatio()
+{
+    return mq_lut_pow(SENSORS_MQ135_ATMOSPHERIC_CO2_PPM / SENSORS_MQ135_PARAMETER_A, -1.0 / SENSORS_MQ135_PARAMETER_B);
+}
+/* ********************************* */
+#endif
+
 /**
  * @brief Initializes the MQ135 sensor.
  * 
@@ -40,6 +85,16 @@ void mq135_init();
  */
 float mq135_readPPM();
 
+/**
+ * @brief Sets the R0 which is used by mq135_readPPM() instead of SENSORS_MQ135_R_ZERO.
+ *
+ * The lookup table stays the one of SENSORS_MQ135_R_ZERO, for a different R0 its output is
+ * multiplied by (R0 / SENSORS_MQ135_R_ZERO)^B, which is computed here once.
+ *
+ * @param r_zero Calibrated R0 in ohms, values below MQ135_R_ZERO_MINIMUM (or NAN) restore SENSORS_MQ135_R_ZERO.
+ */
+void mq135_setResistanceZero(float r_zero);
+
 /**
  * @brief Calculates the sensor's \( R0 \) value during calibration.
  * 
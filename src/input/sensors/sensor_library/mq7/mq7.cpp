@@ -1,42 +1,76 @@
 #include "mq7.h"
 
 /* STATIC GLOBAL VARIABLES */
-// Global variable for heater status
-static bool mq7_is_heater_hot = MQ7_HEATER_IS_OFF;
+// Heater phase state, updated from the Timer1 overflow interrupt
+static volatile uint8_t heater_phase = MQ7_HEATER_PHASE_HIGH;
+static volatile uint16_t heater_phase_ticks_left = MQ7_HEATER_HIGH_TICKS;
+// Latest CO sample taken at the end of the low phase
+static float latched_co_ppm = MQ7_INVALID_VALUE;
+static bool sample_taken = MQ7_SAMPLE_NOT_TAKEN;
+static uint8_t adc_channel = ADC_SAMPLING_INVALID_CHANNEL;
+// Correction of the lookup table for the calibrated R0
+static float ppm_scale = MQ7_PPM_SCALE_UNCALIBRATED;
+
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+// CO concentration for every MQ_LUT_KNOT_STEP ADC codes, generated at compile time
+static constexpr float ppm_table[MQ_LUT_SIZE] PLATFORM_PROGMEM =
+{
+  MQ_LUT_TABLE_ENTRIES(MQ7_LUT_ENTRY)
+};
+
+// ADC codes of the benchmark, about 19..650 ppm with the default curve, checked at compile time
+static constexpr uint16_t benchmark_codes[MQ7_BENCHMARK_NUM_OF_CODES] PLATFORM_PROGMEM =
+{
+  MQ_LUT_SEGMENT_MIDDLE_CODE(52u), MQ_LUT_SEGMENT_MIDDLE_CODE(54u), MQ_LUT_SEGMENT_MIDDLE_CODE(56u), MQ_LUT_SEGMENT_MIDDLE_CODE(58u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(60u), MQ_LUT_SEGMENT_MIDDLE_CODE(62u), MQ_LUT_SEGMENT_MIDDLE_CODE(64u), MQ_LUT_SEGMENT_MIDDLE_CODE(66u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(68u), MQ_LUT_SEGMENT_MIDDLE_CODE(70u), MQ_LUT_SEGMENT_MIDDLE_CODE(72u), MQ_LUT_SEGMENT_MIDDLE_CODE(74u),
+  MQ_LUT_SEGMENT_MIDDLE_CODE(76u), MQ_LUT_SEGMENT_MIDDLE_CODE(78u), MQ_LUT_SEGMENT_MIDDLE_CODE(80u), MQ_LUT_SEGMENT_MIDDLE_CODE(82u)
+};
+#endif
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(MQ7_TIMER1_OC1A_PIN == SENSORS_MQ7_PIN_PWM_HEATER, "MQ7 heater must be connected to OC1A (pin 9), Timer1 generates its PWM");
+static_assert(MQ7_SAMPLE_WINDOW_TICKS > 0u && MQ7_SAMPLE_WINDOW_TICKS < MQ7_HEATER_LOW_TICKS, "MQ7 sample window must be shorter than the low heater phase");
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+static_assert(SENSORS_MQ7_R_ZERO > 0, "MQ7 R-zero must be positive");
+static_assert(mq_lut_isAccurate(ppm_table, mq7_curvePPM, SENSORS_MQ7_PPM_MIN, SENSORS_MQ7_PPM_MAX, 0u, ADC_SAMPLING_RESULT_MAX),
+              "MQ7 lookup table is not accurate enough inside the measuring range, decrease MQ_LUT_KNOT_SHIFT");
+static_assert(mq_lut_areSamplesAccurate(ppm_table, mq7_curvePPM, SENSORS_MQ7_PPM_MIN, SENSORS_MQ7_PPM_MAX,
+                                        benchmark_codes, MQ7_BENCHMARK_NUM_OF_CODES),
+              "MQ7 benchmark codes must be inside the measuring range and the lookup table must match the curve there");
+static_assert(PROFILING_BENCHMARK_MQ7_POWF_CYCLES == PROFILING_BENCHMARK_MQ7_LOOKUP_CYCLES + 1u &&
+              PROFILING_BENCHMARK_MQ7_ERROR_PPM == PROFILING_BENCHMARK_MQ7_LOOKUP_CYCLES + 2u,
+              "Benchmark slots of the MQ7 must follow each other in the order of mq_lut_runBenchmark()");
+#endif
 /* *************************************** */
 
 /* STATIC FUNCTION PROTOTYPES */
 /** 
- * @brief Converts raw ADC reading to resistance value.
+ * @brief Calculates CO concentration from the latest ADC result using the precomputed lookup table.
  * 
- * This function takes the raw ADC value from the MQ7 sensor and converts it to a resistance value
- * using the sensor's voltage and a predefined load resistance. It avoids division by zero by adjusting 
- * the raw ADC value when it's equal to the minimum.
- * 
- * @param raw_adc The raw ADC value from the MQ7 sensor.
- * @return float The calculated resistance in ohms.
+ * @return float The carbon monoxide concentration in PPM or NaN if calibration parameters are missing or invalid.
  */
-static float convertToResistance(int raw_adc);
+static float calculatePPM();
 
 /** 
- * @brief Turns the heater on for the MQ7 sensor.
+ * @brief Sets the heater voltage for the given phase.
  * 
- * This function sets the heater of the MQ7 sensor to 5V, enabling it to start heating. 
- * It returns a status indicating that the heater is on.
+ * Compare register is double buffered by hardware, so the new duty cycle starts with the next PWM period.
  * 
- * @return bool The status of the heater (true if on).
+ * @param phase MQ7_HEATER_PHASE_HIGH (5V) or MQ7_HEATER_PHASE_LOW (1.4V).
  */
-static bool heaterOn();
+static void setHeaterPhase(uint8_t phase);
 
-/** 
- * @brief Turns the heater off for the MQ7 sensor.
- * 
- * This function sets the heater of the MQ7 sensor to 1.4V, turning it off. 
- * It returns a status indicating that the heater is off.
- * 
- * @return bool The status of the heater (true if off).
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+/**
+ * @brief Float formula of the CO curve which the lookup table replaces, the reference of the benchmark.
+ *
+ * @param counts ADC counts, limited to MQ7_ANALOG_INPUT_MIN_VALID..MQ7_ANALOG_INPUT_MAX_CURVE.
+ * @return float CO concentration in PPM for SENSORS_MQ7_R_ZERO.
  */
-static bool heaterOff();
+static float mq7_formulaPPM(float counts);
+#endif
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -44,34 +78,72 @@ void mq7_init()
 {
   pinMode(SENSORS_MQ7_PIN_ANALOG, INPUT);
   pinMode(SENSORS_MQ7_PIN_PWM_HEATER, OUTPUT);
-  mq7_is_heater_hot = heaterOn(); //Start heating
+  adc_channel = adc_sampling_addChannel(SENSORS_MQ7_PIN_ANALOG, SENSORS_MQ7_ADC_DECIMATION);
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    // Fast PWM mode 14 (TOP = ICR1), non-inverting output on OC1A, prescaler 8
+    TCCR1A = _BV(COM1A1) | _BV(WGM11);
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);
+    ICR1 = MQ7_TIMER1_TOP;
+    TCNT1 = 0u;
+
+    setHeaterPhase(MQ7_HEATER_PHASE_HIGH); // Start heating
+    heater_phase_ticks_left = MQ7_HEATER_HIGH_TICKS;
+    sample_taken = MQ7_SAMPLE_NOT_TAKEN;
+
+    TIMSK1 |= _BV(TOIE1); // Phase time base
+  }
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+  // Cycles and error of the lookup against powf(), sent with the profiling dump
+  mq_lut_runBenchmark(ppm_table, mq7_formulaPPM, benchmark_codes, MQ7_BENCHMARK_NUM_OF_CODES, PROFILING_BENCHMARK_MQ7_LOOKUP_CYCLES);
+#endif
 }
 
 float mq7_readPPM()
 {
-  float coPPM = MQ7_INVALID_VALUE; // Return value in case of not defined macros(handled by sensors module)
-#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2) // All parameters must be defined
-  int raw_analog_read = analogRead(SENSORS_MQ7_PIN_ANALOG);
-  if(raw_analog_read >= MQ7_ANALOG_INPUT_MIN && raw_analog_read <= MQ7_ANALOG_INPUT_MAX) // Check for valid analog read
+  return latched_co_ppm;
+}
+
+void mq7_setResistanceZero(float r_zero)
+{
+  ppm_scale = MQ7_PPM_SCALE_UNCALIBRATED;
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+  if(r_zero > 0) // False for NAN as well
   {
-    float resistance_under_CO = convertToResistance(raw_analog_read); // Convert analog read to resistance in ohms
-    float ratio = resistance_under_CO / SENSORS_MQ7_R_ZERO; // Calculate ratio based on calibrated resistance in clear air
-    /* Function for calculating PPM */
-    coPPM = pow(MQ7_CALCULATION_POW_BASE_CONSTANT, ((log10(ratio) - SENSORS_MQ7_CALCULATION_CONSTANT_1) / (SENSORS_MQ7_CALCULATION_CONSTANT_2)));
+    ppm_scale = powf(r_zero / SENSORS_MQ7_R_ZERO, -1.0f / SENSORS_MQ7_CALCULATION_CONSTANT_2);
   }
+#else
+  (void)r_zero;
 #endif
-  return coPPM;
+}
+
+uint8_t mq7_getHeaterPhase()
+{
+  return heater_phase; // Single byte, read is atomic
+}
+
+unsigned long mq7_getPhaseTimeLeftMs()
+{
+  uint16_t ticks_left;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    ticks_left = heater_phase_ticks_left;
+  }
+  return (unsigned long)ticks_left * MQ7_TIMER_TICK_MS;
 }
 
 float mq7_readResistanceForCalibration()
 {
   float calculated_resistance = MQ7_INVALID_VALUE; // Default invalid value
 
-  int sensor_analog_reading = analogRead(SENSORS_MQ7_PIN_ANALOG);
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel);
+  float sensor_analog_reading = ADC_SAMPLING_TO_COUNTS(adc_result);
   
-  if (MQ7_ANALOG_INPUT_MIN <= sensor_analog_reading && sensor_analog_reading <= MQ7_ANALOG_INPUT_MAX) // Ensure valid reading
+  if (ADC_SAMPLING_NO_RESULT != adc_result &&
+      MQ7_ANALOG_INPUT_MIN <= sensor_analog_reading && sensor_analog_reading <= MQ7_ANALOG_INPUT_MAX) // Ensure valid reading
   {
-    if (sensor_analog_reading == MQ7_ANALOG_INPUT_MIN)
+    if (sensor_analog_reading < MQ7_ANALOG_INPUT_MIN_VALID)
     {
       sensor_analog_reading = MQ7_ANALOG_INPUT_MIN_VALID; // Avoid division by zero
     }
@@ -85,45 +157,91 @@ float mq7_readResistanceForCalibration()
 // Needs to be called in loop
 void mq7_heatingCycle(unsigned long current_millis) 
 {
-  static unsigned long previous_millis = 0;
-  unsigned long elapsed_time = current_millis - previous_millis; // Elapsed time between last transition from high to low or low to high till now
+  (void)current_millis; // Phases are timed by Timer1
 
-  // If the heater has been in the high state for the specified duration and is currently hot
-  if (elapsed_time >= SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS && MQ7_HEATER_IS_ON == mq7_is_heater_hot) // Case heater 
+  if (MQ7_HEATER_PHASE_LOW == mq7_getHeaterPhase())
   {
-    mq7_is_heater_hot = heaterOff(); // Turn the heater off
-    previous_millis = current_millis; // Update the last transition time
-  } 
-  // If the heater has been in the low state for the specified duration and is currently off
-  else if (elapsed_time >= SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS && MQ7_HEATER_IS_OFF == mq7_is_heater_hot) 
+    // Sample once, as late in the low phase as possible
+    if (MQ7_SAMPLE_NOT_TAKEN == sample_taken && mq7_getPhaseTimeLeftMs() <= SENSORS_MQ7_SAMPLE_WINDOW_MS)
+    {
+      latched_co_ppm = calculatePPM();
+      sample_taken = MQ7_SAMPLE_TAKEN;
+    }
+  }
+  else
   {
-    mq7_is_heater_hot = heaterOn(); // Turn the heater on
-    previous_millis = current_millis; // Update the last transition time
+    sample_taken = MQ7_SAMPLE_NOT_TAKEN; // Arm sampling for the next low phase
+  }
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(TIMER1_OVF_vect)
+{
+  if (0u < heater_phase_ticks_left)
+  {
+    heater_phase_ticks_left--;
+  }
+
+  if (0u == heater_phase_ticks_left)
+  {
+    if (MQ7_HEATER_PHASE_HIGH == heater_phase)
+    {
+      setHeaterPhase(MQ7_HEATER_PHASE_LOW);
+      heater_phase_ticks_left = MQ7_HEATER_LOW_TICKS;
+    }
+    else
+    {
+      setHeaterPhase(MQ7_HEATER_PHASE_HIGH);
+      heater_phase_ticks_left = MQ7_HEATER_HIGH_TICKS;
+    }
   }
 }
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
-static float convertToResistance(int raw_adc) 
+static float calculatePPM()
 {
-  if(MQ7_ANALOG_INPUT_MIN == raw_adc)
+  float coPPM = MQ7_INVALID_VALUE; // Return value in case of not defined macros(handled by sensors module)
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2) // All parameters must be defined
+  uint16_t adc_result = adc_sampling_getLatest(adc_channel); // Latest oversampled value, no waiting for the ADC
+  float raw_analog_read = ADC_SAMPLING_TO_COUNTS(adc_result);
+  if(ADC_SAMPLING_NO_RESULT != adc_result &&
+     raw_analog_read >= MQ7_ANALOG_INPUT_MIN && raw_analog_read <= MQ7_ANALOG_INPUT_MAX) // Check for valid analog read
   {
-    raw_adc += 1; // To avoid division by 0
+    coPPM = mq_lut_lookup(ppm_table, adc_result) * ppm_scale; // Curve is precomputed, interpolate between two knots
   }
-  float v_out = raw_adc * (MQ7_VCC_VOLTAGE / MQ7_ANALOG_INPUT_MAX);
-  float Rs = ((MQ7_VCC_VOLTAGE - v_out) / v_out) * MQ7_LOAD_RESISTANCE_VAL; // return in ohms
-  return Rs;
+#endif
+  return coPPM;
 }
 
-static bool heaterOn()
+static void setHeaterPhase(uint8_t phase)
 {
-  analogWrite(SENSORS_MQ7_PIN_PWM_HEATER, MQ7_5V_ANALOG_OUTPUT_HEATER);   // Set heater to 5V
-  return MQ7_HEATER_IS_ON;
+  if (MQ7_HEATER_PHASE_HIGH == phase)
+  {
+    OCR1A = MQ7_5V_HEATER_COMPARE;   // Set heater to 5V
+  }
+  else
+  {
+    OCR1A = MQ7_1_4V_HEATER_COMPARE; // Set heater to 1.4V (approx)
+  }
+  heater_phase = phase;
 }
 
-static bool heaterOff()
+#if defined(PROFILING_COMPONENT) && defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+static float mq7_formulaPPM(float counts)
 {
-  analogWrite(SENSORS_MQ7_PIN_PWM_HEATER, MQ7_1_4V_ANALOG_OUTPUT_HEATER); // Set heater to 1.4V (approx)
-  return MQ7_HEATER_IS_OFF;
+  if(MQ7_ANALOG_INPUT_MIN_VALID > counts)
+  {
+    counts = MQ7_ANALOG_INPUT_MIN_VALID;
+  }
+  else if(MQ7_ANALOG_INPUT_MAX_CURVE < counts)
+  {
+    counts = MQ7_ANALOG_INPUT_MAX_CURVE;
+  }
+  float v_out = counts * (MQ7_VCC_VOLTAGE / MQ7_ANALOG_INPUT_MAX);
+  float ratio = ((MQ7_VCC_VOLTAGE - v_out) / v_out) * MQ7_LOAD_RESISTANCE_VAL / SENSORS_MQ7_R_ZERO; // Rs / R0
+  return powf(10.0f, (log10f(ratio) - SENSORS_MQ7_CALCULATION_CONSTANT_1) / SENSORS_MQ7_CALCULATION_CONSTANT_2);
 }
-/* *************************************** */
\ No newline at end of file
+#endif
+/* *************************************** */
@@ -2,7 +2,12 @@
 #define MQ7_H
 
 #include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "../sensors_config.h"
+#include "../adc_sampling/adc_sampling.h"
+#include "../mq_lut/mq_lut.h"
 
 /* Maximum value of the analog input reading (10-bit ADC resolution). */
 #define MQ7_ANALOG_INPUT_MAX              (int)(1023)
@@ -13,47 +18,132 @@
 /* Minimum valid analog value to avoid division by zero */
 #define MQ7_ANALOG_INPUT_MIN_VALID        (int)(1)
 
-/* Analog output value for the heater at 5V. */
-#define MQ7_5V_ANALOG_OUTPUT_HEATER       (int)(1023u)  
+/**
+ * Heater PWM is generated by Timer1 in fast PWM mode 14 (TOP = ICR1) on OC1A,
+ * and the Timer1 overflow interrupt is the time base of the heater phases.
+ * With prescaler 8 and TOP 19999 the PWM runs at 100 Hz, so one overflow is exactly 10 ms.
+ */
+#define MQ7_TIMER1_OC1A_PIN               (uint8_t)(9u)
+#define MQ7_TIMER1_TOP                    (uint16_t)(19999u)
+#define MQ7_TIMER_TICK_MS                 (unsigned long)(10u)
+
+/* Timer1 compare values for the heater at 5V and at 1.4V (1.4V / 5V of the period). */
+#define MQ7_5V_HEATER_COMPARE             (uint16_t)(MQ7_TIMER1_TOP)
+#define MQ7_1_4V_HEATER_COMPARE           (uint16_t)(((uint32_t)MQ7_TIMER1_TOP * 14u) / 50u)
+
+/* Heater phase durations in timer ticks. */
+#define MQ7_HEATER_HIGH_TICKS             (uint16_t)(SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS / MQ7_TIMER_TICK_MS)
+#define MQ7_HEATER_LOW_TICKS              (uint16_t)(SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS / MQ7_TIMER_TICK_MS)
+#define MQ7_SAMPLE_WINDOW_TICKS           (uint16_t)(SENSORS_MQ7_SAMPLE_WINDOW_MS / MQ7_TIMER_TICK_MS)
 
-/* Analog output value for the heater at 1.4V. */
-#define MQ7_1_4V_ANALOG_OUTPUT_HEATER     (int)(71u)   
+/* Heater phases. CO concentration is valid only at the end of the low (1.4V) phase. */
+#define MQ7_HEATER_PHASE_HIGH             (uint8_t)(0u)
+#define MQ7_HEATER_PHASE_LOW              (uint8_t)(1u)
 
 /* The supply voltage of the sensor (5V). */
 #define MQ7_VCC_VOLTAGE                   (float)(5)
 
-/* Heater flags. */
-#define MQ7_HEATER_IS_ON                  (bool)(true)
-#define MQ7_HEATER_IS_OFF                 (bool)(false)
+/* Flags indicating if the CO sample of the current low phase is taken. */
+#define MQ7_SAMPLE_TAKEN                  (bool)(true)
+#define MQ7_SAMPLE_NOT_TAKEN              (bool)(false)
 
 /* Load resistance value in ohms, connected between the analog output of the sensor and ground (based on datasheet). */
 #define MQ7_LOAD_RESISTANCE_VAL           (float)(10000) // Load resistance in ohms
 
-/* Base constant for the calculation of CO PPM, used in logarithmic equation. */
-#define MQ7_CALCULATION_POW_BASE_CONSTANT (float)(10)
+/* Highest ADC code used for the CO curve, at the maximum code the sensor resistance is 0 and the logarithm is undefined. */
+#define MQ7_ANALOG_INPUT_MAX_CURVE        (int)(MQ7_ANALOG_INPUT_MAX - 1)
 
 /* Defines the invalid value for the MQ7 sensor readings */
 #define MQ7_INVALID_VALUE                 (NAN)
 
+/* Scale of the lookup table output while R0 is the one of the table (SENSORS_MQ7_R_ZERO). */
+#define MQ7_PPM_SCALE_UNCALIBRATED        (float)(1)
+
+/* Number of sample codes of the lookup table benchmark, the middle of every second segment inside the measuring range. */
+#define MQ7_BENCHMARK_NUM_OF_CODES        (uint8_t)(16u)
+
+/* Initializer entry of the CO lookup table for one knot (see MQ_LUT_TABLE_ENTRIES). */
+#define MQ7_LUT_ENTRY(knot)               (float)(mq7_curvePPM(MQ_LUT_KNOT_COUNTS(knot))),
+
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+/* COMPILE TIME CO CURVE */
+/**
+ * @brief CO concentration for a resistance ratio, ppm = 10^((log10(Rs / R0) - C1) / C2).
+ *
+ * @param ratio Sensor resistance divided by the calibrated resistance in clear air.
+ */
+static constexpr double mq7_curvePPMFromRatio(double ratio)
+{
+    return mq_lut_exp(MQ_LUT_LN_10 * ((mq_lut_ln(ratio) / MQ_LUT_LN_10 - SENSORS_MQ7_CALCULATION_CONSTANT_1) /
+                                      SENSORS_MQ7_CALCULATION_CONSTANT_2));
+}
+
+/**
+ * @brief Exact CO curve used for generating the lookup table at compile time.
+ *
+ * Sensor resistance is calculated from the voltage divider with MQ7_LOAD_RESISTANCE_VAL,
+ * ADC counts are limited to MQ7_ANALOG_INPUT_MIN_VALID..MQ7_ANALOG_INPUT_MAX_CURVE.
+ *
+ * @param counts ADC counts, may contain a fractional part.
+ * @return double CO concentration in PPM.
+ */
+static constexpr double mq7_curvePPM(double counts)
+{
+    return (MQ7_ANALOG_INPUT_MIN_VALID > counts) ? mq7_curvePPM(MQ7_ANALOG_INPUT_MIN_VALID) :
+           (MQ7_ANALOG_INPUT_MAX_CURVE < counts) ? mq7_curvePPM(MQ7_ANALOG_INPUT_MAX_CURVE) :
+           mq7_curvePPMFromRatio((((MQ7_VCC_VOLTAGE - counts * (MQ7_VCC_VOLTAGE / MQ7_ANALOG_INPUT_MAX)) /
+                                   (counts * (MQ7_VCC_VOLTAGE / MQ7_ANALOG_INPUT_MAX))) * MQ7_LOAD_RESISTANCE_VAL) /
+                                 SENSORS_MQ7_R_ZERO);
+}
+/* ********************************* */
+#endif
+
 /**
  * @brief Initialize the MQ7 sensor by setting up the necessary pins and starting the heating cycle.
  *
- * This function configures the analog input pin for reading sensor data and the PWM output pin for controlling the heater.
- * It then turns on the heater to start the sensor's heating process, preparing it for measurements.
+ * This function configures the analog input pin for reading sensor data and Timer1 for generating
+ * the heater PWM. The heater phases are switched from the Timer1 overflow interrupt, so they
+ * do not drift with the main loop. Heating starts with the high (5V) phase.
  */
 void mq7_init();
 
 /**
- * @brief Reads the carbon monoxide concentration in parts per million (PPM) using the MQ7 sensor.
+ * @brief Returns the carbon monoxide concentration in parts per million (PPM) using the MQ7 sensor.
  *
- * This function reads the analog value from the MQ7 sensor, converts it to resistance, and calculates the carbon monoxide
- * concentration in PPM based on predefined calibration constants. If the necessary constants or analog input range are 
- * not defined or invalid, the function returns NaN.
+ * The concentration is sampled only once per heater cycle, at the end of the low (1.4V) phase
+ * (see mq7_heatingCycle()). This function returns the latest such sample, so it can be called at any time.
+ * If the necessary constants or analog input range are not defined or invalid, or the first heater cycle
+ * has not finished yet, the function returns NaN.
  *
- * @return float The carbon monoxide concentration in PPM or NaN if calibration parameters are missing or invalid.
+ * @return float The carbon monoxide concentration in PPM or NaN if there is no valid sample.
  */
 float mq7_readPPM();
 
+/**
+ * @brief Sets the R0 which is used for the CO samples instead of SENSORS_MQ7_R_ZERO.
+ *
+ * The lookup table stays the one of SENSORS_MQ7_R_ZERO, for a different R0 its output is
+ * multiplied by (R0 / SENSORS_MQ7_R_ZERO)^(-1 / C2), which is computed here once.
+ * The latched sample is corrected from the next low heater phase on.
+ *
+ * @param r_zero Calibrated R0 in ohms, values which are not positive (or NAN) restore SENSORS_MQ7_R_ZERO.
+ */
+void mq7_setResistanceZero(float r_zero);
+
+/**
+ * @brief Returns the current heater phase.
+ *
+ * @return uint8_t MQ7_HEATER_PHASE_HIGH or MQ7_HEATER_PHASE_LOW.
+ */
+uint8_t mq7_getHeaterPhase();
+
+/**
+ * @brief Returns the time left until the current heater phase ends.
+ *
+ * @return unsigned long Time in milliseconds, with the resolution of MQ7_TIMER_TICK_MS.
+ */
+unsigned long mq7_getPhaseTimeLeftMs();
+
 /**
  * @brief Reads the resistance of the MQ-7 sensor for calibration.
  *
@@ -65,12 +155,13 @@ float mq7_readPPM();
 float mq7_readResistanceForCalibration();
 
 /**
- * @brief Handles the heating cycle for the MQ-7 sensor.
+ * @brief Samples the CO concentration when the end of the low heater phase is reached.
  * 
- * Alternates between heating (high state) and cooling (low state) phases based on time intervals.
- * NEEDS TO BE CALLED IN A LOOP.
+ * Phase switching itself is done by the Timer1 interrupt, this function only takes the
+ * ADC sample once per cycle inside the last SENSORS_MQ7_SAMPLE_WINDOW_MS of the low phase.
+ * NEEDS TO BE CALLED IN A LOOP at least once per SENSORS_MQ7_SAMPLE_WINDOW_MS.
  * 
- * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @param current_millis The current time in milliseconds (e.g., from millis()), unused.
  */
 void mq7_heatingCycle(unsigned long current_millis);
 
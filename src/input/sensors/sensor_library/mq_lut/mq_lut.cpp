@@ -0,0 +1,64 @@
+#include "mq_lut.h"
+
+/* COMPILE TIME CHECKS */
+static_assert(ADC_SAMPLING_ADC_MAX < MQ_LUT_NUM_OF_SEGMENTS * MQ_LUT_KNOT_STEP, "Every ADC code must have an upper knot for the interpolation");
+static_assert(128u == MQ_LUT_NUM_OF_SEGMENTS, "MQ_LUT_TABLE_ENTRIES expands exactly 128 segments, update it together with MQ_LUT_KNOT_SHIFT");
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+float mq_lut_lookup(const float *table, uint16_t adc_result)
+{
+  if(ADC_SAMPLING_RESULT_MAX < adc_result)
+  {
+    adc_result = ADC_SAMPLING_RESULT_MAX;
+  }
+
+  uint8_t knot = (uint8_t)(adc_result >> MQ_LUT_INDEX_SHIFT);
+  float lower = PLATFORM_READ_FLOAT(&table[knot]);
+  float upper = PLATFORM_READ_FLOAT(&table[knot + 1u]);
+  float fraction = (float)(adc_result & MQ_LUT_FRACTION_MASK) * MQ_LUT_FRACTION_SCALE;
+
+  return lower + (upper - lower) * fraction;
+}
+
+#ifdef PROFILING_COMPONENT
+void mq_lut_runBenchmark(const float *table, mq_lut_formula_fn formula, const uint16_t *codes, uint8_t num_of_codes, uint8_t first_index)
+{
+  volatile float result; // Results are stored, so the timed conversions are not optimized away
+  float max_error = 0.0f;
+
+  for (uint8_t pass = 0u; pass < MQ_LUT_BENCHMARK_PASSES; pass++)
+  {
+    PROFILING_START(lookup_start);
+    for (uint8_t code_index = 0u; code_index < num_of_codes; code_index++)
+    {
+      result = mq_lut_lookup(table, PLATFORM_READ_WORD(&codes[code_index]));
+    }
+    uint32_t lookup_us = micros() - lookup_start; // Overflow safe
+
+    PROFILING_START(formula_start);
+    for (uint8_t code_index = 0u; code_index < num_of_codes; code_index++)
+    {
+      result = formula(ADC_SAMPLING_TO_COUNTS(PLATFORM_READ_WORD(&codes[code_index])));
+    }
+    uint32_t formula_us = micros() - formula_start;
+
+    profiling_recordValue(PROFILING_GROUP_BENCHMARKS, first_index, lookup_us * MQ_LUT_CYCLES_PER_US / num_of_codes, MQ_LUT_BENCHMARK_NO_LIMIT);
+    profiling_recordValue(PROFILING_GROUP_BENCHMARKS, (uint8_t)(first_index + 1u), formula_us * MQ_LUT_CYCLES_PER_US / num_of_codes,
+                          MQ_LUT_BENCHMARK_NO_LIMIT);
+  }
+  (void)result;
+
+  // Error against the formula which the table replaces, outside of the timed loops
+  for (uint8_t code_index = 0u; code_index < num_of_codes; code_index++)
+  {
+    uint16_t code = PLATFORM_READ_WORD(&codes[code_index]);
+    float exact = formula(ADC_SAMPLING_TO_COUNTS(code));
+    float error = fabsf(mq_lut_lookup(table, code) - exact) / exact;
+    max_error = (error > max_error) ? error : max_error;
+  }
+  profiling_recordValue(PROFILING_GROUP_BENCHMARKS, (uint8_t)(first_index + 2u), (uint32_t)(max_error * MQ_LUT_ERROR_PPM_SCALE),
+                        (uint32_t)(MQ_LUT_MAX_RELATIVE_ERROR * MQ_LUT_ERROR_PPM_SCALE));
+}
+#endif
+/* *************************************** */
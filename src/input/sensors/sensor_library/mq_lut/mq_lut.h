@@ -0,0 +1,240 @@
+#ifndef MQ_LUT_H
+#define MQ_LUT_H
+
+#include <Arduino.h>
+#include "../../../../platform/platform.h"
+#include "../adc_sampling/adc_sampling.h"
+#include "../../../../profiling/profiling.h"
+
+/**
+ * @file mq_lut.h
+ * @brief Compile time generated lookup tables for the ppm curves of the MQ gas sensors.
+ *
+ * The ppm curve of a sensor depends only on the ADC code, so it is evaluated at compile time
+ * (C++11 constexpr math below) for every MQ_LUT_KNOT_STEP ADC codes and stored in program memory.
+ * At runtime the oversampled ADC result is used directly as the table index and the value between
+ * two knots is linearly interpolated from the fractional part, so a reading costs two flash reads
+ * and one multiplication instead of pow()/log10().
+ *
+ * The accuracy of a table is checked at compile time against the exact curve for every ADC result and for the
+ * sample codes of its benchmark, which must all lie inside the measuring range. With PROFILING_COMPONENT the
+ * benchmark also runs on the target once at init: the sample codes are converted with the table and with the
+ * float formula it replaces (powf()), the CPU cycles of one conversion and the largest relative error are
+ * recorded in PROFILING_GROUP_BENCHMARKS and sent with the profiling dump.
+ */
+
+/* Distance between two knots of the table in ADC codes (power of two) */
+#define MQ_LUT_KNOT_SHIFT                (uint8_t)(3u)
+#define MQ_LUT_KNOT_STEP                 (uint16_t)(1u << MQ_LUT_KNOT_SHIFT)
+
+/* Number of knots, one more than the number of segments so the last segment has an upper knot */
+#define MQ_LUT_NUM_OF_SEGMENTS           (uint16_t)((ADC_SAMPLING_ADC_MAX + 1u) / MQ_LUT_KNOT_STEP)
+#define MQ_LUT_SIZE                      (uint16_t)(MQ_LUT_NUM_OF_SEGMENTS + 1u)
+
+/* Oversampled ADC result is split into the knot index (upper bits) and the position inside the segment (lower bits) */
+#define MQ_LUT_INDEX_SHIFT               (uint8_t)(MQ_LUT_KNOT_SHIFT + ADC_SAMPLING_EXTRA_BITS)
+#define MQ_LUT_FRACTION_MASK             (uint16_t)((1u << MQ_LUT_INDEX_SHIFT) - 1u)
+#define MQ_LUT_FRACTION_SCALE            (float)(1.0f / (float)(1u << MQ_LUT_INDEX_SHIFT))
+
+/* ADC code (in counts) of a knot */
+#define MQ_LUT_KNOT_COUNTS(knot)         (double)((knot) * MQ_LUT_KNOT_STEP)
+
+/* Maximum relative error of the interpolation inside the measuring range of a sensor, checked at compile time */
+#define MQ_LUT_MAX_RELATIVE_ERROR        (double)(0.005)
+
+/* Sample code of a benchmark in the middle of the segment above a knot, where the interpolation error is the largest */
+#define MQ_LUT_SEGMENT_MIDDLE_CODE(knot) (uint16_t)(((knot) << MQ_LUT_INDEX_SHIFT) + (1u << (MQ_LUT_INDEX_SHIFT - 1u)))
+
+/* Passes of the benchmark over its sample codes, the time of a pass is split over the codes (micros() counts in 4 us) */
+#define MQ_LUT_BENCHMARK_PASSES          (uint8_t)(8u)
+/* CPU cycles per microsecond, the recorded time of a conversion is converted to cycles */
+#define MQ_LUT_CYCLES_PER_US             (uint32_t)(F_CPU / 1000000u)
+/* Cycles of a conversion are never an overrun, the error is one above MQ_LUT_MAX_RELATIVE_ERROR */
+#define MQ_LUT_BENCHMARK_NO_LIMIT        (uint32_t)(UINT32_MAX)
+/* Relative error is recorded in parts per million */
+#define MQ_LUT_ERROR_PPM_SCALE           (double)(1000000.0)
+
+/* Number of terms of the series used by the constexpr math, enough for float precision */
+#define MQ_LUT_LN_SERIES_TERMS           (uint8_t)(8u)
+#define MQ_LUT_EXP_SERIES_TERMS          (uint8_t)(12u)
+#define MQ_LUT_LN_2                      (double)(0.69314718055994531)
+#define MQ_LUT_LN_10                     (double)(2.30258509299404568)
+
+/**
+ * Macros that expand an initializer for all MQ_LUT_SIZE knots, entry(knot) is expanded for
+ * knots 0..MQ_LUT_NUM_OF_SEGMENTS and must expand to a value followed by a comma.
+ */
+#define MQ_LUT_REPEAT_8(entry, knot)     entry((knot)) entry((knot) + 1u) entry((knot) + 2u) entry((knot) + 3u) \
+                                         entry((knot) + 4u) entry((knot) + 5u) entry((knot) + 6u) entry((knot) + 7u)
+#define MQ_LUT_REPEAT_32(entry, knot)    MQ_LUT_REPEAT_8(entry, (knot)) MQ_LUT_REPEAT_8(entry, (knot) + 8u) \
+                                         MQ_LUT_REPEAT_8(entry, (knot) + 16u) MQ_LUT_REPEAT_8(entry, (knot) + 24u)
+#define MQ_LUT_TABLE_ENTRIES(entry)      MQ_LUT_REPEAT_32(entry, 0u) MQ_LUT_REPEAT_32(entry, 32u) \
+                                         MQ_LUT_REPEAT_32(entry, 64u) MQ_LUT_REPEAT_32(entry, 96u) \
+                                         entry(MQ_LUT_NUM_OF_SEGMENTS)
+
+/* COMPILE TIME MATH */
+/**
+ * @brief Sum of the series ln(x) = 2 * (y + y^3/3 + y^5/5 + ...), y = (x - 1) / (x + 1).
+ *
+ * @param y_squared Square of y.
+ * @param power Current odd power of y.
+ * @param term Index of the current term (recursive, C++11 constexpr).
+ */
+static constexpr double mq_lut_lnSeries(double y_squared, double power, uint8_t term)
+{
+    return (MQ_LUT_LN_SERIES_TERMS <= term) ? 0.0 :
+           power / (double)(2u * term + 1u) + mq_lut_lnSeries(y_squared, power * y_squared, term + 1u);
+}
+
+/**
+ * @brief Natural logarithm, argument is halved or doubled into [0.75, 1.5] where the series converges fast.
+ *
+ * @param x Argument, must be greater than 0.
+ */
+static constexpr double mq_lut_ln(double x)
+{
+    return (1.5 < x) ? mq_lut_ln(x * 0.5) + MQ_LUT_LN_2 :
+           (0.75 > x) ? mq_lut_ln(x * 2.0) - MQ_LUT_LN_2 :
+           2.0 * mq_lut_lnSeries(((x - 1.0) / (x + 1.0)) * ((x - 1.0) / (x + 1.0)), (x - 1.0) / (x + 1.0), 0u);
+}
+
+/**
+ * @brief Taylor series of exp(x), used only for |x| <= 0.5.
+ *
+ * @param x Argument.
+ * @param term_value Value of the current term x^n / n!.
+ * @param term Index of the current term (recursive, C++11 constexpr).
+ */
+static constexpr double mq_lut_expSeries(double x, double term_value, uint8_t term)
+{
+    return (MQ_LUT_EXP_SERIES_TERMS <= term) ? term_value :
+           term_value + mq_lut_expSeries(x, term_value * x / (double)(term + 1u), term + 1u);
+}
+
+static constexpr double mq_lut_square(double value)
+{
+    return value * value;
+}
+
+/**
+ * @brief Exponential function, exp(x) = exp(x / 2)^2 until the argument is small enough for the series.
+ *
+ * @param x Argument.
+ */
+static constexpr double mq_lut_exp(double x)
+{
+    return (0.5 < x || -0.5 > x) ? mq_lut_square(mq_lut_exp(x * 0.5)) : mq_lut_expSeries(x, 1.0, 0u);
+}
+
+/**
+ * @brief Power function base^exponent for a positive base.
+ */
+static constexpr double mq_lut_pow(double base, double exponent)
+{
+    return mq_lut_exp(exponent * mq_lut_ln(base));
+}
+
+/**
+ * @brief Compile time version of mq_lut_lookup(), used for checking the accuracy of a table.
+ */
+static constexpr double mq_lut_interpolate(const float *table, uint16_t adc_result)
+{
+    return table[adc_result >> MQ_LUT_INDEX_SHIFT] +
+           (table[(adc_result >> MQ_LUT_INDEX_SHIFT) + 1u] - table[adc_result >> MQ_LUT_INDEX_SHIFT]) *
+           (double)(adc_result & MQ_LUT_FRACTION_MASK) * MQ_LUT_FRACTION_SCALE;
+}
+
+/**
+ * @brief Checks that the interpolated table matches the exact curve inside the measuring range of the sensor.
+ *
+ * Every oversampled ADC result from first to last is compared, results for which the exact curve
+ * is outside of [min_ppm, max_ppm] are not checked. The range is split in halves, so the recursion
+ * depth stays logarithmic (C++11 constexpr).
+ *
+ * @param table Table generated from the curve.
+ * @param curve Exact curve, ppm as a function of ADC counts.
+ * @param min_ppm Lower limit of the measuring range.
+ * @param max_ppm Upper limit of the measuring range.
+ * @param first First ADC result to check.
+ * @param last Last ADC result to check.
+ * @return true if the relative error is below MQ_LUT_MAX_RELATIVE_ERROR for every checked result.
+ */
+static constexpr bool mq_lut_isAccurate(const float *table, double (*curve)(double), double min_ppm, double max_ppm,
+                                        uint16_t first, uint16_t last)
+{
+    return (first < last) ?
+           (mq_lut_isAccurate(table, curve, min_ppm, max_ppm, first, (uint16_t)((first + last) / 2u)) &&
+            mq_lut_isAccurate(table, curve, min_ppm, max_ppm, (uint16_t)((first + last) / 2u + 1u), last)) :
+           (min_ppm > curve(ADC_SAMPLING_TO_COUNTS(first)) || max_ppm < curve(ADC_SAMPLING_TO_COUNTS(first)) ||
+            MQ_LUT_MAX_RELATIVE_ERROR * curve(ADC_SAMPLING_TO_COUNTS(first)) >=
+            ((mq_lut_interpolate(table, first) > curve(ADC_SAMPLING_TO_COUNTS(first))) ?
+             mq_lut_interpolate(table, first) - curve(ADC_SAMPLING_TO_COUNTS(first)) :
+             curve(ADC_SAMPLING_TO_COUNTS(first)) - mq_lut_interpolate(table, first)));
+}
+/**
+ * @brief Relative error of the interpolated table against the exact curve for one ADC result.
+ */
+static constexpr double mq_lut_relativeError(const float *table, double (*curve)(double), uint16_t adc_result)
+{
+    return ((mq_lut_interpolate(table, adc_result) > curve(ADC_SAMPLING_TO_COUNTS(adc_result))) ?
+            mq_lut_interpolate(table, adc_result) - curve(ADC_SAMPLING_TO_COUNTS(adc_result)) :
+            curve(ADC_SAMPLING_TO_COUNTS(adc_result)) - mq_lut_interpolate(table, adc_result)) /
+           curve(ADC_SAMPLING_TO_COUNTS(adc_result));
+}
+
+/**
+ * @brief Checks the sample codes of a benchmark against the exact curve.
+ *
+ * Unlike mq_lut_isAccurate() no code is skipped, a code whose curve value is outside of [min_ppm, max_ppm]
+ * fails the check, so the benchmark always measures codes of the measuring range.
+ *
+ * @param table Table generated from the curve.
+ * @param curve Exact curve, ppm as a function of ADC counts.
+ * @param min_ppm Lower limit of the measuring range.
+ * @param max_ppm Upper limit of the measuring range.
+ * @param codes Sample codes (recursive, C++11 constexpr).
+ * @param num_of_codes Number of sample codes from codes on.
+ * @return true if every code is inside the range with a relative error below MQ_LUT_MAX_RELATIVE_ERROR.
+ */
+static constexpr bool mq_lut_areSamplesAccurate(const float *table, double (*curve)(double), double min_ppm, double max_ppm,
+                                                const uint16_t *codes, uint8_t num_of_codes)
+{
+    return (0u == num_of_codes) ||
+           (min_ppm <= curve(ADC_SAMPLING_TO_COUNTS(codes[0])) && max_ppm >= curve(ADC_SAMPLING_TO_COUNTS(codes[0])) &&
+            MQ_LUT_MAX_RELATIVE_ERROR >= mq_lut_relativeError(table, curve, codes[0]) &&
+            mq_lut_areSamplesAccurate(table, curve, min_ppm, max_ppm, codes + 1u, (uint8_t)(num_of_codes - 1u)));
+}
+/* ********************************* */
+
+/* Float formula which a table replaces, ppm as a function of ADC counts */
+typedef float (*mq_lut_formula_fn)(float counts);
+
+/**
+ * @brief Returns the ppm value for an oversampled ADC result by interpolating between two knots of a table.
+ *
+ * @param table Table in program memory with MQ_LUT_SIZE knots, generated with MQ_LUT_TABLE_ENTRIES.
+ * @param adc_result ADC code with ADC_SAMPLING_EXTRA_BITS fractional bits (0..ADC_SAMPLING_RESULT_MAX).
+ * @return float Interpolated ppm value.
+ */
+float mq_lut_lookup(const float *table, uint16_t adc_result);
+
+#ifdef PROFILING_COMPONENT
+/**
+ * @brief Benchmarks a table against the float formula it replaces and records the results in the profiling.
+ *
+ * Every one of MQ_LUT_BENCHMARK_PASSES passes converts all sample codes with mq_lut_lookup() and then with the formula,
+ * the CPU cycles of one conversion (time of the pass divided by the number of codes, the read of the code included)
+ * are recorded in the lookup slot and in the formula slot. The largest relative error of the table against the formula
+ * is recorded in parts per million in the error slot, an error above MQ_LUT_MAX_RELATIVE_ERROR counts as an overrun.
+ * Blocks for the whole benchmark, about MQ_LUT_BENCHMARK_PASSES * num_of_codes conversions with the formula.
+ *
+ * @param table Table in program memory with MQ_LUT_SIZE knots.
+ * @param formula Float formula which the table replaces.
+ * @param codes Sample codes in program memory, ADC codes with ADC_SAMPLING_EXTRA_BITS fractional bits.
+ * @param num_of_codes Number of sample codes, at least one.
+ * @param first_index Index of the lookup slot in PROFILING_GROUP_BENCHMARKS, the formula slot and the error slot follow it.
+ */
+void mq_lut_runBenchmark(const float *table, mq_lut_formula_fn formula, const uint16_t *codes, uint8_t num_of_codes, uint8_t first_index);
+#endif
+
+#endif
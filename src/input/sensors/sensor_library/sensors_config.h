@@ -3,12 +3,34 @@
 
 #include <Arduino.h>
 
+/**
+ * Comment out to carry sensor values as float instead of scaled integers.
+ * Scaled integers (real value * 10^num_of_decimals of the catalog entry) keep soft-float
+ * out of range checks, formatting and binary frames, only the driver reading is converted once.
+ */
+#define SENSORS_FIXED_POINT_VALUES
+
+/* ADC sampling (shared by all analog sensors) */
+#define SENSORS_ADC_OVERSAMPLING_EXTRA_BITS           (uint8_t)(2u) /** Extra bits of resolution, 4^n samples are taken per result */
+
 /* DHT11 */
 #define SENSORS_DHT11_PIN                             (uint8_t)(2u) /** Pin for DHT11 sensor */
+#define SENSORS_DHT11_POWER_ON_DELAY_MS               (uint32_t)(1000u) /** Unstable state of DHT11 after power on, it must not be started earlier */
+#define SENSORS_DHT11_CONVERSION_PERIOD_MS            (uint32_t)(5000u) /** Period of the DHT11 exchanges, temperature and humidity come from the same frame */
 #define SENSORS_DHT11_TEMPERATURE_MIN                 (float)(-20)  /** Minimum temperature for DHT11 sensor */
 #define SENSORS_DHT11_TEMPERATURE_MAX                 (float)(50)   /** Maximum temperature for DHT11 sensor */
 #define SENSORS_DHT11_HUMIDITY_MIN                    (float)(0)    /** Minimum humidity for DHT11 sensor */
 #define SENSORS_DHT11_HUMIDITY_MAX                    (float)(100)  /** Maximum humidity for DHT11 sensor */
+#define SENSORS_DHT11_TEMPERATURE_SAMPLE_PERIOD_MS    (uint32_t)(10000u) /** Sample period of DHT11 temperature, sensor itself is limited to 1 Hz */
+#define SENSORS_DHT11_HUMIDITY_SAMPLE_PERIOD_MS       (uint32_t)(10000u) /** Sample period of DHT11 humidity */
+#define SENSORS_DHT11_TEMPERATURE_DEADBAND            (float)(1)    /** Change of DHT11 temperature which is reported, the sensor has 1 C resolution */
+#define SENSORS_DHT11_HUMIDITY_DEADBAND               (float)(2)    /** Change of DHT11 humidity which is reported */
+#define SENSORS_DHT11_TEMPERATURE_MAX_SILENCE_MS      (uint32_t)(600000u) /** Longest time without a report of DHT11 temperature */
+#define SENSORS_DHT11_TEMPERATURE_FILTER              (SENSOR_FILTER_NONE)    /** Filter of DHT11 temperature */
+#define SENSORS_DHT11_TEMPERATURE_FILTER_PARAMETER    (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of DHT11 temperature */
+#define SENSORS_DHT11_HUMIDITY_MAX_SILENCE_MS         (uint32_t)(600000u) /** Longest time without a report of DHT11 humidity */
+#define SENSORS_DHT11_HUMIDITY_FILTER                 (SENSOR_FILTER_NONE)    /** Filter of DHT11 humidity */
+#define SENSORS_DHT11_HUMIDITY_FILTER_PARAMETER       (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of DHT11 humidity */
 
 /* BMP280 */
 #define SENSORS_BMP280_I2C_ADDR                       (uint8_t)(0x76)    /** I2C address for BMP280 sensor */
@@ -19,41 +41,123 @@
 #define SENSORS_BMP280_ALTITUDE_MIN                   (float)(-1000)     /** Minimum altitude for BMP280 sensor */
 #define SENSORS_BMP280_ALTITUDE_MAX                   (float)(9000)      /** Maximum altitude for BMP280 sensor */
 #define SENSORS_BMP280_LOCAL_SEA_LEVEL_PRESSURE       (float)(1013.25f)  /** Local sea-level pressure for BMP280 sensor */
+#define SENSORS_BMP280_CONVERSION_PERIOD_MS           (uint32_t)(10000u)  /** Period of the BMP280 forced conversions, the sensor sleeps in between */
+#define SENSORS_BMP280_HIGH_RESOLUTION                                    /** x2/x16 oversampling and IIR filter x4, comment out for the x1/x1 low power profile */
+#define SENSORS_BMP280_PRESSURE_SAMPLE_PERIOD_MS      (uint32_t)(30000u)  /** Sample period of BMP280 pressure */
+#define SENSORS_BMP280_TEMPERATURE_SAMPLE_PERIOD_MS   (uint32_t)(10000u)  /** Sample period of BMP280 temperature */
+#define SENSORS_BMP280_ALTITUDE_SAMPLE_PERIOD_MS      (uint32_t)(300000u) /** Sample period of BMP280 altitude, changes over minutes */
+#define SENSORS_BMP280_PRESSURE_DEADBAND              (float)(0.5)       /** Change of BMP280 pressure which is reported */
+#define SENSORS_BMP280_TEMPERATURE_DEADBAND           (float)(0.2)       /** Change of BMP280 temperature which is reported */
+#define SENSORS_BMP280_ALTITUDE_DEADBAND              (float)(5)         /** Change of BMP280 altitude which is reported */
+#define SENSORS_BMP280_PRESSURE_MAX_SILENCE_MS        (uint32_t)(600000u)  /** Longest time without a report of BMP280 pressure */
+#define SENSORS_BMP280_PRESSURE_FILTER                (SENSOR_FILTER_NONE)    /** Filter of BMP280 pressure, the sensor has its own IIR filter */
+#define SENSORS_BMP280_PRESSURE_FILTER_PARAMETER      (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of BMP280 pressure */
+#define SENSORS_BMP280_TEMPERATURE_MAX_SILENCE_MS     (uint32_t)(600000u)  /** Longest time without a report of BMP280 temperature */
+#define SENSORS_BMP280_TEMPERATURE_FILTER             (SENSOR_FILTER_NONE)    /** Filter of BMP280 temperature */
+#define SENSORS_BMP280_TEMPERATURE_FILTER_PARAMETER   (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of BMP280 temperature */
+#define SENSORS_BMP280_ALTITUDE_MAX_SILENCE_MS        (uint32_t)(3600000u) /** Longest time without a report of BMP280 altitude */
+#define SENSORS_BMP280_ALTITUDE_FILTER                (SENSOR_FILTER_NONE)    /** Filter of BMP280 altitude */
+#define SENSORS_BMP280_ALTITUDE_FILTER_PARAMETER      (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of BMP280 altitude */
 
 /* BH1750 */
 #define SENSORS_BH1750_I2C_ADDDR_VCC                  (uint8_t)(0x5C)  /** I2C address for BH1750 sensor when VCC is high */
 #define SENSORS_BH1750_I2C_ADDDR_GND                  (uint8_t)(0x23)  /** I2C address for BH1750 sensor when GND is high */
 #define SENSORS_BH1750_LUMINANCE_MIN                  (float)(0)       /** Minimum luminance for BH1750 sensor */
 #define SENSORS_BH1750_LUMINANCE_MAX                  (float)(150000)  /** Maximum luminance for BH1750 sensor */
+#define SENSORS_BH1750_LUMINANCE_SAMPLE_PERIOD_MS     (uint32_t)(2000u)  /** Sample period of BH1750 luminance */
+#define SENSORS_BH1750_CONVERSION_PERIOD_MS           (uint32_t)(2000u)  /** Period of the BH1750 one-shot measurements, the sensor powers down in between */
+#define SENSORS_BH1750_LUMINANCE_DEADBAND             (float)(10)      /** Change of BH1750 luminance which is reported */
+#define SENSORS_BH1750_LUMINANCE_MAX_SILENCE_MS       (uint32_t)(600000u) /** Longest time without a report of BH1750 luminance */
+#define SENSORS_BH1750_LUMINANCE_FILTER               (SENSOR_FILTER_NONE)    /** Filter of BH1750 luminance */
+#define SENSORS_BH1750_LUMINANCE_FILTER_PARAMETER     (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of BH1750 luminance */
 
 /* MQ135 */
 #define SENSORS_MQ135_PIN_ANALOG                      (A0)      /** Analog pin for MQ135 sensor */
-#define SENSORS_MQ135_PPM_MIN                         (float)(0)       /** Minimum PPM for MQ135 sensor */
+#define SENSORS_MQ135_PPM_MIN                         (float)(10)      /** Minimum PPM for MQ135 sensor (datasheet range) */
 #define SENSORS_MQ135_PPM_MAX                         (float)(10000)   /** Maximum PPM for MQ135 sensor */
 #define SENSORS_MQ135_PARAMETER_A                     (float)(116.60)  /** Parameter A for MQ135 sensor calibration */
 #define SENSORS_MQ135_PARAMETER_B                     (float)(2.77)    /** Parameter B for MQ135 sensor calibration */
-#define SENSORS_MQ135_R_ZERO                          (float)(10000)   /** R-zero for MQ135 sensor */
+#define SENSORS_MQ135_R_ZERO                          (float)(10000)   /** R-zero for MQ135 sensor, used until the sensor is calibrated */
+#define SENSORS_MQ135_ATMOSPHERIC_CO2_PPM             (float)(400)     /** CO2 concentration of the clean air in which MQ135 is calibrated */
+#define SENSORS_MQ135_ADC_DECIMATION                  (ADC_SAMPLING_DECIMATION_AVERAGE) /** Decimation of MQ135 samples */
+#define SENSORS_MQ135_PPM_SAMPLE_PERIOD_MS            (uint32_t)(10000u) /** Sample period of MQ135 PPM */
+#define SENSORS_MQ135_PPM_DEADBAND                    (float)(10)      /** Change of MQ135 PPM which is reported */
+#define SENSORS_MQ135_PPM_MAX_SILENCE_MS              (uint32_t)(600000u) /** Longest time without a report of MQ135 PPM */
+#define SENSORS_MQ135_PPM_FILTER                      (SENSOR_FILTER_NONE)    /** Filter of MQ135 PPM */
+#define SENSORS_MQ135_PPM_FILTER_PARAMETER            (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of MQ135 PPM */
 
 /* MQ7 */
 #define SENSORS_MQ7_PIN_ANALOG                        (A1)                     /** Analog pin for MQ7 sensor */
 #define SENSORS_MQ7_PIN_PWM_HEATER                    (uint8_t)(9u)            /** PWM pin for MQ7 heater */
 #define SENSORS_MQ7_PPM_MIN                           (float)(10)              /** Minimum PPM for MQ7 sensor */
 #define SENSORS_MQ7_PPM_MAX                           (float)(1000)            /** Maximum PPM for MQ7 sensor */
-#define SENSORS_MQ7_R_ZERO                            (float)(10000)           /** R-zero for MQ7 sensor calibration */
+#define SENSORS_MQ7_R_ZERO                            (float)(10000)           /** R-zero for MQ7 sensor, used until the sensor is calibrated */
 #define SENSORS_MQ7_CALCULATION_CONSTANT_1            (float)(0.5)             /** Constant 1 for MQ7 sensor calculation */
 #define SENSORS_MQ7_CALCULATION_CONSTANT_2            (float)(-0.27)           /** Constant 2 for MQ7 sensor calculation */
-#define SENSORS_MQ7_CLEAR_AIR_FACTOR                  (float)(9.83)            /** Clear air factor for MQ7 sensor */
+#define SENSORS_MQ7_CLEAR_AIR_FACTOR                  (float)(9.83)            /** Clear air factor for MQ7 sensor, Rs / R0 in clean air */
 #define SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS             (unsigned long)(90000u)  /** Low timeout for MQ7 heater */
 #define SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS            (unsigned long)(60000u)  /** High timeout for MQ7 heater */
+#define SENSORS_MQ7_ADC_DECIMATION                    (ADC_SAMPLING_DECIMATION_AVERAGE) /** Decimation of MQ7 samples */
+#define SENSORS_MQ7_SAMPLE_WINDOW_MS                  (unsigned long)(2000u)   /** Window at the end of the low heater phase in which CO is sampled */
+#define SENSORS_MQ7_COPPM_SAMPLE_PERIOD_MS            (uint32_t)(10000u)       /** Sample period of MQ7 CO PPM */
+#define SENSORS_MQ7_COPPM_DEADBAND                    (float)(5)               /** Change of MQ7 CO PPM which is reported */
+#define SENSORS_MQ7_COPPM_MAX_SILENCE_MS              (uint32_t)(600000u)      /** Longest time without a report of MQ7 CO PPM */
+#define SENSORS_MQ7_COPPM_FILTER                      (SENSOR_FILTER_NONE)    /** Filter of MQ7 CO PPM, one sample per heater cycle */
+#define SENSORS_MQ7_COPPM_FILTER_PARAMETER            (SENSOR_FILTER_NO_PARAMETER) /** Parameter of the filter of MQ7 CO PPM */
+
+/* MQ135 and MQ7 R-zero calibration, done in clean air */
+#define SENSORS_MQ_CALIBRATION_WARM_UP_MS             (uint32_t)(600000u)  /** Heating of the sensors before the first calibration sample */
+#define SENSORS_MQ_CALIBRATION_WINDOW_MS              (uint32_t)(1800000u) /** Time in which the calibration samples are taken */
+#define SENSORS_MQ_CALIBRATION_MIN_SAMPLES            (uint16_t)(10u)      /** Fewest samples of a sensor for a valid R-zero, MQ7 is sampled once per heater cycle */
+#define SENSORS_MQ_CALIBRATION_MAX_DEVIATION_PERCENT  (float)(10)          /** Largest standard deviation of the samples in percent of their mean, the air was not clean otherwise */
 
 /* GY-ML8511 */
 #define SENSORS_GY_ML8511_PIN_ANALOG                  (A2)  /** Analog pin for GY-ML8511 sensor */
 #define SENSORS_GYML8511_UV_MIN                       (float)(0)   /** Minimum UV for GY-ML8511 sensor */
 #define SENSORS_GYML8511_UV_MAX                       (float)(15)  /** Maximum UV for GY-ML8511 sensor */
+#define SENSORS_GYML8511_ADC_DECIMATION               (ADC_SAMPLING_DECIMATION_AVERAGE) /** Decimation of GY-ML8511 samples */
+#define SENSORS_GYML8511_UV_SAMPLE_PERIOD_MS          (uint32_t)(2000u) /** Sample period of GY-ML8511 UV intensity */
+#define SENSORS_GYML8511_UV_DEADBAND                  (float)(0.2) /** Change of GY-ML8511 UV intensity which is reported */
+#define SENSORS_GYML8511_UV_MAX_SILENCE_MS            (uint32_t)(600000u) /** Longest time without a report of GY-ML8511 UV intensity */
+#define SENSORS_GYML8511_UV_FILTER                    (SENSOR_FILTER_EMA)     /** Filter of GY-ML8511 UV intensity, EMA over about 4 samples */
+#define SENSORS_GYML8511_UV_FILTER_PARAMETER          (2)                     /** Shift of the EMA of GY-ML8511 UV intensity, weight 1/4 */
 
 /* Arduino rain sensor */
 #define SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT               /** Flag for analog rain sensor measurement */
 #define SENSORS_ARDUINO_RAIN_PIN_ANALOG               (A4)           /** Analog pin for Arduino rain sensor */
-#define SENSORS_ARDUINO_RAIN_PIN_DIGITAL              (uint8_t)(4u)  /** Digital pin for Arduino rain sensor (if analog measurement is not defined) */
+#define SENSORS_ARDUINO_RAIN_PIN_DIGITAL              (uint8_t)(4u)  /** Digital pin for Arduino rain sensor (if analog measurement is not defined or in interrupt mode) */
+#define SENSORS_ARDUINO_RAIN_ADC_DECIMATION           (ADC_SAMPLING_DECIMATION_MEDIAN)  /** Decimation of rain sensor samples, median rejects droplet spikes */
+#define SENSORS_ARDUINO_RAIN_SAMPLE_PERIOD_MS         (uint32_t)(1000u) /** Sample period of Arduino rain sensor, needs the lowest latency */
+#define SENSORS_ARDUINO_RAIN_MAX_SILENCE_MS           (uint32_t)(300000u) /** Longest time without a report of Arduino rain sensor, every change is reported */
+/**
+ * Uncomment for the interrupt mode, the digital output of the module must be connected to SENSORS_ARDUINO_RAIN_PIN_DIGITAL.
+ * Rain is taken from the debounced digital output instead of the analog value and every change is reported at once.
+ */
+// #define SENSORS_ARDUINO_RAIN_INTERRUPT
+#define SENSORS_ARDUINO_RAIN_DEBOUNCE_MS              (uint32_t)(50u) /** Time the digital output keeps its level before a change of rain is taken in interrupt mode */
+#ifdef SENSORS_ARDUINO_RAIN_INTERRUPT
+#define SENSORS_ARDUINO_RAIN_FILTER                   (SENSOR_FILTER_NONE)    /** Filter of Arduino rain sensor, the output is debounced already and a sample of a change must report it */
+#else
+#define SENSORS_ARDUINO_RAIN_FILTER                   (SENSOR_FILTER_MEDIAN)  /** Filter of Arduino rain sensor, majority of 3 samples rejects single splashes */
+#endif
+#define SENSORS_ARDUINO_RAIN_FILTER_PARAMETER         (SENSOR_FILTER_NO_PARAMETER) /** Median has no parameter */
+
+/* Derived measurements, computed from the cached readings of DHT11 and BMP280 */
+#define SENSORS_DERIVED_STATION_ALTITUDE_M                  (int32_t)(300)     /** Altitude of the station above sea level in meters, for the sea-level pressure */
+#define SENSORS_DERIVED_DEW_POINT_MIN                       (float)(-40)       /** Minimum dew point */
+#define SENSORS_DERIVED_DEW_POINT_MAX                       (float)(50)        /** Maximum dew point, never above the temperature */
+#define SENSORS_DERIVED_DEW_POINT_SAMPLE_PERIOD_MS          (uint32_t)(10000u) /** Sample period of the dew point, computed only when DHT11 has a new sample */
+#define SENSORS_DERIVED_DEW_POINT_DEADBAND                  (float)(1)         /** Change of the dew point which is reported */
+#define SENSORS_DERIVED_DEW_POINT_MAX_SILENCE_MS            (uint32_t)(600000u) /** Longest time without a report of the dew point */
+#define SENSORS_DERIVED_HEAT_INDEX_MIN                      (float)(-30)       /** Minimum heat index */
+#define SENSORS_DERIVED_HEAT_INDEX_MAX                      (float)(80)        /** Maximum heat index */
+#define SENSORS_DERIVED_HEAT_INDEX_SAMPLE_PERIOD_MS         (uint32_t)(10000u) /** Sample period of the heat index, computed only when DHT11 has a new sample */
+#define SENSORS_DERIVED_HEAT_INDEX_DEADBAND                 (float)(1)         /** Change of the heat index which is reported */
+#define SENSORS_DERIVED_HEAT_INDEX_MAX_SILENCE_MS           (uint32_t)(600000u) /** Longest time without a report of the heat index */
+#define SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MIN              (float)(850)       /** Minimum sea-level pressure, a wrong altitude shows up as an abnormal value */
+#define SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MAX              (float)(1100)      /** Maximum sea-level pressure */
+#define SENSORS_DERIVED_SEA_LEVEL_PRESSURE_SAMPLE_PERIOD_MS (uint32_t)(30000u) /** Sample period of the sea-level pressure, computed only when BMP280 has a new sample */
+#define SENSORS_DERIVED_SEA_LEVEL_PRESSURE_DEADBAND         (float)(0.5)       /** Change of the sea-level pressure which is reported */
+#define SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MAX_SILENCE_MS   (uint32_t)(600000u) /** Longest time without a report of the sea-level pressure */
 
 #endif
@@ -1,112 +1,183 @@
 #include "sensors.h"
 
-/* SENSOR FUNCTIONAL CONFIGURATION CATALOG */
-/* MUST BE IN THE SAME ORDER AS THE METADATA CONFIG ARRAY IN sensors_metadata.cpp */
-const sensors_functional_catalog_ts sensors_functional_catalog[] PROGMEM =
+/* STATIC GLOBAL VARIABLES */
+/* Latest sample of every sensor, indexed by catalog index, outputs read only from here */
+static sensors_cache_entry_ts reading_cache[SENSORS_SNAPSHOT_CAPACITY];
+/* Filter of every sensor with a driver, indexed by catalog index, zero initialized state is a filter without samples */
+static sensor_filter_state_ts filter_state[SENSORS_NUM_OF_FILTERS];
+/* Sequences of the inputs of every derivation at its last computation, indexed by SENSOR_DERIVED_* */
+static uint8_t derived_input_sequences[SENSOR_DERIVED_NUM_OF_DERIVATIONS][SENSOR_DERIVED_NUM_OF_INPUTS];
+
+/* Inputs of every derivation in the order of sensor_derived_compute(), indexed by SENSOR_DERIVED_* */
+static const uint8_t derived_inputs[SENSOR_DERIVED_NUM_OF_DERIVATIONS][SENSOR_DERIVED_NUM_OF_INPUTS] PLATFORM_PROGMEM =
 {
-#ifdef DHT11_TEMPERATURE
-  { 
-    SENSORS_DHT11_TEMPERATURE_MIN,     
-    SENSORS_DHT11_TEMPERATURE_MAX,    
-    dht11_readTemperature,          
-    SENSORS_NO_INDICATION_FUNCTION,  
-    DHT11_TEMPERATURE   
-  },
+  {INVALID_SENSOR_ID, INVALID_SENSOR_ID}, // SENSOR_DERIVED_NONE
+#ifdef DERIVED_DEW_POINT
+  {DHT11_TEMPERATURE, DHT11_HUMIDITY},
+#else
+  {INVALID_SENSOR_ID, INVALID_SENSOR_ID},
 #endif
-#ifdef DHT11_HUMIDITY
-  {
-    SENSORS_DHT11_HUMIDITY_MIN,        
-    SENSORS_DHT11_HUMIDITY_MAX,       
-    dht11_readHumidity,             
-    SENSORS_NO_INDICATION_FUNCTION,  
-    DHT11_HUMIDITY
-  },
-#endif  
-#ifdef BMP280_PRESSURE
-  {
-    SENSORS_BMP280_PRESSURE_MIN,       
-    SENSORS_BMP280_PRESSURE_MAX,      
-    bmp280_readPressure,            
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_PRESSURE
-  },
-#endif  
-#ifdef BMP280_TEMPERATURE
-  {
-    SENSORS_BMP280_TEMPERATURE_MIN,    
-    SENSORS_BMP280_TEMPERATURE_MAX,   
-    bmp280_readTemperature,         
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_TEMPERATURE
-  },
-#endif  
-#ifdef BMP280_ALTITUDE
-  { 
-    SENSORS_BMP280_ALTITUDE_MIN,       
-    SENSORS_BMP280_ALTITUDE_MAX,      
-    bmp280_readAltitude,            
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_ALTITUDE
-  },
-#endif  
-#ifdef BH1750_LUMINANCE
-  {
-    SENSORS_BH1750_LUMINANCE_MIN,      
-    SENSORS_BH1750_LUMINANCE_MAX,     
-    bh1750_readLightLevel,          
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BH1750_LUMINANCE
-  },
-#endif  
-#ifdef MQ135_PPM
-  { 
-    SENSORS_MQ135_PPM_MIN,             
-    SENSORS_MQ135_PPM_MAX,            
-    mq135_readPPM,                  
-    SENSORS_NO_INDICATION_FUNCTION,  
-    MQ135_PPM
-  },
-#endif  
-#ifdef MQ7_COPPM
-  { 
-    SENSORS_MQ7_PPM_MIN,               
-    SENSORS_MQ7_PPM_MAX,              
-    mq7_readPPM,                    
-    SENSORS_NO_INDICATION_FUNCTION,  
-    MQ7_COPPM
-  },
-#endif  
-#ifdef GYML8511_UV
-  { 
-    SENSORS_GYML8511_UV_MIN,           
-    SENSORS_GYML8511_UV_MAX,          
-    gy_ml8511_readUvIntensity,      
-    SENSORS_NO_INDICATION_FUNCTION,  
-    GYML8511_UV
-  },
-#endif  
-#ifdef ARDUINORAIN_RAINING
-  { 
-    SENSORS_INDICATION_NO_MIN,         
-    SENSORS_INDICATION_NO_MAX,        
-    SENSORS_NO_VALUE_FUNCTION,      
-    arduino_rain_sensor_readRaining, 
-    ARDUINORAIN_RAINING
-  },
+#ifdef DERIVED_HEAT_INDEX
+  {DHT11_TEMPERATURE, DHT11_HUMIDITY},
+#else
+  {INVALID_SENSOR_ID, INVALID_SENSOR_ID},
+#endif
+#ifdef DERIVED_SEA_LEVEL_PRESSURE
+  {BMP280_TEMPERATURE, BMP280_PRESSURE}
+#else
+  {INVALID_SENSOR_ID, INVALID_SENSOR_ID}
 #endif
 };
 /* *************************************** */
 
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Reads a sensor from the catalog, filters and validates the reading.
+ *
+ * @param sensor_index Catalog index of the sensor, must be valid.
+ * @param reading Pointer to the reading which is filled in place.
+ * @return control_error_code_te Error code of the reading (see sensors_getReading).
+ */
+static control_error_code_te readSensorAtIndex(uint8_t sensor_index, sensor_reading_ts *reading);
+
+/**
+ * @brief Finds the catalog index of a sensor.
+ *
+ * @param id The sensor ID.
+ * @param sensor_index Receives the catalog index of the sensor.
+ * @return control_error_code_te ERROR_CODE_NO_ERROR, ERROR_CODE_NO_SENSORS_CONFIGURED or ERROR_CODE_SENSOR_NOT_FOUND.
+ */
+static control_error_code_te findSensorIndex(uint8_t id, uint8_t *sensor_index);
+
+/**
+ * @brief Copies the cached reading of a sensor and checks its age.
+ *
+ * @param sensor_index Catalog index of the sensor, must be valid.
+ * @param reading Pointer to the reading which receives the cached reading.
+ * @param current_millis The current time in milliseconds.
+ * @return control_error_code_te Error code of the cached sample or ERROR_CODE_SENSOR_READING_STALE.
+ */
+static control_error_code_te readCacheAtIndex(uint8_t sensor_index, sensor_reading_ts *reading, uint32_t current_millis);
+
+/**
+ * @brief Returns a derived measurement, it is computed again only if one of its inputs has a new sample.
+ *
+ * Inputs are read from the cache, the result is stored in the cache entry of the derived measurement.
+ *
+ * @param sensor_index Catalog index of the derived measurement, must be valid.
+ * @param derivation SENSOR_DERIVED_* of the catalog entry.
+ * @param reading Pointer to the reading which receives the derived reading, its timestamp is the one of the newest input.
+ * @param current_millis The current time in milliseconds.
+ * @return control_error_code_te Error code of an input without a valid reading, otherwise ERROR_CODE_NO_ERROR,
+ *         ERROR_CODE_INVALID_VALUE_FROM_SENSOR or ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR of the result.
+ */
+static control_error_code_te readDerivedAtIndex(uint8_t sensor_index, uint8_t derivation, sensor_reading_ts *reading, uint32_t current_millis);
+/* *************************************** */
+
+/* SENSOR CATALOG */
+/* Expands PROGMEM strings of a catalog entry and checks their length */
+#define SENSORS_EXPAND_CATALOG_STRINGS(name, id, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_num_of_letters, \
+                                       min_value, max_value, sample_period, deadband, max_silence, filter, filter_parameter, derivation, ...) \
+  static const char sensors_catalog_type_##name[] PLATFORM_PROGMEM = sensor_type; \
+  static const char sensors_catalog_unit_##name[] PLATFORM_PROGMEM = measurement_unit; \
+  static_assert(sizeof(sensor_type) <= SENSORS_METADATA_SENSOR_TYPE_MAX_LEN + 1u, "Sensor type string is too long"); \
+  static_assert(sizeof(measurement_unit) <= SENSORS_METADATA_MEASUREMENT_UNIT_MAX_LEN + 1u, "Measurement unit string is too long"); \
+  static_assert(SENSORS_METADATA_NO_SAMPLE_PERIOD < (sample_period) && INT32_MAX >= (sample_period), "Sample period must be in range 1..INT32_MAX"); \
+  static_assert((sample_period) <= (max_silence) && INT32_MAX >= (max_silence), "Max silence must be in range sample_period..INT32_MAX"); \
+  static_assert(0 <= (deadband) && SENSOR_VALUE_CONSTANT_FITS(deadband, num_of_decimals), "Deadband must not be negative and must fit the value type"); \
+  static_assert(SENSOR_VALUE_MAX_DECIMALS >= (num_of_decimals), "Number of decimals must be at most SENSOR_VALUE_MAX_DECIMALS"); \
+  static_assert(SENSOR_VALUE_CONSTANT_FITS(min_value, num_of_decimals) && SENSOR_VALUE_CONSTANT_FITS(max_value, num_of_decimals), \
+                "Scaled range of the sensor does not fit the value type, use fewer decimals"); \
+  static_assert(SENSOR_FILTER_NONE == (filter) || SENSOR_FILTER_MEDIAN == (filter) || \
+                (SENSORS_MEASUREMENT_TYPE_VALUE == (measurement_type) && (SENSOR_FILTER_EMA == (filter) || SENSOR_FILTER_RATE_LIMIT == (filter))), \
+                "Filter must be a SENSOR_FILTER_*, indications only take the median"); \
+  static_assert(SENSOR_FILTER_EMA != (filter) || (SENSOR_FILTER_EMA_MIN_SHIFT <= (filter_parameter) && SENSOR_FILTER_EMA_MAX_SHIFT >= (filter_parameter)), \
+                "Shift of the EMA must be in range SENSOR_FILTER_EMA_MIN_SHIFT..SENSOR_FILTER_EMA_MAX_SHIFT"); \
+  static_assert(SENSOR_FILTER_RATE_LIMIT != (filter) || (0 < (filter_parameter) && SENSOR_VALUE_CONSTANT_FITS(filter_parameter, num_of_decimals)), \
+                "Step of the rate limiter must be positive and must fit the value type"); \
+  static_assert(SENSOR_DERIVED_NUM_OF_DERIVATIONS > (derivation) && \
+                (SENSOR_DERIVED_NONE == (derivation) || (SENSORS_MEASUREMENT_TYPE_VALUE == (measurement_type) && SENSOR_FILTER_NONE == (filter))), \
+                "Derivation must be a SENSOR_DERIVED_*, derived measurements are values without a filter");
+
+/* Expands only the derivation of an entry */
+#define SENSORS_EXPAND_CATALOG_DERIVATION(name, id, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_num_of_letters, \
+                                          min_value, max_value, sample_period, deadband, max_silence, filter, filter_parameter, derivation, ...) \
+  derivation,
+
+/* Expands a full catalog entry */
+#define SENSORS_EXPAND_CATALOG_ENTRY(name, id, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_num_of_letters, \
+                                     min_value, max_value, sample_period, deadband, max_silence, filter, filter_parameter, \
+                                     derivation, value_function, indication_function) \
+  { \
+    SENSOR_VALUE_FROM_CONSTANT(min_value, num_of_decimals), \
+    SENSOR_VALUE_FROM_CONSTANT(max_value, num_of_decimals), \
+    sample_period, \
+    SENSOR_VALUE_FROM_CONSTANT(deadband, num_of_decimals), \
+    max_silence, \
+    (SENSOR_FILTER_RATE_LIMIT == (filter)) ? SENSOR_VALUE_FROM_CONSTANT(filter_parameter, num_of_decimals) : (sensor_value_t)(filter_parameter), \
+    value_function, \
+    indication_function, \
+    sensors_catalog_type_##name, \
+    sensors_catalog_unit_##name, \
+    id, \
+    measurement_type, \
+    num_of_decimals, \
+    display_num_of_letters, \
+    filter, \
+    derivation \
+  },
+
+SENSORS_CATALOG(SENSORS_EXPAND_CATALOG_STRINGS)
+
+/* Generated from SENSORS_CATALOG in sensors_catalog.h, the only place where sensors are listed */
+const sensors_catalog_ts sensors_catalog[] PLATFORM_PROGMEM =
+{
+  SENSORS_CATALOG(SENSORS_EXPAND_CATALOG_ENTRY)
+};
+
+static_assert(SENSORS_CATALOG_NUM_OF_SENSORS == sizeof(sensors_catalog) / sizeof(sensors_catalog_ts),
+              "Catalog must contain every sensor from sensors_catalog_order");
+static_assert(PROFILING_MAX_SENSORS >= SENSORS_CATALOG_NUM_OF_SENSORS, "Profiling must have a slot for every sensor");
+
+/* Derivation of every entry in catalog order, only for the compile time check of the order */
+static constexpr uint8_t catalog_derivations[] =
+{
+  SENSORS_CATALOG(SENSORS_EXPAND_CATALOG_DERIVATION)
+  SENSOR_DERIVED_NONE // Keeps the table valid without any sensor
+};
+
+/**
+ * @brief Checks that the entries with a driver are the first SENSORS_NUM_OF_SAMPLED of the catalog,
+ *        so their catalog index is also the index of their filter state.
+ *
+ * @param index Index from which the check starts (recursive, C++11 constexpr).
+ */
+static constexpr bool areDerivedLast(uint8_t index)
+{
+  return (SENSORS_CATALOG_NUM_OF_SENSORS <= index) ||
+         ((SENSOR_DERIVED_NONE == catalog_derivations[index]) == (SENSORS_NUM_OF_SAMPLED > index) && areDerivedLast(index + 1u));
+}
+
+static_assert(areDerivedLast(SENSORS_CATALOG_FIRST_SENSOR_INDEX), "Derived measurements must come after every measurement with a driver in the catalog");
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
 control_error_code_te sensors_init(uint8_t sensor)
 {
   switch(sensor)
   {
+#ifdef DHT11_COMPONENT
     // DHT11
     case DHT11_COMPONENT:
+      if(millis() < SENSORS_DHT11_POWER_ON_DELAY_MS)
+      {
+        return ERROR_CODE_INIT_PENDING; // millis() counts from reset, so this is the time since power on
+      }
       dht11_init();
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef BMP280_COMPONENT
     // BMP280
     case BMP280_COMPONENT:
       if(!bmp280_init())
@@ -114,7 +185,9 @@ control_error_code_te sensors_init(uint8_t sensor)
         return ERROR_CODE_INIT_FAILED;
       }
       return ERROR_CODE_NO_ERROR;
+#endif
     
+#ifdef BH1750_COMPONENT
     // BH1750
     case BH1750_COMPONENT:
       if(!bh1750_init())
@@ -122,101 +195,309 @@ control_error_code_te sensors_init(uint8_t sensor)
         return ERROR_CODE_INIT_FAILED;
       }
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef MQ135_COMPONENT
     // MQ135
     case MQ135_COMPONENT:
       mq135_init();
+      mq135_setResistanceZero(sensors_calibration_loadResistanceZero(SENSORS_CALIBRATION_SLOT_MQ135, SENSORS_MQ135_R_ZERO));
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef MQ7_COMPONENT
     // MQ7
     case MQ7_COMPONENT:
       mq7_init();
+      mq7_setResistanceZero(sensors_calibration_loadResistanceZero(SENSORS_CALIBRATION_SLOT_MQ7, SENSORS_MQ7_R_ZERO));
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef GYML8511_COMPONENT
     // GYML8511
     case GYML8511_COMPONENT:
       gy_ml8511_init();
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef ARDUINORAIN_COMPONENT
     // ARDUINO RAIN SENSOR
     case ARDUINORAIN_COMPONENT:
       arduino_rain_sensor_init();
       return ERROR_CODE_NO_ERROR;
+#endif
   }
 
   return ERROR_CODE_INIT_FAILED;
 }
 
-sensor_return_ts sensors_getReading(uint8_t id)
+control_error_code_te sensors_sampleReading(uint8_t id, sensor_reading_ts *reading, uint32_t timestamp)
 {
-  sensor_return_ts return_data;
-  return_data.error_code = ERROR_CODE_NO_SENSORS_CONFIGURED; // Set default error code to indicate no sensors are configured
+  uint8_t sensor_index;
+  control_error_code_te error_code = findSensorIndex(id, &sensor_index);
 
-  size_t catalog_len = sensors_interface_getSensorsLen(); // Get the length of the sensor configuration array
-  if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED != catalog_len) // Check if any sensors are configured
+  if(ERROR_CODE_NO_ERROR == error_code) // If the sensor is configured, proceed to read its values
   {
-    bool is_sensor_configured = false; // Flag to check if the sensor is found
-    uint8_t sensor_index = SENSORS_FIRST_SENSOR_INDEX;
-
-    for (uint8_t index = SENSORS_FIRST_SENSOR_INDEX; index < catalog_len; index++) // Iterate through sensor configurations to find the matching sensor ID
+    uint8_t derivation = sensors_metadata_getDerivation(sensor_index);
+    if(SENSOR_DERIVED_NONE != derivation)
     {
-      if(pgm_read_byte(&sensors_functional_catalog[index].sensor_id) == id)
+      return readDerivedAtIndex(sensor_index, derivation, reading, PLATFORM_MILLIS()); // Nothing to sample, inputs are in the cache
+    }
+
+    error_code = readSensorAtIndex(sensor_index, reading);
+    reading->timestamp = timestamp;
+
+    sensors_cache_entry_ts *entry = &reading_cache[sensor_index];
+    entry->sensor_reading = *reading;
+    entry->timestamp = PLATFORM_MILLIS();
+    entry->error_code = error_code;
+    entry->filled = SENSORS_CACHE_FILLED;
+    entry->sequence++;
+  }
+  return error_code;
+}
+
+control_error_code_te sensors_getReading(uint8_t id, sensor_reading_ts *reading)
+{
+  uint8_t sensor_index;
+  control_error_code_te error_code = findSensorIndex(id, &sensor_index);
+
+  if(ERROR_CODE_NO_ERROR == error_code)
+  {
+    error_code = readCacheAtIndex(sensor_index, reading, PLATFORM_MILLIS());
+  }
+  return error_code;
+}
+
+control_error_code_te sensors_getSnapshot(sensors_snapshot_ts *snapshot)
+{
+  snapshot->timestamp = PLATFORM_MILLIS();
+  snapshot->num_of_readings = (uint8_t)sensors_interface_getSensorsLen();
+
+  if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED == snapshot->num_of_readings)
+  {
+    return ERROR_CODE_NO_SENSORS_CONFIGURED;
+  }
+
+  for (uint8_t sensor_index = SENSORS_CATALOG_FIRST_SENSOR_INDEX; sensor_index < snapshot->num_of_readings; sensor_index++)
+  {
+    // Written directly into the snapshot entry, no temporary reading
+    snapshot->readings[sensor_index].error_code = readCacheAtIndex(sensor_index, &(snapshot->readings[sensor_index].sensor_reading),
+                                                                   snapshot->timestamp);
+  }
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+void sensors_loop(unsigned long current_millis)
+{
+  adc_sampling_service(); // Decimate finished analog channel and start the next one
+#ifdef DHT11_COMPONENT
+  dht11_service(current_millis); // Start the next exchange or take over the frame decoded by the ISR
+#endif
+#ifdef BMP280_COMPONENT
+  bmp280_service(current_millis); // Start the next forced conversion or read its result
+#endif
+#ifdef BH1750_COMPONENT
+  bh1750_service(current_millis); // Start the next one-shot measurement or read its result
+#endif
+#ifdef MQ7_COMPONENT
+  mq7_heatingCycle(current_millis);
+#endif
+}
+
+uint8_t sensors_takeEvent(uint32_t current_millis, uint32_t *next_check)
+{
+#if defined(ARDUINORAIN_COMPONENT) && defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
+  uint32_t settle_deadline;
+  switch(arduino_rain_sensor_service(current_millis, &settle_deadline))
+  {
+    case ARDUINO_RAIN_SENSOR_CHANGED:
+      return ARDUINORAIN_RAINING;
+
+    case ARDUINO_RAIN_SENSOR_SETTLING:
+      if((settle_deadline - current_millis) < (*next_check - current_millis)) // Overflow safe differences
       {
-        // Sensor ID is found, store it and exit the loop
-        is_sensor_configured = true;
-        sensor_index = index;
-        break;
+        *next_check = settle_deadline;
       }
-    }
-    if(SENSORS_SENSOR_CONFIGURED == is_sensor_configured) // If the sensor is configured, proceed to read its values
-    {
-      sensors_functional_catalog_ts current_sensor;
-      memcpy_P(&current_sensor, &sensors_functional_catalog[sensor_index], sizeof(sensors_functional_catalog_ts)); // Copy the sensor configuration from program memory to a local structure
+      break;
+
+    default:
+      break;
+  }
+#else
+  (void)current_millis;
+  (void)next_check;
+#endif
+  return SENSORS_NO_EVENT;
+}
+
+bool sensors_isEventPending()
+{
+#if defined(ARDUINORAIN_COMPONENT) && defined(SENSORS_ARDUINO_RAIN_INTERRUPT)
+  return arduino_rain_sensor_isEdgePending();
+#else
+  return false;
+#endif
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static control_error_code_te readSensorAtIndex(uint8_t sensor_index, sensor_reading_ts *reading)
+{
+  control_error_code_te error_code;
 
-      if(SENSORS_NO_VALUE_FUNCTION != current_sensor.sensor_value_function) // Check if the sensor has a value function defined
+  // Read only the needed fields from program memory
+  sensors_sensor_value_function_t sensor_value_function = sensors_metadata_getValueFunction(sensor_index);
+  sensors_sensor_indication_function_t sensor_indication_function = sensors_metadata_getIndicationFunction(sensor_index);
+
+  if(SENSORS_NO_VALUE_FUNCTION != sensor_value_function) // Check if the sensor has a value function defined
+  {
+    reading->measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
+    PROFILING_START(start_micros);
+    float driver_value = sensor_value_function();
+    PROFILING_STOP(PROFILING_GROUP_SENSORS, sensor_index, start_micros, SENSORS_PROFILING_BUDGET_US);
+    if(!isnan(driver_value)) // Check if the value is valid
+    {
+      // Converted once, the rest of the path works with the sensor value type
+      reading->value = sensor_value_fromFloat(driver_value, sensors_metadata_getNumOfDecimals(sensor_index));
+      if(SENSOR_VALUE_INVALID != reading->value)
       {
-        return_data.sensor_reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
-        return_data.sensor_reading.value = current_sensor.sensor_value_function();
-        if(!isnan(return_data.sensor_reading.value)) // Check if the value is valid
-        {
-          // Check if the value is within the acceptable range
-          if(return_data.sensor_reading.value >= current_sensor.min_value && return_data.sensor_reading.value <= current_sensor.max_value)
-          {
-            return_data.error_code = ERROR_CODE_NO_ERROR; // No error, value is valid
-          }
-          else
-          {
-            return_data.error_code = ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR; // Value is outside the range
-          }
-        }
-        else
-        {
-          return_data.error_code = ERROR_CODE_INVALID_VALUE_FROM_SENSOR; // Sensor returned an invalid value
-        }
+        // Filtered before the range check, a spike is removed instead of reported as abnormal
+        reading->value = sensor_filter_apply(&filter_state[sensor_index], sensors_metadata_getFilter(sensor_index),
+                                             sensors_metadata_getFilterParameter(sensor_index), reading->value);
       }
-      else if(SENSORS_NO_INDICATION_FUNCTION != current_sensor.sensor_indication_function) // Check if the sensor has an indication function defined
+
+      // Check if the value is within the acceptable range, invalid value is outside of every range
+      if(SENSOR_VALUE_INVALID != reading->value &&
+         reading->value >= sensors_metadata_getMinValue(sensor_index) && 
+         reading->value <= sensors_metadata_getMaxValue(sensor_index))
       {
-        return_data.sensor_reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_INDICATION;
-        return_data.sensor_reading.indication = current_sensor.sensor_indication_function();
-        return_data.error_code = ERROR_CODE_NO_ERROR;
+        error_code = ERROR_CODE_NO_ERROR; // No error, value is valid
       }
       else
       {
-        return_data.error_code = ERROR_CODE_SENSORS_MEASUREMENT_TYPE_MISSING_FUNCTION; // Error: No function defined for the sensor's measurement type
+        error_code = ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR; // Value is outside the range
       }
     }
     else
     {
-      return_data.error_code = ERROR_CODE_SENSOR_NOT_FOUND; // Error: Sensor ID not found in the configuration
+      sensor_filter_reset(&filter_state[sensor_index]); // Old samples do not mix with the ones after the gap
+      error_code = ERROR_CODE_INVALID_VALUE_FROM_SENSOR; // Sensor returned an invalid value
     }
   }
-  return return_data;
+  else if(SENSORS_NO_INDICATION_FUNCTION != sensor_indication_function) // Check if the sensor has an indication function defined
+  {
+    reading->measurement_type_switch = SENSORS_MEASUREMENT_TYPE_INDICATION;
+    PROFILING_START(start_micros);
+    bool driver_indication = sensor_indication_function();
+    PROFILING_STOP(PROFILING_GROUP_SENSORS, sensor_index, start_micros, SENSORS_PROFILING_BUDGET_US);
+    // Indication is filtered as 0 or 1, the median of them is the majority
+    reading->indication = ((sensor_value_t)0 != sensor_filter_apply(&filter_state[sensor_index], sensors_metadata_getFilter(sensor_index),
+                                                                     sensors_metadata_getFilterParameter(sensor_index),
+                                                                     (sensor_value_t)(driver_indication ? 1 : 0)));
+    error_code = ERROR_CODE_NO_ERROR;
+  }
+  else
+  {
+    error_code = ERROR_CODE_SENSORS_MEASUREMENT_TYPE_MISSING_FUNCTION; // Error: No function defined for the sensor's measurement type
+  }
+
+  return error_code;
 }
 
-void sensors_loop(unsigned long current_millis)
+static control_error_code_te findSensorIndex(uint8_t id, uint8_t *sensor_index)
 {
-#ifdef MQ7_COPPM
-  mq7_heatingCycle(current_millis);
-#endif
+  if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED == sensors_interface_getSensorsLen()) // Check if any sensors are configured
+  {
+    return ERROR_CODE_NO_SENSORS_CONFIGURED;
+  }
+
+  *sensor_index = sensors_interface_sensorIdToIndex(id); // Constant time lookup of the catalog index
+  bool is_sensor_configured = (SENSORS_INTERFACE_INVALID_INDEX != *sensor_index);
+
+  return (SENSORS_SENSOR_CONFIGURED == is_sensor_configured) ? ERROR_CODE_NO_ERROR : ERROR_CODE_SENSOR_NOT_FOUND;
+}
+
+static control_error_code_te readCacheAtIndex(uint8_t sensor_index, sensor_reading_ts *reading, uint32_t current_millis)
+{
+  uint8_t derivation = sensors_metadata_getDerivation(sensor_index);
+  if(SENSOR_DERIVED_NONE != derivation)
+  {
+    return readDerivedAtIndex(sensor_index, derivation, reading, current_millis); // Age follows the inputs
+  }
+
+  const sensors_cache_entry_ts *entry = &reading_cache[sensor_index];
+  uint32_t max_age = SENSORS_CACHE_MAX_AGE(sensors_interface_getSamplePeriod(sensor_index)); // Period may be set at runtime
+
+  // Type is set also for stale readings, so outputs can still tell value and indication apart
+  reading->measurement_type_switch = sensors_metadata_getMeasurementType(sensor_index);
+  if(SENSORS_CACHE_FILLED != entry->filled || (current_millis - entry->timestamp) > max_age) // Overflow safe age
+  {
+    return ERROR_CODE_SENSOR_READING_STALE;
+  }
+
+  *reading = entry->sensor_reading;
+  return entry->error_code;
+}
+
+static control_error_code_te readDerivedAtIndex(uint8_t sensor_index, uint8_t derivation, sensor_reading_ts *reading, uint32_t current_millis)
+{
+  sensors_cache_entry_ts *entry = &reading_cache[sensor_index];
+  uint8_t *input_sequences = derived_input_sequences[derivation];
+  bool inputs_changed = (SENSORS_CACHE_FILLED != entry->filled);
+  int32_t inputs[SENSOR_DERIVED_NUM_OF_INPUTS];
+  uint32_t newest_timestamp = 0u;
+
+  reading->measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
+  for (uint8_t input = 0u; input < SENSOR_DERIVED_NUM_OF_INPUTS; input++)
+  {
+    uint8_t input_index = sensors_interface_sensorIdToIndex(PLATFORM_READ_BYTE(&derived_inputs[derivation][input]));
+    sensor_reading_ts input_reading;
+    control_error_code_te error_code = readCacheAtIndex(input_index, &input_reading, current_millis);
+    if(ERROR_CODE_NO_ERROR != error_code)
+    {
+      return error_code; // Stale or wrong input, the derived reading would be as well
+    }
+
+    inputs[input] = sensor_value_toDecimals(input_reading.value, sensors_metadata_getNumOfDecimals(input_index), SENSOR_DERIVED_INPUT_DECIMALS);
+    newest_timestamp = (input_reading.timestamp > newest_timestamp) ? input_reading.timestamp : newest_timestamp;
+    if(reading_cache[input_index].sequence != input_sequences[input])
+    {
+      input_sequences[input] = reading_cache[input_index].sequence;
+      inputs_changed = true;
+    }
+  }
+
+  if(inputs_changed)
+  {
+    PROFILING_START(start_micros);
+    int32_t result = sensor_derived_compute(derivation, inputs);
+    PROFILING_STOP(PROFILING_GROUP_SENSORS, sensor_index, start_micros, SENSORS_PROFILING_BUDGET_US);
+    reading->timestamp = newest_timestamp;
+
+    control_error_code_te error_code;
+    if(SENSOR_VALUE_SCALED_INVALID != result)
+    {
+      // Converted back to the decimals of the entry and checked like a driver reading, the inputs are filtered already
+      reading->value = sensor_value_fromDecimals(result, SENSOR_DERIVED_INPUT_DECIMALS, sensors_metadata_getNumOfDecimals(sensor_index));
+      error_code = (reading->value >= sensors_metadata_getMinValue(sensor_index) && reading->value <= sensors_metadata_getMaxValue(sensor_index)) ?
+                   ERROR_CODE_NO_ERROR : ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR;
+    }
+    else
+    {
+      reading->value = SENSOR_VALUE_INVALID;
+      error_code = ERROR_CODE_INVALID_VALUE_FROM_SENSOR; // Inputs have no result, e.g. a humidity of zero
+    }
+
+    entry->sensor_reading = *reading;
+    entry->timestamp = current_millis;
+    entry->error_code = error_code;
+    entry->filled = SENSORS_CACHE_FILLED;
+    entry->sequence++;
+  }
+
+  *reading = entry->sensor_reading;
+  return entry->error_code;
 }
 /* *************************************** */
\ No newline at end of file
@@ -2,9 +2,11 @@
 #define SENSORS_H
 
 #include <Arduino.h>
-#include <avr/pgmspace.h>
+#include "../../platform/platform.h"
 #include "../input_types.h"
 #include "sensors_interface/sensors_interface.h"
+#include "sensor_library/adc_sampling/adc_sampling.h"
+#include "../../profiling/profiling.h"
 #ifdef DHT11_COMPONENT
 #include "sensor_library/dht11/dht11.h"
 #endif
@@ -26,41 +28,53 @@
 #ifdef ARDUINORAIN_COMPONENT
 #include "sensor_library/arduino_rain_sensor/arduino_rain_sensor.h"
 #endif
+#include "sensors_calibration/sensors_calibration.h"
 
-/* The index of the first sensor in the configuration */
-#define SENSORS_FIRST_SENSOR_INDEX            (uint8_t)(0u)
+/* Flag indicating the sensor is configured in the catalog */
+#define SENSORS_SENSOR_CONFIGURED             (bool)(true)
 
-/* Placeholder for sensors without an indication function */
-#define SENSORS_NO_INDICATION_FUNCTION        (nullptr)
-/* Placeholder for sensors without a value function */
-#define SENSORS_NO_VALUE_FUNCTION             (nullptr)
+/* Flags indicating if the cache holds a sampled reading of the sensor */
+#define SENSORS_CACHE_FILLED                  (bool)(true)
+#define SENSORS_CACHE_EMPTY                   (bool)(false)
 
-/* Placeholders for min_value and max_value in indication sensors */
-#define SENSORS_INDICATION_NO_MIN             (float)(0)       
-#define SENSORS_INDICATION_NO_MAX             (float)(0)
+/* Number of sample periods after which a cached reading is stale, one missed sample is tolerated */
+#define SENSORS_CACHE_MAX_AGE_PERIODS         (uint8_t)(2u)
+/* Max age of the cached reading of a sensor in milliseconds */
+#define SENSORS_CACHE_MAX_AGE(sample_period)  ((uint32_t)(sample_period) * SENSORS_CACHE_MAX_AGE_PERIODS)
 
-/* Flag indicating the sensor is configured in functional catalog */
-#define SENSORS_SENSOR_CONFIGURED             (bool)(true)
+/* Returned by sensors_takeEvent() while no event driven measurement changed */
+#define SENSORS_NO_EVENT                      (uint8_t)(INVALID_SENSOR_ID)
+
+/* Expands to one for a measurement with a driver, derived measurements come last in the catalog */
+#define SENSORS_EXPAND_IS_SAMPLED(name, id, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_num_of_letters, \
+                                  min_value, max_value, sample_period, deadband, max_silence, filter, filter_parameter, derivation, ...) \
+  + ((SENSOR_DERIVED_NONE == (derivation)) ? 1u : 0u)
+
+/* Number of measurements with a driver, only they have a filter state, at least one so the array is valid */
+#define SENSORS_NUM_OF_SAMPLED                (uint8_t)(0u SENSORS_CATALOG(SENSORS_EXPAND_IS_SAMPLED))
+#define SENSORS_NUM_OF_FILTERS                (uint8_t)((SENSORS_NUM_OF_SAMPLED > 0u) ? SENSORS_NUM_OF_SAMPLED : 1u)
 
-/* Function pointer type for sensors returning a float value */
-typedef float (*sensors_sensor_value_function_t)();
-/* Function pointer type for sensors returning a bool indication */
-typedef bool (*sensors_sensor_indication_function_t)();
+/* Longest read function which is not counted as an overrun by the profiling, drivers should only return their latest conversion */
+#define SENSORS_PROFILING_BUDGET_US           (uint32_t)(1000u)
 
 /**
- * @brief Defines the functional properties of a sensor.
- * 
- * Includes valid measurement ranges, optional function pointers for sensor readings, 
- * and a unique identifier for referencing the sensor.
+ * Structure holding the latest sample of a sensor.
+ * Members:
+ *  - sensor_reading: Reading of the latest sample.
+ *  - timestamp: Time in milliseconds (millis() based) of the latest sample.
+ *  - error_code: Error code of the latest sample.
+ *  - filled: Flag indicating if the sensor was sampled at least once.
+ *  - sequence: Number of samples, wraps around. A derived measurement is computed again only when the
+ *              sequence of one of its inputs changed.
  */
 typedef struct
 {
-  float min_value;                                                 /* The minimum valid value for the sensor's reading. Values below this are considered invalid. */
-  float max_value;                                                 /* The maximum valid value for the sensor's reading. Values above this are considered invalid. */
-  sensors_sensor_value_function_t sensor_value_function;           /* Function pointer for obtaining a numerical reading from the sensor. Optional. */
-  sensors_sensor_indication_function_t sensor_indication_function; /* Function pointer for obtaining a boolean status/indication from the sensor. Optional. */
-  uint8_t sensor_id;                                               /* Unique identifier for the sensor. Used to reference the sensor. From config file. */
-} sensors_functional_catalog_ts;
+  sensor_reading_ts sensor_reading;
+  uint32_t timestamp;
+  control_error_code_te error_code;
+  bool filled;
+  uint8_t sequence;
+} sensors_cache_entry_ts;
 
 /**
  * @brief Initializes a specific sensor.
@@ -78,15 +92,16 @@ typedef struct
 control_error_code_te sensors_init(uint8_t sensor);
 
 /**
- * Retrieves a sensor reading based on the provided sensor ID.
+ * Samples a sensor, the only function which reads the sensor hardware.
  * Handles both value-based and indication-based sensor measurements.
  * Validates sensor data against configured thresholds.
+ * The reading is stored in the cache together with its time and error code.
  *
  * @param id The sensor ID for which the reading is requested.
+ * @param reading Pointer to the caller owned reading which is filled in place (value or indication).
+ * @param timestamp Timestamp of the sample in seconds, stored in the reading.
  * 
- * @return A `sensor_return_ts` structure containing:
- *         - Sensor reading (value or indication).
- *         - Error code indicating success or failure:
+ * @return control_error_code_te Error code indicating success or failure:
  *           - ERROR_CODE_NO_ERROR: Reading successful.
  *           - ERROR_CODE_NO_SENSORS_CONFIGURED: No sensors are configured.
  *           - ERROR_CODE_SENSOR_NOT_FOUND: Sensor ID is not found in the configuration.
@@ -97,8 +112,43 @@ control_error_code_te sensors_init(uint8_t sensor);
  * @note The function verifies whether the requested sensor ID exists in the configuration.
  *       If the sensor ID is valid, it invokes the appropriate function for the sensor 
  *       (either value-based or indication-based).
+ *       Analog sensors return the latest value decimated by the ADC sampling service,
+ *       so a reading never waits for an ADC conversion. A derived measurement is not sampled,
+ *       it is taken from the cache like in sensors_getReading().
  **/
-sensor_return_ts sensors_getReading(uint8_t id);
+control_error_code_te sensors_sampleReading(uint8_t id, sensor_reading_ts *reading, uint32_t timestamp);
+
+/**
+ * Retrieves the cached reading of a sensor, the hardware is not read.
+ * A derived measurement is computed from the cached readings of its inputs if one of them has a new sample.
+ *
+ * @param id The sensor ID for which the reading is requested.
+ * @param reading Pointer to the caller owned reading which receives the cached reading.
+ *
+ * @return control_error_code_te
+ *           - Error code of the cached sample (see sensors_sampleReading).
+ *           - ERROR_CODE_NO_SENSORS_CONFIGURED: No sensors are configured.
+ *           - ERROR_CODE_SENSOR_NOT_FOUND: Sensor ID is not found in the configuration.
+ *           - ERROR_CODE_SENSOR_READING_STALE: Sensor was not sampled yet or its reading is
+ *             older than SENSORS_CACHE_MAX_AGE() of its sample period.
+ *           - Error code of an input of a derived measurement which has no valid reading.
+ **/
+control_error_code_te sensors_getReading(uint8_t id, sensor_reading_ts *reading);
+
+/**
+ * @brief Collects the cached readings of all configured sensors.
+ *
+ * The cached reading of every sensor from the catalog is stored at its catalog index,
+ * the hardware is not read. Errors of individual readings are stored next to each reading,
+ * readings older than their max age are reported as ERROR_CODE_SENSOR_READING_STALE.
+ *
+ * @param snapshot Pointer to the snapshot to be filled.
+ *
+ * @return control_error_code_te
+ *         - ERROR_CODE_NO_ERROR if the sweep was done.
+ *         - ERROR_CODE_NO_SENSORS_CONFIGURED if there are no sensors to read.
+ */
+control_error_code_te sensors_getSnapshot(sensors_snapshot_ts *snapshot);
 
 /**
  * @brief Handles periodic tasks for sensors in the main loop.
@@ -111,4 +161,25 @@ sensor_return_ts sensors_getReading(uint8_t id);
  */
 void sensors_loop(unsigned long current_millis);
 
+/**
+ * @brief Takes the change of an event driven measurement, which is reported without waiting for its sample period.
+ *
+ * Only the Arduino rain sensor in interrupt mode (SENSORS_ARDUINO_RAIN_INTERRUPT) is event driven, its edges
+ * are debounced here. Must be called periodically and whenever sensors_isEventPending() is true.
+ *
+ * @param current_millis The current time in milliseconds.
+ * @param next_check Lowered to the time at which a settling measurement must be checked again, untouched otherwise.
+ * @return uint8_t ID of the measurement whose value changed, SENSORS_NO_EVENT otherwise.
+ */
+uint8_t sensors_takeEvent(uint32_t current_millis, uint32_t *next_check);
+
+/**
+ * @brief Checks if an interrupt queued data of an event driven measurement which sensors_takeEvent() did not take yet.
+ *
+ * Cheap enough for the idle loop, the interrupt wakes the MCU from sleep.
+ *
+ * @return true if sensors_takeEvent() should be called.
+ */
+bool sensors_isEventPending();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "sensors_calibration.h"
+
+/* STATIC GLOBAL VARIABLES */
+static uint8_t calibration_state = SENSORS_CALIBRATION_IDLE;
+// End of the warm-up or of the sampling window (millis() based)
+static uint32_t state_deadline = 0u;
+// Next slot which is evaluated at the end of the window
+static uint8_t evaluated_slot = 0u;
+static sensors_calibration_stats_ts slot_stats[SENSORS_CALIBRATION_NUM_OF_SLOTS];
+#ifdef MQ7_COMPONENT
+// MQ7 is sampled once per low heater phase, like its ppm samples
+static bool mq7_sample_taken = MQ7_SAMPLE_NOT_TAKEN;
+#endif
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(2u <= SENSORS_MQ_CALIBRATION_MIN_SAMPLES, "Calibration needs at least two samples for the variance");
+static_assert(0 < SENSORS_MQ_CALIBRATION_MAX_DEVIATION_PERCENT, "Largest deviation of the calibration samples must be positive");
+static_assert(SENSORS_CALIBRATION_EEPROM_END <= PLATFORM_EEPROM_SIZE, "Calibration records do not fit the EEPROM");
+#ifdef MQ7_COMPONENT
+static_assert(SENSORS_MQ_CALIBRATION_MIN_SAMPLES <= SENSORS_MQ_CALIBRATION_WINDOW_MS / (SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS + SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS),
+              "Calibration window must hold SENSORS_MQ_CALIBRATION_MIN_SAMPLES heater cycles of MQ7");
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Checks if the sensor of a slot is enabled in project_settings.h.
+ *
+ * @param slot Slot of the sensor.
+ * @return true if the sensor is compiled in.
+ */
+static bool isSlotEnabled(uint8_t slot);
+
+/**
+ * @brief Returns the catalog ID of the sensor of a slot, used for reporting its errors.
+ *
+ * @param slot Slot of the sensor.
+ * @return uint8_t Sensor ID or SENSORS_CALIBRATION_NO_SENSOR if the sensor is not enabled.
+ */
+static uint8_t slotToSensorId(uint8_t slot);
+
+/**
+ * @brief Returns the ratio Rs / R0 of the sensor of a slot in clean air.
+ *
+ * @param slot Slot of the sensor.
+ * @return float Ratio by which the mean resistance is divided.
+ */
+static float getClearAirRatio(uint8_t slot);
+
+/**
+ * @brief Takes the resistance samples of every enabled sensor which are due.
+ */
+static void sampleSensors();
+
+/**
+ * @brief Adds one resistance sample to the running statistics of a slot, invalid samples are skipped.
+ *
+ * @param slot Slot of the sensor.
+ * @param resistance Resistance in ohms or NAN.
+ */
+static void addSample(uint8_t slot, float resistance);
+
+/**
+ * @brief Computes, checks, stores and applies the R0 of a slot.
+ *
+ * @param slot Slot of the sensor.
+ * @return control_error_code_te Error code of the evaluation (see sensors_calibration_service()).
+ */
+static control_error_code_te evaluateSlot(uint8_t slot);
+
+/**
+ * @brief Passes a new R0 to the driver of a slot.
+ *
+ * @param slot Slot of the sensor.
+ * @param r_zero R0 in ohms.
+ */
+static void applyResistanceZero(uint8_t slot, float r_zero);
+
+/**
+ * @brief Returns the first enabled slot at or after a slot.
+ *
+ * @param slot First slot which is checked.
+ * @return uint8_t Enabled slot or SENSORS_CALIBRATION_NUM_OF_SLOTS if there is none.
+ */
+static uint8_t findEnabledSlot(uint8_t slot);
+
+/**
+ * @brief Reads the record of a slot and checks it.
+ *
+ * @param slot Slot of the sensor.
+ * @param record Receives the record.
+ * @return true if the record was written by a calibration and is not damaged.
+ */
+static bool readRecord(uint8_t slot, sensors_calibration_record_ts *record);
+
+/**
+ * @brief Computes the check byte of a record.
+ *
+ * @param record Record, its check byte is not included.
+ * @return uint8_t Check byte.
+ */
+static uint8_t recordCheck(const sensors_calibration_record_ts *record);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+float sensors_calibration_loadResistanceZero(uint8_t slot, float default_r_zero)
+{
+  sensors_calibration_record_ts record;
+  return readRecord(slot, &record) ? record.r_zero : default_r_zero;
+}
+
+void sensors_calibration_start(uint32_t current_millis)
+{
+  for (uint8_t slot = 0u; slot < SENSORS_CALIBRATION_NUM_OF_SLOTS; slot++)
+  {
+    slot_stats[slot] = {0, 0, 0u};
+  }
+#ifdef MQ7_COMPONENT
+  mq7_sample_taken = MQ7_SAMPLE_TAKEN; // First sample only in a low phase which is entirely inside the window
+#endif
+  evaluated_slot = findEnabledSlot(0u);
+  state_deadline = current_millis + SENSORS_MQ_CALIBRATION_WARM_UP_MS;
+  calibration_state = (SENSORS_CALIBRATION_NUM_OF_SLOTS > evaluated_slot) ? SENSORS_CALIBRATION_WARM_UP : SENSORS_CALIBRATION_IDLE;
+}
+
+bool sensors_calibration_isActive()
+{
+  return (SENSORS_CALIBRATION_IDLE != calibration_state) ? SENSORS_CALIBRATION_ACTIVE : SENSORS_CALIBRATION_NOT_ACTIVE;
+}
+
+bool sensors_calibration_isNeeded()
+{
+  sensors_calibration_record_ts record;
+  for (uint8_t slot = findEnabledSlot(0u); slot < SENSORS_CALIBRATION_NUM_OF_SLOTS; slot = findEnabledSlot(slot + 1u))
+  {
+    if(!readRecord(slot, &record))
+    {
+      return SENSORS_CALIBRATION_NEEDED;
+    }
+  }
+  return SENSORS_CALIBRATION_NOT_NEEDED;
+}
+
+control_error_code_te sensors_calibration_service(uint32_t current_millis, uint8_t *sensor_id)
+{
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+  *sensor_id = SENSORS_CALIBRATION_NO_SENSOR;
+
+  switch(calibration_state)
+  {
+    case SENSORS_CALIBRATION_WARM_UP:
+      if(0 <= (int32_t)(current_millis - state_deadline)) // Overflow safe compare
+      {
+        state_deadline = current_millis + SENSORS_MQ_CALIBRATION_WINDOW_MS;
+        calibration_state = SENSORS_CALIBRATION_SAMPLING;
+      }
+      break;
+
+    case SENSORS_CALIBRATION_SAMPLING:
+      sampleSensors();
+      if(0 <= (int32_t)(current_millis - state_deadline))
+      {
+        calibration_state = SENSORS_CALIBRATION_EVALUATING;
+      }
+      break;
+
+    case SENSORS_CALIBRATION_EVALUATING:
+      // One sensor per call, an EEPROM write takes a few milliseconds per byte
+      *sensor_id = slotToSensorId(evaluated_slot);
+      error_code = evaluateSlot(evaluated_slot);
+      evaluated_slot = findEnabledSlot(evaluated_slot + 1u);
+      if(SENSORS_CALIBRATION_NUM_OF_SLOTS <= evaluated_slot)
+      {
+        calibration_state = SENSORS_CALIBRATION_IDLE;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return error_code;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool isSlotEnabled(uint8_t slot)
+{
+  return SENSORS_CALIBRATION_NO_SENSOR != slotToSensorId(slot);
+}
+
+static uint8_t slotToSensorId(uint8_t slot)
+{
+  switch(slot)
+  {
+#ifdef MQ135_COMPONENT
+    case SENSORS_CALIBRATION_SLOT_MQ135:
+      return MQ135_PPM;
+#endif
+#ifdef MQ7_COMPONENT
+    case SENSORS_CALIBRATION_SLOT_MQ7:
+      return MQ7_COPPM;
+#endif
+    default:
+      return SENSORS_CALIBRATION_NO_SENSOR;
+  }
+}
+
+static float getClearAirRatio(uint8_t slot)
+{
+  switch(slot)
+  {
+#if defined(MQ135_COMPONENT) && defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+    case SENSORS_CALIBRATION_SLOT_MQ135:
+      return (float)mq135_clearAirRatio(); // Constant expression, evaluated at compile time
+#endif
+#ifdef MQ7_COMPONENT
+    case SENSORS_CALIBRATION_SLOT_MQ7:
+      return SENSORS_MQ7_CLEAR_AIR_FACTOR;
+#endif
+    default:
+      return NAN; // No curve, no R0
+  }
+}
+
+static void sampleSensors()
+{
+#ifdef MQ135_COMPONENT
+  addSample(SENSORS_CALIBRATION_SLOT_MQ135, mq135_readResistanceForCalibration());
+#endif
+#ifdef MQ7_COMPONENT
+  if(MQ7_HEATER_PHASE_LOW == mq7_getHeaterPhase())
+  {
+    // Resistance is only meaningful at the end of the low phase
+    if(MQ7_SAMPLE_NOT_TAKEN == mq7_sample_taken && mq7_getPhaseTimeLeftMs() <= SENSORS_MQ7_SAMPLE_WINDOW_MS)
+    {
+      addSample(SENSORS_CALIBRATION_SLOT_MQ7, mq7_readResistanceForCalibration());
+      mq7_sample_taken = MQ7_SAMPLE_TAKEN;
+    }
+  }
+  else
+  {
+    mq7_sample_taken = MQ7_SAMPLE_NOT_TAKEN;
+  }
+#endif
+}
+
+static void addSample(uint8_t slot, float resistance)
+{
+  sensors_calibration_stats_ts *stats = &slot_stats[slot];
+  if(!(0 < resistance) || UINT16_MAX == stats->num_of_samples) // Skips NAN as well
+  {
+    return;
+  }
+  stats->num_of_samples++;
+  float delta = resistance - stats->mean;
+  stats->mean += delta / (float)stats->num_of_samples;
+  stats->m2 += delta * (resistance - stats->mean);
+}
+
+static control_error_code_te evaluateSlot(uint8_t slot)
+{
+  const sensors_calibration_stats_ts *stats = &slot_stats[slot];
+  float clear_air_ratio = getClearAirRatio(slot);
+  if(SENSORS_MQ_CALIBRATION_MIN_SAMPLES > stats->num_of_samples || !(0 < clear_air_ratio))
+  {
+    return ERROR_CODE_CALIBRATION_TOO_FEW_SAMPLES;
+  }
+
+  // Variance against the allowed spread, both squared so no square root is needed
+  float variance = stats->m2 / (float)(stats->num_of_samples - 1u);
+  float max_deviation = stats->mean * (SENSORS_MQ_CALIBRATION_MAX_DEVIATION_PERCENT / 100.0f);
+  if(variance > max_deviation * max_deviation)
+  {
+    return ERROR_CODE_CALIBRATION_UNSTABLE;
+  }
+
+  sensors_calibration_record_ts record = {stats->mean / clear_air_ratio, stats->num_of_samples, SENSORS_CALIBRATION_RECORD_MAGIC, 0u};
+  record.check = recordCheck(&record);
+  PLATFORM_EEPROM_UPDATE(SENSORS_CALIBRATION_EEPROM_ADDRESS + slot * sizeof(record), &record, sizeof(record));
+  applyResistanceZero(slot, record.r_zero);
+  return ERROR_CODE_NO_ERROR;
+}
+
+static void applyResistanceZero(uint8_t slot, float r_zero)
+{
+  switch(slot)
+  {
+#ifdef MQ135_COMPONENT
+    case SENSORS_CALIBRATION_SLOT_MQ135:
+      mq135_setResistanceZero(r_zero);
+      break;
+#endif
+#ifdef MQ7_COMPONENT
+    case SENSORS_CALIBRATION_SLOT_MQ7:
+      mq7_setResistanceZero(r_zero);
+      break;
+#endif
+    default:
+      (void)r_zero;
+      break;
+  }
+}
+
+static uint8_t findEnabledSlot(uint8_t slot)
+{
+  while(SENSORS_CALIBRATION_NUM_OF_SLOTS > slot && !isSlotEnabled(slot))
+  {
+    slot++;
+  }
+  return slot;
+}
+
+static bool readRecord(uint8_t slot, sensors_calibration_record_ts *record)
+{
+  if(SENSORS_CALIBRATION_NUM_OF_SLOTS <= slot)
+  {
+    return false;
+  }
+  PLATFORM_EEPROM_READ(record, SENSORS_CALIBRATION_EEPROM_ADDRESS + slot * sizeof(*record), sizeof(*record));
+  return SENSORS_CALIBRATION_RECORD_MAGIC == record->magic && recordCheck(record) == record->check && 0 < record->r_zero;
+}
+
+static uint8_t recordCheck(const sensors_calibration_record_ts *record)
+{
+  const uint8_t *bytes = (const uint8_t *)record;
+  uint8_t check = 0u;
+  for (uint8_t i = 0u; i < offsetof(sensors_calibration_record_ts, check); i++)
+  {
+    check ^= bytes[i];
+  }
+  return (uint8_t)~check; // All zero record is not valid
+}
+/* *************************************** */
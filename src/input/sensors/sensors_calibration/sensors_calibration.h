@@ -0,0 +1,135 @@
+#ifndef SENSORS_CALIBRATION_H
+#define SENSORS_CALIBRATION_H
+
+#include <Arduino.h>
+#include "../../../platform/platform.h"
+#include "../../../control/control_error_codes.h"
+#include "../sensors_interface/sensors_interface.h"
+#include "../sensor_library/sensors_config.h"
+#ifdef MQ135_COMPONENT
+#include "../sensor_library/mq135/mq135.h"
+#endif
+#ifdef MQ7_COMPONENT
+#include "../sensor_library/mq7/mq7.h"
+#endif
+
+/**
+ * @file sensors_calibration.h
+ * @brief Calibration of the R0 of the MQ135 and MQ7 gas sensors in clean air, kept in the EEPROM.
+ *
+ * After a warm-up the resistance of every MQ sensor is sampled for SENSORS_MQ_CALIBRATION_WINDOW_MS,
+ * MQ7 only at the end of its low heater phase, where its ppm samples are taken as well. Mean and variance
+ * are accumulated on the fly (Welford), so no sample is stored. At the end of the window the R0 of a sensor
+ * is its mean resistance divided by the Rs / R0 ratio in clean air. It is rejected if there were too few
+ * samples or if they spread too much, the air was not clean then. An accepted R0 is written into the
+ * EEPROM, applied right away and loaded by the sensor init on every following boot.
+ *
+ * Record of one sensor in the EEPROM, slot after slot from SENSORS_CALIBRATION_EEPROM_ADDRESS:
+ *  - r_zero: Calibrated R0 in ohms.
+ *  - num_of_samples: Number of samples the R0 was computed from.
+ *  - magic: SENSORS_CALIBRATION_RECORD_MAGIC, an erased EEPROM reads 0xFF.
+ *  - check: Inverted XOR of the other bytes.
+ */
+
+/* Slots of the EEPROM records, one per sensor */
+#define SENSORS_CALIBRATION_SLOT_MQ135          (uint8_t)(0u)
+#define SENSORS_CALIBRATION_SLOT_MQ7            (uint8_t)(1u)
+#define SENSORS_CALIBRATION_NUM_OF_SLOTS        (uint8_t)(2u)
+
+/* Location of the records in the EEPROM, the settings of other modules must start behind SENSORS_CALIBRATION_EEPROM_END */
+#define SENSORS_CALIBRATION_EEPROM_ADDRESS      (uint16_t)(0u)
+#define SENSORS_CALIBRATION_EEPROM_END          (uint16_t)(SENSORS_CALIBRATION_EEPROM_ADDRESS + SENSORS_CALIBRATION_NUM_OF_SLOTS * sizeof(sensors_calibration_record_ts))
+
+/* Marks a written record */
+#define SENSORS_CALIBRATION_RECORD_MAGIC        (uint8_t)(0xC7u)
+
+/* Calibration states */
+#define SENSORS_CALIBRATION_IDLE                (uint8_t)(0u)
+#define SENSORS_CALIBRATION_WARM_UP             (uint8_t)(1u)
+#define SENSORS_CALIBRATION_SAMPLING            (uint8_t)(2u)
+#define SENSORS_CALIBRATION_EVALUATING          (uint8_t)(3u)
+
+/* Flags returned by sensors_calibration_isActive() and sensors_calibration_isNeeded() */
+#define SENSORS_CALIBRATION_ACTIVE              (bool)(true)
+#define SENSORS_CALIBRATION_NOT_ACTIVE          (bool)(false)
+#define SENSORS_CALIBRATION_NEEDED              (bool)(true)
+#define SENSORS_CALIBRATION_NOT_NEEDED          (bool)(false)
+
+/* Value of the sensor ID of sensors_calibration_service() when no sensor was evaluated */
+#define SENSORS_CALIBRATION_NO_SENSOR           (uint8_t)(INVALID_SENSOR_ID)
+
+/**
+ * @brief Record of the calibrated R0 of one sensor in the EEPROM.
+ */
+typedef struct
+{
+  float r_zero;
+  uint16_t num_of_samples;
+  uint8_t magic;
+  uint8_t check;
+} sensors_calibration_record_ts;
+
+/**
+ * @brief Running statistics of the resistance samples of one sensor (Welford).
+ *
+ * Members:
+ *  - mean: Mean of the samples in ohms.
+ *  - m2: Sum of the squared differences to the mean.
+ *  - num_of_samples: Number of samples.
+ */
+typedef struct
+{
+  float mean;
+  float m2;
+  uint16_t num_of_samples;
+} sensors_calibration_stats_ts;
+
+/**
+ * @brief Reads the calibrated R0 of a sensor from the EEPROM.
+ *
+ * @param slot SENSORS_CALIBRATION_SLOT_MQ135 or SENSORS_CALIBRATION_SLOT_MQ7.
+ * @param default_r_zero R0 which is returned if the sensor was never calibrated.
+ * @return float Calibrated R0 in ohms or default_r_zero if the record is missing or damaged.
+ */
+float sensors_calibration_loadResistanceZero(uint8_t slot, float default_r_zero);
+
+/**
+ * @brief Starts a calibration of every enabled MQ sensor, a running calibration is started over.
+ *
+ * The station must be in clean air until the calibration is finished (warm-up plus window).
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void sensors_calibration_start(uint32_t current_millis);
+
+/**
+ * @brief Checks if a calibration was started and is not finished yet.
+ *
+ * @return true (SENSORS_CALIBRATION_ACTIVE) if the calibration is running.
+ */
+bool sensors_calibration_isActive();
+
+/**
+ * @brief Checks if an enabled MQ sensor has no calibrated R0 in the EEPROM.
+ *
+ * @return true (SENSORS_CALIBRATION_NEEDED) if a sensor still uses the R0 of sensors_config.h.
+ */
+bool sensors_calibration_isNeeded();
+
+/**
+ * @brief Takes the resistance samples and evaluates them at the end of the window.
+ *
+ * NEEDS TO BE CALLED IN A LOOP while the calibration is active, at least once per
+ * SENSORS_MQ7_SAMPLE_WINDOW_MS so no low heater phase of MQ7 is missed. One sensor is evaluated
+ * per call, the calibration is finished after the call which evaluated the last one.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @param sensor_id Receives the ID of the evaluated sensor or SENSORS_CALIBRATION_NO_SENSOR.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Calibration is running or the evaluated sensor got its new R0.
+ * - ERROR_CODE_CALIBRATION_TOO_FEW_SAMPLES: Evaluated sensor had less than SENSORS_MQ_CALIBRATION_MIN_SAMPLES valid samples.
+ * - ERROR_CODE_CALIBRATION_UNSTABLE: Samples of the evaluated sensor spread more than SENSORS_MQ_CALIBRATION_MAX_DEVIATION_PERCENT.
+ */
+control_error_code_te sensors_calibration_service(uint32_t current_millis, uint8_t *sensor_id);
+
+#endif
@@ -0,0 +1,145 @@
+#include "sensor_derived.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* ln(1 + i / 16) in Q16, the mantissa of the logarithm is interpolated between the entries */
+static const int32_t ln_mantissa_q16[SENSOR_DERIVED_LN_TABLE_SIZE] PLATFORM_PROGMEM =
+{
+  0, 3973, 7719, 11262, 14624, 17821, 20870, 23783, 26573, 29248, 31818, 34292, 36675, 38975, 41196, 43345, 45426
+};
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(-500 <= (SENSORS_DERIVED_STATION_ALTITUDE_M) && 1500 >= (SENSORS_DERIVED_STATION_ALTITUDE_M),
+              "Station altitude must be in range -500..1500 m, the series of the exponential is accurate there");
+static_assert(SENSOR_DERIVED_INPUT_DECIMALS == 2u, "Derivations are computed in hundredths");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Dew point, Magnus formula Td = c * g / (b - g) with g = ln(RH / 100) + b * T / (c + T).
+ *
+ * @param temperature Temperature in hundredths of C, above -c.
+ * @param humidity Relative humidity in hundredths of %.
+ * @return int32_t Dew point in hundredths of C or SENSOR_VALUE_SCALED_INVALID for a humidity of zero.
+ */
+static int32_t computeDewPoint(int32_t temperature, int32_t humidity);
+
+/**
+ * @brief Heat index, Rothfusz regression in Celsius evaluated with Horner's scheme in Q32.
+ *
+ * @param temperature Temperature in hundredths of C.
+ * @param humidity Relative humidity in hundredths of %.
+ * @return int32_t Heat index in hundredths of C.
+ */
+static int32_t computeHeatIndex(int32_t temperature, int32_t humidity);
+
+/**
+ * @brief Sea-level pressure, P0 = P * exp(h / (29.27 * T)) with four terms of the series of the exponential (Horner's scheme).
+ *
+ * @param temperature Station temperature in hundredths of C.
+ * @param pressure Station pressure in hundredths of hPa.
+ * @return int32_t Sea-level pressure in hundredths of hPa.
+ */
+static int32_t computeSeaLevelPressure(int32_t temperature, int32_t pressure);
+
+/**
+ * @brief Natural logarithm of a positive integer.
+ *
+ * @param value Positive value.
+ * @return int32_t ln(value) in Q16.
+ */
+static int32_t lnQ16(uint32_t value);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+int32_t sensor_derived_compute(uint8_t derivation, const int32_t *inputs)
+{
+  int32_t temperature = inputs[SENSOR_DERIVED_INPUT_TEMPERATURE];
+  switch(derivation)
+  {
+    case SENSOR_DERIVED_DEW_POINT:
+      return computeDewPoint(temperature, inputs[1]);
+
+    case SENSOR_DERIVED_HEAT_INDEX:
+      return computeHeatIndex(temperature, inputs[1]);
+
+    case SENSOR_DERIVED_SEA_LEVEL_PRESSURE:
+      return computeSeaLevelPressure(temperature, inputs[1]);
+
+    default:
+      return SENSOR_VALUE_SCALED_INVALID;
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static int32_t computeDewPoint(int32_t temperature, int32_t humidity)
+{
+  if(0 >= humidity || -SENSOR_DERIVED_MAGNUS_C_CENTI >= temperature)
+  {
+    return SENSOR_VALUE_SCALED_INVALID; // No water in the air, the logarithm has no value
+  }
+
+  // ln(RH / 100 %) is not positive, b * T / (c + T) is below b, so g stays below b
+  int32_t ln_humidity_q12 = (lnQ16((uint32_t)humidity) - SENSOR_DERIVED_LN_FULL_HUMIDITY_Q16 + 8) >> 4;
+  int32_t gamma_q12 = ln_humidity_q12 + (SENSOR_DERIVED_MAGNUS_B_Q12 * temperature) / (SENSOR_DERIVED_MAGNUS_C_CENTI + temperature);
+  return (SENSOR_DERIVED_MAGNUS_C_CENTI * gamma_q12) / (SENSOR_DERIVED_MAGNUS_B_Q12 - gamma_q12);
+}
+
+static int32_t computeHeatIndex(int32_t temperature, int32_t humidity)
+{
+  int32_t steadman = temperature + temperature / 10 - SENSOR_DERIVED_STEADMAN_OFFSET_CENTI +
+                     (humidity * SENSOR_DERIVED_STEADMAN_RH_FACTOR) / 100000;
+  if((steadman + temperature) / 2 < SENSOR_DERIVED_HEAT_INDEX_ROTHFUSZ_CENTI)
+  {
+    return steadman; // Regression is fitted for hot air only
+  }
+
+  // Temperature and humidity in Q8 of their unit, every product is shifted back to Q32
+  int64_t t = ((int64_t)temperature << 8) / SENSOR_DERIVED_SCALE;
+  int64_t rh = ((int64_t)humidity << 8) / SENSOR_DERIVED_SCALE;
+  int64_t a = SENSOR_DERIVED_ROTHFUSZ_C1 + ((rh * (SENSOR_DERIVED_ROTHFUSZ_C3 + ((rh * SENSOR_DERIVED_ROTHFUSZ_C6) >> 8))) >> 8);
+  int64_t b = SENSOR_DERIVED_ROTHFUSZ_C2 + ((rh * (SENSOR_DERIVED_ROTHFUSZ_C4 + ((rh * SENSOR_DERIVED_ROTHFUSZ_C8) >> 8))) >> 8);
+  int64_t c = SENSOR_DERIVED_ROTHFUSZ_C5 + ((rh * (SENSOR_DERIVED_ROTHFUSZ_C7 + ((rh * SENSOR_DERIVED_ROTHFUSZ_C9) >> 8))) >> 8);
+  int64_t heat_index_q32 = a + ((t * (b + ((t * c) >> 8))) >> 8);
+
+  return (int32_t)((heat_index_q32 * SENSOR_DERIVED_SCALE + ((int64_t)1 << 31)) >> 32);
+}
+
+static int32_t computeSeaLevelPressure(int32_t temperature, int32_t pressure)
+{
+  int32_t column_temperature = temperature + SENSOR_DERIVED_ZERO_CELSIUS_CENTI + SENSOR_DERIVED_COLUMN_LAPSE_CENTI;
+  if(0 >= column_temperature)
+  {
+    return SENSOR_VALUE_SCALED_INVALID;
+  }
+
+  // exp(x) - 1 = x * (1 + x / 2 * (1 + x / 3 * (1 + x / 4))) in Q16, x is at most 0.21 for the allowed altitudes
+  int32_t x = (SENSOR_DERIVED_EXPONENT_NUMERATOR + ((0 > SENSOR_DERIVED_EXPONENT_NUMERATOR) ? -column_temperature : column_temperature) / 2) /
+              column_temperature;
+  int32_t series = SENSOR_DERIVED_Q16_ONE + x / 4;
+  series = SENSOR_DERIVED_Q16_ONE + (x * series) / (3 * SENSOR_DERIVED_Q16_ONE);
+  series = SENSOR_DERIVED_Q16_ONE + ((x * series + SENSOR_DERIVED_Q16_HALF) >> 17);
+  int32_t growth_q16 = (x * series + SENSOR_DERIVED_Q16_HALF) >> 16;
+
+  return pressure + (int32_t)(((int64_t)pressure * growth_q16 + SENSOR_DERIVED_Q16_HALF) >> 16);
+}
+
+static int32_t lnQ16(uint32_t value)
+{
+  // value = 2^exponent * (1 + fraction), fraction in Q16
+  uint8_t exponent = 0u;
+  while(31u > exponent && value >= ((uint32_t)2u << exponent))
+  {
+    exponent++;
+  }
+  uint32_t fraction = (exponent <= 16u) ? ((value << (16u - exponent)) - 65536u) : ((value >> (exponent - 16u)) - 65536u);
+
+  uint8_t entry = (uint8_t)(fraction >> 12);
+  int32_t low = (int32_t)PLATFORM_READ_DWORD(&ln_mantissa_q16[entry]);
+  int32_t high = (int32_t)PLATFORM_READ_DWORD(&ln_mantissa_q16[entry + 1u]);
+  int32_t mantissa = low + (int32_t)(((high - low) * (int32_t)(fraction & 0x0FFFu)) >> 12);
+
+  return (int32_t)exponent * SENSOR_DERIVED_LN2_Q16 + mantissa;
+}
+/* *************************************** */
@@ -0,0 +1,85 @@
+#ifndef SENSOR_DERIVED_H
+#define SENSOR_DERIVED_H
+
+#include <Arduino.h>
+#include "../sensor_value/sensor_value.h"
+
+/**
+ * @file sensor_derived.h
+ * @brief Measurements computed from the cached readings of other measurements, without a driver.
+ *
+ * A derived measurement has a derivation instead of a driver function in its catalog entry. Its inputs are
+ * handed in hundredths of their unit (SENSOR_DERIVED_INPUT_DECIMALS), the temperature first, and the math
+ * is integer only, so the AVR needs no log() or exp() and the result is the same in float mode:
+ *  - SENSOR_DERIVED_DEW_POINT: Magnus formula from temperature (C) and relative humidity (%). The logarithm
+ *    is the exponent of two plus a table of ln(1 + i / 16) with linear interpolation, error below 0.03 C.
+ *  - SENSOR_DERIVED_HEAT_INDEX: Rothfusz regression of the NWS in Celsius from temperature (C) and relative
+ *    humidity (%), the simple formula of Steadman where its mean with the temperature is below 26.7 C, error below 0.05 C.
+ *  - SENSOR_DERIVED_SEA_LEVEL_PRESSURE: Hypsometric formula from station temperature (C) and pressure (hPa)
+ *    for SENSORS_DERIVED_STATION_ALTITUDE_M, the mean temperature of the air column follows the standard lapse rate.
+ *    The exponential is a series of four terms, error below 0.03 hPa.
+ */
+
+/* Derivations of a measurement */
+#define SENSOR_DERIVED_NONE                   (uint8_t)(0u) /* Measurement has a driver */
+#define SENSOR_DERIVED_DEW_POINT              (uint8_t)(1u)
+#define SENSOR_DERIVED_HEAT_INDEX             (uint8_t)(2u)
+#define SENSOR_DERIVED_SEA_LEVEL_PRESSURE     (uint8_t)(3u)
+#define SENSOR_DERIVED_NUM_OF_DERIVATIONS     (uint8_t)(4u)
+
+/* Number of inputs of every derivation, the temperature is the first one */
+#define SENSOR_DERIVED_NUM_OF_INPUTS          (uint8_t)(2u)
+#define SENSOR_DERIVED_INPUT_TEMPERATURE      (uint8_t)(0u)
+
+/* Decimals of the inputs and of the result */
+#define SENSOR_DERIVED_INPUT_DECIMALS         (uint8_t)(2u)
+
+/* Hundredths of the inputs and the result */
+#define SENSOR_DERIVED_SCALE                  (int32_t)(100)
+/* One and one half in Q16 */
+#define SENSOR_DERIVED_Q16_ONE                (int32_t)(65536)
+#define SENSOR_DERIVED_Q16_HALF               (int32_t)(32768)
+
+/* Entries of the table of ln(1 + i / 16), i = 0..16 */
+#define SENSOR_DERIVED_LN_TABLE_SIZE          (uint8_t)(17u)
+
+/* Magnus coefficients (Sonntag 1990), b in Q12 and c in hundredths of C */
+#define SENSOR_DERIVED_MAGNUS_B_Q12           (int32_t)(72172)   /* 17.62 */
+#define SENSOR_DERIVED_MAGNUS_C_CENTI         (int32_t)(24312)   /* 243.12 C */
+/* ln(2) and ln(100 %) in Q16 */
+#define SENSOR_DERIVED_LN2_Q16                (int32_t)(45426)
+#define SENSOR_DERIVED_LN_FULL_HUMIDITY_Q16   (int32_t)(603609)  /* ln(10000 hundredths) */
+
+/* Steadman: HI = 1.1 T - 3.944 + 0.02611 RH, used while its mean with the temperature is below 26.7 C */
+#define SENSOR_DERIVED_HEAT_INDEX_ROTHFUSZ_CENTI  (int32_t)(2670)
+#define SENSOR_DERIVED_STEADMAN_OFFSET_CENTI      (int32_t)(394)
+#define SENSOR_DERIVED_STEADMAN_RH_FACTOR         (int32_t)(2611)    /* Per 100000 */
+
+/* Coefficients of the Rothfusz regression in Celsius, in Q32 */
+#define SENSOR_DERIVED_Q32(value)             (int64_t)((value) * 4294967296.0)
+#define SENSOR_DERIVED_ROTHFUSZ_C1            SENSOR_DERIVED_Q32(-8.78469475556)
+#define SENSOR_DERIVED_ROTHFUSZ_C2            SENSOR_DERIVED_Q32(1.61139411)
+#define SENSOR_DERIVED_ROTHFUSZ_C3            SENSOR_DERIVED_Q32(2.33854883889)
+#define SENSOR_DERIVED_ROTHFUSZ_C4            SENSOR_DERIVED_Q32(-0.14611605)
+#define SENSOR_DERIVED_ROTHFUSZ_C5            SENSOR_DERIVED_Q32(-0.012308094)
+#define SENSOR_DERIVED_ROTHFUSZ_C6            SENSOR_DERIVED_Q32(-0.0164248277778)
+#define SENSOR_DERIVED_ROTHFUSZ_C7            SENSOR_DERIVED_Q32(0.002211732)
+#define SENSOR_DERIVED_ROTHFUSZ_C8            SENSOR_DERIVED_Q32(0.00072546)
+#define SENSOR_DERIVED_ROTHFUSZ_C9            SENSOR_DERIVED_Q32(-0.000003582)
+
+/* Hypsometric formula, exponent h / (Rd / g * T) with Rd / g = 29.27 m/K, T is the mean of the air column in hundredths of K */
+#define SENSOR_DERIVED_ZERO_CELSIUS_CENTI     (int32_t)(27315)
+#define SENSOR_DERIVED_COLUMN_LAPSE_CENTI     (int32_t)((SENSORS_DERIVED_STATION_ALTITUDE_M) * 0.325 + (((SENSORS_DERIVED_STATION_ALTITUDE_M) < 0) ? -0.5 : 0.5))
+#define SENSOR_DERIVED_EXPONENT_NUMERATOR     (int32_t)((SENSORS_DERIVED_STATION_ALTITUDE_M) * 100.0 * 65536.0 / 29.27)
+
+/**
+ * @brief Computes a derived measurement.
+ *
+ * @param derivation SENSOR_DERIVED_* of the catalog entry, not SENSOR_DERIVED_NONE.
+ * @param inputs Inputs in hundredths, SENSOR_DERIVED_NUM_OF_INPUTS of them, temperature first.
+ * @return int32_t Result in hundredths of its unit or SENSOR_VALUE_SCALED_INVALID if the inputs have no result
+ *         (humidity of zero or an unknown derivation).
+ */
+int32_t sensor_derived_compute(uint8_t derivation, const int32_t *inputs);
+
+#endif
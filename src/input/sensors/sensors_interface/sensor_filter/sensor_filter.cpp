@@ -0,0 +1,161 @@
+#include "sensor_filter.h"
+
+/* COMPILE TIME CHECKS */
+static_assert(3u == SENSOR_FILTER_MEDIAN_WINDOW, "Median is computed for a window of three samples");
+static_assert(31u > SENSOR_FILTER_EMA_FRACTION_BITS + SENSOR_FILTER_EMA_MAX_SHIFT, "EMA accumulator must fit 32 bits");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Exponential moving average, history[0] is the accumulator.
+ *
+ * @param state State of the filter.
+ * @param shift Weight of the new sample is 1 / 2^shift.
+ * @param value New sample.
+ * @return sensor_value_t Average, rounded to the last decimal.
+ */
+static sensor_value_t applyEma(sensor_filter_state_ts *state, uint8_t shift, sensor_value_t value);
+
+/**
+ * @brief Median of the new sample and the two previous ones.
+ *
+ * @param state State of the filter.
+ * @param value New sample.
+ * @return sensor_value_t Median, the new sample until two previous ones are known.
+ */
+static sensor_value_t applyMedian(sensor_filter_state_ts *state, sensor_value_t value);
+
+/**
+ * @brief Moves the last output towards the new sample by at most max_step, history[0] is the last output.
+ *
+ * @param state State of the filter.
+ * @param max_step Largest change of the output per sample.
+ * @param value New sample.
+ * @return sensor_value_t New output.
+ */
+static sensor_value_t applyRateLimit(sensor_filter_state_ts *state, sensor_value_t max_step, sensor_value_t value);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+sensor_value_t sensor_filter_apply(sensor_filter_state_ts *state, uint8_t filter, sensor_value_t parameter, sensor_value_t value)
+{
+  switch(filter)
+  {
+    case SENSOR_FILTER_EMA:
+      return applyEma(state, (uint8_t)parameter, value);
+
+    case SENSOR_FILTER_MEDIAN:
+      return applyMedian(state, value);
+
+    case SENSOR_FILTER_RATE_LIMIT:
+      return applyRateLimit(state, parameter, value);
+
+    default:
+      return value; // SENSOR_FILTER_NONE
+  }
+}
+
+void sensor_filter_reset(sensor_filter_state_ts *state)
+{
+  state->num_of_samples = SENSOR_FILTER_NO_SAMPLES;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static sensor_value_t applyEma(sensor_filter_state_ts *state, uint8_t shift, sensor_value_t value)
+{
+#ifdef SENSORS_FIXED_POINT_VALUES
+  if(SENSOR_FILTER_EMA_MAX_INPUT < value || -SENSOR_FILTER_EMA_MAX_INPUT > value)
+  {
+    state->num_of_samples = SENSOR_FILTER_NO_SAMPLES; // Does not fit the accumulator, average starts over with the next sample
+    return value;
+  }
+
+  int32_t scaled_value = value * ((int32_t)1 << SENSOR_FILTER_EMA_FRACTION_BITS);
+  if(SENSOR_FILTER_NO_SAMPLES == state->num_of_samples)
+  {
+    state->history[0] = scaled_value; // First sample seeds the average
+    state->num_of_samples = 1u;
+  }
+  else
+  {
+    state->history[0] += (scaled_value - state->history[0]) >> shift; // Arithmetic shift, rounds towards minus infinity
+  }
+  return (state->history[0] + ((int32_t)1 << (SENSOR_FILTER_EMA_FRACTION_BITS - 1u))) >> SENSOR_FILTER_EMA_FRACTION_BITS;
+#else
+  if(SENSOR_FILTER_NO_SAMPLES == state->num_of_samples)
+  {
+    state->history[0] = value;
+    state->num_of_samples = 1u;
+  }
+  else
+  {
+    state->history[0] += (value - state->history[0]) / (float)(1u << shift);
+  }
+  return state->history[0];
+#endif
+}
+
+static sensor_value_t applyMedian(sensor_filter_state_ts *state, sensor_value_t value)
+{
+  sensor_value_t newest = state->history[0];
+  sensor_value_t oldest = state->history[1];
+  sensor_value_t median = value;
+
+  if(SENSOR_FILTER_MEDIAN_WINDOW - 1u <= state->num_of_samples)
+  {
+    // Middle one of three, without sorting
+    if((newest <= value) == (value <= oldest))
+    {
+      median = value;
+    }
+    else if((value <= newest) == (newest <= oldest))
+    {
+      median = newest;
+    }
+    else
+    {
+      median = oldest;
+    }
+  }
+  else
+  {
+    state->num_of_samples++;
+  }
+
+  state->history[1] = newest;
+  state->history[0] = value;
+  return median;
+}
+
+static sensor_value_t applyRateLimit(sensor_filter_state_ts *state, sensor_value_t max_step, sensor_value_t value)
+{
+  if(SENSOR_FILTER_NO_SAMPLES != state->num_of_samples)
+  {
+    sensor_value_t last_output = state->history[0];
+#ifdef SENSORS_FIXED_POINT_VALUES
+    // Unsigned difference does not overflow for any two values
+    if(value > last_output && (uint32_t)value - (uint32_t)last_output > (uint32_t)max_step)
+    {
+      value = last_output + max_step;
+    }
+    else if(value < last_output && (uint32_t)last_output - (uint32_t)value > (uint32_t)max_step)
+    {
+      value = last_output - max_step;
+    }
+#else
+    if(value - last_output > max_step)
+    {
+      value = last_output + max_step;
+    }
+    else if(last_output - value > max_step)
+    {
+      value = last_output - max_step;
+    }
+#endif
+  }
+  state->history[0] = value;
+  state->num_of_samples = 1u;
+  return value;
+}
+/* *************************************** */
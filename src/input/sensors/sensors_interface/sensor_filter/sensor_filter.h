@@ -0,0 +1,78 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <Arduino.h>
+#include "../sensor_value/sensor_value.h"
+
+/**
+ * @file sensor_filter.h
+ * @brief Filter stage between the driver reading and the range check of a measurement.
+ *
+ * The filter of a measurement is chosen in its catalog entry, every sample of the measurement passes it
+ * once. The state is two values per measurement, whatever the filter is:
+ *  - SENSOR_FILTER_EMA: Exponential moving average y += (x - y) / 2^parameter. With
+ *    SENSORS_FIXED_POINT_VALUES the average keeps SENSOR_FILTER_EMA_FRACTION_BITS below the last decimal,
+ *    so it settles on the input instead of stopping a few steps away from it.
+ *  - SENSOR_FILTER_MEDIAN: Median of the last SENSOR_FILTER_MEDIAN_WINDOW samples, removes single spikes
+ *    without delaying steps more than one sample. For indications it is the majority of the samples.
+ *  - SENSOR_FILTER_RATE_LIMIT: Output follows the input by at most parameter per sample (a value of the
+ *    measurement, in its unit), a slow signal is not pulled away by a wrong sample.
+ * A filter is started over when the driver returns no value, the first sample afterwards passes unchanged.
+ */
+
+/* Filters of a measurement */
+#define SENSOR_FILTER_NONE                (uint8_t)(0u)
+#define SENSOR_FILTER_EMA                 (uint8_t)(1u)
+#define SENSOR_FILTER_MEDIAN              (uint8_t)(2u)
+#define SENSOR_FILTER_RATE_LIMIT          (uint8_t)(3u)
+
+/* Parameter of the filters which have none */
+#define SENSOR_FILTER_NO_PARAMETER        (0)
+
+/* Smoothing of the EMA, the weight of a new sample is 1 / 2^shift */
+#define SENSOR_FILTER_EMA_MIN_SHIFT       (uint8_t)(1u)
+#define SENSOR_FILTER_EMA_MAX_SHIFT       (uint8_t)(7u)
+/* Bits below the last decimal of the EMA accumulator */
+#define SENSOR_FILTER_EMA_FRACTION_BITS   (uint8_t)(6u)
+/* Largest input of the EMA, the accumulator and the difference to it stay in the 32-bit range */
+#define SENSOR_FILTER_EMA_MAX_INPUT       (int32_t)(INT32_MAX >> (SENSOR_FILTER_EMA_FRACTION_BITS + 2u))
+
+/* Samples of the median, the two previous ones are kept */
+#define SENSOR_FILTER_MEDIAN_WINDOW       (uint8_t)(3u)
+
+/* Number of samples in the state after a restart */
+#define SENSOR_FILTER_NO_SAMPLES          (uint8_t)(0u)
+
+/**
+ * @brief State of the filter of one measurement.
+ *
+ * Members:
+ *  - history: EMA accumulator or last output of the rate limiter in history[0],
+ *             the two previous samples of the median (newest first).
+ *  - num_of_samples: Number of samples in the history, saturates at SENSOR_FILTER_MEDIAN_WINDOW - 1.
+ */
+typedef struct
+{
+  sensor_value_t history[SENSOR_FILTER_MEDIAN_WINDOW - 1u];
+  uint8_t num_of_samples;
+} sensor_filter_state_ts;
+
+/**
+ * @brief Passes one sample through the filter of a measurement.
+ *
+ * @param state State of the filter of the measurement.
+ * @param filter SENSOR_FILTER_* of the catalog entry.
+ * @param parameter Parameter of the catalog entry (EMA shift or largest step of the rate limiter).
+ * @param value Sample from the driver, must not be SENSOR_VALUE_INVALID (reset the filter instead).
+ * @return sensor_value_t Filtered sample.
+ */
+sensor_value_t sensor_filter_apply(sensor_filter_state_ts *state, uint8_t filter, sensor_value_t parameter, sensor_value_t value);
+
+/**
+ * @brief Starts the filter of a measurement over, the next sample passes unchanged.
+ *
+ * @param state State of the filter of the measurement.
+ */
+void sensor_filter_reset(sensor_filter_state_ts *state);
+
+#endif
@@ -0,0 +1,144 @@
+#include "sensor_value.h"
+
+/* STATIC GLOBAL VARIABLES */
+static const int32_t powers_of_ten[SENSOR_VALUE_MAX_DECIMALS + 1u] PLATFORM_PROGMEM = {1, 10, 100, 1000, 10000};
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(sensor_value_pow10(SENSOR_VALUE_MAX_DECIMALS) == 10000, "powers_of_ten must have an entry for every supported number of decimals");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Reads 10^exponent from program memory.
+ *
+ * @param exponent Exponent, limited to SENSOR_VALUE_MAX_DECIMALS.
+ */
+static int32_t powerOfTen(uint8_t exponent);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+sensor_value_t sensor_value_fromFloat(float value, uint8_t num_of_decimals)
+{
+#ifdef SENSORS_FIXED_POINT_VALUES
+  float scaled_value = value * (float)powerOfTen(num_of_decimals);
+  if(scaled_value <= (float)INT32_MIN || scaled_value >= (float)INT32_MAX)
+  {
+    return SENSOR_VALUE_INVALID;
+  }
+  return (sensor_value_t)lround(scaled_value);
+#else
+  (void)num_of_decimals;
+  return value;
+#endif
+}
+
+size_t sensor_value_format(char *buffer, size_t size, sensor_value_t value, uint8_t num_of_decimals)
+{
+  if(0u == size)
+  {
+    return 0u;
+  }
+
+#ifdef SENSORS_FIXED_POINT_VALUES
+  // Digits are produced from the lowest one, so the text is built in reverse
+  char reversed[SENSOR_VALUE_FORMAT_BUFFER_SIZE];
+  uint8_t len = 0u;
+  uint32_t magnitude = (0 > value) ? (uint32_t)0u - (uint32_t)value : (uint32_t)value;
+
+  if(SENSOR_VALUE_MAX_DECIMALS < num_of_decimals)
+  {
+    num_of_decimals = SENSOR_VALUE_MAX_DECIMALS;
+  }
+  for (uint8_t decimal = 0u; decimal < num_of_decimals; decimal++)
+  {
+    reversed[len++] = (char)('0' + (magnitude % 10u));
+    magnitude /= 10u;
+  }
+  if(0u < num_of_decimals)
+  {
+    reversed[len++] = '.';
+  }
+  do
+  {
+    reversed[len++] = (char)('0' + (magnitude % 10u));
+    magnitude /= 10u;
+  } while(0u < magnitude);
+  if(0 > value)
+  {
+    reversed[len++] = '-';
+  }
+
+  size_t written = 0u;
+  while(0u < len && written < size - 1u)
+  {
+    buffer[written++] = reversed[--len];
+  }
+  buffer[written] = '\0';
+  return written;
+#else
+  char formatted[SENSOR_VALUE_FORMAT_BUFFER_SIZE];
+  dtostrf(value, 1, num_of_decimals, formatted);
+  strncpy(buffer, formatted, size - 1u);
+  buffer[size - 1u] = '\0';
+  return strlen(buffer);
+#endif
+}
+
+int32_t sensor_value_toDecimals(sensor_value_t value, uint8_t num_of_decimals, uint8_t target_decimals)
+{
+#ifdef SENSORS_FIXED_POINT_VALUES
+  if(SENSOR_VALUE_INVALID == value)
+  {
+    return SENSOR_VALUE_SCALED_INVALID;
+  }
+  if(target_decimals >= num_of_decimals)
+  {
+    int32_t factor = powerOfTen((uint8_t)(target_decimals - num_of_decimals));
+    if(value > INT32_MAX / factor || value <= INT32_MIN / factor)
+    {
+      return SENSOR_VALUE_SCALED_INVALID;
+    }
+    return value * factor;
+  }
+  // Fewer decimals, divide and round half away from zero
+  int32_t divisor = powerOfTen((uint8_t)(num_of_decimals - target_decimals));
+  return (0 > value) ? (value - divisor / 2) / divisor : (value + divisor / 2) / divisor;
+#else
+  (void)num_of_decimals;
+  float scaled_value = value * (float)powerOfTen(target_decimals);
+  // NaN fails both comparisons
+  if(scaled_value > (float)INT32_MIN && scaled_value < (float)INT32_MAX)
+  {
+    return (int32_t)lround(scaled_value);
+  }
+  return SENSOR_VALUE_SCALED_INVALID;
+#endif
+}
+
+sensor_value_t sensor_value_fromDecimals(int32_t scaled_value, uint8_t source_decimals, uint8_t num_of_decimals)
+{
+  if(SENSOR_VALUE_SCALED_INVALID == scaled_value)
+  {
+    return SENSOR_VALUE_INVALID;
+  }
+#ifdef SENSORS_FIXED_POINT_VALUES
+  // Same scaling as to fixed decimals, the invalid markers of both are INT32_MIN
+  return (sensor_value_t)sensor_value_toDecimals((sensor_value_t)scaled_value, source_decimals, num_of_decimals);
+#else
+  (void)num_of_decimals;
+  return (sensor_value_t)scaled_value / (sensor_value_t)powerOfTen(source_decimals);
+#endif
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static int32_t powerOfTen(uint8_t exponent)
+{
+  if(SENSOR_VALUE_MAX_DECIMALS < exponent)
+  {
+    exponent = SENSOR_VALUE_MAX_DECIMALS;
+  }
+  return (int32_t)PLATFORM_READ_DWORD(&powers_of_ten[exponent]);
+}
+/* *************************************** */
@@ -0,0 +1,112 @@
+#ifndef SENSOR_VALUE_H
+#define SENSOR_VALUE_H
+
+#include <Arduino.h>
+#include "../../../../platform/platform.h"
+#include "../../sensor_library/sensors_config.h"
+
+/**
+ * @file sensor_value.h
+ * @brief Representation of sensor values between the drivers and the outputs.
+ *
+ * With SENSORS_FIXED_POINT_VALUES (sensors_config.h) a value is a scaled integer, the real value
+ * multiplied by 10^num_of_decimals of the catalog entry (for example 23.4 C with 1 decimal is 234).
+ * Driver reading is converted once, range checks, formatting and binary frames afterwards use
+ * only integer math. Without it values stay float and the same functions wrap the float math.
+ */
+
+/* Highest number of decimals supported for scaled values */
+#define SENSOR_VALUE_MAX_DECIMALS         (uint8_t)(4u)
+
+/* Size of the buffer needed for formatting any value, sign, 10 digits, decimal point and null terminator */
+#define SENSOR_VALUE_FORMAT_BUFFER_SIZE   (uint8_t)(20u)
+
+/* Returned by sensor_value_toDecimals when the value can not be represented */
+#define SENSOR_VALUE_SCALED_INVALID       (int32_t)(INT32_MIN)
+
+#ifdef SENSORS_FIXED_POINT_VALUES
+/* Scaled integer, real value * 10^num_of_decimals */
+typedef int32_t sensor_value_t;
+
+/* Invalid value, outside of every range */
+#define SENSOR_VALUE_INVALID              (sensor_value_t)(INT32_MIN)
+
+/* Reads a value stored in program memory */
+#define SENSOR_VALUE_PGM_READ(address)    (sensor_value_t)(PLATFORM_READ_DWORD(address))
+#else
+typedef float sensor_value_t;
+
+#define SENSOR_VALUE_INVALID              (sensor_value_t)(NAN)
+
+#define SENSOR_VALUE_PGM_READ(address)    (sensor_value_t)(PLATFORM_READ_FLOAT(address))
+#endif
+
+/**
+ * @brief Power of ten for scaling values at compile time.
+ *
+ * @param num_of_decimals Exponent (recursive, C++11 constexpr).
+ */
+static constexpr int32_t sensor_value_pow10(uint8_t num_of_decimals)
+{
+    return (0u == num_of_decimals) ? 1 : 10 * sensor_value_pow10(num_of_decimals - 1u);
+}
+
+#ifdef SENSORS_FIXED_POINT_VALUES
+/* Converts a constant from sensors_config.h (for example catalog range) at compile time, rounded to nearest */
+#define SENSOR_VALUE_FROM_CONSTANT(value, num_of_decimals) \
+    (sensor_value_t)((double)(value) * sensor_value_pow10(num_of_decimals) + (((value) < 0) ? -0.5 : 0.5))
+
+/* Checks at compile time that a scaled constant fits the value type */
+#define SENSOR_VALUE_CONSTANT_FITS(value, num_of_decimals) \
+    ((double)(value) * sensor_value_pow10(num_of_decimals) > (double)INT32_MIN && \
+     (double)(value) * sensor_value_pow10(num_of_decimals) < (double)INT32_MAX)
+#else
+#define SENSOR_VALUE_FROM_CONSTANT(value, num_of_decimals) (sensor_value_t)(value)
+#define SENSOR_VALUE_CONSTANT_FITS(value, num_of_decimals) (true)
+#endif
+
+/**
+ * @brief Converts a driver reading to a sensor value.
+ *
+ * The only place where float math is needed in fixed-point mode, called once per reading.
+ *
+ * @param value Driver reading, must not be NaN.
+ * @param num_of_decimals Number of decimals of the catalog entry.
+ * @return sensor_value_t Converted value or SENSOR_VALUE_INVALID if it does not fit the value type.
+ */
+sensor_value_t sensor_value_fromFloat(float value, uint8_t num_of_decimals);
+
+/**
+ * @brief Formats a value with the given number of decimals.
+ *
+ * In fixed-point mode only integer math is used (no dtostrf).
+ *
+ * @param buffer Destination buffer, always null terminated, text is cut if the buffer is too small.
+ * @param size Size of the buffer.
+ * @param value Value to format.
+ * @param num_of_decimals Number of decimals of the catalog entry.
+ * @return size_t Number of characters written (without null terminator).
+ */
+size_t sensor_value_format(char *buffer, size_t size, sensor_value_t value, uint8_t num_of_decimals);
+
+/**
+ * @brief Converts a value to an integer with a fixed number of decimals (for example for binary frames).
+ *
+ * @param value Value to convert.
+ * @param num_of_decimals Number of decimals of the catalog entry.
+ * @param target_decimals Number of decimals of the result.
+ * @return int32_t Value * 10^target_decimals rounded to nearest or SENSOR_VALUE_SCALED_INVALID.
+ */
+int32_t sensor_value_toDecimals(sensor_value_t value, uint8_t num_of_decimals, uint8_t target_decimals);
+
+/**
+ * @brief Converts an integer with a fixed number of decimals to a value, the inverse of sensor_value_toDecimals().
+ *
+ * @param scaled_value Integer, value * 10^source_decimals.
+ * @param source_decimals Number of decimals of the integer.
+ * @param num_of_decimals Number of decimals of the catalog entry.
+ * @return sensor_value_t Value rounded to nearest or SENSOR_VALUE_INVALID for SENSOR_VALUE_SCALED_INVALID or if it does not fit.
+ */
+sensor_value_t sensor_value_fromDecimals(int32_t scaled_value, uint8_t source_decimals, uint8_t num_of_decimals);
+
+#endif
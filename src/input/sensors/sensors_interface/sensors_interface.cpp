@@ -1,26 +1,76 @@
 #include "sensors_interface.h"
+#include "../../input_types.h"
+
+/* STATIC GLOBAL VARIABLES */
+// Periods set at runtime by catalog index, SENSORS_INTERFACE_CATALOG_PERIOD keeps the period of the catalog
+static uint16_t sample_periods_s[SENSORS_SNAPSHOT_CAPACITY];
+/* *************************************** */
 
 /* EXPORTED FUNCTIONS */
-sensors_interface_metadata_ts sensors_interface_getSensorMetadata(uint8_t id)
+size_t sensors_interface_getSensorsLen()
+{
+    return sensors_metadata_getSensorsLen(); // Use the function from Metadata layer
+}
+
+uint8_t sensors_interface_sensorIndexToId(uint8_t index) 
 {
-    sensors_interface_metadata_ts metadata_return;
-    metadata_return.success_status = SENSORS_INTERFACE_STATUS_FAILED; // Default failure status
+    return sensors_metadata_sensorIndexToId(index);
+}
 
-    // Attempt to retrieve the sensor metadata from the catalog
-    if(SENSORS_METADATA_RETRIEVE_SUCCESS == sensors_metadata_getSensorFromCatalog(id, &metadata_return.metadata))
+uint8_t sensors_interface_sensorIdToIndex(uint8_t id)
+{
+    return sensors_metadata_sensorIdToIndex(id);
+}
+
+platform_flash_string_t sensors_interface_getSensorType(uint8_t index)
+{
+    return sensors_metadata_getSensorType(index);
+}
+
+platform_flash_string_t sensors_interface_getMeasurementUnit(uint8_t index)
+{
+    return sensors_metadata_getMeasurementUnit(index);
+}
+
+uint8_t sensors_interface_getMeasurementType(uint8_t index)
+{
+    return sensors_metadata_getMeasurementType(index);
+}
+
+uint8_t sensors_interface_getNumOfDecimals(uint8_t index)
+{
+    return sensors_metadata_getNumOfDecimals(index);
+}
+
+uint8_t sensors_interface_getDisplayNumOfLetters(uint8_t index)
+{
+    return sensors_metadata_getDisplayNumOfLetters(index);
+}
+
+uint32_t sensors_interface_getSamplePeriod(uint8_t index)
+{
+    if(SENSORS_SNAPSHOT_CAPACITY > index && SENSORS_INTERFACE_CATALOG_PERIOD != sample_periods_s[index])
     {
-        metadata_return.success_status = SENSORS_INTERFACE_STATUS_SUCCESS;
+        return (uint32_t)sample_periods_s[index] * SENSORS_INTERFACE_MS_PER_SECOND;
     }
-    return metadata_return;
+    return sensors_metadata_getSamplePeriod(index);
 }
 
-size_t sensors_interface_getSensorsLen()
+sensor_value_t sensors_interface_getDeadband(uint8_t index)
 {
-    return sensors_metadata_getSensorsLen(); // Use the function from Metadata layer
+    return sensors_metadata_getDeadband(index);
 }
 
-uint8_t sensors_interface_sensorIndexToId(uint8_t index) 
+uint32_t sensors_interface_getMaxSilence(uint8_t index)
 {
-    return sensors_metadata_sensorIndexToId(index);
+    return sensors_metadata_getMaxSilence(index);
+}
+
+void sensors_interface_setSamplePeriod(uint8_t index, uint16_t period_s)
+{
+    if(SENSORS_SNAPSHOT_CAPACITY > index)
+    {
+        sample_periods_s[index] = period_s;
+    }
 }
 /* *************************************** */
\ No newline at end of file
@@ -10,44 +10,28 @@
  *
  * This file provides an abstraction layer for accessing sensor metadata 
  * and information, ensuring encapsulation of underlying implementation details. 
- * It exposes functions for retrieving sensor metadata, mapping sensor indices 
- * to IDs, and obtaining the number of configured sensors. Other components 
+ * It exposes field level accessors for sensor metadata, mapping sensor indices 
+ * to IDs and back, and obtaining the number of configured sensors. Other components 
  * interact with the sensor metadata exclusively through this interface, 
  * promoting modularity and reducing dependencies on internal structures.
  */
 
-/* Status codes indicating the sensor interface operation success or failure */
-#define SENSORS_INTERFACE_STATUS_FAILED     (bool)(false)
-#define SENSORS_INTERFACE_STATUS_SUCCESS    (bool)(true)
-
 /* Indicates that no sensors are configured */
 #define SENSORS_INTERFACE_NO_SENSORS_CONFIGURED (size_t)(SENSORS_METADATA_NO_SENSORS_CONFIGURED)
 
-/**
- * @brief Structure representing the sensor metadata interface.
- * 
- * Contains metadata information for a sensor and the status of the operation
- * (whether metadata retrieval was successful or not).
- */
-typedef struct
-{
-    sensors_metadata_catalog_ts metadata; /* Metadata details for a sensor */
-    bool success_status;                  /* Status of the metadata retrieval operation */
-} sensors_interface_metadata_ts;
+/* Indicates that the sensor ID is not configured in the catalogs */
+#define SENSORS_INTERFACE_INVALID_INDEX         (uint8_t)(SENSORS_CATALOG_INVALID_INDEX)
 
-/**
- * @brief Retrieves sensor metadata for a given sensor ID from the metadata catalog.
- * 
- * This function attempts to retrieve the metadata for a sensor by its ID.
- * If the sensor is found in the catalog, the metadata is returned along 
- * with a success status. If the sensor is not found, the success status 
- * indicates failure.
- * 
- * @param id The unique identifier of the sensor to retrieve.
- * @return sensors_interface_metadata_ts A structure containing the sensor metadata 
- *                                    and success status.
- */
-sensors_interface_metadata_ts sensors_interface_getSensorMetadata(uint8_t id);
+/* Index of the first sensor in the catalog, used when iterating over all sensors */
+#define SENSORS_INTERFACE_FIRST_SENSOR_INDEX    (uint8_t)(SENSORS_CATALOG_FIRST_SENSOR_INDEX)
+
+/* Maximum lengths of metadata strings (without null terminator), used for sizing output buffers */
+#define SENSORS_INTERFACE_SENSOR_TYPE_MAX_LEN      (uint8_t)(SENSORS_METADATA_SENSOR_TYPE_MAX_LEN)
+#define SENSORS_INTERFACE_MEASUREMENT_UNIT_MAX_LEN (uint8_t)(SENSORS_METADATA_MEASUREMENT_UNIT_MAX_LEN)
+
+/* Sample period which follows the catalog, see sensors_interface_setSamplePeriod() */
+#define SENSORS_INTERFACE_CATALOG_PERIOD        (uint16_t)(0u)
+#define SENSORS_INTERFACE_MS_PER_SECOND         (uint32_t)(1000u)
 
 /**
  * @brief Returns the number of configured sensors.
@@ -69,4 +53,43 @@ size_t sensors_interface_getSensorsLen();
  */
 uint8_t sensors_interface_sensorIndexToId(uint8_t index);
 
+/**
+ * @brief Gets the catalog index for a given sensor ID.
+ *
+ * Constant time lookup, the returned index is valid for every sensor catalog.
+ *
+ * @param id ID of the sensor.
+ * @return uint8_t Catalog index or SENSORS_INTERFACE_INVALID_INDEX if the sensor is not configured.
+ */
+uint8_t sensors_interface_sensorIdToIndex(uint8_t id);
+
+/**
+ * @brief Field level accessors for sensor metadata.
+ *
+ * Each accessor reads only the requested field from program memory, without copying
+ * the whole catalog entry. Index must be obtained from sensors_interface_sensorIdToIndex().
+ *
+ * @param index Catalog index of the sensor.
+ * @return Requested field. String fields are pointers to program memory (use *_P string functions).
+ */
+platform_flash_string_t sensors_interface_getSensorType(uint8_t index);
+platform_flash_string_t sensors_interface_getMeasurementUnit(uint8_t index);
+uint8_t sensors_interface_getMeasurementType(uint8_t index);
+uint8_t sensors_interface_getNumOfDecimals(uint8_t index);
+uint8_t sensors_interface_getDisplayNumOfLetters(uint8_t index);
+uint32_t sensors_interface_getSamplePeriod(uint8_t index);
+sensor_value_t sensors_interface_getDeadband(uint8_t index);
+uint32_t sensors_interface_getMaxSilence(uint8_t index);
+
+/**
+ * @brief Overrides the sample period of the catalog at runtime, e.g., with a period set by the host.
+ *
+ * sensors_interface_getSamplePeriod() returns the new period from then on, so the sampling and the
+ * age of the cached readings both follow it.
+ *
+ * @param index Catalog index of the sensor, an invalid index is ignored.
+ * @param period_s Period in seconds, SENSORS_INTERFACE_CATALOG_PERIOD for the period of the catalog.
+ */
+void sensors_interface_setSamplePeriod(uint8_t index, uint16_t period_s);
+
 #endif
\ No newline at end of file
@@ -7,36 +7,294 @@
 /* SENSOR ID'S */
     #define INVALID_SENSOR_ID                     (uint8_t)(0u)
 
-#ifdef DHT11
+#ifdef DHT11_COMPONENT
     #define DHT11_TEMPERATURE                     (uint8_t)(1u)    
     #define DHT11_HUMIDITY                        (uint8_t)(2u)
 #endif
 
-#ifdef BMP280
+#ifdef BMP280_COMPONENT
     #define BMP280_PRESSURE                       (uint8_t)(3u)
     #define BMP280_TEMPERATURE                    (uint8_t)(4u)
     #define BMP280_ALTITUDE                       (uint8_t)(5u)
 #endif
 
-#ifdef BH1750
+#ifdef BH1750_COMPONENT
     #define BH1750_LUMINANCE                      (uint8_t)(6u)
 #endif
 
-#ifdef MQ135
+#ifdef MQ135_COMPONENT
     #define MQ135_PPM                             (uint8_t)(7u)
 #endif
 
-#ifdef MQ7
+#ifdef MQ7_COMPONENT
     #define MQ7_COPPM                             (uint8_t)(8u)
 #endif
 
-#ifdef GYML8511
+#ifdef GYML8511_COMPONENT
     #define GYML8511_UV                           (uint8_t)(9u)
 #endif
 
-#ifdef ARDUINORAIN
+#ifdef ARDUINORAIN_COMPONENT
     #define ARDUINORAIN_RAINING                   (uint8_t)(10u)
 #endif
+
+/* Derived measurements, computed from the cached readings of the measurements they are derived from */
+#ifdef DERIVED_SENSORS_COMPONENT
+#ifdef DHT11_COMPONENT
+    #define DERIVED_DEW_POINT                     (uint8_t)(11u)
+    #define DERIVED_HEAT_INDEX                    (uint8_t)(12u)
+#endif
+#ifdef BMP280_COMPONENT
+    #define DERIVED_SEA_LEVEL_PRESSURE            (uint8_t)(13u)
+#endif
+#endif
+
+/* Highest sensor ID which can be configured, size of the ID to index lookup table is derived from it */
+    #define SENSORS_CATALOG_MAX_SENSOR_ID         (uint8_t)(13u)
+/* ********************************* */
+
+/* Index returned for sensor ID's which are not configured */
+#define SENSORS_CATALOG_INVALID_INDEX             (uint8_t)(0xFFu)
+/* The index of the first sensor in the catalog order */
+#define SENSORS_CATALOG_FIRST_SENSOR_INDEX        (uint8_t)(0u)
+/* Size of the lookup table which maps sensor ID to catalog index (one entry for every possible ID) */
+#define SENSORS_CATALOG_INDEX_LUT_SIZE            (uint8_t)(SENSORS_CATALOG_MAX_SENSOR_ID + 1u)
+
+/* SENSORS CATALOG */
+/**
+ * Single source of truth for every sensor measurement (X-macro list).
+ * Every entry is in the form:
+ *   X(name, id, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_num_of_letters,
+ *     min_value, max_value, sample_period, deadband, max_silence, filter, filter_parameter, derivation, value_function,
+ *     indication_function)
+ *
+ *  - name:                   Token used to generate names of PROGMEM strings belonging to the entry.
+ *  - id:                     Sensor ID from above.
+ *  - sensor_type:            Type of the sensor (e.g., Temperature, Pressure, etc.), max SENSORS_METADATA_SENSOR_TYPE_MAX_LEN characters.
+ *  - measurement_unit:       Unit of measurement (e.g., C, Pa, etc.), max SENSORS_METADATA_MEASUREMENT_UNIT_MAX_LEN characters.
+ *  - measurement_type:       Type of measurement the sensor provides (value or indication).
+ *  - num_of_decimals:        Number of decimal places for the sensor's measurement values.
+ *  - display_num_of_letters: Number of letters to display for the sensor name in compact formats.
+ *  - min_value, max_value:   Valid range of the reading (from sensors_config.h).
+ *  - sample_period:          Time in milliseconds between two samples of the measurement (from sensors_config.h).
+ *  - deadband:               Smallest change of the value which is reported to the time independent outputs (from sensors_config.h).
+ *  - max_silence:            Longest time in milliseconds without a report, a heartbeat is sent after it even without a change.
+ *  - filter:                 SENSOR_FILTER_* applied to every sample before the range check (see sensor_filter.h),
+ *                            SENSOR_FILTER_NONE for a derived measurement, its inputs are filtered already.
+ *  - filter_parameter:       Shift of the EMA, largest step per sample of the rate limiter or SENSOR_FILTER_NO_PARAMETER.
+ *  - derivation:             SENSOR_DERIVED_* computing the value from the cached readings of other measurements (see
+ *                            sensor_derived.h), the entry has no driver functions then. SENSOR_DERIVED_NONE otherwise.
+ *  - value_function:         Driver function returning a float value or SENSORS_NO_VALUE_FUNCTION.
+ *  - indication_function:    Driver function returning a bool indication or SENSORS_NO_INDICATION_FUNCTION.
+ *
+ * Only the macro which expands the full entry references driver functions, so this header
+ * can be used without including the sensor drivers. Order of the entries is the order of the catalog,
+ * derived measurements come last so their inputs are sampled before them in a pass.
+ */
+#ifdef DHT11_TEMPERATURE
+    #define SENSORS_CATALOG_ENTRY_DHT11_TEMPERATURE(X)  X(dht11_temperature, DHT11_TEMPERATURE, "Temperature", "C", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_4_LETTERS, \
+        SENSORS_DHT11_TEMPERATURE_MIN, SENSORS_DHT11_TEMPERATURE_MAX, SENSORS_DHT11_TEMPERATURE_SAMPLE_PERIOD_MS, \
+        SENSORS_DHT11_TEMPERATURE_DEADBAND, SENSORS_DHT11_TEMPERATURE_MAX_SILENCE_MS, \
+        SENSORS_DHT11_TEMPERATURE_FILTER, SENSORS_DHT11_TEMPERATURE_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, dht11_readTemperature, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_DHT11_TEMPERATURE(X)
+#endif
+
+#ifdef DHT11_HUMIDITY
+    #define SENSORS_CATALOG_ENTRY_DHT11_HUMIDITY(X)  X(dht11_humidity, DHT11_HUMIDITY, "Humidity", "%", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_8_LETTERS, \
+        SENSORS_DHT11_HUMIDITY_MIN, SENSORS_DHT11_HUMIDITY_MAX, SENSORS_DHT11_HUMIDITY_SAMPLE_PERIOD_MS, \
+        SENSORS_DHT11_HUMIDITY_DEADBAND, SENSORS_DHT11_HUMIDITY_MAX_SILENCE_MS, \
+        SENSORS_DHT11_HUMIDITY_FILTER, SENSORS_DHT11_HUMIDITY_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, dht11_readHumidity, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_DHT11_HUMIDITY(X)
+#endif
+
+#ifdef BMP280_PRESSURE
+    #define SENSORS_CATALOG_ENTRY_BMP280_PRESSURE(X)  X(bmp280_pressure, BMP280_PRESSURE, "Pressure", "hPa", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_5_LETTERS, \
+        SENSORS_BMP280_PRESSURE_MIN, SENSORS_BMP280_PRESSURE_MAX, SENSORS_BMP280_PRESSURE_SAMPLE_PERIOD_MS, \
+        SENSORS_BMP280_PRESSURE_DEADBAND, SENSORS_BMP280_PRESSURE_MAX_SILENCE_MS, \
+        SENSORS_BMP280_PRESSURE_FILTER, SENSORS_BMP280_PRESSURE_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, bmp280_readPressure, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_BMP280_PRESSURE(X)
+#endif
+
+#ifdef BMP280_TEMPERATURE
+    #define SENSORS_CATALOG_ENTRY_BMP280_TEMPERATURE(X)  X(bmp280_temperature, BMP280_TEMPERATURE, "Temperature", "C", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_4_LETTERS, \
+        SENSORS_BMP280_TEMPERATURE_MIN, SENSORS_BMP280_TEMPERATURE_MAX, SENSORS_BMP280_TEMPERATURE_SAMPLE_PERIOD_MS, \
+        SENSORS_BMP280_TEMPERATURE_DEADBAND, SENSORS_BMP280_TEMPERATURE_MAX_SILENCE_MS, \
+        SENSORS_BMP280_TEMPERATURE_FILTER, SENSORS_BMP280_TEMPERATURE_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, bmp280_readTemperature, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_BMP280_TEMPERATURE(X)
+#endif
+
+#ifdef BMP280_ALTITUDE
+    #define SENSORS_CATALOG_ENTRY_BMP280_ALTITUDE(X)  X(bmp280_altitude, BMP280_ALTITUDE, "Altitude", "m", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_8_LETTERS, \
+        SENSORS_BMP280_ALTITUDE_MIN, SENSORS_BMP280_ALTITUDE_MAX, SENSORS_BMP280_ALTITUDE_SAMPLE_PERIOD_MS, \
+        SENSORS_BMP280_ALTITUDE_DEADBAND, SENSORS_BMP280_ALTITUDE_MAX_SILENCE_MS, \
+        SENSORS_BMP280_ALTITUDE_FILTER, SENSORS_BMP280_ALTITUDE_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, bmp280_readAltitude, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_BMP280_ALTITUDE(X)
+#endif
+
+#ifdef BH1750_LUMINANCE
+    #define SENSORS_CATALOG_ENTRY_BH1750_LUMINANCE(X)  X(bh1750_luminance, BH1750_LUMINANCE, "Luminance", "lx", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_9_LETTERS, \
+        SENSORS_BH1750_LUMINANCE_MIN, SENSORS_BH1750_LUMINANCE_MAX, SENSORS_BH1750_LUMINANCE_SAMPLE_PERIOD_MS, \
+        SENSORS_BH1750_LUMINANCE_DEADBAND, SENSORS_BH1750_LUMINANCE_MAX_SILENCE_MS, \
+        SENSORS_BH1750_LUMINANCE_FILTER, SENSORS_BH1750_LUMINANCE_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, bh1750_readLightLevel, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_BH1750_LUMINANCE(X)
+#endif
+
+#ifdef MQ135_PPM
+    #define SENSORS_CATALOG_ENTRY_MQ135_PPM(X)  X(mq135_ppm, MQ135_PPM, "Gases PPM", "", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_9_LETTERS, \
+        SENSORS_MQ135_PPM_MIN, SENSORS_MQ135_PPM_MAX, SENSORS_MQ135_PPM_SAMPLE_PERIOD_MS, \
+        SENSORS_MQ135_PPM_DEADBAND, SENSORS_MQ135_PPM_MAX_SILENCE_MS, \
+        SENSORS_MQ135_PPM_FILTER, SENSORS_MQ135_PPM_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, mq135_readPPM, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_MQ135_PPM(X)
+#endif
+
+#ifdef MQ7_COPPM
+    #define SENSORS_CATALOG_ENTRY_MQ7_COPPM(X)  X(mq7_coppm, MQ7_COPPM, "CO PPM", "", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_6_LETTERS, \
+        SENSORS_MQ7_PPM_MIN, SENSORS_MQ7_PPM_MAX, SENSORS_MQ7_COPPM_SAMPLE_PERIOD_MS, \
+        SENSORS_MQ7_COPPM_DEADBAND, SENSORS_MQ7_COPPM_MAX_SILENCE_MS, \
+        SENSORS_MQ7_COPPM_FILTER, SENSORS_MQ7_COPPM_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, mq7_readPPM, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_MQ7_COPPM(X)
+#endif
+
+#ifdef GYML8511_UV
+    #define SENSORS_CATALOG_ENTRY_GYML8511_UV(X)  X(gyml8511_uv, GYML8511_UV, "UV intensity", "", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_2_LETTERS, \
+        SENSORS_GYML8511_UV_MIN, SENSORS_GYML8511_UV_MAX, SENSORS_GYML8511_UV_SAMPLE_PERIOD_MS, \
+        SENSORS_GYML8511_UV_DEADBAND, SENSORS_GYML8511_UV_MAX_SILENCE_MS, \
+        SENSORS_GYML8511_UV_FILTER, SENSORS_GYML8511_UV_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, gy_ml8511_readUvIntensity, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_GYML8511_UV(X)
+#endif
+
+#ifdef ARDUINORAIN_RAINING
+    #define SENSORS_CATALOG_ENTRY_ARDUINORAIN_RAINING(X)  X(arduinorain_raining, ARDUINORAIN_RAINING, "Raining", "", \
+        SENSORS_MEASUREMENT_TYPE_INDICATION, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_7_LETTERS, \
+        SENSORS_INDICATION_NO_MIN, SENSORS_INDICATION_NO_MAX, SENSORS_ARDUINO_RAIN_SAMPLE_PERIOD_MS, \
+        SENSORS_INDICATION_NO_DEADBAND, SENSORS_ARDUINO_RAIN_MAX_SILENCE_MS, \
+        SENSORS_ARDUINO_RAIN_FILTER, SENSORS_ARDUINO_RAIN_FILTER_PARAMETER, \
+        SENSOR_DERIVED_NONE, SENSORS_NO_VALUE_FUNCTION, arduino_rain_sensor_readRaining)
+#else
+    #define SENSORS_CATALOG_ENTRY_ARDUINORAIN_RAINING(X)
+#endif
+
+#ifdef DERIVED_DEW_POINT
+    #define SENSORS_CATALOG_ENTRY_DERIVED_DEW_POINT(X)  X(derived_dew_point, DERIVED_DEW_POINT, "Dew point", "C", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_9_LETTERS, \
+        SENSORS_DERIVED_DEW_POINT_MIN, SENSORS_DERIVED_DEW_POINT_MAX, SENSORS_DERIVED_DEW_POINT_SAMPLE_PERIOD_MS, \
+        SENSORS_DERIVED_DEW_POINT_DEADBAND, SENSORS_DERIVED_DEW_POINT_MAX_SILENCE_MS, \
+        SENSOR_FILTER_NONE, SENSOR_FILTER_NO_PARAMETER, \
+        SENSOR_DERIVED_DEW_POINT, SENSORS_NO_VALUE_FUNCTION, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_DERIVED_DEW_POINT(X)
+#endif
+
+#ifdef DERIVED_HEAT_INDEX
+    #define SENSORS_CATALOG_ENTRY_DERIVED_HEAT_INDEX(X)  X(derived_heat_index, DERIVED_HEAT_INDEX, "Heat index", "C", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_10_LETTERS, \
+        SENSORS_DERIVED_HEAT_INDEX_MIN, SENSORS_DERIVED_HEAT_INDEX_MAX, SENSORS_DERIVED_HEAT_INDEX_SAMPLE_PERIOD_MS, \
+        SENSORS_DERIVED_HEAT_INDEX_DEADBAND, SENSORS_DERIVED_HEAT_INDEX_MAX_SILENCE_MS, \
+        SENSOR_FILTER_NONE, SENSOR_FILTER_NO_PARAMETER, \
+        SENSOR_DERIVED_HEAT_INDEX, SENSORS_NO_VALUE_FUNCTION, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_DERIVED_HEAT_INDEX(X)
+#endif
+
+#ifdef DERIVED_SEA_LEVEL_PRESSURE
+    #define SENSORS_CATALOG_ENTRY_DERIVED_SEA_LEVEL_PRESSURE(X)  X(derived_sea_level_pressure, DERIVED_SEA_LEVEL_PRESSURE, "Sea-level pressure", "hPa", \
+        SENSORS_MEASUREMENT_TYPE_VALUE, SENSORS_DISPLAY_1_DECIMAL, SENSORS_DISPLAY_9_LETTERS, \
+        SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MIN, SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MAX, SENSORS_DERIVED_SEA_LEVEL_PRESSURE_SAMPLE_PERIOD_MS, \
+        SENSORS_DERIVED_SEA_LEVEL_PRESSURE_DEADBAND, SENSORS_DERIVED_SEA_LEVEL_PRESSURE_MAX_SILENCE_MS, \
+        SENSOR_FILTER_NONE, SENSOR_FILTER_NO_PARAMETER, \
+        SENSOR_DERIVED_SEA_LEVEL_PRESSURE, SENSORS_NO_VALUE_FUNCTION, SENSORS_NO_INDICATION_FUNCTION)
+#else
+    #define SENSORS_CATALOG_ENTRY_DERIVED_SEA_LEVEL_PRESSURE(X)
+#endif
+
+/* Expands X for every configured entry, in catalog order */
+#define SENSORS_CATALOG(X) \
+    SENSORS_CATALOG_ENTRY_DHT11_TEMPERATURE(X) \
+    SENSORS_CATALOG_ENTRY_DHT11_HUMIDITY(X) \
+    SENSORS_CATALOG_ENTRY_BMP280_PRESSURE(X) \
+    SENSORS_CATALOG_ENTRY_BMP280_TEMPERATURE(X) \
+    SENSORS_CATALOG_ENTRY_BMP280_ALTITUDE(X) \
+    SENSORS_CATALOG_ENTRY_BH1750_LUMINANCE(X) \
+    SENSORS_CATALOG_ENTRY_MQ135_PPM(X) \
+    SENSORS_CATALOG_ENTRY_MQ7_COPPM(X) \
+    SENSORS_CATALOG_ENTRY_GYML8511_UV(X) \
+    SENSORS_CATALOG_ENTRY_ARDUINORAIN_RAINING(X) \
+    SENSORS_CATALOG_ENTRY_DERIVED_DEW_POINT(X) \
+    SENSORS_CATALOG_ENTRY_DERIVED_HEAT_INDEX(X) \
+    SENSORS_CATALOG_ENTRY_DERIVED_SEA_LEVEL_PRESSURE(X)
+
+/* Expands only the sensor ID of an entry */
+#define SENSORS_CATALOG_EXPAND_ID(name, id, ...)  id,
+
+/**
+ * Order of sensor ID's in the catalog, generated from the catalog itself.
+ * The ID to index lookup table is generated from this list.
+ */
+static constexpr uint8_t sensors_catalog_order[] =
+{
+    SENSORS_CATALOG(SENSORS_CATALOG_EXPAND_ID)
+};
+
+/* Number of configured sensor measurements */
+#define SENSORS_CATALOG_NUM_OF_SENSORS            (uint8_t)(sizeof(sensors_catalog_order) / sizeof(uint8_t))
+
+/**
+ * @brief Finds the catalog index of a sensor ID at compile time.
+ *
+ * @param id Sensor ID to look for.
+ * @param index Index from which the search starts (recursive, C++11 constexpr).
+ * @return uint8_t Catalog index of the sensor or SENSORS_CATALOG_INVALID_INDEX if it is not configured.
+ */
+static constexpr uint8_t sensors_catalog_findIndex(uint8_t id, uint8_t index)
+{
+    return (SENSORS_CATALOG_NUM_OF_SENSORS <= index) ? SENSORS_CATALOG_INVALID_INDEX :
+           (id == sensors_catalog_order[index]) ? index : sensors_catalog_findIndex(id, index + 1u);
+}
+
+/**
+ * @brief Checks at compile time that every configured sensor ID is valid and fits into the lookup table.
+ *
+ * @param index Index from which the check starts (recursive, C++11 constexpr).
+ * @return true if all ID's from the index till the end are in range, false otherwise.
+ */
+static constexpr bool sensors_catalog_idsInRange(uint8_t index)
+{
+    return (SENSORS_CATALOG_NUM_OF_SENSORS <= index) ||
+           (INVALID_SENSOR_ID != sensors_catalog_order[index] &&
+            SENSORS_CATALOG_MAX_SENSOR_ID >= sensors_catalog_order[index] &&
+            sensors_catalog_findIndex(sensors_catalog_order[index], SENSORS_CATALOG_FIRST_SENSOR_INDEX) == index && // No duplicates
+            sensors_catalog_idsInRange(index + 1u));
+}
+
+static_assert(sensors_catalog_idsInRange(SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+              "Sensor ID's must be unique and in range 1..SENSORS_CATALOG_MAX_SENSOR_ID");
 /* ********************************* */
 
 #endif
\ No newline at end of file
@@ -1,157 +1,131 @@
 #include "sensors_metadata.h"
 
-/* SENSORS METADATA CATALOG */
-/* It's crucial to keep the strings (sensor_type and measurement_unit) short enough to fit into the allocated buffer size.
-   Ensure that:
-   - `sensor_type` does not exceed 25 characters.
-   - `measurement_unit` does not exceed 10 characters.
-   This prevents potential overflow issues when formatting the final output in the buffer and ensures proper display of sensor readings. */
-const sensors_metadata_catalog_ts sensors_metadata_catalog[] PROGMEM =
-{
-#ifdef DHT11_TEMPERATURE
-  {
-    "Temperature",     
-    "C",     
-    DHT11_TEMPERATURE,   
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_4_LETTERS
-  },
-#endif
-#ifdef DHT11_HUMIDITY
-  {
-    "Humidity",        
-    "%",   
-    DHT11_HUMIDITY,      
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_8_LETTERS
-  },
-#endif  
-#ifdef BMP280_PRESSURE
-  {
-    "Pressure",        
-    "hPa",  
-    BMP280_PRESSURE,     
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_5_LETTERS
-  },
-#endif  
-#ifdef BMP280_TEMPERATURE
-  {
-    "Temperature",     
-    "C",   
-    BMP280_TEMPERATURE,  
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_4_LETTERS
-  },
-#endif  
-#ifdef BMP280_ALTITUDE
-  {
-    "Altitude",        
-    "m",   
-    BMP280_ALTITUDE,     
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_8_LETTERS
-  },
-#endif  
-#ifdef BH1750_LUMINANCE
-  {
-    "Luminance",       
-    "lx",  
-    BH1750_LUMINANCE,    
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_9_LETTERS
-  },
-#endif  
-#ifdef MQ135_PPM
-  {
-    "Gases PPM",       
-    "",    
-    MQ135_PPM,           
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_9_LETTERS
-  },
-#endif  
-#ifdef MQ7_COPPM
-  {
-    "CO PPM",          
-    "",    
-    MQ7_COPPM,           
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_6_LETTERS
-  },
-#endif  
-#ifdef GYML8511_UV
-  {
-    "UV intensity",    
-    "",     
-    GYML8511_UV,         
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_2_LETTERS
-  },
-#endif  
-#ifdef ARDUINORAIN_RAINING
-  {
-    "Raining",  
-    "",    
-    ARDUINORAIN_RAINING, 
-    SENSORS_MEASUREMENT_TYPE_INDICATION,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_7_LETTERS
-  },
-#endif
+/* SENSOR ID TO CATALOG INDEX LOOKUP TABLE */
+/* One entry for every sensor ID, each is computed at compile time from sensors_catalog_order.
+   The array takes its size from the entries, so a missing or extra ID fails the check below. */
+const uint8_t sensors_metadata_index_lut[] PLATFORM_PROGMEM =
+{
+  sensors_catalog_findIndex(0u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(1u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(2u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(3u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(4u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(5u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(6u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(7u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(8u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(9u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(10u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(11u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(12u, SENSORS_CATALOG_FIRST_SENSOR_INDEX),
+  sensors_catalog_findIndex(13u, SENSORS_CATALOG_FIRST_SENSOR_INDEX)
 };
 /* *************************************** */
 
+/* COMPILE TIME CHECKS */
+static_assert(SENSORS_CATALOG_INDEX_LUT_SIZE == sizeof(sensors_metadata_index_lut),
+              "Lookup table must have exactly one entry for every sensor ID from 0 to SENSORS_CATALOG_MAX_SENSOR_ID");
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
-bool sensors_metadata_getSensorFromCatalog(uint8_t id, sensors_metadata_catalog_ts * current_sensor)
+uint8_t sensors_metadata_sensorIdToIndex(uint8_t id)
 {
-  bool success_status = SENSORS_METADATA_RETRIEVE_FAILED;
-  size_t num_of_sensors = sensors_metadata_getSensorsLen();
-  uint8_t current_id = INVALID_SENSOR_ID;
+  uint8_t index = SENSORS_CATALOG_INVALID_INDEX; // Default in case ID is out of range
 
-  // Loop through all sensors in the catalog
-  for (uint8_t index = SENSORS_METADATA_FIRST_SENSOR_INDEX; index < num_of_sensors; index++)
+  if(SENSORS_CATALOG_MAX_SENSOR_ID >= id)
   {
-    current_id = pgm_read_byte(&sensors_metadata_catalog[index].sensor_id); // Read from program memory
-    if(id == current_id)
-    {
-      // Copy the sensor configuration from program memory to the provided structure
-      memcpy_P(current_sensor, &sensors_metadata_catalog[index], sizeof(sensors_metadata_catalog_ts));
-      success_status = SENSORS_METADATA_RETRIEVE_SUCCESS; // Mark as successful
-      break;
-    }
+    index = PLATFORM_READ_BYTE(&sensors_metadata_index_lut[id]); // Single PROGMEM access instead of catalog scan
   }
-  return success_status;
+  return index;
 }
 
 size_t sensors_metadata_getSensorsLen()
 {
-  size_t sensors_len = SENSORS_METADATA_NO_SENSORS_CONFIGURED; // Default value in case of no sensors configured
-  if (SENSORS_METADATA_NO_SENSORS_CONFIGURED < sizeof(sensors_metadata_catalog)) // Ensure catalog is not empty
-  {
-    sensors_len = sizeof(sensors_metadata_catalog) / sizeof(sensors_metadata_catalog[SENSORS_METADATA_FIRST_SENSOR_INDEX]);
-  }
-  return sensors_len;
+  return (size_t)SENSORS_CATALOG_NUM_OF_SENSORS; // Generated from the catalog at compile time
 }
 
 uint8_t sensors_metadata_sensorIndexToId(uint8_t index) 
 {
   uint8_t sensor_id = INVALID_SENSOR_ID; // Default sensor ID in case index is out of bounds or there are no sensors configured
-  size_t num_of_sensors = sensors_metadata_getSensorsLen();
-  if(index < num_of_sensors && SENSORS_METADATA_FIRST_SENSOR_INDEX <= index)
+  if(index < SENSORS_CATALOG_NUM_OF_SENSORS)
   {
-    sensor_id = pgm_read_byte(&sensors_metadata_catalog[index].sensor_id); // Convert to sensor ID
+    sensor_id = PLATFORM_READ_BYTE(&sensors_catalog[index].sensor_id); // Convert to sensor ID
   }
   return sensor_id;
 }
-/* *************************************** */
 
+platform_flash_string_t sensors_metadata_getSensorType(uint8_t index)
+{
+  return (platform_flash_string_t)PLATFORM_READ_PTR(&sensors_catalog[index].sensor_type);
+}
+
+platform_flash_string_t sensors_metadata_getMeasurementUnit(uint8_t index)
+{
+  return (platform_flash_string_t)PLATFORM_READ_PTR(&sensors_catalog[index].measurement_unit);
+}
+
+uint8_t sensors_metadata_getMeasurementType(uint8_t index)
+{
+  return PLATFORM_READ_BYTE(&sensors_catalog[index].measurement_type);
+}
+
+uint8_t sensors_metadata_getNumOfDecimals(uint8_t index)
+{
+  return PLATFORM_READ_BYTE(&sensors_catalog[index].num_of_decimals);
+}
+
+uint8_t sensors_metadata_getDisplayNumOfLetters(uint8_t index)
+{
+  return PLATFORM_READ_BYTE(&sensors_catalog[index].display_num_of_letters);
+}
+
+sensor_value_t sensors_metadata_getMinValue(uint8_t index)
+{
+  return SENSOR_VALUE_PGM_READ(&sensors_catalog[index].min_value);
+}
+
+sensor_value_t sensors_metadata_getMaxValue(uint8_t index)
+{
+  return SENSOR_VALUE_PGM_READ(&sensors_catalog[index].max_value);
+}
+
+uint32_t sensors_metadata_getSamplePeriod(uint8_t index)
+{
+  return PLATFORM_READ_DWORD(&sensors_catalog[index].sample_period);
+}
+
+sensor_value_t sensors_metadata_getDeadband(uint8_t index)
+{
+  return SENSOR_VALUE_PGM_READ(&sensors_catalog[index].deadband);
+}
+
+uint32_t sensors_metadata_getMaxSilence(uint8_t index)
+{
+  return PLATFORM_READ_DWORD(&sensors_catalog[index].max_silence);
+}
+
+uint8_t sensors_metadata_getFilter(uint8_t index)
+{
+  return PLATFORM_READ_BYTE(&sensors_catalog[index].filter);
+}
+
+sensor_value_t sensors_metadata_getFilterParameter(uint8_t index)
+{
+  return SENSOR_VALUE_PGM_READ(&sensors_catalog[index].filter_parameter);
+}
+
+uint8_t sensors_metadata_getDerivation(uint8_t index)
+{
+  return PLATFORM_READ_BYTE(&sensors_catalog[index].derivation);
+}
+
+sensors_sensor_value_function_t sensors_metadata_getValueFunction(uint8_t index)
+{
+  return (sensors_sensor_value_function_t)PLATFORM_READ_PTR(&sensors_catalog[index].sensor_value_function);
+}
+
+sensors_sensor_indication_function_t sensors_metadata_getIndicationFunction(uint8_t index)
+{
+  return (sensors_sensor_indication_function_t)PLATFORM_READ_PTR(&sensors_catalog[index].sensor_indication_function);
+}
+/* *************************************** */
@@ -2,17 +2,14 @@
 #define SENSORS_METADATA_H
 
 #include <Arduino.h>
-#include <avr/pgmspace.h>
+#include "../../../../platform/platform.h"
 #include "sensors_catalog.h"
+#include "../sensor_value/sensor_value.h"
+#include "../sensor_filter/sensor_filter.h"
+#include "../sensor_derived/sensor_derived.h"
 
 /* Indicates that no sensor metadata is configured */
 #define SENSORS_METADATA_NO_SENSORS_CONFIGURED         (size_t)(0u)
-/* The index of the first sensor in the metadata configuration */
-#define SENSORS_METADATA_FIRST_SENSOR_INDEX            (uint8_t)(0u)
-
-/* Metadata retrieve success status codes */
-#define SENSORS_METADATA_RETRIEVE_FAILED               (bool)(false)
-#define SENSORS_METADATA_RETRIEVE_SUCCESS              (bool)(true)
 
 /* Measurement type for sensors providing float values */
 #define SENSORS_MEASUREMENT_TYPE_VALUE                 (uint8_t)(0u)
@@ -44,41 +41,73 @@
 #define SENSORS_DISPLAY_11_LETTERS   (uint8_t)(11u)
 #define SENSORS_DISPLAY_12_LETTERS   (uint8_t)(12u)
 
+/* Maximum lengths of the catalog strings (without null terminator), checked at compile time */
+#define SENSORS_METADATA_SENSOR_TYPE_MAX_LEN         (uint8_t)(25u)
+#define SENSORS_METADATA_MEASUREMENT_UNIT_MAX_LEN    (uint8_t)(10u)
+
+/* Sample period of zero is not allowed, the measurement would be sampled in every scheduler pass */
+#define SENSORS_METADATA_NO_SAMPLE_PERIOD            (uint32_t)(0u)
+
+/* Placeholder for sensors without an indication function */
+#define SENSORS_NO_INDICATION_FUNCTION        (nullptr)
+/* Placeholder for sensors without a value function */
+#define SENSORS_NO_VALUE_FUNCTION             (nullptr)
+
+/* Placeholders for min_value and max_value in indication sensors */
+#define SENSORS_INDICATION_NO_MIN             (float)(0)       
+#define SENSORS_INDICATION_NO_MAX             (float)(0)
+/* Deadband of indication sensors, every change of the indication is reported */
+#define SENSORS_INDICATION_NO_DEADBAND        (float)(0)
+
+/* Function pointer type for sensors returning a float value */
+typedef float (*sensors_sensor_value_function_t)();
+/* Function pointer type for sensors returning a bool indication */
+typedef bool (*sensors_sensor_indication_function_t)();
+
 /**
- * @brief Structure representing metadata for a sensor.
+ * @brief Structure representing a single entry of the sensor catalog.
  *
- * This structure defines the static properties of a sensor, such as its type, 
- * measurement unit, unique ID, and display-related attributes. It is used to 
- * store descriptive information about sensors that does not change during runtime.
- * Used in other components like Display, Serial Console etc.
+ * This structure holds both the functional properties of a measurement (valid range and
+ * driver functions) and its static metadata (type, unit and display attributes).
+ * Entries live in program memory and are generated from SENSORS_CATALOG in sensors_catalog.h,
+ * so the fields should be read one by one with the accessors below instead of copying the whole entry.
  */
 typedef struct
 {
-  const char* sensor_type;            // Type of the sensor (e.g., Temperature, Pressure, etc.).
-  const char* measurement_unit;       // Unit of measurement for the sensor (e.g., C, Pa, etc.).
-  uint8_t sensor_id;                  // Unique identifier for the sensor. Used to reference the sensor. From config file.
-  uint8_t measurement_type;           // Type of measurement the sensor provides (e.g., value, indication).
-  uint8_t num_of_decimals;            // Number of decimal places for the sensor's measurement values.
-  uint8_t display_num_of_letters;     // Number of letters to display for the sensor name in compact formats.
-} sensors_metadata_catalog_ts;
+  sensor_value_t min_value;                                        // The minimum valid value for the sensor's reading (scaled like the readings). Values below this are considered invalid.
+  sensor_value_t max_value;                                        // The maximum valid value for the sensor's reading (scaled like the readings). Values above this are considered invalid.
+  uint32_t sample_period;                                          // Time in milliseconds between two samples of the measurement.
+  sensor_value_t deadband;                                         // Smallest reported change of the value (scaled like the readings).
+  uint32_t max_silence;                                            // Longest time in milliseconds without a report of the measurement.
+  sensor_value_t filter_parameter;                                 // Shift of the EMA or largest step of the rate limiter (scaled like the readings).
+  sensors_sensor_value_function_t sensor_value_function;           // Function pointer for obtaining a numerical reading from the sensor. Optional.
+  sensors_sensor_indication_function_t sensor_indication_function; // Function pointer for obtaining a boolean status/indication from the sensor. Optional.
+  platform_flash_string_t sensor_type;                                               // Type of the sensor (e.g., Temperature, Pressure, etc.), string in program memory.
+  platform_flash_string_t measurement_unit;                                          // Unit of measurement for the sensor (e.g., C, Pa, etc.), string in program memory.
+  uint8_t sensor_id;                                               // Unique identifier for the sensor. Used to reference the sensor. From config file.
+  uint8_t measurement_type;                                        // Type of measurement the sensor provides (e.g., value, indication).
+  uint8_t num_of_decimals;                                         // Number of decimal places for the sensor's measurement values.
+  uint8_t display_num_of_letters;                                  // Number of letters to display for the sensor name in compact formats.
+  uint8_t filter;                                                  // Filter applied to every sample before the range check (SENSOR_FILTER_*).
+  uint8_t derivation;                                              // Computation from the cached readings of other measurements (SENSOR_DERIVED_*).
+} sensors_catalog_ts;
+
+/* Sensor catalog in program memory, defined in sensors.cpp where the driver functions are available */
+extern const sensors_catalog_ts sensors_catalog[] PLATFORM_PROGMEM;
 /* ***************************************** */
 
 /**
- * @brief Retrieves a sensor's metadata from the catalog based on its ID.
- * 
- * This function looks up a sensor by its unique identifier in the catalog.
- * If found, it copies the sensor's metadata into the provided structure.
- * 
- * @param id The ID of the sensor to retrieve.
- * @param current_sensor Pointer to the structure where the sensor metadata will be stored.
- * @return bool `true` if the sensor was found and metadata was copied, `false` otherwise.
+ * @brief Converts a sensor ID to its index in the sensor catalog.
+ *
+ * Uses the compile time generated lookup table, so the cost is a single PROGMEM read.
+ *
+ * @param id The ID of the sensor.
+ * @return uint8_t Catalog index of the sensor or SENSORS_CATALOG_INVALID_INDEX if the sensor is not configured.
  */
-bool sensors_metadata_getSensorFromCatalog(uint8_t id, sensors_metadata_catalog_ts *current_sensor);
+uint8_t sensors_metadata_sensorIdToIndex(uint8_t id);
 
 /**
- * @brief Retrieves the number of sensors in the metadata catalog.
- * 
- * This function calculates the total number of sensors in the catalog.
+ * @brief Retrieves the number of sensors in the catalog.
  * 
  * @return size_t The total number of sensors.
  */
@@ -87,7 +116,7 @@ size_t sensors_metadata_getSensorsLen();
 /**
  * @brief Converts a sensor index to its corresponding sensor ID.
  *
- * This function takes an index within the sensor metadata configuration array and 
+ * This function takes an index within the sensor catalog and 
  * retrieves the corresponding sensor ID. Returns an invalid ID if the 
  * index is out of bounds or no sensors are configured.
  *
@@ -96,4 +125,29 @@ size_t sensors_metadata_getSensorsLen();
  */
 uint8_t sensors_metadata_sensorIndexToId(uint8_t index);
 
+/**
+ * @brief Field level accessors for the sensor catalog.
+ *
+ * Every accessor reads only the requested field from program memory.
+ * Index must be valid (obtained from sensors_metadata_sensorIdToIndex), it is not checked again.
+ *
+ * @param index Catalog index of the sensor.
+ * @return Requested field. String fields are pointers to program memory (use *_P string functions).
+ */
+platform_flash_string_t sensors_metadata_getSensorType(uint8_t index);
+platform_flash_string_t sensors_metadata_getMeasurementUnit(uint8_t index);
+uint8_t sensors_metadata_getMeasurementType(uint8_t index);
+uint8_t sensors_metadata_getNumOfDecimals(uint8_t index);
+uint8_t sensors_metadata_getDisplayNumOfLetters(uint8_t index);
+sensor_value_t sensors_metadata_getMinValue(uint8_t index);
+sensor_value_t sensors_metadata_getMaxValue(uint8_t index);
+uint32_t sensors_metadata_getSamplePeriod(uint8_t index);
+sensor_value_t sensors_metadata_getDeadband(uint8_t index);
+uint32_t sensors_metadata_getMaxSilence(uint8_t index);
+uint8_t sensors_metadata_getFilter(uint8_t index);
+sensor_value_t sensors_metadata_getFilterParameter(uint8_t index);
+uint8_t sensors_metadata_getDerivation(uint8_t index);
+sensors_sensor_value_function_t sensors_metadata_getValueFunction(uint8_t index);
+sensors_sensor_indication_function_t sensors_metadata_getIndicationFunction(uint8_t index);
+
 #endif
\ No newline at end of file
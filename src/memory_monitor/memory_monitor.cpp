@@ -0,0 +1,142 @@
+#include "memory_monitor.h"
+
+/* Symbols of the avr-libc allocator: start of the heap and its current end (nullptr before the first malloc) */
+extern char __heap_start;
+extern char *__brkval;
+
+/* STATIC GLOBAL VARIABLES */
+/* Painted region, from its lowest byte to the first byte above it */
+static uint8_t *paint_bottom = nullptr;
+static uint8_t *paint_top = nullptr;
+/* Lowest byte overwritten by the stack, the paint above it is no longer checked */
+static uint8_t *stack_low_mark = nullptr;
+static uint16_t min_free_bytes = 0u;
+static uint16_t heap_high_water = 0u;
+static uint32_t next_check = 0u;
+static bool low_reported = MEMORY_MONITOR_LOW_NOT_REPORTED;
+
+static bool report_requested = MEMORY_MONITOR_NO_REPORT_REQUEST;
+static uint8_t report_frame[MEMORY_MONITOR_FRAME_REPORT_SIZE + MEMORY_MONITOR_FRAME_CRC_SIZE];
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Returns the current end of the heap, the start of the heap if nothing was allocated.
+ *
+ * @return uint8_t* First byte above the heap.
+ */
+static uint8_t *getHeapEnd();
+
+/**
+ * @brief Scans the painted region from the bottom and updates the high-water marks.
+ */
+static void updateMarks();
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void memory_monitor_init()
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    paint_bottom = getHeapEnd();
+    paint_top = (uint8_t *)(uintptr_t)(SP - MEMORY_MONITOR_STACK_GUARD);
+    for (uint8_t *address = paint_bottom; address < paint_top; address++)
+    {
+      *address = MEMORY_MONITOR_PAINT_BYTE;
+    }
+  }
+
+  stack_low_mark = paint_top;
+  min_free_bytes = (uint16_t)(paint_top - paint_bottom);
+  low_reported = MEMORY_MONITOR_LOW_NOT_REPORTED;
+  next_check = millis();
+  updateMarks();
+}
+
+bool memory_monitor_service(uint32_t current_millis)
+{
+  if(nullptr == paint_top || 0 > (int32_t)(current_millis - next_check)) // Overflow safe deadline
+  {
+    return MEMORY_MONITOR_MEMORY_OK;
+  }
+  next_check = current_millis + MEMORY_MONITOR_CHECK_PERIOD_MS;
+  updateMarks();
+
+  if(MEMORY_MONITOR_LOW_FREE_BYTES > min_free_bytes && MEMORY_MONITOR_LOW_REPORTED != low_reported)
+  {
+    low_reported = MEMORY_MONITOR_LOW_REPORTED;
+    return MEMORY_MONITOR_MEMORY_LOW;
+  }
+  return MEMORY_MONITOR_MEMORY_OK;
+}
+
+uint16_t memory_monitor_getMinFreeBytes()
+{
+  return min_free_bytes;
+}
+
+uint16_t memory_monitor_getStackHighWater()
+{
+  return (nullptr == stack_low_mark) ? 0u : (uint16_t)((uint8_t *)RAMEND + 1u - stack_low_mark);
+}
+
+uint16_t memory_monitor_getHeapHighWater()
+{
+  return heap_high_water;
+}
+
+void memory_monitor_handleCommand(const uint8_t *payload, size_t payload_len)
+{
+  if(MEMORY_MONITOR_CMD_QUERY == payload[0] && MEMORY_MONITOR_CMD_QUERY_SIZE == payload_len)
+  {
+    report_requested = MEMORY_MONITOR_REPORT_REQUESTED;
+  }
+}
+
+uint8_t *memory_monitor_peekReportFrame(size_t *payload_len)
+{
+  if(MEMORY_MONITOR_REPORT_REQUESTED != report_requested || nullptr == paint_top)
+  {
+    return nullptr;
+  }
+  updateMarks();
+
+  report_frame[0] = MEMORY_MONITOR_FRAME_REPORT;
+  serial_frame_putU16(&report_frame[1], min_free_bytes);
+  serial_frame_putU16(&report_frame[3], (uint16_t)((uint8_t *)(uintptr_t)SP - getHeapEnd()));
+  serial_frame_putU16(&report_frame[5], memory_monitor_getStackHighWater());
+  serial_frame_putU16(&report_frame[7], heap_high_water);
+  *payload_len = MEMORY_MONITOR_FRAME_REPORT_SIZE;
+  return report_frame;
+}
+
+void memory_monitor_releaseReportFrame()
+{
+  report_requested = MEMORY_MONITOR_NO_REPORT_REQUEST;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t *getHeapEnd()
+{
+  return (nullptr == __brkval) ? (uint8_t *)&__heap_start : (uint8_t *)__brkval;
+}
+
+static void updateMarks()
+{
+  uint8_t *heap_end = getHeapEnd();
+  uint16_t heap_size = (uint16_t)(heap_end - (uint8_t *)&__heap_start);
+  heap_high_water = (heap_size > heap_high_water) ? heap_size : heap_high_water;
+
+  // Heap grows over the bottom of the paint, the scan starts above it and stops at the deepest stack byte
+  uint8_t *address = (heap_end > paint_bottom) ? heap_end : paint_bottom;
+  while(address < stack_low_mark && MEMORY_MONITOR_PAINT_BYTE == *address)
+  {
+    address++;
+  }
+  stack_low_mark = address;
+
+  uint16_t free_bytes = (stack_low_mark > heap_end) ? (uint16_t)(stack_low_mark - heap_end) : 0u;
+  min_free_bytes = (free_bytes < min_free_bytes) ? free_bytes : min_free_bytes;
+}
+/* *************************************** */
@@ -0,0 +1,114 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "../output/serial_console/serial_frame.h"
+
+/**
+ * @file memory_monitor.h
+ * @brief High-water marks of the stack and the heap in SRAM.
+ *
+ * At boot the free SRAM between the end of the heap and the stack is painted with MEMORY_MONITOR_PAINT_BYTE.
+ * The stack grows down into the painted region and overwrites the paint, so the lowest overwritten byte is the
+ * deepest point the stack ever reached. The heap end is taken from the allocator (__brkval) on every check.
+ *
+ * Report protocol (binary frames of serial_frame.h, all fields little endian):
+ *  - host -> station QUERY:  type
+ *  - station -> host REPORT: type, min free, free now, stack high-water and heap high-water (u16, bytes)
+ */
+
+/* Value painted into the free SRAM, unlikely to be written by the stack (not 0x00 or 0xFF) */
+#define MEMORY_MONITOR_PAINT_BYTE         (uint8_t)(0xC5u)
+/* Bytes below the stack pointer which are not painted, room for the frame of the paint loop itself */
+#define MEMORY_MONITOR_STACK_GUARD        (uint8_t)(16u)
+
+/* Period of the scan of the painted region, one scan reads at most the whole free SRAM */
+#define MEMORY_MONITOR_CHECK_PERIOD_MS    (uint32_t)(1000u)
+/* Free SRAM below which the memory is reported as low, once per boot */
+#define MEMORY_MONITOR_LOW_FREE_BYTES     (uint16_t)(128u)
+
+/* Flags returned by the service */
+#define MEMORY_MONITOR_MEMORY_LOW         (bool)(true)
+#define MEMORY_MONITOR_MEMORY_OK          (bool)(false)
+
+/* Flags indicating if the low memory was already reported */
+#define MEMORY_MONITOR_LOW_REPORTED       (bool)(true)
+#define MEMORY_MONITOR_LOW_NOT_REPORTED   (bool)(false)
+
+/* Frame types of the report protocol, the profiling dump uses 0x20..0x27 */
+#define MEMORY_MONITOR_CMD_QUERY          (uint8_t)(0x28u)
+#define MEMORY_MONITOR_FRAME_REPORT       (uint8_t)(0x29u)
+
+/* Payload sizes of the report frames */
+#define MEMORY_MONITOR_CMD_QUERY_SIZE     (uint8_t)(1u)
+#define MEMORY_MONITOR_FRAME_REPORT_SIZE  (uint8_t)(9u)
+/* Room for the CRC of the frame, which is appended by the framing */
+#define MEMORY_MONITOR_FRAME_CRC_SIZE     (uint8_t)(SERIAL_FRAME_CRC_SIZE)
+
+/* Flags indicating if the host asked for a report */
+#define MEMORY_MONITOR_REPORT_REQUESTED   (bool)(true)
+#define MEMORY_MONITOR_NO_REPORT_REQUEST  (bool)(false)
+
+/**
+ * @brief Paints the free SRAM between the heap and the stack.
+ *
+ * Must be called once at boot, as early as possible, so the stack of the initialization is measured too.
+ * Interrupts are disabled while painting, so no interrupt frame is painted over.
+ */
+void memory_monitor_init();
+
+/**
+ * @brief Updates the high-water marks every MEMORY_MONITOR_CHECK_PERIOD_MS.
+ *
+ * NEEDS TO BE CALLED IN A LOOP.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return true (MEMORY_MONITOR_MEMORY_LOW) the first time the free SRAM drops below MEMORY_MONITOR_LOW_FREE_BYTES, false otherwise.
+ */
+bool memory_monitor_service(uint32_t current_millis);
+
+/**
+ * @brief Returns the smallest free SRAM between the heap and the stack since boot, as of the last check.
+ *
+ * @return uint16_t Free bytes.
+ */
+uint16_t memory_monitor_getMinFreeBytes();
+
+/**
+ * @brief Returns the deepest use of the stack since boot, as of the last check.
+ *
+ * @return uint16_t Bytes from the end of the SRAM to the deepest point of the stack.
+ */
+uint16_t memory_monitor_getStackHighWater();
+
+/**
+ * @brief Returns the largest size of the heap since boot, as of the last check.
+ *
+ * @return uint16_t Bytes from the start of the heap to its highest end.
+ */
+uint16_t memory_monitor_getHeapHighWater();
+
+/**
+ * @brief Handles a frame received from the host, QUERY requests a report. Other frames are ignored.
+ *
+ * @param payload Payload of the received frame.
+ * @param payload_len Number of payload bytes.
+ */
+void memory_monitor_handleCommand(const uint8_t *payload, size_t payload_len);
+
+/**
+ * @brief Returns the report frame requested by the host, with freshly updated marks.
+ *
+ * @param payload_len Receives the number of payload bytes.
+ * @return uint8_t* Payload with MEMORY_MONITOR_FRAME_CRC_SIZE free bytes after it, nullptr if no report is requested.
+ *         The request stays until memory_monitor_releaseReportFrame() is called.
+ */
+uint8_t *memory_monitor_peekReportFrame(size_t *payload_len);
+
+/**
+ * @brief Releases the report frame after it was queued for transmission.
+ */
+void memory_monitor_releaseReportFrame();
+
+#endif
@@ -0,0 +1,489 @@
+#include "data_log.h"
+#include "../output_checks.h"
+
+/* STATIC GLOBAL VARIABLES */
+static uint8_t log_state = DATA_LOG_STATE_UNMOUNTED;
+
+// Header scan of the mount
+static uint16_t mount_block = 0u;
+static bool newest_found = DATA_LOG_BLOCK_NOT_FOUND;
+static uint16_t newest_block = 0u;
+static uint16_t newest_sequence = 0u;
+
+// Position of the next block which is written
+static uint16_t next_block = 0u;
+static uint16_t next_sequence = 0u;
+
+// Blocks in RAM, every buffer starts with the memory address so it is sent as one job
+static uint8_t buffers[DATA_LOG_NUM_OF_BUFFERS][DATA_LOG_MEMORY_ADDRESS_SIZE + DATA_LOG_PAGE_SIZE];
+static uint8_t fill_buffer = 0u;
+static uint8_t fill_count = 0u;
+
+// Page write of the other buffer
+static i2c_bus_job_ts write_job;
+static bool write_pending = DATA_LOG_NO_WRITE_PENDING;
+static uint8_t write_attempts = 0u;
+static uint32_t last_write_millis = 0u;
+
+static uint16_t dropped_records = DATA_LOG_NO_DROPPED_RECORDS;
+
+// Export, blocks are read straight into the payload of the export frame
+static bool export_active = DATA_LOG_EXPORT_INACTIVE;
+static bool export_frame_ready = DATA_LOG_EXPORT_FRAME_NOT_READY;
+static uint16_t export_block = 0u;
+static uint16_t export_remaining = 0u;
+static uint32_t export_from = 0u;
+static uint32_t export_to = 0u;
+static uint8_t export_credits = 0u;
+static uint32_t export_host_millis = 0u;
+static i2c_bus_job_ts export_job;
+static uint8_t export_address[DATA_LOG_MEMORY_ADDRESS_SIZE];
+static uint8_t export_frame[DATA_LOG_EXPORT_FRAME_BLOCK_SIZE + DATA_LOG_EXPORT_FRAME_CRC_SIZE];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(0u < DATA_LOG_RECORDS_PER_BLOCK, "Page must have room for the block header and at least one record");
+static_assert(0u == (DATA_LOG_MEMORY_SIZE % DATA_LOG_PAGE_SIZE), "Memory must consist of whole pages");
+static_assert(DATA_LOG_NUM_OF_BLOCKS <= (uint16_t)INT16_MAX, "Sequence numbers of all blocks must be comparable with a signed 16-bit difference");
+static_assert(DATA_LOG_MEMORY_ADDRESS_SIZE + DATA_LOG_PAGE_SIZE <= UINT8_MAX, "Page write must fit one I2C bus job");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Calculates CRC-8 (polynomial DATA_LOG_CRC_POLYNOMIAL) of a buffer.
+ *
+ * @param data Buffer to calculate the CRC of.
+ * @param len Number of bytes.
+ * @return uint8_t Calculated CRC.
+ */
+static uint8_t crc8(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Stores the memory address of a block big endian.
+ *
+ * @param buffer Destination, DATA_LOG_MEMORY_ADDRESS_SIZE bytes.
+ * @param block Index of the block.
+ */
+static void putBlockAddress(uint8_t *buffer, uint16_t block);
+
+/**
+ * @brief Reads the header of one block and remembers it if it is the newest valid block so far.
+ *
+ * @param block Index of the block.
+ * @return true if the memory answered, false otherwise.
+ */
+static bool scanBlockHeader(uint16_t block);
+
+/**
+ * @brief Appends a record to the block which is being filled.
+ *
+ * @param sensor_id ID of the sensor.
+ * @param value Value with DATA_LOG_VALUE_DECIMALS decimals.
+ * @param timestamp Timestamp of the reading in seconds.
+ */
+static void appendRecord(uint8_t sensor_id, int32_t value, uint32_t timestamp);
+
+/**
+ * @brief Completes the header of the full block and prepares its page write.
+ *
+ * The other buffer becomes the one which is filled.
+ */
+static void startBlockWrite();
+
+/**
+ * @brief Checks the result of the page write and starts the write of the next full block.
+ *
+ * @param current_millis The current time in milliseconds.
+ */
+static void serviceBlockWrite(uint32_t current_millis);
+
+/**
+ * @brief Reads the next block of the export and prepares its frame.
+ *
+ * @param current_millis The current time in milliseconds.
+ */
+static void serviceExport(uint32_t current_millis);
+
+/**
+ * @brief Checks if a block read by the export has a valid header and a record in the time range of the export.
+ *
+ * @param block Raw block as stored in the memory.
+ * @return true if the block is sent to the host, false if it is skipped.
+ */
+static bool isBlockInExportRange(const uint8_t *block);
+
+/**
+ * @brief Counts dropped records, the counter saturates.
+ *
+ * @param count Number of dropped records.
+ */
+static void countDropped(uint8_t count);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+control_error_code_te data_log_init()
+{
+  if(DATA_LOG_STATE_MOUNTED == log_state)
+  {
+    return ERROR_CODE_NO_ERROR;
+  }
+
+  if(DATA_LOG_STATE_MOUNTING != log_state)
+  {
+    // New mount, also after a failed one
+    mount_block = 0u;
+    newest_found = DATA_LOG_BLOCK_NOT_FOUND;
+    log_state = DATA_LOG_STATE_MOUNTING;
+  }
+
+  for (uint8_t step = 0u; step < DATA_LOG_HEADERS_PER_MOUNT_STEP && mount_block < DATA_LOG_NUM_OF_BLOCKS; step++)
+  {
+    if(!scanBlockHeader(mount_block))
+    {
+      log_state = DATA_LOG_STATE_UNMOUNTED;
+      return ERROR_CODE_INIT_FAILED;
+    }
+    mount_block++;
+  }
+
+  if(DATA_LOG_NUM_OF_BLOCKS > mount_block)
+  {
+    return ERROR_CODE_INIT_PENDING;
+  }
+
+  // Continue after the newest block, an empty memory starts at the first block
+  if(DATA_LOG_BLOCK_FOUND == newest_found)
+  {
+    next_block = (uint16_t)((newest_block + 1u) % DATA_LOG_NUM_OF_BLOCKS);
+    next_sequence = (uint16_t)(newest_sequence + 1u);
+  }
+  else
+  {
+    next_block = 0u;
+    next_sequence = 0u;
+  }
+  log_state = DATA_LOG_STATE_MOUNTED;
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+control_error_code_te data_log_displayData(const control_data_ts *data)
+{
+  if(INPUT_SENSORS != data->input.io_component)
+  {
+    return ERROR_CODE_NO_ERROR; // Only single readings are logged
+  }
+
+  const sensor_reading_ts *sensor_data = &(data->input_return.sensor_reading);
+  uint8_t sensor_index = sensors_interface_sensorIdToIndex(data->input.device_id);
+  int32_t value = SENSOR_VALUE_SCALED_INVALID;
+
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch)
+  {
+    value = sensor_data->indication ? 1 : 0;
+  }
+  else if(SENSORS_INTERFACE_INVALID_INDEX != sensor_index)
+  {
+    value = sensor_value_toDecimals(sensor_data->value, sensors_interface_getNumOfDecimals(sensor_index), DATA_LOG_VALUE_DECIMALS);
+  }
+
+  if(SENSOR_VALUE_SCALED_INVALID != value)
+  {
+    appendRecord(data->input.device_id, value, sensor_data->timestamp);
+  }
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+void data_log_service(uint32_t current_millis)
+{
+  if(DATA_LOG_STATE_MOUNTED != log_state)
+  {
+    return;
+  }
+
+  serviceBlockWrite(current_millis);
+  serviceExport(current_millis);
+}
+
+uint16_t data_log_getDroppedRecords()
+{
+  return dropped_records;
+}
+
+void data_log_handleExportCommand(const uint8_t *payload, size_t payload_len, uint32_t current_millis)
+{
+  if(DATA_LOG_STATE_MOUNTED != log_state || 0u == payload_len)
+  {
+    return;
+  }
+
+  if(DATA_LOG_EXPORT_CMD_EXPORT == payload[0] && DATA_LOG_EXPORT_CMD_EXPORT_SIZE == payload_len)
+  {
+    uint16_t first_block = serial_frame_getU16(&payload[1]);
+    if(DATA_LOG_NUM_OF_BLOCKS <= first_block) // Also DATA_LOG_EXPORT_FROM_OLDEST
+    {
+      // Block at the write position is the oldest one, every block is visited once
+      export_block = next_block;
+      export_remaining = DATA_LOG_NUM_OF_BLOCKS;
+    }
+    else
+    {
+      // Resume, only the blocks up to the write position
+      export_block = first_block;
+      export_remaining = (uint16_t)((next_block + DATA_LOG_NUM_OF_BLOCKS - first_block) % DATA_LOG_NUM_OF_BLOCKS);
+    }
+    export_from = serial_frame_getU32(&payload[3]);
+    export_to = serial_frame_getU32(&payload[7]);
+    export_credits = DATA_LOG_EXPORT_INITIAL_CREDITS;
+    export_frame_ready = DATA_LOG_EXPORT_FRAME_NOT_READY;
+    export_active = DATA_LOG_EXPORT_ACTIVE;
+    export_host_millis = current_millis;
+  }
+  else if(DATA_LOG_EXPORT_CMD_CREDIT == payload[0] && DATA_LOG_EXPORT_CMD_CREDIT_SIZE == payload_len &&
+          DATA_LOG_EXPORT_ACTIVE == export_active)
+  {
+    export_credits = (UINT8_MAX - export_credits < payload[1]) ? UINT8_MAX : (uint8_t)(export_credits + payload[1]);
+    export_host_millis = current_millis;
+  }
+}
+
+uint8_t *data_log_peekExportFrame(size_t *payload_len)
+{
+  if(DATA_LOG_EXPORT_ACTIVE != export_active || DATA_LOG_EXPORT_FRAME_READY != export_frame_ready)
+  {
+    return nullptr;
+  }
+
+  *payload_len = (DATA_LOG_EXPORT_FRAME_BLOCK == export_frame[0]) ? DATA_LOG_EXPORT_FRAME_BLOCK_SIZE : DATA_LOG_EXPORT_FRAME_END_SIZE;
+  return export_frame;
+}
+
+void data_log_releaseExportFrame()
+{
+  if(DATA_LOG_EXPORT_FRAME_END == export_frame[0])
+  {
+    export_active = DATA_LOG_EXPORT_INACTIVE; // Host has everything up to the write position
+  }
+  export_frame_ready = DATA_LOG_EXPORT_FRAME_NOT_READY;
+}
+
+bool data_log_isExportActive()
+{
+  return export_active;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t crc8(const uint8_t *data, uint8_t len)
+{
+  uint8_t crc = DATA_LOG_CRC_INITIAL;
+
+  for (uint8_t i = 0u; i < len; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t bit = 0u; bit < 8u; bit++)
+    {
+      crc = (crc & 0x80u) ? (uint8_t)((crc << 1) ^ DATA_LOG_CRC_POLYNOMIAL) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void putBlockAddress(uint8_t *buffer, uint16_t block)
+{
+  uint16_t address = (uint16_t)(block * DATA_LOG_PAGE_SIZE);
+  buffer[0] = (uint8_t)(address >> 8);
+  buffer[1] = (uint8_t)(address & 0xFFu);
+}
+
+static bool scanBlockHeader(uint16_t block)
+{
+  i2c_bus_job_ts job;
+  uint8_t address[DATA_LOG_MEMORY_ADDRESS_SIZE];
+  uint8_t header[DATA_LOG_BLOCK_HEADER_SIZE];
+
+  putBlockAddress(address, block);
+  i2c_bus_prepareJob(&job, DATA_LOG_MEMORY_I2C_ADDR, address, sizeof(address), header, sizeof(header));
+  if(I2C_BUS_JOB_DONE != i2c_bus_transfer(&job))
+  {
+    return false;
+  }
+
+  if(DATA_LOG_BLOCK_MAGIC == header[0] && crc8(header, DATA_LOG_BLOCK_HEADER_SIZE - 1u) == header[DATA_LOG_BLOCK_HEADER_SIZE - 1u])
+  {
+    uint16_t sequence = (uint16_t)(header[1] | (header[2] << 8));
+    // Signed difference, sequence numbers wrap around
+    if(DATA_LOG_BLOCK_NOT_FOUND == newest_found || (int16_t)(sequence - newest_sequence) > 0)
+    {
+      newest_found = DATA_LOG_BLOCK_FOUND;
+      newest_block = block;
+      newest_sequence = sequence;
+    }
+  }
+
+  return true;
+}
+
+static void appendRecord(uint8_t sensor_id, int32_t value, uint32_t timestamp)
+{
+  if(DATA_LOG_RECORDS_PER_BLOCK == fill_count)
+  {
+    countDropped(1u); // Both buffers are full, the memory is missing or too slow
+    return;
+  }
+
+  uint8_t *block = &buffers[fill_buffer][DATA_LOG_MEMORY_ADDRESS_SIZE];
+  if(0u == fill_count)
+  {
+    memset(block, DATA_LOG_ERASED_BYTE, DATA_LOG_PAGE_SIZE);
+  }
+
+  uint8_t *record = &block[DATA_LOG_BLOCK_HEADER_SIZE + fill_count * DATA_LOG_RECORD_SIZE];
+  serial_frame_putU32(&record[0], timestamp);
+  serial_frame_putU32(&record[4], (uint32_t)value);
+  record[8] = sensor_id;
+  record[9] = crc8(record, DATA_LOG_RECORD_SIZE - 1u);
+  fill_count++;
+}
+
+static void startBlockWrite()
+{
+  uint8_t *buffer = buffers[fill_buffer];
+  uint8_t *header = &buffer[DATA_LOG_MEMORY_ADDRESS_SIZE];
+
+  putBlockAddress(buffer, next_block);
+  header[0] = DATA_LOG_BLOCK_MAGIC;
+  header[1] = (uint8_t)(next_sequence & 0xFFu);
+  header[2] = (uint8_t)(next_sequence >> 8);
+  header[3] = crc8(header, DATA_LOG_BLOCK_HEADER_SIZE - 1u);
+
+  // Whole page in one job, the EEPROM writes it in a single write cycle
+  i2c_bus_prepareJob(&write_job, DATA_LOG_MEMORY_I2C_ADDR, buffer, DATA_LOG_MEMORY_ADDRESS_SIZE + DATA_LOG_PAGE_SIZE, nullptr, 0u);
+  write_pending = DATA_LOG_WRITE_PENDING;
+  write_attempts = 0u;
+
+  fill_buffer = (uint8_t)((fill_buffer + 1u) % DATA_LOG_NUM_OF_BUFFERS);
+  fill_count = 0u;
+}
+
+static void serviceBlockWrite(uint32_t current_millis)
+{
+  if(I2C_BUS_IS_JOB_PENDING(write_job.status))
+  {
+    return; // Page write is still on the bus
+  }
+
+  if(DATA_LOG_WRITE_PENDING == write_pending && I2C_BUS_JOB_DONE == write_job.status)
+  {
+    next_block = (uint16_t)((next_block + 1u) % DATA_LOG_NUM_OF_BLOCKS);
+    next_sequence++;
+    write_pending = DATA_LOG_NO_WRITE_PENDING;
+    last_write_millis = current_millis; // Write cycle of the EEPROM starts now
+  }
+  else if(DATA_LOG_WRITE_PENDING == write_pending && I2C_BUS_JOB_IDLE != write_job.status)
+  {
+    write_attempts++;
+    write_job.status = I2C_BUS_JOB_IDLE;
+    last_write_millis = current_millis; // Memory may still be busy, try again after the write cycle
+    if(DATA_LOG_MAX_WRITE_ATTEMPTS <= write_attempts)
+    {
+      countDropped(DATA_LOG_RECORDS_PER_BLOCK); // Block position is kept for the next block
+      write_pending = DATA_LOG_NO_WRITE_PENDING;
+    }
+  }
+
+  if(DATA_LOG_NO_WRITE_PENDING == write_pending && DATA_LOG_RECORDS_PER_BLOCK == fill_count)
+  {
+    startBlockWrite();
+  }
+
+  if(DATA_LOG_WRITE_PENDING == write_pending && (current_millis - last_write_millis) >= DATA_LOG_WRITE_CYCLE_MS)
+  {
+    (void)i2c_bus_submit(&write_job); // Rejected only when the queue is full, submitted again in the next call
+  }
+}
+
+static void serviceExport(uint32_t current_millis)
+{
+  if(DATA_LOG_EXPORT_ACTIVE != export_active || I2C_BUS_IS_JOB_PENDING(export_job.status))
+  {
+    return; // No export or the block read is still on the bus
+  }
+
+  if(DATA_LOG_EXPORT_TIMEOUT_MS < (current_millis - export_host_millis))
+  {
+    export_active = DATA_LOG_EXPORT_INACTIVE; // Host is gone, it resumes with a new EXPORT
+    export_frame_ready = DATA_LOG_EXPORT_FRAME_NOT_READY;
+    return;
+  }
+
+  if(DATA_LOG_EXPORT_FRAME_READY == export_frame_ready)
+  {
+    return; // Frame buffer is still waiting for the transmit ring
+  }
+
+  if(I2C_BUS_JOB_IDLE != export_job.status)
+  {
+    // Result of a read of an earlier export is discarded, so is a failed read (for example during the write cycle)
+    uint16_t block_read = (uint16_t)(((uint16_t)export_address[0] << 8 | export_address[1]) / DATA_LOG_PAGE_SIZE);
+    if(I2C_BUS_JOB_DONE == export_job.status && block_read == export_block)
+    {
+      if(isBlockInExportRange(&export_frame[DATA_LOG_EXPORT_FRAME_HEADER_SIZE]))
+      {
+        export_frame[0] = DATA_LOG_EXPORT_FRAME_BLOCK;
+        serial_frame_putU16(&export_frame[1], export_block);
+        export_frame_ready = DATA_LOG_EXPORT_FRAME_READY;
+        export_credits--;
+      }
+      export_block = (uint16_t)((export_block + 1u) % DATA_LOG_NUM_OF_BLOCKS);
+      export_remaining--;
+    }
+    export_job.status = I2C_BUS_JOB_IDLE;
+
+    if(DATA_LOG_EXPORT_FRAME_READY == export_frame_ready)
+    {
+      return; // Next block is read after the frame is queued
+    }
+  }
+
+  if(0u == export_remaining)
+  {
+    export_frame[0] = DATA_LOG_EXPORT_FRAME_END;
+    serial_frame_putU16(&export_frame[1], export_block);
+    export_frame_ready = DATA_LOG_EXPORT_FRAME_READY;
+  }
+  else if(0u != export_credits)
+  {
+    putBlockAddress(export_address, export_block);
+    i2c_bus_prepareJob(&export_job, DATA_LOG_MEMORY_I2C_ADDR, export_address, sizeof(export_address),
+                       &export_frame[DATA_LOG_EXPORT_FRAME_HEADER_SIZE], DATA_LOG_PAGE_SIZE);
+    (void)i2c_bus_submit(&export_job); // Queue full keeps the job idle, it is prepared again in the next call
+  }
+}
+
+static bool isBlockInExportRange(const uint8_t *block)
+{
+  if(DATA_LOG_BLOCK_MAGIC != block[0] || crc8(block, DATA_LOG_BLOCK_HEADER_SIZE - 1u) != block[DATA_LOG_BLOCK_HEADER_SIZE - 1u])
+  {
+    return false; // Erased or never written
+  }
+
+  for (uint8_t record_index = 0u; record_index < DATA_LOG_RECORDS_PER_BLOCK; record_index++)
+  {
+    const uint8_t *record = &block[DATA_LOG_BLOCK_HEADER_SIZE + record_index * DATA_LOG_RECORD_SIZE];
+    uint32_t timestamp = serial_frame_getU32(&record[0]);
+    if(DATA_LOG_ERASED_BYTE != record[8] && crc8(record, DATA_LOG_RECORD_SIZE - 1u) == record[9] &&
+       timestamp >= export_from && timestamp <= export_to)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void countDropped(uint8_t count)
+{
+  dropped_records = (UINT16_MAX - dropped_records < count) ? UINT16_MAX : (uint16_t)(dropped_records + count);
+}
+/* *************************************** */
@@ -0,0 +1,192 @@
+#ifndef DATA_LOG_H
+#define DATA_LOG_H
+
+#include <Arduino.h>
+#include "data_log_config.h"
+#include "../../control/control_types.h"
+#include "../../i2c_bus/i2c_bus.h"
+#include "../serial_console/serial_frame.h"
+
+/**
+ * @file data_log.h
+ * @brief Append-only log of the sensor readings in an external I2C EEPROM or FRAM.
+ *
+ * Readings are packed into fixed-size records in RAM and written one block (one page of the memory)
+ * at a time, so there is one bus transaction per page and not per reading. Blocks are written in a
+ * circle over the whole memory, every page is written once per pass, which spreads the wear evenly.
+ *
+ * Block layout (DATA_LOG_PAGE_SIZE bytes):
+ *  - header: magic, sequence number (u16, little endian), CRC-8 of the magic and the sequence number
+ *  - records: timestamp (u32, seconds, see control_getTimestamp()), value (i32, DATA_LOG_VALUE_DECIMALS decimals, indications 0 or 1),
+ *             sensor ID, CRC-8 of the previous bytes of the record. Unused records are left filled with 0xFF.
+ *
+ * At boot only the block headers are read, the valid header with the highest sequence number is the
+ * newest block and writing continues after it.
+ *
+ * Export protocol (binary frames of serial_frame.h, all fields little endian):
+ *  - host -> station EXPORT: type, first block (u16, DATA_LOG_EXPORT_FROM_OLDEST for the oldest block),
+ *                            from and to timestamp (u32, seconds, inclusive)
+ *  - host -> station CREDIT: type, number of blocks the host can receive more (u8)
+ *  - station -> host BLOCK:  type, block index (u16), raw block as stored in the memory
+ *  - station -> host END:    type, block index (u16) at which a later export continues with new blocks
+ * Only blocks up to the write position at the start of the export are sent, blocks with no record in the
+ * time range are skipped. EXPORT grants DATA_LOG_EXPORT_INITIAL_CREDITS blocks, the host grants more with
+ * CREDIT frames as it consumes them. A broken transfer is resumed with EXPORT from the block after the last
+ * received one, an export without host frames for DATA_LOG_EXPORT_TIMEOUT_MS is stopped.
+ */
+
+/* Block header: magic, sequence number (u16) and CRC-8 */
+#define DATA_LOG_BLOCK_HEADER_SIZE      (uint8_t)(4u)
+/* Record: timestamp (u32), value (i32), sensor ID and CRC-8 */
+#define DATA_LOG_RECORD_SIZE            (uint8_t)(10u)
+/* Number of records in one block */
+#define DATA_LOG_RECORDS_PER_BLOCK      (uint8_t)((DATA_LOG_PAGE_SIZE - DATA_LOG_BLOCK_HEADER_SIZE) / DATA_LOG_RECORD_SIZE)
+/* Number of blocks in the memory */
+#define DATA_LOG_NUM_OF_BLOCKS          (uint16_t)(DATA_LOG_MEMORY_SIZE / DATA_LOG_PAGE_SIZE)
+/* First byte of every written block, erased memory (0xFF) or other data never match it */
+#define DATA_LOG_BLOCK_MAGIC            (uint8_t)(0xA5u)
+/* Memory address (u16, big endian) sent before the data of every access */
+#define DATA_LOG_MEMORY_ADDRESS_SIZE    (uint8_t)(2u)
+/* Value of the unused bytes of a block */
+#define DATA_LOG_ERASED_BYTE            (uint8_t)(0xFFu)
+
+/* CRC-8 parameters (polynomial 0x07, initial value 0x00) */
+#define DATA_LOG_CRC_POLYNOMIAL         (uint8_t)(0x07u)
+#define DATA_LOG_CRC_INITIAL            (uint8_t)(0x00u)
+
+/* Values are logged as fixed-point integers with 2 decimals, same as the binary frames of the serial console */
+#define DATA_LOG_VALUE_DECIMALS         (uint8_t)(2u)
+
+/* Number of block headers read in one step of the mount, every step is one init call of the bring-up */
+#define DATA_LOG_HEADERS_PER_MOUNT_STEP (uint8_t)(8u)
+
+/* Number of failed writes of a block before its records are dropped */
+#define DATA_LOG_MAX_WRITE_ATTEMPTS     (uint8_t)(3u)
+
+/* Number of RAM buffers, one is filled while the other one is written */
+#define DATA_LOG_NUM_OF_BUFFERS         (uint8_t)(2u)
+
+/* Frame types of the export protocol, the binary output uses the types below 0x10 */
+#define DATA_LOG_EXPORT_CMD_EXPORT      (uint8_t)(0x10u)
+#define DATA_LOG_EXPORT_CMD_CREDIT      (uint8_t)(0x11u)
+#define DATA_LOG_EXPORT_FRAME_BLOCK     (uint8_t)(0x12u)
+#define DATA_LOG_EXPORT_FRAME_END       (uint8_t)(0x13u)
+
+/* Payload sizes of the export frames */
+#define DATA_LOG_EXPORT_CMD_EXPORT_SIZE (uint8_t)(11u)
+#define DATA_LOG_EXPORT_CMD_CREDIT_SIZE (uint8_t)(2u)
+#define DATA_LOG_EXPORT_FRAME_HEADER_SIZE (uint8_t)(3u)
+#define DATA_LOG_EXPORT_FRAME_BLOCK_SIZE (uint8_t)(DATA_LOG_EXPORT_FRAME_HEADER_SIZE + DATA_LOG_PAGE_SIZE)
+#define DATA_LOG_EXPORT_FRAME_END_SIZE  (uint8_t)(DATA_LOG_EXPORT_FRAME_HEADER_SIZE)
+/* Room for the CRC of the frame, which is appended by the framing */
+#define DATA_LOG_EXPORT_FRAME_CRC_SIZE  (uint8_t)(SERIAL_FRAME_CRC_SIZE)
+
+/* First block of EXPORT which selects the oldest block in the memory */
+#define DATA_LOG_EXPORT_FROM_OLDEST     (uint16_t)(0xFFFFu)
+/* Blocks which can be sent after EXPORT before the first CREDIT */
+#define DATA_LOG_EXPORT_INITIAL_CREDITS (uint8_t)(4u)
+/* Export is stopped when the host sends nothing for this long */
+#define DATA_LOG_EXPORT_TIMEOUT_MS      (uint32_t)(2000u)
+
+/* Flags indicating if an export is running */
+#define DATA_LOG_EXPORT_ACTIVE          (bool)(true)
+#define DATA_LOG_EXPORT_INACTIVE        (bool)(false)
+
+/* Flags indicating if the export frame is ready to be sent */
+#define DATA_LOG_EXPORT_FRAME_READY     (bool)(true)
+#define DATA_LOG_EXPORT_FRAME_NOT_READY (bool)(false)
+
+/* State of the log */
+#define DATA_LOG_STATE_UNMOUNTED        (uint8_t)(0u) /* Not initialized or the memory did not answer */
+#define DATA_LOG_STATE_MOUNTING         (uint8_t)(1u) /* Block headers are being scanned */
+#define DATA_LOG_STATE_MOUNTED          (uint8_t)(2u) /* Newest block is known, blocks are written */
+
+/* Flags indicating if a full block waits for its page write */
+#define DATA_LOG_WRITE_PENDING          (bool)(true)
+#define DATA_LOG_NO_WRITE_PENDING       (bool)(false)
+
+/* Flags indicating if a valid block header was found by the mount */
+#define DATA_LOG_BLOCK_FOUND            (bool)(true)
+#define DATA_LOG_BLOCK_NOT_FOUND        (bool)(false)
+
+/* Value of the dropped records counter when nothing was dropped */
+#define DATA_LOG_NO_DROPPED_RECORDS     (uint16_t)(0u)
+
+/**
+ * @brief Mounts the log, one step of the header scan per call.
+ *
+ * Reads DATA_LOG_HEADERS_PER_MOUNT_STEP block headers and returns ERROR_CODE_INIT_PENDING until
+ * all headers are read, so the mount is finished by the background bring-up without blocking the loop.
+ *
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Log is mounted, new blocks are written after the newest block found.
+ * - ERROR_CODE_INIT_PENDING: Header scan is not finished yet.
+ * - ERROR_CODE_INIT_FAILED: Memory did not answer.
+ */
+control_error_code_te data_log_init();
+
+/**
+ * @brief Appends the sensor readings to the log.
+ *
+ * Single sensor readings are packed into the current block in RAM, the block is written by
+ * data_log_service() when it is full. Readings without a valid value are not logged, snapshots
+ * are skipped because the same readings are logged from the per-sensor sampling, other inputs are
+ * not part of the log. If both buffers are full the reading is dropped and counted.
+ *
+ * @param data Pointer to data structure containing the input type and associated readings.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Reading was logged, dropped or is not part of the log.
+ */
+control_error_code_te data_log_displayData(const control_data_ts *data);
+
+/**
+ * @brief Writes full blocks to the memory.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Submits the page write of a full block as one I2C bus job,
+ * checks its result and keeps the write cycle of the EEPROM between two page writes.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void data_log_service(uint32_t current_millis);
+
+/**
+ * @brief Returns the number of records dropped since boot, because the buffers were full or a write failed.
+ *
+ * @return uint16_t Number of dropped records, saturates at UINT16_MAX.
+ */
+uint16_t data_log_getDroppedRecords();
+
+/**
+ * @brief Handles a frame of the export protocol received from the host.
+ *
+ * EXPORT starts a new export (a running one is replaced), CREDIT allows more blocks to be sent.
+ * Other frames and exports before the log is mounted are ignored.
+ *
+ * @param payload Payload of the received frame.
+ * @param payload_len Number of payload bytes.
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void data_log_handleExportCommand(const uint8_t *payload, size_t payload_len, uint32_t current_millis);
+
+/**
+ * @brief Returns the next frame of the export, the blocks are read in the background by data_log_service().
+ *
+ * @param payload_len Receives the number of payload bytes.
+ * @return uint8_t* Payload with DATA_LOG_EXPORT_FRAME_CRC_SIZE free bytes after it, nullptr if no frame is ready.
+ *         The frame stays ready until data_log_releaseExportFrame() is called.
+ */
+uint8_t *data_log_peekExportFrame(size_t *payload_len);
+
+/**
+ * @brief Releases the export frame after it was queued for transmission, so the next block can be read.
+ */
+void data_log_releaseExportFrame();
+
+/**
+ * @brief Checks if an export is running.
+ *
+ * @return true (DATA_LOG_EXPORT_ACTIVE) if an export is running, false otherwise.
+ */
+bool data_log_isExportActive();
+
+#endif
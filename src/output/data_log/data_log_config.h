@@ -0,0 +1,15 @@
+#ifndef DATA_LOG_CONFIG_H
+#define DATA_LOG_CONFIG_H
+
+#include <Arduino.h>
+
+/* I2C address of the log memory (24LC256 / 24C256 EEPROM or MB85RC256 FRAM with A0..A2 connected to GND) */
+#define DATA_LOG_MEMORY_I2C_ADDR      (uint8_t)(0x50)
+/* Size of the log memory in bytes (256 kbit) */
+#define DATA_LOG_MEMORY_SIZE          (uint32_t)(32768u)
+/* Size of one write page of the memory, every block of the log is one page */
+#define DATA_LOG_PAGE_SIZE            (uint8_t)(64u)
+/* Internal write cycle of the EEPROM after a page write, the memory does not answer until it is over (0 for FRAM) */
+#define DATA_LOG_WRITE_CYCLE_MS       (uint32_t)(5u)
+
+#endif
@@ -1,7 +1,24 @@
 #include "display.h"
+#include "../output_checks.h"
 
 /* STATIC GLOBAL VARIABLES */
-static LiquidCrystal_I2C lcd(DISPLAY_LCD_I2C_ADDDR, DISPLAY_LCD_WIDTH, DISPLAY_LCD_HEIGHT);
+// Frame built by the display functions and the characters which are currently on the panel
+static char frame[DISPLAY_LCD_HEIGHT][DISPLAY_LCD_WIDTH];
+static char panel[DISPLAY_LCD_HEIGHT][DISPLAY_LCD_WIDTH];
+// Position of the LCD cursor, it advances by itself after every written character
+static uint8_t cursor_row = DISPLAY_CURSOR_UNKNOWN;
+static uint8_t cursor_column = DISPLAY_CURSOR_UNKNOWN;
+// Frames are only kept in RAM until the LCD is initialized
+static bool display_ready = DISPLAY_NOT_READY;
+// Frame was changed but not queued, the panel shows an older one
+static bool frame_pending = false;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(CONTROL_VIEW_PAGE_ROWS <= DISPLAY_LCD_HEIGHT, "Every row of a view page must have a row on the LCD");
+static_assert(TREND_MAX_LEVEL - TREND_MIN_LEVEL < LCD_I2C_NUM_OF_GLYPHS, "Every level of a trend needs a glyph");
+static_assert(TREND_MAX_LEVEL <= LCD_I2C_GLYPH_HEIGHT, "Every level of a trend needs a pixel row");
+static_assert(TREND_MAX_SAMPLES <= DISPLAY_LCD_WIDTH, "Every sample of a trend needs a column");
 /* *************************************** */
 
 /* STATIC FUNCTION PROTOTYPES */
@@ -11,24 +28,54 @@ static LiquidCrystal_I2C lcd(DISPLAY_LCD_I2C_ADDDR, DISPLAY_LCD_WIDTH, DISPLAY_L
  * If the measurement type is invalid or metadata is not found, the function returns an error code.
  *
  * @param control_data_ts Pointer to data containing sensor reading with value, and measurement type switch and sensor ID.
+ * @param row The row of the frame which receives the measurement.
  * 
  * @return control_error_code_te Returns an error code based on the display process:
  *         - ERROR_CODE_NO_ERROR if the sensor data is successfully displayed.
  *         - ERROR_CODE_INVALID_SENSOR_MEASUREMENT_TYPE if the measurement type is invalid.
  *         - ERROR_CODE_SENSOR_NOT_CONFIGURED if the sensor metadata is not found.
  **/
-static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data);
+static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data, uint8_t row);
 
+#ifdef RTC_COMPONENT
 /** 
  * @brief Displays the current time on the LCD, formatted to fit a 16-character wide display.
  * This function formats the time and date values from the RTC reading and displays it.
  *
  * @param control_data_ts Pointer to data containing RTC reading with the current time (year, month, day, hour, minutes, seconds).
+ * @param row The row of the frame which receives the time.
  * 
  * @return control_error_code_te Returns an error code:
  *         - ERROR_CODE_NO_ERROR indicating successful execution.
  **/
-static control_error_code_te display_displayTime(const control_data_ts *data);
+static control_error_code_te display_displayTime(const control_data_ts *data, uint8_t row);
+#endif
+
+/**
+ * @brief Displays the trend of a sensor as one bar per sample, the newest sample in the last column.
+ *
+ * Bars are the glyphs loaded by loadTrendGlyphs(), columns without a sample are blank.
+ *
+ * @param control_data_ts Pointer to data containing the trend with the bar level of every sample.
+ * @param row The row of the frame which receives the trend.
+ *
+ * @return control_error_code_te Returns an error code:
+ *         - ERROR_CODE_NO_ERROR indicating successful execution.
+ **/
+static control_error_code_te display_displayTrend(const control_data_ts *data, uint8_t row);
+
+/**
+ * @brief Displays a page of the view, every row of the page in the same row of the LCD.
+ *
+ * Rows without data (IO_UNUSED) are blank. Only the characters which differ from the panel are sent.
+ *
+ * @param page Pointer to the page with the data of every row.
+ *
+ * @return control_error_code_te Returns an error code:
+ *         - ERROR_CODE_NO_ERROR if every row was displayed.
+ *         - Error code of the first row which could not be displayed, the row is then blank.
+ **/
+static control_error_code_te display_displayViewPage(const control_view_page_ts *page);
 
 /** 
  * @brief Displays the results of an I2C bus scan on the LCD. 
@@ -43,33 +90,92 @@ static control_error_code_te display_displayTime(const control_data_ts *data);
  **/
 static control_error_code_te display_displayI2cScan(const control_data_ts *data);
 
+/**
+ * @brief Displays the fault code of an error in one row: error code, component and device ID, occurrences.
+ *
+ * @param error Pointer to the error with the number of occurrences since its last report.
+ *
+ * @return control_error_code_te Returns an error code:
+ *         - ERROR_CODE_NO_ERROR indicating successful execution.
+ **/
+static control_error_code_te display_displayError(const control_error_ts *error);
+
 /**
  * @brief Formats sensor data for display on an LCD screen.
  * 
- * This function takes sensor metadata and a measurement value, 
- * formats it as a string, and ensures it fits within the display width.
+ * This function takes the catalog index of a sensor and a measurement value and 
+ * formats them into a caller provided buffer, cut to the display width.
+ * Sensor type and unit are read directly from program memory, nothing is allocated.
  * 
- * @param sensor_metadata Metadata containing sensor type, unit, and display settings.
+ * @param display_string Buffer for the formatted text.
+ * @param size Size of the buffer, at most DISPLAY_MAX_STRING_LEN characters are used.
+ * @param sensor_index Catalog index of the sensor, used to read sensor type and unit.
  * @param val The sensor measurement value as a string.
- * @return A formatted string ready for LCD display.
  */
-static String formatDisplaySensorData(sensors_metadata_catalog_ts sensor_metadata, char* val);
+static void formatDisplaySensorData(char *display_string, size_t size, uint8_t sensor_index, const char *val);
 
 /** 
- * @brief Clears a specific row on the LCD by printing blank spaces.
+ * @brief Clears a specific row of the frame.
  * 
  * @param row The row index to clear.
  */
 static void displayEmptyLine(uint8_t row);
+
+/**
+ * @brief Writes a text into a row of the frame, padded with spaces to the full width.
+ *
+ * Only the RAM frame is changed, the panel is updated by displayFlushFrame().
+ *
+ * @param row The row index to write.
+ * @param text Null terminated text, longer texts are cut to the display width.
+ */
+static void displayWriteRow(uint8_t row, const char *text);
+
+/**
+ * @brief Loads the bar glyph of every trend level into the CGRAM of the LCD.
+ *
+ * @return true if every glyph was written, false otherwise.
+ */
+static bool loadTrendGlyphs();
+
+/**
+ * @brief Sends only the characters of the frame which differ from the panel.
+ *
+ * Changed characters are sent in runs, the cursor is set only when it is not already
+ * at the start of the run, and runs separated by at most DISPLAY_SET_CURSOR_COST_CHARS unchanged
+ * characters are merged. The whole refresh is sent as one background I2C job, if the previous
+ * refresh is still on the bus the frame is kept and sent by a later call.
+ *
+ * @return true (DISPLAY_FRAME_QUEUED) if the refresh was queued, false (DISPLAY_FRAME_DEFERRED) if the frame stays in RAM.
+ */
+static bool displayFlushFrame();
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 control_error_code_te display_init()
 {
-  lcd.begin(DISPLAY_LCD_WIDTH, DISPLAY_LCD_HEIGHT); // Initialize a 16x2 LCD
-  lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_START_ROW);
-  lcd.backlight();
-  lcd.noCursor();
+  if(!LCD_I2C_IS_POWERED_UP(millis()))
+  {
+    return ERROR_CODE_INIT_PENDING; // LCD controller is still in its power on reset
+  }
+
+  if(!lcd_i2c_init() || !loadTrendGlyphs()) // Initialize a 16x2 LCD, panel is cleared and backlight is on
+  {
+    return ERROR_CODE_INIT_FAILED;
+  }
+  // Frame may already contain rows routed before the LCD was ready, they are sent by the next flush
+  char *frame_character = &frame[DISPLAY_START_ROW][DISPLAY_START_COLUMN];
+  for (uint8_t i = 0u; i < sizeof(frame); i++)
+  {
+    if('\0' == frame_character[i])
+    {
+      frame_character[i] = DISPLAY_BLANK_CHARACTER; // Row was never written
+    }
+  }
+  memset(panel, DISPLAY_BLANK_CHARACTER, sizeof(panel));
+  cursor_row = DISPLAY_CURSOR_UNKNOWN; // Address counter was left in the CGRAM by the glyphs
+  cursor_column = DISPLAY_CURSOR_UNKNOWN;
+  display_ready = DISPLAY_READY;
   return ERROR_CODE_NO_ERROR;
 }
 
@@ -80,61 +186,75 @@ control_error_code_te display_displayData(const control_data_ts *data)
   switch(data->input.io_component)
   {
     case INPUT_SENSORS:
-      error_code = display_displaySensorMeasurement(data);
+      error_code = display_displaySensorMeasurement(data, DISPLAY_SENSORS_ROW);
       break;
 
+#ifdef RTC_COMPONENT
     case INPUT_RTC:
-      error_code = display_displayTime(data);
+      error_code = display_displayTime(data, DISPLAY_TIME_ROW);
       break;
+#endif
 
     case INPUT_I2C_SCAN:
       error_code = display_displayI2cScan(data);
       break;
 
     case INPUT_ERROR:
-      error_code = ERROR_CODE_NO_ERROR; // Need to implement
+      error_code = display_displayError(&(data->input_return.error_msg));
+      break;
+
+    case INPUT_VIEW_PAGE:
+      error_code = display_displayViewPage(data->input_return.view_page);
+      break;
+
+    case INPUT_HISTORY:
+      error_code = display_displayTrend(data, DISPLAY_TREND_ROW);
       break;
 
     default:
       break;
   }
 
+  frame_pending = (DISPLAY_FRAME_QUEUED != displayFlushFrame()); // Send only what changed
+
   return error_code;
 }
+
+bool display_isFramePending()
+{
+  return frame_pending;
+}
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
-static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data)
+static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data, uint8_t row)
 {
-  sensor_reading_ts sensor_data = data->input_return.sensor_reading;
+  const sensor_reading_ts *sensor_data = &(data->input_return.sensor_reading);
   uint8_t sensor_id = data->input.device_id;
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR; // Default Error code
   bool proceed_with_display = DISPLAY_DONT_PROCEED_WITH_DISPLAY; // Flag to determine if the display should be updated
   char val[DISPLAY_MAX_STRING_LEN]; // Holds the formatted sensor value or indication
 
-  // Retrieve metadata for the given sensor ID
-  sensors_interface_metadata_ts sensor_metadata = sensors_interface_getSensorMetadata(sensor_id);
+  // Retrieve catalog index for the given sensor ID
+  uint8_t sensor_index = sensors_interface_sensorIdToIndex(sensor_id);
 
-  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensor_metadata.success_status)
+  if(SENSORS_INTERFACE_INVALID_INDEX != sensor_index)
   {
     // Extract what's needed for now
-    uint8_t measurement_type = sensor_metadata.metadata.measurement_type; // Expected measurement type
-    uint8_t num_of_decimals = sensor_metadata.metadata.num_of_decimals; // Number of decimal places for display
+    uint8_t measurement_type = sensors_interface_getMeasurementType(sensor_index); // Expected measurement type
+    uint8_t num_of_decimals = sensors_interface_getNumOfDecimals(sensor_index); // Number of decimal places for display
 
-    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
+    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
     {
       // Case: Sensor provides a numerical value
-      char val_buffer[DISPLAY_DTOSTRF_BUFFER_SIZE]; // Buffer for formatted float value
-      dtostrf(sensor_data.value, DISPLAY_MIN_FLOAT_STRING_LEN, num_of_decimals, val_buffer); // Convert float to string
-      strncpy(val, val_buffer, sizeof(val) - DISPLAY_NULL_TERMINATOR_SIZE); // Copy into val
-      val[sizeof(val) - DISPLAY_NULL_TERMINATOR_SIZE] = '\0'; // Null terminate
+      (void)sensor_value_format(val, sizeof(val), sensor_data->value, num_of_decimals); // Integer formatting in fixed-point mode
       proceed_with_display = DISPLAY_PROCEED_WITH_DISPLAY;
     }
-    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
+    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
     {
       // Case: Sensor provides an indication (boolean)
-      snprintf(val, sizeof(val), "%s", sensor_data.indication ? "yes" : "no");
+      snprintf(val, sizeof(val), "%s", sensor_data->indication ? "yes" : "no");
       proceed_with_display = DISPLAY_PROCEED_WITH_DISPLAY;
     }
     else
@@ -150,59 +270,116 @@ static control_error_code_te display_displaySensorMeasurement(const control_data
   // Display the formatted value if valid, otherwise clear the display row
   if(DISPLAY_PROCEED_WITH_DISPLAY == proceed_with_display)
   {
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_SENSORS_ROW);
-    String display_string = formatDisplaySensorData(sensor_metadata.metadata, val); // Format display string
-    lcd.print(display_string); // Print the formatted sensor data to the LCD
+    char display_string[DISPLAY_MAX_STRING_LEN];
+    formatDisplaySensorData(display_string, sizeof(display_string), sensor_index, val); // Format display string
+    displayWriteRow(row, display_string); // Put the formatted sensor data into the frame
   }
   else
   {
-    displayEmptyLine(DISPLAY_SENSORS_ROW); // Clear the display row if no valid data
+    displayEmptyLine(row); // Clear the display row if no valid data
   }
   return error_code;
 }
 
-static control_error_code_te display_displayTime(const control_data_ts *data)
+#ifdef RTC_COMPONENT
+static control_error_code_te display_displayTime(const control_data_ts *data, uint8_t row)
 {
-  rtc_reading_ts time_data = data->input_return.rtc_reading;
-
-  lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_TIME_ROW);
+  const rtc_reading_ts *time_data = &(data->input_return.rtc_reading);
 
-  uint16_t year = time_data.year;
-  uint8_t month = time_data.month;
-  uint8_t day = time_data.day;
-  uint8_t hour = time_data.hour;
-  uint8_t mins = time_data.mins;
-  uint8_t secs = time_data.secs;
+  uint16_t year = time_data->year;
+  uint8_t month = time_data->month;
+  uint8_t day = time_data->day;
+  uint8_t hour = time_data->hour;
+  uint8_t mins = time_data->mins;
+  uint8_t secs = time_data->secs;
 
   // Build the formatted time string to fit the 16-character display
   char time_string[DISPLAY_MAX_STRING_LEN]; // One extra for null terminator
   snprintf(time_string, sizeof(time_string), "%02d:%02d %02d/%02d/%04d", hour, mins, day, month, year); // To avoid dynamic allocation
 
-  lcd.print(time_string);
+  displayWriteRow(row, time_string); // Usually only the minutes change
 
   return ERROR_CODE_NO_ERROR; // Return success error code
 }
+#endif
+
+static control_error_code_te display_displayTrend(const control_data_ts *data, uint8_t row)
+{
+  const trend_reading_ts *trend_data = &(data->input_return.trend_reading);
+
+  uint8_t num_of_samples = (TREND_MAX_SAMPLES < trend_data->num_of_samples) ? TREND_MAX_SAMPLES : trend_data->num_of_samples;
+  uint8_t first_column = (uint8_t)(DISPLAY_LCD_WIDTH - num_of_samples);
+  char trend_string[DISPLAY_MAX_STRING_LEN];
+
+  // Glyph characters start at 0x08, so the bars never terminate the string
+  for (uint8_t column = DISPLAY_START_COLUMN; column < DISPLAY_LCD_WIDTH; column++)
+  {
+    uint8_t level = (column < first_column) ? TREND_NO_SAMPLE : trend_data->levels[column - first_column];
+    bool is_bar = (TREND_MIN_LEVEL <= level && TREND_MAX_LEVEL >= level);
+    trend_string[column] = is_bar ? LCD_I2C_GLYPH_CHARACTER(DISPLAY_TREND_BAR_SLOT(level)) : DISPLAY_BLANK_CHARACTER;
+  }
+  trend_string[DISPLAY_LCD_WIDTH] = '\0';
+
+  displayWriteRow(row, trend_string); // Only the bars which moved are sent
+  return ERROR_CODE_NO_ERROR;
+}
+
+static control_error_code_te display_displayViewPage(const control_view_page_ts *page)
+{
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+
+  for (uint8_t row = DISPLAY_START_ROW; row < CONTROL_VIEW_PAGE_ROWS; row++)
+  {
+    const control_data_ts *row_data = &(page->rows[row]);
+    control_error_code_te row_error_code = ERROR_CODE_NO_ERROR;
+
+    switch(row_data->input.io_component)
+    {
+      case INPUT_SENSORS:
+        row_error_code = display_displaySensorMeasurement(row_data, row);
+        break;
+
+#ifdef RTC_COMPONENT
+      case INPUT_RTC:
+        row_error_code = display_displayTime(row_data, row);
+        break;
+#endif
+
+      case INPUT_HISTORY:
+        row_error_code = display_displayTrend(row_data, row);
+        break;
+
+      default:
+        displayEmptyLine(row); // Row is not used by the page
+        break;
+    }
+
+    if(ERROR_CODE_NO_ERROR == error_code)
+    {
+      error_code = row_error_code;
+    }
+  }
+  return error_code;
+}
 
 static control_error_code_te display_displayI2cScan(const control_data_ts *data)
 {
-  i2c_scan_reading_ts i2c_scan_data = data->input_return.i2c_scan_reading;
+  const i2c_scan_reading_ts *i2c_scan_data = &(data->input_return.i2c_scan_reading);
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
   // Create buffer for display strings
   char display_string[DISPLAY_MAX_STRING_LEN];  // +1 for null terminator
 
-  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data.device_address)
+  if(I2C_SCAN_IS_MULTI_DEVICE_SCAN(i2c_scan_data->device_address))
   {
     // Print user friendly scanning message
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_STRING_ROW);
     snprintf(display_string, sizeof(display_string), "Scanning I2C....");
-    lcd.print(display_string);
+    displayWriteRow(DISPLAY_I2C_SCAN_STRING_ROW, display_string);
 
     // Print I2C address
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_ADDR_ROW);
-    snprintf(display_string, sizeof(display_string), "I2C Addr: 0x%02X", i2c_scan_data.current_i2c_addr);
-    lcd.print(display_string);
+    snprintf(display_string, sizeof(display_string), "I2C Addr: 0x%02X", i2c_scan_data->current_i2c_addr);
+    displayWriteRow(DISPLAY_I2C_SCAN_ADDR_ROW, display_string);
   }
   else
   {
@@ -211,7 +388,7 @@ static control_error_code_te display_displayI2cScan(const control_data_ts *data)
     // Create buffer for status
     char status_string[DISPLAY_MAX_STRING_LEN];  // +1 for null terminator
 
-    switch(i2c_scan_data.single_device_status)
+    switch(i2c_scan_data->single_device_status)
     {
       case I2C_SCAN_TRANSMISSION_RESULT_SUCCESS:
         snprintf(status_string, sizeof(status_string), "Successful");
@@ -242,48 +419,147 @@ static control_error_code_te display_displayI2cScan(const control_data_ts *data)
     if(DISPLAY_PROCEED_WITH_DISPLAY == proceed_with_display)
     {
       // Print headline with device address
-      lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_STRING_ROW);
-      snprintf(display_string, sizeof(display_string), "I2C 0x%02X status:", i2c_scan_data.device_address);
-      lcd.print(display_string);
-
-      // Print device status based on scan result
-      lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_ADDR_ROW);
-      // Print the status on LCD with padding
-      while(strlen(status_string) < DISPLAY_LCD_WIDTH) 
-      {
-        strcat(status_string, " "); // Pad the string with spaces
-      }
-      lcd.print(status_string);
+      snprintf(display_string, sizeof(display_string), "I2C 0x%02X status:", i2c_scan_data->device_address);
+      displayWriteRow(DISPLAY_I2C_SCAN_STRING_ROW, display_string);
+
+      // Print device status based on scan result, row is padded with spaces
+      displayWriteRow(DISPLAY_I2C_SCAN_ADDR_ROW, status_string);
     }
   }
   /* IMPORTANT: Check of invalid I2C address is done on I2C scanner side and it should not arrive on the Display */
   return error_code;
 }
 
-static String formatDisplaySensorData(sensors_metadata_catalog_ts sensor_metadata, char* val)
+static control_error_code_te display_displayError(const control_error_ts *error)
 {
-  char display_string[DISPLAY_MAX_STRING_LEN]; // Buffer to hold formatted string
-  int display_sensor_type_length = min(sensor_metadata.display_num_of_letters, strlen(sensor_metadata.sensor_type));
-  
-  snprintf(display_string, sizeof(display_string), "%s: %s%s", sensor_metadata.sensor_type, val, sensor_metadata.measurement_unit);
-
-  // Ensure the string fits the display by padding with spaces
-  int len = strlen(display_string);
-  for (int i = len; i < DISPLAY_LCD_WIDTH; ++i)
+  char error_string[DISPLAY_MAX_STRING_LEN];
+
+  // For example "E12 0:3 x25", the row is cut to the display width
+  snprintf(error_string, sizeof(error_string), "E%u %u:%u x%u",
+           (unsigned int)error->error_code, (unsigned int)error->component.io_component,
+           (unsigned int)error->component.device_id, (unsigned int)error->occurrences);
+  displayWriteRow(DISPLAY_ERROR_ROW, error_string);
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+static void formatDisplaySensorData(char *display_string, size_t size, uint8_t sensor_index, const char *val)
+{
+  char sensor_type[DISPLAY_MAX_STRING_LEN]; // Longer sensor types would not fit the display anyway
+  char measurement_unit[SENSORS_INTERFACE_MEASUREMENT_UNIT_MAX_LEN + DISPLAY_NULL_TERMINATOR_SIZE];
+
+  // Copy only the strings from program memory
+  PLATFORM_STRNCPY_FLASH(sensor_type, sensors_interface_getSensorType(sensor_index), sizeof(sensor_type) - DISPLAY_NULL_TERMINATOR_SIZE);
+  sensor_type[sizeof(sensor_type) - DISPLAY_NULL_TERMINATOR_SIZE] = '\0';
+  PLATFORM_STRNCPY_FLASH(measurement_unit, sensors_interface_getMeasurementUnit(sensor_index), sizeof(measurement_unit) - DISPLAY_NULL_TERMINATOR_SIZE);
+  measurement_unit[sizeof(measurement_unit) - DISPLAY_NULL_TERMINATOR_SIZE] = '\0';
+
+  if(DISPLAY_MAX_STRING_LEN < size)
   {
-    display_string[i] = ' ';
+    size = DISPLAY_MAX_STRING_LEN; // Longer text would not fit the display, padding is done by displayWriteRow()
   }
-  display_string[DISPLAY_LCD_WIDTH] = '\0';  // Null-terminate the string
-  
-  return String(display_string); // Return the formatted string as a String object
+  snprintf(display_string, size, "%s: %s%s", sensor_type, val, measurement_unit);
 }
 
 static void displayEmptyLine(uint8_t row)
 {
-  lcd.setCursor(DISPLAY_START_COLUMN, row);
-  for (uint8_t i = 0; i < DISPLAY_LCD_WIDTH; i++) 
+  displayWriteRow(row, "");
+}
+
+static void displayWriteRow(uint8_t row, const char *text)
+{
+  if(DISPLAY_LCD_HEIGHT <= row)
+  {
+    return;
+  }
+
+  uint8_t column = DISPLAY_START_COLUMN;
+  for (; column < DISPLAY_LCD_WIDTH && '\0' != text[column]; column++)
+  {
+    frame[row][column] = text[column];
+  }
+  for (; column < DISPLAY_LCD_WIDTH; column++)
+  {
+    frame[row][column] = DISPLAY_BLANK_CHARACTER; // Pad the rest of the row
+  }
+}
+
+static bool loadTrendGlyphs()
+{
+  for (uint8_t level = TREND_MIN_LEVEL; level <= TREND_MAX_LEVEL; level++)
+  {
+    uint8_t rows[LCD_I2C_GLYPH_HEIGHT];
+    for (uint8_t pixel_row = 0u; pixel_row < LCD_I2C_GLYPH_HEIGHT; pixel_row++)
+    {
+      // Bars grow from the bottom row of the glyph
+      rows[pixel_row] = (pixel_row >= (uint8_t)(LCD_I2C_GLYPH_HEIGHT - level)) ? DISPLAY_GLYPH_FULL_ROW : DISPLAY_GLYPH_EMPTY_ROW;
+    }
+    if(!lcd_i2c_loadGlyph(DISPLAY_TREND_BAR_SLOT(level), rows))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool displayFlushFrame()
+{
+  if(DISPLAY_READY != display_ready || lcd_i2c_isBusy())
+  {
+    return DISPLAY_FRAME_DEFERRED; // Frame stays in RAM, unchanged characters are compared again on the next call
+  }
+  if(lcd_i2c_hasFrameFailed())
+  {
+    // Previous refresh did not reach the panel, rewrite everything from a known cursor position
+    memset(panel, '\0', sizeof(panel));
+    cursor_row = DISPLAY_CURSOR_UNKNOWN;
+    cursor_column = DISPLAY_CURSOR_UNKNOWN;
+  }
+
+  lcd_i2c_beginFrame();
+  for (uint8_t row = DISPLAY_START_ROW; row < DISPLAY_LCD_HEIGHT; row++)
+  {
+    uint8_t column = DISPLAY_START_COLUMN;
+    while(column < DISPLAY_LCD_WIDTH)
+    {
+      if(frame[row][column] == panel[row][column])
+      {
+        column++;
+        continue;
+      }
+
+      // Extend the run over short gaps of unchanged characters
+      uint8_t run_end = (uint8_t)(column + 1u);
+      for (uint8_t probe = run_end; probe < DISPLAY_LCD_WIDTH && (uint8_t)(probe - run_end) <= DISPLAY_SET_CURSOR_COST_CHARS; probe++)
+      {
+        if(frame[row][probe] != panel[row][probe])
+        {
+          run_end = (uint8_t)(probe + 1u);
+        }
+      }
+
+      if(cursor_row != row || cursor_column != column)
+      {
+        lcd_i2c_setCursor(column, row);
+      }
+      for (; column < run_end; column++)
+      {
+        lcd_i2c_write(frame[row][column]);
+        panel[row][column] = frame[row][column];
+      }
+      cursor_row = row;
+      cursor_column = run_end; // Cursor advanced with every written character
+    }
+  }
+
+  if(!lcd_i2c_endFrame())
   {
-    lcd.print(" ");
+    // Frame was not queued, nothing of it reaches the panel
+    memset(panel, '\0', sizeof(panel));
+    cursor_row = DISPLAY_CURSOR_UNKNOWN;
+    cursor_column = DISPLAY_CURSOR_UNKNOWN;
+    return DISPLAY_FRAME_DEFERRED;
   }
+  return DISPLAY_FRAME_QUEUED;
 }
 /* *************************************** */
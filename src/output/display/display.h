@@ -2,10 +2,10 @@
 #define DISPLAY_H
 
 #include <Arduino.h>
-#include <LiquidCrystal_I2C.h>
-#include <WString.h>
 #include "display_config.h"
+#include "lcd_i2c.h"
 #include "../../control/control_types.h"
+#include "../../platform/platform.h"
 
 /* Start column for display cursor */
 #define DISPLAY_START_COLUMN  (0u)
@@ -17,15 +17,37 @@
 /* Flag to prevent displaying data */
 #define DISPLAY_DONT_PROCEED_WITH_DISPLAY (false)
 
-/* Minimum length of the float string for display */
-#define DISPLAY_MIN_FLOAT_STRING_LEN  (signed char)(1)
-/* Size of the buffer for converting float to string */
-#define DISPLAY_DTOSTRF_BUFFER_SIZE   (uint8_t)(20u)
 /* Size for the null terminator in strings */
 #define DISPLAY_NULL_TERMINATOR_SIZE  (uint8_t)(1u)
 /** Defines the maximum string length for the display, including the null terminator. */
 #define DISPLAY_MAX_STRING_LEN        (uint8_t)(DISPLAY_LCD_WIDTH + DISPLAY_NULL_TERMINATOR_SIZE)
 
+/* Flags indicating if the LCD is initialized and frames can be sent to it */
+#define DISPLAY_READY                 (bool)(true)
+#define DISPLAY_NOT_READY             (bool)(false)
+
+/* Flags indicating if the frame was queued for the LCD by displayFlushFrame() */
+#define DISPLAY_FRAME_QUEUED          (bool)(true)
+#define DISPLAY_FRAME_DEFERRED        (bool)(false)
+
+/* Character the panel is filled with after lcd_i2c_init() clears it */
+#define DISPLAY_BLANK_CHARACTER       (char)(' ')
+/**
+ * Unchanged characters between two changed runs are rewritten when there are at most this many,
+ * sending them costs no more than the set cursor command needed to skip them.
+ */
+#define DISPLAY_SET_CURSOR_COST_CHARS (uint8_t)(1u)
+/* Cursor position which forces a set cursor command before the next write */
+#define DISPLAY_CURSOR_UNKNOWN        (uint8_t)(0xFFu)
+
+/**
+ * Glyphs of the trend bars, the glyph in slot n lights the lowest n + 1 pixel rows, so one level
+ * of a trend is one pixel row. The set is fixed, it is loaded into the CGRAM by every display_init().
+ */
+#define DISPLAY_GLYPH_FULL_ROW        (uint8_t)(LCD_I2C_GLYPH_ROW_MASK)
+#define DISPLAY_GLYPH_EMPTY_ROW       (uint8_t)(0x00u)
+#define DISPLAY_TREND_BAR_SLOT(level) (uint8_t)((level) - TREND_MIN_LEVEL)
+
 /**
  * @brief Initializes the LCD display module.
  *
@@ -34,6 +56,8 @@
  *
  * @return control_error_code_te
  * - ERROR_CODE_NO_ERROR: Display initialized successfully.
+ * - ERROR_CODE_INIT_FAILED: LCD did not acknowledge the initialization.
+ * - ERROR_CODE_INIT_PENDING: LCD is still in its power on reset, call again later.
  */
 control_error_code_te display_init();
 
@@ -53,4 +77,14 @@ control_error_code_te display_init();
  **/
 control_error_code_te display_displayData(const control_data_ts *data);
 
+/**
+ * @brief Checks if the frame of the last display_displayData() call is still waiting in RAM.
+ *
+ * The frame is not sent while the previous one is on the bus (or before the LCD is initialized),
+ * it is sent by the next call of display_displayData().
+ *
+ * @return true if the panel does not show the frame yet.
+ */
+bool display_isFramePending();
+
 #endif
\ No newline at end of file
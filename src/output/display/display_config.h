@@ -18,5 +18,9 @@
 #define DISPLAY_I2C_SCAN_STRING_ROW  (uint8_t)(0u)
 /* Row for displaying I2C address during scan */
 #define DISPLAY_I2C_SCAN_ADDR_ROW    (uint8_t)(1u)
+/* Row for displaying the trend of a sensor */
+#define DISPLAY_TREND_ROW            (uint8_t)(1u)
+/* Row for displaying the fault code of a reported error, until the next time is displayed */
+#define DISPLAY_ERROR_ROW            (uint8_t)(1u)
 
 #endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "lcd_i2c.h"
+
+/* STATIC GLOBAL VARIABLES */
+// Expander bytes of the frame which is built or sent
+static uint8_t frame_buffer[LCD_I2C_FRAME_SIZE];
+static uint8_t frame_length = 0u;
+static i2c_bus_job_ts frame_job;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(DISPLAY_LCD_HEIGHT <= 2u, "Only the DDRAM offsets of two rows are defined");
+static_assert((uint16_t)DISPLAY_LCD_HEIGHT * (DISPLAY_LCD_WIDTH + 1u) * LCD_I2C_BYTES_PER_LCD_BYTE <= 0xFFu,
+              "Frame does not fit a single I2C job");
+static_assert(LCD_I2C_GLYPH_UPLOAD_SIZE <= 0xFFu, "Glyph does not fit a single I2C job");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Appends one byte of the LCD to the frame as two nibbles.
+ *
+ * @param value Instruction or character.
+ * @param mode LCD_I2C_PIN_RS for a character, 0 for an instruction.
+ */
+static void appendLcdByte(uint8_t value, uint8_t mode);
+
+/**
+ * @brief Encodes one byte of the LCD as the expander bytes of its two nibbles.
+ *
+ * @param bytes Receives LCD_I2C_BYTES_PER_LCD_BYTE expander bytes.
+ * @param value Instruction or character.
+ * @param mode LCD_I2C_PIN_RS for a character, 0 for an instruction.
+ */
+static void encodeLcdByte(uint8_t *bytes, uint8_t value, uint8_t mode);
+
+/**
+ * @brief Writes one nibble directly to the expander and waits for the transfer.
+ *
+ * @param nibble Nibble in the upper four bits.
+ * @param mode LCD_I2C_PIN_RS for a character, 0 for an instruction.
+ * @return true if the expander acknowledged the write, false otherwise.
+ */
+static bool sendNibble(uint8_t nibble, uint8_t mode);
+
+/**
+ * @brief Writes one instruction directly to the LCD and waits for the transfer.
+ *
+ * @param command Instruction of the HD44780.
+ * @return true if the expander acknowledged the write, false otherwise.
+ */
+static bool sendCommand(uint8_t command);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+bool lcd_i2c_init()
+{
+  bool result = true;
+
+  // Three times the 8-bit function set, the LCD may be in any interface mode at this point
+  result &= sendNibble(LCD_I2C_INIT_8BIT_NIBBLE, 0u);
+  delayMicroseconds(LCD_I2C_INIT_DELAY_US);
+  result &= sendNibble(LCD_I2C_INIT_8BIT_NIBBLE, 0u);
+  delayMicroseconds(LCD_I2C_INIT_DELAY_US);
+  result &= sendNibble(LCD_I2C_INIT_8BIT_NIBBLE, 0u);
+  delayMicroseconds(LCD_I2C_INIT_SHORT_DELAY_US);
+  result &= sendNibble(LCD_I2C_INIT_4BIT_NIBBLE, 0u);
+
+  result &= sendCommand(LCD_I2C_CMD_FUNCTION_SET);
+  result &= sendCommand(LCD_I2C_CMD_DISPLAY_ON);
+  result &= sendCommand(LCD_I2C_CMD_CLEAR);
+  delay(LCD_I2C_CLEAR_DELAY_MS);
+  result &= sendCommand(LCD_I2C_CMD_ENTRY_MODE);
+
+  frame_length = 0u;
+  return result;
+}
+
+bool lcd_i2c_loadGlyph(uint8_t slot, const uint8_t *rows)
+{
+  i2c_bus_job_ts job;
+  uint8_t upload[LCD_I2C_GLYPH_UPLOAD_SIZE];
+
+  // Frame buffer may still be clocked out by the ISR, the glyph goes out as one job of its own
+  encodeLcdByte(upload, (uint8_t)(LCD_I2C_CMD_SET_CGRAM_ADDR | ((slot % LCD_I2C_NUM_OF_GLYPHS) * LCD_I2C_GLYPH_HEIGHT)), 0u);
+  for (uint8_t row = 0u; row < LCD_I2C_GLYPH_HEIGHT; row++)
+  {
+    encodeLcdByte(&upload[(1u + row) * LCD_I2C_BYTES_PER_LCD_BYTE], (uint8_t)(rows[row] & LCD_I2C_GLYPH_ROW_MASK), LCD_I2C_PIN_RS);
+  }
+
+  i2c_bus_prepareJob(&job, DISPLAY_LCD_I2C_ADDDR, upload, sizeof(upload), nullptr, 0u);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+bool lcd_i2c_isBusy()
+{
+  return I2C_BUS_IS_JOB_PENDING(frame_job.status);
+}
+
+bool lcd_i2c_hasFrameFailed()
+{
+  return I2C_BUS_JOB_IDLE != frame_job.status && I2C_BUS_JOB_DONE != frame_job.status && !lcd_i2c_isBusy();
+}
+
+void lcd_i2c_beginFrame()
+{
+  frame_length = 0u;
+}
+
+void lcd_i2c_setCursor(uint8_t column, uint8_t row)
+{
+  uint8_t row_offset = (0u == row) ? LCD_I2C_ROW_0_OFFSET : LCD_I2C_ROW_1_OFFSET;
+  appendLcdByte((uint8_t)(LCD_I2C_CMD_SET_DDRAM_ADDR | (row_offset + column)), 0u);
+}
+
+void lcd_i2c_write(char character)
+{
+  appendLcdByte((uint8_t)character, LCD_I2C_PIN_RS);
+}
+
+bool lcd_i2c_endFrame()
+{
+  if(0u == frame_length)
+  {
+    return I2C_BUS_JOB_ACCEPTED;
+  }
+
+  i2c_bus_prepareJob(&frame_job, DISPLAY_LCD_I2C_ADDDR, frame_buffer, frame_length, nullptr, 0u);
+  return i2c_bus_submit(&frame_job);
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void appendLcdByte(uint8_t value, uint8_t mode)
+{
+  if((uint8_t)(LCD_I2C_FRAME_SIZE - frame_length) < LCD_I2C_BYTES_PER_LCD_BYTE)
+  {
+    return; // Can not happen with the frames of the display, runs are bounded by LCD_I2C_FRAME_MAX_LCD_BYTES
+  }
+
+  encodeLcdByte(&frame_buffer[frame_length], value, mode);
+  frame_length = (uint8_t)(frame_length + LCD_I2C_BYTES_PER_LCD_BYTE);
+}
+
+static void encodeLcdByte(uint8_t *bytes, uint8_t value, uint8_t mode)
+{
+  uint8_t nibbles[] = {(uint8_t)(value & LCD_I2C_DATA_MASK), (uint8_t)((value << 4) & LCD_I2C_DATA_MASK)};
+  for (uint8_t i = 0u; i < sizeof(nibbles); i++)
+  {
+    uint8_t pins = (uint8_t)(nibbles[i] | mode | LCD_I2C_PIN_BACKLIGHT);
+    bytes[i * LCD_I2C_BYTES_PER_NIBBLE] = (uint8_t)(pins | LCD_I2C_PIN_EN);
+    bytes[i * LCD_I2C_BYTES_PER_NIBBLE + 1u] = pins;
+  }
+}
+
+static bool sendNibble(uint8_t nibble, uint8_t mode)
+{
+  i2c_bus_job_ts job;
+  uint8_t pins = (uint8_t)((nibble & LCD_I2C_DATA_MASK) | mode | LCD_I2C_PIN_BACKLIGHT);
+  const uint8_t tx_buffer[LCD_I2C_BYTES_PER_NIBBLE] = {(uint8_t)(pins | LCD_I2C_PIN_EN), pins};
+
+  i2c_bus_prepareJob(&job, DISPLAY_LCD_I2C_ADDDR, tx_buffer, sizeof(tx_buffer), nullptr, 0u);
+  return I2C_BUS_JOB_DONE == i2c_bus_transfer(&job);
+}
+
+static bool sendCommand(uint8_t command)
+{
+  // Each expander byte takes about 90 us at 100 kHz, longer than any instruction except clear
+  return sendNibble(command, 0u) && sendNibble((uint8_t)(command << 4), 0u);
+}
+/* *************************************** */
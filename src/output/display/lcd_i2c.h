@@ -0,0 +1,134 @@
+#ifndef LCD_I2C_H
+#define LCD_I2C_H
+
+#include <Arduino.h>
+#include "display_config.h"
+#include "../../i2c_bus/i2c_bus.h"
+
+/**
+ * @file lcd_i2c.h
+ * @brief HD44780 character LCD behind a PCF8574 I2C port expander, driven through the I2C bus engine.
+ *
+ * The display builds all changes of one refresh into a frame of expander bytes, which is sent
+ * to the panel as a single background job, so the main loop never waits for the LCD.
+ */
+
+/* Pins of the PCF8574 expander */
+#define LCD_I2C_PIN_RS              (uint8_t)(0x01u) /* Register select, data when set */
+#define LCD_I2C_PIN_EN              (uint8_t)(0x04u) /* Enable, the LCD latches the nibble on its falling edge */
+#define LCD_I2C_PIN_BACKLIGHT       (uint8_t)(0x08u)
+#define LCD_I2C_DATA_MASK           (uint8_t)(0xF0u) /* Data lines D4..D7 */
+
+/* Expander bytes per nibble (with and without EN) and per LCD byte (two nibbles) */
+#define LCD_I2C_BYTES_PER_NIBBLE    (uint8_t)(2u)
+#define LCD_I2C_BYTES_PER_LCD_BYTE  (uint8_t)(2u * LCD_I2C_BYTES_PER_NIBBLE)
+
+/**
+ * Maximum number of LCD bytes in one frame. Every row needs at most one set DDRAM address
+ * command more than it has characters, because runs of changed characters are only split by
+ * gaps which are longer than the command.
+ */
+#define LCD_I2C_FRAME_MAX_LCD_BYTES (uint8_t)(DISPLAY_LCD_HEIGHT * (DISPLAY_LCD_WIDTH + 1u))
+#define LCD_I2C_FRAME_SIZE          (uint8_t)(LCD_I2C_FRAME_MAX_LCD_BYTES * LCD_I2C_BYTES_PER_LCD_BYTE)
+
+/* Instructions of the HD44780 */
+#define LCD_I2C_CMD_CLEAR           (uint8_t)(0x01u)
+#define LCD_I2C_CMD_ENTRY_MODE      (uint8_t)(0x06u) /* Cursor moves right, no display shift */
+#define LCD_I2C_CMD_DISPLAY_ON      (uint8_t)(0x0Cu) /* Display on, cursor and blinking off */
+#define LCD_I2C_CMD_FUNCTION_SET    (uint8_t)(0x28u) /* 4-bit interface, 2 lines, 5x8 font */
+#define LCD_I2C_CMD_SET_CGRAM_ADDR  (uint8_t)(0x40u)
+#define LCD_I2C_CMD_SET_DDRAM_ADDR  (uint8_t)(0x80u)
+
+/* User defined characters in the CGRAM, 5x8 pixels, rows from top to bottom with the pixels in the lower five bits */
+#define LCD_I2C_NUM_OF_GLYPHS       (uint8_t)(8u)
+#define LCD_I2C_GLYPH_HEIGHT        (uint8_t)(8u)
+#define LCD_I2C_GLYPH_ROW_MASK      (uint8_t)(0x1Fu)
+/* Character codes 0x08..0x0F show the glyphs like 0x00..0x07, without a null terminator in the strings */
+#define LCD_I2C_GLYPH_CHARACTER(slot) (char)(0x08u + (slot))
+/* Expander bytes of a glyph upload, the set CGRAM address command and the rows, kept apart from the frame on the bus */
+#define LCD_I2C_GLYPH_UPLOAD_SIZE   (uint8_t)((1u + LCD_I2C_GLYPH_HEIGHT) * LCD_I2C_BYTES_PER_LCD_BYTE)
+
+/* Nibbles of the power on sequence which switches the LCD to the 4-bit interface */
+#define LCD_I2C_INIT_8BIT_NIBBLE    (uint8_t)(0x30u)
+#define LCD_I2C_INIT_4BIT_NIBBLE    (uint8_t)(0x20u)
+
+/* DDRAM address of the first character of a row */
+#define LCD_I2C_ROW_0_OFFSET        (uint8_t)(0x00u)
+#define LCD_I2C_ROW_1_OFFSET        (uint8_t)(0x40u)
+
+/* Waiting times of the power on sequence (datasheet) */
+#define LCD_I2C_POWER_ON_DELAY_MS   (uint32_t)(50u)
+#define LCD_I2C_INIT_DELAY_US       (uint16_t)(4500u)
+#define LCD_I2C_INIT_SHORT_DELAY_US (uint16_t)(150u)
+#define LCD_I2C_CLEAR_DELAY_MS      (uint8_t)(2u)
+
+/* Macro that checks if the LCD had enough time after power on, millis() counts from reset */
+#define LCD_I2C_IS_POWERED_UP(current_millis) ((current_millis) >= LCD_I2C_POWER_ON_DELAY_MS)
+
+/**
+ * @brief Initializes the LCD with the power on sequence and waits for every step.
+ *
+ * Only for initialization code, the panel is cleared and the backlight is switched on.
+ * Must not be called before LCD_I2C_IS_POWERED_UP(millis()) is true.
+ *
+ * @return true if the expander acknowledged every write, false otherwise.
+ */
+bool lcd_i2c_init();
+
+/**
+ * @brief Writes the pixels of one user defined character into the CGRAM and waits for the transfer.
+ *
+ * Only for initialization code. The glyph has its own buffer and is queued behind a frame which is
+ * still on the bus. The address counter points into the CGRAM afterwards, the cursor must be set
+ * before the next character.
+ *
+ * @param slot Slot of the glyph (0..LCD_I2C_NUM_OF_GLYPHS - 1), shown by LCD_I2C_GLYPH_CHARACTER(slot).
+ * @param rows LCD_I2C_GLYPH_HEIGHT rows of pixels, top row first.
+ * @return true if the expander acknowledged every write, false otherwise.
+ */
+bool lcd_i2c_loadGlyph(uint8_t slot, const uint8_t *rows);
+
+/**
+ * @brief Checks if the previous frame is still being sent.
+ *
+ * @return true if the frame job is pending, a new frame must not be started.
+ */
+bool lcd_i2c_isBusy();
+
+/**
+ * @brief Checks if the previous frame was not sent completely.
+ *
+ * @return true if the frame job failed, the content of the panel is unknown.
+ */
+bool lcd_i2c_hasFrameFailed();
+
+/**
+ * @brief Starts a new frame, must not be called while lcd_i2c_isBusy() is true.
+ */
+void lcd_i2c_beginFrame();
+
+/**
+ * @brief Appends moving the cursor to the frame.
+ *
+ * @param column Column of the cursor.
+ * @param row Row of the cursor.
+ */
+void lcd_i2c_setCursor(uint8_t column, uint8_t row);
+
+/**
+ * @brief Appends one character at the cursor to the frame, the cursor advances by itself.
+ *
+ * @param character Character to be written.
+ */
+void lcd_i2c_write(char character);
+
+/**
+ * @brief Sends the frame to the panel as one background job.
+ *
+ * Does nothing if the frame is empty.
+ *
+ * @return true if the frame was queued or empty, false if the bus engine rejected it.
+ */
+bool lcd_i2c_endFrame();
+
+#endif
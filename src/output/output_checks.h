@@ -0,0 +1,15 @@
+#ifndef OUTPUT_CHECKS_H
+#define OUTPUT_CHECKS_H
+
+/**
+ * @file output_checks.h
+ * @brief Compile time checks shared by all output modules.
+ *
+ * MUST BE THE LAST INCLUDE of every output module source file. Output modules run on every
+ * update of the station, so they work only with fixed buffers. Arduino String allocates on the heap
+ * and fragments it over long uptimes, any use of it after this point is a compile error.
+ */
+
+#pragma GCC poison String
+
+#endif
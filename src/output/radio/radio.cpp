@@ -0,0 +1,280 @@
+#include "radio.h"
+#include "../output_checks.h"
+
+/* STATIC GLOBAL VARIABLES */
+static bool radio_ready = RADIO_NOT_READY;
+// Newest snapshot, scaled like the catalog entries
+static int32_t snapshot_values[SENSORS_SNAPSHOT_CAPACITY];
+static radio_values_bitset_t snapshot_valid;
+static bool snapshot_pending = RADIO_NO_SNAPSHOT_PENDING;
+// Values of the last transmitted packet, the differences of the next packet are taken to them
+static int32_t sent_values[SENSORS_SNAPSHOT_CAPACITY];
+static radio_values_bitset_t sent_valid;
+// Packet which is transmitted or waits for its retry, with the values it carries
+static uint8_t packet[RADIO_MAX_PACKET_SIZE];
+static uint8_t packet_len = 0u;
+static int32_t packet_values[SENSORS_SNAPSHOT_CAPACITY];
+static radio_values_bitset_t packet_valid;
+static bool packet_pending = RADIO_NO_PACKET_PENDING;
+static bool transmitting = RADIO_NOT_TRANSMITTING;
+static uint8_t tx_attempts = 0u;
+static uint32_t tx_started_millis = 0u;
+static uint32_t tx_airtime_ms = 0u;
+// Earliest start of the next transmission, set by the interval, the duty cycle and the retries
+static uint32_t next_tx_millis = 0u;
+static uint8_t sequence_number = 0u;
+static uint8_t packets_since_key_frame = RADIO_KEY_FRAME_INTERVAL;
+static uint16_t dropped_packets = RADIO_NO_DROPPED_PACKETS;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(RADIO_MAX_PACKET_SIZE <= SX1276_MAX_PAYLOAD, "Packet must fit the FIFO of the transceiver");
+static_assert(0u < RADIO_DUTY_CYCLE_PERMILLE && 1000u >= RADIO_DUTY_CYCLE_PERMILLE, "Duty cycle must be 1..1000 permille");
+static_assert(0u < RADIO_KEY_FRAME_INTERVAL, "Key frames must be sent");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Builds the packet from the newest snapshot, as key frame or delta frame.
+ */
+static void buildPacket();
+
+/**
+ * @brief Appends a value to the packet as zigzag encoded varint.
+ *
+ * @param value Value which is appended.
+ */
+static void appendVarint(int32_t value);
+
+/**
+ * @brief Starts the transmission of the pending packet.
+ *
+ * @param current_millis The current time in milliseconds.
+ */
+static void startTransmission(uint32_t current_millis);
+
+/**
+ * @brief Takes the values of the transmitted packet as the base of the next differences.
+ *
+ * @param current_millis The current time in milliseconds, the transmission ended at this time.
+ */
+static void finishTransmission(uint32_t current_millis);
+
+/**
+ * @brief Schedules the retry of a failed transmission or drops the packet.
+ *
+ * @param current_millis The current time in milliseconds.
+ */
+static void failTransmission(uint32_t current_millis);
+
+/**
+ * @brief Computes the earliest start of the next transmission after the duty cycle off time.
+ *
+ * @param current_millis End of the transmission in milliseconds.
+ * @return uint32_t Time in milliseconds before which nothing is sent.
+ */
+static uint32_t getDutyCycleEnd(uint32_t current_millis);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+control_error_code_te radio_init()
+{
+  transmitting = RADIO_NOT_TRANSMITTING;
+  if(!sx1276_init())
+  {
+    radio_ready = RADIO_NOT_READY;
+    return ERROR_CODE_INIT_FAILED;
+  }
+  radio_ready = RADIO_READY;
+  return ERROR_CODE_NO_ERROR;
+}
+
+control_error_code_te radio_displayData(const control_data_ts *data)
+{
+  if(INPUT_SENSORS_SNAPSHOT != data->input.io_component)
+  {
+    return ERROR_CODE_NO_ERROR; // Only complete snapshots are sent
+  }
+
+  const sensors_snapshot_ts *snapshot = data->input_return.sensors_snapshot;
+  uint8_t num_of_readings = (SENSORS_SNAPSHOT_CAPACITY < snapshot->num_of_readings) ? SENSORS_SNAPSHOT_CAPACITY : snapshot->num_of_readings;
+
+  memset(&snapshot_valid, 0, sizeof(snapshot_valid));
+  for (uint8_t sensor_index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; sensor_index < num_of_readings; sensor_index++)
+  {
+    const sensor_return_ts *entry = &(snapshot->readings[sensor_index]);
+    if(ERROR_CODE_NO_ERROR != entry->error_code)
+    {
+      continue; // Value is left out of the packet
+    }
+
+    int32_t value = entry->sensor_reading.indication ? 1 : 0;
+    if(SENSORS_MEASUREMENT_TYPE_VALUE == entry->sensor_reading.measurement_type_switch)
+    {
+      uint8_t num_of_decimals = sensors_interface_getNumOfDecimals(sensor_index);
+      value = sensor_value_toDecimals(entry->sensor_reading.value, num_of_decimals, num_of_decimals);
+    }
+    if(SENSOR_VALUE_SCALED_INVALID != value)
+    {
+      snapshot_values[sensor_index] = value;
+      bitset_set(&snapshot_valid, sensor_index);
+    }
+  }
+  snapshot_pending = RADIO_SNAPSHOT_PENDING;
+  return ERROR_CODE_NO_ERROR;
+}
+
+void radio_service(uint32_t current_millis)
+{
+  if(RADIO_READY != radio_ready)
+  {
+    return;
+  }
+
+  if(RADIO_TRANSMITTING == transmitting)
+  {
+    if(SX1276_TX_DONE == sx1276_isTransmitDone())
+    {
+      finishTransmission(current_millis);
+    }
+    else if((uint32_t)(current_millis - tx_started_millis) > tx_airtime_ms + RADIO_TX_TIMEOUT_MARGIN_MS)
+    {
+      failTransmission(current_millis);
+    }
+    return;
+  }
+
+  if(0 > (int32_t)(current_millis - next_tx_millis)) // Overflow safe compare
+  {
+    return; // Interval, duty cycle or retry delay not over yet
+  }
+
+  if(RADIO_PACKET_PENDING != packet_pending && RADIO_SNAPSHOT_PENDING == snapshot_pending)
+  {
+    buildPacket();
+  }
+  if(RADIO_PACKET_PENDING == packet_pending)
+  {
+    startTransmission(current_millis);
+  }
+}
+
+bool radio_isIdle()
+{
+  return RADIO_TRANSMITTING != transmitting;
+}
+
+uint16_t radio_getDroppedPackets()
+{
+  return dropped_packets;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void buildPacket()
+{
+  // Differences need a base for every value and a delta frame can not tell a lost value from an unchanged one,
+  // so a sensor which came back or failed is sent as a key frame
+  radio_values_bitset_t changed_values = snapshot_valid;
+  bitset_xor(&changed_values, &sent_valid);
+  bool key_frame = (RADIO_KEY_FRAME_INTERVAL <= packets_since_key_frame) || !bitset_isEmpty(&changed_values);
+
+  memcpy(packet_values, snapshot_values, sizeof(packet_values));
+  packet_valid = snapshot_valid;
+  snapshot_pending = RADIO_NO_SNAPSHOT_PENDING;
+
+  radio_values_bitset_t included = packet_valid;
+  for (uint8_t sensor_index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; sensor_index < SENSORS_SNAPSHOT_CAPACITY && !key_frame; sensor_index++)
+  {
+    if(bitset_test(&included, sensor_index) && packet_values[sensor_index] == sent_values[sensor_index])
+    {
+      bitset_clear(&included, sensor_index); // Unchanged values are left out of a delta frame
+    }
+  }
+
+  packet[RADIO_HEADER_STATION_ID] = RADIO_STATION_ID;
+  packet[RADIO_HEADER_SEQUENCE] = sequence_number;
+  packet[RADIO_HEADER_FRAME_TYPE] = key_frame ? RADIO_FRAME_KEY : RADIO_FRAME_DELTA;
+  memcpy(&packet[RADIO_HEADER_BITMAP], included.words, RADIO_BITMAP_SIZE);
+  packet_len = RADIO_HEADER_SIZE;
+
+  for (uint8_t sensor_index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; sensor_index < SENSORS_SNAPSHOT_CAPACITY; sensor_index++)
+  {
+    if(bitset_test(&included, sensor_index))
+    {
+      // Differences of the scaled values stay small, most of them fit one byte
+      appendVarint(key_frame ? packet_values[sensor_index] : (int32_t)((uint32_t)packet_values[sensor_index] - (uint32_t)sent_values[sensor_index]));
+    }
+  }
+
+  packet_pending = RADIO_PACKET_PENDING;
+  tx_attempts = 0u;
+}
+
+static void appendVarint(int32_t value)
+{
+  uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); // Small negative values stay small
+
+  do
+  {
+    uint8_t byte = (uint8_t)(zigzag & RADIO_VARINT_VALUE_MASK);
+    zigzag >>= RADIO_VARINT_VALUE_BITS;
+    packet[packet_len++] = (0u != zigzag) ? (uint8_t)(byte | RADIO_VARINT_CONTINUE) : byte;
+  } while(0u != zigzag);
+}
+
+static void startTransmission(uint32_t current_millis)
+{
+  tx_attempts++;
+  tx_airtime_ms = sx1276_getAirtimeMs(packet_len);
+  tx_started_millis = current_millis;
+  sx1276_startTransmit(packet, packet_len);
+  transmitting = RADIO_TRANSMITTING;
+}
+
+static void finishTransmission(uint32_t current_millis)
+{
+  sx1276_sleep();
+  transmitting = RADIO_NOT_TRANSMITTING;
+  packet_pending = RADIO_NO_PACKET_PENDING;
+
+  // Receiver applies the differences of the next packet to exactly these values
+  memcpy(sent_values, packet_values, sizeof(sent_values));
+  sent_valid = packet_valid;
+  packets_since_key_frame = (RADIO_FRAME_KEY == packet[RADIO_HEADER_FRAME_TYPE]) ? 1u : (uint8_t)(packets_since_key_frame + 1u);
+  sequence_number++;
+
+  uint32_t next_interval = tx_started_millis + RADIO_TX_INTERVAL_MS;
+  uint32_t duty_cycle_end = getDutyCycleEnd(current_millis);
+  next_tx_millis = (0 < (int32_t)(duty_cycle_end - next_interval)) ? duty_cycle_end : next_interval;
+}
+
+static void failTransmission(uint32_t current_millis)
+{
+  sx1276_sleep();
+  transmitting = RADIO_NOT_TRANSMITTING;
+
+  // Airtime may have been used, the duty cycle is kept for the retry as well
+  uint32_t retry_millis = current_millis + (RADIO_RETRY_DELAY_MS << (tx_attempts - 1u));
+  uint32_t duty_cycle_end = getDutyCycleEnd(current_millis);
+  next_tx_millis = (0 < (int32_t)(duty_cycle_end - retry_millis)) ? duty_cycle_end : retry_millis;
+
+  if(RADIO_MAX_TX_ATTEMPTS <= tx_attempts)
+  {
+    // Packet may have reached the air without the end being reported, the next packet is sent absolute
+    packet_pending = RADIO_NO_PACKET_PENDING;
+    packets_since_key_frame = RADIO_KEY_FRAME_INTERVAL;
+    sequence_number++;
+    if(UINT16_MAX != dropped_packets)
+    {
+      dropped_packets++;
+    }
+  }
+}
+
+static uint32_t getDutyCycleEnd(uint32_t current_millis)
+{
+  // Off time is the airtime times (1 / duty cycle - 1)
+  return current_millis + (tx_airtime_ms * (1000u - RADIO_DUTY_CYCLE_PERMILLE)) / RADIO_DUTY_CYCLE_PERMILLE;
+}
+/* *************************************** */
@@ -0,0 +1,122 @@
+#ifndef RADIO_H
+#define RADIO_H
+
+#include <Arduino.h>
+#include "radio_config.h"
+#include "sx1276.h"
+#include "../../control/control_types.h"
+#include "../../bitset/bitset.h"
+
+/**
+ * @file radio.h
+ * @brief LoRa uplink of the sensors snapshots, one packet per interval.
+ *
+ * The sink only keeps the newest snapshot, the packet is built and sent by radio_service() when the
+ * interval and the duty cycle allow it. Values are sent as the differences to the values of the last
+ * transmitted packet, only values which changed are in the packet, so a quiet station sends little
+ * more than the header. Every RADIO_KEY_FRAME_INTERVAL packets (and whenever a sensor comes back or fails)
+ * the values are sent absolute, so a receiver which missed packets is in sync again.
+ *
+ * Packet layout:
+ *  - header: station ID, sequence number (u8), frame type (RADIO_FRAME_KEY or RADIO_FRAME_DELTA),
+ *            bitmap of the values in the packet (bit per catalog index, RADIO_BITMAP_SIZE bytes, LSB first)
+ *  - values: for every set bit in catalog order, the value (key frame) or the difference to the
+ *            last transmitted value (delta frame) with the decimals of the catalog entry, zigzag
+ *            encoded as a varint (7 bits per byte, LSB first, bit 7 set if another byte follows).
+ *            Indications are sent as 0 or 1.
+ * In a delta frame the missing values are unchanged, a key frame has every valid value and only the
+ * values of the last key frame are valid until the next one. A gap in the sequence numbers tells the
+ * receiver that the differences up to the next key frame can not be applied, a repeated sequence
+ * number is a retry of a packet which was already received.
+ *
+ * A transmission which does not finish within its airtime is retried in the background with a
+ * doubled delay, after RADIO_MAX_TX_ATTEMPTS the packet is dropped and the next one is a key frame.
+ */
+
+/* Header: station ID, sequence number, frame type and the bitmap of the values */
+#define RADIO_BITMAP_SIZE             (uint8_t)(BITSET_NUM_OF_WORDS(SENSORS_SNAPSHOT_CAPACITY))
+#define RADIO_HEADER_STATION_ID       (uint8_t)(0u)
+#define RADIO_HEADER_SEQUENCE         (uint8_t)(1u)
+#define RADIO_HEADER_FRAME_TYPE       (uint8_t)(2u)
+#define RADIO_HEADER_BITMAP           (uint8_t)(3u)
+#define RADIO_HEADER_SIZE             (uint8_t)(RADIO_HEADER_BITMAP + RADIO_BITMAP_SIZE)
+/* Longest varint of a zigzag encoded 32-bit value */
+#define RADIO_VARINT_MAX_SIZE         (uint8_t)(5u)
+#define RADIO_VARINT_VALUE_BITS       (uint8_t)(7u)
+#define RADIO_VARINT_VALUE_MASK       (uint8_t)(0x7Fu)
+#define RADIO_VARINT_CONTINUE         (uint8_t)(0x80u)
+/* Longest packet, every value with the longest varint */
+#define RADIO_MAX_PACKET_SIZE         (uint8_t)(RADIO_HEADER_SIZE + SENSORS_SNAPSHOT_CAPACITY * RADIO_VARINT_MAX_SIZE)
+
+/* Bit per catalog index of the values which are valid or in a packet */
+typedef bitset_ts<SENSORS_SNAPSHOT_CAPACITY> radio_values_bitset_t;
+
+/* Frame types */
+#define RADIO_FRAME_KEY               (uint8_t)(0x01u)
+#define RADIO_FRAME_DELTA             (uint8_t)(0x02u)
+
+/* Time after the airtime in which the transceiver must report the end of the transmission */
+#define RADIO_TX_TIMEOUT_MARGIN_MS    (uint32_t)(100u)
+/* Transmissions of the same packet, the delay before a retry starts here and doubles */
+#define RADIO_MAX_TX_ATTEMPTS         (uint8_t)(3u)
+#define RADIO_RETRY_DELAY_MS          (uint32_t)(2000u)
+
+/* Flags of the state of the uplink */
+#define RADIO_READY                   (bool)(true)
+#define RADIO_NOT_READY               (bool)(false)
+#define RADIO_TRANSMITTING            (bool)(true)
+#define RADIO_NOT_TRANSMITTING        (bool)(false)
+#define RADIO_PACKET_PENDING          (bool)(true)
+#define RADIO_NO_PACKET_PENDING       (bool)(false)
+#define RADIO_SNAPSHOT_PENDING        (bool)(true)
+#define RADIO_NO_SNAPSHOT_PENDING     (bool)(false)
+
+/* Value of the dropped packets counter when nothing was dropped */
+#define RADIO_NO_DROPPED_PACKETS      (uint16_t)(0u)
+
+/**
+ * @brief Initializes the transceiver, blocks for its reset (about 5 ms).
+ *
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Transceiver is configured and sleeps until the first packet.
+ * - ERROR_CODE_INIT_FAILED: Transceiver did not answer.
+ */
+control_error_code_te radio_init();
+
+/**
+ * @brief Keeps the newest sensors snapshot for the next packet.
+ *
+ * Only snapshots are sent, single readings and other inputs are not part of the uplink.
+ * Nothing is sent here, so the sink never waits for the radio.
+ *
+ * @param data Pointer to data structure containing the input type and associated readings.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Snapshot was kept or the data is not part of the uplink.
+ */
+control_error_code_te radio_displayData(const control_data_ts *data);
+
+/**
+ * @brief Sends the packets and supervises the transmissions.
+ *
+ * NEEDS TO BE CALLED IN A LOOP. Builds a packet from the newest snapshot when the interval and the
+ * duty cycle allow it, polls the end of the transmission and schedules the retries of failed ones.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void radio_service(uint32_t current_millis);
+
+/**
+ * @brief Checks if the uplink neither transmits nor waits for a transmission.
+ *
+ * @return true if no transmission is running, the SPI and millis() may be stopped.
+ */
+bool radio_isIdle();
+
+/**
+ * @brief Returns the number of packets dropped since boot because every transmission failed.
+ *
+ * @return uint16_t Number of dropped packets, saturates at UINT16_MAX.
+ */
+uint16_t radio_getDroppedPackets();
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef RADIO_CONFIG_H
+#define RADIO_CONFIG_H
+
+#include <Arduino.h>
+
+/* Pins of the SX1276 / RFM95W module, the SPI lines are the hardware SPI pins of the board (the gateway runs on a Mega 2560) */
+#ifdef __AVR_ATmega2560__
+#define RADIO_PIN_NSS                 (uint8_t)(53u)
+#define RADIO_PIN_MOSI                (uint8_t)(51u)
+#define RADIO_PIN_SCK                 (uint8_t)(52u)
+#else
+#define RADIO_PIN_NSS                 (uint8_t)(10u)
+#define RADIO_PIN_MOSI                (uint8_t)(11u)
+#define RADIO_PIN_SCK                 (uint8_t)(13u)
+#endif
+#define RADIO_PIN_RESET               (uint8_t)(8u)
+
+/* LoRa channel (EU868 g1 sub-band, 1% duty cycle) */
+#define RADIO_FREQUENCY_HZ            (uint32_t)(868100000u)
+#define RADIO_SPREADING_FACTOR        (uint8_t)(9u)      /* 7..12 */
+#define RADIO_BANDWIDTH_HZ            (uint32_t)(125000u) /* 125000, 250000 or 500000 */
+#define RADIO_CODING_RATE             (uint8_t)(1u)      /* 1..4 for 4/5..4/8 */
+#define RADIO_PREAMBLE_LENGTH         (uint16_t)(8u)
+#define RADIO_SYNC_WORD               (uint8_t)(0x12u)   /* Private network, 0x34 is used by LoRaWAN */
+#define RADIO_TX_POWER_DBM            (uint8_t)(14u)     /* 2..17 dBm on PA_BOOST, 14 dBm is the EU868 limit */
+
+/* Share of the time the station may transmit, in permille of the time (10 = 1%) */
+#define RADIO_DUTY_CYCLE_PERMILLE     (uint16_t)(10u)
+/* Shortest time between two packets, a packet carries the newest snapshot */
+#define RADIO_TX_INTERVAL_MS          (uint32_t)(60000u)
+/* Every this many packets the values are sent absolute instead of as differences */
+#define RADIO_KEY_FRAME_INTERVAL      (uint8_t)(10u)
+
+/* ID of the station in every packet, lets the receiver tell several stations apart */
+#define RADIO_STATION_ID              (uint8_t)(1u)
+
+#endif
@@ -0,0 +1,194 @@
+#include "sx1276.h"
+
+/* COMPILE TIME CHECKS */
+static_assert(7u <= RADIO_SPREADING_FACTOR && 12u >= RADIO_SPREADING_FACTOR, "LoRa spreading factor must be 7..12");
+static_assert(125000u == RADIO_BANDWIDTH_HZ || 250000u == RADIO_BANDWIDTH_HZ || 500000u == RADIO_BANDWIDTH_HZ, "Only the 125, 250 and 500 kHz bandwidths are supported");
+static_assert(1u <= RADIO_CODING_RATE && 4u >= RADIO_CODING_RATE, "LoRa coding rate must be 1..4 (4/5..4/8)");
+static_assert(SX1276_PA_MIN_POWER_DBM <= RADIO_TX_POWER_DBM && SX1276_PA_MAX_POWER_DBM >= RADIO_TX_POWER_DBM, "PA_BOOST power must be 2..17 dBm");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Exchanges one byte on the SPI and waits for it.
+ *
+ * @param value Byte which is sent.
+ * @return uint8_t Byte which was received.
+ */
+static uint8_t transferByte(uint8_t value);
+
+/**
+ * @brief Writes one register of the transceiver.
+ *
+ * @param address Address of the register.
+ * @param value Value to be written.
+ */
+static void writeRegister(uint8_t address, uint8_t value);
+
+/**
+ * @brief Reads one register of the transceiver.
+ *
+ * @param address Address of the register.
+ * @return uint8_t Value of the register.
+ */
+static uint8_t readRegister(uint8_t address);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+bool sx1276_init()
+{
+  // SPI master, mode 0, MSB first, F_CPU / 4. SS must be an output, otherwise the SPI falls back to slave
+  digitalWrite(RADIO_PIN_NSS, HIGH);
+  pinMode(RADIO_PIN_NSS, OUTPUT);
+  pinMode(RADIO_PIN_MOSI, OUTPUT);
+  pinMode(RADIO_PIN_SCK, OUTPUT);
+  SPCR = (uint8_t)(_BV(SPE) | _BV(MSTR));
+  SPSR = 0u;
+
+  pinMode(RADIO_PIN_RESET, OUTPUT);
+  digitalWrite(RADIO_PIN_RESET, LOW);
+  delayMicroseconds(SX1276_RESET_PULSE_US);
+  pinMode(RADIO_PIN_RESET, INPUT); // Reset pin of the module must float after the pulse
+  delay(SX1276_RESET_DELAY_MS);
+
+  if(SX1276_VERSION != readRegister(SX1276_REG_VERSION))
+  {
+    return false; // No transceiver or no answer on the SPI
+  }
+
+  writeRegister(SX1276_REG_OP_MODE, SX1276_MODE_SLEEP);
+  writeRegister(SX1276_REG_OP_MODE, (uint8_t)(SX1276_MODE_LONG_RANGE | SX1276_MODE_SLEEP));
+
+  uint32_t frf = SX1276_FRF(RADIO_FREQUENCY_HZ);
+  writeRegister(SX1276_REG_FRF_MSB, (uint8_t)(frf >> 16));
+  writeRegister(SX1276_REG_FRF_MID, (uint8_t)(frf >> 8));
+  writeRegister(SX1276_REG_FRF_LSB, (uint8_t)frf);
+
+  // Explicit header with CRC, the receiver drops damaged packets
+  writeRegister(SX1276_REG_MODEM_CONFIG_1, (uint8_t)(SX1276_BANDWIDTH_BITS(RADIO_BANDWIDTH_HZ) | (RADIO_CODING_RATE << SX1276_CODING_RATE_SHIFT)));
+  writeRegister(SX1276_REG_MODEM_CONFIG_2, (uint8_t)((RADIO_SPREADING_FACTOR << SX1276_SPREADING_FACTOR_SHIFT) | SX1276_RX_PAYLOAD_CRC_ON));
+  writeRegister(SX1276_REG_MODEM_CONFIG_3, (uint8_t)(SX1276_AGC_AUTO_ON | ((SX1276_LOW_DATA_RATE_SYMBOL_US < SX1276_SYMBOL_US) ? SX1276_LOW_DATA_RATE_OPTIMIZE : 0u)));
+  writeRegister(SX1276_REG_PREAMBLE_MSB, (uint8_t)(RADIO_PREAMBLE_LENGTH >> 8));
+  writeRegister(SX1276_REG_PREAMBLE_LSB, (uint8_t)RADIO_PREAMBLE_LENGTH);
+  writeRegister(SX1276_REG_SYNC_WORD, RADIO_SYNC_WORD);
+  writeRegister(SX1276_REG_PA_CONFIG, (uint8_t)(SX1276_PA_BOOST | (RADIO_TX_POWER_DBM - SX1276_PA_MIN_POWER_DBM)));
+  writeRegister(SX1276_REG_FIFO_TX_BASE_ADDR, SX1276_FIFO_TX_BASE);
+  writeRegister(SX1276_REG_FIFO_RX_BASE_ADDR, SX1276_FIFO_RX_BASE);
+  return true;
+}
+
+void sx1276_startTransmit(const uint8_t *payload, uint8_t payload_len)
+{
+  writeRegister(SX1276_REG_OP_MODE, (uint8_t)(SX1276_MODE_LONG_RANGE | SX1276_MODE_STANDBY)); // FIFO is only accessible outside of sleep
+  writeRegister(SX1276_REG_FIFO_ADDR_PTR, SX1276_FIFO_TX_BASE);
+
+  digitalWrite(RADIO_PIN_NSS, LOW);
+  (void)transferByte((uint8_t)(SX1276_REG_FIFO | SX1276_SPI_WRITE)); // Burst write, the FIFO pointer advances by itself
+  for (uint8_t i = 0u; i < payload_len; i++)
+  {
+    (void)transferByte(payload[i]);
+  }
+  digitalWrite(RADIO_PIN_NSS, HIGH);
+
+  writeRegister(SX1276_REG_PAYLOAD_LENGTH, payload_len);
+  writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+  writeRegister(SX1276_REG_OP_MODE, (uint8_t)(SX1276_MODE_LONG_RANGE | SX1276_MODE_TX));
+}
+
+bool sx1276_isTransmitDone()
+{
+  if(0u == (readRegister(SX1276_REG_IRQ_FLAGS) & SX1276_IRQ_TX_DONE))
+  {
+    return SX1276_TX_BUSY;
+  }
+  writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_TX_DONE);
+  return SX1276_TX_DONE;
+}
+
+void sx1276_startReceive()
+{
+  writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+  writeRegister(SX1276_REG_OP_MODE, (uint8_t)(SX1276_MODE_LONG_RANGE | SX1276_MODE_RX_CONTINUOUS));
+}
+
+bool sx1276_readPacket(uint8_t *payload, uint8_t payload_size, uint8_t *payload_len)
+{
+  uint8_t irq_flags = readRegister(SX1276_REG_IRQ_FLAGS);
+  if(0u == (irq_flags & SX1276_IRQ_RX_DONE))
+  {
+    return SX1276_NO_PACKET;
+  }
+  writeRegister(SX1276_REG_IRQ_FLAGS, (uint8_t)(SX1276_IRQ_RX_DONE | SX1276_IRQ_PAYLOAD_CRC_ERROR));
+
+  uint8_t received_len = readRegister(SX1276_REG_RX_NB_BYTES);
+  if(0u != (irq_flags & SX1276_IRQ_PAYLOAD_CRC_ERROR) || received_len > payload_size)
+  {
+    *payload_len = SX1276_PACKET_DROPPED_LEN;
+    return SX1276_PACKET_RECEIVED;
+  }
+
+  // Reception continues while the FIFO is read, the next packet is written behind this one
+  writeRegister(SX1276_REG_FIFO_ADDR_PTR, readRegister(SX1276_REG_FIFO_RX_CURRENT));
+  digitalWrite(RADIO_PIN_NSS, LOW);
+  (void)transferByte((uint8_t)(SX1276_REG_FIFO & (uint8_t)~SX1276_SPI_WRITE)); // Burst read
+  for (uint8_t i = 0u; i < received_len; i++)
+  {
+    payload[i] = transferByte(0u);
+  }
+  digitalWrite(RADIO_PIN_NSS, HIGH);
+
+  *payload_len = received_len;
+  return SX1276_PACKET_RECEIVED;
+}
+
+void sx1276_sleep()
+{
+  writeRegister(SX1276_REG_OP_MODE, (uint8_t)(SX1276_MODE_LONG_RANGE | SX1276_MODE_SLEEP));
+}
+
+uint32_t sx1276_getAirtimeMs(uint8_t payload_len)
+{
+  // Payload symbols: 8 + max(ceil((8 PL - 4 SF + 28 + 16 CRC) / (4 (SF - 2 DE))) * (CR + 4), 0), explicit header
+  uint8_t low_data_rate = (SX1276_LOW_DATA_RATE_SYMBOL_US < SX1276_SYMBOL_US) ? 1u : 0u;
+  int16_t numerator = (int16_t)(8 * (int16_t)payload_len - 4 * (int16_t)RADIO_SPREADING_FACTOR + 28 + 16);
+  int16_t denominator = (int16_t)(4 * ((int16_t)RADIO_SPREADING_FACTOR - 2 * (int16_t)low_data_rate));
+  uint32_t payload_symbols = 8u;
+  if(0 < numerator)
+  {
+    payload_symbols += (uint32_t)((numerator + denominator - 1) / denominator) * (RADIO_CODING_RATE + 4u);
+  }
+
+  // Preamble takes 4.25 symbols more than its length
+  uint32_t preamble_us = ((4u * (uint32_t)RADIO_PREAMBLE_LENGTH + 17u) * SX1276_SYMBOL_US) / 4u;
+  uint32_t airtime_us = preamble_us + payload_symbols * SX1276_SYMBOL_US;
+  return (airtime_us + 999u) / 1000u;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t transferByte(uint8_t value)
+{
+  SPDR = value;
+  while(!(SPSR & _BV(SPIF)))
+  {
+    // 2 us per byte at F_CPU / 4
+  }
+  return SPDR;
+}
+
+static void writeRegister(uint8_t address, uint8_t value)
+{
+  digitalWrite(RADIO_PIN_NSS, LOW);
+  (void)transferByte((uint8_t)(address | SX1276_SPI_WRITE));
+  (void)transferByte(value);
+  digitalWrite(RADIO_PIN_NSS, HIGH);
+}
+
+static uint8_t readRegister(uint8_t address)
+{
+  digitalWrite(RADIO_PIN_NSS, LOW);
+  (void)transferByte((uint8_t)(address & (uint8_t)~SX1276_SPI_WRITE));
+  uint8_t value = transferByte(0u);
+  digitalWrite(RADIO_PIN_NSS, HIGH);
+  return value;
+}
+/* *************************************** */
@@ -0,0 +1,157 @@
+#ifndef SX1276_H
+#define SX1276_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include "radio_config.h"
+
+/**
+ * @file sx1276.h
+ * @brief SX1276 LoRa transceiver (e.g., RFM95W) on the hardware SPI.
+ *
+ * Register accesses take a few microseconds at 4 MHz, so they are done directly. The transmission
+ * itself runs in the transceiver, it is started by sx1276_startTransmit() and polled by
+ * sx1276_isTransmitDone(), the MCU never waits for the airtime. A station only transmits, the
+ * gateway (see gateway.h) only receives.
+ */
+
+/* Registers of the LoRa mode */
+#define SX1276_REG_FIFO               (uint8_t)(0x00u)
+#define SX1276_REG_OP_MODE            (uint8_t)(0x01u)
+#define SX1276_REG_FRF_MSB            (uint8_t)(0x06u)
+#define SX1276_REG_FRF_MID            (uint8_t)(0x07u)
+#define SX1276_REG_FRF_LSB            (uint8_t)(0x08u)
+#define SX1276_REG_PA_CONFIG          (uint8_t)(0x09u)
+#define SX1276_REG_FIFO_ADDR_PTR      (uint8_t)(0x0Du)
+#define SX1276_REG_FIFO_TX_BASE_ADDR  (uint8_t)(0x0Eu)
+#define SX1276_REG_FIFO_RX_BASE_ADDR  (uint8_t)(0x0Fu)
+#define SX1276_REG_FIFO_RX_CURRENT    (uint8_t)(0x10u)
+#define SX1276_REG_IRQ_FLAGS          (uint8_t)(0x12u)
+#define SX1276_REG_RX_NB_BYTES        (uint8_t)(0x13u)
+#define SX1276_REG_MODEM_CONFIG_1     (uint8_t)(0x1Du)
+#define SX1276_REG_MODEM_CONFIG_2     (uint8_t)(0x1Eu)
+#define SX1276_REG_PREAMBLE_MSB       (uint8_t)(0x20u)
+#define SX1276_REG_PREAMBLE_LSB       (uint8_t)(0x21u)
+#define SX1276_REG_PAYLOAD_LENGTH     (uint8_t)(0x22u)
+#define SX1276_REG_MODEM_CONFIG_3     (uint8_t)(0x26u)
+#define SX1276_REG_SYNC_WORD          (uint8_t)(0x39u)
+#define SX1276_REG_VERSION            (uint8_t)(0x42u)
+
+/* Value of the version register of the SX1276/77/78/79 */
+#define SX1276_VERSION                (uint8_t)(0x12u)
+
+/* Bit of the register address which selects a write access */
+#define SX1276_SPI_WRITE              (uint8_t)(0x80u)
+
+/* Operating modes, the LoRa bit can only be changed in sleep */
+#define SX1276_MODE_LONG_RANGE        (uint8_t)(0x80u)
+#define SX1276_MODE_SLEEP             (uint8_t)(0x00u)
+#define SX1276_MODE_STANDBY           (uint8_t)(0x01u)
+#define SX1276_MODE_TX                (uint8_t)(0x03u)
+#define SX1276_MODE_RX_CONTINUOUS     (uint8_t)(0x05u)
+
+/* Interrupt flags, written with 1 to clear */
+#define SX1276_IRQ_RX_DONE            (uint8_t)(0x40u)
+#define SX1276_IRQ_PAYLOAD_CRC_ERROR  (uint8_t)(0x20u)
+#define SX1276_IRQ_TX_DONE            (uint8_t)(0x08u)
+#define SX1276_IRQ_ALL                (uint8_t)(0xFFu)
+
+/* PA_BOOST output, the power is 2 dBm plus the lower four bits */
+#define SX1276_PA_BOOST               (uint8_t)(0x80u)
+#define SX1276_PA_MIN_POWER_DBM       (uint8_t)(2u)
+#define SX1276_PA_MAX_POWER_DBM       (uint8_t)(17u)
+
+/* Fields of the modem configuration */
+#define SX1276_BANDWIDTH_BITS(bandwidth_hz) (uint8_t)((125000u == (bandwidth_hz)) ? 0x70u : (250000u == (bandwidth_hz)) ? 0x80u : 0x90u)
+#define SX1276_CODING_RATE_SHIFT      (uint8_t)(1u)
+#define SX1276_SPREADING_FACTOR_SHIFT (uint8_t)(4u)
+#define SX1276_RX_PAYLOAD_CRC_ON      (uint8_t)(0x04u)
+#define SX1276_LOW_DATA_RATE_OPTIMIZE (uint8_t)(0x08u)
+#define SX1276_AGC_AUTO_ON            (uint8_t)(0x04u)
+
+/* FIFO of 256 bytes, the whole FIFO is used for the transmission or the reception */
+#define SX1276_FIFO_TX_BASE           (uint8_t)(0x00u)
+#define SX1276_FIFO_RX_BASE           (uint8_t)(0x00u)
+#define SX1276_MAX_PAYLOAD            (uint8_t)(255u)
+
+/* Carrier frequency register, frequency * 2^19 / 32 MHz */
+#define SX1276_CRYSTAL_HZ             (uint32_t)(32000000u)
+#define SX1276_FRF(frequency_hz)      (uint32_t)(((uint64_t)(frequency_hz) << 19) / SX1276_CRYSTAL_HZ)
+
+/* Symbols longer than this need the low data rate optimization (datasheet) */
+#define SX1276_LOW_DATA_RATE_SYMBOL_US (uint32_t)(16000u)
+/* Length of one symbol in microseconds */
+#define SX1276_SYMBOL_US              (uint32_t)((((uint32_t)1u << RADIO_SPREADING_FACTOR) * 1000000u) / RADIO_BANDWIDTH_HZ)
+
+/* Reset pulse and start-up of the oscillator after the reset (datasheet) */
+#define SX1276_RESET_PULSE_US         (uint16_t)(100u)
+#define SX1276_RESET_DELAY_MS         (uint8_t)(5u)
+
+/* Flags returned by sx1276_isTransmitDone() */
+#define SX1276_TX_DONE                (bool)(true)
+#define SX1276_TX_BUSY                (bool)(false)
+
+/* Flags returned by sx1276_readPacket() */
+#define SX1276_PACKET_RECEIVED        (bool)(true)
+#define SX1276_NO_PACKET              (bool)(false)
+/* Length of a received packet which was damaged or did not fit the buffer */
+#define SX1276_PACKET_DROPPED_LEN     (uint8_t)(0u)
+
+/**
+ * @brief Resets the transceiver, checks its version and configures the LoRa channel of radio_config.h.
+ *
+ * Blocks for the reset of the transceiver (about 5 ms), only for initialization code.
+ * The transceiver is left in sleep.
+ *
+ * @return true if the transceiver answered with the expected version, false otherwise.
+ */
+bool sx1276_init();
+
+/**
+ * @brief Writes a packet into the FIFO and starts its transmission.
+ *
+ * @param payload Bytes of the packet.
+ * @param payload_len Number of bytes, at most SX1276_MAX_PAYLOAD.
+ */
+void sx1276_startTransmit(const uint8_t *payload, uint8_t payload_len);
+
+/**
+ * @brief Checks if the transmission started by sx1276_startTransmit() is finished.
+ *
+ * @return true (SX1276_TX_DONE) if the packet was sent, the transceiver is back in standby.
+ */
+bool sx1276_isTransmitDone();
+
+/**
+ * @brief Starts the continuous reception, the transceiver receives until it is put to sleep.
+ */
+void sx1276_startReceive();
+
+/**
+ * @brief Reads the packet received since the last call.
+ *
+ * Only the latest packet is kept by the transceiver, the call must come before the next packet
+ * ends (at least the airtime of the shortest packet, tens of milliseconds with the usual channels).
+ *
+ * @param payload Buffer for the packet.
+ * @param payload_size Size of the buffer.
+ * @param payload_len Receives the number of bytes, SX1276_PACKET_DROPPED_LEN if the CRC failed or the
+ *        packet does not fit the buffer.
+ * @return true (SX1276_PACKET_RECEIVED) if a packet arrived, false (SX1276_NO_PACKET) otherwise.
+ */
+bool sx1276_readPacket(uint8_t *payload, uint8_t payload_size, uint8_t *payload_len);
+
+/**
+ * @brief Puts the transceiver to sleep, a running transmission or reception is aborted.
+ */
+void sx1276_sleep();
+
+/**
+ * @brief Computes the time on air of a packet with the LoRa channel of radio_config.h (datasheet formula).
+ *
+ * @param payload_len Number of bytes of the packet.
+ * @return uint32_t Time on air in milliseconds, rounded up.
+ */
+uint32_t sx1276_getAirtimeMs(uint8_t payload_len);
+
+#endif
@@ -1,20 +1,114 @@
 #include "serial_console.h"
+#include "../output_checks.h"
+
+/* STATIC GLOBAL VARIABLES */
+// Transmit ring, indexes are free running and masked on access
+static char tx_ring[SERIAL_CONSOLE_TX_RING_SIZE];
+static uint16_t tx_head = 0u;
+static uint16_t tx_tail = 0u;
+// Lines dropped since the last notice, reported together once there is room again
+static uint16_t dropped_lines = SERIAL_CONSOLE_NO_DROPPED_LINES;
+// Frame being received from the host, collected until the delimiter
+static uint8_t rx_frame[SERIAL_CONSOLE_RX_FRAME_SIZE];
+static uint8_t rx_len = 0u;
+static bool rx_overflow = SERIAL_CONSOLE_RX_NO_OVERFLOW;
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(0u == (SERIAL_CONSOLE_TX_RING_SIZE & SERIAL_CONSOLE_TX_RING_MASK), "Serial console transmit ring size must be a power of two");
+static_assert(SERIAL_CONSOLE_TX_RING_SIZE >= SERIAL_CONSOLE_STRING_RESERVED_GIANT + SERIAL_CONSOLE_LINE_ENDING_LEN,
+              "Serial console transmit ring must hold the longest line");
+static_assert(SERIAL_CONSOLE_TX_RING_SIZE >= SERIAL_FRAME_ENCODED_SIZE(SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD),
+              "Serial console transmit ring must hold the longest queued frame");
+/* *************************************** */
 
 /* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Queues one line for transmission without waiting for the UART.
+ *
+ * The line is queued whole or not at all. If it does not fit, it is dropped and counted,
+ * and a single notice with the number of dropped lines is queued before the next line that fits.
+ *
+ * @param line Null terminated line, line ending is appended.
+ */
+static void txWriteLine(const char *line);
+
+/**
+ * @brief Copies a line with line ending into the transmit ring if there is room for all of it.
+ *
+ * @param line Null terminated line.
+ * @return true if the line was queued, false if there was not enough room.
+ */
+static bool txPushLine(const char *line);
+
+/**
+ * @brief Copies bytes into the transmit ring if there is room for all of them.
+ *
+ * @param data Bytes to queue.
+ * @param len Number of bytes.
+ * @return true if the bytes were queued, false if there was not enough room.
+ */
+static bool txPushBytes(const uint8_t *data, size_t len);
+
+/**
+ * @brief COBS encodes a payload and queues the frame whole or drops it.
+ *
+ * Dropped frames are only counted, a text notice would corrupt the binary stream.
+ *
+ * @param payload Payload buffer with SERIAL_FRAME_CRC_SIZE free bytes after payload_len.
+ * @param payload_len Number of payload bytes.
+ */
+static void txWriteFrame(uint8_t *payload, size_t payload_len);
+
+/**
+ * @brief Sends data as a binary frame, used in SERIAL_CONSOLE_OUTPUT_MODE_BINARY.
+ *
+ * @param data Pointer to data structure containing the input type and associated readings.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Frame queued, dropped because the ring was full, or data is not part of the telemetry.
+ * - ERROR_CODE_INVALID_INPUT_TYPE: Invalid input type specified.
+ */
+static control_error_code_te serial_console_sendFrame(const control_data_ts *data);
+
+/**
+ * @brief Converts a sensor reading to the fixed-point value of the binary frames.
+ *
+ * @param sensor_data Pointer to sensor reading.
+ * @param sensor_id ID of the sensor the reading belongs to, its number of decimals is needed for scaling.
+ * @return int32_t Value with SERIAL_CONSOLE_FRAME_VALUE_DECIMALS decimals, 0/1 for indications
+ *         or SERIAL_CONSOLE_FRAME_INVALID_VALUE.
+ */
+static int32_t toFrameValue(const sensor_reading_ts *sensor_data, uint8_t sensor_id);
+
 /**
  * @brief Displays sensor measurements on the serial console.
  *
  * This function retrieves sensor metadata and formats the sensor readings
  * for display on the serial console, including the sensor type, value, and unit.
  *
- * @param control_data_ts Pointer to data containing sensor reading with value, and measurement type switch and sensor ID.
+ * @param sensor_data Pointer to sensor reading with value/indication and measurement type switch.
+ * @param sensor_id ID of the sensor the reading belongs to.
  * @return control_error_code_te
  * - ERROR_CODE_NO_ERROR: Sensor data displayed successfully.
  * - ERROR_CODE_SENSOR_NOT_CONFIGURED: Sensor metadata retrieval failed.
  * - ERROR_CODE_INVALID_SENSOR_MEASUREMENT_TYPE: Invalid measurement type.
  */
-static control_error_code_te serial_console_displaySensorMeasurement(const control_data_ts *data);
+static control_error_code_te serial_console_displaySensorMeasurement(const sensor_reading_ts *sensor_data, uint8_t sensor_id);
+
+/**
+ * @brief Displays all readings of a sensors snapshot on the serial console as one record.
+ *
+ * Prints the timestamp of the sweep followed by every successful reading.
+ * Readings which failed are skipped, their errors are handled by the sender.
+ *
+ * @param control_data_ts Pointer to data containing pointer to the sensors snapshot.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Snapshot displayed successfully.
+ * - Error code of the first reading which could not be displayed otherwise.
+ */
+static control_error_code_te serial_console_displaySensorsSnapshot(const control_data_ts *data);
 
+#ifdef RTC_COMPONENT
 /**
  * @brief Displays the current RTC time on the serial console.
  *
@@ -26,6 +120,7 @@ static control_error_code_te serial_console_displaySensorMeasurement(const contr
  * - ERROR_CODE_NO_ERROR: Time data displayed successfully.
  */
 static control_error_code_te serial_console_displayTime(const control_data_ts *data);
+#endif
 
 /**
  * @brief Displays I2C scan results on the serial console.
@@ -39,6 +134,15 @@ static control_error_code_te serial_console_displayTime(const control_data_ts *d
  * - ERROR_CODE_UNKNOWN_I2C_DEVICE_STATUS: Unknown device status during communication.
  */
 static control_error_code_te serial_console_displayI2cScan(const control_data_ts *data);
+
+/**
+ * @brief Displays an error summary on the serial console, one line per reported error.
+ *
+ * @param error Pointer to the error with the number of occurrences since its last report.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Error displayed successfully.
+ */
+static control_error_code_te serial_console_displayError(const control_error_ts *error);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -61,63 +165,298 @@ control_error_code_te serial_console_displayData(const control_data_ts *data)
   // Default error code for invalid input type
   control_error_code_te error_code = ERROR_CODE_INVALID_INPUT_TYPE;
 
+  if(SERIAL_CONSOLE_OUTPUT_MODE_BINARY == SERIAL_CONSOLE_OUTPUT_MODE)
+  {
+    error_code = serial_console_sendFrame(data); // Same data in compact frames, no text formatting
+  }
+  else
+  {
+    switch(data->input.io_component)
+    {
+      case INPUT_SENSORS:
+        error_code = serial_console_displaySensorMeasurement(&(data->input_return.sensor_reading), data->input.device_id); // Display sensor data
+        break;
+
+      case INPUT_SENSORS_SNAPSHOT:
+        error_code = serial_console_displaySensorsSnapshot(data); // Display readings of all sensors
+        break;
+
+#ifdef RTC_COMPONENT
+      case INPUT_RTC:
+        error_code = serial_console_displayTime(data); // Display RTC time data 
+        break;
+#endif
+
+      case INPUT_I2C_SCAN:
+        error_code = serial_console_displayI2cScan(data); // Display I2C scan results
+        break;
+
+      case INPUT_ERROR:
+        error_code = serial_console_displayError(&(data->input_return.error_msg)); // Display error summary
+        break;
+
+      default:
+        // No action, error code is already set
+        break;
+    }
+  }
+
+  return error_code;
+}
+
+void serial_console_service()
+{
+  int hardware_space = Serial.availableForWrite(); // Writing more than this would block in HardwareSerial::write()
+
+  while(tx_tail != tx_head && 0 < hardware_space)
+  {
+    (void)Serial.write((uint8_t)tx_ring[tx_tail & SERIAL_CONSOLE_TX_RING_MASK]);
+    tx_tail++;
+    hardware_space--;
+  }
+}
+
+size_t serial_console_receiveFrame(uint8_t *payload, size_t payload_size)
+{
+  while(0 < Serial.available())
+  {
+    uint8_t received = (uint8_t)Serial.read();
+
+    if(SERIAL_FRAME_DELIMITER == received)
+    {
+      size_t payload_len = 0u;
+      if(SERIAL_CONSOLE_RX_NO_OVERFLOW == rx_overflow && 0u != rx_len)
+      {
+        payload_len = serial_frame_decode(rx_frame, rx_len, payload, payload_size);
+      }
+      // Next frame starts after the delimiter, also after a broken one
+      rx_len = 0u;
+      rx_overflow = SERIAL_CONSOLE_RX_NO_OVERFLOW;
+
+      if(0u != payload_len)
+      {
+        return payload_len; // Remaining bytes stay in the HardwareSerial buffer for the next call
+      }
+    }
+    else if(SERIAL_CONSOLE_RX_FRAME_SIZE > rx_len)
+    {
+      rx_frame[rx_len] = received;
+      rx_len++;
+    }
+    else
+    {
+      rx_overflow = SERIAL_CONSOLE_RX_OVERFLOW;
+    }
+  }
+
+  return 0u;
+}
+
+bool serial_console_queueFrame(uint8_t *payload, size_t payload_len)
+{
+  uint8_t frame[SERIAL_FRAME_ENCODED_SIZE(SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD)];
+  size_t frame_len = serial_frame_encode(payload, payload_len, frame, sizeof(frame));
+
+  serial_console_service(); // Make room first
+  bool queued = (0u != frame_len) && txPushBytes(frame, frame_len);
+  serial_console_service(); // Start transmission right away
+
+  return queued;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void txWriteLine(const char *line)
+{
+  serial_console_service(); // Make room first
+
+  if(SERIAL_CONSOLE_NO_DROPPED_LINES != dropped_lines)
+  {
+    char notice[SERIAL_CONSOLE_STRING_RESERVED_SMALL];
+    snprintf(notice, sizeof(notice), "[%u lines dropped]", dropped_lines);
+    if(txPushLine(notice))
+    {
+      dropped_lines = SERIAL_CONSOLE_NO_DROPPED_LINES;
+    }
+  }
+
+  // Keep the order of lines, nothing new is queued until the notice is queued
+  if(SERIAL_CONSOLE_NO_DROPPED_LINES != dropped_lines || !txPushLine(line))
+  {
+    if(UINT16_MAX > dropped_lines)
+    {
+      dropped_lines++;
+    }
+  }
+
+  serial_console_service(); // Start transmission right away
+}
+
+static bool txPushLine(const char *line)
+{
+  size_t line_len = strlen(line);
+  uint16_t free_space = (uint16_t)(SERIAL_CONSOLE_TX_RING_SIZE - (uint16_t)(tx_head - tx_tail));
+
+  if((size_t)free_space < line_len + SERIAL_CONSOLE_LINE_ENDING_LEN)
+  {
+    return false;
+  }
+
+  (void)txPushBytes((const uint8_t *)line, line_len);
+  (void)txPushBytes((const uint8_t *)SERIAL_CONSOLE_LINE_ENDING, SERIAL_CONSOLE_LINE_ENDING_LEN);
+  return true;
+}
+
+static bool txPushBytes(const uint8_t *data, size_t len)
+{
+  uint16_t free_space = (uint16_t)(SERIAL_CONSOLE_TX_RING_SIZE - (uint16_t)(tx_head - tx_tail));
+
+  if((size_t)free_space < len)
+  {
+    return false;
+  }
+
+  for (size_t i = 0u; i < len; i++)
+  {
+    tx_ring[tx_head & SERIAL_CONSOLE_TX_RING_MASK] = (char)data[i];
+    tx_head++;
+  }
+  return true;
+}
+
+static void txWriteFrame(uint8_t *payload, size_t payload_len)
+{
+  uint8_t frame[SERIAL_FRAME_ENCODED_SIZE(SERIAL_CONSOLE_SNAPSHOT_PAYLOAD_SIZE)]; // Snapshot is the longest payload
+  size_t frame_len = serial_frame_encode(payload, payload_len, frame, sizeof(frame));
+
+  serial_console_service(); // Make room first
+
+  if(0u == frame_len || !txPushBytes(frame, frame_len))
+  {
+    if(UINT16_MAX > dropped_lines)
+    {
+      dropped_lines++;
+    }
+  }
+
+  serial_console_service(); // Start transmission right away
+}
+
+static control_error_code_te serial_console_sendFrame(const control_data_ts *data)
+{
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+  uint8_t payload[SERIAL_CONSOLE_SNAPSHOT_PAYLOAD_SIZE + SERIAL_FRAME_CRC_SIZE]; // Room for the CRC after every payload
+
   switch(data->input.io_component)
   {
     case INPUT_SENSORS:
-      error_code = serial_console_displaySensorMeasurement(data); // Display sensor data
+    {
+      payload[0] = SERIAL_CONSOLE_FRAME_TYPE_READING;
+      payload[1] = data->input.device_id;
+      payload[2] = (uint8_t)ERROR_CODE_NO_ERROR; // Failed readings are reported through errors
+      serial_frame_putU32(&payload[3], millis());
+      serial_frame_putU32(&payload[7], (uint32_t)toFrameValue(&(data->input_return.sensor_reading), data->input.device_id));
+      txWriteFrame(payload, SERIAL_CONSOLE_READING_PAYLOAD_SIZE);
       break;
+    }
 
-    case INPUT_RTC:
-      error_code = serial_console_displayTime(data); // Display RTC time data 
+    case INPUT_SENSORS_SNAPSHOT:
+    {
+      const sensors_snapshot_ts *snapshot = data->input_return.sensors_snapshot;
+      uint8_t num_of_readings = (SENSORS_SNAPSHOT_CAPACITY < snapshot->num_of_readings) ? SENSORS_SNAPSHOT_CAPACITY : snapshot->num_of_readings;
+
+      payload[0] = SERIAL_CONSOLE_FRAME_TYPE_SNAPSHOT;
+      serial_frame_putU32(&payload[1], snapshot->timestamp);
+      payload[5] = num_of_readings;
+
+      // Failed readings are sent too, with their error code
+      uint8_t *entry = &payload[SERIAL_CONSOLE_SNAPSHOT_HEADER_SIZE];
+      for (uint8_t sensor_index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; sensor_index < num_of_readings; sensor_index++)
+      {
+        entry[0] = sensors_interface_sensorIndexToId(sensor_index);
+        entry[1] = (uint8_t)snapshot->readings[sensor_index].error_code;
+        serial_frame_putU32(&entry[2], (ERROR_CODE_NO_ERROR == snapshot->readings[sensor_index].error_code) ?
+                                       (uint32_t)toFrameValue(&(snapshot->readings[sensor_index].sensor_reading), entry[0]) :
+                                       (uint32_t)SERIAL_CONSOLE_FRAME_INVALID_VALUE);
+        entry += SERIAL_CONSOLE_SNAPSHOT_ENTRY_SIZE;
+      }
+      txWriteFrame(payload, SERIAL_CONSOLE_SNAPSHOT_HEADER_SIZE + num_of_readings * SERIAL_CONSOLE_SNAPSHOT_ENTRY_SIZE);
+      break;
+    }
+
+    case INPUT_ERROR:
+    {
+      payload[0] = SERIAL_CONSOLE_FRAME_TYPE_ERROR;
+      payload[1] = data->input_return.error_msg.component.io_component;
+      payload[2] = data->input_return.error_msg.component.device_id;
+      payload[3] = (uint8_t)data->input_return.error_msg.error_code;
+      serial_frame_putU32(&payload[4], millis());
+      serial_frame_putU16(&payload[8], data->input_return.error_msg.occurrences);
+      txWriteFrame(payload, SERIAL_CONSOLE_ERROR_PAYLOAD_SIZE);
       break;
+    }
 
     case INPUT_I2C_SCAN:
-      error_code = serial_console_displayI2cScan(data); // Display I2C scan results
+#ifdef RTC_COMPONENT
+    case INPUT_RTC:
+#endif
+      // Not part of the telemetry, nothing is sent
       break;
 
     default:
-      // No action, error code is already set
+      error_code = ERROR_CODE_INVALID_INPUT_TYPE;
       break;
   }
 
   return error_code;
 }
-/* *************************************** */
 
-/* STATIC FUNCTIONS IMPLEMENTATIONS */
-static control_error_code_te serial_console_displaySensorMeasurement(const control_data_ts *data)
+static int32_t toFrameValue(const sensor_reading_ts *sensor_data, uint8_t sensor_id)
 {
-  sensor_reading_ts sensor_data = data->input_return.sensor_reading;
-  uint8_t sensor_id = data->input.device_id;
+  int32_t frame_value = SERIAL_CONSOLE_FRAME_INVALID_VALUE;
+  uint8_t sensor_index = sensors_interface_sensorIdToIndex(sensor_id);
 
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch)
+  {
+    frame_value = sensor_data->indication ? 1 : 0;
+  }
+  else if(SENSORS_INTERFACE_INVALID_INDEX != sensor_index)
+  {
+    // Integer rescaling in fixed-point mode
+    frame_value = sensor_value_toDecimals(sensor_data->value, sensors_interface_getNumOfDecimals(sensor_index),
+                                          SERIAL_CONSOLE_FRAME_VALUE_DECIMALS);
+  }
+  return frame_value;
+}
+
+static control_error_code_te serial_console_displaySensorMeasurement(const sensor_reading_ts *sensor_data, uint8_t sensor_id)
+{
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
-  // Retrieve sensor metadata
-  sensors_interface_metadata_ts sensor_metadata = sensors_interface_getSensorMetadata(sensor_id);
+  // Retrieve catalog index of the sensor
+  uint8_t sensor_index = sensors_interface_sensorIdToIndex(sensor_id);
 
-  // Check if metadata retrieval was successful
-  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensor_metadata.success_status)
+  // Check if the sensor is configured
+  if(SENSORS_INTERFACE_INVALID_INDEX != sensor_index)
   {
     // Extract metadata fields (display_num_of_letters is not needed in this case since everything is displayed)
-    const char* sensor_type = sensor_metadata.metadata.sensor_type;
-    const char* measurement_unit = sensor_metadata.metadata.measurement_unit;
-    uint8_t measurement_type = sensor_metadata.metadata.measurement_type;
-    uint8_t num_of_decimals = sensor_metadata.metadata.num_of_decimals;
+    uint8_t measurement_type = sensors_interface_getMeasurementType(sensor_index);
+    uint8_t num_of_decimals = sensors_interface_getNumOfDecimals(sensor_index);
 
     char display_string[SERIAL_CONSOLE_STRING_RESERVED_LARGE]; // Buffer for output string
-    char val[SERIAL_CONSOLE_DTOSTRF_BUFFER_SIZE]; // Buffer for value string
+    char val[SERIAL_CONSOLE_VALUE_BUFFER_SIZE]; // Buffer for value string
 
     bool proceed_with_display = SERIAL_CONSOLE_PROCEED_WITH_DISPLAY;
 
     // Handle value-based measurements
-    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
+    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
     {
-      dtostrf(sensor_data.value, SERIAL_CONSOLE_MIN_FLOAT_STRING_LEN, num_of_decimals, val); // Convert float to char array
+      (void)sensor_value_format(val, sizeof(val), sensor_data->value, num_of_decimals); // Integer formatting in fixed-point mode
     }
     // Handle indication-based measurements
-    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
+    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
     {
-      strncpy(val, (sensor_data.indication ? "yes" : "no"), sizeof(val) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+      strncpy(val, (sensor_data->indication ? "yes" : "no"), sizeof(val) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
       val[sizeof(val) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE] = '\0'; // Ensure null termination
     }
     else
@@ -129,8 +468,16 @@ static control_error_code_te serial_console_displaySensorMeasurement(const contr
     // Format and display the sensor data if everything is okay
     if(SERIAL_CONSOLE_PROCEED_WITH_DISPLAY == proceed_with_display)
     {
+      // Copy sensor type and unit from program memory only when they are needed
+      char sensor_type[SENSORS_INTERFACE_SENSOR_TYPE_MAX_LEN + SERIAL_CONSOLE_NULL_TERMINATOR_SIZE];
+      char measurement_unit[SENSORS_INTERFACE_MEASUREMENT_UNIT_MAX_LEN + SERIAL_CONSOLE_NULL_TERMINATOR_SIZE];
+      PLATFORM_STRNCPY_FLASH(sensor_type, sensors_interface_getSensorType(sensor_index), sizeof(sensor_type) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+      sensor_type[sizeof(sensor_type) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE] = '\0';
+      PLATFORM_STRNCPY_FLASH(measurement_unit, sensors_interface_getMeasurementUnit(sensor_index), sizeof(measurement_unit) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+      measurement_unit[sizeof(measurement_unit) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE] = '\0';
+
       snprintf(display_string, sizeof(display_string), "%s: %s%s", sensor_type, val, measurement_unit);
-      Serial.println(display_string);
+      txWriteLine(display_string);
     }
   }
   else
@@ -140,17 +487,45 @@ static control_error_code_te serial_console_displaySensorMeasurement(const contr
   return error_code;
 }
 
+static control_error_code_te serial_console_displaySensorsSnapshot(const control_data_ts *data)
+{
+  const sensors_snapshot_ts *snapshot = data->input_return.sensors_snapshot;
+
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+
+  char header_string[SERIAL_CONSOLE_STRING_RESERVED_MEDIUM]; // Buffer for the record header
+  snprintf(header_string, sizeof(header_string), "Sensors snapshot at %lu ms:", (unsigned long)snapshot->timestamp);
+  txWriteLine(header_string);
+
+  for (uint8_t sensor_index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; sensor_index < snapshot->num_of_readings; sensor_index++)
+  {
+    if(ERROR_CODE_NO_ERROR == snapshot->readings[sensor_index].error_code)
+    {
+      control_error_code_te reading_error_code = serial_console_displaySensorMeasurement(&(snapshot->readings[sensor_index].sensor_reading),
+                                                                                          sensors_interface_sensorIndexToId(sensor_index));
+      // Remember only the first error, the rest of the record is still displayed
+      if(ERROR_CODE_NO_ERROR == error_code)
+      {
+        error_code = reading_error_code;
+      }
+    }
+  }
+
+  return error_code;
+}
+
+#ifdef RTC_COMPONENT
 static control_error_code_te serial_console_displayTime(const control_data_ts *data)
 {
-  rtc_reading_ts time_data = data->input_return.rtc_reading;
+  const rtc_reading_ts *time_data = &(data->input_return.rtc_reading);
 
   // Extract time components
-  uint16_t year = time_data.year;
-  uint8_t month = time_data.month;
-  uint8_t day = time_data.day;
-  uint8_t hour = time_data.hour;
-  uint8_t mins = time_data.mins;
-  uint8_t secs = time_data.secs;
+  uint16_t year = time_data->year;
+  uint8_t month = time_data->month;
+  uint8_t day = time_data->day;
+  uint8_t hour = time_data->hour;
+  uint8_t mins = time_data->mins;
+  uint8_t secs = time_data->secs;
 
   // Buffer for formatted time string
   char time_string[SERIAL_CONSOLE_STRING_RESERVED_MEDIUM]; // Ensures enough space
@@ -161,14 +536,15 @@ static control_error_code_te serial_console_displayTime(const control_data_ts *d
            hour, mins, day, month, year);
 
   // Display the formatted time
-  Serial.println(time_string);
+  txWriteLine(time_string);
 
   return ERROR_CODE_NO_ERROR;
 }
+#endif
 
 static control_error_code_te serial_console_displayI2cScan(const control_data_ts *data)
 {
-  i2c_scan_reading_ts i2c_scan_data = data->input_return.i2c_scan_reading;
+  const i2c_scan_reading_ts *i2c_scan_data = &(data->input_return.i2c_scan_reading);
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
@@ -178,19 +554,19 @@ static control_error_code_te serial_console_displayI2cScan(const control_data_ts
   char addr_string[SERIAL_CONSOLE_HEX_ADDR_STRING_LEN]; // Buffer for hexadecimal address representation
 
   // Handle scan for all devices mode
-  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data.device_address)
+  if(I2C_SCAN_IS_MULTI_DEVICE_SCAN(i2c_scan_data->device_address))
   {
-    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data.current_i2c_addr);
+    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data->current_i2c_addr);
     snprintf(display_string, sizeof(display_string), "I2C scan - I2C device found at address: 0x%s", addr_string);
   }
   else
   {
-    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data.device_address);
+    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data->device_address);
     snprintf(display_string, sizeof(display_string), "I2C device on address 0x%s status: ", addr_string);
 
     char status_msg[SERIAL_CONSOLE_STRING_RESERVED_LARGE]; // Buffer for the status message
     // Interpret and append the device status
-    switch (i2c_scan_data.single_device_status)
+    switch (i2c_scan_data->single_device_status)
     {
       case I2C_SCAN_TRANSMISSION_RESULT_SUCCESS:
         strncpy(status_msg, "Successful transmission", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
@@ -222,9 +598,22 @@ static control_error_code_te serial_console_displayI2cScan(const control_data_ts
   // Display the formatted string if no error occurred
   if(SERIAL_CONSOLE_PROCEED_WITH_DISPLAY == proceed_with_display)
   {
-    Serial.println(display_string);
+    txWriteLine(display_string);
   }
 
   return error_code;
 }
-/* *************************************** */
\ No newline at end of file
+
+static control_error_code_te serial_console_displayError(const control_error_ts *error)
+{
+  char error_string[SERIAL_CONSOLE_STRING_RESERVED_MEDIUM];
+
+  // Component and device ID are sent as numbers, the error may come from a component which is not compiled in
+  snprintf(error_string, sizeof(error_string), "Error %u from %u:%u x%u",
+           (unsigned int)error->error_code, (unsigned int)error->component.io_component,
+           (unsigned int)error->component.device_id, (unsigned int)error->occurrences);
+  txWriteLine(error_string);
+
+  return ERROR_CODE_NO_ERROR;
+}
+/* *************************************** */
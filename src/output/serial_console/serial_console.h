@@ -2,22 +2,20 @@
 #define SERIAL_CONSOLE_H
 
 #include <Arduino.h>
-#include <avr/pgmspace.h>
-#include <WString.h>
+#include "../../platform/platform.h"
 #include "../../control/control_types.h"
 #include "serial_console_config.h"
+#include "serial_frame.h"
 
 /* Flag to proceed with displaying data */
 #define SERIAL_CONSOLE_PROCEED_WITH_DISPLAY      (bool)(true)
 /* Flag to prevent displaying data */
 #define SERIAL_CONSOLE_DONT_PROCEED_WITH_DISPLAY (bool)(false)
 
-/* Size of the buffer for converting float to string */
-#define SERIAL_CONSOLE_DTOSTRF_BUFFER_SIZE   (uint8_t)(20u)
+/* Size of the buffer for formatting a sensor value */
+#define SERIAL_CONSOLE_VALUE_BUFFER_SIZE     (uint8_t)(SENSOR_VALUE_FORMAT_BUFFER_SIZE)
 /* Size for the null terminator in strings */
 #define SERIAL_CONSOLE_NULL_TERMINATOR_SIZE  (uint8_t)(1u)
-/* Minimal size of float string for serial console */
-#define SERIAL_CONSOLE_MIN_FLOAT_STRING_LEN  (signed char)(1)
 /* Len of formated hex address */
 #define SERIAL_CONSOLE_HEX_ADDR_STRING_LEN   (uint8_t)(3u)
 
@@ -29,6 +27,42 @@
 #define SERIAL_CONSOLE_STRING_RESERVED_GIANT         (uint16_t)(100u) /* Suitable for multi-field messages or debugging output */
 #define SERIAL_CONSOLE_STRING_RESERVED_ENORMOUS      (uint16_t)(200u) /* Very large messages or extensive debugging output, not recommended for RAM saving */
 
+/* Transmit ring indexes are free running, ring size must be a power of two */
+#define SERIAL_CONSOLE_TX_RING_MASK          (uint16_t)(SERIAL_CONSOLE_TX_RING_SIZE - 1u)
+/* Line ending appended to every queued line, same as Serial.println() */
+#define SERIAL_CONSOLE_LINE_ENDING           "\r\n"
+#define SERIAL_CONSOLE_LINE_ENDING_LEN       (uint8_t)(2u)
+/* Value of the dropped lines counter when nothing was dropped */
+#define SERIAL_CONSOLE_NO_DROPPED_LINES      (uint16_t)(0u)
+
+/* Size of the buffer for a received frame (COBS encoded, without the delimiter), longer frames are discarded */
+#define SERIAL_CONSOLE_RX_FRAME_SIZE         (uint8_t)(32u)
+/* Longest payload which can be queued with serial_console_queueFrame() */
+#define SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD (uint8_t)(80u)
+/* Flags indicating if the frame being received did not fit the receive buffer */
+#define SERIAL_CONSOLE_RX_OVERFLOW           (bool)(true)
+#define SERIAL_CONSOLE_RX_NO_OVERFLOW        (bool)(false)
+
+/* Binary frame types, first byte of every payload */
+#define SERIAL_CONSOLE_FRAME_TYPE_READING    (uint8_t)(0x01u)
+#define SERIAL_CONSOLE_FRAME_TYPE_SNAPSHOT   (uint8_t)(0x02u)
+#define SERIAL_CONSOLE_FRAME_TYPE_ERROR      (uint8_t)(0x03u)
+
+/* Reading payload: type, sensor ID, error code, timestamp (u32), value (i32) */
+#define SERIAL_CONSOLE_READING_PAYLOAD_SIZE  (uint8_t)(11u)
+/* Snapshot payload: type, timestamp (u32), number of readings, then for every reading: sensor ID, error code, value (i32) */
+#define SERIAL_CONSOLE_SNAPSHOT_HEADER_SIZE  (uint8_t)(6u)
+#define SERIAL_CONSOLE_SNAPSHOT_ENTRY_SIZE   (uint8_t)(6u)
+#define SERIAL_CONSOLE_SNAPSHOT_PAYLOAD_SIZE (uint16_t)(SERIAL_CONSOLE_SNAPSHOT_HEADER_SIZE + \
+                                                        SENSORS_SNAPSHOT_CAPACITY * SERIAL_CONSOLE_SNAPSHOT_ENTRY_SIZE)
+/* Error payload: type, IO component, device ID, error code, timestamp (u32), occurrences since the last report (u16) */
+#define SERIAL_CONSOLE_ERROR_PAYLOAD_SIZE    (uint8_t)(10u)
+
+/* Values are sent as fixed-point integers with 2 decimals (1/100 of the measurement unit), indications as 0 or 1 */
+#define SERIAL_CONSOLE_FRAME_VALUE_DECIMALS  (uint8_t)(2u)
+/* Sent instead of the value when it is not a number or does not fit the fixed-point range */
+#define SERIAL_CONSOLE_FRAME_INVALID_VALUE   (int32_t)(SENSOR_VALUE_SCALED_INVALID)
+
 /**
  * @brief Initializes the serial console communication.
  *
@@ -46,6 +80,8 @@ control_error_code_te serial_console_init();
  *
  * This function handles data routing and invokes specific display functions
  * based on the type of input provided (e.g., sensor data, RTC time, or I2C scan results).
+ * In SERIAL_CONSOLE_OUTPUT_MODE_BINARY sensor readings, snapshots and errors are sent as
+ * COBS framed packets instead (see serial_frame.h), RTC time and I2C scan results are not sent.
  *
  * @param data Pointer to data structure containing the input type and associated readings.
  * @return control_error_code_te
@@ -54,4 +90,37 @@ control_error_code_te serial_console_init();
  */
 control_error_code_te serial_console_displayData(const control_data_ts *data);
 
+/**
+ * @brief Moves queued bytes from the transmit ring into the HardwareSerial buffer.
+ *
+ * NEEDS TO BE CALLED IN A LOOP, often enough that the HardwareSerial buffer does not run empty
+ * (64 bytes last about 66 ms at 9600 baud). Only as many bytes as fit into the HardwareSerial buffer
+ * are moved, so the call never blocks. Transmission itself is done by the UART interrupt.
+ */
+void serial_console_service();
+
+/**
+ * @brief Collects received bytes and returns the payload of a complete frame.
+ *
+ * Frames from the host use the same framing as the binary output (see serial_frame.h). Only the bytes
+ * already received are read, so the call never blocks. Malformed frames and frames with a wrong CRC are dropped.
+ *
+ * @param payload Buffer for the payload, the CRC is decoded into it too.
+ * @param payload_size Size of the payload buffer.
+ * @return size_t Number of payload bytes of a received frame or 0 if no complete valid frame was received.
+ */
+size_t serial_console_receiveFrame(uint8_t *payload, size_t payload_size);
+
+/**
+ * @brief Queues a binary frame whole or not at all, in both output modes.
+ *
+ * Unlike the frames of the routed data a frame which does not fit is not dropped, so the caller
+ * can queue it again later (for example the blocks of the log export, which are flow controlled).
+ *
+ * @param payload Payload, MUST HAVE SERIAL_FRAME_CRC_SIZE free bytes after payload_len, the CRC is written there.
+ * @param payload_len Number of payload bytes, at most SERIAL_CONSOLE_QUEUED_FRAME_MAX_PAYLOAD.
+ * @return true if the frame was queued, false if there is not enough room in the transmit ring.
+ */
+bool serial_console_queueFrame(uint8_t *payload, size_t payload_len);
+
 #endif
\ No newline at end of file
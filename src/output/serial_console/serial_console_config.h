@@ -9,4 +9,20 @@
  */
 #define SERIAL_CONSOLE_BAUDRATE (uint64_t)(9600u)
 
+/**
+ * Size of the transmit ring in bytes (power of two). Lines are queued here and moved into the
+ * 64 byte HardwareSerial buffer only as fast as it drains, so printing never waits for the UART.
+ * Lines which do not fit are dropped and reported with one "[N lines dropped]" notice.
+ */
+#define SERIAL_CONSOLE_TX_RING_SIZE (uint16_t)(256u)
+
+/**
+ * Output mode of the serial console.
+ * TEXT - human readable lines for a serial monitor.
+ * BINARY - COBS framed packets with CRC for an ingest host, no float formatting on the device.
+ */
+#define SERIAL_CONSOLE_OUTPUT_MODE_TEXT   (uint8_t)(0u)
+#define SERIAL_CONSOLE_OUTPUT_MODE_BINARY (uint8_t)(1u)
+#define SERIAL_CONSOLE_OUTPUT_MODE        (SERIAL_CONSOLE_OUTPUT_MODE_TEXT)
+
 #endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "serial_frame.h"
+
+/* EXPORTED FUNCTIONS */
+uint16_t serial_frame_crc16(const uint8_t *data, size_t len)
+{
+  uint16_t crc = SERIAL_FRAME_CRC_INITIAL;
+
+  for (size_t i = 0u; i < len; i++)
+  {
+    crc ^= (uint16_t)((uint16_t)data[i] << 8u);
+    for (uint8_t bit = 0u; bit < 8u; bit++)
+    {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1u) ^ SERIAL_FRAME_CRC_POLYNOMIAL) : (uint16_t)(crc << 1u);
+    }
+  }
+  return crc;
+}
+
+size_t serial_frame_encode(uint8_t *payload, size_t payload_len, uint8_t *frame, size_t frame_size)
+{
+  if(SERIAL_FRAME_ENCODED_SIZE(payload_len) > frame_size)
+  {
+    return 0u;
+  }
+
+  serial_frame_putU16(&payload[payload_len], serial_frame_crc16(payload, payload_len));
+  size_t data_len = payload_len + SERIAL_FRAME_CRC_SIZE;
+
+  // Every code byte holds the distance to the next zero, zeros themselves are not written
+  size_t code_index = 0u;
+  size_t write_index = 1u;
+  uint8_t code = 1u;
+
+  for (size_t read_index = 0u; read_index < data_len; read_index++)
+  {
+    if(SERIAL_FRAME_DELIMITER == payload[read_index])
+    {
+      frame[code_index] = code;
+      code = 1u;
+      code_index = write_index++;
+    }
+    else
+    {
+      frame[write_index++] = payload[read_index];
+      code++;
+      if(SERIAL_FRAME_COBS_MAX_CODE == code)
+      {
+        frame[code_index] = code;
+        code = 1u;
+        code_index = write_index++;
+      }
+    }
+  }
+  frame[code_index] = code;
+  frame[write_index++] = SERIAL_FRAME_DELIMITER;
+
+  return write_index;
+}
+
+size_t serial_frame_decode(const uint8_t *frame, size_t frame_len, uint8_t *payload, size_t payload_size)
+{
+  size_t read_index = 0u;
+  size_t write_index = 0u;
+
+  while(read_index < frame_len)
+  {
+    uint8_t code = frame[read_index++];
+    if(SERIAL_FRAME_DELIMITER == code || read_index + code - 1u > frame_len)
+    {
+      return 0u; // Zero inside the frame or code points behind the end
+    }
+
+    for (uint8_t i = 1u; i < code; i++)
+    {
+      if(write_index >= payload_size)
+      {
+        return 0u;
+      }
+      payload[write_index++] = frame[read_index++];
+    }
+
+    // Every code except the maximum one and the last one stands for a zero
+    if(SERIAL_FRAME_COBS_MAX_CODE != code && read_index < frame_len)
+    {
+      if(write_index >= payload_size)
+      {
+        return 0u;
+      }
+      payload[write_index++] = SERIAL_FRAME_DELIMITER;
+    }
+  }
+
+  if(SERIAL_FRAME_CRC_SIZE > write_index)
+  {
+    return 0u;
+  }
+
+  size_t payload_len = write_index - SERIAL_FRAME_CRC_SIZE;
+  if(serial_frame_crc16(payload, payload_len) != serial_frame_getU16(&payload[payload_len]))
+  {
+    return 0u;
+  }
+  return payload_len;
+}
+
+void serial_frame_putU16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t)(value);
+  buffer[1] = (uint8_t)(value >> 8u);
+}
+
+void serial_frame_putU32(uint8_t *buffer, uint32_t value)
+{
+  serial_frame_putU16(&buffer[0], (uint16_t)(value));
+  serial_frame_putU16(&buffer[2], (uint16_t)(value >> 16u));
+}
+
+uint16_t serial_frame_getU16(const uint8_t *buffer)
+{
+  return (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8u));
+}
+
+uint32_t serial_frame_getU32(const uint8_t *buffer)
+{
+  return (uint32_t)serial_frame_getU16(&buffer[0]) | ((uint32_t)serial_frame_getU16(&buffer[2]) << 16u);
+}
+/* *************************************** */
@@ -0,0 +1,96 @@
+#ifndef SERIAL_FRAME_H
+#define SERIAL_FRAME_H
+
+#include <Arduino.h>
+
+/**
+ * @file serial_frame.h
+ * @brief COBS framing with CRC-16 for the binary output mode of the serial console.
+ *
+ * A frame on the wire is COBS(payload + CRC) followed by a single 0x00 delimiter.
+ * COBS removes every zero byte from the encoded data, so a receiver can always
+ * resynchronize on the next delimiter. CRC is CRC-16/CCITT-FALSE (polynomial 0x1021,
+ * initial value 0xFFFF) over the payload, stored little endian after the payload.
+ * All multi-byte payload fields are little endian as well.
+ */
+
+/* Frame delimiter, never present inside an encoded frame */
+#define SERIAL_FRAME_DELIMITER            (uint8_t)(0x00u)
+
+/* CRC-16/CCITT-FALSE parameters */
+#define SERIAL_FRAME_CRC_POLYNOMIAL       (uint16_t)(0x1021u)
+#define SERIAL_FRAME_CRC_INITIAL          (uint16_t)(0xFFFFu)
+#define SERIAL_FRAME_CRC_SIZE             (uint8_t)(2u)
+
+/* Longest run of non-zero bytes described by a single COBS code byte */
+#define SERIAL_FRAME_COBS_MAX_CODE        (uint8_t)(0xFFu)
+
+/* Size on the wire of a frame with the given payload size: COBS overhead, one code byte per 254 bytes, and the delimiter */
+#define SERIAL_FRAME_ENCODED_SIZE(payload_size) ((size_t)(payload_size) + SERIAL_FRAME_CRC_SIZE + \
+                                                 (((size_t)(payload_size) + SERIAL_FRAME_CRC_SIZE) / 254u) + 2u)
+
+/**
+ * @brief Calculates CRC-16/CCITT-FALSE of a buffer.
+ *
+ * @param data Buffer to calculate the CRC of.
+ * @param len Number of bytes.
+ * @return uint16_t Calculated CRC.
+ */
+uint16_t serial_frame_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Appends the CRC to a payload and COBS encodes it into a frame terminated by the delimiter.
+ *
+ * @param payload Payload buffer, MUST HAVE SERIAL_FRAME_CRC_SIZE free bytes after payload_len, the CRC is written there.
+ * @param payload_len Number of payload bytes.
+ * @param frame Buffer for the encoded frame.
+ * @param frame_size Size of the frame buffer, at least SERIAL_FRAME_ENCODED_SIZE(payload_len).
+ * @return size_t Number of bytes of the encoded frame including the delimiter or 0 if the frame buffer is too small.
+ */
+size_t serial_frame_encode(uint8_t *payload, size_t payload_len, uint8_t *frame, size_t frame_size);
+
+/**
+ * @brief Decodes a received frame and checks its CRC.
+ *
+ * @param frame Encoded frame without the delimiter.
+ * @param frame_len Number of bytes of the encoded frame.
+ * @param payload Buffer for the decoded payload, the CRC is decoded into it too.
+ * @param payload_size Size of the payload buffer.
+ * @return size_t Number of payload bytes (without the CRC) or 0 if the frame is malformed,
+ *         does not fit the buffer or the CRC does not match.
+ */
+size_t serial_frame_decode(const uint8_t *frame, size_t frame_len, uint8_t *payload, size_t payload_size);
+
+/**
+ * @brief Stores a 16-bit value little endian.
+ *
+ * @param buffer Destination, 2 bytes.
+ * @param value Value to store.
+ */
+void serial_frame_putU16(uint8_t *buffer, uint16_t value);
+
+/**
+ * @brief Stores a 32-bit value little endian.
+ *
+ * @param buffer Destination, 4 bytes.
+ * @param value Value to store.
+ */
+void serial_frame_putU32(uint8_t *buffer, uint32_t value);
+
+/**
+ * @brief Loads a 16-bit little endian value.
+ *
+ * @param buffer Source, 2 bytes.
+ * @return uint16_t Loaded value.
+ */
+uint16_t serial_frame_getU16(const uint8_t *buffer);
+
+/**
+ * @brief Loads a 32-bit little endian value.
+ *
+ * @param buffer Source, 4 bytes.
+ * @return uint32_t Loaded value.
+ */
+uint32_t serial_frame_getU32(const uint8_t *buffer);
+
+#endif
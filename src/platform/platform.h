@@ -0,0 +1,91 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <Arduino.h>
+
+/**
+ * @file platform.h
+ * @brief Access to constant data in flash, timing and the memory of the target.
+ *
+ * On the AVR constant tables live in program memory, which is a separate address space and is read
+ * with the pgm_read_* instructions. The ESP32 maps its flash into the data address space, so the same
+ * tables are read through plain pointers there. Modules use the PLATFORM_* macros instead of avr/pgmspace.h,
+ * so a table is declared and read the same way on both targets.
+ *
+ * Every task runs in the Arduino loop() on one core. Only this layer, the scheduler and the settings are ported to the
+ * ESP32 so far, the I2C bus, ADC sampling, MQ7, DHT11, RTC and power drivers still use AVR registers, so the ESP32
+ * build is stopped by a compile time check in control.cpp. Splitting acquisition and output over the two cores of
+ * the ESP32 waits for that port. Data between an interrupt and the loop is passed through single-producer/single-consumer queues
+ * whose indexes are published with PLATFORM_STORE_RELEASE and read with PLATFORM_LOAD_ACQUIRE. On the AVR both
+ * expand to plain 8-bit accesses, which are atomic.
+ *
+ * Settings which survive a power cycle are kept in the internal EEPROM of the AVR. The ESP32 has no EEPROM,
+ * its Arduino core emulates one in a flash partition which is mirrored in RAM, PLATFORM_EEPROM_BEGIN() loads
+ * the mirror and every PLATFORM_EEPROM_UPDATE() commits it back to the flash.
+ */
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <EEPROM.h>
+
+/* Constant data stays in the flash mapped into the data address space */
+#define PLATFORM_PROGMEM
+typedef const char *platform_flash_string_t;
+
+#define PLATFORM_READ_BYTE(address)            (*(const uint8_t *)(address))
+#define PLATFORM_READ_WORD(address)            (*(const uint16_t *)(address))
+#define PLATFORM_READ_DWORD(address)           (*(const uint32_t *)(address))
+#define PLATFORM_READ_FLOAT(address)           (*(const float *)(address))
+#define PLATFORM_READ_PTR(address)             (*(const void * const *)(address))
+#define PLATFORM_MEMCPY_FLASH(dest, src, len)  memcpy((dest), (src), (len))
+#define PLATFORM_STRNCPY_FLASH(dest, src, len) strncpy((dest), (src), (len))
+
+/* Emulated EEPROM, the size of the mirror in RAM is chosen here */
+#define PLATFORM_EEPROM_SIZE                   (uint16_t)(512u)
+#define PLATFORM_EEPROM_BEGIN()                (void)EEPROM.begin(PLATFORM_EEPROM_SIZE)
+#define PLATFORM_EEPROM_READ(dest, address, len) (void)EEPROM.readBytes((address), (dest), (len))
+#define PLATFORM_EEPROM_UPDATE(address, src, len) do { (void)EEPROM.writeBytes((address), (src), (len)); (void)EEPROM.commit(); } while(0)
+
+/* Internal data RAM, the buffers of the serial driver are taken from its heap and not counted by the budget */
+#define PLATFORM_SRAM_SIZE                     (uint32_t)(320u * 1024u)
+#define PLATFORM_SERIAL_BUFFERS_SIZE           (uint16_t)(0u)
+
+/* Gives the core to other FreeRTOS tasks for at least one tick */
+#define PLATFORM_YIELD_MS(ms)                  vTaskDelay(pdMS_TO_TICKS(ms) ? pdMS_TO_TICKS(ms) : 1u)
+#else
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+
+/* Constant data in program memory, read with the pgm_read_* instructions */
+#define PLATFORM_PROGMEM                       PROGMEM
+typedef PGM_P platform_flash_string_t;
+
+#define PLATFORM_READ_BYTE(address)            pgm_read_byte(address)
+#define PLATFORM_READ_WORD(address)            pgm_read_word(address)
+#define PLATFORM_READ_DWORD(address)           pgm_read_dword(address)
+#define PLATFORM_READ_FLOAT(address)           pgm_read_float(address)
+#define PLATFORM_READ_PTR(address)             pgm_read_ptr(address)
+#define PLATFORM_MEMCPY_FLASH(dest, src, len)  memcpy_P((dest), (src), (len))
+#define PLATFORM_STRNCPY_FLASH(dest, src, len) strncpy_P((dest), (src), (len))
+
+/* Internal EEPROM, update only writes the bytes which changed, so a rewrite of the same data costs no write cycle */
+#define PLATFORM_EEPROM_SIZE                   (uint16_t)(E2END + 1u)
+#define PLATFORM_EEPROM_BEGIN()                do { } while(0)
+#define PLATFORM_EEPROM_READ(dest, address, len) eeprom_read_block((dest), (const void *)(uintptr_t)(address), (len))
+#define PLATFORM_EEPROM_UPDATE(address, src, len) eeprom_update_block((src), (void *)(uintptr_t)(address), (len))
+
+/* SRAM of the MCU (2 KB on the Uno) and the static buffers of HardwareSerial, which the budget check can not see */
+#define PLATFORM_SRAM_SIZE                     (uint32_t)(RAMEND - RAMSTART + 1u)
+#define PLATFORM_SERIAL_BUFFERS_SIZE           (uint16_t)(SERIAL_RX_BUFFER_SIZE + SERIAL_TX_BUFFER_SIZE)
+#endif
+
+/* Time since boot, the deadlines of the modules are compared with the signed difference of two values */
+#define PLATFORM_MILLIS()                      (uint32_t)(millis())
+#define PLATFORM_MICROS()                      (uint32_t)(micros())
+
+/* Index of a single-producer/single-consumer queue, published by its owner and read by the other side */
+#define PLATFORM_LOAD_ACQUIRE(address)         __atomic_load_n((address), __ATOMIC_ACQUIRE)
+#define PLATFORM_STORE_RELEASE(address, value) __atomic_store_n((address), (value), __ATOMIC_RELEASE)
+
+#endif
@@ -0,0 +1,118 @@
+#include "power.h"
+
+/* Millisecond counter of the Arduino core (wiring.c), advanced by the Timer0 overflow interrupt */
+extern volatile unsigned long timer0_millis;
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Advances millis() to a later time, an earlier time is ignored.
+ *
+ * @param target_millis Time in milliseconds which millis() returns afterwards.
+ */
+static void advanceMillis(uint32_t target_millis);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void power_init()
+{
+  ACSR = _BV(ACD); // Analog comparator off, its interrupt stays disabled
+
+#if !defined(RADIO_COMPONENT) && !defined(GATEWAY_COMPONENT)
+  power_spi_disable(); // SPI only drives the LoRa transceiver
+#endif
+  power_timer2_disable();
+#ifndef MQ7_COMPONENT
+  power_timer1_disable(); // Timer1 only generates the heater PWM of the MQ7
+#endif
+#ifndef SERIAL_CONSOLE_COMPONENT
+  power_usart0_disable();
+#endif
+#ifndef POWER_ADC_USED
+  power_adc_disable(); // ADEN is cleared after reset, the clock can be stopped
+#endif
+}
+
+void power_sleep(uint8_t sleep_mode)
+{
+  set_sleep_mode(sleep_mode);
+  cli();
+  sleep_enable();
+#if defined(BODS)
+  if(SLEEP_MODE_IDLE != sleep_mode)
+  {
+    sleep_bod_disable(); // Timed sequence, the sleep must follow within three cycles
+  }
+#endif
+  sei(); // Instruction after sei is executed before any pending interrupt, so the sleep is entered
+  sleep_cpu();
+  sleep_disable();
+}
+
+bool power_isDeepSleepPossible(uint32_t current_millis, uint32_t deadline)
+{
+#ifdef POWER_DEEP_SLEEP_SUPPORTED
+  uint32_t tick_millis = 0u;
+
+  if(RTC_TICK_KNOWN != rtc_getNextTick(current_millis, &tick_millis))
+  {
+    return POWER_DEEP_SLEEP_NOT_POSSIBLE;
+  }
+  // Sleep ends with the tick, it must come before the deadline and be worth the start-up of the oscillator
+  if(0 > (int32_t)(deadline - tick_millis) || POWER_MIN_DEEP_SLEEP_MS > (uint32_t)(tick_millis - current_millis))
+  {
+    return POWER_DEEP_SLEEP_NOT_POSSIBLE;
+  }
+  if(!i2c_bus_isIdle() || !adc_sampling_isIdle())
+  {
+    return POWER_DEEP_SLEEP_NOT_POSSIBLE;
+  }
+#ifdef RADIO_COMPONENT
+  if(!radio_isIdle())
+  {
+    return POWER_DEEP_SLEEP_NOT_POSSIBLE; // End of the transmission is polled against its airtime
+  }
+#endif
+#ifdef DHT11_COMPONENT
+  if(!dht11_isIdle())
+  {
+    return POWER_DEEP_SLEEP_NOT_POSSIBLE; // Bits of the frame are decoded with micros()
+  }
+#endif
+  return POWER_DEEP_SLEEP_POSSIBLE;
+#else
+  (void)current_millis;
+  (void)deadline;
+  return POWER_DEEP_SLEEP_NOT_POSSIBLE;
+#endif
+}
+
+void power_sleepUntilTick()
+{
+  uint32_t tick_millis = 0u;
+
+  if(RTC_TICK_WAKE_UP_ARMED != rtc_armTickWakeUp())
+  {
+    return;
+  }
+  power_sleep(POWER_DEEP_SLEEP_MODE);
+
+  // Timer0 stood still, millis() continues from the tick. An early wake-up by another interrupt loses the time slept
+  if(RTC_WOKEN_BY_TICK == rtc_finishTickWakeUp(&tick_millis))
+  {
+    advanceMillis(tick_millis);
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void advanceMillis(uint32_t target_millis)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(0 < (int32_t)(target_millis - (uint32_t)timer0_millis)) // Overflow safe compare
+    {
+      timer0_millis = target_millis;
+    }
+  }
+}
+/* *************************************** */
@@ -0,0 +1,89 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "../project_settings.h"
+#include "../i2c_bus/i2c_bus.h"
+#include "../input/rtc/rtc.h"
+#include "../input/sensors/sensor_library/adc_sampling/adc_sampling.h"
+#include "../input/sensors/sensor_library/dht11/dht11.h"
+#include "../output/radio/radio.h"
+
+/**
+ * @file power.h
+ * @brief Gating of the unused peripherals and the sleep of the scheduler between the task deadlines.
+ *
+ * At boot the clocks of the peripherals which no component uses are stopped in PRR and the analog
+ * comparator is switched off. The ADC is switched off by the sampling between its rounds of conversions,
+ * BMP280 (forced mode) and BH1750 (one time mode) already go to sleep after every measurement.
+ *
+ * The scheduler sleeps in the idle mode, where Timer0 wakes it every millisecond. Power-save stops
+ * Timer0 (millis()), Timer1, the USART and the TWI, so it is used only when no component needs them and
+ * the MCU is woken by the SQW tick of the RTC: INT1 is switched to the low level, the only mode of INT1
+ * which wakes from power-save, and millis() is advanced to the time of the tick after the wake-up.
+ * The asynchronous Timer2 can not be used as a wake-up source, its crystal pins carry the clock crystal.
+ */
+
+/* Power-save needs the SQW ticks and stops Timer1 (MQ7 heater PWM) and the USART (serial console) */
+#if defined(RTC_COMPONENT) && !defined(MQ7_COMPONENT) && !defined(SERIAL_CONSOLE_COMPONENT)
+#define POWER_DEEP_SLEEP_SUPPORTED
+#endif
+
+/* Analog components, the ADC is stopped in PRR without them */
+#if defined(MQ135_COMPONENT) || defined(MQ7_COMPONENT) || defined(GYML8511_COMPONENT) || defined(ARDUINORAIN_COMPONENT)
+#define POWER_ADC_USED
+#endif
+
+/* Sleep mode between the SQW ticks */
+#define POWER_DEEP_SLEEP_MODE               (SLEEP_MODE_PWR_SAVE)
+
+/* Shortest sleep until the tick which is done in power-save, the oscillator start-up takes about 1 ms */
+#define POWER_MIN_DEEP_SLEEP_MS             (uint32_t)(10u)
+
+/* Flags returned by power_isDeepSleepPossible() */
+#define POWER_DEEP_SLEEP_POSSIBLE           (bool)(true)
+#define POWER_DEEP_SLEEP_NOT_POSSIBLE       (bool)(false)
+
+/**
+ * @brief Stops the clocks of the unused peripherals and switches off the analog comparator.
+ *
+ * Must be called once at boot, before the components are started. Timer2 is never used,
+ * the SPI, Timer1, the USART and the ADC are stopped if their components are not compiled in.
+ */
+void power_init();
+
+/**
+ * @brief Puts the MCU to sleep until the next interrupt.
+ *
+ * The brown-out detector is switched off during the sleep in the deep modes, where it takes effect.
+ *
+ * @param sleep_mode One of the SLEEP_MODE_* values of avr/sleep.h.
+ */
+void power_sleep(uint8_t sleep_mode);
+
+/**
+ * @brief Checks if the MCU can sleep in power-save until the next SQW tick.
+ *
+ * The tick must be known and come before the deadline, and no I2C job, ADC round or DHT11
+ * exchange may run, they are timed by or run on the clocks which stop in power-save.
+ * Always false without POWER_DEEP_SLEEP_SUPPORTED.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @param deadline Time in milliseconds at which the MCU must be awake.
+ * @return true (POWER_DEEP_SLEEP_POSSIBLE) if power_sleepUntilTick() may be called, false otherwise.
+ */
+bool power_isDeepSleepPossible(uint32_t current_millis, uint32_t deadline);
+
+/**
+ * @brief Sleeps in power-save until the next SQW tick and advances millis() by the time of the sleep.
+ *
+ * Must be called only after power_isDeepSleepPossible() returned true. The watchdog keeps running
+ * in power-save, so its timeout must be longer than one second. Nothing is done if SQW is low.
+ */
+void power_sleepUntilTick();
+
+#endif
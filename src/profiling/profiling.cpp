@@ -0,0 +1,198 @@
+#include "profiling.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Tasks first, then sensors and benchmarks */
+static profiling_stats_ts stats[PROFILING_NUM_OF_SLOTS];
+
+static bool dump_active = PROFILING_DUMP_INACTIVE;
+static bool dump_frame_ready = PROFILING_FRAME_NOT_READY;
+static bool reset_after_dump = PROFILING_KEEP_AFTER_DUMP;
+static uint8_t dump_slot = 0u;
+static uint8_t dump_frame[PROFILING_FRAME_STATS_SIZE + PROFILING_FRAME_CRC_SIZE];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert((uint16_t)PROFILING_MAX_TASKS + PROFILING_MAX_SENSORS + PROFILING_MAX_BENCHMARKS < UINT8_MAX, "Slot indexes are 8-bit, PROFILING_NUM_OF_SLOTS marks an invalid slot");
+static_assert(PROFILING_FRAME_STATS_SIZE >= PROFILING_FRAME_END_SIZE, "Dump frame buffer must fit every frame");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Finds the slot of a profiled call.
+ *
+ * @param group Group of the call.
+ * @param index Index in the group.
+ * @return uint8_t Slot of the call or PROFILING_NUM_OF_SLOTS for an invalid group or index.
+ */
+static uint8_t findSlot(uint8_t group, uint8_t index);
+
+/**
+ * @brief Writes the STATS frame of a slot into the dump frame.
+ *
+ * @param slot Slot which ran at least once.
+ */
+static void buildStatsFrame(uint8_t slot);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void profiling_record(uint8_t group, uint8_t index, uint32_t start_micros, uint32_t budget_us)
+{
+  profiling_recordValue(group, index, micros() - start_micros, budget_us); // Overflow safe
+}
+
+void profiling_recordValue(uint8_t group, uint8_t index, uint32_t value, uint32_t limit)
+{
+  uint8_t slot = findSlot(group, index);
+
+  if(PROFILING_NUM_OF_SLOTS <= slot)
+  {
+    return;
+  }
+  profiling_stats_ts *slot_stats = &stats[slot];
+
+  if(PROFILING_NO_RUNS == slot_stats->runs)
+  {
+    slot_stats->min_us = value;
+    slot_stats->max_us = value;
+  }
+  else
+  {
+    slot_stats->min_us = (value < slot_stats->min_us) ? value : slot_stats->min_us;
+    slot_stats->max_us = (value > slot_stats->max_us) ? value : slot_stats->max_us;
+  }
+
+  // Halving both keeps the mean and lets it follow recent runs, at least one run stays counted
+  if(UINT16_MAX == slot_stats->runs || UINT32_MAX - slot_stats->total_us < value)
+  {
+    slot_stats->total_us /= 2u;
+    slot_stats->runs = (uint16_t)((slot_stats->runs + 1u) / 2u);
+  }
+  slot_stats->total_us += value;
+  slot_stats->runs++;
+
+  if(value > limit && UINT16_MAX != slot_stats->overruns)
+  {
+    slot_stats->overruns++;
+  }
+}
+
+const profiling_stats_ts *profiling_getStats(uint8_t group, uint8_t index)
+{
+  uint8_t slot = findSlot(group, index);
+  return (PROFILING_NUM_OF_SLOTS > slot) ? &stats[slot] : nullptr;
+}
+
+void profiling_reset()
+{
+  memset(stats, 0, sizeof(stats));
+}
+
+void profiling_handleCommand(const uint8_t *payload, size_t payload_len)
+{
+  if(PROFILING_CMD_DUMP == payload[0] && PROFILING_CMD_DUMP_SIZE == payload_len)
+  {
+    reset_after_dump = (0u != payload[1]) ? PROFILING_RESET_AFTER_DUMP : PROFILING_KEEP_AFTER_DUMP;
+    dump_slot = 0u;
+    dump_frame_ready = PROFILING_FRAME_NOT_READY;
+    dump_active = PROFILING_DUMP_ACTIVE;
+  }
+}
+
+uint8_t *profiling_peekDumpFrame(size_t *payload_len)
+{
+  if(PROFILING_DUMP_ACTIVE != dump_active)
+  {
+    return nullptr;
+  }
+
+  if(PROFILING_FRAME_READY != dump_frame_ready)
+  {
+    // Slots which never ran are not sent
+    while(PROFILING_NUM_OF_SLOTS > dump_slot && PROFILING_NO_RUNS == stats[dump_slot].runs)
+    {
+      dump_slot++;
+    }
+
+    if(PROFILING_NUM_OF_SLOTS > dump_slot)
+    {
+      buildStatsFrame(dump_slot);
+    }
+    else
+    {
+      dump_frame[0] = PROFILING_FRAME_END;
+    }
+    dump_frame_ready = PROFILING_FRAME_READY;
+  }
+
+  *payload_len = (PROFILING_FRAME_STATS == dump_frame[0]) ? PROFILING_FRAME_STATS_SIZE : PROFILING_FRAME_END_SIZE;
+  return dump_frame;
+}
+
+void profiling_releaseDumpFrame()
+{
+  if(PROFILING_FRAME_END == dump_frame[0])
+  {
+    dump_active = PROFILING_DUMP_INACTIVE;
+    if(PROFILING_RESET_AFTER_DUMP == reset_after_dump)
+    {
+      profiling_reset();
+    }
+  }
+  else
+  {
+    dump_slot++;
+  }
+  dump_frame_ready = PROFILING_FRAME_NOT_READY;
+}
+
+bool profiling_isDumpActive()
+{
+  return dump_active;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t findSlot(uint8_t group, uint8_t index)
+{
+  if(PROFILING_GROUP_TASKS == group && PROFILING_MAX_TASKS > index)
+  {
+    return index;
+  }
+  if(PROFILING_GROUP_SENSORS == group && PROFILING_MAX_SENSORS > index)
+  {
+    return (uint8_t)(PROFILING_MAX_TASKS + index);
+  }
+  if(PROFILING_GROUP_BENCHMARKS == group && PROFILING_MAX_BENCHMARKS > index)
+  {
+    return (uint8_t)(PROFILING_MAX_TASKS + PROFILING_MAX_SENSORS + index);
+  }
+  return PROFILING_NUM_OF_SLOTS;
+}
+
+static void buildStatsFrame(uint8_t slot)
+{
+  const profiling_stats_ts *slot_stats = &stats[slot];
+
+  dump_frame[0] = PROFILING_FRAME_STATS;
+  if(PROFILING_MAX_TASKS > slot)
+  {
+    dump_frame[1] = PROFILING_GROUP_TASKS;
+    dump_frame[2] = slot;
+  }
+  else if(PROFILING_MAX_TASKS + PROFILING_MAX_SENSORS > slot)
+  {
+    dump_frame[1] = PROFILING_GROUP_SENSORS;
+    dump_frame[2] = (uint8_t)(slot - PROFILING_MAX_TASKS);
+  }
+  else
+  {
+    dump_frame[1] = PROFILING_GROUP_BENCHMARKS;
+    dump_frame[2] = (uint8_t)(slot - PROFILING_MAX_TASKS - PROFILING_MAX_SENSORS);
+  }
+  serial_frame_putU16(&dump_frame[3], slot_stats->runs);
+  serial_frame_putU16(&dump_frame[5], slot_stats->overruns);
+  serial_frame_putU32(&dump_frame[7], slot_stats->min_us);
+  serial_frame_putU32(&dump_frame[11], slot_stats->max_us);
+  serial_frame_putU32(&dump_frame[15], slot_stats->total_us / slot_stats->runs);
+}
+/* *************************************** */
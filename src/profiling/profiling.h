@@ -0,0 +1,166 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <Arduino.h>
+#include "../project_settings.h"
+#include "../output/serial_console/serial_frame.h"
+
+/**
+ * @file profiling.h
+ * @brief Execution time statistics of the tasks, of the sensor read functions and of the benchmarks.
+ *
+ * Every profiled call keeps the number of runs, the shortest, longest and mean execution time and the
+ * number of runs longer than the budget given by the caller (overruns). Times are measured with micros()
+ * (4 us resolution), Timer1 is not free since it generates the MQ7 heater PWM. Compiled out with
+ * PROFILING_START() and PROFILING_STOP() unless PROFILING_COMPONENT is enabled.
+ * Benchmarks which run once at init record their own values with profiling_recordValue(), for example the
+ * CPU cycles of one conversion, their unit is given with the index of the benchmark.
+ *
+ * Dump protocol (binary frames of serial_frame.h, all fields little endian):
+ *  - host -> station DUMP:  type, reset flag (u8, non-zero clears the statistics after the dump)
+ *  - station -> host STATS: type, group, index, runs (u16), overruns (u16), min, max and mean time (u32, us, the unit of the slot for a benchmark)
+ *  - station -> host END:   type
+ * Only slots which ran at least once are sent, one frame per call of the outputs background.
+ */
+
+/* Groups of the profiled calls, the index is the task ID, the catalog index of the sensor or PROFILING_BENCHMARK_* */
+#define PROFILING_GROUP_TASKS           (uint8_t)(0u)
+#define PROFILING_GROUP_SENSORS         (uint8_t)(1u)
+#define PROFILING_GROUP_BENCHMARKS      (uint8_t)(2u)
+#define PROFILING_NUM_OF_GROUPS         (uint8_t)(3u)
+
+/* Benchmarks of the MQ135 and MQ7 ppm lookup tables (see mq_lut.h), cycles of one conversion and the relative error in ppm */
+#define PROFILING_BENCHMARK_MQ135_LOOKUP_CYCLES   (uint8_t)(0u)
+#define PROFILING_BENCHMARK_MQ135_POWF_CYCLES     (uint8_t)(1u)
+#define PROFILING_BENCHMARK_MQ135_ERROR_PPM       (uint8_t)(2u)
+#define PROFILING_BENCHMARK_MQ7_LOOKUP_CYCLES     (uint8_t)(3u)
+#define PROFILING_BENCHMARK_MQ7_POWF_CYCLES       (uint8_t)(4u)
+#define PROFILING_BENCHMARK_MQ7_ERROR_PPM         (uint8_t)(5u)
+
+/* Number of slots of every group */
+#define PROFILING_MAX_TASKS             (uint8_t)(12u)
+#define PROFILING_MAX_SENSORS           (uint8_t)(16u)
+#define PROFILING_MAX_BENCHMARKS        (uint8_t)(6u)
+#define PROFILING_NUM_OF_SLOTS          (uint8_t)(PROFILING_MAX_TASKS + PROFILING_MAX_SENSORS + PROFILING_MAX_BENCHMARKS)
+
+/* Frame types of the dump protocol, the data log export uses 0x10..0x1F */
+#define PROFILING_CMD_DUMP              (uint8_t)(0x20u)
+#define PROFILING_FRAME_STATS           (uint8_t)(0x21u)
+#define PROFILING_FRAME_END             (uint8_t)(0x22u)
+
+/* Payload sizes of the dump frames */
+#define PROFILING_CMD_DUMP_SIZE         (uint8_t)(2u)
+#define PROFILING_FRAME_STATS_SIZE      (uint8_t)(19u)
+#define PROFILING_FRAME_END_SIZE        (uint8_t)(1u)
+/* Room for the CRC of the frame, which is appended by the framing */
+#define PROFILING_FRAME_CRC_SIZE        (uint8_t)(SERIAL_FRAME_CRC_SIZE)
+
+/* Value of the counters of a call which did not run yet */
+#define PROFILING_NO_RUNS               (uint16_t)(0u)
+
+/* Flags indicating if a dump is running */
+#define PROFILING_DUMP_ACTIVE           (bool)(true)
+#define PROFILING_DUMP_INACTIVE         (bool)(false)
+
+/* Flags indicating if the dump frame is ready to be sent */
+#define PROFILING_FRAME_READY           (bool)(true)
+#define PROFILING_FRAME_NOT_READY       (bool)(false)
+
+/* Flags selecting if the statistics are cleared after the dump */
+#define PROFILING_RESET_AFTER_DUMP      (bool)(true)
+#define PROFILING_KEEP_AFTER_DUMP       (bool)(false)
+
+/* Hooks around a profiled call, expand to nothing without PROFILING_COMPONENT */
+#ifdef PROFILING_COMPONENT
+#define PROFILING_START(start_micros)                          uint32_t start_micros = micros()
+#define PROFILING_STOP(group, index, start_micros, budget_us)  profiling_record((group), (index), (start_micros), (budget_us))
+#else
+#define PROFILING_START(start_micros)
+#define PROFILING_STOP(group, index, start_micros, budget_us)
+#endif
+
+/**
+ * @brief Structure with the execution time statistics of one profiled call.
+ *
+ * Members:
+ *  - min_us: Shortest execution time in microseconds, valid after the first run.
+ *  - max_us: Longest execution time in microseconds.
+ *  - total_us: Sum of the execution times of the counted runs, halved together with runs before either overflows.
+ *  - runs: Number of runs the total is taken over, PROFILING_NO_RUNS before the first run.
+ *  - overruns: Number of runs longer than the budget, saturates at UINT16_MAX.
+ */
+typedef struct
+{
+  uint32_t min_us;
+  uint32_t max_us;
+  uint32_t total_us;
+  uint16_t runs;
+  uint16_t overruns;
+} profiling_stats_ts;
+
+/**
+ * @brief Adds one run to the statistics of a profiled call, use PROFILING_STOP() instead of calling it directly.
+ *
+ * @param group PROFILING_GROUP_TASKS or PROFILING_GROUP_SENSORS, other groups are ignored.
+ * @param index Index in the group, indexes above the size of the group are ignored.
+ * @param start_micros Value of micros() before the call.
+ * @param budget_us Longest execution time which is not counted as an overrun.
+ */
+void profiling_record(uint8_t group, uint8_t index, uint32_t start_micros, uint32_t budget_us);
+
+/**
+ * @brief Adds one run with a value measured by the caller, the statistics are kept as for a duration.
+ *
+ * @param group Group of the slot, PROFILING_GROUP_BENCHMARKS for the benchmarks.
+ * @param index Index in the group, indexes above the size of the group are ignored.
+ * @param value Measured value, in the unit of the slot.
+ * @param limit Largest value which is not counted as an overrun.
+ */
+void profiling_recordValue(uint8_t group, uint8_t index, uint32_t value, uint32_t limit);
+
+/**
+ * @brief Returns the statistics of a profiled call.
+ *
+ * @param group PROFILING_GROUP_TASKS, PROFILING_GROUP_SENSORS or PROFILING_GROUP_BENCHMARKS.
+ * @param index Index in the group.
+ * @return const profiling_stats_ts* Statistics of the call, nullptr for an invalid group or index.
+ */
+const profiling_stats_ts *profiling_getStats(uint8_t group, uint8_t index);
+
+/**
+ * @brief Clears the statistics of every profiled call.
+ */
+void profiling_reset();
+
+/**
+ * @brief Handles a frame received from the host, DUMP starts a new dump (a running one is restarted).
+ *
+ * Other frames are ignored.
+ *
+ * @param payload Payload of the received frame.
+ * @param payload_len Number of payload bytes.
+ */
+void profiling_handleCommand(const uint8_t *payload, size_t payload_len);
+
+/**
+ * @brief Returns the next frame of the dump.
+ *
+ * @param payload_len Receives the number of payload bytes.
+ * @return uint8_t* Payload with PROFILING_FRAME_CRC_SIZE free bytes after it, nullptr if no dump is running.
+ *         The frame stays ready until profiling_releaseDumpFrame() is called.
+ */
+uint8_t *profiling_peekDumpFrame(size_t *payload_len);
+
+/**
+ * @brief Releases the dump frame after it was queued for transmission, so the next slot can be sent.
+ */
+void profiling_releaseDumpFrame();
+
+/**
+ * @brief Checks if a dump is running.
+ *
+ * @return true (PROFILING_DUMP_ACTIVE) if a dump is running, false otherwise.
+ */
+bool profiling_isDumpActive();
+
+#endif
@@ -16,10 +16,22 @@
  * Make sure to enable communication protocol which the display uses (I2C for example).
  */
 #define LCD_DISPLAY_COMPONENT               (uint8_t)(1u)
+
+/**
+ * Uncomment if an I2C EEPROM or FRAM is used for logging the sensor readings (for example 24LC256).
+ * Make sure that the memory is connected to the I2C bus and its size matches data_log_config.h.
+ */
+// #define DATA_LOG_COMPONENT                  (uint8_t)(2u)
+
+/**
+ * Uncomment if a LoRa transceiver is used for the telemetry of a remote station (for example RFM95W).
+ * Make sure that the module is connected to the hardware SPI and its channel matches radio_config.h.
+ */
+// #define RADIO_COMPONENT                     (uint8_t)(3u)
 /* ********************************* */
 
 /* INPUT HARDWARE COMPONENTS */
-/* SENSOR COMPONENTS - Comment out if sensor is not used */
+/* SENSOR COMPONENTS - Comment out if sensor is not used, driver and catalog entries are compiled only for the enabled ones. IDs must be unique, see control.cpp */
 #define DHT11_COMPONENT                     (uint8_t)(0u)    
 #define BMP280_COMPONENT                    (uint8_t)(1u)
 #define BH1750_COMPONENT                    (uint8_t)(2u)
@@ -35,6 +47,65 @@
  * Make sure that the RTC is properly connected and configured.
  */
 #define RTC_COMPONENT                       (uint8_t)(0u)
+
+/**
+ * Uncomment to build a gateway which receives the LoRa packets of the stations and forwards their readings
+ * to the host over the serial console. Needs the serial console and a board with more SRAM (Mega 2560),
+ * the transceiver is connected as for RADIO_COMPONENT, which can not be used at the same time.
+ */
+// #define GATEWAY_COMPONENT                   (uint8_t)(1u)
+/* ********************************* */
+
+/* OTHER COMPONENTS */
+/**
+ * Uncomment to add the dew point and the heat index (with DHT11) and the sea-level pressure (with BMP280) to the catalog.
+ * They are computed in integer math from the cached readings, only when an input has a new sample. The altitude
+ * of the station is set in sensors_config.h. A derived measurement has a cache entry but no filter, about 40 bytes of SRAM.
+ * The three of them do not fit the Uno next to the other default components, disable HISTORY_COMPONENT or two sampled
+ * sensors (e.g. MQ7_COMPONENT and GYML8511_COMPONENT) to use them, the SRAM budget check in control.cpp confirms the choice.
+ */
+// #define DERIVED_SENSORS_COMPONENT
+
+/**
+ * Uncomment to keep a history (ring of the latest samples, minute and hour min/max/mean) of the value measurements
+ * whose trend is shown on the view, see history.cpp. Takes about 80 bytes of SRAM per measurement, up to
+ * HISTORY_MAX_FOOTPRINT_BYTES, which the Uno has left with the other default components.
+ */
+#define HISTORY_COMPONENT
+
+/**
+ * Uncomment to measure the execution time (min/max/mean and overruns) of every task and sensor read function and to
+ * benchmark the MQ135 and MQ7 lookup tables against powf() at init.
+ * Statistics are dumped on request of the host over the serial console. Takes 16 bytes of SRAM per task, sensor and benchmark.
+ */
+// #define PROFILING_COMPONENT
+
+/**
+ * Uncomment to paint the free SRAM at boot and track the high-water marks of the stack and the heap.
+ * Low free SRAM is reported as an error, the marks are sent on request of the host over the serial console.
+ */
+#define MEMORY_MONITOR_COMPONENT
+
+/**
+ * Uncomment to supervise every task with the AVR watchdog. A task which runs longer than its timeout resets
+ * the station, the task and the device it was talking to are reported after the reset and a device which
+ * hangs the station repeatedly is skipped at the next boot.
+ */
+#define WATCHDOG_COMPONENT
+
+/**
+ * Uncomment to stop the clocks of the unused peripherals at boot and to sleep in power-save between the
+ * RTC ticks. Power-save is used only with the RTC and without the MQ7 and the serial console, whose
+ * Timer1 and USART stop in power-save. The scheduler sleeps in the idle mode otherwise.
+ */
+#define POWER_SAVE_COMPONENT
+
+/**
+ * Uncomment to let the host change the sample periods, the outputs of the tasks and the mode of the boot scan
+ * over the serial console and to keep them in the EEPROM. The host may also trigger an I2C scan, the calibration
+ * of the MQ sensors and a dump of the statistics. The firmware values are used otherwise.
+ */
+#define SETTINGS_COMPONENT
 /* ********************************* */
 /* ********************************* */
 
@@ -0,0 +1,275 @@
+#include "settings.h"
+
+/* STATIC GLOBAL VARIABLES */
+static settings_record_ts settings =
+{
+  {},
+  {SETTINGS_DEFAULT_OUTPUTS_I2C_SCAN, SETTINGS_DEFAULT_OUTPUTS_SAMPLE, SETTINGS_DEFAULT_OUTPUTS_SNAPSHOT, SETTINGS_DEFAULT_OUTPUTS_VIEW},
+  SETTINGS_DEFAULT_I2C_SCAN_MODE,
+  SENSORS_CATALOG_NUM_OF_SENSORS,
+  SETTINGS_RECORD_MAGIC,
+  0u
+};
+
+// Written by the host commands, cleared by the task which takes the trigger
+static uint8_t pending_triggers[SETTINGS_NUM_OF_TRIGGERS];
+
+static bool answer_requested = SETTINGS_NO_ANSWER_REQUEST;
+static uint8_t answer_command = SETTINGS_CMD_STATUS;
+static uint8_t answer_result = SETTINGS_RESULT_ACCEPTED;
+static uint8_t answer_frame[SETTINGS_FRAME_STATUS_SIZE + SETTINGS_FRAME_CRC_SIZE];
+/* *************************************** */
+
+/* COMPILE TIME CHECKS */
+static_assert(SETTINGS_EEPROM_END <= PLATFORM_EEPROM_SIZE, "Settings record does not fit the EEPROM");
+static_assert(SETTINGS_FRAME_ACK_SIZE <= SETTINGS_FRAME_STATUS_SIZE, "Answer frame must hold the ACK frame");
+static_assert(SETTINGS_NUM_OF_OUTPUT_GROUPS == sizeof(settings.outputs) / sizeof(settings.outputs[0]), "Every output group needs its outputs in the record");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Handles SET_PERIOD, the new period is saved and the sampling is told to follow it.
+ *
+ * @param payload Payload of the command.
+ * @return uint8_t SETTINGS_RESULT_ACCEPTED or SETTINGS_RESULT_REJECTED for an unknown sensor or a period out of range.
+ */
+static uint8_t setPeriod(const uint8_t *payload);
+
+/**
+ * @brief Handles SET_OUTPUT, the new outputs are saved.
+ *
+ * @param payload Payload of the command.
+ * @return uint8_t SETTINGS_RESULT_ACCEPTED or SETTINGS_RESULT_REJECTED for an unknown group.
+ */
+static uint8_t setOutput(const uint8_t *payload);
+
+/**
+ * @brief Handles TRIGGER_SCAN, the mode is saved as the mode of the boot scan and the scan is requested.
+ *
+ * @param payload Payload of the command.
+ * @return uint8_t SETTINGS_RESULT_ACCEPTED or SETTINGS_RESULT_REJECTED if the mode is not a scan of several devices.
+ */
+static uint8_t triggerScan(const uint8_t *payload);
+
+/**
+ * @brief Notes an action for the tasks.
+ *
+ * @param trigger SETTINGS_TRIGGER_*.
+ * @return uint8_t Always SETTINGS_RESULT_ACCEPTED.
+ */
+static uint8_t requestTrigger(uint8_t trigger);
+
+/**
+ * @brief Writes the settings into the EEPROM, unchanged bytes are not written again.
+ */
+static void saveRecord();
+
+/**
+ * @brief Fills the status frame into the answer frame.
+ *
+ * @return size_t Number of payload bytes.
+ */
+static size_t buildStatusFrame();
+
+/**
+ * @brief Computes the check byte of a record.
+ *
+ * @param record Record, its check byte is not included.
+ * @return uint8_t Check byte.
+ */
+static uint8_t recordCheck(const settings_record_ts *record);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void settings_init()
+{
+  settings_record_ts record;
+  PLATFORM_EEPROM_READ(&record, SETTINGS_EEPROM_ADDRESS, sizeof(record));
+  // Periods of another catalog would belong to other measurements
+  if(SETTINGS_RECORD_MAGIC == record.magic && recordCheck(&record) == record.check &&
+     SENSORS_CATALOG_NUM_OF_SENSORS == record.num_of_sensors && I2C_SCAN_IS_MULTI_DEVICE_SCAN(record.i2c_scan_mode))
+  {
+    settings = record;
+  }
+
+  for (uint8_t index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; index < SENSORS_SNAPSHOT_CAPACITY; index++)
+  {
+    sensors_interface_setSamplePeriod(index, settings.sample_periods_s[index]);
+  }
+}
+
+output_destination_t settings_getOutputs(uint8_t group)
+{
+  return (SETTINGS_NUM_OF_OUTPUT_GROUPS > group) ? settings.outputs[group] : NO_OUTPUTS;
+}
+
+uint8_t settings_getI2CScanMode()
+{
+  return settings.i2c_scan_mode;
+}
+
+bool settings_takeTrigger(uint8_t trigger)
+{
+  if(SETTINGS_NUM_OF_TRIGGERS <= trigger || SETTINGS_TRIGGER_PENDING != PLATFORM_LOAD_ACQUIRE(&pending_triggers[trigger]))
+  {
+    return false;
+  }
+  PLATFORM_STORE_RELEASE(&pending_triggers[trigger], SETTINGS_TRIGGER_NOT_PENDING);
+  return true;
+}
+
+void settings_handleCommand(const uint8_t *payload, size_t payload_len)
+{
+  uint8_t result = SETTINGS_RESULT_REJECTED;
+
+  if(SETTINGS_CMD_STATUS == payload[0] && SETTINGS_CMD_STATUS_SIZE == payload_len)
+  {
+    result = SETTINGS_RESULT_ACCEPTED;
+  }
+  else if(SETTINGS_CMD_SET_PERIOD == payload[0] && SETTINGS_CMD_SET_PERIOD_SIZE == payload_len)
+  {
+    result = setPeriod(payload);
+  }
+  else if(SETTINGS_CMD_SET_OUTPUT == payload[0] && SETTINGS_CMD_SET_OUTPUT_SIZE == payload_len)
+  {
+    result = setOutput(payload);
+  }
+  else if(SETTINGS_CMD_DUMP_STATS == payload[0] && SETTINGS_CMD_DUMP_STATS_SIZE == payload_len)
+  {
+    result = requestTrigger(SETTINGS_TRIGGER_DUMP_STATS);
+  }
+  else if(SETTINGS_CMD_TRIGGER_SCAN == payload[0] && SETTINGS_CMD_TRIGGER_SCAN_SIZE == payload_len)
+  {
+    result = triggerScan(payload);
+  }
+  else if(SETTINGS_CMD_TRIGGER_CALIBRATE == payload[0] && SETTINGS_CMD_TRIGGER_CALIBRATE_SIZE == payload_len)
+  {
+    result = requestTrigger(SETTINGS_TRIGGER_CALIBRATE);
+  }
+  else
+  {
+    return; // Frame of another module
+  }
+
+  answer_command = payload[0];
+  answer_result = result;
+  answer_requested = SETTINGS_ANSWER_REQUESTED;
+}
+
+uint8_t *settings_peekAnswerFrame(size_t *payload_len)
+{
+  if(SETTINGS_ANSWER_REQUESTED != answer_requested)
+  {
+    return nullptr;
+  }
+
+  if(SETTINGS_CMD_STATUS == answer_command)
+  {
+    *payload_len = buildStatusFrame(); // Built when it is sent, so it is up to date
+  }
+  else
+  {
+    answer_frame[0] = SETTINGS_FRAME_ACK;
+    answer_frame[1] = answer_command;
+    answer_frame[2] = answer_result;
+    *payload_len = SETTINGS_FRAME_ACK_SIZE;
+  }
+  return answer_frame;
+}
+
+void settings_releaseAnswerFrame()
+{
+  answer_requested = SETTINGS_NO_ANSWER_REQUEST;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t setPeriod(const uint8_t *payload)
+{
+  uint8_t index = sensors_interface_sensorIdToIndex(payload[1]);
+  uint16_t period_s = serial_frame_getU16(&payload[2]);
+  if(SENSORS_SNAPSHOT_CAPACITY <= index || SETTINGS_MAX_PERIOD_S < period_s)
+  {
+    return SETTINGS_RESULT_REJECTED;
+  }
+
+  settings.sample_periods_s[index] = period_s;
+  sensors_interface_setSamplePeriod(index, period_s);
+  saveRecord();
+  return requestTrigger(SETTINGS_TRIGGER_PERIODS_CHANGED);
+}
+
+static uint8_t setOutput(const uint8_t *payload)
+{
+  uint8_t group = payload[1];
+  if(SETTINGS_NUM_OF_OUTPUT_GROUPS <= group)
+  {
+    return SETTINGS_RESULT_REJECTED;
+  }
+
+  settings.outputs[group] = (output_destination_t)serial_frame_getU16(&payload[2]);
+  saveRecord();
+  return SETTINGS_RESULT_ACCEPTED;
+}
+
+static uint8_t triggerScan(const uint8_t *payload)
+{
+  uint8_t scan_mode = payload[1];
+  if(!I2C_SCAN_IS_MULTI_DEVICE_SCAN(scan_mode))
+  {
+    return SETTINGS_RESULT_REJECTED;
+  }
+
+  settings.i2c_scan_mode = scan_mode;
+  saveRecord();
+  return requestTrigger(SETTINGS_TRIGGER_I2C_SCAN);
+}
+
+static uint8_t requestTrigger(uint8_t trigger)
+{
+  PLATFORM_STORE_RELEASE(&pending_triggers[trigger], SETTINGS_TRIGGER_PENDING);
+  return SETTINGS_RESULT_ACCEPTED;
+}
+
+static void saveRecord()
+{
+  settings.check = recordCheck(&settings);
+  PLATFORM_EEPROM_UPDATE(SETTINGS_EEPROM_ADDRESS, &settings, sizeof(settings));
+}
+
+static size_t buildStatusFrame()
+{
+  answer_frame[0] = SETTINGS_FRAME_STATUS;
+  serial_frame_putU32(&answer_frame[1], PLATFORM_MILLIS());
+  answer_frame[5] = settings.i2c_scan_mode;
+  answer_frame[6] = (SENSORS_CALIBRATION_ACTIVE == sensors_calibration_isActive()) ? 1u : 0u;
+  size_t payload_len = 7u;
+  for (uint8_t group = 0u; group < SETTINGS_NUM_OF_OUTPUT_GROUPS; group++)
+  {
+    serial_frame_putU16(&answer_frame[payload_len], settings.outputs[group]);
+    payload_len += sizeof(output_destination_t);
+  }
+
+  uint8_t num_of_sensors = (uint8_t)sensors_interface_getSensorsLen();
+  answer_frame[payload_len] = num_of_sensors;
+  payload_len++;
+  for (uint8_t index = SENSORS_INTERFACE_FIRST_SENSOR_INDEX; index < num_of_sensors; index++)
+  {
+    answer_frame[payload_len] = sensors_interface_sensorIndexToId(index);
+    serial_frame_putU16(&answer_frame[payload_len + 1u], (uint16_t)(sensors_interface_getSamplePeriod(index) / SENSORS_INTERFACE_MS_PER_SECOND));
+    payload_len += SETTINGS_FRAME_STATUS_ENTRY_SIZE;
+  }
+  return payload_len;
+}
+
+static uint8_t recordCheck(const settings_record_ts *record)
+{
+  const uint8_t *bytes = (const uint8_t *)record;
+  uint8_t check = 0u;
+  for (uint8_t i = 0u; i < offsetof(settings_record_ts, check); i++)
+  {
+    check ^= bytes[i];
+  }
+  return (uint8_t)~check; // All zero record is not valid
+}
+/* *************************************** */
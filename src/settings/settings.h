@@ -0,0 +1,187 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <Arduino.h>
+#include "../platform/platform.h"
+#include "../control/control_types.h"
+#include "../input/sensors/sensors_interface/sensors_interface.h"
+#include "../input/sensors/sensors_calibration/sensors_calibration.h"
+#include "../output/serial_console/serial_frame.h"
+
+/**
+ * @file settings.h
+ * @brief Settings which the host changes at runtime over the serial console, kept in the EEPROM.
+ *
+ * The sample period of every measurement, the outputs of the tasks and the mode of the I2C scan at boot
+ * start with the values of the firmware and may be changed by the host without reflashing. The periods
+ * are handed to the sensors interface (sensors_interface_setSamplePeriod()). Every accepted
+ * change is written into the EEPROM right away (only the changed bytes, a few milliseconds each) and
+ * loaded by settings_init() on every following boot. The actions requested by the host (scan, calibration,
+ * statistics) are only noted, the tasks take them with settings_takeTrigger().
+ * Without SETTINGS_COMPONENT settings_init() is not called and every getter returns the firmware value.
+ *
+ * Command protocol (binary frames of serial_frame.h, all fields little endian):
+ *  - host -> station STATUS:            type
+ *  - host -> station SET_PERIOD:        type, sensor ID, period (u16, seconds, SETTINGS_CATALOG_PERIOD for the period of the catalog)
+ *  - host -> station SET_OUTPUT:        type, output group (SETTINGS_OUTPUTS_*), outputs (u16, output_destination_t)
+ *  - host -> station DUMP_STATS:        type, starts the profiling dump and the memory report
+ *  - host -> station TRIGGER_SCAN:      type, scan mode (I2C_SCAN_MODE_*), which is kept as the mode of the boot scan
+ *  - host -> station TRIGGER_CALIBRATE: type, starts the R0 calibration of the MQ sensors
+ *  - station -> host ACK:               type, type of the command, result (SETTINGS_RESULT_*)
+ *  - station -> host STATUS:            type, uptime (u32, ms), boot scan mode, calibration active, outputs of every
+ *                                       group (u16), number of sensors, then for every sensor: sensor ID, period (u16, seconds)
+ */
+
+/* Frame types of the command protocol, the gateway batches use 0x30 */
+#define SETTINGS_CMD_STATUS                   (uint8_t)(0x38u)
+#define SETTINGS_CMD_SET_PERIOD               (uint8_t)(0x39u)
+#define SETTINGS_CMD_SET_OUTPUT               (uint8_t)(0x3Au)
+#define SETTINGS_CMD_DUMP_STATS               (uint8_t)(0x3Bu)
+#define SETTINGS_CMD_TRIGGER_SCAN             (uint8_t)(0x3Cu)
+#define SETTINGS_CMD_TRIGGER_CALIBRATE        (uint8_t)(0x3Du)
+#define SETTINGS_FRAME_ACK                    (uint8_t)(0x3Eu)
+#define SETTINGS_FRAME_STATUS                 (uint8_t)(0x3Fu)
+
+/* Payload sizes of the command frames */
+#define SETTINGS_CMD_STATUS_SIZE              (uint8_t)(1u)
+#define SETTINGS_CMD_SET_PERIOD_SIZE          (uint8_t)(4u)
+#define SETTINGS_CMD_SET_OUTPUT_SIZE          (uint8_t)(4u)
+#define SETTINGS_CMD_DUMP_STATS_SIZE          (uint8_t)(1u)
+#define SETTINGS_CMD_TRIGGER_SCAN_SIZE        (uint8_t)(2u)
+#define SETTINGS_CMD_TRIGGER_CALIBRATE_SIZE   (uint8_t)(1u)
+#define SETTINGS_FRAME_ACK_SIZE               (uint8_t)(3u)
+#define SETTINGS_FRAME_STATUS_HEADER_SIZE     (uint8_t)(8u + 2u * SETTINGS_NUM_OF_OUTPUT_GROUPS)
+#define SETTINGS_FRAME_STATUS_ENTRY_SIZE      (uint8_t)(3u)
+#define SETTINGS_FRAME_STATUS_SIZE            (uint8_t)(SETTINGS_FRAME_STATUS_HEADER_SIZE + SENSORS_SNAPSHOT_CAPACITY * SETTINGS_FRAME_STATUS_ENTRY_SIZE)
+/* Room for the CRC of the frame, which is appended by the framing */
+#define SETTINGS_FRAME_CRC_SIZE               (uint8_t)(SERIAL_FRAME_CRC_SIZE)
+
+/* Results of a command in the ACK frame */
+#define SETTINGS_RESULT_ACCEPTED              (uint8_t)(0u)
+#define SETTINGS_RESULT_REJECTED              (uint8_t)(1u) /* Unknown sensor, group or mode, or period out of range */
+
+/* Output groups, one per kind of task which routes data */
+#define SETTINGS_OUTPUTS_I2C_SCAN             (uint8_t)(0u)
+#define SETTINGS_OUTPUTS_SAMPLE               (uint8_t)(1u)
+#define SETTINGS_OUTPUTS_SNAPSHOT             (uint8_t)(2u)
+#define SETTINGS_OUTPUTS_VIEW                 (uint8_t)(3u)
+#define SETTINGS_NUM_OF_OUTPUT_GROUPS         (uint8_t)(4u)
+
+/* Outputs of the groups in the firmware */
+#define SETTINGS_DEFAULT_OUTPUTS_I2C_SCAN     (output_destination_t)(ALL_OUTPUTS)
+#define SETTINGS_DEFAULT_OUTPUTS_SAMPLE       (output_destination_t)(ALL_TIME_INDEPENDENT_OUTPUTS)
+#define SETTINGS_DEFAULT_OUTPUTS_SNAPSHOT     (output_destination_t)(ALL_TIME_INDEPENDENT_OUTPUTS)
+#define SETTINGS_DEFAULT_OUTPUTS_VIEW         (output_destination_t)(LCD_DISPLAY)
+
+/**
+ * I2C scan done at boot. Known devices are probed in milliseconds and only reported,
+ * set to I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES to probe every address and present each found device.
+ */
+#define SETTINGS_DEFAULT_I2C_SCAN_MODE        (uint8_t)(I2C_SCAN_MODE_SCAN_FOR_KNOWN_DEVICES)
+
+/* Period of a measurement which follows the period of the catalog */
+#define SETTINGS_CATALOG_PERIOD               (uint16_t)(SENSORS_INTERFACE_CATALOG_PERIOD)
+/* Longest period the host may set, 12 hours */
+#define SETTINGS_MAX_PERIOD_S                 (uint16_t)(43200u)
+
+/* Location of the record in the EEPROM, behind the calibration of the MQ sensors */
+#define SETTINGS_EEPROM_ADDRESS               (uint16_t)(SENSORS_CALIBRATION_EEPROM_END)
+#define SETTINGS_EEPROM_END                   (uint16_t)(SETTINGS_EEPROM_ADDRESS + sizeof(settings_record_ts))
+
+/* Marks a written record, changed whenever the layout of the record changes */
+#define SETTINGS_RECORD_MAGIC                 (uint8_t)(0x5Au)
+
+/* Actions requested by the host, taken by the tasks */
+#define SETTINGS_TRIGGER_I2C_SCAN             (uint8_t)(0u)
+#define SETTINGS_TRIGGER_CALIBRATE            (uint8_t)(1u)
+#define SETTINGS_TRIGGER_DUMP_STATS           (uint8_t)(2u)
+#define SETTINGS_TRIGGER_PERIODS_CHANGED      (uint8_t)(3u) /* Deadlines of the sampling follow the new periods */
+#define SETTINGS_NUM_OF_TRIGGERS              (uint8_t)(4u)
+
+/* Flags of the pending triggers */
+#define SETTINGS_TRIGGER_PENDING              (uint8_t)(1u)
+#define SETTINGS_TRIGGER_NOT_PENDING          (uint8_t)(0u)
+
+/* Flags indicating if an answer waits for the host */
+#define SETTINGS_ANSWER_REQUESTED             (bool)(true)
+#define SETTINGS_NO_ANSWER_REQUEST            (bool)(false)
+
+/**
+ * @brief Record of the settings in the EEPROM.
+ *
+ * Members:
+ *  - sample_periods_s: Sample period of every measurement by catalog index, SETTINGS_CATALOG_PERIOD for the period of the catalog.
+ *  - outputs: Outputs of every group (SETTINGS_OUTPUTS_*).
+ *  - i2c_scan_mode: Mode of the I2C scan at boot.
+ *  - num_of_sensors: Number of measurements of the catalog the periods belong to, a record of another firmware is not loaded.
+ *  - magic: SETTINGS_RECORD_MAGIC, an erased EEPROM reads 0xFF.
+ *  - check: Inverted XOR of the other bytes.
+ */
+typedef struct
+{
+  uint16_t sample_periods_s[SENSORS_SNAPSHOT_CAPACITY];
+  output_destination_t outputs[SETTINGS_NUM_OF_OUTPUT_GROUPS];
+  uint8_t i2c_scan_mode;
+  uint8_t num_of_sensors;
+  uint8_t magic;
+  uint8_t check;
+} settings_record_ts;
+
+/**
+ * @brief Loads the settings from the EEPROM and hands the periods to the sensors interface, a missing or damaged record keeps the firmware values.
+ *
+ * Must be called once at boot after PLATFORM_EEPROM_BEGIN() and before the tasks use the settings.
+ */
+void settings_init();
+
+/**
+ * @brief Returns the outputs of a group of tasks.
+ *
+ * @param group SETTINGS_OUTPUTS_*.
+ * @return output_destination_t Outputs set by the host, the outputs of the firmware otherwise, NO_OUTPUTS for an unknown group.
+ */
+output_destination_t settings_getOutputs(uint8_t group);
+
+/**
+ * @brief Returns the mode of the I2C scan at boot, which is also the mode of the last scan triggered by the host.
+ *
+ * @return uint8_t I2C_SCAN_MODE_*.
+ */
+uint8_t settings_getI2CScanMode();
+
+/**
+ * @brief Takes an action requested by the host, the request is cleared.
+ *
+ * Requests are noted by the host commands of the outputs background and taken by the tasks,
+ * a request repeated before it is taken is done once.
+ *
+ * @param trigger SETTINGS_TRIGGER_*.
+ * @return true if the host requested the action since the last call.
+ */
+bool settings_takeTrigger(uint8_t trigger);
+
+/**
+ * @brief Handles a frame received from the host, the commands of the protocol above. Other frames are ignored.
+ *
+ * Every command is answered, STATUS with the status frame and the others with an ACK frame.
+ *
+ * @param payload Payload of the received frame.
+ * @param payload_len Number of payload bytes.
+ */
+void settings_handleCommand(const uint8_t *payload, size_t payload_len);
+
+/**
+ * @brief Returns the answer to the last command of the host.
+ *
+ * @param payload_len Receives the number of payload bytes.
+ * @return uint8_t* Payload with SETTINGS_FRAME_CRC_SIZE free bytes after it, nullptr if no answer is requested.
+ *         The answer stays until settings_releaseAnswerFrame() is called, a newer command replaces it.
+ */
+uint8_t *settings_peekAnswerFrame(size_t *payload_len);
+
+/**
+ * @brief Releases the answer frame after it was queued for transmission.
+ */
+void settings_releaseAnswerFrame();
+
+#endif
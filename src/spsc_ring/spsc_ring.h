@@ -0,0 +1,160 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+#include "../platform/platform.h"
+
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free ring buffer between one producer and one consumer (e.g., an interrupt and the loop).
+ *
+ * The head is written only by the producer and the tail only by the consumer, both run freely over the
+ * 8-bit range and are masked with the size, which is a power of two. An index is published with
+ * PLATFORM_STORE_RELEASE after the entry is written or read, so the other side never sees an index before
+ * the entry behind it. On the AVR an 8-bit access is atomic and neither side needs a critical section, an
+ * interrupt and the loop may use the ring at the same time.
+ * Every function is for one side only, as noted, except spsc_ring_getCount() and spsc_ring_isEmpty().
+ * The ring is a plain aggregate, `{}` (or a static variable) starts it empty.
+ */
+
+/* Largest ring, the number of entries must fit the 8-bit difference of the indexes */
+#define SPSC_RING_MAX_ENTRIES           (uint8_t)(128u)
+
+/* Flags returned by spsc_ring_push() */
+#define SPSC_RING_PUSHED                (bool)(true)
+#define SPSC_RING_FULL                  (bool)(false)
+
+/* Flags returned by spsc_ring_pop() */
+#define SPSC_RING_POPPED                (bool)(true)
+#define SPSC_RING_EMPTY                 (bool)(false)
+
+/**
+ * @brief Ring of num_of_entries entries of entry_t.
+ *
+ * Members:
+ *  - entries: Storage of the entries, indexed by the masked head and tail.
+ *  - head: Number of pushed entries, written by the producer only.
+ *  - tail: Number of popped entries, written by the consumer only.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+struct spsc_ring_ts
+{
+  static_assert(0u < num_of_entries && 0u == (num_of_entries & (num_of_entries - 1u)), "Ring size must be a power of two");
+  static_assert(SPSC_RING_MAX_ENTRIES >= num_of_entries, "Ring size must fit the 8-bit difference of the indexes");
+  entry_t entries[num_of_entries];
+  uint8_t head;
+  uint8_t tail;
+};
+
+/**
+ * @brief Returns the number of entries in the ring, for both sides.
+ *
+ * The count is a snapshot, it only grows for the consumer and only shrinks for the producer.
+ *
+ * @param ring Ring.
+ * @return uint8_t Number of entries which were pushed and not popped yet.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline uint8_t spsc_ring_getCount(const spsc_ring_ts<entry_t, num_of_entries> *ring)
+{
+  return (uint8_t)(PLATFORM_LOAD_ACQUIRE(&ring->head) - PLATFORM_LOAD_ACQUIRE(&ring->tail));
+}
+
+/**
+ * @brief Checks if the ring has no entry, for both sides.
+ *
+ * @param ring Ring.
+ * @return true if every pushed entry was popped.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline bool spsc_ring_isEmpty(const spsc_ring_ts<entry_t, num_of_entries> *ring)
+{
+  return 0u == spsc_ring_getCount(ring);
+}
+
+/**
+ * @brief Copies an entry into the ring, producer only.
+ *
+ * @param ring Ring.
+ * @param entry Entry which is copied.
+ * @return true (SPSC_RING_PUSHED) if the entry was copied, false (SPSC_RING_FULL) if the ring is full.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline bool spsc_ring_push(spsc_ring_ts<entry_t, num_of_entries> *ring, const entry_t *entry)
+{
+  uint8_t head = ring->head;
+  if(num_of_entries <= (uint8_t)(head - PLATFORM_LOAD_ACQUIRE(&ring->tail)))
+  {
+    return SPSC_RING_FULL;
+  }
+  ring->entries[head & (uint8_t)(num_of_entries - 1u)] = *entry;
+  PLATFORM_STORE_RELEASE(&ring->head, (uint8_t)(head + 1u)); // Entry is complete before the consumer sees it
+  return SPSC_RING_PUSHED;
+}
+
+/**
+ * @brief Returns an entry without removing it, consumer only.
+ *
+ * The entry stays valid until it is removed with spsc_ring_drop() or spsc_ring_pop().
+ *
+ * @param ring Ring.
+ * @param offset Position of the entry, 0 is the oldest entry.
+ * @return const entry_t* Entry or nullptr if the ring has not more than offset entries.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline const entry_t *spsc_ring_peek(const spsc_ring_ts<entry_t, num_of_entries> *ring, uint8_t offset)
+{
+  uint8_t tail = ring->tail;
+  if((uint8_t)(PLATFORM_LOAD_ACQUIRE(&ring->head) - tail) <= offset)
+  {
+    return nullptr;
+  }
+  return &ring->entries[(uint8_t)(tail + offset) & (uint8_t)(num_of_entries - 1u)];
+}
+
+/**
+ * @brief Removes the oldest entries, consumer only.
+ *
+ * @param ring Ring.
+ * @param count Number of entries, at most the number of entries in the ring are removed.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline void spsc_ring_drop(spsc_ring_ts<entry_t, num_of_entries> *ring, uint8_t count)
+{
+  uint8_t tail = ring->tail;
+  uint8_t available = (uint8_t)(PLATFORM_LOAD_ACQUIRE(&ring->head) - tail);
+  PLATFORM_STORE_RELEASE(&ring->tail, (uint8_t)(tail + ((count < available) ? count : available))); // Slots are free for the producer again
+}
+
+/**
+ * @brief Removes every entry, consumer only, entries pushed meanwhile may stay.
+ *
+ * @param ring Ring.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline void spsc_ring_clear(spsc_ring_ts<entry_t, num_of_entries> *ring)
+{
+  PLATFORM_STORE_RELEASE(&ring->tail, PLATFORM_LOAD_ACQUIRE(&ring->head));
+}
+
+/**
+ * @brief Copies the oldest entry out of the ring and removes it, consumer only.
+ *
+ * @param ring Ring.
+ * @param entry Receives the entry.
+ * @return true (SPSC_RING_POPPED) if an entry was copied, false (SPSC_RING_EMPTY) if the ring is empty.
+ */
+template <typename entry_t, uint8_t num_of_entries>
+inline bool spsc_ring_pop(spsc_ring_ts<entry_t, num_of_entries> *ring, entry_t *entry)
+{
+  uint8_t tail = ring->tail;
+  if(PLATFORM_LOAD_ACQUIRE(&ring->head) == tail)
+  {
+    return SPSC_RING_EMPTY;
+  }
+  *entry = ring->entries[tail & (uint8_t)(num_of_entries - 1u)];
+  PLATFORM_STORE_RELEASE(&ring->tail, (uint8_t)(tail + 1u)); // Slot is free for the producer again
+  return SPSC_RING_POPPED;
+}
+
+#endif
@@ -1,92 +1,514 @@
 #include "task.h"
 
-static tasks_config_ts tasks_config[] =
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Task which scans the I2C bus in slices and outputs the I2C addresses found on it.
+ *
+ * While the scan is in progress the task is re-scheduled after TASK_I2C_SCAN_SLICE_TIMER,
+ * the found addresses are presented with its regular period. When every address is processed
+ * the task disables itself and enables the sensor sampling and the display view tasks.
+ */
+static void taskI2CAddrRead();
+
+/**
+ * @brief Task which runs the R0 calibration of the MQ gas sensors.
+ *
+ * Enabled after the boot scan when a gas sensor was never calibrated, disables itself when every sensor is evaluated.
+ */
+static void taskCalibrating();
+
+/**
+ * @brief Task which draws the current page of the display view again when a value on it changed.
+ */
+static void taskViewRefresh();
+
+/**
+ * @brief Task which switches the display view to the next page.
+ */
+static void taskViewRotate();
+
+/**
+ * @brief Task which reads all sensors in one sweep and routes the snapshot to time independent outputs.
+ */
+static void taskSensorsSnapshot();
+
+/**
+ * @brief Task which samples every sensor on its own deadline and routes readings to time independent outputs.
+ *
+ * After each run the task is re-scheduled to the nearest per-sensor deadline instead of a fixed period.
+ */
+static void taskSensorSample();
+
+/**
+ * @brief Task which runs the background work of the sensors (time critical samples) and starts the actions requested by the host.
+ *
+ * Enabled from the start, independently of the I2C scan, since the MQ7 heater cycle runs from init.
+ */
+static void taskSensorsLoop();
+
+/**
+ * @brief Task which runs the background work of the outputs (feeding queued serial console lines to the UART).
+ */
+static void taskOutputsLoop();
+
+/**
+ * @brief Task which brings up the components that were still settling after power on.
+ *
+ * Disables itself when no component is pending anymore.
+ */
+static void taskBringUp();
+
+/**
+ * @brief Task which retries the components that failed to initialize.
+ *
+ * Runs with the lowest priority, so it only takes the time left by the sampling tasks.
+ * Enables the bring-up again when a retried component is settling.
+ */
+static void taskRecovery();
+
+/**
+ * @brief Starts the actions which the host requested over the serial console (see settings.h).
+ *
+ * An I2C scan is started unless one is running, a calibration is started over, the sampling of every
+ * measurement starts again right away when a period was changed, so the new period applies from now.
+ */
+static void startHostRequests();
+
+/**
+ * @brief Reports the change of an event driven sensor right away (rain in SENSORS_ARDUINO_RAIN_INTERRUPT mode).
+ *
+ * A changed sensor is sampled and routed to the outputs of the sampling without waiting for its period,
+ * while its output settles the sensors loop is due again at the end of the debounce time.
+ */
+static void startSensorEvents();
+
+/**
+ * @brief Finds the enabled task with the highest priority whose deadline is reached.
+ *
+ * @param current_millis Current time in milliseconds.
+ * @return uint8_t ID of the task or TASK_INVALID_INDEX if no task is due.
+ */
+static uint8_t findHighestPriorityDueTask(uint32_t current_millis);
+
+/**
+ * @brief Finds the enabled task with the nearest deadline.
+ *
+ * @param current_millis Current time in milliseconds.
+ * @return uint8_t ID of the task or TASK_INVALID_INDEX if no task is enabled.
+ */
+static uint8_t findNearestDeadlineTask(uint32_t current_millis);
+
+/**
+ * @brief Moves the deadline of the task one period forward.
+ *
+ * The deadline is advanced by exactly one period to keep the task phase stable.
+ * If the task was late by more than one period, the deadline is re-synchronized to the
+ * current time to avoid a burst of catch-up executions.
+ *
+ * @param task_id ID of the task.
+ * @param current_millis Current time in milliseconds.
+ */
+static void advanceDeadline(uint8_t task_id, uint32_t current_millis);
+
+/**
+ * @brief Enables or disables a task and sets its first deadline one period from now.
+ *
+ * Tasks without a function (TASK_NO_FUNCTION) can not be enabled.
+ *
+ * @param task_id ID of the task.
+ * @param enabled TASK_ENABLED or TASK_DISABLED.
+ */
+static void setTaskEnabled(uint8_t task_id, bool enabled);
+
+/**
+ * @brief Overrides the next deadline of a task, used by tasks with a variable period.
+ *
+ * @param task_id ID of the task.
+ * @param deadline Time in milliseconds at which the task is due next.
+ */
+static void setTaskDeadline(uint8_t task_id, uint32_t deadline);
+
+/**
+ * @brief Puts the MCU to sleep until the deadline is reached or an event driven sensor had an interrupt.
+ *
+ * @param deadline Time in milliseconds at which the MCU should continue with execution.
+ */
+static void sleepUntil(uint32_t deadline);
+
+/**
+ * @brief Field accessors for the task configuration table in program memory.
+ *
+ * Task ID is used directly as the index, so every access is a single PROGMEM read.
+ *
+ * @param task_id ID of the task, must be lower than TASK_NUM_OF_TASKS.
+ */
+static uint32_t getTaskPeriod(uint8_t task_id);
+static uint8_t getTaskPriority(uint8_t task_id);
+static task_function_t getTaskFunction(uint8_t task_id);
+static uint8_t getTaskWatchdog(uint8_t task_id);
+/* *************************************** */
+
+/* STATIC GLOBAL VARIABLES */
+/* TASK CONFIGURATION TABLE - MUST BE IN THE ORDER OF TASK ID'S, TASK ID IS USED AS THE INDEX */
+static constexpr tasks_config_ts tasks_config[] PLATFORM_PROGMEM =
 {
-  {millis(), TASK_I2C_ADDR_READ_TIMER, TASK_I2C_ADDR_READ},
-  {millis(), TASK_SENSOR_READ_TIMER, TASK_SENSOR_READ},
-  {millis(), TASK_TIME_READ_TIMER, TASK_TIME_READ}
+  {TASK_CALIBRATING_TIMER, taskCalibrating, TASK_CALIBRATING, TASK_CALIBRATING_PRIORITY, TASK_CALIBRATING_WATCHDOG},
+  {TASK_VIEW_REFRESH_TIMER, taskViewRefresh, TASK_VIEW_REFRESH, TASK_VIEW_REFRESH_PRIORITY, TASK_VIEW_REFRESH_WATCHDOG},
+  {TASK_VIEW_ROTATE_TIMER, taskViewRotate, TASK_VIEW_ROTATE, TASK_VIEW_ROTATE_PRIORITY, TASK_VIEW_ROTATE_WATCHDOG},
+  {TASK_I2C_ADDR_READ_TIMER, taskI2CAddrRead, TASK_I2C_ADDR_READ, TASK_I2C_ADDR_READ_PRIORITY, TASK_I2C_ADDR_READ_WATCHDOG},
+  {TASK_SENSORS_SNAPSHOT_TIMER, taskSensorsSnapshot, TASK_SENSORS_SNAPSHOT, TASK_SENSORS_SNAPSHOT_PRIORITY, TASK_SENSORS_SNAPSHOT_WATCHDOG},
+  {TASK_SENSOR_SAMPLE_TIMER, taskSensorSample, TASK_SENSOR_SAMPLE, TASK_SENSOR_SAMPLE_PRIORITY, TASK_SENSOR_SAMPLE_WATCHDOG},
+  {TASK_SENSORS_LOOP_TIMER, taskSensorsLoop, TASK_SENSORS_LOOP, TASK_SENSORS_LOOP_PRIORITY, TASK_SENSORS_LOOP_WATCHDOG},
+  {TASK_OUTPUTS_LOOP_TIMER, taskOutputsLoop, TASK_OUTPUTS_LOOP, TASK_OUTPUTS_LOOP_PRIORITY, TASK_OUTPUTS_LOOP_WATCHDOG},
+  {TASK_BRING_UP_TIMER, taskBringUp, TASK_BRING_UP, TASK_BRING_UP_PRIORITY, TASK_BRING_UP_WATCHDOG},
+  {TASK_RECOVERY_TIMER, taskRecovery, TASK_RECOVERY, TASK_RECOVERY_PRIORITY, TASK_RECOVERY_WATCHDOG}
 };
 
-static bool intervalPassed(uint8_t task_id);
-static uint8_t findTaskIndex(uint8_t task_id);
-static size_t getNumOfTasks();
+static tasks_state_ts tasks_state[TASK_NUM_OF_TASKS];
+
+static i2c_scan_reading_context_ts context_i2c_scan = app_createI2CScanReadingContext(SETTINGS_DEFAULT_I2C_SCAN_MODE);
+static view_context_ts context_view = app_createViewContext();
+static sensor_sampling_context_ts context_sensor_sampling = app_createSensorsSamplingContext(0u);
+/* *************************************** */
 
+/* COMPILE TIME CHECKS */
+/**
+ * @brief Checks that every task ID is equal to its index and that all periods are valid.
+ *
+ * @param index Index from which the check starts (recursive, C++11 constexpr).
+ * @return true if the table is consistent from the index till the end, false otherwise.
+ */
+static constexpr bool tasksConfigIsConsistent(uint8_t index)
+{
+  return (TASK_NUM_OF_TASKS <= index) ||
+         (index == tasks_config[index].task_id &&
+          TASK_NO_PERIOD < tasks_config[index].task_period &&
+          TASK_MAX_PERIOD >= tasks_config[index].task_period &&
+          WATCHDOG_MAX_TIMEOUT >= tasks_config[index].task_watchdog &&
+          tasksConfigIsConsistent(index + 1u));
+}
+
+static_assert(TASK_NUM_OF_TASKS == sizeof(tasks_config) / sizeof(tasks_config[TASK_FIRST_TASK_INDEX]),
+              "tasks_config must contain exactly one entry for every task ID");
+static_assert(TASK_INVALID_INDEX >= TASK_NUM_OF_TASKS, "TASK_INVALID_INDEX must not be a valid task ID");
+static_assert(tasksConfigIsConsistent(TASK_FIRST_TASK_INDEX),
+              "Task IDs must match their index in tasks_config, periods must be in range 1..TASK_MAX_PERIOD and watchdog timeouts valid");
+static_assert(PROFILING_MAX_TASKS >= TASK_NUM_OF_TASKS, "Profiling must have a slot for every task");
+#if defined(ARDUINO_ARCH_ESP32) && (defined(WATCHDOG_COMPONENT) || defined(POWER_SAVE_COMPONENT))
+static_assert(false, "WATCHDOG_COMPONENT and POWER_SAVE_COMPONENT drive the AVR watchdog and sleep modes, disable them on the ESP32");
+#endif
+#ifdef MQ7_COMPONENT
+static_assert(TASK_SENSORS_LOOP_TIMER < SENSORS_MQ7_SAMPLE_WINDOW_MS, "Sensors loop must run at least once inside the MQ7 sample window");
+static_assert(TASK_CALIBRATING_TIMER < SENSORS_MQ7_SAMPLE_WINDOW_MS, "Calibration must run at least once inside the MQ7 sample window");
+#endif
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
 void task_initTask()
 {
+  TASK_WATCHDOG_INIT(); // Culprit of a watchdog reset is taken over before the components report it
+  TASK_WATCHDOG_ARM(WATCHDOG_NO_OWNER, TASK_BOOT_WATCHDOG);
+  TASK_POWER_INIT(); // Unused peripherals are stopped before the components start the used ones
+  PLATFORM_EEPROM_BEGIN(); // Sensors load their calibration during init
 
+  // Components are only started, settle times overlap with each other and with the boot scan
+  (void)app_startComponents();
+  context_i2c_scan = app_createI2CScanReadingContext(app_getI2CScanMode()); // Settings are loaded with the components
+
+  for (uint8_t task_id = TASK_FIRST_TASK_INDEX; task_id < TASK_NUM_OF_TASKS; task_id++)
+  {
+    setTaskEnabled(task_id, TASK_DISABLED);
+  }
+  // Station starts with scanning the I2C bus
+  setTaskEnabled(TASK_I2C_ADDR_READ, TASK_ENABLED);
+  setTaskDeadline(TASK_I2C_ADDR_READ, PLATFORM_MILLIS()); // Scan without waiting for the first period
+  setTaskEnabled(TASK_SENSORS_LOOP, TASK_ENABLED);
+  setTaskEnabled(TASK_OUTPUTS_LOOP, TASK_ENABLED);
+  setTaskEnabled(TASK_BRING_UP, TASK_ENABLED);
+  setTaskEnabled(TASK_RECOVERY, TASK_ENABLED);
 }
 
 void task_cyclicTask()
 {
-  static i2c_scan_reading_context_ts context_i2c_scan = app_createI2CScanReadingContext();
-  static sensor_reading_context_ts context_sensor_reading = app_createNewSensorsReadingContext();
-  static task_state_machine_te current_state = STATE_SCANNING_FOR_I2C_ADDRESSES;
+  uint32_t current_millis = PLATFORM_MILLIS();
+  if(app_isSensorEventPending())
+  {
+    setTaskDeadline(TASK_SENSORS_LOOP, current_millis); // Interrupt of an event driven sensor woke the MCU
+  }
+  uint8_t task_id = findHighestPriorityDueTask(current_millis);
+
+  // Run every due task, the most important one first
+  while(TASK_INVALID_INDEX != task_id)
+  {
+    advanceDeadline(task_id, current_millis);
+    TASK_WATCHDOG_ARM(task_id, getTaskWatchdog(task_id));
+    PROFILING_START(start_micros);
+    getTaskFunction(task_id)();
+    PROFILING_STOP(PROFILING_GROUP_TASKS, task_id, start_micros, TASK_PROFILING_BUDGET_US);
+
+    current_millis = PLATFORM_MILLIS();
+    task_id = findHighestPriorityDueTask(current_millis);
+  }
 
-  if(STATE_SCANNING_FOR_I2C_ADDRESSES == current_state)
+  // Sleep until the nearest deadline of all enabled tasks
+  TASK_WATCHDOG_ARM(WATCHDOG_NO_OWNER, TASK_IDLE_WATCHDOG);
+  task_id = findNearestDeadlineTask(current_millis);
+  if(TASK_INVALID_INDEX != task_id)
   {
-    if(INTERVAL_PASSED == intervalPassed(TASK_I2C_ADDR_READ))
+    sleepUntil(tasks_state[task_id].next_deadline);
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void taskI2CAddrRead()
+{
+  if(FINISHED == app_readAllI2CAddressesPeriodic(app_getOutputs(SETTINGS_OUTPUTS_I2C_SCAN), &context_i2c_scan))
+  {
+    setTaskEnabled(TASK_I2C_ADDR_READ, TASK_DISABLED);
+    if(TASK_ENABLED == tasks_state[TASK_SENSOR_SAMPLE].task_enabled)
     {
-      if(FINISHED == app_readAllI2CAddressesPeriodic(ALL_OUTPUTS, &context_i2c_scan))
-      {
-        current_state = STATE_CYCLIC_SENSOR_AND_TIME_READING;
-      }
+      return; // Scan requested by the host, the station keeps running as it is
+    }
+    // Boot scan is done, continue with cyclic sensor sampling and the display view
+    setTaskEnabled(TASK_VIEW_ROTATE, TASK_ENABLED);
+    setTaskEnabled(TASK_SENSORS_SNAPSHOT, TASK_ENABLED);
+    setTaskEnabled(TASK_SENSOR_SAMPLE, TASK_ENABLED);
+    setTaskEnabled(TASK_VIEW_REFRESH, TASK_ENABLED);
+    if(app_isSensorsCalibrationNeeded())
+    {
+      // First boot of the gas sensors, they are calibrated in the air of the first start-up
+      (void)app_startSensorsCalibration(PLATFORM_MILLIS());
+      setTaskEnabled(TASK_CALIBRATING, TASK_ENABLED);
     }
   }
-  else if(STATE_CYCLIC_SENSOR_AND_TIME_READING == current_state)
+  else if(app_isI2CScanInProgress(&context_i2c_scan))
+  {
+    setTaskDeadline(TASK_I2C_ADDR_READ, PLATFORM_MILLIS() + TASK_I2C_SCAN_SLICE_TIMER); // Next slice of the scan
+  }
+}
+
+static void taskCalibrating()
+{
+  if(FINISHED == app_runSensorsCalibration(PLATFORM_MILLIS()))
+  {
+    setTaskEnabled(TASK_CALIBRATING, TASK_DISABLED);
+  }
+}
+
+static void taskViewRefresh()
+{
+  // Time independent outputs receive all sensors at once from the snapshot task
+  (void)app_refreshViewPage(app_getOutputs(SETTINGS_OUTPUTS_VIEW), &context_view);
+}
+
+static void taskViewRotate()
+{
+  (void)app_rotateViewPage(app_getOutputs(SETTINGS_OUTPUTS_VIEW), &context_view);
+}
+
+static void taskSensorsSnapshot()
+{
+  (void)app_readSensorsSnapshot(app_getOutputs(SETTINGS_OUTPUTS_SNAPSHOT));
+}
+
+static void taskSensorSample()
+{
+  uint32_t current_millis = PLATFORM_MILLIS();
+  (void)app_readDueSensors(app_getOutputs(SETTINGS_OUTPUTS_SAMPLE), &context_sensor_sampling, current_millis);
+  setTaskDeadline(TASK_SENSOR_SAMPLE, app_getNextSensorDeadline(&context_sensor_sampling, PLATFORM_MILLIS()));
+}
+
+static void taskSensorsLoop()
+{
+  (void)app_runSensorsBackground();
+  startHostRequests();
+  startSensorEvents();
+}
+
+static void taskOutputsLoop()
+{
+  if(NOT_FINISHED == app_runOutputsBackground())
   {
-    if(INTERVAL_PASSED == intervalPassed(TASK_SENSOR_READ))
+    setTaskDeadline(TASK_OUTPUTS_LOOP, PLATFORM_MILLIS() + TASK_LOG_EXPORT_TIMER); // Next frame of the log export or the profiling dump
+  }
+}
+
+static void taskBringUp()
+{
+  if(FINISHED == app_bringUpComponents())
+  {
+    setTaskEnabled(TASK_BRING_UP, TASK_DISABLED); // Every component is up or has failed
+  }
+}
+
+static void taskRecovery()
+{
+  if(NOT_FINISHED == app_recoverComponents(PLATFORM_MILLIS()) && TASK_ENABLED != tasks_state[TASK_BRING_UP].task_enabled)
+  {
+    setTaskEnabled(TASK_BRING_UP, TASK_ENABLED); // Retried component is settling again
+  }
+}
+
+static void startHostRequests()
+{
+  uint32_t current_millis = PLATFORM_MILLIS();
+
+  if(app_takeHostRequest(SETTINGS_TRIGGER_I2C_SCAN) && TASK_ENABLED != tasks_state[TASK_I2C_ADDR_READ].task_enabled)
+  {
+    context_i2c_scan = app_createI2CScanReadingContext(app_getI2CScanMode());
+    setTaskEnabled(TASK_I2C_ADDR_READ, TASK_ENABLED);
+    setTaskDeadline(TASK_I2C_ADDR_READ, current_millis);
+  }
+  if(app_takeHostRequest(SETTINGS_TRIGGER_CALIBRATE))
+  {
+    (void)app_startSensorsCalibration(current_millis);
+    setTaskEnabled(TASK_CALIBRATING, TASK_ENABLED);
+  }
+  if(app_takeHostRequest(SETTINGS_TRIGGER_PERIODS_CHANGED))
+  {
+    context_sensor_sampling = app_createSensorsSamplingContext(current_millis);
+    if(TASK_ENABLED == tasks_state[TASK_SENSOR_SAMPLE].task_enabled)
     {
-      (void)app_readAllSensorsPeriodic(ALL_OUTPUTS, &context_sensor_reading);
+      setTaskDeadline(TASK_SENSOR_SAMPLE, current_millis);
     }
-    if(INTERVAL_PASSED == intervalPassed(TASK_TIME_READ))
+  }
+}
+
+static void startSensorEvents()
+{
+  uint32_t current_millis = PLATFORM_MILLIS();
+  uint32_t next_check = tasks_state[TASK_SENSORS_LOOP].next_deadline;
+
+  uint8_t sensor_id = app_takeSensorEvent(current_millis, &next_check);
+  if(SENSORS_NO_EVENT != sensor_id && TASK_ENABLED == tasks_state[TASK_SENSOR_SAMPLE].task_enabled)
+  {
+    (void)app_readEventSensor(app_getOutputs(SETTINGS_OUTPUTS_SAMPLE), sensor_id, current_millis);
+  }
+  setTaskDeadline(TASK_SENSORS_LOOP, next_check);
+}
+
+static uint8_t findHighestPriorityDueTask(uint32_t current_millis)
+{
+  uint8_t id_returned = TASK_INVALID_INDEX;
+  uint8_t best_priority = TASK_PRIORITY_LOWEST;
+
+  for (uint8_t task_id = TASK_FIRST_TASK_INDEX; task_id < TASK_NUM_OF_TASKS; task_id++)
+  {
+    if(TASK_ENABLED == tasks_state[task_id].task_enabled &&
+       TASK_IS_DEADLINE_REACHED(current_millis, tasks_state[task_id].next_deadline))
     {
-      (void)app_readCurrentRtcTime(LCD_DISPLAY);
+      uint8_t task_priority = getTaskPriority(task_id);
+      if(TASK_INVALID_INDEX == id_returned || task_priority < best_priority)
+      {
+        id_returned = task_id;
+        best_priority = task_priority;
+      }
     }
   }
 
-  delay(CYCLIC_TASK_DELAY_MS);
+  return id_returned;
 }
 
-static bool intervalPassed(uint8_t task_id)
+static uint8_t findNearestDeadlineTask(uint32_t current_millis)
 {
-  uint32_t current_milis = millis();
-  tasks_config_ts current_task;
-  uint8_t task_index = findTaskIndex(task_id);
-  if(TASK_INVALID_INDEX != task_index)
+  uint8_t id_returned = TASK_INVALID_INDEX;
+  uint32_t nearest_time_left = UINT32_MAX;
+
+  for (uint8_t task_id = TASK_FIRST_TASK_INDEX; task_id < TASK_NUM_OF_TASKS; task_id++)
   {
-    if(current_milis - tasks_config[task_index].previous_millis >= tasks_config[task_index].task_period)
+    if(TASK_ENABLED == tasks_state[task_id].task_enabled)
     {
-      tasks_config[task_index].previous_millis = current_milis;
-      return INTERVAL_PASSED;
+      uint32_t time_left = tasks_state[task_id].next_deadline - current_millis; // Overflow safe difference
+      if(time_left < nearest_time_left)
+      {
+        nearest_time_left = time_left;
+        id_returned = task_id;
+      }
     }
   }
-  return INTERVAL_NOT_PASSED;
+
+  return id_returned;
 }
 
-static uint8_t findTaskIndex(uint8_t task_id)
+static void advanceDeadline(uint8_t task_id, uint32_t current_millis)
 {
-  uint8_t index_returned = TASK_INVALID_INDEX;
-  size_t num_of_tasks = getNumOfTasks();
+  uint32_t task_period = getTaskPeriod(task_id);
+  tasks_state[task_id].next_deadline += task_period;
 
-  // Loop through all tasks till the right one is found
-  for (uint8_t index = TASK_FIRST_TASK_INDEX; index < num_of_tasks; index++)
+  // Task was late for more than one period, skip the missed executions
+  if(TASK_IS_DEADLINE_REACHED(current_millis, tasks_state[task_id].next_deadline))
   {
-    if(task_id == tasks_config[index].task_id)
+    tasks_state[task_id].next_deadline = current_millis + task_period;
+  }
+}
+
+static void setTaskEnabled(uint8_t task_id, bool enabled)
+{
+  if(TASK_NUM_OF_TASKS > task_id)
+  {
+    if(TASK_NO_FUNCTION == getTaskFunction(task_id))
     {
-      index_returned = index;
-      break;
+      enabled = TASK_DISABLED; // Nothing to execute
     }
+    tasks_state[task_id].task_enabled = enabled;
+    tasks_state[task_id].next_deadline = PLATFORM_MILLIS() + getTaskPeriod(task_id);
   }
+}
 
-  return index_returned;
+static void setTaskDeadline(uint8_t task_id, uint32_t deadline)
+{
+  if(TASK_NUM_OF_TASKS > task_id)
+  {
+    tasks_state[task_id].next_deadline = deadline;
+  }
 }
 
-static size_t getNumOfTasks()
+static void sleepUntil(uint32_t deadline)
 {
-  size_t num_of_tasks = TASK_NO_TASKS; // Default value in case of no tasks configured
-  if (TASK_NO_TASKS < sizeof(tasks_config)) // Ensure there is at least 1 task
+#ifdef ARDUINO_ARCH_ESP32
+  // Other FreeRTOS tasks and the idle task of the core run in the meantime
+  uint32_t current_millis = PLATFORM_MILLIS();
+  if(!TASK_IS_DEADLINE_REACHED(current_millis, deadline))
   {
-    num_of_tasks = sizeof(tasks_config) / sizeof(tasks_config[TASK_FIRST_TASK_INDEX]);
+    PLATFORM_YIELD_MS(deadline - current_millis); // Overflow safe difference
   }
-  return num_of_tasks;
-}
\ No newline at end of file
+#else
+  // Every interrupt (millis() timer, serial, I2C...) wakes the MCU, so go back to sleep till the deadline or an event of a sensor
+  while(!TASK_IS_DEADLINE_REACHED(PLATFORM_MILLIS(), deadline) && !app_isSensorEventPending())
+  {
+    if(POWER_DEEP_SLEEP_POSSIBLE == TASK_IS_DEEP_SLEEP_POSSIBLE(PLATFORM_MILLIS(), deadline))
+    {
+      TASK_WATCHDOG_ARM(WATCHDOG_NO_OWNER, TASK_DEEP_SLEEP_WATCHDOG);
+      power_sleepUntilTick();
+      TASK_WATCHDOG_ARM(WATCHDOG_NO_OWNER, TASK_IDLE_WATCHDOG);
+    }
+    else
+    {
+      power_sleep(TASK_SLEEP_MODE);
+    }
+    TASK_WATCHDOG_FEED();
+  }
+#endif
+}
+
+static uint32_t getTaskPeriod(uint8_t task_id)
+{
+  return PLATFORM_READ_DWORD(&tasks_config[task_id].task_period);
+}
+
+static uint8_t getTaskPriority(uint8_t task_id)
+{
+  return PLATFORM_READ_BYTE(&tasks_config[task_id].task_priority);
+}
+
+static task_function_t getTaskFunction(uint8_t task_id)
+{
+  return (task_function_t)PLATFORM_READ_PTR(&tasks_config[task_id].task_function);
+}
+
+static uint8_t getTaskWatchdog(uint8_t task_id)
+{
+  return PLATFORM_READ_BYTE(&tasks_config[task_id].task_watchdog);
+}
+/* *************************************** */
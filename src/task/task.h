@@ -2,7 +2,14 @@
 #define TASK_H
 
 #include <Arduino.h>
+#ifndef ARDUINO_ARCH_ESP32
+#include <avr/sleep.h>
+#endif
 #include "../app_layer/app.h"
+#include "../profiling/profiling.h"
+#include "../watchdog/watchdog.h"
+#include "../power/power.h"
+#include "../platform/platform.h"
 
 #define MS_PER_SECOND   ((uint32_t)1000u)
 #define MS_PER_MINUTE   (60u * MS_PER_SECOND)
@@ -13,38 +20,180 @@
 #define TIME_SECS(s)    ((s) * MS_PER_SECOND)
 
 #define TASK_CALIBRATING_TIMER     (TIME_SECS(1))
-#define TASK_TIME_READ_TIMER       (TIME_SECS(1))
-#define TASK_SENSOR_READ_TIMER     (TIME_SECS(2))
+/* Current page of the display is drawn again when a value on it changed, the page itself changes with the rotation */
+#define TASK_VIEW_REFRESH_TIMER    ((uint32_t)250u)
+#define TASK_VIEW_ROTATE_TIMER     (TIME_SECS(4))
 #define TASK_I2C_ADDR_READ_TIMER   (TIME_SECS(2))
+/* Pause between two slices of the I2C scan, the found addresses are presented with TASK_I2C_ADDR_READ_TIMER */
+#define TASK_I2C_SCAN_SLICE_TIMER  ((uint32_t)5u)
+#define TASK_SENSORS_SNAPSHOT_TIMER (TIME_SECS(20))
+/* Only the first deadline of the sampling task, afterwards it follows the nearest per-sensor deadline */
+#define TASK_SENSOR_SAMPLE_TIMER   (TIME_SECS(1))
+/* Must be shorter than SENSORS_MQ7_SAMPLE_WINDOW_MS, so the MQ7 sample window is never missed */
+#define TASK_SENSORS_LOOP_TIMER    ((uint32_t)500u)
+/* Must be shorter than the time the 64 byte HardwareSerial buffer needs to drain (about 66 ms at 9600 baud) */
+#define TASK_OUTPUTS_LOOP_TIMER    ((uint32_t)50u)
+/* Period of the outputs background task while the log is exported or the profiling is dumped, one frame is moved per pass */
+#define TASK_LOG_EXPORT_TIMER      ((uint32_t)5u)
+/* Polling period of the components which are still settling after power on */
+#define TASK_BRING_UP_TIMER        ((uint32_t)10u)
+/* Polling period of the recovery of failed components, the retries themselves follow the backoff of the control */
+#define TASK_RECOVERY_TIMER        (TIME_SECS(1))
 
 #define TASK_CALIBRATING           (0u)
-#define TASK_TIME_READ             (1u)
-#define TASK_SENSOR_READ           (2u)
+#define TASK_VIEW_REFRESH          (1u)
+#define TASK_VIEW_ROTATE           (2u)
 #define TASK_I2C_ADDR_READ         (3u)
+#define TASK_SENSORS_SNAPSHOT      (4u)
+#define TASK_SENSOR_SAMPLE         (5u)
+#define TASK_SENSORS_LOOP          (6u)
+#define TASK_OUTPUTS_LOOP          (7u)
+#define TASK_BRING_UP              (8u)
+#define TASK_RECOVERY              (9u)
 
-#define CYCLIC_TASK_DELAY_MS       ((uint32_t)50u)
+/* Number of tasks, task IDs are used directly as indexes into the task table so they must be 0..TASK_NUM_OF_TASKS-1 */
+#define TASK_NUM_OF_TASKS          (10u)
+
+/* Tasks running longer than the shortest task period delay the tasks behind them, counted as overruns by the profiling */
+#define TASK_PROFILING_BUDGET_US   ((uint32_t)(TASK_LOG_EXPORT_TIMER * 1000u))
+
+/* Task priorities - lower value means higher priority, due tasks are executed in this order */
+#define TASK_BRING_UP_PRIORITY       (uint8_t)(0u)
+#define TASK_SENSORS_LOOP_PRIORITY   (uint8_t)(1u)
+#define TASK_I2C_ADDR_READ_PRIORITY  (uint8_t)(2u)
+#define TASK_SENSOR_SAMPLE_PRIORITY  (uint8_t)(3u)
+#define TASK_VIEW_REFRESH_PRIORITY   (uint8_t)(4u)
+#define TASK_VIEW_ROTATE_PRIORITY    (uint8_t)(5u)
+#define TASK_SENSORS_SNAPSHOT_PRIORITY (uint8_t)(6u)
+#define TASK_CALIBRATING_PRIORITY    (uint8_t)(7u)
+#define TASK_OUTPUTS_LOOP_PRIORITY   (uint8_t)(8u)
+#define TASK_RECOVERY_PRIORITY       (uint8_t)(9u)
+/* Watchdog timeouts of the tasks (WDTO_* of avr/wdt.h), a task running longer resets the station */
+#define TASK_CALIBRATING_WATCHDOG    (uint8_t)(WDTO_250MS)
+#define TASK_VIEW_REFRESH_WATCHDOG   (uint8_t)(WDTO_250MS)
+#define TASK_VIEW_ROTATE_WATCHDOG    (uint8_t)(WDTO_250MS)
+#define TASK_I2C_ADDR_READ_WATCHDOG  (uint8_t)(WDTO_250MS)
+#define TASK_SENSORS_SNAPSHOT_WATCHDOG (uint8_t)(WDTO_250MS)
+#define TASK_SENSOR_SAMPLE_WATCHDOG  (uint8_t)(WDTO_250MS)
+#define TASK_SENSORS_LOOP_WATCHDOG   (uint8_t)(WDTO_250MS)
+#define TASK_OUTPUTS_LOOP_WATCHDOG   (uint8_t)(WDTO_250MS)
+/* Initialization of the components may wait for the libraries of the sensors and the display */
+#define TASK_BRING_UP_WATCHDOG       (uint8_t)(WDTO_1S)
+#define TASK_RECOVERY_WATCHDOG       (uint8_t)(WDTO_1S)
+/* Timeout of the first initialization of all components at boot */
+#define TASK_BOOT_WATCHDOG           (uint8_t)(WDTO_4S)
+/* Timeout of the scheduler between the tasks, fed on every wake-up of the sleep */
+#define TASK_IDLE_WATCHDOG           (uint8_t)(WDTO_1S)
+/* Timeout of the scheduler during the sleep until the next RTC tick, which comes within one second */
+#define TASK_DEEP_SLEEP_WATCHDOG     (uint8_t)(WDTO_2S)
+
+/* Hooks of the watchdog supervision, expand to nothing without WATCHDOG_COMPONENT */
+#ifdef WATCHDOG_COMPONENT
+#define TASK_WATCHDOG_INIT()                watchdog_init()
+#define TASK_WATCHDOG_ARM(owner, timeout)   watchdog_arm((owner), (timeout))
+#define TASK_WATCHDOG_FEED()                watchdog_feed()
+#else
+#define TASK_WATCHDOG_INIT()
+#define TASK_WATCHDOG_ARM(owner, timeout)
+#define TASK_WATCHDOG_FEED()
+#endif
+
+/* Hooks of the power management, without POWER_SAVE_COMPONENT the scheduler only sleeps in TASK_SLEEP_MODE */
+#ifdef POWER_SAVE_COMPONENT
+#define TASK_POWER_INIT()                                 power_init()
+#define TASK_IS_DEEP_SLEEP_POSSIBLE(current_millis, deadline) power_isDeepSleepPossible((current_millis), (deadline))
+#else
+#define TASK_POWER_INIT()
+#define TASK_IS_DEEP_SLEEP_POSSIBLE(current_millis, deadline) (POWER_DEEP_SLEEP_NOT_POSSIBLE)
+#endif
+
+/* Lowest possible task priority, used as a starting point when searching for the most important task */
+#define TASK_PRIORITY_LOWEST         (uint8_t)(0xFFu)
 
-#define TASK_NO_TASKS              (0u)
 #define TASK_FIRST_TASK_INDEX      (0u)
 #define TASK_INVALID_INDEX         (127u)
 
-#define INTERVAL_PASSED            (true)
-#define INTERVAL_NOT_PASSED        (false)
+/* Placeholder for tasks which are reserved but have no implementation yet */
+#define TASK_NO_FUNCTION           (nullptr)
+/* Period of zero is not allowed, scheduler would run such task in every pass */
+#define TASK_NO_PERIOD             ((uint32_t)0u)
+/* Maximum task period, deadlines are compared with signed 32-bit difference */
+#define TASK_MAX_PERIOD            ((uint32_t)INT32_MAX)
 
-typedef enum
-{
-    STATE_SCANNING_FOR_I2C_ADDRESSES,
-    STATE_CYCLIC_SENSOR_AND_TIME_READING
-} task_state_machine_te;
+/* Flags for enabling or disabling a task in the scheduler */
+#define TASK_ENABLED               (bool)(true)
+#define TASK_DISABLED              (bool)(false)
+
+#ifndef ARDUINO_ARCH_ESP32
+/**
+ * Sleep mode used between task deadlines.
+ * IDLE keeps Timer0 running, so the millis() overflow interrupt wakes the MCU roughly every millisecond
+ * and serial/I2C peripherals keep working while the CPU core is halted.
+ * With POWER_SAVE_COMPONENT the scheduler sleeps in power-save instead whenever the next RTC tick
+ * comes before the deadline and no peripheral is busy (see power.h).
+ */
+#define TASK_SLEEP_MODE            (SLEEP_MODE_IDLE)
+#endif
 
+/* Macro that checks if a deadline has been reached, safe against millis() overflow */
+#define TASK_IS_DEADLINE_REACHED(current_millis, deadline) IS_DEADLINE_REACHED(current_millis, deadline)
+
+/* Function pointer type for a task executed by the scheduler */
+typedef void (*task_function_t)();
+
+/**
+ * @brief Structure describing the static configuration of a single task.
+ *
+ * Entries are stored in program memory and indexed directly by task ID.
+ *
+ * Members:
+ *  - task_period: Period of the task in milliseconds.
+ *  - task_function: Function executed when the task is due.
+ *  - task_id: Unique identifier of the task (TASK_* macros), must be equal to its index in the table.
+ *  - task_priority: Priority of the task, lower value means the task is executed first.
+ *  - task_watchdog: Watchdog timeout of the task (WDTO_* of avr/wdt.h), only used with WATCHDOG_COMPONENT.
+ */
 typedef struct
 {
-    uint32_t previous_millis;
     uint32_t task_period;
+    task_function_t task_function;
     uint8_t task_id;
+    uint8_t task_priority;
+    uint8_t task_watchdog;
 } tasks_config_ts;
 
+/**
+ * @brief Structure describing the runtime state of a single task.
+ *
+ * Members:
+ *  - next_deadline: Time in milliseconds (millis() based) at which the task is due next.
+ *  - task_enabled: Flag indicating if the task is currently scheduled.
+ */
+typedef struct
+{
+    uint32_t next_deadline;
+    bool task_enabled;
+} tasks_state_ts;
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * Starts the initialization of every component, disables every task and enables the I2C address
+ * reading task, which is the first state of the station and starts right away, together with the
+ * bring-up of the settling components, the recovery of the failed ones and the sensors and outputs background tasks.
+ * The watchdog supervises the initialization with TASK_BOOT_WATCHDOG.
+ * Must be called once from setup() before the first call of task_cyclicTask().
+ */
 void task_initTask();
+
+/**
+ * @brief Runs one pass of the deadline-driven cooperative scheduler.
+ *
+ * Executes all due tasks in priority order, computes the nearest deadline of all
+ * enabled tasks and puts the MCU to sleep until that deadline is reached. Every task runs
+ * with its own watchdog timeout, a task which hangs resets the station and is reported after the reset.
+ * On the ESP32 the core is given to FreeRTOS until the deadline instead of sleeping.
+ */
 void task_cyclicTask();
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,146 @@
+#include "watchdog.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Record of the last hang, survives the watchdog reset since the startup code does not clear .noinit */
+static watchdog_reset_ts reset_record __attribute__((section(".noinit")));
+static uint8_t record_magic __attribute__((section(".noinit")));
+static uint8_t record_check __attribute__((section(".noinit")));
+/* Copy of MCUSR, taken before main() */
+static uint8_t reset_flags __attribute__((section(".noinit")));
+
+static bool reset_by_watchdog = WATCHDOG_RESET_BY_OTHER_CAUSE;
+static volatile uint8_t current_owner = WATCHDOG_NO_OWNER;
+static volatile uint8_t current_group = WATCHDOG_NO_ACTIVITY;
+static volatile uint8_t current_id = WATCHDOG_NO_ACTIVITY;
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Saves MCUSR and disables the watchdog before main(), placed into .init3 of the startup code.
+ *
+ * After a watchdog reset the watchdog stays enabled with the shortest timeout, so it must be disabled
+ * before the initialization of the C++ objects, which takes longer.
+ */
+static void captureResetFlags() __attribute__((naked, used, section(".init3")));
+
+/**
+ * @brief Computes the check byte of the record.
+ *
+ * @return uint8_t Check byte of the current record.
+ */
+static uint8_t recordCheck();
+
+/**
+ * @brief Writes a timeout into the watchdog register with the interrupt and the reset enabled.
+ *
+ * @param timeout One of the WDTO_* values of avr/wdt.h.
+ */
+static void writeTimeout(uint8_t timeout);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void watchdog_init()
+{
+  bool record_valid = (WATCHDOG_RECORD_MAGIC == record_magic && recordCheck() == record_check);
+  reset_by_watchdog = (bit_is_set(reset_flags, WDRF) && record_valid) ? WATCHDOG_RESET_BY_WATCHDOG : WATCHDOG_RESET_BY_OTHER_CAUSE;
+
+  if(WATCHDOG_RESET_BY_WATCHDOG != reset_by_watchdog)
+  {
+    // Power on, external or brown-out reset, consecutive resets are counted from zero again
+    reset_record = {WATCHDOG_NO_OWNER, WATCHDOG_NO_ACTIVITY, WATCHDOG_NO_ACTIVITY, 0u};
+    record_magic = WATCHDOG_RECORD_MAGIC;
+    record_check = recordCheck();
+  }
+  reset_flags = 0u; // Next boot without a fresh copy is not taken as a watchdog reset
+}
+
+void watchdog_arm(uint8_t owner, uint8_t timeout)
+{
+  current_owner = owner;
+  writeTimeout((WATCHDOG_MAX_TIMEOUT < timeout) ? WATCHDOG_MAX_TIMEOUT : timeout);
+}
+
+void watchdog_feed()
+{
+  wdt_reset();
+}
+
+void watchdog_setActivity(uint8_t group, uint8_t id)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    current_group = group;
+    current_id = id;
+  }
+}
+
+void watchdog_clearActivity()
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    // Device which hung before came through this time
+    if(current_group == reset_record.activity_group && current_id == reset_record.activity_id && 0u != reset_record.consecutive_resets)
+    {
+      reset_record.consecutive_resets = 0u;
+      record_check = recordCheck();
+    }
+    current_group = WATCHDOG_NO_ACTIVITY;
+    current_id = WATCHDOG_NO_ACTIVITY;
+  }
+}
+
+bool watchdog_getLastReset(watchdog_reset_ts *reset)
+{
+  if(WATCHDOG_RESET_BY_WATCHDOG == reset_by_watchdog)
+  {
+    *reset = reset_record;
+  }
+  return reset_by_watchdog;
+}
+/* *************************************** */
+
+/* INTERRUPT SERVICE ROUTINES */
+ISR(WDT_vect)
+{
+  // Same activity hung again, the count lets the next boot decide to skip the device
+  uint8_t consecutive_resets = 1u;
+  if(current_group == reset_record.activity_group && current_id == reset_record.activity_id)
+  {
+    consecutive_resets = (UINT8_MAX != reset_record.consecutive_resets) ? (uint8_t)(reset_record.consecutive_resets + 1u) : UINT8_MAX;
+  }
+
+  reset_record = {current_owner, current_group, current_id, consecutive_resets};
+  record_magic = WATCHDOG_RECORD_MAGIC;
+  record_check = recordCheck();
+
+  // Interrupt mode was cleared by the hardware, the next timeout resets the station
+  writeTimeout(WATCHDOG_RESET_DELAY);
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void captureResetFlags()
+{
+  reset_flags = MCUSR;
+  MCUSR = 0u; // WDRF must be cleared, otherwise the watchdog can not be disabled
+  wdt_disable();
+}
+
+static uint8_t recordCheck()
+{
+  return (uint8_t)~(reset_record.owner ^ reset_record.activity_group ^ reset_record.activity_id ^ reset_record.consecutive_resets);
+}
+
+static void writeTimeout(uint8_t timeout)
+{
+  uint8_t prescaler = (uint8_t)(((WATCHDOG_TIMEOUT_HIGH_BIT & timeout) ? _BV(WDP3) : 0u) | (WATCHDOG_TIMEOUT_LOW_BITS & timeout));
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    wdt_reset();
+    // Timed sequence, the new value must be written within four cycles after WDCE
+    WDTCSR = (uint8_t)(_BV(WDCE) | _BV(WDE));
+    WDTCSR = (uint8_t)(_BV(WDIE) | _BV(WDE) | prescaler);
+  }
+}
+/* *************************************** */
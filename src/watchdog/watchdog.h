@@ -0,0 +1,116 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+#include "../project_settings.h"
+
+/**
+ * @file watchdog.h
+ * @brief Supervision of the scheduler with the AVR watchdog, the culprit of a hang survives the reset.
+ *
+ * The watchdog runs in interrupt and reset mode. When the armed timeout expires, the interrupt writes the
+ * owner of the watchdog (the running task) and the current activity (the device the control is talking to)
+ * into a record in the .noinit section, which is not cleared by the startup code, and the reset follows
+ * WATCHDOG_RESET_DELAY later. At the next boot the record tells which task and device hung and how many
+ * resets in a row the same device caused.
+ *
+ * The reset cause is taken from MCUSR before main(), where the watchdog is also disabled, so a station which
+ * was reset by the watchdog does not reset again during its initialization. A bootloader which clears MCUSR
+ * itself (e.g. newer Optiboot) hides the watchdog resets, the record is then treated as stale.
+ */
+
+/* Values of the owner and the activity when nothing is supervised */
+#define WATCHDOG_NO_OWNER               (uint8_t)(0xFFu)
+#define WATCHDOG_NO_ACTIVITY            (uint8_t)(0xFFu)
+
+/* Marks a valid record in the .noinit section, RAM after power on holds random values */
+#define WATCHDOG_RECORD_MAGIC           (uint8_t)(0x5Au)
+
+/* Timeout after the interrupt until the reset, the shortest one so the hang does not continue */
+#define WATCHDOG_RESET_DELAY            (WDTO_15MS)
+
+/* Highest timeout of the watchdog (WDTO_8S), timeouts are the WDTO_* values of avr/wdt.h */
+#define WATCHDOG_MAX_TIMEOUT            (uint8_t)(WDTO_8S)
+/* Bit of the timeout which goes to WDP3, the lower bits go to WDP2..WDP0 */
+#define WATCHDOG_TIMEOUT_HIGH_BIT       (uint8_t)(0x08u)
+#define WATCHDOG_TIMEOUT_LOW_BITS       (uint8_t)(0x07u)
+
+/* Flags returned by watchdog_getLastReset() */
+#define WATCHDOG_RESET_BY_WATCHDOG      (bool)(true)
+#define WATCHDOG_RESET_BY_OTHER_CAUSE   (bool)(false)
+
+/**
+ * @brief Structure with the culprit of the last watchdog reset.
+ *
+ * Members:
+ *  - owner: Owner which armed the watchdog (task ID), WATCHDOG_NO_OWNER outside of a task.
+ *  - activity_group: Group of the activity (I/O component of the control), WATCHDOG_NO_ACTIVITY if there was none.
+ *  - activity_id: ID of the activity (device ID of the control).
+ *  - consecutive_resets: Number of watchdog resets in a row during the same activity, saturates at UINT8_MAX.
+ */
+typedef struct
+{
+  uint8_t owner;
+  uint8_t activity_group;
+  uint8_t activity_id;
+  uint8_t consecutive_resets;
+} watchdog_reset_ts;
+
+/* Hooks around an activity of a supervised device, expand to nothing without WATCHDOG_COMPONENT */
+#ifdef WATCHDOG_COMPONENT
+#define WATCHDOG_SET_ACTIVITY(group, id)  watchdog_setActivity((group), (id))
+#define WATCHDOG_CLEAR_ACTIVITY()         watchdog_clearActivity()
+#else
+#define WATCHDOG_SET_ACTIVITY(group, id)
+#define WATCHDOG_CLEAR_ACTIVITY()
+#endif
+
+/**
+ * @brief Takes over the reset cause and the record of the last watchdog reset.
+ *
+ * Must be called once at boot, before the watchdog is armed. A record is kept only after a watchdog reset,
+ * after any other reset it is cleared, so the count of consecutive resets starts again.
+ */
+void watchdog_init();
+
+/**
+ * @brief Arms the watchdog for an owner, the interrupt records the owner if the timeout expires.
+ *
+ * @param owner Owner of the watchdog (task ID) or WATCHDOG_NO_OWNER.
+ * @param timeout Timeout of the watchdog, one of the WDTO_* values of avr/wdt.h.
+ */
+void watchdog_arm(uint8_t owner, uint8_t timeout);
+
+/**
+ * @brief Restarts the timeout of the armed watchdog.
+ */
+void watchdog_feed();
+
+/**
+ * @brief Marks the start of an activity of a device, recorded together with the owner by a hang.
+ *
+ * @param group Group of the activity (I/O component of the control).
+ * @param id ID of the activity (device ID of the control).
+ */
+void watchdog_setActivity(uint8_t group, uint8_t id);
+
+/**
+ * @brief Marks the end of the current activity.
+ *
+ * An activity which finishes after it caused the last watchdog reset clears the count of consecutive resets.
+ */
+void watchdog_clearActivity();
+
+/**
+ * @brief Returns the culprit of the last reset.
+ *
+ * @param reset Receives the culprit, only written after a watchdog reset.
+ * @return true (WATCHDOG_RESET_BY_WATCHDOG) if the station was reset by the watchdog, false otherwise.
+ */
+bool watchdog_getLastReset(watchdog_reset_ts *reset);
+
+#endif